@@ -0,0 +1,264 @@
+#include "AdcircRun.h"
+
+AdcircRun::AdcircRun(JobScheduler *newScheduler, QObject *parent) :
+	QObject(parent),
+	scheduler(newScheduler)
+{
+	runDirectory = "";
+	executable = "";
+	adcprepExecutable = "";
+	numProcessors = 1;
+	priority = 0;
+	memory = 0;
+	stage = RunNotStarted;
+	currentJob = -1;
+	exitCode = 0;
+
+	if (scheduler)
+	{
+		connect(scheduler, SIGNAL(jobStateChanged(int,QString,QString)), this, SLOT(jobStateChanged(int,QString,QString)));
+		connect(scheduler, SIGNAL(jobFinished(int,int)), this, SLOT(jobFinished(int,int)));
+	}
+}
+
+
+void AdcircRun::SetRunDirectory(QString newDirectory)
+{
+	runDirectory = newDirectory;
+	memory = JobScheduler::EstimateMemory(runDirectory + QDir::separator() + "fort.14");
+}
+
+
+/**
+ * @brief Sets the ADCIRC executable, and the adcprep executable used for parallel runs
+ * @param newExecutable adcirc for a serial run, or padcirc for a parallel run
+ * @param newAdcprep adcprep, or empty to use the adcprep next to the ADCIRC executable
+ */
+void AdcircRun::SetExecutable(QString newExecutable, QString newAdcprep)
+{
+	executable = newExecutable;
+	if (newAdcprep.isEmpty())
+		adcprepExecutable = QFileInfo(executable).absolutePath() + QDir::separator() + ADCPREP_NAME;
+	else
+		adcprepExecutable = newAdcprep;
+}
+
+
+/**
+ * @brief Sets the number of processors to run on
+ * @param newNum 1 for a serial run, or more to partition the mesh and run padcirc
+ */
+void AdcircRun::SetNumProcessors(int newNum)
+{
+	numProcessors = newNum > 0 ? newNum : 1;
+}
+
+
+void AdcircRun::SetPriority(int newPriority)
+{
+	priority = newPriority;
+}
+
+
+/**
+ * @brief Queues the first step of the run
+ * @return true if the first step was queued
+ */
+bool AdcircRun::Start()
+{
+	if (!scheduler || stage != RunNotStarted || runDirectory.isEmpty() || executable.isEmpty())
+		return false;
+
+	if (numProcessors > 1 && !QFile(adcprepExecutable).exists())
+	{
+		emit emitMessage("<p style='color:red'><strong>Error:</strong> Unable to find " + adcprepExecutable + "</p>");
+		return false;
+	}
+
+	return StartStage(numProcessors > 1 ? RunPartitioning : RunSimulating);
+}
+
+
+/**
+ * @brief Cancels the step that is queued or running. No further steps are started.
+ */
+void AdcircRun::Cancel()
+{
+	if (scheduler && currentJob >= 0)
+		scheduler->CancelJob(currentJob);
+}
+
+
+int AdcircRun::GetNumProcessors()
+{
+	return numProcessors;
+}
+
+
+AdcircRunStage AdcircRun::GetStage()
+{
+	return stage;
+}
+
+
+/**
+ * @brief Returns the exit code of the step the run ended on
+ * @return The exit code, or -1 if a step could not be started
+ */
+int AdcircRun::GetExitCode()
+{
+	return exitCode;
+}
+
+
+QString AdcircRun::GetStageName(AdcircRunStage stage)
+{
+	switch (stage)
+	{
+		case RunNotStarted:	return QString("Not Started");
+		case RunPartitioning:	return QString("Partitioning Mesh");
+		case RunPreparing:	return QString("Preparing Input Files");
+		case RunSimulating:	return QString("Running");
+		case RunFinished:	return QString("Finished");
+		case RunFailed:		return QString("Failed");
+	}
+	return QString("Unknown");
+}
+
+
+/**
+ * @brief Queues the job for a step of the run
+ * @param newStage The step
+ * @return true if the job was queued
+ */
+bool AdcircRun::StartStage(AdcircRunStage newStage)
+{
+	QString np = QString::number(numProcessors);
+	QString name;
+	QString program;
+	QStringList arguments;
+	QString outputName;
+	int cores = 1;
+
+	if (newStage == RunPartitioning)
+	{
+		name = "adcprep --partmesh (" + np + " processors)";
+		program = adcprepExecutable;
+		arguments << "--np" << np << "--partmesh";
+		outputName = "adcprep_partmesh";
+	}
+	else if (newStage == RunPreparing)
+	{
+		name = "adcprep --prepall (" + np + " processors)";
+		program = adcprepExecutable;
+		arguments << "--np" << np << "--prepall";
+		outputName = "adcprep_prepall";
+	}
+	else if (newStage == RunSimulating && numProcessors > 1)
+	{
+		name = "padcirc (" + np + " processors)";
+		program = MPI_LAUNCHER;
+		arguments << "-np" << np << executable;
+		outputName = "padcirc";
+		cores = numProcessors;
+	}
+	else if (newStage == RunSimulating)
+	{
+		name = "adcirc";
+		program = executable;
+		outputName = JOB_OUTPUT_NAME;
+	}
+	else
+	{
+		return false;
+	}
+
+	stage = newStage;
+	emit stageChanged(GetStageName(stage));
+	emit emitMessage("<p>" + runDirectory + ": " + GetStageName(stage) + "</p>");
+
+	currentJob = -1;
+	int id = scheduler->SubmitJob(name, runDirectory, program, arguments, cores,
+				      newStage == RunSimulating ? memory : 0, priority, outputName);
+	currentJob = id;
+
+	/* A job that started or could not be started did so before SubmitJob() returned */
+	const AdcircJob *job = scheduler->GetJob(id);
+	if (job && job->state == JobRunning && stage == RunSimulating)
+		emit simulationStarted();
+	else if (job && job->state != JobQueued && job->state != JobRunning)
+		jobFinished(id, job->exitCode);
+	return true;
+}
+
+
+void AdcircRun::FinishRun(AdcircRunStage finalStage, int newExitCode)
+{
+	stage = finalStage;
+	exitCode = newExitCode;
+	currentJob = -1;
+	emit stageChanged(GetStageName(stage));
+	emit finished(exitCode);
+}
+
+
+/**
+ * @brief Emits simulationStarted() when a queued ADCIRC job starts running
+ * @param id The ID of the job that changed state
+ */
+void AdcircRun::jobStateChanged(int id, QString, QString)
+{
+	if (id != currentJob || currentJob < 0 || stage != RunSimulating)
+		return;
+
+	const AdcircJob *job = scheduler->GetJob(id);
+	if (job && job->state == JobRunning)
+		emit simulationStarted();
+}
+
+
+/**
+ * @brief Moves on to the next step when the job of the current step has finished
+ * @param id The ID of the job that finished
+ * @param jobExitCode Its exit code
+ */
+void AdcircRun::jobFinished(int id, int jobExitCode)
+{
+	if (id != currentJob || currentJob < 0)
+		return;
+
+	const AdcircJob *job = scheduler->GetJob(id);
+	if (!job || job->state != JobFinished)
+	{
+		emit emitMessage("<p style='color:red'><strong>Error:</strong> " + runDirectory + ": " +
+				 GetStageName(stage) + " did not finish (exit code " + QString::number(jobExitCode) + ")</p>");
+		FinishRun(RunFailed, jobExitCode);
+		return;
+	}
+
+	if (stage == RunPartitioning)
+	{
+		StartStage(RunPreparing);
+	}
+	else if (stage == RunPreparing)
+	{
+		/* Only a run that records subdomain boundary conditions has a fort.015 */
+		if (QFile(runDirectory + QDir::separator() + "fort.015").exists())
+		{
+			Fort015 fort015;
+			fort015.SetPath(runDirectory);
+			if (!fort015.WriteFort015Partitioned())
+			{
+				emit emitMessage("<p style='color:red'><strong>Error:</strong> Unable to write fort.015 into the processor directories of " +
+						 runDirectory + "</p>");
+				FinishRun(RunFailed, -1);
+				return;
+			}
+		}
+		StartStage(RunSimulating);
+	}
+	else if (stage == RunSimulating)
+	{
+		FinishRun(RunFinished, jobExitCode);
+	}
+}
@@ -0,0 +1,99 @@
+#ifndef ADCIRCRUN_H
+#define ADCIRCRUN_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include "Adcirc/JobScheduler.h"
+#include "Projects/IO/FileIO/Fort015.h"
+
+#define ADCPREP_NAME		"adcprep"
+#define MPI_LAUNCHER		"mpirun"
+
+
+/**
+ * @brief The steps of an AdcircRun
+ */
+enum AdcircRunStage
+{
+	RunNotStarted,
+	RunPartitioning,	/**< adcprep --partmesh */
+	RunPreparing,		/**< adcprep --prepall, then fort.015 is written for every processor */
+	RunSimulating,		/**< adcirc, or padcirc through mpirun */
+	RunFinished,
+	RunFailed
+};
+
+
+/**
+ * @brief A single ADCIRC run, serial or parallel, carried out through a JobScheduler
+ *
+ * A single ADCIRC run, serial or parallel, carried out through a JobScheduler. A
+ * serial run is a single job. A parallel run first partitions the mesh and prepares
+ * the input files of every processor with adcprep, writes a fort.015 file into every
+ * processor directory if the run records subdomain boundary conditions, and then
+ * runs padcirc on the requested number of processors through mpirun. Each step is
+ * queued as its own job once the one before it has succeeded, and the run stops at
+ * the first step that fails. simulationStarted() is emitted when the ADCIRC job
+ * itself leaves the queue and starts running.
+ *
+ * adcprep is expected in the same directory as the ADCIRC executable, and mpirun
+ * is found through the PATH.
+ *
+ */
+class AdcircRun : public QObject
+{
+		Q_OBJECT
+	public:
+		AdcircRun(JobScheduler *newScheduler, QObject *parent=0);
+
+		void	SetRunDirectory(QString newDirectory);
+		void	SetExecutable(QString newExecutable, QString newAdcprep=QString());
+		void	SetNumProcessors(int newNum);
+		void	SetPriority(int newPriority);
+
+		bool	Start();
+		void	Cancel();
+
+		/* Getter Methods */
+		int		GetNumProcessors();
+		AdcircRunStage	GetStage();
+		int		GetExitCode();
+
+		static QString	GetStageName(AdcircRunStage stage);
+
+	private:
+
+		JobScheduler*	scheduler;
+		QString		runDirectory;
+		QString		executable;
+		QString		adcprepExecutable;
+		int		numProcessors;
+		int		priority;
+		qint64		memory;
+
+		AdcircRunStage	stage;
+		int		currentJob;
+		int		exitCode;
+
+		bool	StartStage(AdcircRunStage newStage);
+		void	FinishRun(AdcircRunStage finalStage, int newExitCode);
+
+	private slots:
+
+		void	jobStateChanged(int id, QString, QString);
+		void	jobFinished(int id, int jobExitCode);
+
+	signals:
+
+		void	stageChanged(QString);
+		void	simulationStarted();
+		void	finished(int);
+		void	emitMessage(QString);
+};
+
+#endif // ADCIRCRUN_H
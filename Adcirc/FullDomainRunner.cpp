@@ -5,10 +5,14 @@ FullDomainRunner::FullDomainRunner()
 	fullDomain = 0;
 	fullDomainPath = "";
 	adcircExecutableLocation = "";
+	padcircExecutableLocation = "";
 	adcircExecutableName = "";
 	subdomainApproach = -1;
 	recordFrequency = -1;
 	runEnvironment = -1;
+	numProcessors = 1;
+	liveCarving = false;
+	resampleInterval = 0.0;
 }
 
 
@@ -24,6 +28,12 @@ void FullDomainRunner::SetAdcircExecutable(QString newLoc)
 }
 
 
+void FullDomainRunner::SetPadcircExecutable(QString newLoc)
+{
+	padcircExecutableLocation = newLoc;
+}
+
+
 void FullDomainRunner::SetFullDomain(Domain *newFull)
 {
 	if (newFull)
@@ -43,45 +53,145 @@ void FullDomainRunner::SetSubDomains(std::vector<Domain *> newSubs)
 }
 
 
-bool FullDomainRunner::PrepareForFullDomainRun()
+/**
+ * @brief Asks the user for the options of the full domain run
+ * @return true if the dialog was accepted
+ */
+bool FullDomainRunner::ShowRunOptionsDialog()
 {
 	FullDomainRunOptionsDialog dlg;
 	dlg.SetAdcircExecutable(adcircExecutableLocation);
+	dlg.SetPadcircExecutable(padcircExecutableLocation);
 	if (dlg.exec())
 	{
 		adcircExecutableLocation = dlg.GetAdcircExecutableLocation();
+		padcircExecutableLocation = dlg.GetPadcircExecutableLocation();
 		subdomainApproach = dlg.GetSubdomainApproach();
 		recordFrequency = dlg.GetRecordFrequency();
 		runEnvironment = dlg.GetRunEnvironment();
+		numProcessors = dlg.GetNumProcessors();
+		adcircExecutableName = QFileInfo(GetRunExecutable()).fileName();
+		liveCarving = dlg.GetLiveCarving();
+		resampleInterval = dlg.GetResampleInterval();
 		std::cout << subdomainApproach << recordFrequency << runEnvironment << std::endl;
 		std::cout << adcircExecutableLocation.toStdString().data() << std::endl;
-		if (!WriteFort015File())
-		{
-			std::cout << "Did not write fort.015 file" << std::endl;
-			return false;
-		}
-		return CheckForRequiredFiles();
+		return true;
 	}
 	return false;
 }
 
 
-bool FullDomainRunner::PerformFullDomainRun()
+/**
+ * @brief Starts the full domain run
+ *
+ * Starts the full domain run through the scheduler of an AdcircRun, at a higher
+ * priority than subdomain runs. A run on more than one processor is partitioned
+ * with adcprep and run with the padcirc executable, and adcprep is expected next
+ * to padcirc.
+ *
+ * @param run The run to set up and start
+ * @return true if the run was started
+ */
+bool FullDomainRunner::PerformFullDomainRun(AdcircRun *run)
+{
+	if (!run || fullDomainPath.isEmpty() || adcircExecutableName.isEmpty())
+		return false;
+
+	run->SetRunDirectory(fullDomainPath);
+	run->SetExecutable(fullDomainPath + QDir::separator() + adcircExecutableName,	// Adcirc executable link in project path
+			   QFileInfo(GetRunExecutable()).absolutePath() + QDir::separator() + ADCPREP_NAME);
+	run->SetNumProcessors(numProcessors);
+	run->SetPriority(FULL_DOMAIN_JOB_PRIORITY);
+	return run->Start();
+}
+
+
+QString FullDomainRunner::GetAdcircExecutable()
+{
+	return adcircExecutableLocation;
+}
+
+
+/**
+ * @brief Returns the number of processors the full domain runs on
+ * @return 1 for a serial run, or more for a parallel run
+ */
+int FullDomainRunner::GetNumProcessors()
+{
+	return numProcessors;
+}
+
+
+int FullDomainRunner::GetSubdomainApproach()
+{
+	return subdomainApproach;
+}
+
+
+/**
+ * @brief Returns true if the user asked for fort.066 to be carved while the run is going
+ * @return true if subdomain boundary conditions should be carved during the run
+ */
+bool FullDomainRunner::GetLiveCarving()
+{
+	return liveCarving && subDomains.size() > 0;
+}
+
+
+/**
+ * @brief Returns the number of timesteps between the records of fort.066
+ * @return NSPOOLGS, as written to fort.015
+ */
+int FullDomainRunner::GetRecordFrequency()
 {
-	arguments.clear();
-	arguments << "--working-directory="+fullDomainPath;	// Set the working directory of the new terminal
-	arguments << "-e";					// Execute command flag
-	arguments << "./"+adcircExecutableName;			// Adcirc executable link in project path
+	return recordFrequency;
+}
 
-	QProcess *bash = new QProcess();
-	bash->start("gnome-terminal", arguments);
-	return bash->waitForStarted();
+
+/**
+ * @brief Returns the time between the records of fort.066
+ *
+ * Returns the time between the records of fort.066, which is the record frequency
+ * times the model timestep (DTDP) read from the fort.15 of the full domain.
+ *
+ * @return The interval in seconds, or 0 if fort.15 could not be read
+ */
+double FullDomainRunner::GetRecordInterval()
+{
+	if (recordFrequency <= 0 || fullDomainPath.isEmpty())
+		return 0.0;
+
+	Fort15 fort15 ((fullDomainPath + QDir::separator() + "fort.15").toStdString());
+	if (!fort15.ReadFile())
+		return 0.0;
+	return recordFrequency * fort15.GetTimestep();
+}
+
+
+/**
+ * @brief Returns the interval the carved boundary conditions should be resampled to
+ * @return The subdomain timestep in seconds, or 0 to keep the record frequency
+ */
+double FullDomainRunner::GetResampleInterval()
+{
+	return resampleInterval;
 }
 
 
 bool FullDomainRunner::CheckForRequiredFiles()
 {
-	QFile adcExe (adcircExecutableLocation);
+	if (numProcessors > 1 && padcircExecutableLocation.isEmpty())
+	{
+		QMessageBox dlg;
+		dlg.setWindowTitle("Run Full Domain");
+		dlg.setText("Error - A run on more than one processor needs the padcirc executable");
+		dlg.setIcon(QMessageBox::Critical);
+		dlg.setStandardButtons(QMessageBox::Ok);
+		dlg.exec();
+		return false;
+	}
+
+	QFile adcExe (GetRunExecutable());
 	adcircExecutableName = QFileInfo(adcExe).fileName();
 
 	/* Check for fort.14, fort.15, fort.015, ln to adcirc */
@@ -121,18 +231,48 @@ bool FullDomainRunner::CheckForRequiredFiles()
 }
 
 
+/**
+ * @brief Returns the executable for the number of processors the run uses
+ * @return padcirc for a parallel run, or adcirc for a serial run
+ */
+QString FullDomainRunner::GetRunExecutable()
+{
+	return numProcessors > 1 ? padcircExecutableLocation : adcircExecutableLocation;
+}
+
+
 bool FullDomainRunner::CheckForFile(QString fileName)
 {
 	return QFile(fullDomainPath + QDir::separator() + fileName).exists();
 }
 
 
-bool FullDomainRunner::WriteFort015File()
+/**
+ * @brief Sets up the writer of the full domain fort.015 file
+ *
+ * Sets up the writer of the full domain fort.015 file with the options from the
+ * run options dialog. The caller starts its writeFullDomain() slot as a task on the
+ * TaskScheduler, so the boundary nodes of the subdomains are found off the GUI
+ * thread. The subdomains' loaded Elements are not handed over, since a domain can
+ * be unloaded while the task runs. The boundary node cache in each subdomain
+ * directory saves reading their fort.14 files again on later runs.
+ *
+ * @return The writer, which the caller deletes, or 0 if a subdomain is missing
+ */
+Fort015* FullDomainRunner::CreateFort015Writer()
 {
-	Fort015 fort015;
-	fort015.SetPath(fullDomainPath);
-	fort015.SetSubdomains(subDomains);
-	fort015.SetApproach(subdomainApproach);
-	fort015.SetRecordFrequency(recordFrequency);
-	return fort015.WriteFort015FullDomain();
+	std::vector<SubdomainFiles> subdomainFiles;
+	for (std::vector<Domain*>::iterator it = subDomains.begin(); it != subDomains.end(); ++it)
+	{
+		if (!*it)
+			return 0;
+		subdomainFiles.push_back((*it)->GetSubdomainFiles());
+	}
+
+	Fort015 *fort015 = new Fort015();
+	fort015->SetPath(fullDomainPath);
+	fort015->SetSubdomains(subdomainFiles);
+	fort015->SetApproach(subdomainApproach);
+	fort015->SetRecordFrequency(recordFrequency);
+	return fort015;
 }
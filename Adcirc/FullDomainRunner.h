@@ -6,12 +6,17 @@
 #include "Dialogs/FullDomainRunOptionsDialog.h"
 
 #include "Projects/IO/FileIO/Fort015.h"
+#include "Projects/IO/FileIO/Fort15.h"
+
+#include "Adcirc/JobScheduler.h"
+#include "Adcirc/AdcircRun.h"
 
 #include <QString>
 #include <QMessageBox>
-#include <QProcess>
 #include <iostream>
 
+#define FULL_DOMAIN_JOB_PRIORITY	10
+
 class FullDomainRunner
 {
 	public:
@@ -19,11 +24,23 @@ class FullDomainRunner
 		~FullDomainRunner();
 
 		void	SetAdcircExecutable(QString newLoc);
+		void	SetPadcircExecutable(QString newLoc);
 		void	SetFullDomain(Domain *newFull);
 		void	SetSubDomains(std::vector<Domain*> newSubs);
 
-		bool	PrepareForFullDomainRun();
-		bool	PerformFullDomainRun();
+		bool	ShowRunOptionsDialog();
+		Fort015*	CreateFort015Writer();
+		bool	CheckForRequiredFiles();
+		bool	PerformFullDomainRun(AdcircRun *run);
+
+		QString	GetAdcircExecutable();
+		QString	GetRunExecutable();
+		int	GetNumProcessors();
+		int	GetSubdomainApproach();
+		bool	GetLiveCarving();
+		int	GetRecordFrequency();
+		double	GetRecordInterval();
+		double	GetResampleInterval();
 
 	private:
 
@@ -31,20 +48,21 @@ class FullDomainRunner
 		QString			fullDomainPath;
 		std::vector<Domain*>	subDomains;
 		QString			adcircExecutableLocation;
-		QString			adcircExecutableName;
-		QStringList		arguments;
+		QString			padcircExecutableLocation;
+		QString			adcircExecutableName;	/**< The link to the executable of the run in the full domain directory */
 
 		int	subdomainApproach;
 		int	recordFrequency;
 		int	runEnvironment;
+		int	numProcessors;
+		bool	liveCarving;
+		double	resampleInterval;
 		std::vector<unsigned int>	innerBoundaries;
 		std::vector<unsigned int>	outerBoundaries;
 
 		void	DisplayFullDomainOptionsDialog();
 
-		bool	CheckForRequiredFiles();
 		bool	CheckForFile(QString fileName);
-		bool	WriteFort015File();
 };
 
 #endif // FULLDOMAINRUNNER_H
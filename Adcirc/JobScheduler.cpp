@@ -0,0 +1,464 @@
+#include "JobScheduler.h"
+
+JobScheduler::JobScheduler(QObject *parent) :
+	QObject(parent)
+{
+	nextID = 1;
+	coreBudget = QThread::idealThreadCount() > 0 ? QThread::idealThreadCount() : 1;
+	memoryBudget = GetPhysicalMemory();
+	coresInUse = 0;
+	memoryInUse = 0;
+	busy = false;
+}
+
+
+/**
+ * @brief Kills any job that is still running
+ *
+ * Kills any job that is still running. Jobs only live as long as the scheduler
+ * that started them, so callers should check GetNumQueuedJobs() and
+ * GetNumRunningJobs() and confirm with the user before deleting a busy scheduler
+ * (see MainWindow::closeEvent()).
+ *
+ */
+JobScheduler::~JobScheduler()
+{
+	for (std::vector<AdcircJob>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+	{
+		if (it->process)
+		{
+			disconnect(it->process, 0, this, 0);
+			it->process->kill();
+			it->process->waitForFinished(JOB_KILL_TIMEOUT);
+			delete it->process;
+			it->process = 0;
+		}
+	}
+}
+
+
+/**
+ * @brief Returns the physical memory of the machine
+ * @return The physical memory in bytes, or 0 if it cannot be determined
+ */
+qint64 JobScheduler::GetPhysicalMemory()
+{
+#ifdef Q_OS_UNIX
+	long pages = sysconf(_SC_PHYS_PAGES);
+	long pageSize = sysconf(_SC_PAGE_SIZE);
+	if (pages > 0 && pageSize > 0)
+		return (qint64)pages * (qint64)pageSize;
+#endif
+	return 0;
+}
+
+
+/**
+ * @brief Estimates the memory a serial ADCIRC run of a mesh will need
+ *
+ * Estimates the memory a serial ADCIRC run of a mesh will need from the number
+ * of nodes on the second line of its fort.14 file.
+ *
+ * @param fort14Path The fort.14 file of the run
+ * @return The estimate in bytes, or 0 if the file could not be read
+ */
+qint64 JobScheduler::EstimateMemory(QString fort14Path)
+{
+	std::ifstream fort14 (fort14Path.toStdString().data());
+	if (!fort14.is_open())
+		return 0;
+
+	std::string line;
+	qint64 numElements = 0, numNodes = 0;
+	if (std::getline(fort14, line) && std::getline(fort14, line))
+		std::stringstream(line) >> numElements >> numNodes;
+
+	return numNodes > 0 ? numNodes * JOB_BYTES_PER_NODE : 0;
+}
+
+
+/**
+ * @brief Sets the number of cores jobs may use at once
+ * @param cores The number of cores
+ */
+void JobScheduler::SetCoreBudget(int cores)
+{
+	coreBudget = cores > 0 ? cores : 1;
+	Schedule();
+}
+
+
+/**
+ * @brief Sets the memory jobs may use at once
+ * @param bytes The memory in bytes, or 0 for no limit
+ */
+void JobScheduler::SetMemoryBudget(qint64 bytes)
+{
+	memoryBudget = bytes > 0 ? bytes : 0;
+	Schedule();
+}
+
+
+/**
+ * @brief Adds a job to the queue
+ *
+ * Adds a job to the queue, and starts it right away if the cores and memory it
+ * needs are free.
+ *
+ * @param name The name shown for the job
+ * @param workingDirectory The directory the job runs in. Its output files are written here.
+ * @param program The executable
+ * @param arguments The arguments passed to the executable
+ * @param cores The number of cores the job uses
+ * @param memory The estimated memory use of the job in bytes, or 0 if unknown
+ * @param priority Higher priorities are started first
+ * @param outputName The output of the job is written to outputName.stdout and outputName.stderr
+ * @return The ID of the job
+ */
+int JobScheduler::SubmitJob(QString name, QString workingDirectory, QString program, QStringList arguments,
+			    int cores, qint64 memory, int priority, QString outputName)
+{
+	AdcircJob job;
+	job.id = nextID++;
+	job.name = name;
+	job.workingDirectory = workingDirectory;
+	job.program = program;
+	job.arguments = arguments;
+	job.outputName = outputName.isEmpty() ? QString(JOB_OUTPUT_NAME) : outputName;
+	job.cores = cores > 0 ? cores : 1;
+	job.memory = memory > 0 ? memory : 0;
+	job.priority = priority;
+	job.state = JobQueued;
+	job.exitCode = 0;
+	job.cancelRequested = false;
+	job.process = 0;
+	jobs.push_back(job);
+	busy = true;
+
+	emit jobStateChanged(job.id, job.name, GetStateName(JobQueued));
+	Schedule();
+
+	return job.id;
+}
+
+
+/**
+ * @brief Cancels a job
+ *
+ * Cancels a job. A queued job is removed from the queue. A running job is asked to
+ * terminate, and is killed if it has not stopped within JOB_KILL_TIMEOUT
+ * milliseconds. Its cores and memory are released once the process has exited.
+ *
+ * @param id The ID of the job
+ * @return true if the job was queued or running
+ */
+bool JobScheduler::CancelJob(int id)
+{
+	AdcircJob *job = FindJob(id);
+	if (!job)
+		return false;
+
+	if (job->state == JobQueued)
+	{
+		job->state = JobCancelled;
+		job->endTime = QDateTime::currentDateTime();
+		emit jobStateChanged(job->id, job->name, GetStateName(JobCancelled));
+		CheckIfIdle();
+		return true;
+	}
+
+	if (job->state == JobRunning && job->process && !job->cancelRequested)
+	{
+		job->cancelRequested = true;
+		job->process->terminate();
+		QTimer::singleShot(JOB_KILL_TIMEOUT, job->process, SLOT(kill()));
+		return true;
+	}
+
+	return false;
+}
+
+
+void JobScheduler::CancelAllJobs()
+{
+	for (unsigned int i=0; i<jobs.size(); ++i)
+		CancelJob(jobs[i].id);
+}
+
+
+int JobScheduler::GetCoreBudget()
+{
+	return coreBudget;
+}
+
+
+qint64 JobScheduler::GetMemoryBudget()
+{
+	return memoryBudget;
+}
+
+
+int JobScheduler::GetNumQueuedJobs()
+{
+	int count = 0;
+	for (std::vector<AdcircJob>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+		if (it->state == JobQueued)
+			++count;
+	return count;
+}
+
+
+int JobScheduler::GetNumRunningJobs()
+{
+	int count = 0;
+	for (std::vector<AdcircJob>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+		if (it->state == JobRunning)
+			++count;
+	return count;
+}
+
+
+/**
+ * @brief Returns a job
+ * @param id The ID of the job
+ * @return The job, or 0 if there is no job with the ID. Only valid until the next job is submitted.
+ */
+const AdcircJob* JobScheduler::GetJob(int id)
+{
+	return FindJob(id);
+}
+
+
+QString JobScheduler::GetStateName(JobState state)
+{
+	switch (state)
+	{
+		case JobQueued:		return QString("Queued");
+		case JobRunning:	return QString("Running");
+		case JobFinished:	return QString("Finished");
+		case JobFailed:		return QString("Failed");
+		case JobCancelled:	return QString("Cancelled");
+	}
+	return QString("Unknown");
+}
+
+
+AdcircJob* JobScheduler::FindJob(int id)
+{
+	for (std::vector<AdcircJob>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+		if (it->id == id)
+			return &(*it);
+	return 0;
+}
+
+
+AdcircJob* JobScheduler::FindJob(QProcess *process)
+{
+	for (std::vector<AdcircJob>::iterator it = jobs.begin(); it != jobs.end(); ++it)
+		if (process && it->process == process)
+			return &(*it);
+	return 0;
+}
+
+
+/**
+ * @brief Checks if a job fits in the cores and memory that are still free
+ * @param job The job
+ * @return true if the job can be started now
+ */
+bool JobScheduler::Fits(const AdcircJob &job)
+{
+	if (coresInUse + job.cores > coreBudget)
+		return false;
+	if (memoryBudget > 0 && memoryInUse + job.memory > memoryBudget)
+		return false;
+	return true;
+}
+
+
+/**
+ * @brief Starts the process of a queued job
+ *
+ * Starts the process of a queued job and reserves its cores and memory. The
+ * process is only launched here. A failure to launch is reported through
+ * processError().
+ *
+ * @param job The job
+ * @return true if the process was launched
+ */
+bool JobScheduler::StartJob(AdcircJob &job)
+{
+	QDir directory (job.workingDirectory);
+	if (!directory.exists())
+	{
+		job.state = JobFailed;
+		job.exitCode = -1;
+		job.endTime = QDateTime::currentDateTime();
+
+		int id = job.id;
+		QString name = job.name;
+		emit emitMessage("<p style='color:red'><strong>Error:</strong> " + name + " - " +
+				 job.workingDirectory + " does not exist</p>");
+		emit jobStateChanged(id, name, GetStateName(JobFailed));
+		emit jobFinished(id, -1);
+		return false;
+	}
+
+	job.process = new QProcess(this);
+	job.process->setWorkingDirectory(job.workingDirectory);
+	job.process->setStandardOutputFile(directory.absoluteFilePath(job.outputName + ".stdout"));
+	job.process->setStandardErrorFile(directory.absoluteFilePath(job.outputName + ".stderr"));
+	connect(job.process, SIGNAL(finished(int,QProcess::ExitStatus)), this, SLOT(processFinished(int,QProcess::ExitStatus)));
+	connect(job.process, SIGNAL(error(QProcess::ProcessError)), this, SLOT(processError(QProcess::ProcessError)));
+
+	job.state = JobRunning;
+	job.startTime = QDateTime::currentDateTime();
+	coresInUse += job.cores;
+	memoryInUse += job.memory;
+
+	/* Copy what is needed to launch, since a slot may submit a job and move the vector */
+	QProcess *process = job.process;
+	QString program = job.program;
+	QStringList arguments = job.arguments;
+	emit jobStateChanged(job.id, job.name, GetStateName(JobRunning));
+	process->start(program, arguments);
+	return true;
+}
+
+
+/**
+ * @brief Releases the cores and memory of a job that has stopped
+ * @param job The job
+ * @param newState The state the job ended in
+ * @param exitCode The exit code of the process
+ */
+void JobScheduler::ReleaseJob(AdcircJob &job, JobState newState, int exitCode)
+{
+	if (job.state != JobRunning)
+		return;
+
+	coresInUse -= job.cores;
+	memoryInUse -= job.memory;
+	job.state = newState;
+	job.exitCode = exitCode;
+	job.endTime = QDateTime::currentDateTime();
+	if (job.process)
+	{
+		disconnect(job.process, 0, this, 0);
+		job.process->deleteLater();
+		job.process = 0;
+	}
+
+	/* Copy what the signals need, since a slot may submit a job and move the vector */
+	int id = job.id;
+	QString name = job.name;
+	emit jobStateChanged(id, name, GetStateName(newState));
+	emit jobFinished(id, exitCode);
+}
+
+
+/**
+ * @brief Starts every queued job that fits in the budget
+ *
+ * Starts every queued job that fits in the budget, highest priority first and
+ * then in the order they were submitted. Jobs that do not fit are skipped so that
+ * smaller jobs can fill the free cores. A job that needs more than the whole budget
+ * is started once nothing else is running, and nothing behind it is started while
+ * it waits.
+ *
+ * Jobs are referred to by index, since a slot connected to one of the signals may
+ * submit another job while the queue is being walked.
+ *
+ */
+void JobScheduler::Schedule()
+{
+	std::vector<unsigned int> queue;
+	for (unsigned int i=0; i<jobs.size(); ++i)
+		if (jobs[i].state == JobQueued)
+			queue.push_back(i);
+	std::stable_sort(queue.begin(), queue.end(), HigherPriority(jobs));
+
+	for (std::vector<unsigned int>::iterator it = queue.begin(); it != queue.end(); ++it)
+	{
+		AdcircJob &job = jobs[*it];
+		if (job.state != JobQueued)
+			continue;
+
+		bool oversized = job.cores > coreBudget || (memoryBudget > 0 && job.memory > memoryBudget);
+		if (oversized)
+		{
+			if (coresInUse == 0)
+				StartJob(job);
+			break;
+		}
+
+		if (Fits(job))
+			StartJob(job);
+	}
+
+	CheckIfIdle();
+}
+
+
+/**
+ * @brief Emits allJobsFinished() when the last queued or running job has stopped
+ */
+void JobScheduler::CheckIfIdle()
+{
+	if (busy && GetNumQueuedJobs() == 0 && GetNumRunningJobs() == 0)
+	{
+		busy = false;
+		emit allJobsFinished();
+	}
+}
+
+
+void JobScheduler::cancelJob(int id)
+{
+	CancelJob(id);
+}
+
+
+void JobScheduler::processFinished(int exitCode, QProcess::ExitStatus exitStatus)
+{
+	AdcircJob *job = FindJob(qobject_cast<QProcess*>(sender()));
+	if (!job)
+		return;
+
+	JobState newState = JobFinished;
+	if (job->cancelRequested)
+		newState = JobCancelled;
+	else if (exitStatus != QProcess::NormalExit || exitCode != 0)
+		newState = JobFailed;
+
+	if (newState == JobFailed)
+		emit emitMessage("<p style='color:red'><strong>Error:</strong> " + job->name + " exited with code " +
+				 QString::number(exitCode) + ". See " + job->outputName + ".stderr in " + job->workingDirectory + "</p>");
+
+	ReleaseJob(*job, newState, exitStatus == QProcess::NormalExit ? exitCode : -1);
+	Schedule();
+}
+
+
+/**
+ * @brief Handles a process that could not be launched
+ *
+ * Handles a process that could not be launched. Every other error is followed by
+ * finished(), which is handled by processFinished().
+ *
+ */
+void JobScheduler::processError(QProcess::ProcessError error)
+{
+	if (error != QProcess::FailedToStart)
+		return;
+
+	AdcircJob *job = FindJob(qobject_cast<QProcess*>(sender()));
+	if (!job)
+		return;
+
+	emit emitMessage("<p style='color:red'><strong>Error:</strong> Unable to start " + job->program +
+			 " for " + job->name + "</p>");
+
+	ReleaseJob(*job, job->cancelRequested ? JobCancelled : JobFailed, -1);
+	Schedule();
+}
@@ -0,0 +1,160 @@
+#ifndef JOBSCHEDULER_H
+#define JOBSCHEDULER_H
+
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QProcess>
+#include <QDir>
+#include <QThread>
+#include <QDateTime>
+#include <QTimer>
+
+#ifdef Q_OS_UNIX
+#include <unistd.h>
+#endif
+
+#define JOB_OUTPUT_NAME		"adcirc"	/**< Output is written to <name>.stdout and <name>.stderr */
+#define JOB_BYTES_PER_NODE	2048		/**< Rough memory use of serial ADCIRC per mesh node */
+#define JOB_KILL_TIMEOUT	5000
+
+
+/**
+ * @brief The states an AdcircJob moves through
+ */
+enum JobState
+{
+	JobQueued,
+	JobRunning,
+	JobFinished,
+	JobFailed,
+	JobCancelled
+};
+
+
+/**
+ * @brief A single run managed by a JobScheduler
+ */
+struct AdcircJob
+{
+	int		id;
+	QString		name;
+	QString		workingDirectory;
+	QString		program;
+	QStringList	arguments;
+	QString		outputName;
+	int		cores;
+	qint64		memory;		/**< Estimated memory use in bytes, or 0 if unknown */
+	int		priority;	/**< Higher priorities are started first */
+	JobState	state;
+	int		exitCode;
+	bool		cancelRequested;	/**< The process has been asked to stop */
+	QDateTime	startTime;
+	QDateTime	endTime;
+	QProcess*	process;
+};
+
+
+/**
+ * @brief Orders job indices by descending priority, for use with std::stable_sort()
+ */
+struct HigherPriority
+{
+	const std::vector<AdcircJob> &jobs;
+	HigherPriority(const std::vector<AdcircJob> &newJobs) : jobs(newJobs) {}
+	bool operator()(unsigned int a, unsigned int b) const { return jobs[a].priority > jobs[b].priority; }
+};
+
+
+/**
+ * @brief Runs ADCIRC jobs as managed processes within a core and memory budget
+ *
+ * Runs ADCIRC jobs as managed processes within a core and memory budget. Jobs are
+ * queued with a priority and started, highest priority first and then in the order
+ * they were submitted, as soon as the cores and memory they need are free. A job that
+ * does not fit does not hold up smaller jobs behind it, except that nothing new is
+ * started past a job that needs more than the whole budget until every running job
+ * has finished, so it can run on its own.
+ *
+ * The standard output and error of each job are written to adcirc.stdout and
+ * adcirc.stderr in its working directory, unless the job is given a different
+ * output name.
+ *
+ * The scheduler does not know anything about ADCIRC itself, so it can be exercised
+ * with any stand-in executable (a shell script that sleeps, for example) in place of
+ * the model.
+ *
+ * The object lives on the GUI thread. Processes are watched through QProcess signals,
+ * so nothing blocks while jobs run.
+ *
+ */
+class JobScheduler : public QObject
+{
+		Q_OBJECT
+	public:
+		JobScheduler(QObject *parent=0);
+		~JobScheduler();
+
+		static qint64	GetPhysicalMemory();
+		static qint64	EstimateMemory(QString fort14Path);
+
+		void	SetCoreBudget(int cores);
+		void	SetMemoryBudget(qint64 bytes);
+
+		int	SubmitJob(QString name, QString workingDirectory, QString program, QStringList arguments=QStringList(),
+				  int cores=1, qint64 memory=0, int priority=0, QString outputName=JOB_OUTPUT_NAME);
+		bool	CancelJob(int id);
+		void	CancelAllJobs();
+
+		/* Getter Methods */
+		int		GetCoreBudget();
+		qint64		GetMemoryBudget();
+		int		GetNumQueuedJobs();
+		int		GetNumRunningJobs();
+		const AdcircJob*	GetJob(int id);
+
+		static QString	GetStateName(JobState state);
+
+	private:
+
+		int			nextID;
+		int			coreBudget;
+		qint64			memoryBudget;	/**< Memory available to jobs in bytes, or 0 for no limit */
+		int			coresInUse;
+		qint64			memoryInUse;
+		std::vector<AdcircJob>	jobs;		/**< Every job submitted, in submission order */
+		bool			busy;		/**< A job has been queued since allJobsFinished() was last emitted */
+
+		AdcircJob*	FindJob(int id);
+		AdcircJob*	FindJob(QProcess *process);
+		bool		Fits(const AdcircJob &job);
+		bool		StartJob(AdcircJob &job);
+		void		ReleaseJob(AdcircJob &job, JobState newState, int exitCode);
+		void		Schedule();
+		void		CheckIfIdle();
+
+	public slots:
+
+		void	cancelJob(int id);
+
+	private slots:
+
+		void	processFinished(int exitCode, QProcess::ExitStatus exitStatus);
+		void	processError(QProcess::ProcessError error);
+
+	signals:
+
+		void	jobStateChanged(int id, QString name, QString state);
+		void	jobFinished(int id, int exitCode);
+		void	allJobsFinished();
+		void	emitMessage(QString);
+
+};
+
+#endif // JOBSCHEDULER_H
@@ -0,0 +1,713 @@
+#include "Pipeline.h"
+
+Pipeline::Pipeline(JobScheduler *newScheduler, ProjectFile *newProjectFile, QObject *parent) :
+	QObject(parent),
+	scheduler(newScheduler),
+	projectFile(newProjectFile)
+{
+	fullDomain = 0;
+	subdomainExecutable = "";
+	running = false;
+	stopRequested = false;
+
+	fullDomainRun = 0;
+	fort015Writer = 0;
+	fort13Carver = 0;
+	fort066Carver = 0;
+
+	if (scheduler)
+		connect(scheduler, SIGNAL(jobFinished(int,int)), this, SLOT(jobFinished(int,int)));
+	connect(&fort015Tasks, SIGNAL(finished()), this, SLOT(fort015Written()));
+	connect(&fort13Tasks, SIGNAL(finished()), this, SLOT(fort13CarvingFinished()));
+	connect(&fort066Tasks, SIGNAL(finished()), this, SLOT(fort066CarvingFinished()));
+}
+
+
+Pipeline::~Pipeline()
+{
+	if (fort015Writer)
+	{
+		fort015Tasks.Cancel();
+		fort015Tasks.Wait();
+		delete fort015Writer;
+	}
+
+	if (fort066Carver)
+	{
+		fort066Carver->StopCarving();
+		fort066Tasks.Cancel();
+		fort066Tasks.Wait();
+		delete fort066Carver;
+	}
+
+	if (fort13Carver)
+	{
+		fort13Tasks.Cancel();
+		fort13Tasks.Wait();
+		delete fort13Carver;
+	}
+
+	if (fullDomainRun)
+		delete fullDomainRun;
+}
+
+
+void Pipeline::SetFullDomain(Domain *newFull)
+{
+	fullDomain = newFull;
+}
+
+
+void Pipeline::SetSubdomains(std::map<QString, Domain *> newSubs)
+{
+	subDomains = newSubs;
+}
+
+
+/**
+ * @brief Sets the ADCIRC executable offered for the full domain run
+ * @param newLoc The executable
+ */
+void Pipeline::SetAdcircExecutable(QString newLoc)
+{
+	runner.SetAdcircExecutable(newLoc);
+}
+
+
+/**
+ * @brief Sets the padcirc executable offered for a full domain run on more than one processor
+ * @param newLoc The executable
+ */
+void Pipeline::SetPadcircExecutable(QString newLoc)
+{
+	runner.SetPadcircExecutable(newLoc);
+}
+
+
+/**
+ * @brief Sets the serial ADCIRC executable used for the subdomain runs
+ * @param newLoc The executable
+ */
+void Pipeline::SetSubdomainExecutable(QString newLoc)
+{
+	subdomainExecutable = newLoc;
+}
+
+
+/**
+ * @brief Asks the user for the options of the full domain run
+ *
+ * Asks the user for the options of the full domain run. The options are also
+ * used by the steps after the full domain run, so this must be done every time
+ * the pipeline is started, even if the full domain run is already done.
+ *
+ * @return true if the options were accepted
+ */
+bool Pipeline::Configure()
+{
+	if (running || !fullDomain)
+		return false;
+
+	std::vector<Domain*> subdomainList;
+	for (std::map<QString, Domain*>::iterator it = subDomains.begin(); it != subDomains.end(); ++it)
+		subdomainList.push_back(it->second);
+
+	runner.SetFullDomain(fullDomain);
+	runner.SetSubDomains(subdomainList);
+	return runner.ShowRunOptionsDialog();
+}
+
+
+/**
+ * @brief Starts every step that is not already done
+ *
+ * Starts every step that is not already done, according to the states saved in
+ * the project file. Configure() must have been called first.
+ *
+ * @return true if the pipeline was started
+ */
+bool Pipeline::Start()
+{
+	if (running || !fullDomain || !scheduler || !projectFile)
+		return false;
+
+	BuildSteps();
+	LoadState();
+
+	running = true;
+	stopRequested = false;
+	emit emitMessage("<p>Starting the run pipeline. " + QString::number(GetNumStepsDone()) + " of " +
+			 QString::number(GetNumSteps()) + " steps are already done.</p>");
+	emit progress(GetNumSteps() > 0 ? 100*GetNumStepsDone()/GetNumSteps() : 100);
+
+	StartReadySteps();
+	CheckIfFinished();
+	return true;
+}
+
+
+/**
+ * @brief Stops every running step. Nothing new is started.
+ *
+ * Stops every running step, and nothing new is started. The stopped steps are
+ * marked as failed and run again when the pipeline is next started. A fort.015
+ * write or fort.13 carve cannot be interrupted, and is left to finish.
+ *
+ */
+void Pipeline::Stop()
+{
+	if (!running)
+		return;
+
+	stopRequested = true;
+	for (std::vector<PipelineStep>::iterator it = steps.begin(); it != steps.end(); ++it)
+		if (it->type == SubdomainRunStep && it->state == StepRunning && it->jobID >= 0)
+			scheduler->CancelJob(it->jobID);
+	if (fullDomainRun)
+		fullDomainRun->Cancel();
+	if (fort066Carver)
+		fort066Carver->StopCarving();
+}
+
+
+/**
+ * @brief Forgets the saved state of every step, so the next start runs the whole pipeline
+ */
+void Pipeline::Reset()
+{
+	if (running)
+		return;
+
+	if (projectFile)
+		projectFile->ClearPipelineState();
+	steps.clear();
+}
+
+
+bool Pipeline::IsRunning()
+{
+	return running;
+}
+
+
+int Pipeline::GetNumSteps()
+{
+	return steps.size();
+}
+
+
+int Pipeline::GetNumStepsDone()
+{
+	int count = 0;
+	for (std::vector<PipelineStep>::iterator it = steps.begin(); it != steps.end(); ++it)
+		if (it->state == StepDone)
+			++count;
+	return count;
+}
+
+
+QString Pipeline::GetStateName(PipelineStepState state)
+{
+	switch (state)
+	{
+		case StepPending:	return QString("pending");
+		case StepRunning:	return QString(PIPELINE_STATE_RUNNING);
+		case StepDone:		return QString(PIPELINE_STATE_DONE);
+		case StepFailed:	return QString(PIPELINE_STATE_FAILED);
+	}
+	return QString("unknown");
+}
+
+
+unsigned int Pipeline::AddStep(QString name, PipelineStepType type, Domain *domain, QString subdomainName)
+{
+	PipelineStep step;
+	step.name = name;
+	step.type = type;
+	step.subdomainName = subdomainName;
+	step.domain = domain;
+	step.state = StepPending;
+	step.jobID = -1;
+	steps.push_back(step);
+	steps.back().inputs = FingerprintInputs(steps.size()-1);
+	return steps.size()-1;
+}
+
+
+/**
+ * @brief Builds the dependency graph for the full domain and the current subdomains
+ *
+ * Builds the dependency graph for the full domain and the current subdomains.
+ * Every step is added after the steps it depends on, which LoadState() relies on.
+ *
+ */
+void Pipeline::BuildSteps()
+{
+	steps.clear();
+
+	unsigned int prepareFull = AddStep("fullDomain:prepare", PrepareFullDomainStep, fullDomain);
+
+	int carveFort13 = -1;
+	if (QFile(fullDomain->GetDomainPath() + QDir::separator() + "fort.13").exists())
+		carveFort13 = AddStep("fullDomain:carveFort13", CarveFort13Step, fullDomain);
+
+	unsigned int runFull = AddStep("fullDomain:run", FullDomainRunStep, fullDomain);
+	steps[runFull].dependencies.push_back(prepareFull);
+
+	unsigned int carveFort066 = AddStep("fullDomain:carveFort066", CarveFort066Step, fullDomain);
+	steps[carveFort066].dependencies.push_back(runFull);
+
+	for (std::map<QString, Domain*>::iterator it = subDomains.begin(); it != subDomains.end(); ++it)
+	{
+		if (!it->second)
+			continue;
+
+		unsigned int prepareSub = AddStep(it->first + ":prepare", PrepareSubdomainStep, it->second, it->first);
+		unsigned int runSub = AddStep(it->first + ":run", SubdomainRunStep, it->second, it->first);
+		steps[runSub].dependencies.push_back(prepareSub);
+		steps[runSub].dependencies.push_back(carveFort066);
+		if (carveFort13 >= 0)
+			steps[runSub].dependencies.push_back(carveFort13);
+	}
+}
+
+
+/**
+ * @brief Marks every step that the project file records as done with the current inputs
+ *
+ * Marks every step that the project file records as done with the current inputs.
+ * Every other step, including one that was running when the pipeline was interrupted,
+ * one whose inputs have changed since it was done, and every step that depends on
+ * one of those, will be run.
+ *
+ */
+void Pipeline::LoadState()
+{
+	for (unsigned int i=0; i<steps.size(); ++i)
+	{
+		steps[i].state = StepPending;
+		if (projectFile->GetPipelineStepState(steps[i].name) != PIPELINE_STATE_DONE)
+			continue;
+
+		if (projectFile->GetPipelineStepInputs(steps[i].name) != steps[i].inputs)
+		{
+			emit emitMessage("<p>The inputs of pipeline step " + steps[i].name + " have changed, so it will be run again</p>");
+			continue;
+		}
+
+		/* Dependencies come first, so their states are already known */
+		if (DependenciesDone(i))
+			steps[i].state = StepDone;
+	}
+}
+
+
+/**
+ * @brief Fingerprints the files and options a step reads
+ *
+ * Fingerprints the files and options a step reads, so that a step that is already
+ * done can be told apart from one whose inputs have changed since. Files are
+ * identified by their path, size and modification time.
+ *
+ * @param step The index of the step
+ * @return A hash of the inputs
+ */
+QString Pipeline::FingerprintInputs(unsigned int step)
+{
+	PipelineStep &current = steps[step];
+	QStringList inputs;
+	inputs << current.name;
+
+	QStringList subdomainSet;
+	for (std::map<QString, Domain*>::iterator it = subDomains.begin(); it != subDomains.end(); ++it)
+		if (it->second)
+			subdomainSet << it->first << FingerprintFile(it->second->GetFort14Location());
+
+	switch (current.type)
+	{
+		case PrepareFullDomainStep:
+			inputs << FingerprintFile(fullDomain->GetFort14Location()) << FingerprintFile(fullDomain->GetFort15Location());
+			inputs << subdomainSet;
+			inputs << QString::number(runner.GetSubdomainApproach()) << QString::number(runner.GetRecordFrequency());
+			break;
+		case CarveFort13Step:
+			inputs << FingerprintFile(fullDomain->GetDomainPath() + QDir::separator() + "fort.13");
+			inputs << subdomainSet;
+			break;
+		case FullDomainRunStep:
+			inputs << FingerprintFile(fullDomain->GetFort14Location()) << FingerprintFile(fullDomain->GetFort15Location());
+			inputs << runner.GetRunExecutable() << QString::number(runner.GetNumProcessors());
+			break;
+		case CarveFort066Step:
+			inputs << subdomainSet;
+			inputs << QString::number(runner.GetResampleInterval());
+			break;
+		case PrepareSubdomainStep:
+			inputs << FingerprintFile(current.domain->GetFort14Location());
+			inputs << QString::number(runner.GetSubdomainApproach());
+			break;
+		case SubdomainRunStep:
+			inputs << FingerprintFile(current.domain->GetFort14Location()) << FingerprintFile(current.domain->GetFort15Location());
+			inputs << subdomainExecutable;
+			break;
+	}
+
+	return QString(QCryptographicHash::hash(inputs.join("\n").toUtf8(), QCryptographicHash::Md5).toHex());
+}
+
+
+QString Pipeline::FingerprintFile(QString path)
+{
+	QFileInfo info (path);
+	if (!info.exists())
+		return path + " (missing)";
+	return info.absoluteFilePath() + " " + QString::number(info.size()) + " " + info.lastModified().toString(Qt::ISODate);
+}
+
+
+bool Pipeline::DependenciesDone(unsigned int step)
+{
+	for (std::vector<unsigned int>::iterator it = steps[step].dependencies.begin(); it != steps[step].dependencies.end(); ++it)
+		if (steps[*it].state != StepDone)
+			return false;
+	return true;
+}
+
+
+/**
+ * @brief Finds the running step of a type that only has a single step
+ * @param type The type
+ * @return The index of the step, or -1 if no step of the type is running
+ */
+int Pipeline::FindRunningStep(PipelineStepType type)
+{
+	for (unsigned int i=0; i<steps.size(); ++i)
+		if (steps[i].type == type && steps[i].state == StepRunning)
+			return i;
+	return -1;
+}
+
+
+/**
+ * @brief Starts every pending step whose dependencies are done
+ */
+void Pipeline::StartReadySteps()
+{
+	if (stopRequested)
+		return;
+
+	for (unsigned int i=0; i<steps.size(); ++i)
+		if (steps[i].state == StepPending && DependenciesDone(i))
+			StartStep(i);
+}
+
+
+/**
+ * @brief Starts a single step
+ *
+ * Starts a single step. Preparing a subdomain only writes small files, so it is
+ * done right away. Writing the full domain fort.015 and the carves run on the
+ * TaskScheduler, and the ADCIRC runs are handed to the JobScheduler. Their slots
+ * finish the step.
+ *
+ * @param step The index of the step
+ */
+void Pipeline::StartStep(unsigned int step)
+{
+	SetStepState(step, StepRunning);
+
+	bool started = false;
+	switch (steps[step].type)
+	{
+		case PrepareFullDomainStep:
+			started = StartFort015Writing(step);
+			break;
+		case PrepareSubdomainStep:
+			StepFinished(step, PrepareSubdomain(step));
+			return;
+		case CarveFort13Step:
+			started = StartFort13Carving(step);
+			break;
+		case FullDomainRunStep:
+			started = StartFullDomainRun(step);
+			break;
+		case CarveFort066Step:
+			started = StartFort066Carving(step);
+			break;
+		case SubdomainRunStep:
+			started = StartSubdomainRun(step);
+			break;
+	}
+
+	if (!started)
+		StepFinished(step, false);
+}
+
+
+/**
+ * @brief Records the outcome of a step and starts the steps that were waiting on it
+ * @param step The index of the step
+ * @param succeeded true if the step is done
+ */
+void Pipeline::StepFinished(unsigned int step, bool succeeded)
+{
+	SetStepState(step, succeeded ? StepDone : StepFailed);
+	if (!succeeded)
+		emit emitMessage("<p style='color:red'><strong>Error:</strong> Pipeline step " + steps[step].name + " failed</p>");
+
+	emit progress(GetNumSteps() > 0 ? 100*GetNumStepsDone()/GetNumSteps() : 100);
+
+	StartReadySteps();
+	CheckIfFinished();
+}
+
+
+/**
+ * @brief Changes the state of a step and saves it in the project file
+ * @param step The index of the step
+ * @param newState The new state
+ */
+void Pipeline::SetStepState(unsigned int step, PipelineStepState newState)
+{
+	steps[step].state = newState;
+	if (newState == StepDone)
+		projectFile->SetPipelineStepState(steps[step].name, GetStateName(newState), steps[step].inputs);
+	else if (newState != StepPending)
+		projectFile->SetPipelineStepState(steps[step].name, GetStateName(newState));
+	emit stepStateChanged(steps[step].name, GetStateName(newState));
+}
+
+
+/**
+ * @brief Emits finished() once no step is running and nothing more can be started
+ */
+void Pipeline::CheckIfFinished()
+{
+	if (!running)
+		return;
+
+	for (std::vector<PipelineStep>::iterator it = steps.begin(); it != steps.end(); ++it)
+		if (it->state == StepRunning)
+			return;
+
+	running = false;
+	bool allDone = GetNumStepsDone() == GetNumSteps();
+	if (allDone)
+		emit emitMessage("<p>The run pipeline has finished</p>");
+	else
+		emit emitMessage("<p style='color:red'><strong>Error:</strong> The run pipeline stopped with " +
+				 QString::number(GetNumSteps()-GetNumStepsDone()) + " steps left to do. " +
+				 "Run it again to continue from the last completed steps.</p>");
+	emit finished(allDone);
+}
+
+
+/**
+ * @brief Starts writing the full domain fort.015 file as a task on the TaskScheduler
+ * @return true if the task was started
+ */
+bool Pipeline::StartFort015Writing(unsigned int)
+{
+	if (fort015Writer)
+		return false;
+
+	fort015Writer = runner.CreateFort015Writer();
+	if (!fort015Writer)
+		return false;
+
+	TaskScheduler::Instance()->Start(fort015Writer, "writeFullDomain", TASK_PRIORITY_HIGH, &fort015Tasks);
+	return true;
+}
+
+
+bool Pipeline::StartFort13Carving(unsigned int step)
+{
+	if (fort13Carver)
+		return false;
+
+	std::vector<SubdomainFiles> subdomainList;
+	for (std::map<QString, Domain*>::iterator it = subDomains.begin(); it != subDomains.end(); ++it)
+		if (it->second)
+			subdomainList.push_back(it->second->GetSubdomainFiles());
+
+	fort13Carver = new Fort13(steps[step].domain->GetDomainPath() + QDir::separator() + "fort.13");
+	fort13Carver->SetSubdomains(subdomainList);
+
+	connect(fort13Carver, SIGNAL(emitMessage(QString)), this, SIGNAL(emitMessage(QString)));
+
+	TaskScheduler::Instance()->Start(fort13Carver, "carveAllSubdomains", TASK_PRIORITY_NORMAL, &fort13Tasks);
+	return true;
+}
+
+
+bool Pipeline::StartFort066Carving(unsigned int step)
+{
+	if (fort066Carver)
+		return false;
+
+	std::vector<SubdomainFiles> subdomainList;
+	for (std::map<QString, Domain*>::iterator it = subDomains.begin(); it != subDomains.end(); ++it)
+		if (it->second)
+			subdomainList.push_back(it->second->GetSubdomainFiles());
+
+	fort066Carver = new Fort066(steps[step].domain->GetDomainPath() + QDir::separator() + "fort.066");
+	fort066Carver->SetSubdomains(subdomainList);
+	double recordInterval = runner.GetRecordInterval();
+	if (runner.GetResampleInterval() > 0.0 && recordInterval <= 0.0)
+		emit emitMessage("<p style='color:red'><strong>Error:</strong> Unable to read the timestep (DTDP) from fort.15, boundary conditions will not be resampled</p>");
+	fort066Carver->SetResampling(recordInterval, runner.GetResampleInterval());
+
+	connect(fort066Carver, SIGNAL(emitMessage(QString)), this, SIGNAL(emitMessage(QString)));
+
+	TaskScheduler::Instance()->Start(fort066Carver, "carveAllSubdomains", TASK_PRIORITY_NORMAL, &fort066Tasks);
+	return true;
+}
+
+
+bool Pipeline::StartFullDomainRun(unsigned int)
+{
+	if (fullDomainRun)
+		return false;
+
+	fullDomainRun = new AdcircRun(scheduler);
+	connect(fullDomainRun, SIGNAL(emitMessage(QString)), this, SIGNAL(emitMessage(QString)));
+	connect(fullDomainRun, SIGNAL(finished(int)), this, SLOT(fullDomainRunFinished(int)));
+	if (runner.PerformFullDomainRun(fullDomainRun))
+		return true;
+
+	/* A run that failed to launch has already been finished by fullDomainRunFinished() */
+	if (!fullDomainRun)
+		return true;
+
+	delete fullDomainRun;
+	fullDomainRun = 0;
+	return false;
+}
+
+
+/**
+ * @brief Queues the ADCIRC run of a subdomain
+ * @param step The index of the step
+ * @return true if the run was queued
+ */
+bool Pipeline::StartSubdomainRun(unsigned int step)
+{
+	if (subdomainExecutable.isEmpty())
+	{
+		emit emitMessage("<p style='color:red'><strong>Error:</strong> The ADCIRC executable has not been set in the project settings</p>");
+		return false;
+	}
+
+	Domain *subdomain = steps[step].domain;
+	int id = scheduler->SubmitJob(steps[step].subdomainName,
+				      subdomain->GetDomainPath(),
+				      subdomainExecutable,
+				      QStringList(),
+				      1,
+				      JobScheduler::EstimateMemory(subdomain->GetFort14Location()));
+	steps[step].jobID = id;
+
+	/* A job that could not be started has already finished by the time SubmitJob() returns */
+	const AdcircJob *job = scheduler->GetJob(id);
+	return job && (job->state == JobQueued || job->state == JobRunning);
+}
+
+
+/**
+ * @brief Writes the fort.015 file that makes ADCIRC force a subdomain with its carved boundary conditions
+ * @param step The index of the step
+ * @return true if the file was written
+ */
+bool Pipeline::PrepareSubdomain(unsigned int step)
+{
+	Fort015 fort015;
+	fort015.SetPath(steps[step].domain->GetDomainPath());
+	fort015.SetApproach(runner.GetSubdomainApproach());
+	return fort015.WriteFort015Subdomain();
+}
+
+
+void Pipeline::jobFinished(int id, int)
+{
+	for (unsigned int i=0; i<steps.size(); ++i)
+	{
+		if (steps[i].type == SubdomainRunStep && steps[i].state == StepRunning && steps[i].jobID == id)
+		{
+			const AdcircJob *job = scheduler->GetJob(id);
+			StepFinished(i, job && job->state == JobFinished);
+			return;
+		}
+	}
+}
+
+
+void Pipeline::fullDomainRunFinished(int)
+{
+	bool succeeded = false;
+	if (fullDomainRun)
+	{
+		succeeded = fullDomainRun->GetStage() == RunFinished;
+
+		/* The run is still emitting finished(), so it cannot be deleted from here */
+		fullDomainRun->deleteLater();
+		fullDomainRun = 0;
+	}
+
+	int step = FindRunningStep(FullDomainRunStep);
+	if (step >= 0)
+		StepFinished(step, succeeded);
+}
+
+
+void Pipeline::fort015Written()
+{
+	/* The writing task has finished, so the writer can be deleted from here */
+	bool succeeded = false;
+	if (fort015Writer)
+	{
+		succeeded = fort015Writer->FullDomainWritten();
+		delete fort015Writer;
+		fort015Writer = 0;
+	}
+
+	int step = FindRunningStep(PrepareFullDomainStep);
+	if (step >= 0)
+		StepFinished(step, succeeded && !stopRequested && runner.CheckForRequiredFiles());
+}
+
+
+void Pipeline::fort13CarvingFinished()
+{
+	/* The carving task has finished, so the carver can be deleted from here */
+	if (fort13Carver)
+	{
+		delete fort13Carver;
+		fort13Carver = 0;
+	}
+
+	bool succeeded = true;
+	for (std::map<QString, Domain*>::iterator it = subDomains.begin(); it != subDomains.end(); ++it)
+		if (it->second && !QFile(it->second->GetDomainPath() + QDir::separator() + "fort.13").exists())
+			succeeded = false;
+
+	int step = FindRunningStep(CarveFort13Step);
+	if (step >= 0)
+		StepFinished(step, succeeded);
+}
+
+
+void Pipeline::fort066CarvingFinished()
+{
+	/* The carving task has finished, so the carver can be deleted from here */
+	bool succeeded = false;
+	if (fort066Carver)
+	{
+		succeeded = fort066Carver->CarvedAllTimesteps();
+		delete fort066Carver;
+		fort066Carver = 0;
+	}
+
+	int step = FindRunningStep(CarveFort066Step);
+	if (step >= 0)
+		StepFinished(step, succeeded);
+}
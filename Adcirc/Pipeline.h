@@ -0,0 +1,182 @@
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <map>
+#include <vector>
+
+#include <QObject>
+#include <QString>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QCryptographicHash>
+
+#include "Domains/Domain.h"
+#include "Projects/ProjectFile.h"
+#include "Projects/IO/FileIO/Fort015.h"
+#include "Projects/IO/FileIO/Fort066.h"
+#include "Projects/IO/FileIO/Fort13.h"
+
+#include "Adcirc/FullDomainRunner.h"
+#include "Adcirc/AdcircRun.h"
+#include "Adcirc/JobScheduler.h"
+
+#include "Tasks/TaskScheduler.h"
+
+#define PIPELINE_STATE_RUNNING	"running"
+#define PIPELINE_STATE_DONE	"done"
+#define PIPELINE_STATE_FAILED	"failed"
+
+
+/**
+ * @brief The kinds of work a PipelineStep can do
+ */
+enum PipelineStepType
+{
+	PrepareFullDomainStep,	/**< Write fort.015 and check the full domain input files */
+	CarveFort13Step,	/**< Carve the full domain fort.13 into every subdomain */
+	FullDomainRunStep,	/**< Run ADCIRC on the full domain */
+	CarveFort066Step,	/**< Carve the recorded boundary conditions into every subdomain fort.020 */
+	PrepareSubdomainStep,	/**< Write the subdomain fort.015 */
+	SubdomainRunStep	/**< Run ADCIRC on the subdomain */
+};
+
+
+/**
+ * @brief The states a PipelineStep moves through
+ */
+enum PipelineStepState
+{
+	StepPending,
+	StepRunning,
+	StepDone,
+	StepFailed
+};
+
+
+/**
+ * @brief A single step of a Pipeline
+ */
+struct PipelineStep
+{
+	QString				name;		/**< Unique name, used to save the state in the project file */
+	PipelineStepType		type;
+	QString				subdomainName;
+	Domain*				domain;		/**< The subdomain of a subdomain step, otherwise the full domain */
+	std::vector<unsigned int>	dependencies;	/**< Steps that must be done before this one starts */
+	PipelineStepState		state;
+	int				jobID;		/**< The scheduler job of a subdomain run, or -1 */
+	QString				inputs;		/**< Fingerprint of the files and options the step reads */
+};
+
+
+/**
+ * @brief Carries out every step from a full domain run to the subdomain runs
+ *
+ * Carries out every step from a full domain run to the subdomain runs, as a
+ * dependency graph:
+ *
+ *	prepare full domain -> full domain run -> carve fort.066 -> run subdomain
+ *	carve fort.13 ------------------------------------------> run subdomain
+ *	prepare subdomain --------------------------------------> run subdomain
+ *
+ * Every step starts as soon as the steps it depends on are done, so the fort.13
+ * carve runs alongside the full domain run and the subdomain runs are handed to
+ * the JobScheduler together, which runs as many of them at once as its budget
+ * allows. A step that fails does not stop steps that do not depend on it.
+ *
+ * The state of each step is saved in the project file as it changes. When the
+ * pipeline is started again, steps that are already done are skipped, so a failed
+ * or interrupted pipeline picks up from the last completed steps. Steps that were
+ * running when the pipeline was interrupted are run again.
+ *
+ * Along with the state, each step saves a fingerprint of the files and options it
+ * read: the fort.14 and fort.15 files, the set of subdomains, and the run options.
+ * A step whose fingerprint has changed since it was done is run again, and so is
+ * every step that depends on it.
+ *
+ */
+class Pipeline : public QObject
+{
+		Q_OBJECT
+	public:
+		Pipeline(JobScheduler *newScheduler, ProjectFile *newProjectFile, QObject *parent=0);
+		~Pipeline();
+
+		void	SetFullDomain(Domain *newFull);
+		void	SetSubdomains(std::map<QString, Domain*> newSubs);
+		void	SetAdcircExecutable(QString newLoc);
+		void	SetPadcircExecutable(QString newLoc);
+		void	SetSubdomainExecutable(QString newLoc);
+
+		bool	Configure();
+		bool	Start();
+		void	Stop();
+		void	Reset();
+
+		bool	IsRunning();
+		int	GetNumSteps();
+		int	GetNumStepsDone();
+
+		static QString	GetStateName(PipelineStepState state);
+
+	private:
+
+		JobScheduler*			scheduler;
+		ProjectFile*			projectFile;
+		FullDomainRunner		runner;
+		Domain*				fullDomain;
+		std::map<QString, Domain*>	subDomains;
+		QString				subdomainExecutable;
+
+		std::vector<PipelineStep>	steps;
+		bool				running;
+		bool				stopRequested;
+
+		/* Steps that run outside of the scheduler */
+		AdcircRun*	fullDomainRun;
+		TaskGroup	fort015Tasks;
+		Fort015*	fort015Writer;
+		TaskGroup	fort13Tasks;
+		Fort13*		fort13Carver;
+		TaskGroup	fort066Tasks;
+		Fort066*	fort066Carver;
+
+		unsigned int	AddStep(QString name, PipelineStepType type, Domain *domain, QString subdomainName=QString());
+		void		BuildSteps();
+		void		LoadState();
+		QString		FingerprintInputs(unsigned int step);
+		static QString	FingerprintFile(QString path);
+		bool		DependenciesDone(unsigned int step);
+		int		FindRunningStep(PipelineStepType type);
+
+		void	StartReadySteps();
+		void	StartStep(unsigned int step);
+		void	StepFinished(unsigned int step, bool succeeded);
+		void	SetStepState(unsigned int step, PipelineStepState newState);
+		void	CheckIfFinished();
+
+		bool	StartFort015Writing(unsigned int step);
+		bool	StartFort13Carving(unsigned int step);
+		bool	StartFort066Carving(unsigned int step);
+		bool	StartFullDomainRun(unsigned int step);
+		bool	StartSubdomainRun(unsigned int step);
+		bool	PrepareSubdomain(unsigned int step);
+
+	private slots:
+
+		void	jobFinished(int id, int exitCode);
+		void	fullDomainRunFinished(int exitCode);
+		void	fort015Written();
+		void	fort13CarvingFinished();
+		void	fort066CarvingFinished();
+
+	signals:
+
+		void	stepStateChanged(QString, QString);
+		void	progress(int);
+		void	finished(bool);
+		void	emitMessage(QString);
+};
+
+#endif // PIPELINE_H
@@ -0,0 +1,357 @@
+#include "RunMonitor.h"
+
+/* Global output files whose growth is reported */
+static const char *outputFiles[] = {"fort.61", "fort.62", "fort.63", "fort.64", "fort.066", "fort.63.nc", "fort.64.nc", 0};
+
+
+RunMonitor::RunMonitor(JobScheduler *newScheduler, QObject *parent) :
+	QObject(parent),
+	scheduler(newScheduler)
+{
+	updateTimer.setSingleShot(true);
+	updateTimer.setInterval(RUN_MONITOR_INTERVAL);
+	pollTimer.setInterval(RUN_MONITOR_POLL_INTERVAL);
+
+	connect(&watcher, SIGNAL(fileChanged(QString)), this, SLOT(pathChanged(QString)));
+	connect(&watcher, SIGNAL(directoryChanged(QString)), this, SLOT(pathChanged(QString)));
+	connect(&updateTimer, SIGNAL(timeout()), this, SLOT(update()));
+	connect(&pollTimer, SIGNAL(timeout()), this, SLOT(pollOutputSizes()));
+	if (scheduler)
+		connect(scheduler, SIGNAL(jobStateChanged(int,QString,QString)), this, SLOT(jobStateChanged(int,QString,QString)));
+}
+
+
+/**
+ * @brief Reads the progress from a line of ADCIRC screen output
+ *
+ * Reads the progress from a line of ADCIRC screen output, which looks like:
+ *
+ *	TIME STEP =   3600   25.00% COMPLETE     ITERATIONS =   12     TIME =  0.36000000E+04
+ *
+ * Older versions of ADCIRC do not print the percent complete.
+ *
+ * @param line The line
+ * @param timestep Set to the timestep
+ * @param percent Set to the percent complete, or -1 if the line does not have it
+ * @param modelTime Set to the model time in seconds, or left alone if the line does not have it
+ * @return true if the line reports a timestep
+ */
+bool RunMonitor::ParseProgressLine(QString line, int &timestep, double &percent, double &modelTime)
+{
+	QRegExp stepPattern ("TIME\\s*STEP\\s*=\\s*(\\d+)(\\s+([0-9.]+)\\s*%)?");
+	if (stepPattern.indexIn(line) < 0)
+		return false;
+
+	timestep = stepPattern.cap(1).toInt();
+	percent = stepPattern.cap(3).isEmpty() ? -1.0 : stepPattern.cap(3).toDouble();
+
+	QRegExp timePattern ("\\bTIME\\s*=\\s*([-+0-9.EeDd]+)");
+	if (timePattern.indexIn(line) >= 0)
+	{
+		/* Fortran may write the exponent with a D */
+		QString value = timePattern.cap(1);
+		value.replace('D', 'E').replace('d', 'e');
+		bool ok = false;
+		double time = value.toDouble(&ok);
+		if (ok)
+			modelTime = time;
+	}
+	return true;
+}
+
+
+/**
+ * @brief Formats a number of seconds as hours and minutes, or minutes and seconds
+ * @param seconds The number of seconds
+ * @return The formatted duration, such as "2h 05m"
+ */
+QString RunMonitor::FormatDuration(qint64 seconds)
+{
+	if (seconds < 60)
+		return QString::number(seconds) + "s";
+	if (seconds < 3600)
+		return QString::number(seconds/60) + "m " + QString("%1").arg(seconds%60, 2, 10, QChar('0')) + "s";
+	return QString::number(seconds/3600) + "h " + QString("%1").arg((seconds%3600)/60, 2, 10, QChar('0')) + "m";
+}
+
+
+/**
+ * @brief Starts watching the output of a job that has just started
+ * @param id The ID of the job
+ */
+void RunMonitor::StartMonitoring(int id)
+{
+	const AdcircJob *job = scheduler->GetJob(id);
+	if (!job || runs.contains(id))
+		return;
+
+	QDir directory (job->workingDirectory);
+
+	RunProgress run;
+	run.id = id;
+	run.name = job->name;
+	run.directory = directory.absolutePath();
+	run.streams << directory.absoluteFilePath(job->outputName + ".stdout")
+		    << directory.absoluteFilePath("fort.16")
+		    << directory.absoluteFilePath(QString(RUN_MONITOR_PARALLEL_DIR) + QDir::separator() + "fort.16");
+	run.timestep = -1;
+	run.percent = -1.0;
+	run.modelTime = 0.0;
+	run.firstPercent = -1.0;
+	run.bytesWritten = 0;
+	run.changed = false;
+
+	/* A fort.16 left by an earlier run is skipped. ADCIRC truncates it when it starts, which resets the offset. */
+	for (int i=1; i<run.streams.size(); ++i)
+	{
+		QFileInfo oldFort16 (run.streams[i]);
+		if (oldFort16.exists())
+			run.offsets[run.streams[i]] = oldFort16.size();
+	}
+
+	runs.insert(id, run);
+	WatchNewFiles(runs[id]);
+	if (!pollTimer.isActive())
+		pollTimer.start();
+}
+
+
+/**
+ * @brief Stops watching the output of a job that has stopped
+ * @param id The ID of the job
+ */
+void RunMonitor::StopMonitoring(int id)
+{
+	QMap<QString, int>::iterator it = watchedPaths.begin();
+	while (it != watchedPaths.end())
+	{
+		if (it.value() == id)
+		{
+			watcher.removePath(it.key());
+			it = watchedPaths.erase(it);
+		} else {
+			++it;
+		}
+	}
+	runs.remove(id);
+	if (runs.isEmpty())
+		pollTimer.stop();
+}
+
+
+/**
+ * @brief Adds a file or directory to the watcher if it exists and is not already watched
+ * @param path The file or directory
+ * @param id The ID of the job it belongs to
+ */
+void RunMonitor::WatchPath(QString path, int id)
+{
+	if (!QFileInfo(path).exists())
+		return;
+
+	if (!watcher.files().contains(path) && !watcher.directories().contains(path))
+		watcher.addPath(path);
+	watchedPaths[path] = id;
+}
+
+
+/**
+ * @brief Watches every stream of a run that has appeared since it was last checked
+ *
+ * Watches every stream of a run that has appeared since it was last checked.
+ * ADCIRC creates its streams after it has started, adcprep creates the processor
+ * directories, and a file that is replaced drops out of the watcher, so this is
+ * done whenever one of the run's directories changes. The large output files are
+ * not watched, since they would wake the monitor on every write.
+ *
+ * @param run The run
+ */
+void RunMonitor::WatchNewFiles(RunProgress &run)
+{
+	WatchPath(run.directory, run.id);
+	WatchPath(run.directory + QDir::separator() + RUN_MONITOR_PARALLEL_DIR, run.id);
+	for (QStringList::iterator it = run.streams.begin(); it != run.streams.end(); ++it)
+		WatchPath(*it, run.id);
+}
+
+
+/**
+ * @brief Reads the lines appended to a stream since it was last read
+ *
+ * Reads the lines appended to a stream since it was last read, and keeps the last
+ * progress line among them. Only the last RUN_MONITOR_MAX_READ bytes are read if more
+ * than that has been appended, since only the newest progress line matters. A line
+ * that is still being written is left for the next update.
+ *
+ * @param run The run
+ * @param path The stream
+ */
+void RunMonitor::ReadStream(RunProgress &run, QString path)
+{
+	QFile file (path);
+	if (!file.exists())
+		return;
+
+	qint64 size = file.size();
+	qint64 offset = run.offsets.value(path, 0);
+	if (size < offset)
+		offset = 0;
+	if (size == offset)
+		return;
+	if (size - offset > RUN_MONITOR_MAX_READ)
+		offset = size - RUN_MONITOR_MAX_READ;
+
+	if (!file.open(QIODevice::ReadOnly) || !file.seek(offset))
+		return;
+	QByteArray data = file.read(size - offset);
+	file.close();
+
+	int end = data.lastIndexOf('\n');
+	if (end < 0)
+		return;
+	run.offsets[path] = offset + end + 1;
+
+	QStringList lines = QString::fromLatin1(data.left(end)).split('\n');
+	for (int i=lines.size()-1; i>=0; --i)
+	{
+		int timestep;
+		double percent;
+		double modelTime = run.modelTime;
+		if (ParseProgressLine(lines[i], timestep, percent, modelTime))
+		{
+			if (timestep >= run.timestep)
+			{
+				run.timestep = timestep;
+				run.modelTime = modelTime;
+				if (percent >= 0.0)
+					run.percent = percent;
+			}
+			break;
+		}
+	}
+}
+
+
+/**
+ * @brief Returns the combined size of the global output files of a run
+ * @param run The run
+ * @return The size in bytes
+ */
+qint64 RunMonitor::MeasureOutput(RunProgress &run)
+{
+	qint64 bytes = 0;
+	for (int i=0; outputFiles[i]; ++i)
+	{
+		QFileInfo output (run.directory + QDir::separator() + outputFiles[i]);
+		if (output.exists())
+			bytes += output.size();
+	}
+	return bytes;
+}
+
+
+/**
+ * @brief Reads what a run has written since the last update and reports its progress
+ * @param run The run
+ */
+void RunMonitor::UpdateRun(RunProgress &run)
+{
+	for (QStringList::iterator it = run.streams.begin(); it != run.streams.end(); ++it)
+		ReadStream(run, *it);
+
+	if (run.timestep < 0)
+		return;
+
+	QStringList details;
+	details << "Timestep " + QString::number(run.timestep);
+	if (run.modelTime > 0.0)
+		details << QString::number(run.modelTime/86400.0, 'f', 2) + " days";
+
+	if (run.percent >= 0.0)
+	{
+		QDateTime now = QDateTime::currentDateTime();
+		if (run.firstPercent < 0.0)
+		{
+			run.firstPercent = run.percent;
+			run.firstSeen = now;
+		}
+
+		qint64 elapsed = run.firstSeen.secsTo(now);
+		if (run.percent > run.firstPercent && elapsed > 0)
+		{
+			double rate = (run.percent - run.firstPercent) / elapsed;
+			details << FormatDuration((qint64)((100.0 - run.percent) / rate)) + " left";
+		}
+	}
+
+	if (run.bytesWritten > 0)
+		details << QString::number(run.bytesWritten/1048576.0, 'f', 1) + " MB written";
+
+	emit jobProgress(run.id, run.percent >= 0.0 ? (int)run.percent : -1, details.join(", "));
+}
+
+
+void RunMonitor::jobStateChanged(int id, QString, QString state)
+{
+	if (state == JobScheduler::GetStateName(JobRunning))
+		StartMonitoring(id);
+	else if (runs.contains(id))
+		StopMonitoring(id);
+}
+
+
+/**
+ * @brief Notes that a watched file or directory has changed
+ *
+ * Notes that a watched file or directory has changed. Nothing is read here. The
+ * change is picked up by the next update, which is started if one is not already
+ * pending, so a run that writes every timestep costs one read per interval.
+ *
+ * @param path The file or directory
+ */
+void RunMonitor::pathChanged(QString path)
+{
+	int id = watchedPaths.value(path, -1);
+	if (!runs.contains(id))
+		return;
+
+	runs[id].changed = true;
+	if (!updateTimer.isActive())
+		updateTimer.start();
+}
+
+
+/**
+ * @brief Reports the runs whose output files have grown since the last poll
+ */
+void RunMonitor::pollOutputSizes()
+{
+	bool grown = false;
+	for (QMap<int, RunProgress>::iterator it = runs.begin(); it != runs.end(); ++it)
+	{
+		qint64 bytes = MeasureOutput(it.value());
+		if (bytes != it.value().bytesWritten)
+		{
+			it.value().bytesWritten = bytes;
+			it.value().changed = true;
+			grown = true;
+		}
+	}
+
+	if (grown && !updateTimer.isActive())
+		updateTimer.start();
+}
+
+
+void RunMonitor::update()
+{
+	for (QMap<int, RunProgress>::iterator it = runs.begin(); it != runs.end(); ++it)
+	{
+		if (it.value().changed)
+		{
+			it.value().changed = false;
+			WatchNewFiles(it.value());
+			UpdateRun(it.value());
+		}
+	}
+}
@@ -0,0 +1,101 @@
+#ifndef RUNMONITOR_H
+#define RUNMONITOR_H
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QMap>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDateTime>
+#include <QTimer>
+#include <QRegExp>
+#include <QFileSystemWatcher>
+
+#include "Adcirc/JobScheduler.h"
+
+#define RUN_MONITOR_INTERVAL	1000	/**< Milliseconds to gather file changes for before reading them */
+#define RUN_MONITOR_MAX_READ	1048576	/**< Most bytes read from the end of a stream in one update */
+#define RUN_MONITOR_POLL_INTERVAL	10000	/**< Milliseconds between checks of the output file sizes */
+#define RUN_MONITOR_PARALLEL_DIR	"PE0000"	/**< The processor directory padcirc writes fort.16 into */
+
+
+/**
+ * @brief What is known about the progress of a single running job
+ */
+struct RunProgress
+{
+	int		id;
+	QString		name;
+	QString		directory;
+	QStringList	streams;	/**< The job's stdout and fort.16, in the run directory or PE0000 */
+	QMap<QString, qint64>	offsets;	/**< Bytes of each stream already read */
+	int		timestep;	/**< Last timestep reported, or -1 */
+	double		percent;	/**< Percent complete, or -1 if not reported */
+	double		modelTime;	/**< Model time in seconds of the last timestep */
+	double		firstPercent;	/**< Percent complete when the monitor first saw the run progress */
+	QDateTime	firstSeen;
+	qint64		bytesWritten;	/**< Combined size of the global output files */
+	bool		changed;	/**< A watched file has changed since the last update */
+};
+
+
+/**
+ * @brief Follows the progress of every running ADCIRC job
+ *
+ * Follows the progress of every running ADCIRC job. When the JobScheduler starts
+ * a job, the job's stdout, its fort.16 and its working directory are handed to a
+ * QFileSystemWatcher, which uses inotify on Linux, so nothing is read while the run
+ * is quiet. padcirc writes fort.16 into the PE0000 processor directory, which is
+ * watched as well. Changes are gathered for RUN_MONITOR_INTERVAL milliseconds and
+ * then only the bytes appended since the last update are read, so the cost does not
+ * grow with the length of the run or with how often ADCIRC writes.
+ *
+ * The last "TIME STEP =" line gives the timestep and the percent complete, and
+ * the rate the percent has grown at since the monitor first saw it gives the
+ * estimated time left. The combined size of the global output files is reported
+ * alongside, so a run that writes output but no screen messages can still be seen
+ * to be alive. The output files can be written to every timestep, so their sizes
+ * are polled every RUN_MONITOR_POLL_INTERVAL milliseconds rather than watched.
+ *
+ */
+class RunMonitor : public QObject
+{
+		Q_OBJECT
+	public:
+		RunMonitor(JobScheduler *newScheduler, QObject *parent=0);
+
+		static bool	ParseProgressLine(QString line, int &timestep, double &percent, double &modelTime);
+		static QString	FormatDuration(qint64 seconds);
+
+	private:
+
+		JobScheduler*		scheduler;
+		QFileSystemWatcher	watcher;
+		QTimer			updateTimer;
+		QTimer			pollTimer;
+		QMap<int, RunProgress>	runs;		/**< Map of job IDs to their progress */
+		QMap<QString, int>	watchedPaths;	/**< Map of watched files and directories to job IDs */
+
+		void	StartMonitoring(int id);
+		void	StopMonitoring(int id);
+		void	WatchPath(QString path, int id);
+		void	WatchNewFiles(RunProgress &run);
+		void	ReadStream(RunProgress &run, QString path);
+		qint64	MeasureOutput(RunProgress &run);
+		void	UpdateRun(RunProgress &run);
+
+	private slots:
+
+		void	jobStateChanged(int id, QString name, QString state);
+		void	pathChanged(QString path);
+		void	pollOutputSizes();
+		void	update();
+
+	signals:
+
+		void	jobProgress(int id, int percent, QString details);
+};
+
+#endif // RUNMONITOR_H
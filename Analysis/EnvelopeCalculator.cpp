@@ -0,0 +1,236 @@
+#include "EnvelopeCalculator.h"
+
+EnvelopeCalculator::EnvelopeCalculator(QString sourceLoc, QObject *parent) :
+	QObject(parent)
+{
+	sourcePath = sourceLoc;
+	maxOutputPath = "";
+	minOutputPath = "";
+	firstTimestep = 1;
+	lastTimestep = 0;
+	numThreads = QThread::idealThreadCount();
+	written = false;
+}
+
+
+/**
+ * @brief Sets the window of timesteps the envelope is computed over
+ * @param first The first timestep (starting from 1)
+ * @param last The last timestep, or 0 for the last timestep in the file
+ */
+void EnvelopeCalculator::SetTimeWindow(unsigned int first, unsigned int last)
+{
+	firstTimestep = first > 0 ? first : 1;
+	lastTimestep = last;
+}
+
+
+/**
+ * @brief Sets the files the envelopes are written to
+ * @param newMaxLoc The max envelope file
+ * @param newMinLoc The min envelope file, or empty to skip the min envelope
+ */
+void EnvelopeCalculator::SetOutputPaths(QString newMaxLoc, QString newMinLoc)
+{
+	maxOutputPath = newMaxLoc;
+	minOutputPath = newMinLoc;
+}
+
+
+/**
+ * @brief Sets the number of threads used to fold in each timestep
+ * @param newNumThreads The number of threads, or 0 or less for one per core
+ */
+void EnvelopeCalculator::SetNumThreads(int newNumThreads)
+{
+	numThreads = newNumThreads > 0 ? newNumThreads : QThread::idealThreadCount();
+}
+
+
+/**
+ * @brief Streams the file once and writes the envelopes
+ * @return true if the envelopes were computed and written
+ */
+bool EnvelopeCalculator::Calculate()
+{
+	emit startedCalculating();
+	emit progress(0);
+	written = false;
+
+	Fort63 source (sourcePath);
+	if (maxOutputPath.isEmpty() || !source.BuildIndex() || source.GetNumTimesteps() == 0)
+	{
+		std::cout << "WARNING: Unable to compute the envelope of " << sourcePath.toStdString().data() << std::endl;
+		emit emitMessage(QString("<p style='color:red'><strong>Error:</strong> Unable to read ").append(sourcePath).append("</p>"));
+		emit finishedCalculating();
+		return false;
+	}
+
+	unsigned int first = firstTimestep;
+	unsigned int last = lastTimestep > 0 && lastTimestep < source.GetNumTimesteps() ? lastTimestep : source.GetNumTimesteps();
+	if (first > last)
+	{
+		emit emitMessage("<p style='color:red'><strong>Error:</strong> The envelope time window is empty.</p>");
+		emit finishedCalculating();
+		return false;
+	}
+
+	unsigned int numNodes = source.GetNumNodes();
+	unsigned int valuesPerNode = source.GetValuesPerNode();
+	std::vector<float> maxValues (numNodes, -FLT_MAX);
+	std::vector<float> minValues (numNodes, FLT_MAX);
+	std::vector<unsigned int> maxTimesteps (numNodes, 0);
+	std::vector<unsigned int> minTimesteps (numNodes, 0);
+
+	/* One range of nodes per thread, aligned so that neighboring ranges don't share cache lines */
+	int threadCount = numThreads > 0 ? numThreads : 1;
+	unsigned int nodesPerTask = (numNodes + threadCount - 1) / threadCount;
+	nodesPerTask = (nodesPerTask + ENVELOPE_NODE_ALIGNMENT - 1) / ENVELOPE_NODE_ALIGNMENT * ENVELOPE_NODE_ALIGNMENT;
+	std::vector<EnvelopeTask*> tasks;
+	for (unsigned int firstNode=0; firstNode<numNodes; firstNode+=nodesPerTask)
+	{
+		unsigned int count = numNodes - firstNode < nodesPerTask ? numNodes - firstNode : nodesPerTask;
+		tasks.push_back(new EnvelopeTask(firstNode, count, &maxValues[0], &minValues[0], &maxTimesteps[0], &minTimesteps[0]));
+	}
+
+	TaskGroup timestepTasks;
+
+	std::vector<float> currentValues, nextValues;
+	bool read = source.ReadTimestep(first, currentValues);
+	bool cancelled = false;
+	for (unsigned int ts=first; ts<=last && read && !cancelled; ++ts)
+	{
+		if (currentValues.size() < numNodes*valuesPerNode)
+		{
+			read = false;
+			break;
+		}
+
+		for (std::vector<EnvelopeTask*>::iterator it=tasks.begin(); it != tasks.end(); ++it)
+		{
+			(*it)->SetTimestep(ts, &currentValues[0], valuesPerNode);
+			TaskScheduler::Instance()->Start(*it, TASK_PRIORITY_NORMAL, &timestepTasks);
+		}
+
+		/* Read the next timestep while this one is folded in */
+		if (ts < last)
+			read = source.ReadTimestep(ts+1, nextValues);
+
+		timestepTasks.Wait();
+		currentValues.swap(nextValues);
+		emit progress((int)(95.0*(ts-first+1)/(last-first+1)));
+		cancelled = TaskScheduler::Instance()->CurrentTaskCancelled();
+	}
+
+	for (std::vector<EnvelopeTask*>::iterator it=tasks.begin(); it != tasks.end(); ++it)
+		delete *it;
+
+	if (cancelled)
+	{
+		emit finishedCalculating();
+		return false;
+	}
+
+	if (!read)
+	{
+		std::cout << "WARNING: Unable to read every timestep of " << sourcePath.toStdString().data() << std::endl;
+		emit emitMessage(QString("<p style='color:red'><strong>Error:</strong> Unable to read every timestep of ").append(sourcePath).append("</p>"));
+		emit finishedCalculating();
+		return false;
+	}
+
+	written = WriteEnvelope(maxOutputPath, source, maxValues, maxTimesteps, first, last, "Maximum");
+	if (written && !minOutputPath.isEmpty())
+		written = WriteEnvelope(minOutputPath, source, minValues, minTimesteps, first, last, "Minimum");
+
+	emit progress(100);
+	emit finishedCalculating();
+	return written;
+}
+
+
+void EnvelopeCalculator::calculate()
+{
+	Calculate();
+}
+
+
+QString EnvelopeCalculator::GetSourcePath()
+{
+	return sourcePath;
+}
+
+
+QString EnvelopeCalculator::GetMaxOutputPath()
+{
+	return maxOutputPath;
+}
+
+
+QString EnvelopeCalculator::GetMinOutputPath()
+{
+	return minOutputPath;
+}
+
+
+bool EnvelopeCalculator::EnvelopeWritten()
+{
+	return written;
+}
+
+
+/**
+ * @brief Writes an envelope in the maxele.63 format
+ *
+ * Writes an envelope in the maxele.63 format. The first record holds the envelope
+ * and the second holds the time it was reached, in seconds. Nodes that were never
+ * wet are written as -99999 in both records. The file is written to a temporary
+ * file first, so an existing envelope is only replaced once the new one is complete.
+ *
+ * @param outputPath The file to write
+ * @param source The file the envelope was computed from
+ * @param envelope The envelope value of every node
+ * @param timesteps The timestep each envelope value was reached at, or 0 if never wet
+ * @param first The first timestep of the window
+ * @param last The last timestep of the window
+ * @param description Maximum or Minimum
+ * @return true if the file was written
+ */
+bool EnvelopeCalculator::WriteEnvelope(QString outputPath, Fort63 &source, std::vector<float> &envelope,
+				       std::vector<unsigned int> &timesteps, unsigned int first, unsigned int last, QString description)
+{
+	QString tempPath = outputPath + ".tmp";
+	std::ofstream outFile (tempPath.toStdString().data());
+	if (!outFile.is_open())
+	{
+		std::cout << "WARNING: Unable to open " << tempPath.toStdString().data() << std::endl;
+		return false;
+	}
+
+	unsigned int numNodes = envelope.size();
+	double lastTime = source.GetTimestepTime(last);
+
+	outFile << description.toStdString() << " of " << QFileInfo(sourcePath).fileName().toStdString() <<
+		   " from timestep " << first << " to " << last << "\n";
+	outFile << 2 << " " << numNodes << " " << 0.0 << " " << 0 << " " << 1 << "\n";
+
+	outFile << std::scientific << std::setprecision(10);
+	outFile << lastTime << " " << last << "\n";
+	for (unsigned int i=0; i<numNodes; ++i)
+		outFile << i+1 << " " << (timesteps[i] > 0 ? envelope[i] : DRY_VALUE) << "\n";
+
+	outFile << lastTime << " " << last << "\n";
+	for (unsigned int i=0; i<numNodes; ++i)
+		outFile << i+1 << " " << (timesteps[i] > 0 ? source.GetTimestepTime(timesteps[i]) : DRY_VALUE) << "\n";
+
+	outFile.close();
+	if (outFile.fail())
+	{
+		std::cout << "WARNING: Unable to write " << tempPath.toStdString().data() << std::endl;
+		QFile::remove(tempPath);
+		return false;
+	}
+
+	QFile::remove(outputPath);
+	return QFile::rename(tempPath, outputPath);
+}
@@ -0,0 +1,92 @@
+#ifndef ENVELOPECALCULATOR_H
+#define ENVELOPECALCULATOR_H
+
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <cfloat>
+
+#include <QObject>
+#include <QString>
+#include <QFile>
+#include <QFileInfo>
+#include <QThread>
+
+#include "Analysis/EnvelopeTask.h"
+#include "Tasks/TaskScheduler.h"
+#include "Projects/IO/FileIO/Fort63.h"
+
+#define ENVELOPE_NODE_ALIGNMENT	16
+
+
+/**
+ * @brief Computes the max/min envelope of a fort.63 or fort.64 file
+ *
+ * Computes the maximum and minimum of every node over a window of timesteps,
+ * along with the timestep each was reached at. This gives the same results as
+ * ADCIRC's maxele.63 (from fort.63) and maxvel.63 (from fort.64, using the speed),
+ * but for runs that did not write them or for a shorter window of time.
+ *
+ * The file is streamed once. The nodes are split into one contiguous range per
+ * thread, and each timestep is folded into the envelope by an EnvelopeTask for each
+ * range on the TaskScheduler. The next timestep is read while the tasks are running,
+ * and the calculator then helps to finish them.
+ *
+ * Dry values (-99999) are ignored. A node that is dry for the whole window is
+ * written as dry.
+ *
+ * The envelopes are written in the maxele.63 format: one record holding the
+ * envelope and a second record holding the time (in seconds) it was reached. The
+ * output can be read with Fort63 like any other global output file.
+ *
+ * calculate() does not return until the whole file has been read, so it should be
+ * started on the TaskScheduler rather than called from the GUI thread. Its
+ * EnvelopeTasks then go on the local queue of the thread it runs on.
+ *
+ */
+class EnvelopeCalculator : public QObject
+{
+		Q_OBJECT
+	public:
+		EnvelopeCalculator(QString sourceLoc, QObject *parent=0);
+
+		void	SetTimeWindow(unsigned int first, unsigned int last);
+		void	SetOutputPaths(QString newMaxLoc, QString newMinLoc=QString());
+		void	SetNumThreads(int newNumThreads);
+
+		bool	Calculate();
+
+		/* Getter Methods */
+		QString		GetSourcePath();
+		QString		GetMaxOutputPath();
+		QString		GetMinOutputPath();
+		bool		EnvelopeWritten();
+
+	private:
+
+		QString		sourcePath;
+		QString		maxOutputPath;
+		QString		minOutputPath;	/**< Empty if the min envelope is not written */
+		unsigned int	firstTimestep;	/**< The first timestep of the window (starting from 1) */
+		unsigned int	lastTimestep;	/**< The last timestep of the window, or 0 for the last timestep in the file */
+		int		numThreads;
+		bool		written;	/**< Flag that shows if the last calculation wrote its envelopes */
+
+		bool	WriteEnvelope(QString outputPath, Fort63 &source, std::vector<float> &envelope,
+				      std::vector<unsigned int> &timesteps, unsigned int first, unsigned int last, QString description);
+
+	public slots:
+
+		void	calculate();
+
+	signals:
+
+		void	startedCalculating();
+		void	progress(int);
+		void	finishedCalculating();
+		void	emitMessage(QString);
+
+};
+
+#endif // ENVELOPECALCULATOR_H
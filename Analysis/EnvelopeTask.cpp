@@ -0,0 +1,73 @@
+#include "EnvelopeTask.h"
+
+EnvelopeTask::EnvelopeTask(unsigned int newFirstNode, unsigned int newNumNodes, float *newMaxValues, float *newMinValues,
+			   unsigned int *newMaxTimesteps, unsigned int *newMinTimesteps)
+{
+	firstNode = newFirstNode;
+	numNodes = newNumNodes;
+	maxValues = newMaxValues;
+	minValues = newMinValues;
+	maxTimesteps = newMaxTimesteps;
+	minTimesteps = newMinTimesteps;
+
+	timestep = 0;
+	values = 0;
+	valuesPerNode = 1;
+
+	setAutoDelete(false);
+}
+
+
+/**
+ * @brief Sets the timestep that will be folded in the next time the task is run
+ * @param ts The timestep (starting from 1)
+ * @param newValues The timestep's values for every node, valuesPerNode for each node
+ * @param newValuesPerNode The number of values for each node
+ */
+void EnvelopeTask::SetTimestep(unsigned int ts, const float *newValues, unsigned int newValuesPerNode)
+{
+	timestep = ts;
+	values = newValues;
+	valuesPerNode = newValuesPerNode > 0 ? newValuesPerNode : 1;
+}
+
+
+void EnvelopeTask::run()
+{
+	if (!values || numNodes == 0)
+		return;
+
+	const float *nodeValues = values + firstNode*valuesPerNode;
+	if (valuesPerNode > 1)
+	{
+		magnitudes.resize(numNodes);
+		for (unsigned int i=0; i<numNodes; ++i)
+		{
+			const float *vector = nodeValues + i*valuesPerNode;
+			float magnitude = 0.0f;
+			for (unsigned int j=0; j<valuesPerNode; ++j)
+				magnitude += vector[j]*vector[j];
+			magnitudes[i] = vector[0] > DRY_VALUE ? sqrtf(magnitude) : DRY_VALUE;
+		}
+		nodeValues = &magnitudes[0];
+	}
+
+	float *maxRange = maxValues + firstNode;
+	float *minRange = minValues + firstNode;
+	unsigned int *maxTimestepRange = maxTimesteps + firstNode;
+	unsigned int *minTimestepRange = minTimesteps + firstNode;
+	const unsigned int ts = timestep;
+	const unsigned int count = numNodes;
+
+	for (unsigned int i=0; i<count; ++i)
+	{
+		const float value = nodeValues[i];
+		const bool wet = value > DRY_VALUE;
+		const bool higher = wet & (value > maxRange[i]);
+		const bool lower = wet & (value < minRange[i]);
+		maxRange[i] = higher ? value : maxRange[i];
+		maxTimestepRange[i] = higher ? ts : maxTimestepRange[i];
+		minRange[i] = lower ? value : minRange[i];
+		minTimestepRange[i] = lower ? ts : minTimestepRange[i];
+	}
+}
@@ -0,0 +1,51 @@
+#ifndef ENVELOPETASK_H
+#define ENVELOPETASK_H
+
+#include <vector>
+#include <cmath>
+
+#include <QRunnable>
+
+#include "adcData.h"
+
+
+/**
+ * @brief Folds one timestep into the running max/min envelope of a range of nodes
+ *
+ * Folds one timestep into the running max/min envelope of a contiguous range of
+ * nodes. Each task owns one node range, so the tasks never write to the same memory
+ * and need no locking.
+ *
+ * The reduction loop has no branches, so the compiler can vectorize it. Vector
+ * values (fort.64) are first reduced to their magnitude in a scratch buffer owned
+ * by the task. Dry values (-99999) never replace the envelope.
+ *
+ * Auto deletion is turned off so the same task can be started again for every
+ * timestep.
+ *
+ */
+class EnvelopeTask : public QRunnable
+{
+	public:
+		EnvelopeTask(unsigned int newFirstNode, unsigned int newNumNodes, float *newMaxValues, float *newMinValues,
+			     unsigned int *newMaxTimesteps, unsigned int *newMinTimesteps);
+
+		void	SetTimestep(unsigned int ts, const float *newValues, unsigned int newValuesPerNode);
+		void	run();
+
+	private:
+
+		unsigned int	firstNode;	/**< The first node of the range (starting from 0) */
+		unsigned int	numNodes;	/**< The number of nodes in the range */
+		float*		maxValues;	/**< The full max envelope, shared by all tasks */
+		float*		minValues;	/**< The full min envelope, shared by all tasks */
+		unsigned int*	maxTimesteps;	/**< The timestep of each max, shared by all tasks */
+		unsigned int*	minTimesteps;	/**< The timestep of each min, shared by all tasks */
+
+		unsigned int		timestep;	/**< The timestep being folded in */
+		const float*		values;		/**< The timestep's values for every node */
+		unsigned int		valuesPerNode;
+		std::vector<float>	magnitudes;	/**< Scratch buffer for the magnitude of vector values */
+};
+
+#endif // ENVELOPETASK_H
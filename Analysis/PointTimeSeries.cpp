@@ -0,0 +1,223 @@
+#include "PointTimeSeries.h"
+
+PointTimeSeries::PointTimeSeries(QString newLoc, QObject *parent) :
+	QObject(parent)
+{
+	filePath = newLoc;
+	for (int i=0; i<3; ++i)
+	{
+		nodes[i] = 0;
+		weights[i] = 0.0;
+	}
+	locationX = 0.0;
+	locationY = 0.0;
+}
+
+
+/**
+ * @brief Sets the point the time series is extracted at
+ *
+ * Sets the point the time series is extracted at and calculates the barycentric
+ * weight of each of the Element's nodes. Barycentric weights do not change when
+ * the mesh is scaled, so the normalized coordinates used for drawing can be used.
+ *
+ * @param element The Element that contains the point
+ * @param x The normalized x-coordinate of the point
+ * @param y The normalized y-coordinate of the point
+ * @return true if the weights could be calculated
+ */
+bool PointTimeSeries::SetLocation(Element *element, float x, float y)
+{
+	if (!element || !element->n1 || !element->n2 || !element->n3)
+		return false;
+
+	Node *n1 = element->n1;
+	Node *n2 = element->n2;
+	Node *n3 = element->n3;
+	double det = ((double)n2->normY - n3->normY)*((double)n1->normX - n3->normX) +
+		     ((double)n3->normX - n2->normX)*((double)n1->normY - n3->normY);
+	if (det == 0.0)
+		return false;
+
+	double w1 = (((double)n2->normY - n3->normY)*((double)x - n3->normX) + ((double)n3->normX - n2->normX)*((double)y - n3->normY)) / det;
+	double w2 = (((double)n3->normY - n1->normY)*((double)x - n3->normX) + ((double)n1->normX - n3->normX)*((double)y - n3->normY)) / det;
+
+	nodes[0] = n1->nodeNumber;
+	nodes[1] = n2->nodeNumber;
+	nodes[2] = n3->nodeNumber;
+	weights[0] = w1;
+	weights[1] = w2;
+	weights[2] = 1.0 - w1 - w2;
+	locationX = weights[0]*n1->x + weights[1]*n2->x + weights[2]*n3->x;
+	locationY = weights[0]*n1->y + weights[1]*n2->y + weights[2]*n3->y;
+	return true;
+}
+
+
+/**
+ * @brief Extracts the time series at the point
+ * @return true if the time series was extracted
+ */
+bool PointTimeSeries::Extract()
+{
+	emit startedExtracting();
+	series.clear();
+
+	std::vector<float> histories[3];
+	std::vector<double> times;
+	unsigned int valuesPerNode = 1;
+	bool read = nodes[0] > 0;
+	if (read && NodeReadsAreCheap(filePath))
+	{
+		/* netCDF output that is chunked by node can be read by node directly */
+		Fort63NetCDF netcdfFile (filePath);
+		read = netcdfFile.Open();
+		for (int i=0; i<3 && read; ++i)
+			read = netcdfFile.ReadNodeHistory(nodes[i], histories[i]);
+		valuesPerNode = netcdfFile.GetValuesPerNode();
+		for (unsigned int ts=1; ts<=netcdfFile.GetNumTimesteps(); ++ts)
+			times.push_back(netcdfFile.GetTimestepTime(ts));
+	}
+	else if (read && Fort63Cache(filePath).CacheIsCurrent())
+	{
+		Fort63Cache cache (filePath);
+		read = cache.Open();
+		for (int i=0; i<3 && read; ++i)
+			read = cache.ReadNodeHistory(nodes[i], histories[i]);
+		valuesPerNode = cache.GetValuesPerNode();
+		for (unsigned int ts=1; ts<=cache.GetNumTimesteps(); ++ts)
+			times.push_back(cache.GetTimestepTime(ts));
+	}
+	else if (read)
+	{
+		read = ReadHistoriesDirectly(histories, times, valuesPerNode);
+	}
+
+	for (int i=0; i<3 && read; ++i)
+		read = histories[i].size() >= times.size()*valuesPerNode;
+
+	if (!read)
+	{
+		std::cout << "WARNING: Unable to read the time series from " << filePath.toStdString().data() << std::endl;
+		emit finishedExtracting();
+		return false;
+	}
+
+	unsigned int numTimesteps = times.size();
+	series.reserve(numTimesteps);
+	for (unsigned int ts=0; ts<numTimesteps; ++ts)
+	{
+		double value = 0.0, wetWeight = 0.0;
+		for (int i=0; i<3; ++i)
+		{
+			float nodeValue = histories[i][ts*valuesPerNode];
+			if (nodeValue > DRY_VALUE)
+			{
+				value += weights[i]*nodeValue;
+				wetWeight += weights[i];
+			}
+		}
+
+		double time = times[ts] / 86400.0;
+		if (wetWeight > 0.0)
+			series.append(QPointF(time, value / wetWeight));
+		else
+			series.append(QPointF(time, qQNaN()));
+	}
+
+	emit progress(100);
+	emit finishedExtracting();
+	return true;
+}
+
+
+void PointTimeSeries::extract()
+{
+	Extract();
+}
+
+
+/**
+ * @brief Reads the histories of the Element's nodes from the fort.63 file itself
+ *
+ * Reads the histories of the Element's nodes from the fort.63 file itself, one
+ * timestep at a time. This reads the whole file, so it is only used when the binary
+ * cache could not be built. A timestep without every value of the nodes fails the
+ * read.
+ *
+ * @param histories The history of each of the three nodes
+ * @param times The model time of each timestep
+ * @param valuesPerNode The number of values per node in the file
+ * @return true if the histories were read
+ */
+bool PointTimeSeries::ReadHistoriesDirectly(std::vector<float> histories[3], std::vector<double> &times, unsigned int &valuesPerNode)
+{
+	Fort63 file (filePath);
+	if (!file.BuildIndex() || file.GetNumTimesteps() == 0)
+		return false;
+
+	valuesPerNode = file.GetValuesPerNode();
+	unsigned int numTimesteps = file.GetNumTimesteps();
+	for (int i=0; i<3; ++i)
+	{
+		if (nodes[i] > file.GetNumNodes())
+			return false;
+		histories[i].clear();
+		histories[i].reserve(numTimesteps*valuesPerNode);
+	}
+
+	std::vector<float> values;
+	for (unsigned int ts=1; ts<=numTimesteps; ++ts)
+	{
+		if (TaskScheduler::Instance()->CurrentTaskCancelled() || !file.ReadTimestep(ts, values))
+			return false;
+		for (int i=0; i<3; ++i)
+			if (nodes[i] == 0 || (size_t)nodes[i]*valuesPerNode > values.size())
+				return false;
+		for (int i=0; i<3; ++i)
+			for (unsigned int j=0; j<valuesPerNode; ++j)
+				histories[i].push_back(values[(nodes[i]-1)*valuesPerNode + j]);
+		times.push_back(file.GetTimestepTime(ts));
+		emit progress(100*ts/numTimesteps);
+	}
+	return true;
+}
+
+
+/**
+ * @brief Checks if node histories can be read from an output file without a cache
+ * @param fileLoc The output file
+ * @return true if the file is netCDF and chunked so that node histories are cheap to read
+ */
+bool PointTimeSeries::NodeReadsAreCheap(QString fileLoc)
+{
+	if (!Fort63NetCDF::IsNetCDF(fileLoc))
+		return false;
+
+	Fort63NetCDF netcdfFile (fileLoc);
+	return netcdfFile.Open() && netcdfFile.NodeReadsAreCheap();
+}
+
+
+QString PointTimeSeries::GetFilePath()
+{
+	return filePath;
+}
+
+
+/**
+ * @brief Returns a description of the point for labeling the time series
+ * @return The point's coordinates and the Element's nodes
+ */
+QString PointTimeSeries::GetLocationText()
+{
+	return QString("(").append(QString::number(locationX, 'f', 5)).append(", ").append(QString::number(locationY, 'f', 5))
+			   .append(")   Nodes ").append(QString::number(nodes[0])).append(", ").append(QString::number(nodes[1]))
+			   .append(", ").append(QString::number(nodes[2]));
+}
+
+
+QPolygonF PointTimeSeries::GetSeries()
+{
+	return series;
+}
@@ -0,0 +1,80 @@
+#ifndef POINTTIMESERIES_H
+#define POINTTIMESERIES_H
+
+#include <vector>
+#include <iostream>
+
+#include <QObject>
+#include <QString>
+#include <QPolygonF>
+#include <qnumeric.h>
+
+#include "adcData.h"
+#include "Projects/IO/FileIO/Fort63Cache.h"
+#include "Projects/IO/FileIO/Fort63NetCDF.h"
+
+
+/**
+ * @brief Extracts the time series of a fort.63 file at a single point in the domain
+ *
+ * The point is located inside an Element, and its value at each timestep is
+ * interpolated from the Element's three nodes using the point's barycentric
+ * weights. The history of each node is read from the node-major chunks of the
+ * fort.63 binary cache (see Fort63Cache), so extracting a series reads three
+ * small chunks no matter how long the run was. If the cache does not exist or is
+ * out of date, the histories are read from fort.63 itself instead. Callers that
+ * build the cache should wait for it rather than have both read the whole file
+ * (see Domain::BuildFort63Cache()).
+ *
+ * netCDF output (fort.63.nc) that is chunked by node is read by node directly
+ * through Fort63NetCDF, without a cache. Other netCDF output is handled like
+ * ASCII output, since reading one node from it reads the whole file.
+ *
+ * Dry nodes (-99999) are left out of the interpolation, and the remaining weights
+ * are scaled to sum to one. A timestep where all three nodes are dry is dry.
+ *
+ * Only Node numbers and weights are kept once the location is set, so the
+ * object can safely be run as a task on the TaskScheduler through the extract()
+ * slot.
+ *
+ */
+class PointTimeSeries : public QObject
+{
+		Q_OBJECT
+	public:
+		PointTimeSeries(QString newLoc, QObject *parent=0);
+
+		static bool	NodeReadsAreCheap(QString fileLoc);
+
+		bool	SetLocation(Element *element, float x, float y);
+		bool	Extract();
+
+		QString		GetFilePath();
+		QString		GetLocationText();
+		QPolygonF	GetSeries();
+
+	private:
+
+		QString		filePath;
+		unsigned int	nodes[3];	/**< The Element's node numbers */
+		float		weights[3];	/**< The barycentric weight of each node */
+		float		locationX;	/**< The point in domain coordinates */
+		float		locationY;	/**< The point in domain coordinates */
+		QPolygonF	series;		/**< Model time (days) and value of each timestep, with NaN for dry timesteps */
+
+		bool	ReadHistoriesDirectly(std::vector<float> histories[3], std::vector<double> &times, unsigned int &valuesPerNode);
+
+	public slots:
+
+		void	extract();
+
+	signals:
+
+		void	startedExtracting();
+		void	progress(int);
+		void	finishedExtracting();
+		void	emitMessage(QString);
+
+};
+
+#endif // POINTTIMESERIES_H
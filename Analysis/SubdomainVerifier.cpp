@@ -0,0 +1,274 @@
+#include "SubdomainVerifier.h"
+
+SubdomainVerifier::SubdomainVerifier(QString newSubLoc, QString newFullLoc, QString newPy140Loc, QObject *parent) :
+	QObject(parent)
+{
+	subPath = newSubLoc;
+	fullPath = newFullLoc;
+	py140Path = newPy140Loc;
+	outputPath = "";
+	written = false;
+
+	numMatched = 0;
+	maxNode = 0;
+	maxTime = 0.0;
+	maxDiff = 0.0;
+}
+
+
+/**
+ * @brief Sets the file the per-node differences are written to
+ * @param newLoc The output file
+ */
+void SubdomainVerifier::SetOutputPath(QString newLoc)
+{
+	outputPath = newLoc;
+}
+
+
+/**
+ * @brief Streams both files once and writes the per-node differences
+ * @return true if at least one timestep was compared and the differences were written
+ */
+bool SubdomainVerifier::Verify()
+{
+	emit startedVerifying();
+	emit progress(0);
+	written = false;
+	numMatched = 0;
+	maxNode = 0;
+	maxTime = 0.0;
+	maxDiff = 0.0;
+
+	Fort63 subFile (subPath);
+	Fort63 fullFile (fullPath);
+	if (outputPath.isEmpty() || !subFile.BuildIndex() || !fullFile.BuildIndex())
+	{
+		emit emitMessage("<p style='color:red'><strong>Error:</strong> Unable to read the subdomain and full domain output files.</p>");
+		emit finishedVerifying();
+		return false;
+	}
+
+	unsigned int numNodes = subFile.GetNumNodes();
+	unsigned int valuesPerNode = subFile.GetValuesPerNode();
+	std::vector<unsigned int> newToOld = Py140(py140Path).GetNewToOldList();
+	if (valuesPerNode != fullFile.GetValuesPerNode() || newToOld.size() < numNodes)
+	{
+		emit emitMessage("<p style='color:red'><strong>Error:</strong> The subdomain output does not match the full domain output and py.140.</p>");
+		emit finishedVerifying();
+		return false;
+	}
+
+	maxDiffSquared.assign(numNodes, 0.0f);
+	sumDiffSquared.assign(numNodes, 0.0);
+	wetCounts.assign(numNodes, 0);
+	mismatchCounts.assign(numNodes, 0);
+
+	std::vector<float> subValues, fullValues, diffSquared (numNodes);
+	std::vector<unsigned char> wetFlags (numNodes);
+	unsigned int numSubTimesteps = subFile.GetNumTimesteps();
+	unsigned int numFullTimesteps = fullFile.GetNumTimesteps();
+	unsigned int fullTimestep = 1;
+	for (unsigned int ts=1; ts<=numSubTimesteps; ++ts)
+	{
+		if (TaskScheduler::Instance()->CurrentTaskCancelled())
+		{
+			emit finishedVerifying();
+			return false;
+		}
+
+		/* Both files are in time order, so the matching full domain timestep only moves forward */
+		double time = subFile.GetTimestepTime(ts);
+		double tolerance = VERIFY_TIME_TOLERANCE * (fabs(time) > 1.0 ? fabs(time) : 1.0);
+		while (fullTimestep <= numFullTimesteps && fullFile.GetTimestepTime(fullTimestep) < time - tolerance)
+			++fullTimestep;
+		if (fullTimestep > numFullTimesteps)
+			break;
+
+		if (fabs(fullFile.GetTimestepTime(fullTimestep) - time) <= tolerance &&
+		    subFile.ReadTimestep(ts, subValues) && fullFile.ReadTimestep(fullTimestep, fullValues))
+		{
+			CompareTimestep(subValues, fullValues, newToOld, valuesPerNode, diffSquared, wetFlags, time);
+			++numMatched;
+		}
+
+		emit progress((int)(95.0*ts/numSubTimesteps));
+	}
+
+	if (numMatched == 0)
+	{
+		emit emitMessage("<p style='color:red'><strong>Error:</strong> The subdomain and full domain output files have no timesteps in common.</p>");
+		emit finishedVerifying();
+		return false;
+	}
+
+	written = WriteDifferences();
+	if (!written)
+		std::cout << "WARNING: Unable to write " << outputPath.toStdString().data() << std::endl;
+
+	emit emitMessage(GetSummary());
+	emit progress(100);
+	emit finishedVerifying();
+	return written;
+}
+
+
+void SubdomainVerifier::verify()
+{
+	Verify();
+}
+
+
+QString SubdomainVerifier::GetOutputPath()
+{
+	return outputPath;
+}
+
+
+bool SubdomainVerifier::VerificationWritten()
+{
+	return written;
+}
+
+
+unsigned int SubdomainVerifier::GetNumMatchedTimesteps()
+{
+	return numMatched;
+}
+
+
+float SubdomainVerifier::GetMaxDifference()
+{
+	return maxDiff;
+}
+
+
+/**
+ * @brief Returns a description of the largest and RMS differences over the whole subdomain
+ * @return The summary
+ */
+QString SubdomainVerifier::GetSummary()
+{
+	double totalSquared = 0.0;
+	unsigned int totalWet = 0, totalMismatched = 0;
+	for (unsigned int i=0; i<sumDiffSquared.size(); ++i)
+	{
+		totalSquared += sumDiffSquared[i];
+		totalWet += wetCounts[i];
+		totalMismatched += mismatchCounts[i];
+	}
+	double rms = totalWet > 0 ? sqrt(totalSquared / totalWet) : 0.0;
+
+	return QString("Compared ").append(QString::number(numMatched)).append(" timesteps. Max difference ")
+			.append(QString::number(maxDiff, 'g', 6)).append(" at node ").append(QString::number(maxNode))
+			.append(" (t = ").append(QString::number(maxTime, 'g', 10)).append(" s), RMS difference ")
+			.append(QString::number(rms, 'g', 6)).append(", ").append(QString::number(totalMismatched))
+			.append(" wet/dry mismatches.");
+}
+
+
+/**
+ * @brief Folds the differences of one timestep into the per-node results
+ * @param subValues The subdomain values
+ * @param fullValues The full domain values
+ * @param newToOld The full domain node number of each subdomain node
+ * @param valuesPerNode The number of values for each node
+ * @param diffSquared Scratch buffer for the squared difference at each node
+ * @param wetFlags Scratch buffer for the wet state of each node (1 subdomain, 2 full domain)
+ * @param time The model time of the timestep
+ */
+void SubdomainVerifier::CompareTimestep(const std::vector<float> &subValues, const std::vector<float> &fullValues,
+					const std::vector<unsigned int> &newToOld, unsigned int valuesPerNode,
+					std::vector<float> &diffSquared, std::vector<unsigned char> &wetFlags, double time)
+{
+	const unsigned int numNodes = diffSquared.size();
+	const unsigned int numFullNodes = fullValues.size() / valuesPerNode;
+	if (subValues.size() < numNodes*valuesPerNode)
+		return;
+
+	/* Gather the full domain values through py.140 */
+	for (unsigned int i=0; i<numNodes; ++i)
+	{
+		unsigned int oldNode = newToOld[i];
+		if (oldNode == 0 || oldNode > numFullNodes)
+		{
+			diffSquared[i] = 0.0f;
+			wetFlags[i] = 0;
+			continue;
+		}
+
+		const float *sub = &subValues[i*valuesPerNode];
+		const float *full = &fullValues[(oldNode-1)*valuesPerNode];
+		float squared = 0.0f;
+		for (unsigned int j=0; j<valuesPerNode; ++j)
+			squared += (sub[j]-full[j])*(sub[j]-full[j]);
+
+		unsigned char flags = (sub[0] > DRY_VALUE ? 1 : 0) | (full[0] > DRY_VALUE ? 2 : 0);
+		diffSquared[i] = flags == 3 ? squared : 0.0f;
+		wetFlags[i] = flags;
+
+		if (diffSquared[i] > maxDiff*maxDiff)
+		{
+			maxDiff = sqrt(diffSquared[i]);
+			maxNode = i+1;
+			maxTime = time;
+		}
+	}
+
+	/* Accumulate */
+	const float *squared = &diffSquared[0];
+	const unsigned char *flags = &wetFlags[0];
+	float *maxSquared = &maxDiffSquared[0];
+	double *sumSquared = &sumDiffSquared[0];
+	unsigned int *wet = &wetCounts[0];
+	unsigned int *mismatched = &mismatchCounts[0];
+	for (unsigned int i=0; i<numNodes; ++i)
+	{
+		const float value = squared[i];
+		maxSquared[i] = value > maxSquared[i] ? value : maxSquared[i];
+		sumSquared[i] += value;
+		wet[i] += flags[i] == 3;
+		mismatched[i] += (flags[i] == 1) | (flags[i] == 2);
+	}
+}
+
+
+/**
+ * @brief Writes the per-node max and RMS differences in the maxele.63 format
+ *
+ * Writes the per-node max and RMS differences in the maxele.63 format. Nodes that
+ * were never wet in both runs are written as -99999. The file is written to a
+ * temporary file first and renamed once it is complete.
+ *
+ * @return true if the file was written
+ */
+bool SubdomainVerifier::WriteDifferences()
+{
+	QString tempPath = outputPath + ".tmp";
+	std::ofstream outFile (tempPath.toStdString().data());
+	if (!outFile.is_open())
+		return false;
+
+	unsigned int numNodes = maxDiffSquared.size();
+	outFile << "Max and RMS difference from the full domain over " << numMatched << " timesteps\n";
+	outFile << 2 << " " << numNodes << " " << 0.0 << " " << 0 << " " << 1 << "\n";
+
+	outFile << std::scientific << std::setprecision(10);
+	outFile << 0.0 << " " << numMatched << "\n";
+	for (unsigned int i=0; i<numNodes; ++i)
+		outFile << i+1 << " " << (wetCounts[i] > 0 ? sqrt(maxDiffSquared[i]) : DRY_VALUE) << "\n";
+
+	outFile << 0.0 << " " << numMatched << "\n";
+	for (unsigned int i=0; i<numNodes; ++i)
+		outFile << i+1 << " " << (wetCounts[i] > 0 ? sqrt(sumDiffSquared[i] / wetCounts[i]) : DRY_VALUE) << "\n";
+
+	outFile.close();
+	if (outFile.fail())
+	{
+		QFile::remove(tempPath);
+		return false;
+	}
+
+	QFile::remove(outputPath);
+	return QFile::rename(tempPath, outputPath);
+}
@@ -0,0 +1,102 @@
+#ifndef SUBDOMAINVERIFIER_H
+#define SUBDOMAINVERIFIER_H
+
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <cmath>
+
+#include <QObject>
+#include <QString>
+#include <QFile>
+
+#include "Projects/IO/FileIO/Fort63.h"
+#include "Projects/IO/FileIO/Py140.h"
+#include "Tasks/TaskScheduler.h"
+#include "adcData.h"
+
+#define VERIFY_TIME_TOLERANCE	1.0e-6
+
+
+/**
+ * @brief Compares a subdomain's fort.63 or fort.64 with the full domain's
+ *
+ * A subdomain run is only correct if its results match the full domain run inside
+ * the subdomain. This class streams both files once, side by side. Timesteps are
+ * matched by model time, so a subdomain that only wrote part of the run can still be
+ * checked. At each matched timestep the full domain values of the subdomain's nodes
+ * are gathered through py.140 and the difference at every node is folded into a max
+ * and an RMS difference. Vector files are compared by the length of the difference
+ * vector.
+ *
+ * The gather has to follow py.140, but the accumulation loop has no branches and
+ * works on contiguous arrays so the compiler can vectorize it.
+ *
+ * Nodes are only compared while they are wet in both runs. A node that is wet in
+ * one run and dry in the other is counted as a wet/dry mismatch instead.
+ *
+ * The per-node differences are written in the maxele.63 format, with the max
+ * difference in the first record and the RMS difference in the second, so they can
+ * be drawn over the subdomain like any other envelope.
+ *
+ * The verifier is only given file paths, so verify() can run on the TaskScheduler
+ * without touching the Domain it was started from.
+ *
+ */
+class SubdomainVerifier : public QObject
+{
+		Q_OBJECT
+	public:
+		SubdomainVerifier(QString newSubLoc, QString newFullLoc, QString newPy140Loc, QObject *parent=0);
+
+		void	SetOutputPath(QString newLoc);
+
+		bool	Verify();
+
+		/* Getter Methods */
+		QString	GetOutputPath();
+		bool	VerificationWritten();
+		QString	GetSummary();
+		unsigned int	GetNumMatchedTimesteps();
+		float		GetMaxDifference();
+
+	private:
+
+		QString		subPath;
+		QString		fullPath;
+		QString		py140Path;
+		QString		outputPath;
+		bool		written;	/**< Flag that shows if the last verification wrote its differences */
+
+		/* Per-node results */
+		std::vector<float>		maxDiffSquared;	/**< The largest squared difference at each node */
+		std::vector<double>		sumDiffSquared;	/**< The sum of squared differences at each node */
+		std::vector<unsigned int>	wetCounts;	/**< The number of timesteps each node was wet in both runs */
+		std::vector<unsigned int>	mismatchCounts;	/**< The number of timesteps each node was wet in only one run */
+
+		/* Summary */
+		unsigned int	numMatched;	/**< The number of timesteps found in both files */
+		unsigned int	maxNode;	/**< The subdomain node with the largest difference */
+		double		maxTime;	/**< The model time of the largest difference */
+		float		maxDiff;	/**< The largest difference at any node and timestep */
+
+		void	CompareTimestep(const std::vector<float> &subValues, const std::vector<float> &fullValues,
+					const std::vector<unsigned int> &newToOld, unsigned int valuesPerNode,
+					std::vector<float> &diffSquared, std::vector<unsigned char> &wetFlags, double time);
+		bool	WriteDifferences();
+
+	public slots:
+
+		void	verify();
+
+	signals:
+
+		void	startedVerifying();
+		void	progress(int);
+		void	finishedVerifying();
+		void	emitMessage(QString);
+
+};
+
+#endif // SUBDOMAINVERIFIER_H
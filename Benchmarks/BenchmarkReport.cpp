@@ -0,0 +1,104 @@
+#include "BenchmarkReport.h"
+
+BenchmarkReport::BenchmarkReport(std::string benchmarkName)
+{
+	AddValue("benchmark", benchmarkName);
+}
+
+
+void BenchmarkReport::AddValue(std::string key, double value)
+{
+	values.push_back(std::make_pair(key, StageStats::FormatNumber(value)));
+}
+
+
+void BenchmarkReport::AddValue(std::string key, std::string value)
+{
+	values.push_back(std::make_pair(key, "\"" + StageStats::Escape(value) + "\""));
+}
+
+
+/**
+ * @brief Starts a new case, which the case values and stages that follow are added to
+ */
+void BenchmarkReport::StartCase()
+{
+	cases.push_back(BenchmarkCase());
+}
+
+
+void BenchmarkReport::AddCaseValue(std::string key, double value)
+{
+	if (cases.empty())
+		StartCase();
+	cases.back().values.push_back(std::make_pair(key, StageStats::FormatNumber(value)));
+}
+
+
+void BenchmarkReport::AddCaseValue(std::string key, std::string value)
+{
+	if (cases.empty())
+		StartCase();
+	cases.back().values.push_back(std::make_pair(key, "\"" + StageStats::Escape(value) + "\""));
+}
+
+
+/**
+ * @brief Adds a measured stage to the current case
+ * @param result The stage, as returned by StageStats::Finish()
+ */
+void BenchmarkReport::AddStage(StageResult result)
+{
+	if (cases.empty())
+		StartCase();
+	cases.back().stages.push_back(StageStats::ToJson(result));
+}
+
+
+/**
+ * @brief Writes the report
+ * @param filePath The JSON file, which is replaced
+ * @return true if the file was written
+ */
+bool BenchmarkReport::WriteFile(std::string filePath)
+{
+	std::ofstream file (filePath.data(), std::ios::out | std::ios::trunc);
+	if (!file.is_open())
+		return false;
+
+	file << "{" << WriteValues(values) << ",\"cases\":[";
+	for (std::vector<BenchmarkCase>::iterator it = cases.begin(); it != cases.end(); ++it)
+	{
+		if (it != cases.begin())
+			file << ",";
+		file << "\n{" << WriteValues(it->values);
+		if (!it->values.empty())
+			file << ",";
+		file << "\"stages\":[";
+		for (std::vector<std::string>::iterator stage = it->stages.begin(); stage != it->stages.end(); ++stage)
+		{
+			if (stage != it->stages.begin())
+				file << ",";
+			file << "\n" << *stage;
+		}
+		file << "]}";
+	}
+	file << "]}" << std::endl;
+
+	bool written = !file.fail();
+	file.close();
+	return written;
+}
+
+
+std::string BenchmarkReport::WriteValues(const std::vector<std::pair<std::string, std::string> > &valueList)
+{
+	std::string json;
+	for (std::vector<std::pair<std::string, std::string> >::const_iterator it = valueList.begin(); it != valueList.end(); ++it)
+	{
+		if (it != valueList.begin())
+			json += ",";
+		json += "\"" + StageStats::Escape(it->first) + "\":" + it->second;
+	}
+	return json;
+}
@@ -0,0 +1,56 @@
+#ifndef BENCHMARKREPORT_H
+#define BENCHMARKREPORT_H
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#include "CommandLine/StageStats.h"
+
+
+/**
+ * @brief The measurements of one mesh size in a BenchmarkReport
+ */
+struct BenchmarkCase
+{
+		std::vector<std::pair<std::string, std::string> >	values;	/**< Keys and their JSON values */
+		std::vector<std::string>				stages;	/**< The JSON object of each stage */
+};
+
+
+/**
+ * @brief Collects the stages measured by the benchmarks and writes them as one JSON file
+ *
+ * Collects the stages measured by the benchmarks and writes them as one JSON file,
+ * so the results of two builds can be compared with any JSON tool:
+ *
+ *     {"benchmark":"pipeline","qt":"5.15.2",...,"cases":[{"target_elements":10000,...,"stages":[...]}]}
+ *
+ * The values at the top describe the build and the run. Each case holds the values
+ * of one mesh and the stages measured on it, in the order they were run, written
+ * the same way as the lines of StageStats.
+ *
+ */
+class BenchmarkReport
+{
+	public:
+		BenchmarkReport(std::string benchmarkName);
+
+		void	AddValue(std::string key, double value);
+		void	AddValue(std::string key, std::string value);
+		void	StartCase();
+		void	AddCaseValue(std::string key, double value);
+		void	AddCaseValue(std::string key, std::string value);
+		void	AddStage(StageResult result);
+
+		bool	WriteFile(std::string filePath);
+
+	private:
+
+		std::vector<std::pair<std::string, std::string> >	values;
+		std::vector<BenchmarkCase>				cases;
+
+		std::string	WriteValues(const std::vector<std::pair<std::string, std::string> > &valueList);
+};
+
+#endif // BENCHMARKREPORT_H
@@ -0,0 +1,630 @@
+#include "BenchmarkRunner.h"
+
+BenchmarkRunner::BenchmarkRunner(QObject *parent) :
+	CommandLineTool(parent)
+{
+	stats.SetOutput(&std::cout);
+}
+
+
+/**
+ * @brief Runs the benchmark given on the command line
+ * @param arguments The command line, including the program name
+ * @return The exit code of the program
+ */
+int BenchmarkRunner::Run(QStringList arguments)
+{
+	if (arguments.size() > 0)
+		arguments.removeFirst();
+
+	if (arguments.isEmpty())
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	QString command = arguments.takeFirst();
+	if (command == "pipeline")
+		return RunPipeline(arguments);
+	else if (command == "queries")
+		return RunQueries(arguments);
+	else if (command == "help" || command == "--help" || command == "-h")
+	{
+		PrintUsage();
+		return 0;
+	}
+
+	PrintUsage();
+	return Error("Unknown benchmark " + command);
+}
+
+
+/**
+ * @brief Times every stage from reading a mesh to carving fort.066, for meshes of each size
+ *
+ * pipeline [--sizes <n,n,...>] [--timesteps <n>] [--seed <n>] [--repeat <n>] [--bin-size <n>]
+ *          [--shuffle] [--label <text>] [--work-dir <dir>] [--keep] [--report <file>]
+ *
+ * The generated files of each size are written to their own directory in the work
+ * directory, and are removed once the size is done unless --keep is given. Every
+ * stage but generate is run --repeat times, so the spread of the timings can be seen.
+ * --shuffle numbers the nodes and elements in a random order, like a real mesh,
+ * instead of row by row (see MeshGenerator).
+ *
+ * @param args The arguments after the benchmark
+ * @return The exit code
+ */
+int BenchmarkRunner::RunPipeline(QStringList args)
+{
+	bool keep = TakeFlag(args, "--keep");
+	bool shuffle = TakeFlag(args, "--shuffle");
+	std::vector<unsigned int> sizes = ParseSizes(TakeValue(args, "--sizes", BENCH_DEFAULT_SIZES));
+	unsigned int numTimesteps = TakeValue(args, "--timesteps", QString::number(BENCH_DEFAULT_TIMESTEPS)).toUInt();
+	unsigned int seed = TakeValue(args, "--seed", "1").toUInt();
+	int repeat = TakeValue(args, "--repeat", "1").toInt();
+	int binSize = TakeValue(args, "--bin-size", QString::number(BENCH_DEFAULT_BIN_SIZE)).toInt();
+	QString label = TakeValue(args, "--label");
+	QString workPath = TakeValue(args, "--work-dir", QDir::temp().absoluteFilePath("adcSubdomainTool-bench"));
+	QString reportPath = TakeValue(args, "--report", "bench-pipeline.json");
+	if (HasUnknownOption(args) || args.size() != 0 || sizes.empty() || numTimesteps == 0 || repeat <= 0 || binSize <= 0)
+	{
+		PrintUsage();
+		return Error("pipeline takes no arguments besides its options");
+	}
+
+	QDir workDir (workPath);
+	if (!QDir().mkpath(workDir.absolutePath()))
+		return Error("Unable to create " + workPath);
+
+	BenchmarkReport report ("pipeline");
+	AddBuildValues(report);
+	report.AddValue("label", label.toStdString());
+	report.AddValue("seed", seed);
+	report.AddValue("shuffled", shuffle ? 1 : 0);
+	report.AddValue("timesteps", numTimesteps);
+	report.AddValue("repeat", repeat);
+	report.AddValue("bin_size", binSize);
+
+	int failures = 0;
+	for (std::vector<unsigned int>::iterator it = sizes.begin(); it != sizes.end(); ++it)
+	{
+		MeshGenerator generator;
+		generator.SetNumElements(*it);
+		generator.SetSeed(seed);
+		generator.SetShuffledNumbering(shuffle);
+		generator.SetNumTimesteps(numTimesteps);
+
+		report.StartCase();
+		report.AddCaseValue("target_elements", *it);
+		report.AddCaseValue("nodes", generator.GetNumNodes());
+		report.AddCaseValue("elements", generator.GetNumElements());
+		report.AddCaseValue("subdomain_nodes", generator.GetNumSubdomainNodes());
+		report.AddCaseValue("recorded_nodes", generator.GetNumRecordedNodes());
+
+		QString casePath = workDir.absoluteFilePath(QString("mesh_%1").arg(*it));
+		if (!RunPipelineCase(generator, QDir(casePath), binSize, repeat, report))
+			failures += Error(QString("The pipeline did not complete for %1 elements").arg(*it));
+
+		if (!keep)
+			RemoveDirectory(casePath);
+	}
+
+	if (!report.WriteFile(reportPath.toStdString()))
+		return Error("Unable to write " + reportPath);
+	std::cerr << "Wrote " << reportPath.toStdString() << std::endl;
+	return failures > 0 ? 1 : 0;
+}
+
+
+/**
+ * @brief Generates the files of one mesh and runs every stage of the pipeline on them
+ * @param generator The generator, set up for the mesh
+ * @param caseDir The directory to write the files in
+ * @param binSize The bin size of the Quadtree
+ * @param repeat The number of times to run each stage
+ * @param report The report to add the stages to
+ * @return true if every stage succeeded
+ */
+bool BenchmarkRunner::RunPipelineCase(MeshGenerator &generator, QDir caseDir, int binSize, int repeat, BenchmarkReport &report)
+{
+	QString fullPath = caseDir.absoluteFilePath("full");
+	QString subPath = caseDir.absoluteFilePath("sub");
+	QString extractedPath = caseDir.absoluteFilePath("extracted");
+	QString fort14Path = QDir(fullPath).absoluteFilePath("fort.14");
+	QString fort066Path = QDir(fullPath).absoluteFilePath("fort.066");
+	QString py140Path = QDir(subPath).absoluteFilePath("py.140");
+
+	stats.Start("generate");
+	bool generated = QDir().mkpath(fullPath) && QDir().mkpath(subPath) && QDir().mkpath(extractedPath) &&
+			 generator.WriteFort14File(fort14Path.toStdString()) &&
+			 generator.WritePy140File(py140Path.toStdString()) &&
+			 generator.WriteFort066File(fort066Path.toStdString());
+	stats.AddValue("fort14_bytes", QFileInfo(fort14Path).size());
+	stats.AddValue("fort066_bytes", QFileInfo(fort066Path).size());
+	report.AddStage(stats.Finish());
+	if (!generated)
+		return false;
+
+	float subL, subR, subB, subT;
+	generator.GetSubdomainBounds(subL, subR, subB, subT);
+
+	for (int run=1; run<=repeat; ++run)
+	{
+		std::string infoLine;
+		std::vector<Node> nodes;
+		std::vector<Element> elements;
+		std::vector<unsigned int> boundaryNodes;
+
+		stats.Start("parse");
+		stats.AddValue("run", run);
+		Fort14 fort14 (fort14Path.toStdString());
+		bool read = fort14.ReadFile(infoLine, nodes, elements, boundaryNodes);
+		stats.AddValue("nodes", nodes.size());
+		stats.AddValue("elements", elements.size());
+		report.AddStage(stats.Finish());
+		if (!read)
+			return false;
+
+		MeshNormalizer normalizer;
+		stats.Start("normalize");
+		stats.AddValue("run", run);
+		normalizer.FindExtents(nodes);
+		normalizer.NormalizeNodes(nodes);
+		report.AddStage(stats.Finish());
+
+		stats.Start("quadtree");
+		stats.AddValue("run", run);
+		Quadtree quadtree (nodes, elements, binSize, normalizer.GetNormalizedMinX(), normalizer.GetNormalizedMaxX(),
+				   normalizer.GetNormalizedMinY(), normalizer.GetNormalizedMaxY());
+		report.AddStage(stats.Finish());
+
+		/* Viewports from the whole mesh down to 1/64 of its width, the same on every run */
+		float minX = normalizer.GetNormalizedMinX();
+		float minY = normalizer.GetNormalizedMinY();
+		float width = normalizer.GetNormalizedMaxX() - minX;
+		float height = normalizer.GetNormalizedMaxY() - minY;
+		unsigned long long randomState = 1;
+		unsigned long long numLeaves = 0, numCulledElements = 0;
+		stats.Start("culling");
+		stats.AddValue("run", run);
+		for (int i=0; i<BENCH_NUM_VIEWPORTS; ++i)
+		{
+			float zoom = pow(2.0, -6.0 * NextRandom(randomState));
+			float centerX = minX + width * NextRandom(randomState);
+			float centerY = minY + height * NextRandom(randomState);
+			std::vector<std::vector<Element*> *> leaves = quadtree.GetElementsThroughDepth(BENCH_CULLING_DEPTH,
+												    centerX - 0.5*zoom*width,
+												    centerX + 0.5*zoom*width,
+												    centerY - 0.5*zoom*height,
+												    centerY + 0.5*zoom*height);
+			numLeaves += leaves.size();
+			for (std::vector<std::vector<Element*> *>::iterator it = leaves.begin(); it != leaves.end(); ++it)
+				if (*it)
+					numCulledElements += (*it)->size();
+		}
+		stats.AddValue("viewports", BENCH_NUM_VIEWPORTS);
+		stats.AddValue("leaves", numLeaves);
+		stats.AddValue("visible_elements", numCulledElements);
+		report.AddStage(stats.Finish());
+
+		stats.Start("boundary");
+		stats.AddValue("run", run);
+		BoundaryFinder boundaryFinder;
+		Boundaries boundaries = boundaryFinder.FindAllBoundaries(&elements);
+		stats.AddValue("inner_boundary_nodes", boundaries.innerBoundaryNodes.size());
+		stats.AddValue("outer_boundary_nodes", boundaries.outerBoundaryNodes.size());
+		report.AddStage(stats.Finish());
+
+		stats.Start("subdomain_extract");
+		stats.AddValue("run", run);
+		SubdomainExtractor extractor;
+		extractor.SetElements(quadtree.FindElementsInRectangle(normalizer.NormalizeX(subL), normalizer.NormalizeX(subR),
+								       normalizer.NormalizeY(subB), normalizer.NormalizeY(subT)));
+		extractor.SetFullDomainSize(nodes.size(), elements.size());
+		extractor.SetSubdomainName("bench");
+		extractor.Extract();
+		stats.AddValue("nodes", extractor.GetNumNodes());
+		stats.AddValue("elements", extractor.GetNumElements());
+		stats.AddValue("boundary_nodes", extractor.GetBoundaryNodes().size());
+		report.AddStage(stats.Finish());
+		if (!extractor.HasSufficientElements() || !extractor.HasSufficientNodes())
+			return false;
+
+		QDir extractedDir (extractedPath);
+		stats.Start("subdomain_write");
+		stats.AddValue("run", run);
+		bool written = extractor.WriteFort14File(extractedDir.absoluteFilePath("fort.14").toStdString()) &&
+			       extractor.WritePy140File(extractedDir.absoluteFilePath("py.140").toStdString()) &&
+			       extractor.WritePy141File(extractedDir.absoluteFilePath("py.141").toStdString());
+		report.AddStage(stats.Finish());
+		if (!written)
+			return false;
+
+		/* The carver appends to an existing fort.020 */
+		QFile::remove(QDir(subPath).absoluteFilePath("fort.020"));
+		std::vector<SubdomainFiles> subdomains;
+		subdomains.push_back(SubdomainFiles(subPath, QDir(subPath).absoluteFilePath("fort.14"), py140Path,
+						    QDir(subPath).absoluteFilePath("py.141")));
+
+		stats.Start("carve");
+		stats.AddValue("run", run);
+		Fort066 carver (fort066Path);
+		connect(&carver, SIGNAL(emitMessage(QString)), this, SLOT(printMessage(QString)));
+		carver.SetSubdomains(subdomains);
+		carver.CarveAllSubdomains();
+		bool carved = carver.CarvedAllTimesteps();
+		stats.AddValue("fort020_bytes", QFileInfo(QDir(subPath).absoluteFilePath("fort.020")).size());
+		report.AddStage(stats.Finish());
+		if (!carved)
+			return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Times the searches of the Quadtree and checks their results, for meshes and bin sizes of each size
+ *
+ * queries [--sizes <n,n,...>] [--bin-sizes <n,n,...>] [--queries <n>] [--seed <n>] [--no-verify]
+ *         [--shuffle] [--label <text>] [--work-dir <dir>] [--keep] [--report <file>]
+ *
+ * The same queries are run for every bin size of a mesh, so the bin sizes can be
+ * compared. Checking a result searches the whole mesh, so --no-verify can be given
+ * to time meshes that are too large to check in a reasonable time.
+ *
+ * @param args The arguments after the benchmark
+ * @return The exit code, which is 1 if any result was wrong
+ */
+int BenchmarkRunner::RunQueries(QStringList args)
+{
+	bool keep = TakeFlag(args, "--keep");
+	bool verify = !TakeFlag(args, "--no-verify");
+	bool shuffle = TakeFlag(args, "--shuffle");
+	std::vector<unsigned int> sizes = ParseSizes(TakeValue(args, "--sizes", BENCH_DEFAULT_QUERY_SIZES));
+	std::vector<unsigned int> binSizes = ParseSizes(TakeValue(args, "--bin-sizes", BENCH_DEFAULT_BIN_SIZES));
+	unsigned int numQueries = TakeValue(args, "--queries", QString::number(BENCH_DEFAULT_NUM_QUERIES)).toUInt();
+	unsigned int seed = TakeValue(args, "--seed", "1").toUInt();
+	QString label = TakeValue(args, "--label");
+	QString workPath = TakeValue(args, "--work-dir", QDir::temp().absoluteFilePath("adcSubdomainTool-bench"));
+	QString reportPath = TakeValue(args, "--report", "bench-queries.json");
+	if (HasUnknownOption(args) || args.size() != 0 || sizes.empty() || binSizes.empty() || numQueries == 0)
+	{
+		PrintUsage();
+		return Error("queries takes no arguments besides its options");
+	}
+
+	QDir workDir (workPath);
+	if (!QDir().mkpath(workDir.absolutePath()))
+		return Error("Unable to create " + workPath);
+
+	BenchmarkReport report ("queries");
+	AddBuildValues(report);
+	report.AddValue("label", label.toStdString());
+	report.AddValue("seed", seed);
+	report.AddValue("shuffled", shuffle ? 1 : 0);
+	report.AddValue("queries", numQueries);
+	report.AddValue("verified", verify ? 1 : 0);
+
+	int failures = 0;
+	for (std::vector<unsigned int>::iterator it = sizes.begin(); it != sizes.end(); ++it)
+	{
+		MeshGenerator generator;
+		generator.SetNumElements(*it);
+		generator.SetSeed(seed);
+		generator.SetShuffledNumbering(shuffle);
+
+		report.StartCase();
+		report.AddCaseValue("target_elements", *it);
+		report.AddCaseValue("nodes", generator.GetNumNodes());
+		report.AddCaseValue("elements", generator.GetNumElements());
+
+		QString casePath = workDir.absoluteFilePath(QString("queries_%1").arg(*it));
+		QString fort14Path = QDir(casePath).absoluteFilePath("fort.14");
+		stats.Start("generate");
+		bool generated = QDir().mkpath(casePath) && generator.WriteFort14File(fort14Path.toStdString());
+		report.AddStage(stats.Finish());
+
+		std::string infoLine;
+		std::vector<Node> nodes;
+		std::vector<Element> elements;
+		std::vector<unsigned int> boundaryNodes;
+		Fort14 fort14 (fort14Path.toStdString());
+		if (!generated || !fort14.ReadFile(infoLine, nodes, elements, boundaryNodes))
+		{
+			failures += Error(QString("Unable to generate a mesh of %1 elements").arg(*it));
+			if (!keep)
+				RemoveDirectory(casePath);
+			continue;
+		}
+
+		MeshNormalizer normalizer;
+		normalizer.FindExtents(nodes);
+		normalizer.NormalizeNodes(nodes);
+		std::vector<SpatialQuery> queries = CreateQueries(normalizer, numQueries, seed);
+		QueryOracle oracle (&nodes, &elements);
+
+		for (std::vector<unsigned int>::iterator binSize = binSizes.begin(); binSize != binSizes.end(); ++binSize)
+		{
+			stats.Start("quadtree");
+			stats.AddValue("bin_size", *binSize);
+			Quadtree quadtree (nodes, elements, *binSize, normalizer.GetNormalizedMinX(), normalizer.GetNormalizedMaxX(),
+					   normalizer.GetNormalizedMinY(), normalizer.GetNormalizedMaxY());
+			report.AddStage(stats.Finish());
+
+			for (int tool=0; tool<NumQueryTools; ++tool)
+				if (!RunQueryTool((QueryTool)tool, quadtree, verify ? &oracle : 0, queries, *binSize, report))
+					++failures;
+		}
+
+		if (!keep)
+			RemoveDirectory(casePath);
+	}
+
+	if (!report.WriteFile(reportPath.toStdString()))
+		return Error("Unable to write " + reportPath);
+	std::cerr << "Wrote " << reportPath.toStdString() << std::endl;
+	return failures > 0 ? 1 : 0;
+}
+
+
+/**
+ * @brief Times one search of the Quadtree over every query, and checks the results
+ *
+ * Times one search of the Quadtree over every query, and checks the results. Each query
+ * is timed on its own so the spread of the latencies can be reported, and the checks
+ * are not part of the query times, although they are part of the time of the stage.
+ *
+ * @param tool The search to run
+ * @param quadtree The Quadtree to search
+ * @param oracle The oracle to check the results with, or 0 to only time the search
+ * @param queries The queries
+ * @param binSize The bin size of the Quadtree, for the report
+ * @param report The report to add the stage to
+ * @return true if every result was correct
+ */
+bool BenchmarkRunner::RunQueryTool(QueryTool tool, Quadtree &quadtree, QueryOracle *oracle, std::vector<SpatialQuery> &queries,
+				   int binSize, BenchmarkReport &report)
+{
+	static const char *toolNames[NumQueryTools] = {"find_node", "find_element", "find_elements_in_circle",
+						       "find_elements_in_rectangle", "find_elements_in_polygon"};
+
+	std::vector<qint64> latencies;
+	latencies.reserve(queries.size());
+	unsigned long long numResults = 0, numWrong = 0, numMissed = 0, numExtra = 0, numDuplicates = 0;
+	QElapsedTimer timer;
+
+	stats.Start(toolNames[tool]);
+	stats.AddValue("bin_size", binSize);
+	for (std::vector<SpatialQuery>::iterator it = queries.begin(); it != queries.end(); ++it)
+	{
+		Node *node = 0;
+		Element *element = 0;
+		std::vector<Element*> selection;
+
+		timer.start();
+		if (tool == FindNodeQuery)
+			node = quadtree.FindNode(it->x, it->y);
+		else if (tool == FindElementQuery)
+			element = quadtree.FindElement(it->x, it->y);
+		else if (tool == CircleQuery)
+			selection = quadtree.FindElementsInCircle(it->x, it->y, it->radius);
+		else if (tool == RectangleQuery)
+			selection = quadtree.FindElementsInRectangle(it->x - it->halfWidth, it->x + it->halfWidth,
+								     it->y - it->halfHeight, it->y + it->halfHeight);
+		else
+			selection = quadtree.FindElementsInPolygon(it->polygon);
+		latencies.push_back(timer.nsecsElapsed());
+
+		numResults += selection.size() + (node ? 1 : 0) + (element ? 1 : 0);
+		if (!oracle)
+			continue;
+
+		bool correct = true;
+		if (tool == FindNodeQuery)
+			correct = oracle->CheckNode(it->x, it->y, node);
+		else if (tool == FindElementQuery)
+			correct = oracle->CheckElement(it->x, it->y, element);
+		else if (tool == CircleQuery)
+			correct = oracle->CheckCircle(it->x, it->y, it->radius, selection);
+		else if (tool == RectangleQuery)
+			correct = oracle->CheckRectangle(it->x - it->halfWidth, it->x + it->halfWidth,
+							 it->y - it->halfHeight, it->y + it->halfHeight, selection);
+		else
+			correct = oracle->CheckPolygon(it->polygon, selection);
+
+		numWrong += correct ? 0 : 1;
+		numMissed += oracle->GetNumMissed();
+		numExtra += oracle->GetNumExtra();
+		numDuplicates += oracle->GetNumDuplicates();
+	}
+
+	AddLatencyValues(latencies);
+	stats.AddValue("mean_results", queries.empty() ? 0.0 : double(numResults) / queries.size());
+	if (oracle)
+	{
+		stats.AddValue("wrong", numWrong);
+		stats.AddValue("missed", numMissed);
+		stats.AddValue("extra", numExtra);
+		stats.AddValue("duplicates", numDuplicates);
+	}
+	report.AddStage(stats.Finish());
+
+	if (numWrong > 0)
+		Error(QString("%1 of %2 results of %3 were wrong with a bin size of %4").arg(numWrong).arg(queries.size())
+		      .arg(toolNames[tool]).arg(binSize));
+	return numWrong == 0;
+}
+
+
+/**
+ * @brief Creates queries spread over the mesh, the same for every seed on every machine
+ *
+ * Creates queries spread over the mesh. The shapes range from a thousandth to a tenth
+ * of the size of the mesh, spread evenly on a log scale, so both the searches that end
+ * in a few leaves and the ones that take whole branches are timed.
+ *
+ * @param normalizer The normalizer of the mesh
+ * @param numQueries The number of queries
+ * @param seed The seed of the random sequence
+ * @return The queries
+ */
+std::vector<SpatialQuery> BenchmarkRunner::CreateQueries(MeshNormalizer &normalizer, unsigned int numQueries, unsigned int seed)
+{
+	float minX = normalizer.GetNormalizedMinX();
+	float minY = normalizer.GetNormalizedMinY();
+	float width = normalizer.GetNormalizedMaxX() - minX;
+	float height = normalizer.GetNormalizedMaxY() - minY;
+	float meshSize = std::max(width, height);
+	unsigned long long randomState = seed;
+
+	std::vector<SpatialQuery> queries (numQueries);
+	for (std::vector<SpatialQuery>::iterator it = queries.begin(); it != queries.end(); ++it)
+	{
+		it->x = minX + width * NextRandom(randomState);
+		it->y = minY + height * NextRandom(randomState);
+		it->radius = meshSize * pow(10.0, -3.0 + 2.0 * NextRandom(randomState));
+		it->halfWidth = it->radius * (0.5 + NextRandom(randomState));
+		it->halfHeight = it->radius * (0.5 + NextRandom(randomState));
+
+		int numCorners = 3 + int(10 * NextRandom(randomState));
+		for (int i=0; i<numCorners; ++i)
+		{
+			double angle = 2.0 * MESH_GENERATOR_PI * (i + 0.8 * NextRandom(randomState)) / numCorners;
+			double distance = it->radius * (0.3 + 0.7 * NextRandom(randomState));
+			it->polygon.push_back(Point(it->x + distance * cos(angle), it->y + distance * sin(angle)));
+		}
+	}
+	return queries;
+}
+
+
+/**
+ * @brief Adds the rate and the spread of the latencies of a set of queries to the current stage
+ * @param latencies The time of each query, in nanoseconds
+ */
+void BenchmarkRunner::AddLatencyValues(std::vector<qint64> latencies)
+{
+	if (latencies.empty())
+		return;
+
+	std::sort(latencies.begin(), latencies.end());
+	double total = 0.0;
+	for (std::vector<qint64>::iterator it = latencies.begin(); it != latencies.end(); ++it)
+		total += *it;
+
+	unsigned int count = latencies.size();
+	stats.AddValue("queries", count);
+	stats.AddValue("queries_per_s", total > 0.0 ? count / (total / 1.0e9) : 0.0);
+	stats.AddValue("mean_us", total / count / 1.0e3);
+	stats.AddValue("p50_us", latencies[std::min(count-1, (unsigned int)(0.50 * count))] / 1.0e3);
+	stats.AddValue("p90_us", latencies[std::min(count-1, (unsigned int)(0.90 * count))] / 1.0e3);
+	stats.AddValue("p99_us", latencies[std::min(count-1, (unsigned int)(0.99 * count))] / 1.0e3);
+	stats.AddValue("max_us", latencies.back() / 1.0e3);
+}
+
+
+/**
+ * @brief Adds the values that tell which build and machine a report came from
+ * @param report The report
+ */
+void BenchmarkRunner::AddBuildValues(BenchmarkReport &report)
+{
+	report.AddValue("date", QDateTime::currentDateTime().toString(Qt::ISODate).toStdString());
+	report.AddValue("qt", qVersion());
+#if defined(__clang__)
+	report.AddValue("compiler", std::string("clang ") + __clang_version__);
+#elif defined(__GNUC__)
+	report.AddValue("compiler", std::string("gcc ") + __VERSION__);
+#elif defined(_MSC_VER)
+	report.AddValue("compiler", "msvc " + QString::number(_MSC_VER).toStdString());
+#else
+	report.AddValue("compiler", "unknown");
+#endif
+#ifdef QT_NO_DEBUG
+	report.AddValue("build", "release");
+#else
+	report.AddValue("build", "debug");
+#endif
+	report.AddValue("threads", TaskScheduler::Instance()->GetNumThreads());
+}
+
+
+/**
+ * @brief Reads a comma separated list of mesh or bin sizes
+ * @param sizes The list, such as 10000,100000
+ * @return The sizes, or an empty list if any of them is not a positive number
+ */
+std::vector<unsigned int> BenchmarkRunner::ParseSizes(QString sizes)
+{
+	std::vector<unsigned int> sizeList;
+	QStringList parts = sizes.split(",", QString::SkipEmptyParts);
+	for (QStringList::iterator it = parts.begin(); it != parts.end(); ++it)
+	{
+		bool ok = false;
+		unsigned int size = it->trimmed().toUInt(&ok);
+		if (!ok || size < 2)
+		{
+			Error("Invalid size " + *it);
+			return std::vector<unsigned int>();
+		}
+		sizeList.push_back(size);
+	}
+	return sizeList;
+}
+
+
+/**
+ * @brief Removes a directory and everything in it
+ * @param path The directory
+ * @return true if it was removed
+ */
+bool BenchmarkRunner::RemoveDirectory(QString path)
+{
+	QDir dir (path);
+	if (!dir.exists())
+		return true;
+
+	QFileInfoList entries = dir.entryInfoList(QDir::NoDotAndDotDot | QDir::Files | QDir::Dirs | QDir::Hidden);
+	for (QFileInfoList::iterator it = entries.begin(); it != entries.end(); ++it)
+	{
+		if (it->isDir())
+			RemoveDirectory(it->absoluteFilePath());
+		else
+			QFile::remove(it->absoluteFilePath());
+	}
+	return QDir().rmdir(path);
+}
+
+
+/**
+ * @brief Returns the next number of a random sequence that is the same on every machine
+ * @param state The state of the sequence, which is advanced
+ * @return A number from 0 to 1
+ */
+double BenchmarkRunner::NextRandom(unsigned long long &state)
+{
+	state += 0x9E3779B97F4A7C15ULL;
+	unsigned long long value = state;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+	value = value ^ (value >> 31);
+	return (value >> 11) * (1.0 / 9007199254740992.0);
+}
+
+
+void BenchmarkRunner::PrintUsage()
+{
+	std::cerr << "Usage: adcSubdomainTool-bench <benchmark> [options]" << std::endl <<
+		     std::endl <<
+		     "Benchmarks:" << std::endl <<
+		     "  pipeline [--sizes <n,n,...>] [--timesteps <n>] [--seed <n>] [--repeat <n>] [--bin-size <n>]" << std::endl <<
+		     "           [--shuffle] [--label <text>] [--work-dir <dir>] [--keep] [--report <file>]" << std::endl <<
+		     "  queries [--sizes <n,n,...>] [--bin-sizes <n,n,...>] [--queries <n>] [--seed <n>] [--no-verify]" << std::endl <<
+		     "          [--shuffle] [--label <text>] [--work-dir <dir>] [--keep] [--report <file>]" << std::endl <<
+		     std::endl <<
+		     "Sizes are numbers of elements, and default to " << BENCH_DEFAULT_SIZES << " for pipeline" << std::endl <<
+		     "and " << BENCH_DEFAULT_QUERY_SIZES << " for queries." << std::endl <<
+		     "--shuffle numbers the nodes and elements of the generated meshes in a random order." << std::endl <<
+		     "Each stage is written to stdout as a line of JSON, and the whole run to the report." << std::endl;
+}
@@ -0,0 +1,108 @@
+#ifndef BENCHMARKRUNNER_H
+#define BENCHMARKRUNNER_H
+
+#include <vector>
+#include <string>
+#include <iostream>
+#include <algorithm>
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QStringList>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+
+#include "adcData.h"
+#include "CommandLine/CommandLineTool.h"
+#include "Benchmarks/MeshGenerator.h"
+#include "Benchmarks/BenchmarkReport.h"
+#include "Benchmarks/QueryOracle.h"
+#include "Quadtree/Quadtree.h"
+#include "Quadtree/MeshNormalizer.h"
+#include "SubdomainTools/BoundaryFinder.h"
+#include "SubdomainTools/SubdomainExtractor.h"
+#include "Projects/IO/FileIO/SubdomainFiles.h"
+#include "Projects/IO/FileIO/Fort14.h"
+#include "Projects/IO/FileIO/Fort066.h"
+#include "Tasks/TaskScheduler.h"
+
+#define BENCH_DEFAULT_SIZES		"10000,100000,1000000"
+#define BENCH_DEFAULT_TIMESTEPS		100
+#define BENCH_DEFAULT_BIN_SIZE		50
+#define BENCH_CULLING_DEPTH		5	/**< The viewing depth of TerrainLayer */
+#define BENCH_NUM_VIEWPORTS		100
+#define BENCH_DEFAULT_QUERY_SIZES	"10000,100000"
+#define BENCH_DEFAULT_BIN_SIZES		"10,50,200"
+#define BENCH_DEFAULT_NUM_QUERIES	1000
+
+
+/**
+ * @brief The Quadtree searches timed by the queries benchmark
+ */
+enum QueryTool {FindNodeQuery, FindElementQuery, CircleQuery, RectangleQuery, PolygonQuery, NumQueryTools};
+
+
+/**
+ * @brief A randomized query of the queries benchmark, in normalized coordinates
+ */
+struct SpatialQuery
+{
+		float			x;		/**< The point, or the center of the shape */
+		float			y;
+		float			radius;		/**< The radius of the circle */
+		float			halfWidth;	/**< Half the width of the rectangle */
+		float			halfHeight;	/**< Half the height of the rectangle */
+		std::vector<Point>	polygon;	/**< A star shaped polygon around the point, which is often not convex */
+};
+
+
+/**
+ * @brief The benchmarks of adcSubdomainTool-bench
+ *
+ * The benchmarks of adcSubdomainTool-bench, which time the core operations of the
+ * tool on synthetic meshes of any size (see MeshGenerator), so the effect of a change
+ * can be measured the same way on every machine without real model output:
+ *
+ * - pipeline: for each mesh size, generates fort.14, py.140 and fort.066, then times
+ *   reading the mesh, building the Quadtree, culling viewports through the Quadtree
+ *   like TerrainLayer does, finding the boundaries, extracting and writing a
+ *   subdomain, and carving fort.066 for it
+ * - queries: for each mesh size and Quadtree bin size, times each search of the
+ *   Quadtree over the same randomized queries, and checks every result against a
+ *   search of the whole mesh (see QueryOracle)
+ *
+ * Each stage is written to stdout as it finishes (see StageStats), and the whole run
+ * is written to a JSON report (see BenchmarkReport) that describes the build, so the
+ * reports of two builds can be compared.
+ *
+ */
+class BenchmarkRunner : public CommandLineTool
+{
+		Q_OBJECT
+	public:
+		BenchmarkRunner(QObject *parent=0);
+
+		int	Run(QStringList arguments);
+
+	private:
+
+		/* Benchmarks */
+		int	RunPipeline(QStringList args);
+		bool	RunPipelineCase(MeshGenerator &generator, QDir caseDir, int binSize, int repeat, BenchmarkReport &report);
+		int	RunQueries(QStringList args);
+		bool	RunQueryTool(QueryTool tool, Quadtree &quadtree, QueryOracle *oracle, std::vector<SpatialQuery> &queries,
+				     int binSize, BenchmarkReport &report);
+
+		/* Helpers */
+		void			AddBuildValues(BenchmarkReport &report);
+		std::vector<unsigned int>	ParseSizes(QString sizes);
+		std::vector<SpatialQuery>	CreateQueries(MeshNormalizer &normalizer, unsigned int numQueries, unsigned int seed);
+		void			AddLatencyValues(std::vector<qint64> latencies);
+		bool			RemoveDirectory(QString path);
+		static double		NextRandom(unsigned long long &state);
+		void			PrintUsage();
+};
+
+#endif // BENCHMARKRUNNER_H
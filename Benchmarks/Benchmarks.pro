@@ -0,0 +1,30 @@
+#-------------------------------------------------
+#
+# adcSubdomainTool-bench: times the core operations on synthetic meshes
+#
+#-------------------------------------------------
+
+QT       = core
+
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = adcSubdomainTool-bench
+TEMPLATE = app
+
+CORE_BUILD_DIR = $$OUT_PWD/../Core
+include(../Core/Core.pri)
+include(../CommandLine/CommandLine.pri)
+
+
+SOURCES += main.cpp \
+    BenchmarkRunner.cpp \
+    BenchmarkReport.cpp \
+    MeshGenerator.cpp \
+    QueryOracle.cpp
+
+HEADERS  += \
+    BenchmarkRunner.h \
+    BenchmarkReport.h \
+    MeshGenerator.h \
+    QueryOracle.h
@@ -0,0 +1,440 @@
+#include "MeshGenerator.h"
+
+MeshGenerator::MeshGenerator()
+{
+	nx = 2;
+	ny = 2;
+	seed = 1;
+	numTimesteps = 100;
+	subdomainFraction = 0.2;
+	shuffledNumbering = false;
+	FindSubdomain();
+}
+
+
+/**
+ * @brief Sets the number of Elements to generate
+ *
+ * Sets the number of Elements to generate. The mesh is two triangles per grid
+ * cell, with about one and a half times as many cells across as up, so the actual
+ * count is the nearest that fits (see GetNumElements()).
+ *
+ * @param target The number of Elements
+ */
+void MeshGenerator::SetNumElements(unsigned int target)
+{
+	double cells = std::max(1.0, target / 2.0);
+	unsigned int rows = std::max(1u, (unsigned int)(sqrt(cells / 1.5) + 0.5));
+	unsigned int columns = std::max(1u, (unsigned int)(cells / rows + 0.5));
+	nx = columns + 1;
+	ny = rows + 1;
+	FindSubdomain();
+}
+
+
+void MeshGenerator::SetSeed(unsigned int newSeed)
+{
+	seed = newSeed;
+}
+
+
+void MeshGenerator::SetNumTimesteps(unsigned int newNumTimesteps)
+{
+	numTimesteps = newNumTimesteps;
+}
+
+
+/**
+ * @brief Sets the size of the subdomain
+ * @param fraction The width and height of the subdomain, as a fraction of the mesh (0 to 1)
+ */
+void MeshGenerator::SetSubdomainFraction(double fraction)
+{
+	if (fraction > 0.0 && fraction <= 1.0)
+		subdomainFraction = fraction;
+	FindSubdomain();
+}
+
+
+/**
+ * @brief Sets whether the nodes and elements are numbered in a random order
+ *
+ * Sets whether the nodes and elements are numbered in a random order instead of row
+ * by row. The order is the same for every call with the same seed.
+ *
+ * @param shuffle true to number the nodes and elements in a random order
+ */
+void MeshGenerator::SetShuffledNumbering(bool shuffle)
+{
+	shuffledNumbering = shuffle;
+}
+
+
+/**
+ * @brief Writes the full domain mesh
+ * @param filePath The fort.14 file
+ * @return true if the file was written
+ */
+bool MeshGenerator::WriteFort14File(std::string filePath)
+{
+	std::ofstream file (filePath.data());
+	if (!file.is_open())
+		return false;
+
+	file << "Synthetic mesh " << GetNumElements() << " elements, seed " << seed << std::endl;
+	file << GetNumElements() << " " << GetNumNodes() << std::endl;
+
+	/* Each line is found from its number, so the lines are in order when the numbering is shuffled */
+	unsigned int numNodes = GetNumNodes();
+	file << std::fixed << std::setprecision(8);
+	for (unsigned int nodeNumber=1; nodeNumber<=numNodes; ++nodeNumber)
+	{
+		unsigned int index = Permute(nodeNumber-1, numNodes, MESH_GENERATOR_NODE_SALT, true);
+		double x, y, z;
+		FindNodePosition(index % nx, index / nx, x, y, z);
+		file << nodeNumber << "\t" << x << "\t" << y << "\t" << z << "\n";
+	}
+
+	unsigned int numElements = GetNumElements();
+	for (unsigned int elementNumber=1; elementNumber<=numElements; ++elementNumber)
+	{
+		/* Each cell is split into two triangles */
+		unsigned int triangle = Permute(elementNumber-1, numElements, MESH_GENERATOR_ELEMENT_SALT, true);
+		unsigned int cell = triangle / 2;
+		unsigned int i = cell % (nx-1);
+		unsigned int j = cell / (nx-1);
+
+		/* Counterclockwise corners of the cell */
+		unsigned int a = NodeNumber(i, j);
+		unsigned int b = NodeNumber(i+1, j);
+		unsigned int c = NodeNumber(i+1, j+1);
+		unsigned int d = NodeNumber(i, j+1);
+		file << elementNumber << "\t3\t";
+		if (Random(j*nx + i, 3) < 0.5)
+		{
+			if (triangle % 2 == 0)
+				file << a << "\t" << b << "\t" << c << "\n";
+			else
+				file << a << "\t" << c << "\t" << d << "\n";
+		} else {
+			if (triangle % 2 == 0)
+				file << a << "\t" << b << "\t" << d << "\n";
+			else
+				file << b << "\t" << c << "\t" << d << "\n";
+		}
+	}
+
+	/* The west side is open ocean. The node count of a segment is alone on its line,
+	 * since that is all Fort14 reads there. */
+	file << "1 = Number of open boundaries" << std::endl;
+	file << ny << " = Total number of open boundary nodes" << std::endl;
+	file << ny << std::endl;
+	for (unsigned int j=0; j<ny; ++j)
+		file << NodeNumber(0, j) << "\n";
+
+	/* The south, east and north sides are land */
+	unsigned int numLandNodes = 2*(nx-1) + ny;
+	file << "1 = Number of land boundaries" << std::endl;
+	file << numLandNodes << " = Total number of land boundary nodes" << std::endl;
+	file << numLandNodes << " 0" << std::endl;
+	for (unsigned int i=1; i<nx; ++i)
+		file << NodeNumber(i, 0) << "\n";
+	for (unsigned int j=1; j<ny; ++j)
+		file << NodeNumber(nx-1, j) << "\n";
+	for (unsigned int i=nx-1; i>0; --i)
+		file << NodeNumber(i-1, ny-1) << "\n";
+
+	bool written = !file.fail();
+	file.close();
+	return written;
+}
+
+
+/**
+ * @brief Writes the subdomain to full domain node mapping
+ * @param filePath The py.140 file
+ * @return true if the file was written
+ */
+bool MeshGenerator::WritePy140File(std::string filePath)
+{
+	std::ofstream file (filePath.data());
+	if (!file.is_open())
+		return false;
+
+	file << "new old " << GetNumNodes() << std::endl;
+	unsigned int newNumber = 1;
+	for (unsigned int j=subMinJ; j<=subMaxJ; ++j)
+		for (unsigned int i=subMinI; i<=subMaxI; ++i)
+			file << newNumber++ << " " << NodeNumber(i, j) << "\n";
+
+	bool written = !file.fail();
+	file.close();
+	return written;
+}
+
+
+/**
+ * @brief Writes a recording of the boundary conditions of the subdomain
+ *
+ * Writes a recording of the boundary conditions of the subdomain in the ASCII
+ * format of fort.066. Each timestep has a header line with the model time and
+ * iteration, and two lines for each recorded node: the node number with the water
+ * levels and node code, then the velocities. The values are a tide that travels
+ * across the mesh.
+ *
+ * @param filePath The fort.066 file
+ * @return true if the file was written
+ */
+bool MeshGenerator::WriteFort066File(std::string filePath)
+{
+	std::ofstream file (filePath.data());
+	if (!file.is_open())
+		return false;
+
+	std::vector<unsigned int> recordedNodes = FindRecordedNodes();
+	const double timestep = 2.0;
+	const unsigned int iterationsPerRecord = 30;
+	const double omega = 2.0*MESH_GENERATOR_PI / 44712.0;
+
+	file << "1 " << recordedNodes.size() << " " << numTimesteps << std::endl;
+	file << std::scientific << std::setprecision(8);
+	for (unsigned int ts=1; ts<=numTimesteps; ++ts)
+	{
+		double time = ts * iterationsPerRecord * timestep;
+		file << time << " " << ts*iterationsPerRecord << "\n";
+		for (std::vector<unsigned int>::iterator it = recordedNodes.begin(); it != recordedNodes.end(); ++it)
+		{
+			double phase = 0.001 * (*it % nx);
+			double eta = 0.5*sin(omega*time - phase);
+			double etaPrevious = 0.5*sin(omega*(time - timestep) - phase);
+			double u = 0.3*cos(omega*time - phase);
+			double v = 0.1*sin(omega*time + phase);
+			file << *it << " " << etaPrevious << " " << eta << " 1\n";
+			file << u << " " << v << "\n";
+		}
+	}
+
+	bool written = !file.fail();
+	file.close();
+	return written;
+}
+
+
+unsigned int MeshGenerator::GetNumNodes()
+{
+	return nx*ny;
+}
+
+
+unsigned int MeshGenerator::GetNumElements()
+{
+	return 2*(nx-1)*(ny-1);
+}
+
+
+unsigned int MeshGenerator::GetNumSubdomainNodes()
+{
+	return (subMaxI-subMinI+1)*(subMaxJ-subMinJ+1);
+}
+
+
+unsigned int MeshGenerator::GetNumRecordedNodes()
+{
+	return FindRecordedNodes().size();
+}
+
+
+/**
+ * @brief Returns a rectangle, in mesh coordinates, that holds most of the subdomain
+ *
+ * Returns a rectangle, in mesh coordinates, that holds most of the subdomain. The
+ * rectangle is drawn through the middle of the cells on the edge of the subdomain,
+ * since the nodes there have been moved.
+ *
+ * @param l Set to the left side
+ * @param r Set to the right side
+ * @param b Set to the bottom side
+ * @param t Set to the top side
+ */
+void MeshGenerator::GetSubdomainBounds(float &l, float &r, float &b, float &t)
+{
+	double width = MESH_GENERATOR_MAX_X - MESH_GENERATOR_MIN_X;
+	double height = MESH_GENERATOR_MAX_Y - MESH_GENERATOR_MIN_Y;
+	l = MESH_GENERATOR_MIN_X + width * GradeX((subMinI + 0.5) / (nx-1));
+	r = MESH_GENERATOR_MIN_X + width * GradeX((subMaxI - 0.5) / (nx-1));
+	b = MESH_GENERATOR_MIN_Y + height * GradeY((subMinJ + 0.5) / (ny-1));
+	t = MESH_GENERATOR_MIN_Y + height * GradeY((subMaxJ - 0.5) / (ny-1));
+}
+
+
+/**
+ * @brief Places the subdomain near the coast, at least two cells across
+ */
+void MeshGenerator::FindSubdomain()
+{
+	unsigned int cellsX = std::min(nx-1, std::max(2u, (unsigned int)((nx-1) * subdomainFraction)));
+	unsigned int cellsY = std::min(ny-1, std::max(2u, (unsigned int)((ny-1) * subdomainFraction)));
+	subMinI = std::min((unsigned int)((nx-1) * 0.6), nx-1-cellsX);
+	subMinJ = std::min((unsigned int)((ny-1) * 0.4), ny-1-cellsY);
+	subMaxI = subMinI + cellsX;
+	subMaxJ = subMinJ + cellsY;
+}
+
+
+/**
+ * @brief Mixes an index with the seed, the same for every call with the same seed
+ * @param index The node or cell index
+ * @param salt Separates the numbers used for different purposes
+ * @return 64 random bits
+ */
+unsigned long long MeshGenerator::Hash(unsigned long long index, unsigned int salt)
+{
+	unsigned long long value = seed * 0x9E3779B97F4A7C15ULL + index * 0xBF58476D1CE4E5B9ULL + salt * 0x94D049BB133111EBULL;
+	value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+	return value ^ (value >> 31);
+}
+
+
+/**
+ * @brief Returns a random number for an index, the same for every call with the same seed
+ * @param index The node or cell index
+ * @param salt Separates the numbers used for different purposes
+ * @return A number from 0 to 1
+ */
+double MeshGenerator::Random(unsigned int index, unsigned int salt)
+{
+	return (Hash(index, salt) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+
+/**
+ * @brief Maps an index onto its place in the shuffled numbering, or back
+ *
+ * Maps an index onto its place in the shuffled numbering, or back. The mapping is a
+ * four round Feistel network over the smallest square power of two that holds every
+ * index, and any result past the end of the range is mapped again until it falls
+ * inside it, which makes it a permutation of the range. Nothing is stored, so any
+ * index can be mapped in either direction at any time.
+ *
+ * @param index The index, from 0 to count-1
+ * @param count The number of indices
+ * @param salt Separates the node numbering from the element numbering
+ * @param inverse true to map a shuffled index back onto its grid index
+ * @return The mapped index, or index itself if the numbering is not shuffled
+ */
+unsigned int MeshGenerator::Permute(unsigned int index, unsigned int count, unsigned int salt, bool inverse)
+{
+	if (!shuffledNumbering || count < 2)
+		return index;
+
+	unsigned int halfBits = 1;
+	while ((1ULL << (2*halfBits)) < count)
+		++halfBits;
+	unsigned long long mask = (1ULL << halfBits) - 1;
+
+	unsigned long long value = index;
+	do
+	{
+		unsigned long long left = value >> halfBits;
+		unsigned long long right = value & mask;
+		for (unsigned int round=0; round<4; ++round)
+		{
+			if (!inverse)
+			{
+				unsigned long long newRight = left ^ (Hash(right, 8*salt + round) & mask);
+				left = right;
+				right = newRight;
+			} else {
+				unsigned long long newLeft = right ^ (Hash(left, 8*salt + 3 - round) & mask);
+				right = left;
+				left = newLeft;
+			}
+		}
+		value = (left << halfBits) | right;
+	} while (value >= count);
+
+	return value;
+}
+
+
+/**
+ * @brief Spaces the columns so the cells near the coast are about three times smaller than offshore
+ * @param u The position across the grid (0 to 1)
+ * @return The position across the mesh (0 to 1)
+ */
+double MeshGenerator::GradeX(double u)
+{
+	return u + 0.5 * sin(MESH_GENERATOR_PI * u) / MESH_GENERATOR_PI;
+}
+
+
+/**
+ * @brief Spaces the rows so the cells are smallest in the middle of the coast
+ * @param v The position up the grid (0 to 1)
+ * @return The position up the mesh (0 to 1)
+ */
+double MeshGenerator::GradeY(double v)
+{
+	return v + 0.3 * sin(2.0 * MESH_GENERATOR_PI * v) / (2.0 * MESH_GENERATOR_PI);
+}
+
+
+/**
+ * @brief Calculates the location and depth of a node
+ *
+ * Calculates the location and depth of a node. Interior nodes are moved by up to a
+ * fifth of the local spacing in each direction, which keeps every cell convex so
+ * either diagonal makes two valid triangles.
+ *
+ * @param i The column
+ * @param j The row
+ * @param x Set to the x-coordinate
+ * @param y Set to the y-coordinate
+ * @param z Set to the depth, positive below the geoid
+ */
+void MeshGenerator::FindNodePosition(unsigned int i, unsigned int j, double &x, double &y, double &z)
+{
+	double width = MESH_GENERATOR_MAX_X - MESH_GENERATOR_MIN_X;
+	double height = MESH_GENERATOR_MAX_Y - MESH_GENERATOR_MIN_Y;
+	double u = double(i) / (nx-1);
+	double v = double(j) / (ny-1);
+	double gradedU = GradeX(u);
+	double gradedV = GradeY(v);
+	x = MESH_GENERATOR_MIN_X + width * gradedU;
+	y = MESH_GENERATOR_MIN_Y + height * gradedV;
+
+	if (i > 0 && j > 0 && i+1 < nx && j+1 < ny)
+	{
+		unsigned int index = j*nx + i;
+		double spacingX = width * (1.0 - 0.5) / (nx-1);
+		double spacingY = height * (1.0 - 0.3) / (ny-1);
+		x += (Random(index, 1) - 0.5) * 0.4 * spacingX;
+		y += (Random(index, 2) - 0.5) * 0.4 * spacingY;
+	}
+
+	double offshore = 1.0 - gradedU;
+	z = 2.0 + 4500.0 * offshore * offshore + 25.0 * sin(7.0 * x) * cos(5.0 * y);
+}
+
+
+unsigned int MeshGenerator::NodeNumber(unsigned int i, unsigned int j)
+{
+	return Permute(j*nx + i, GetNumNodes(), MESH_GENERATOR_NODE_SALT, false) + 1;
+}
+
+
+/**
+ * @brief Finds the full domain numbers of the nodes on the edge of the subdomain
+ * @return The node numbers, sorted
+ */
+std::vector<unsigned int> MeshGenerator::FindRecordedNodes()
+{
+	std::vector<unsigned int> recordedNodes;
+	for (unsigned int j=subMinJ; j<=subMaxJ; ++j)
+		for (unsigned int i=subMinI; i<=subMaxI; ++i)
+			if (i == subMinI || i == subMaxI || j == subMinJ || j == subMaxJ)
+				recordedNodes.push_back(NodeNumber(i, j));
+	std::sort(recordedNodes.begin(), recordedNodes.end());
+	return recordedNodes;
+}
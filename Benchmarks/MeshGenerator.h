@@ -0,0 +1,99 @@
+#ifndef MESHGENERATOR_H
+#define MESHGENERATOR_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+#include <math.h>
+
+#define MESH_GENERATOR_MIN_X	-98.0	/**< West edge of the generated mesh (degrees) */
+#define MESH_GENERATOR_MAX_X	-60.0	/**< East edge, the coast, of the generated mesh (degrees) */
+#define MESH_GENERATOR_MIN_Y	8.0	/**< South edge of the generated mesh (degrees) */
+#define MESH_GENERATOR_MAX_Y	46.0	/**< North edge of the generated mesh (degrees) */
+#define MESH_GENERATOR_NODE_SALT	4	/**< Separates the random numbers of the node numbering */
+#define MESH_GENERATOR_ELEMENT_SALT	5	/**< Separates the random numbers of the element numbering */
+
+static const double MESH_GENERATOR_PI = 3.14159265358979323846;
+
+
+/**
+ * @brief Writes synthetic ADCIRC inputs of a given size for the benchmarks
+ *
+ * Writes synthetic ADCIRC inputs of a given size for the benchmarks: a full domain
+ * fort.14, the py.140 of a subdomain inside it, and a fort.066 that records the
+ * boundary of that subdomain. Everything is calculated from the node and cell
+ * indices as it is written, so meshes far larger than memory can be generated, and
+ * the same seed always gives the same files.
+ *
+ * The mesh is an irregular triangulation that looks like a coastal mesh to the code
+ * that reads it:
+ * - The nodes lie on a grid that is refined towards the coast on the east side and
+ *   towards the middle of the coast, so element sizes vary across the mesh
+ * - Every interior node is moved by a random fraction of the local spacing, and each
+ *   cell is split along a random diagonal, so no two neighbourhoods are alike
+ * - Depths increase away from the coast, and the west side is an open boundary
+ *   while the rest of the edge is a land boundary
+ *
+ * By default the nodes and elements are numbered row by row, which gives every
+ * Element nodes that are next to each other in the list. Real meshes are rarely
+ * numbered that well, so SetShuffledNumbering() numbers them in a random order
+ * instead. The lines are still written in the order of their numbers, as ADCIRC
+ * requires, but neighbouring nodes and elements end up far apart in memory. The
+ * numbering is a permutation of the grid indices that is calculated for each
+ * index, so shuffling needs no more memory than the ordered numbering.
+ *
+ * The subdomain is a block of cells near the coast. Its nodes are numbered in the
+ * row order of the grid, and the nodes on its edge are the ones recorded in
+ * fort.066.
+ *
+ */
+class MeshGenerator
+{
+	public:
+		MeshGenerator();
+
+		void	SetNumElements(unsigned int target);
+		void	SetSeed(unsigned int newSeed);
+		void	SetNumTimesteps(unsigned int newNumTimesteps);
+		void	SetSubdomainFraction(double fraction);
+		void	SetShuffledNumbering(bool shuffle);
+
+		bool	WriteFort14File(std::string filePath);
+		bool	WritePy140File(std::string filePath);
+		bool	WriteFort066File(std::string filePath);
+
+		unsigned int	GetNumNodes();
+		unsigned int	GetNumElements();
+		unsigned int	GetNumSubdomainNodes();
+		unsigned int	GetNumRecordedNodes();
+		void		GetSubdomainBounds(float &l, float &r, float &b, float &t);
+
+	private:
+
+		unsigned int	nx;		/**< Nodes in each row */
+		unsigned int	ny;		/**< Rows of nodes */
+		unsigned int	seed;
+		unsigned int	numTimesteps;
+		double		subdomainFraction;	/**< The width and height of the subdomain, as a fraction of the mesh */
+		bool		shuffledNumbering;	/**< Number the nodes and elements in a random order */
+
+		/* The subdomain, in node indices */
+		unsigned int	subMinI;
+		unsigned int	subMaxI;
+		unsigned int	subMinJ;
+		unsigned int	subMaxJ;
+
+		void		FindSubdomain();
+		unsigned long long	Hash(unsigned long long index, unsigned int salt);
+		double		Random(unsigned int index, unsigned int salt);
+		unsigned int	Permute(unsigned int index, unsigned int count, unsigned int salt, bool inverse);
+		double		GradeX(double u);
+		double		GradeY(double v);
+		void		FindNodePosition(unsigned int i, unsigned int j, double &x, double &y, double &z);
+		unsigned int	NodeNumber(unsigned int i, unsigned int j);
+		std::vector<unsigned int>	FindRecordedNodes();
+};
+
+#endif // MESHGENERATOR_H
@@ -0,0 +1,290 @@
+#include "QueryOracle.h"
+
+/* How a Node or Element lies relative to the shape being checked */
+#define ORACLE_OUTSIDE		0
+#define ORACLE_BORDERLINE	1
+#define ORACLE_INSIDE		2
+
+#define ORACLE_CIRCLE		0
+#define ORACLE_RECTANGLE	1
+#define ORACLE_POLYGON		2
+
+
+QueryOracle::QueryOracle(std::vector<Node> *newNodes, std::vector<Element> *newElements)
+{
+	nodes = newNodes;
+	elements = newElements;
+	numMissed = 0;
+	numExtra = 0;
+	numDuplicates = 0;
+	shapeType = ORACLE_CIRCLE;
+	for (int i=0; i<4; ++i)
+		shapeValues[i] = 0.0;
+}
+
+
+/**
+ * @brief Checks the result of Quadtree::FindNode()
+ * @param x The x-coordinate of the point
+ * @param y The y-coordinate of the point
+ * @param result The Node that was found
+ * @return true if no Node is closer to the point than the one found
+ */
+bool QueryOracle::CheckNode(float x, float y, Node *result)
+{
+	numMissed = numExtra = numDuplicates = 0;
+
+	double closestDistance = -1.0;
+	for (std::vector<Node>::iterator it = nodes->begin(); it != nodes->end(); ++it)
+	{
+		double distance = sqrt(pow(x - (double)it->normX, 2.0) + pow(y - (double)it->normY, 2.0));
+		if (closestDistance < 0.0 || distance < closestDistance)
+			closestDistance = distance;
+	}
+
+	if (!result)
+	{
+		numMissed = closestDistance < 0.0 ? 0 : 1;
+		return numMissed == 0;
+	}
+
+	double resultDistance = sqrt(pow(x - (double)result->normX, 2.0) + pow(y - (double)result->normY, 2.0));
+	if (resultDistance > closestDistance + QUERY_ORACLE_TOLERANCE)
+		numExtra = 1;
+	return numExtra == 0;
+}
+
+
+/**
+ * @brief Checks the result of Quadtree::FindElement()
+ * @param x The x-coordinate of the point
+ * @param y The y-coordinate of the point
+ * @param result The Element that was found, or 0
+ * @return true if the Element found contains the point, or no Element contains it
+ */
+bool QueryOracle::CheckElement(float x, float y, Element *result)
+{
+	numMissed = numExtra = numDuplicates = 0;
+
+	if (result)
+	{
+		if (DistanceInsideElement(result, x, y) < -QUERY_ORACLE_TOLERANCE)
+			numExtra = 1;
+		return numExtra == 0;
+	}
+
+	for (std::vector<Element>::iterator it = elements->begin(); it != elements->end(); ++it)
+	{
+		if (DistanceInsideElement(&*it, x, y) > QUERY_ORACLE_TOLERANCE)
+		{
+			numMissed = 1;
+			break;
+		}
+	}
+	return numMissed == 0;
+}
+
+
+/**
+ * @brief Checks the result of Quadtree::FindElementsInCircle()
+ * @param x The x-coordinate of the circle center
+ * @param y The y-coordinate of the circle center
+ * @param radius The radius of the circle
+ * @param result The Elements that were found
+ * @return true if the Elements found are the ones with a Node in the circle
+ */
+bool QueryOracle::CheckCircle(float x, float y, float radius, const std::vector<Element*> &result)
+{
+	shapeType = ORACLE_CIRCLE;
+	shapeValues[0] = x;
+	shapeValues[1] = y;
+	shapeValues[2] = radius;
+	return CheckSelection(result);
+}
+
+
+/**
+ * @brief Checks the result of Quadtree::FindElementsInRectangle()
+ * @param l The left side of the rectangle
+ * @param r The right side of the rectangle
+ * @param b The bottom of the rectangle
+ * @param t The top of the rectangle
+ * @param result The Elements that were found
+ * @return true if the Elements found are the ones with a Node in the rectangle
+ */
+bool QueryOracle::CheckRectangle(float l, float r, float b, float t, const std::vector<Element*> &result)
+{
+	shapeType = ORACLE_RECTANGLE;
+	shapeValues[0] = l;
+	shapeValues[1] = r;
+	shapeValues[2] = b;
+	shapeValues[3] = t;
+	return CheckSelection(result);
+}
+
+
+/**
+ * @brief Checks the result of Quadtree::FindElementsInPolygon()
+ * @param polygon The corners of the polygon, which is closed between the last and first
+ * @param result The Elements that were found
+ * @return true if the Elements found are the ones with a Node in the polygon
+ */
+bool QueryOracle::CheckPolygon(const std::vector<Point> &polygon, const std::vector<Element*> &result)
+{
+	shapeType = ORACLE_POLYGON;
+	shapePolygon = polygon;
+	return CheckSelection(result);
+}
+
+
+/**
+ * @brief Returns the number of Elements the last search should have found and did not
+ * @return The number of Elements, or 1 if FindNode() or FindElement() gave no result when it should have
+ */
+unsigned int QueryOracle::GetNumMissed()
+{
+	return numMissed;
+}
+
+
+/**
+ * @brief Returns the number of results of the last search that were wrong
+ * @return The number of Elements, or 1 if FindNode() or FindElement() gave the wrong result
+ */
+unsigned int QueryOracle::GetNumExtra()
+{
+	return numExtra;
+}
+
+
+/**
+ * @brief Returns the number of Elements the last search returned more than once
+ * @return The number of repeated results
+ */
+unsigned int QueryOracle::GetNumDuplicates()
+{
+	return numDuplicates;
+}
+
+
+bool QueryOracle::CheckSelection(const std::vector<Element*> &result)
+{
+	numMissed = numExtra = numDuplicates = 0;
+
+	std::set<unsigned int> found;
+	for (std::vector<Element*>::const_iterator it = result.begin(); it != result.end(); ++it)
+	{
+		if (!found.insert((*it)->elementNumber).second)
+			++numDuplicates;
+		else if (ClassifyElement(*it) == ORACLE_OUTSIDE)
+			++numExtra;
+	}
+
+	for (std::vector<Element>::iterator it = elements->begin(); it != elements->end(); ++it)
+		if (ClassifyElement(&*it) == ORACLE_INSIDE && found.count(it->elementNumber) == 0)
+			++numMissed;
+
+	return numMissed == 0 && numExtra == 0;
+}
+
+
+/**
+ * @brief Determines if a Node is inside of the shape being checked
+ * @param currNode The Node
+ * @return ORACLE_INSIDE, ORACLE_OUTSIDE, or ORACLE_BORDERLINE if it is within the tolerance of the edge
+ */
+int QueryOracle::ClassifyNode(Node *currNode)
+{
+	double x = currNode->normX;
+	double y = currNode->normY;
+	double distanceInside = 0.0;
+
+	if (shapeType == ORACLE_CIRCLE)
+	{
+		distanceInside = shapeValues[2] - sqrt(pow(x - shapeValues[0], 2.0) + pow(y - shapeValues[1], 2.0));
+	}
+	else if (shapeType == ORACLE_RECTANGLE)
+	{
+		distanceInside = std::min(std::min(x - shapeValues[0], shapeValues[1] - x),
+					  std::min(y - shapeValues[2], shapeValues[3] - y));
+	}
+	else
+	{
+		/* Ray casting for the side, and the closest edge for the distance */
+		bool inside = false;
+		double edgeDistance = -1.0;
+		for (unsigned int i=0, j=shapePolygon.size()-1; i<shapePolygon.size(); j = i++)
+		{
+			double xi = shapePolygon[i].x, yi = shapePolygon[i].y;
+			double xj = shapePolygon[j].x, yj = shapePolygon[j].y;
+			if (((yi > y) != (yj > y)) && (x < (xj-xi) * (y-yi) / (yj-yi) + xi))
+				inside = !inside;
+			double distance = DistanceToSegment(x, y, xi, yi, xj, yj);
+			if (edgeDistance < 0.0 || distance < edgeDistance)
+				edgeDistance = distance;
+		}
+		distanceInside = inside ? edgeDistance : -edgeDistance;
+	}
+
+	if (distanceInside > QUERY_ORACLE_TOLERANCE)
+		return ORACLE_INSIDE;
+	if (distanceInside < -QUERY_ORACLE_TOLERANCE)
+		return ORACLE_OUTSIDE;
+	return ORACLE_BORDERLINE;
+}
+
+
+/**
+ * @brief Determines if an Element is part of the selection of the shape being checked
+ * @param currElement The Element
+ * @return ORACLE_INSIDE if a Node is inside, ORACLE_OUTSIDE if every Node is outside, and
+ * ORACLE_BORDERLINE otherwise
+ */
+int QueryOracle::ClassifyElement(Element *currElement)
+{
+	int n1 = ClassifyNode(currElement->n1);
+	int n2 = ClassifyNode(currElement->n2);
+	int n3 = ClassifyNode(currElement->n3);
+	return std::max(n1, std::max(n2, n3));
+}
+
+
+/**
+ * @brief Calculates how far inside of an Element a point is
+ * @param currElement The Element
+ * @param x The x-coordinate of the point
+ * @param y The y-coordinate of the point
+ * @return The distance to the closest edge, negative if the point is outside
+ */
+double QueryOracle::DistanceInsideElement(Element *currElement, double x, double y)
+{
+	double px[3] = {currElement->n1->normX, currElement->n2->normX, currElement->n3->normX};
+	double py[3] = {currElement->n1->normY, currElement->n2->normY, currElement->n3->normY};
+	double area = (px[1]-px[0])*(py[2]-py[0]) - (px[2]-px[0])*(py[1]-py[0]);
+	if (area == 0.0)
+		return -1.0;
+
+	double distanceInside = 0.0;
+	for (int i=0; i<3; ++i)
+	{
+		int j = (i+1) % 3;
+		double length = sqrt(pow(px[j]-px[i], 2.0) + pow(py[j]-py[i], 2.0));
+		double side = ((px[j]-px[i])*(y-py[i]) - (x-px[i])*(py[j]-py[i])) / length;
+		if (area < 0.0)
+			side = -side;
+		if (i == 0 || side < distanceInside)
+			distanceInside = side;
+	}
+	return distanceInside;
+}
+
+
+double QueryOracle::DistanceToSegment(double x, double y, double ax, double ay, double bx, double by)
+{
+	double dx = bx - ax;
+	double dy = by - ay;
+	double lengthSquared = dx*dx + dy*dy;
+	double u = lengthSquared > 0.0 ? ((x-ax)*dx + (y-ay)*dy) / lengthSquared : 0.0;
+	u = std::max(0.0, std::min(1.0, u));
+	return sqrt(pow(x - (ax + u*dx), 2.0) + pow(y - (ay + u*dy), 2.0));
+}
@@ -0,0 +1,68 @@
+#ifndef QUERYORACLE_H
+#define QUERYORACLE_H
+
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <math.h>
+
+#include "adcData.h"
+
+#define QUERY_ORACLE_TOLERANCE	1.0e-5	/**< Distance, in normalized coordinates, within which either answer is accepted */
+
+
+/**
+ * @brief Checks the results of the Quadtree searches against a search of every Node and Element
+ *
+ * Checks the results of the Quadtree searches against a search of every Node and Element,
+ * in double precision, so the search tools can be benchmarked and verified at the same
+ * time. All coordinates are normalized, like those given to the Quadtree.
+ *
+ * The selections follow the rules of the search tools: an Element is in a circle,
+ * rectangle or polygon if any of its Nodes is. Nodes that are within the tolerance of
+ * the edge of a shape, and points that are within it of the edge of an Element, can go
+ * either way, since the Quadtree works in single precision.
+ *
+ * Each check sets the number of Elements the search missed, the number it returned
+ * that it should not have, and the number it returned more than once, which is allowed
+ * but is counted so it can be reported.
+ *
+ */
+class QueryOracle
+{
+	public:
+		QueryOracle(std::vector<Node> *newNodes, std::vector<Element> *newElements);
+
+		bool	CheckNode(float x, float y, Node *result);
+		bool	CheckElement(float x, float y, Element *result);
+		bool	CheckCircle(float x, float y, float radius, const std::vector<Element*> &result);
+		bool	CheckRectangle(float l, float r, float b, float t, const std::vector<Element*> &result);
+		bool	CheckPolygon(const std::vector<Point> &polygon, const std::vector<Element*> &result);
+
+		unsigned int	GetNumMissed();
+		unsigned int	GetNumExtra();
+		unsigned int	GetNumDuplicates();
+
+	private:
+
+		std::vector<Node>*	nodes;
+		std::vector<Element>*	elements;
+
+		/* Results of the last check */
+		unsigned int	numMissed;
+		unsigned int	numExtra;
+		unsigned int	numDuplicates;
+
+		/* The shape being checked */
+		int			shapeType;
+		double			shapeValues[4];
+		std::vector<Point>	shapePolygon;
+
+		bool	CheckSelection(const std::vector<Element*> &result);
+		int	ClassifyNode(Node *currNode);
+		int	ClassifyElement(Element *currElement);
+		double	DistanceInsideElement(Element *currElement, double x, double y);
+		double	DistanceToSegment(double x, double y, double ax, double ay, double bx, double by);
+};
+
+#endif // QUERYORACLE_H
@@ -0,0 +1,11 @@
+#include "Benchmarks/BenchmarkRunner.h"
+#include <QCoreApplication>
+
+// Main entry point of the benchmarks
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	BenchmarkRunner runner;
+	return runner.Run(a.arguments());
+}
@@ -0,0 +1,28 @@
+#-------------------------------------------------
+#
+# adcSubdomainTool-cli: the load, extract and carve operations without a display
+#
+#-------------------------------------------------
+
+QT       = core
+
+CONFIG += console
+CONFIG -= app_bundle
+
+TARGET = adcSubdomainTool-cli
+TEMPLATE = app
+
+CORE_BUILD_DIR = $$OUT_PWD/../Core
+include(../Core/Core.pri)
+include(../CommandLine/CommandLine.pri)
+
+
+SOURCES += main.cpp \
+    CliCommands.cpp
+
+HEADERS  += \
+    CliCommands.h
+
+target.path = /usr/local/bin
+
+INSTALLS += target
@@ -0,0 +1,517 @@
+#include "CliCommands.h"
+
+CliCommands::CliCommands(QObject *parent) :
+	CommandLineTool(parent)
+{
+
+}
+
+
+CliCommands::~CliCommands()
+{
+	stats.Finish();
+	if (statsFile.is_open())
+		statsFile.close();
+}
+
+
+/**
+ * @brief Runs the subcommand given on the command line
+ * @param arguments The command line, including the program name
+ * @return The exit code of the program
+ */
+int CliCommands::Run(QStringList arguments)
+{
+	if (arguments.size() > 0)
+		arguments.removeFirst();
+
+	QString statsPath = TakeValue(arguments, "--stats");
+	if (!statsPath.isEmpty())
+	{
+		statsFile.open(statsPath.toStdString().data(), std::ios::out | std::ios::app);
+		if (!statsFile.is_open())
+			return Error("Unable to open " + statsPath);
+		stats.SetOutput(&statsFile);
+	}
+
+	if (arguments.isEmpty())
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	QString command = arguments.takeFirst();
+	if (command == "inspect")
+		return Inspect(arguments);
+	else if (command == "cache")
+		return BuildCaches(arguments);
+	else if (command == "extract")
+		return ExtractSubdomains(arguments);
+	else if (command == "fort015")
+		return WriteFort015(arguments);
+	else if (command == "carve")
+		return CarveFort066(arguments);
+	else if (command == "verify")
+		return VerifySubdomain(arguments);
+	else if (command == "help" || command == "--help" || command == "-h")
+	{
+		PrintUsage();
+		return 0;
+	}
+
+	PrintUsage();
+	return Error("Unknown command " + command);
+}
+
+
+/**
+ * @brief Reads a mesh, builds its Quadtree and finds its boundaries
+ *
+ * inspect [--no-cache] [--bin-size <n>] <fort.14>
+ *
+ * @param args The arguments after the subcommand
+ * @return The exit code
+ */
+int CliCommands::Inspect(QStringList args)
+{
+	bool useCache = !TakeFlag(args, "--no-cache");
+	int binSize = TakeValue(args, "--bin-size", QString::number(CLI_DEFAULT_BIN_SIZE)).toInt();
+	if (HasUnknownOption(args) || args.size() != 1 || binSize <= 0)
+	{
+		PrintUsage();
+		return Error("inspect takes a single fort.14 file");
+	}
+
+	std::string infoLine;
+	std::vector<Node> nodes;
+	std::vector<Element> elements;
+	std::vector<unsigned int> boundaryNodes;
+	if (!LoadMesh(args[0], useCache, infoLine, nodes, elements, boundaryNodes))
+		return Error("Unable to read " + args[0]);
+
+	MeshNormalizer normalizer;
+	stats.Start("normalize");
+	normalizer.FindExtents(nodes);
+	normalizer.NormalizeNodes(nodes);
+	stats.AddValue("min_x", normalizer.GetMinX());
+	stats.AddValue("max_x", normalizer.GetMaxX());
+	stats.AddValue("min_y", normalizer.GetMinY());
+	stats.AddValue("max_y", normalizer.GetMaxY());
+	stats.AddValue("min_z", normalizer.GetMinZ());
+	stats.AddValue("max_z", normalizer.GetMaxZ());
+	stats.Finish();
+
+	stats.Start("quadtree");
+	Quadtree quadtree (nodes, elements, binSize, normalizer.GetNormalizedMinX(), normalizer.GetNormalizedMaxX(),
+			   normalizer.GetNormalizedMinY(), normalizer.GetNormalizedMaxY());
+	stats.AddValue("bin_size", binSize);
+	stats.Finish();
+
+	stats.Start("boundary");
+	BoundaryFinder boundaryFinder;
+	Boundaries boundaries = boundaryFinder.FindAllBoundaries(&elements);
+	stats.AddValue("inner_boundary_nodes", boundaries.innerBoundaryNodes.size());
+	stats.AddValue("outer_boundary_nodes", boundaries.outerBoundaryNodes.size());
+	stats.Finish();
+
+	return 0;
+}
+
+
+/**
+ * @brief Builds the binary caches of mesh and output files that are missing or out of date
+ *
+ * cache [--force] [--compress] <fort.14|fort.63|fort.64>...
+ *
+ * Files whose name ends in .14 get a Fort14Cache, and every other file is taken to be
+ * global output and gets a Fort63Cache.
+ *
+ * @param args The arguments after the subcommand
+ * @return The exit code
+ */
+int CliCommands::BuildCaches(QStringList args)
+{
+	bool force = TakeFlag(args, "--force");
+	bool compress = TakeFlag(args, "--compress");
+	if (HasUnknownOption(args) || args.size() == 0)
+	{
+		PrintUsage();
+		return Error("cache takes at least one file");
+	}
+
+	int failures = 0;
+	for (QStringList::iterator it = args.begin(); it != args.end(); ++it)
+	{
+		QString path = *it;
+		if (!QFileInfo(path).exists())
+		{
+			failures += Error("Unable to find " + path);
+			continue;
+		}
+
+		bool built = false, succeeded = true;
+		if (path.endsWith(".14"))
+		{
+			stats.Start("cache_fort14");
+			stats.AddValue("file", path.toStdString());
+			Fort14Cache cache (path);
+			if (force || !cache.CacheIsCurrent())
+			{
+				std::string infoLine;
+				std::vector<Node> nodes;
+				std::vector<Element> elements;
+				std::vector<unsigned int> boundaryNodes;
+				Fort14 fort14 (path.toStdString());
+				succeeded = fort14.ReadFile(infoLine, nodes, elements, boundaryNodes) &&
+					    cache.WriteCache(infoLine, nodes, elements, boundaryNodes);
+				built = true;
+				stats.AddValue("nodes", nodes.size());
+				stats.AddValue("elements", elements.size());
+			}
+		} else {
+			stats.Start("cache_fort63");
+			stats.AddValue("file", path.toStdString());
+			Fort63Cache cache (path);
+			cache.SetCompression(compress);
+			connect(&cache, SIGNAL(emitMessage(QString)), this, SLOT(printMessage(QString)));
+			if (force || !cache.CacheIsCurrent())
+			{
+				succeeded = cache.BuildCache();
+				built = true;
+			}
+		}
+		stats.AddValue("built", built ? 1 : 0);
+		stats.Finish();
+
+		if (!succeeded)
+			failures += Error("Unable to build the cache of " + path);
+	}
+
+	return failures > 0 ? 1 : 0;
+}
+
+
+/**
+ * @brief Creates a subdomain from each definition file
+ *
+ * extract [--output <dir>] [--bin-size <n>] [--no-cache] <fort.14> <definition>...
+ *
+ * Each subdomain is written to a directory named after its definition file (without
+ * the extension) in the output directory.
+ *
+ * @param args The arguments after the subcommand
+ * @return The exit code
+ */
+int CliCommands::ExtractSubdomains(QStringList args)
+{
+	QString outputPath = TakeValue(args, "--output", ".");
+	int binSize = TakeValue(args, "--bin-size", QString::number(CLI_DEFAULT_BIN_SIZE)).toInt();
+	bool useCache = !TakeFlag(args, "--no-cache");
+	if (HasUnknownOption(args) || args.size() < 2 || binSize <= 0)
+	{
+		PrintUsage();
+		return Error("extract takes a fort.14 file and at least one definition file");
+	}
+
+	QDir outputDir (outputPath);
+	if (!outputDir.exists() && !QDir().mkpath(outputPath))
+		return Error("Unable to create " + outputPath);
+
+	std::string infoLine;
+	std::vector<Node> nodes;
+	std::vector<Element> elements;
+	std::vector<unsigned int> boundaryNodes;
+	if (!LoadMesh(args[0], useCache, infoLine, nodes, elements, boundaryNodes))
+		return Error("Unable to read " + args[0]);
+
+	MeshNormalizer normalizer;
+	stats.Start("normalize");
+	normalizer.FindExtents(nodes);
+	normalizer.NormalizeNodes(nodes);
+	stats.Finish();
+
+	stats.Start("quadtree");
+	Quadtree quadtree (nodes, elements, binSize, normalizer.GetNormalizedMinX(), normalizer.GetNormalizedMaxX(),
+			   normalizer.GetNormalizedMinY(), normalizer.GetNormalizedMaxY());
+	stats.AddValue("bin_size", binSize);
+	stats.Finish();
+
+	int failures = 0;
+	for (int i=1; i<args.size(); ++i)
+	{
+		QString name = QFileInfo(args[i]).completeBaseName();
+
+		stats.Start("extract");
+		stats.AddValue("subdomain", name.toStdString());
+		SubdomainDefinition definition;
+		if (!definition.ReadFile(args[i].toStdString()))
+		{
+			stats.Finish();
+			failures += Error(QString::fromStdString(definition.GetErrorMessage()));
+			continue;
+		}
+
+		SubdomainExtractor extractor;
+		extractor.SetElements(definition.SelectElements(&quadtree, &normalizer));
+		extractor.SetFullDomainSize(nodes.size(), elements.size());
+		extractor.SetSubdomainName(name.toStdString());
+		extractor.Extract();
+		stats.AddValue("shapes", definition.GetNumShapes());
+		stats.AddValue("nodes", extractor.GetNumNodes());
+		stats.AddValue("elements", extractor.GetNumElements());
+		stats.AddValue("boundary_nodes", extractor.GetBoundaryNodes().size());
+		stats.Finish();
+
+		if (!extractor.HasSufficientElements() || !extractor.HasSufficientNodes() || !extractor.HasValidBoundary())
+		{
+			failures += Error("The subdomain " + name + " does not have enough elements or a valid boundary");
+			continue;
+		}
+
+		stats.Start("write");
+		stats.AddValue("subdomain", name.toStdString());
+		QString subdomainPath = outputDir.absoluteFilePath(name);
+		QDir subdomainDir (subdomainPath);
+		bool written = QDir().mkpath(subdomainPath) &&
+			       extractor.WriteFort14File(subdomainDir.absoluteFilePath("fort.14").toStdString()) &&
+			       extractor.WritePy140File(subdomainDir.absoluteFilePath("py.140").toStdString()) &&
+			       extractor.WritePy141File(subdomainDir.absoluteFilePath("py.141").toStdString());
+		stats.Finish();
+
+		if (!written)
+			failures += Error("Unable to write the files of the subdomain " + name + " to " + subdomainPath);
+	}
+
+	return failures > 0 ? 1 : 0;
+}
+
+
+/**
+ * @brief Writes the fort.015 files of a full domain and its subdomains
+ *
+ * fort015 [--approach <1|2>] [--frequency <n>] [--partitioned] <full domain dir> <subdomain dir>...
+ *
+ * With --partitioned, the full domain fort.015 is also split into the processor
+ * directories that adcprep created in the full domain directory.
+ *
+ * @param args The arguments after the subcommand
+ * @return The exit code
+ */
+int CliCommands::WriteFort015(QStringList args)
+{
+	int approach = TakeValue(args, "--approach", "2").toInt();
+	int frequency = TakeValue(args, "--frequency", "1").toInt();
+	bool partitioned = TakeFlag(args, "--partitioned");
+	if (HasUnknownOption(args) || args.size() < 2 || (approach != 1 && approach != 2) || frequency <= 0)
+	{
+		PrintUsage();
+		return Error("fort015 takes a full domain directory and at least one subdomain directory");
+	}
+
+	QString fullPath = QDir(args.takeFirst()).absolutePath();
+	std::vector<SubdomainFiles> subdomains = ListSubdomainFiles(args);
+
+	stats.Start("fort015_full");
+	stats.AddValue("subdomains", subdomains.size());
+	Fort015 fullFort015;
+	fullFort015.SetPath(fullPath);
+	fullFort015.SetSubdomains(subdomains);
+	fullFort015.SetApproach(approach);
+	fullFort015.SetRecordFrequency(frequency);
+	bool written = fullFort015.WriteFort015FullDomain();
+	stats.Finish();
+	if (!written)
+		return Error("Unable to find the boundaries of every subdomain or write " + fullPath + "/fort.015");
+
+	if (partitioned)
+	{
+		stats.Start("fort015_partitioned");
+		written = fullFort015.WriteFort015Partitioned();
+		stats.Finish();
+		if (!written)
+			return Error("Unable to write fort.015 into the processor directories of " + fullPath);
+	}
+
+	stats.Start("fort015_subdomains");
+	int failures = 0;
+	for (std::vector<SubdomainFiles>::iterator it = subdomains.begin(); it != subdomains.end(); ++it)
+	{
+		Fort015 subFort015;
+		subFort015.SetPath(it->domainPath);
+		subFort015.SetApproach(approach);
+		if (!subFort015.WriteFort015Subdomain())
+			failures += Error("Unable to write " + it->domainPath + "/fort.015");
+	}
+	stats.Finish();
+
+	return failures > 0 ? 1 : 0;
+}
+
+
+/**
+ * @brief Carves the full domain fort.066 into a fort.020 file for each subdomain
+ *
+ * carve [--binary] [--value-size <4|8>] [--record-interval <s> --output-interval <s>] <full domain dir> <subdomain dir>...
+ *
+ * @param args The arguments after the subcommand
+ * @return The exit code
+ */
+int CliCommands::CarveFort066(QStringList args)
+{
+	bool binary = TakeFlag(args, "--binary");
+	unsigned int valueSize = TakeValue(args, "--value-size", "8").toUInt();
+	double recordInterval = TakeValue(args, "--record-interval", "0").toDouble();
+	double outputInterval = TakeValue(args, "--output-interval", "0").toDouble();
+	if (HasUnknownOption(args) || args.size() < 2 || (valueSize != 4 && valueSize != 8) ||
+	    (outputInterval > 0.0 && recordInterval <= 0.0))
+	{
+		PrintUsage();
+		return Error("carve takes a full domain directory and at least one subdomain directory");
+	}
+
+	QString fort066Path = QDir(args.takeFirst()).absoluteFilePath("fort.066");
+	std::vector<SubdomainFiles> subdomains = ListSubdomainFiles(args);
+
+	stats.Start("carve");
+	stats.AddValue("subdomains", subdomains.size());
+	Fort066 carver (fort066Path);
+	connect(&carver, SIGNAL(emitMessage(QString)), this, SLOT(printMessage(QString)));
+	carver.SetSubdomains(subdomains);
+	carver.SetBinaryOutput(binary, valueSize);
+	carver.SetResampling(recordInterval, outputInterval);
+	carver.CarveAllSubdomains();
+	bool carved = carver.CarvedAllTimesteps();
+	stats.AddValue("carved_all", carved ? 1 : 0);
+	stats.Finish();
+
+	if (!carved)
+		return Error("Unable to carve every timestep of " + fort066Path);
+	return 0;
+}
+
+
+/**
+ * @brief Compares the output of a subdomain with the output of the full domain
+ *
+ * verify [--file <fort.63|fort.64>] [--output <file>] <full domain dir> <subdomain dir>
+ *
+ * The per-node differences are written next to the subdomain output, like the GUI
+ * does, unless another file is given.
+ *
+ * @param args The arguments after the subcommand
+ * @return The exit code
+ */
+int CliCommands::VerifySubdomain(QStringList args)
+{
+	QString fileName = TakeValue(args, "--file", "fort.63");
+	QString outputPath = TakeValue(args, "--output");
+	if (HasUnknownOption(args) || args.size() != 2)
+	{
+		PrintUsage();
+		return Error("verify takes a full domain directory and a subdomain directory");
+	}
+
+	QDir fullDir (args[0]);
+	QDir subDir (args[1]);
+	QString subLocation = subDir.absoluteFilePath(fileName);
+	if (outputPath.isEmpty())
+		outputPath = subLocation + ".diff";
+
+	stats.Start("verify");
+	stats.AddValue("file", fileName.toStdString());
+	SubdomainVerifier verifier (subLocation, fullDir.absoluteFilePath(fileName), subDir.absoluteFilePath("py.140"));
+	connect(&verifier, SIGNAL(emitMessage(QString)), this, SLOT(printMessage(QString)));
+	verifier.SetOutputPath(outputPath);
+	bool verified = verifier.Verify();
+	stats.AddValue("timesteps", verifier.GetNumMatchedTimesteps());
+	stats.AddValue("max_difference", verifier.GetMaxDifference());
+	stats.Finish();
+
+	if (!verified)
+		return Error("Unable to verify " + subLocation);
+	return 0;
+}
+
+
+/**
+ * @brief Reads a mesh from its cache if it is current, or from fort.14 otherwise
+ * @param fort14Path The fort.14 file
+ * @param useCache false to always read fort.14
+ * @param infoLine Set to the info line
+ * @param nodes Filled with every Node
+ * @param elements Filled with every Element
+ * @param boundaryNodes Filled with the boundary nodes
+ * @return true if the mesh was read
+ */
+bool CliCommands::LoadMesh(QString fort14Path, bool useCache, std::string &infoLine, std::vector<Node> &nodes,
+			   std::vector<Element> &elements, std::vector<unsigned int> &boundaryNodes)
+{
+	stats.Start("load");
+	stats.AddValue("file", fort14Path.toStdString());
+
+	bool loaded = false;
+	Fort14Cache cache (fort14Path);
+	if (useCache && cache.CacheIsCurrent())
+	{
+		loaded = cache.ReadCache(infoLine, nodes, elements, boundaryNodes);
+		stats.AddValue("source", std::string("cache"));
+	}
+	if (!loaded)
+	{
+		Fort14 fort14 (fort14Path.toStdString());
+		loaded = fort14.ReadFile(infoLine, nodes, elements, boundaryNodes);
+		stats.AddValue("source", std::string("fort.14"));
+	}
+
+	stats.AddValue("info", infoLine);
+	stats.AddValue("nodes", nodes.size());
+	stats.AddValue("elements", elements.size());
+	stats.AddValue("boundary_nodes", boundaryNodes.size());
+	stats.Finish();
+
+	return loaded && nodes.size() > 0 && elements.size() > 0;
+}
+
+
+/**
+ * @brief Describes the files of each subdomain directory
+ * @param directories The subdomain directories
+ * @return The files of each subdomain
+ */
+std::vector<SubdomainFiles> CliCommands::ListSubdomainFiles(QStringList directories)
+{
+	std::vector<SubdomainFiles> filesList;
+	for (QStringList::iterator it = directories.begin(); it != directories.end(); ++it)
+	{
+		QDir subDir (*it);
+		QString py141Location = subDir.absoluteFilePath("py.141");
+		filesList.push_back(SubdomainFiles(subDir.absolutePath(),
+						   subDir.absoluteFilePath("fort.14"),
+						   subDir.absoluteFilePath("py.140"),
+						   QFile(py141Location).exists() ? py141Location : QString()));
+	}
+	return filesList;
+}
+
+
+void CliCommands::PrintUsage()
+{
+	std::cerr << "Usage: adcSubdomainTool-cli [--stats <file>] <command> [options] <arguments>" << std::endl <<
+		     std::endl <<
+		     "Commands:" << std::endl <<
+		     "  inspect [--no-cache] [--bin-size <n>] <fort.14>" << std::endl <<
+		     "  cache [--force] [--compress] <fort.14|fort.63|fort.64>..." << std::endl <<
+		     "  extract [--output <dir>] [--bin-size <n>] [--no-cache] <fort.14> <definition>..." << std::endl <<
+		     "  fort015 [--approach <1|2>] [--frequency <n>] [--partitioned] <full domain dir> <subdomain dir>..." << std::endl <<
+		     "  carve [--binary] [--value-size <4|8>] [--record-interval <s> --output-interval <s>]" << std::endl <<
+		     "        <full domain dir> <subdomain dir>..." << std::endl <<
+		     "  verify [--file <fort.63|fort.64>] [--output <file>] <full domain dir> <subdomain dir>" << std::endl <<
+		     std::endl <<
+		     "A definition file has one shape per line, in mesh coordinates:" << std::endl <<
+		     "  circle <x> <y> <radius>" << std::endl <<
+		     "  rectangle <left> <right> <bottom> <top>" << std::endl <<
+		     "  polygon <x1> <y1> <x2> <y2> <x3> <y3> ..." << std::endl <<
+		     std::endl <<
+		     "Each stage writes a JSON line of timing and memory statistics to stdout, or to" << std::endl <<
+		     "the --stats file." << std::endl;
+}
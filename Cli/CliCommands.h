@@ -0,0 +1,82 @@
+#ifndef CLICOMMANDS_H
+#define CLICOMMANDS_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+
+#include <QString>
+#include <QStringList>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+
+#include "adcData.h"
+#include "CommandLine/CommandLineTool.h"
+#include "Quadtree/Quadtree.h"
+#include "Quadtree/MeshNormalizer.h"
+#include "SubdomainTools/BoundaryFinder.h"
+#include "SubdomainTools/SubdomainExtractor.h"
+#include "SubdomainTools/SubdomainDefinition.h"
+#include "Projects/IO/FileIO/SubdomainFiles.h"
+#include "Projects/IO/FileIO/Fort14.h"
+#include "Projects/IO/FileIO/Fort14Cache.h"
+#include "Projects/IO/FileIO/Fort63Cache.h"
+#include "Projects/IO/FileIO/Fort015.h"
+#include "Projects/IO/FileIO/Fort066.h"
+#include "Analysis/SubdomainVerifier.h"
+
+#define CLI_DEFAULT_BIN_SIZE	50
+
+
+/**
+ * @brief The subcommands of adcSubdomainTool-cli
+ *
+ * The subcommands of adcSubdomainTool-cli, which runs the load, extract and carve
+ * operations of the GUI on machines without a display:
+ *
+ * - inspect: reads a mesh and reports its size, extents and boundaries
+ * - cache: builds or refreshes the binary caches of fort.14, fort.63 and fort.64 files
+ * - extract: creates subdomains from definition files (see SubdomainDefinition)
+ * - fort015: writes the fort.015 files of the full domain and the subdomains
+ * - carve: carves fort.066 into a fort.020 file for each subdomain
+ * - verify: compares the output of a subdomain with the full domain
+ *
+ * Each stage of a command writes a line of timing and memory statistics (see
+ * StageStats) to stdout, or to the file given with --stats. Errors are written to
+ * stderr, and the exit code is 0 only if every step succeeded.
+ *
+ * Subdomains are given as directories holding fort.14, py.140 and py.141, which is
+ * how extract and the GUI write them.
+ *
+ */
+class CliCommands : public CommandLineTool
+{
+		Q_OBJECT
+	public:
+		CliCommands(QObject *parent=0);
+		~CliCommands();
+
+		int	Run(QStringList arguments);
+
+	private:
+
+		std::ofstream	statsFile;
+
+		/* Subcommands */
+		int	Inspect(QStringList args);
+		int	BuildCaches(QStringList args);
+		int	ExtractSubdomains(QStringList args);
+		int	WriteFort015(QStringList args);
+		int	CarveFort066(QStringList args);
+		int	VerifySubdomain(QStringList args);
+
+		/* Helpers */
+		bool				LoadMesh(QString fort14Path, bool useCache, std::string &infoLine, std::vector<Node> &nodes,
+							 std::vector<Element> &elements, std::vector<unsigned int> &boundaryNodes);
+		std::vector<SubdomainFiles>	ListSubdomainFiles(QStringList directories);
+		void				PrintUsage();
+};
+
+#endif // CLICOMMANDS_H
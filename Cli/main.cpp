@@ -0,0 +1,11 @@
+#include "Cli/CliCommands.h"
+#include <QCoreApplication>
+
+// Main entry point of the command line tool
+int main(int argc, char *argv[])
+{
+	QCoreApplication a(argc, argv);
+
+	CliCommands commands;
+	return commands.Run(a.arguments());
+}
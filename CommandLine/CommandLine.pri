@@ -0,0 +1,15 @@
+# The argument handling and stage statistics shared by the command line tools
+# (Cli/Cli.pro and Benchmarks/Benchmarks.pro)
+
+INCLUDEPATH += $$PWD/..
+DEPENDPATH += $$PWD/..
+
+win32: LIBS += -lpsapi
+
+SOURCES += \
+    $$PWD/CommandLineTool.cpp \
+    $$PWD/StageStats.cpp
+
+HEADERS  += \
+    $$PWD/CommandLineTool.h \
+    $$PWD/StageStats.h
@@ -0,0 +1,87 @@
+#include "CommandLineTool.h"
+
+CommandLineTool::CommandLineTool(QObject *parent) :
+	QObject(parent)
+{
+
+}
+
+
+CommandLineTool::~CommandLineTool()
+{
+
+}
+
+
+/**
+ * @brief Removes a flag from the arguments
+ * @param args The arguments
+ * @param name The flag, such as --keep
+ * @return true if the flag was given
+ */
+bool CommandLineTool::TakeFlag(QStringList &args, QString name)
+{
+	return args.removeAll(name) > 0;
+}
+
+
+/**
+ * @brief Removes an option and its value from the arguments
+ * @param args The arguments
+ * @param name The option, such as --output
+ * @param defaultValue The value if the option was not given
+ * @return The value of the option
+ */
+QString CommandLineTool::TakeValue(QStringList &args, QString name, QString defaultValue)
+{
+	int index = args.indexOf(name);
+	if (index < 0 || index+1 >= args.size())
+		return defaultValue;
+
+	QString value = args[index+1];
+	args.removeAt(index+1);
+	args.removeAt(index);
+	return value;
+}
+
+
+/**
+ * @brief Checks for options that are left over once the known ones have been taken
+ * @param args The arguments
+ * @return true if an option was not recognized
+ */
+bool CommandLineTool::HasUnknownOption(QStringList args)
+{
+	for (QStringList::iterator it = args.begin(); it != args.end(); ++it)
+	{
+		if (it->startsWith("--"))
+		{
+			Error("Unknown option " + *it);
+			return true;
+		}
+	}
+	return false;
+}
+
+
+/**
+ * @brief Writes an error to stderr
+ * @param message The error
+ * @return 1, so it can be returned as the exit code
+ */
+int CommandLineTool::Error(QString message)
+{
+	std::cerr << "ERROR: " << message.toStdString() << std::endl;
+	return 1;
+}
+
+
+/**
+ * @brief Writes a message from one of the readers or carvers to stderr, without its markup
+ * @param message The message
+ */
+void CommandLineTool::printMessage(QString message)
+{
+	message.remove(QRegExp("<[^>]*>"));
+	std::cerr << message.toStdString() << std::endl;
+}
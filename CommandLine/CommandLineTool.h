@@ -0,0 +1,48 @@
+#ifndef COMMANDLINETOOL_H
+#define COMMANDLINETOOL_H
+
+#include <iostream>
+
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <QRegExp>
+
+#include "CommandLine/StageStats.h"
+
+
+/**
+ * @brief The argument handling shared by the command line tools
+ *
+ * The argument handling shared by adcSubdomainTool-cli (see CliCommands) and
+ * adcSubdomainTool-bench (see BenchmarkRunner). Options are taken out of the
+ * argument list as they are read, so whatever is left starting with -- was not
+ * recognized. Errors and the messages of the readers and carvers go to stderr,
+ * and the stages are measured with a StageStats.
+ *
+ */
+class CommandLineTool : public QObject
+{
+		Q_OBJECT
+	public:
+		CommandLineTool(QObject *parent=0);
+		virtual ~CommandLineTool();
+
+		virtual int	Run(QStringList arguments) = 0;
+
+	protected:
+
+		StageStats	stats;
+
+		bool		TakeFlag(QStringList &args, QString name);
+		QString		TakeValue(QStringList &args, QString name, QString defaultValue="");
+		bool		HasUnknownOption(QStringList args);
+		int		Error(QString message);
+		virtual void	PrintUsage() = 0;
+
+	public slots:
+
+		void	printMessage(QString message);
+};
+
+#endif // COMMANDLINETOOL_H
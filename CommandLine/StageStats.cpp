@@ -0,0 +1,203 @@
+#include "StageStats.h"
+
+#if defined(Q_OS_WIN)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(Q_OS_UNIX)
+#include <fstream>
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+
+StageStats::StageStats()
+{
+	output = &std::cout;
+	cpuStart = 0;
+}
+
+
+/**
+ * @brief Sets the stream the stage lines are written to
+ * @param newOutput The stream, which must outlive the object, or 0 to write nothing
+ */
+void StageStats::SetOutput(std::ostream *newOutput)
+{
+	output = newOutput;
+}
+
+
+/**
+ * @brief Starts timing a stage
+ *
+ * Starts timing a stage. A stage that was started and not finished is finished first.
+ *
+ * @param stageName The name written as the stage
+ */
+void StageStats::Start(std::string stageName)
+{
+	if (!currentStage.empty())
+		Finish();
+
+	currentStage = stageName;
+	values.clear();
+	cpuStart = std::clock();
+	wallTimer.start();
+}
+
+
+/**
+ * @brief Adds a number to the line of the current stage
+ * @param key The key
+ * @param value The value
+ */
+void StageStats::AddValue(std::string key, double value)
+{
+	values.push_back(std::pair<std::string, std::string>(key, FormatNumber(value)));
+}
+
+
+/**
+ * @brief Adds a string to the line of the current stage
+ * @param key The key
+ * @param value The value
+ */
+void StageStats::AddValue(std::string key, std::string value)
+{
+	values.push_back(std::pair<std::string, std::string>(key, "\"" + Escape(value) + "\""));
+}
+
+
+/**
+ * @brief Finishes the current stage and writes its line
+ * @return What was measured, with an empty name if no stage was started
+ */
+StageResult StageStats::Finish()
+{
+	StageResult result;
+	result.wallSeconds = result.cpuSeconds = 0.0;
+	result.currentMemory = result.peakMemory = -1;
+	if (currentStage.empty())
+		return result;
+
+	result.name = currentStage;
+	result.wallSeconds = wallTimer.nsecsElapsed() / 1.0e9;
+	result.cpuSeconds = double(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+	result.currentMemory = GetCurrentMemory();
+	result.peakMemory = GetPeakMemory();
+	result.values = values;
+
+	if (output)
+		*output << ToJson(result) << std::endl;
+
+	currentStage = "";
+	values.clear();
+	return result;
+}
+
+
+/**
+ * @brief Returns the resident memory of the process
+ * @return The memory in bytes, or -1 if it cannot be measured
+ */
+qint64 StageStats::GetCurrentMemory()
+{
+#if defined(Q_OS_WIN)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.WorkingSetSize;
+	return -1;
+#elif defined(Q_OS_LINUX)
+	std::ifstream statm ("/proc/self/statm");
+	qint64 totalPages = 0, residentPages = 0;
+	if (statm >> totalPages >> residentPages)
+		return residentPages * sysconf(_SC_PAGESIZE);
+	return -1;
+#else
+	return -1;
+#endif
+}
+
+
+/**
+ * @brief Returns the largest resident memory of the process so far
+ * @return The memory in bytes, or -1 if it cannot be measured
+ */
+qint64 StageStats::GetPeakMemory()
+{
+#if defined(Q_OS_WIN)
+	PROCESS_MEMORY_COUNTERS counters;
+	if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+		return counters.PeakWorkingSetSize;
+	return -1;
+#elif defined(Q_OS_UNIX)
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return -1;
+#if defined(Q_OS_MAC)
+	return usage.ru_maxrss;
+#else
+	return qint64(usage.ru_maxrss) * 1024;
+#endif
+#else
+	return -1;
+#endif
+}
+
+
+/**
+ * @brief Formats the result of a stage as a single line JSON object
+ * @param result The result
+ * @return The JSON object
+ */
+std::string StageStats::ToJson(const StageResult &result)
+{
+	std::stringstream stream;
+	stream << "{\"stage\":\"" << Escape(result.name) << "\"" << std::fixed << std::setprecision(6) <<
+		  ",\"wall_s\":" << result.wallSeconds <<
+		  ",\"cpu_s\":" << result.cpuSeconds <<
+		  ",\"rss_bytes\":" << result.currentMemory <<
+		  ",\"peak_rss_bytes\":" << result.peakMemory;
+	for (std::vector<std::pair<std::string, std::string> >::const_iterator it = result.values.begin(); it != result.values.end(); ++it)
+		stream << ",\"" << Escape(it->first) << "\":" << it->second;
+	stream << "}";
+	return stream.str();
+}
+
+
+/**
+ * @brief Formats a number as a JSON value
+ * @param value The number
+ * @return The number, or null if it is not finite
+ */
+std::string StageStats::FormatNumber(double value)
+{
+	if (value != value || value > 1.0e300 || value < -1.0e300)
+		return "null";
+
+	std::stringstream stream;
+	stream << std::setprecision(12) << value;
+	return stream.str();
+}
+
+
+/**
+ * @brief Escapes a string to be written inside quotes in JSON
+ * @param value The string
+ * @return The escaped string
+ */
+std::string StageStats::Escape(std::string value)
+{
+	std::string escaped;
+	for (std::string::iterator it = value.begin(); it != value.end(); ++it)
+	{
+		if (*it == '"' || *it == '\\')
+			escaped += '\\';
+		if (*it == '\n')
+			escaped += "\\n";
+		else if (*it == '\t')
+			escaped += "\\t";
+		else if ((unsigned char)*it >= 0x20)
+			escaped += *it;
+	}
+	return escaped;
+}
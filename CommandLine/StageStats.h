@@ -0,0 +1,77 @@
+#ifndef STAGESTATS_H
+#define STAGESTATS_H
+
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <ctime>
+
+#include <QtGlobal>
+#include <QElapsedTimer>
+
+
+/**
+ * @brief The time and memory taken by a single stage
+ */
+struct StageResult
+{
+		std::string	name;
+		double		wallSeconds;
+		double		cpuSeconds;
+		qint64		currentMemory;	/**< Resident memory at the end of the stage, or -1 */
+		qint64		peakMemory;	/**< Largest resident memory so far, or -1 */
+		std::vector<std::pair<std::string, std::string> >	values;	/**< Extra keys and their JSON values */
+};
+
+
+/**
+ * @brief Measures the time and memory taken by each stage of a command line operation
+ *
+ * Measures the time and memory taken by each stage of a command line operation, and
+ * writes one JSON object per line for each stage, so the command line tool can be
+ * used as a benchmark driver as well as for batch work:
+ *
+ *     {"stage":"parse","wall_s":1.234,"cpu_s":1.198,"rss_bytes":52428800,"peak_rss_bytes":60817408,"nodes":100000}
+ *
+ * - wall_s is the elapsed time of the stage
+ * - cpu_s is the processor time used by the whole process during the stage, so it
+ *   is larger than wall_s when the TaskScheduler runs work in parallel
+ * - rss_bytes is the resident memory of the process at the end of the stage
+ * - peak_rss_bytes is the largest resident memory of the process so far
+ *
+ * Any other values added with AddValue() are written after these, for example the
+ * number of Nodes read. Values that cannot be measured on a platform are written
+ * as -1. Finish() also returns what it measured, so the benchmarks can collect the
+ * stages into a report.
+ *
+ */
+class StageStats
+{
+	public:
+		StageStats();
+
+		void	SetOutput(std::ostream *newOutput);
+
+		void	Start(std::string stageName);
+		void	AddValue(std::string key, double value);
+		void	AddValue(std::string key, std::string value);
+		StageResult	Finish();
+
+		static qint64		GetCurrentMemory();
+		static qint64		GetPeakMemory();
+		static std::string	ToJson(const StageResult &result);
+		static std::string	FormatNumber(double value);
+		static std::string	Escape(std::string value);
+
+	private:
+
+		std::ostream*	output;		/**< Where the stage lines are written, or 0 to only return them */
+		std::string	currentStage;
+		QElapsedTimer	wallTimer;
+		std::clock_t	cpuStart;
+		std::vector<std::pair<std::string, std::string> >	values;
+};
+
+#endif // STAGESTATS_H
@@ -0,0 +1,27 @@
+# Links a project against the core library built by Core/Core.pro
+#
+# CORE_BUILD_DIR is where Core.pro is built. It defaults to the Core directory of the
+# build directory of the including project, which is where the top level subdirs
+# project puts it. Projects built further down the tree set it before including this.
+
+INCLUDEPATH += $$PWD/..
+DEPENDPATH += $$PWD/..
+
+# The core reads netCDF output when the library is installed, so its users link it too
+CONFIG += link_pkgconfig
+packagesExist(netcdf) {
+    PKGCONFIG += netcdf
+    DEFINES += ADCIRC_NETCDF
+}
+
+isEmpty(CORE_BUILD_DIR): CORE_BUILD_DIR = $$OUT_PWD/Core
+
+win32:CONFIG(release, debug|release): CORE_LIB_DIR = $$CORE_BUILD_DIR/release
+else:win32:CONFIG(debug, debug|release): CORE_LIB_DIR = $$CORE_BUILD_DIR/debug
+else: CORE_LIB_DIR = $$CORE_BUILD_DIR
+
+LIBS += -L$$CORE_LIB_DIR -ladcSubdomainCore
+
+win32-g++: PRE_TARGETDEPS += $$CORE_LIB_DIR/libadcSubdomainCore.a
+else:win32: PRE_TARGETDEPS += $$CORE_LIB_DIR/adcSubdomainCore.lib
+else: PRE_TARGETDEPS += $$CORE_LIB_DIR/libadcSubdomainCore.a
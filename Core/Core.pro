@@ -0,0 +1,96 @@
+#-------------------------------------------------
+#
+# The mesh, spatial index and file I/O code, built as a static library that only
+# depends on QtCore. Used by the GUI and by tools that run without a display.
+#
+#-------------------------------------------------
+
+QT       = core
+
+# Lets the per-node reductions (output envelopes, etc.) be vectorized
+*-g++*|*-clang*: QMAKE_CXXFLAGS_RELEASE += -ftree-vectorize
+
+# netCDF output (fort.63.nc, fort.64.nc) is read when the netCDF library is installed
+CONFIG += link_pkgconfig
+packagesExist(netcdf) {
+    PKGCONFIG += netcdf
+    DEFINES += ADCIRC_NETCDF
+}
+
+TARGET = adcSubdomainCore
+TEMPLATE = lib
+CONFIG += staticlib
+
+INCLUDEPATH += ..
+
+
+SOURCES += \
+    ../Quadtree/Quadtree.cpp \
+    ../Quadtree/SearchTools/PolygonSearch.cpp \
+    ../Quadtree/SearchTools/CircleSearch.cpp \
+    ../Quadtree/SearchTools/RectangleSearch.cpp \
+    ../Quadtree/SearchTools/DepthSearch.cpp \
+    ../Quadtree/SearchTools/ClickSearch.cpp \
+    ../Quadtree/SearchTools/SampleSearch.cpp \
+    ../Quadtree/MeshNormalizer.cpp \
+    ../Tasks/TaskScheduler.cpp \
+    ../Tasks/TaskGroup.cpp \
+    ../Layers/Actions/ElementState.cpp \
+    ../SubdomainTools/BoundaryFinder.cpp \
+    ../SubdomainTools/SubdomainExtractor.cpp \
+    ../SubdomainTools/SubdomainDefinition.cpp \
+    ../SubdomainTools/BoundaryExtractionTask.cpp \
+    ../Projects/IO/FileIO/Fort14.cpp \
+    ../Projects/IO/FileIO/Fort14Cache.cpp \
+    ../Projects/IO/FileIO/Py140.cpp \
+    ../Projects/IO/FileIO/Py141.cpp \
+    ../Projects/IO/FileIO/Fort020.cpp \
+    ../Projects/IO/FileIO/BinaryBoundaryConditions.cpp \
+    ../Projects/IO/FileIO/BoundaryResampler.cpp \
+    ../Projects/IO/FileIO/Fort13.cpp \
+    ../Projects/IO/FileIO/Fort066.cpp \
+    ../Projects/IO/FileIO/Fort67.cpp \
+    ../Projects/IO/FileIO/Fort015.cpp \
+    ../Projects/IO/FileIO/Fort15.cpp \
+    ../Projects/IO/FileIO/BoundaryCache.cpp \
+    ../Projects/IO/FileIO/Fort63.cpp \
+    ../Projects/IO/FileIO/Fort63NetCDF.cpp \
+    ../Projects/IO/FileIO/Fort63Cache.cpp \
+    ../Analysis/SubdomainVerifier.cpp
+
+HEADERS  += \
+    ../adcData.h \
+    ../Quadtree/Quadtree.h \
+    ../Quadtree/QuadtreeData.h \
+    ../Quadtree/SearchTools/PolygonSearch.h \
+    ../Quadtree/SearchTools/CircleSearch.h \
+    ../Quadtree/SearchTools/RectangleSearch.h \
+    ../Quadtree/SearchTools/DepthSearch.h \
+    ../Quadtree/SearchTools/ClickSearch.h \
+    ../Quadtree/SearchTools/SampleSearch.h \
+    ../Quadtree/MeshNormalizer.h \
+    ../Tasks/TaskScheduler.h \
+    ../Tasks/TaskGroup.h \
+    ../Layers/Actions/ElementState.h \
+    ../SubdomainTools/BoundaryFinder.h \
+    ../SubdomainTools/SubdomainExtractor.h \
+    ../SubdomainTools/SubdomainDefinition.h \
+    ../SubdomainTools/BoundaryExtractionTask.h \
+    ../Projects/IO/FileIO/SubdomainFiles.h \
+    ../Projects/IO/FileIO/Fort14.h \
+    ../Projects/IO/FileIO/Fort14Cache.h \
+    ../Projects/IO/FileIO/Py140.h \
+    ../Projects/IO/FileIO/Py141.h \
+    ../Projects/IO/FileIO/Fort020.h \
+    ../Projects/IO/FileIO/BinaryBoundaryConditions.h \
+    ../Projects/IO/FileIO/BoundaryResampler.h \
+    ../Projects/IO/FileIO/Fort13.h \
+    ../Projects/IO/FileIO/Fort066.h \
+    ../Projects/IO/FileIO/Fort67.h \
+    ../Projects/IO/FileIO/Fort015.h \
+    ../Projects/IO/FileIO/Fort15.h \
+    ../Projects/IO/FileIO/BoundaryCache.h \
+    ../Projects/IO/FileIO/Fort63.h \
+    ../Projects/IO/FileIO/Fort63NetCDF.h \
+    ../Projects/IO/FileIO/Fort63Cache.h \
+    ../Analysis/SubdomainVerifier.h
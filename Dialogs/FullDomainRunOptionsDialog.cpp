@@ -12,6 +12,8 @@ FullDomainRunOptionsDialog::FullDomainRunOptionsDialog(QWidget *parent) :
 	ui->runEnvironmentGroup->setId(ui->runEnvironmentHere, 2);
 
 	connect(ui->chooseAdcircExecutableButton, SIGNAL(clicked()), this, SLOT(ChooseAdcircExecutableLocation()));
+	connect(ui->choosePadcircExecutableButton, SIGNAL(clicked()), this, SLOT(ChoosePadcircExecutableLocation()));
+	connect(ui->liveCarving, SIGNAL(toggled(bool)), ui->resampleInterval, SLOT(setEnabled(bool)));
 }
 
 FullDomainRunOptionsDialog::~FullDomainRunOptionsDialog()
@@ -26,12 +28,24 @@ void FullDomainRunOptionsDialog::SetAdcircExecutable(QString newPath)
 }
 
 
+void FullDomainRunOptionsDialog::SetPadcircExecutable(QString newPath)
+{
+	ui->padcircExecutable->setText(newPath);
+}
+
+
 QString FullDomainRunOptionsDialog::GetAdcircExecutableLocation()
 {
 	return ui->adcircExecutable->text();
 }
 
 
+QString FullDomainRunOptionsDialog::GetPadcircExecutableLocation()
+{
+	return ui->padcircExecutable->text();
+}
+
+
 int FullDomainRunOptionsDialog::GetSubdomainApproach()
 {
 	if (ui->subdomainMethodSpin->currentText() == "New Approach")
@@ -53,6 +67,32 @@ int FullDomainRunOptionsDialog::GetRunEnvironment()
 }
 
 
+bool FullDomainRunOptionsDialog::GetLiveCarving()
+{
+	return ui->liveCarving->isChecked();
+}
+
+
+/**
+ * @brief Returns the interval to resample the subdomain boundary conditions to
+ * @return The subdomain timestep in seconds, or 0 to keep the record frequency
+ */
+double FullDomainRunOptionsDialog::GetResampleInterval()
+{
+	return ui->resampleInterval->value();
+}
+
+
+/**
+ * @brief Returns the number of processors to run the full domain on
+ * @return 1 for a serial run, or more to partition the mesh with adcprep and run padcirc
+ */
+int FullDomainRunOptionsDialog::GetNumProcessors()
+{
+	return ui->numProcessors->value();
+}
+
+
 bool FullDomainRunOptionsDialog::ExecutableIsValid(QString execLocation)
 {
 	if (QFile(execLocation).exists())
@@ -76,3 +116,20 @@ void FullDomainRunOptionsDialog::ChooseAdcircExecutableLocation()
 		}
 	}
 }
+
+
+void FullDomainRunOptionsDialog::ChoosePadcircExecutableLocation()
+{
+	QFileDialog dlg (0, "Choose padcirc executable", QDir::homePath());
+	dlg.setModal(true);
+	dlg.setFileMode(QFileDialog::ExistingFile);
+
+	if (dlg.exec())
+	{
+		QString newLoc = dlg.selectedFiles().first();
+		if (ExecutableIsValid(newLoc))
+		{
+			ui->padcircExecutable->setText(newLoc);
+		}
+	}
+}
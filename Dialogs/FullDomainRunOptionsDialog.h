@@ -17,11 +17,16 @@ class FullDomainRunOptionsDialog : public QDialog
 		~FullDomainRunOptionsDialog();
 
 		void	SetAdcircExecutable(QString newPath);
+		void	SetPadcircExecutable(QString newPath);
 
 		QString	GetAdcircExecutableLocation();
+		QString	GetPadcircExecutableLocation();
 		int	GetSubdomainApproach();
 		int	GetRecordFrequency();
 		int	GetRunEnvironment();
+		bool	GetLiveCarving();
+		double	GetResampleInterval();
+		int	GetNumProcessors();
 
 		
 	private:
@@ -32,6 +37,7 @@ class FullDomainRunOptionsDialog : public QDialog
 	private slots:
 
 		void	ChooseAdcircExecutableLocation();
+		void	ChoosePadcircExecutableLocation();
 };
 
 #endif // FULLDOMAINRUNOPTIONSDIALOG_H
@@ -8,6 +8,7 @@ ProjectSettingsDialog::ProjectSettingsDialog(QWidget *parent) :
 	ui->setupUi(this);
 
 	connect(ui->chooseAdcircExecutableButton, SIGNAL(clicked()), this, SLOT(ChooseAdcircExecutableLocation()));
+	connect(ui->choosePadcircExecutableButton, SIGNAL(clicked()), this, SLOT(ChoosePadcircExecutableLocation()));
 }
 
 ProjectSettingsDialog::~ProjectSettingsDialog()
@@ -22,12 +23,24 @@ void ProjectSettingsDialog::SetAdcircExecutableLocation(const QString &currentLo
 }
 
 
+void ProjectSettingsDialog::SetPadcircExecutableLocation(const QString &currentLoc)
+{
+	ui->padcircExecutableLine->setText(currentLoc);
+}
+
+
 QString ProjectSettingsDialog::GetAdcircExecutableLocation()
 {
 	return ui->adcircExecutableLine->text();
 }
 
 
+QString ProjectSettingsDialog::GetPadcircExecutableLocation()
+{
+	return ui->padcircExecutableLine->text();
+}
+
+
 bool ProjectSettingsDialog::ExecutableIsValid(QString execLocation)
 {
 	if (QFile(execLocation).exists())
@@ -51,3 +64,20 @@ void ProjectSettingsDialog::ChooseAdcircExecutableLocation()
 		}
 	}
 }
+
+
+void ProjectSettingsDialog::ChoosePadcircExecutableLocation()
+{
+	QFileDialog dlg (0, "Choose padcirc executable", QDir::homePath());
+	dlg.setModal(true);
+	dlg.setFileMode(QFileDialog::ExistingFile);
+
+	if (dlg.exec())
+	{
+		QString newLoc = dlg.selectedFiles().first();
+		if (ExecutableIsValid(newLoc))
+		{
+			ui->padcircExecutableLine->setText(newLoc);
+		}
+	}
+}
@@ -18,8 +18,10 @@ class ProjectSettingsDialog : public QDialog
 		~ProjectSettingsDialog();
 
 		void	SetAdcircExecutableLocation(const QString &currentLoc);
+		void	SetPadcircExecutableLocation(const QString &currentLoc);
 
 		QString		GetAdcircExecutableLocation();
+		QString		GetPadcircExecutableLocation();
 		
 	private:
 
@@ -30,6 +32,7 @@ class ProjectSettingsDialog : public QDialog
 	private slots:
 
 		void	ChooseAdcircExecutableLocation();
+		void	ChoosePadcircExecutableLocation();
 };
 
 #endif // PROJECTSETTINGSDIALOG_H
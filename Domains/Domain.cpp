@@ -4,7 +4,7 @@
  * Constructor that initializes necessary initial class members and hooks up initial signals/slots
  *
  * Every new domain is created with a number of members already initialized. These include a GLCamera object,
- * a SelectionLayer object, a QThread on which to perform all file reading operations, and all of the following tools:
+ * a SelectionLayer object, and all of the following tools:
  * - CircleTool
  *
  * All signals from member objects that have been created are connected to the appropriate signals that are emitted by
@@ -19,11 +19,33 @@ Domain::Domain()
 	camera = new GLCamera();
 
 	terrainLayer = 0;
+	velocityLayer = 0;
 	selectionLayer = new CreationSelectionLayer();
 
-	layerThread = new QThread();
 	progressBar = 0;
 	loadingLayer = 0;
+	loading = false;
+	loadQueued = false;
+
+	prefetchThread = 0;
+	prefetcher = 0;
+	animationTimer = new QTimer(this);
+	animationTimer->setInterval(ANIMATION_FRAME_INTERVAL);
+	animationTimestep = 1;
+	animationRangeSet = false;
+
+	velocityThread = 0;
+	velocityPrefetcher = 0;
+	velocityTimestep = 1;
+
+	timeSeriesExtractor = 0;
+	fort63CacheBuilder = 0;
+
+	envelopeCalculator = 0;
+	envelopeVelocity = false;
+	visibleOverlay = NoOverlay;
+
+	verifier = 0;
 
 	currentMode = DisplayAction;
 	oldx = oldy = newx = newy = dx = dy = 0;
@@ -37,6 +59,8 @@ Domain::Domain()
 	fort64Location = "";
 	bnListLocation = "";
 	py140Location = "";
+	py141Location = "";
+	sourceDomain = 0;
 
 
 
@@ -44,13 +68,6 @@ Domain::Domain()
 	if (selectionLayer && camera)
 		selectionLayer->SetCamera(camera);
 
-	if (layerThread)
-	{
-		connect(this, SIGNAL(BeingDestroyed()), layerThread, SLOT(quit()));
-		connect(layerThread, SIGNAL(finished()), layerThread, SLOT(deleteLater()));
-		layerThread->start();
-	}
-
 	/* Pass signals up from the selection layer */
 	connect(selectionLayer, SIGNAL(Message(QString)), this, SIGNAL(Message(QString)));
 	connect(selectionLayer, SIGNAL(Instructions(QString)), this, SIGNAL(Instructions(QString)));
@@ -63,6 +80,12 @@ Domain::Domain()
 	connect(selectionLayer, SIGNAL(ToolFinishedDrawing()), this, SIGNAL(ToolFinishedDrawing()));
 
 	connect(selectionLayer, SIGNAL(ToolFinishedDrawing()), this, SLOT(EnterDisplayMode()));
+	connect(animationTimer, SIGNAL(timeout()), this, SLOT(ShowNextTimestep()));
+
+	connect(&timeSeriesTasks, SIGNAL(finished()), this, SLOT(TimeSeriesFinished()));
+	connect(&fort63CacheTasks, SIGNAL(finished()), this, SLOT(Fort63CacheFinished()));
+	connect(&envelopeTasks, SIGNAL(finished()), this, SLOT(EnvelopeFinished()));
+	connect(&verifierTasks, SIGNAL(finished()), this, SLOT(VerificationFinished()));
 
 }
 
@@ -76,8 +99,36 @@ Domain::Domain()
  */
 Domain::~Domain()
 {
+	StopFort63Animation();
+	StopFort64Animation();
+	if (fort63CacheBuilder)
+	{
+		fort63CacheTasks.Cancel();
+		fort63CacheTasks.Wait();
+		delete fort63CacheBuilder;
+	}
+	if (timeSeriesExtractor)
+	{
+		timeSeriesTasks.Cancel();
+		timeSeriesTasks.Wait();
+		delete timeSeriesExtractor;
+	}
+	if (envelopeCalculator)
+	{
+		envelopeTasks.Cancel();
+		envelopeTasks.Wait();
+		delete envelopeCalculator;
+	}
+	if (verifier)
+	{
+		verifierTasks.Cancel();
+		verifierTasks.Wait();
+		delete verifier;
+	}
 	if (selectionLayer)
 		delete selectionLayer;
+	if (velocityLayer)
+		delete velocityLayer;
 	if (terrainLayer)
 		delete terrainLayer;
 	if (camera)
@@ -96,12 +147,14 @@ void Domain::Draw()
 {
 	if (terrainLayer)
 	{
-		if (!terrainLayer->DataLoaded() && !fort14Location.isEmpty())
+		if (!terrainLayer->DataLoaded() && !loadQueued)
 		{
-			LoadFort14File();
+			LoadData();
 		}
 		terrainLayer->Draw();
 	}
+	if (velocityLayer && velocityPrefetcher)
+		velocityLayer->Draw();
 	if (selectionLayer)
 		selectionLayer->Draw();
 }
@@ -154,6 +207,7 @@ void Domain::MouseMove(QMouseEvent *event)
 
 void Domain::MouseRelease(QMouseEvent *event)
 {
+	bool dragged = mouseMoved;
 	clicking = false;
 	mouseMoved = false;
 
@@ -164,6 +218,11 @@ void Domain::MouseRelease(QMouseEvent *event)
 	{
 		selectionLayer->MouseRelease(event);
 	}
+	else if (currentMode == TimeSeriesAction && !dragged && pushedButton == Qt::LeftButton)
+	{
+		ExtractTimeSeries(oldx, oldy);
+		EnterDisplayMode();
+	}
 
 	emit UpdateGL();
 }
@@ -205,6 +264,9 @@ void Domain::SetWindowSize(float w, float h)
 	if (camera)
 		camera->SetWindowSize(-1.0*w/h, 1.0*w/h, -1.0, 1.0, -1000.0, 1000.0);
 
+	if (velocityLayer)
+		velocityLayer->ViewChanged();
+
 	if (selectionLayer)
 		selectionLayer->WindowSizeChanged(w, h);
 }
@@ -219,6 +281,21 @@ void Domain::UseTool(ToolType tool, SelectionType selection)
 }
 
 
+/**
+ * @brief Lets the user click a point to plot its fort.63 time series
+ *
+ * Lets the user click a point to plot its fort.63 time series. The Domain goes
+ * back to display mode after the click.
+ *
+ */
+void Domain::UseTimeSeriesTool()
+{
+	currentMode = TimeSeriesAction;
+	emit SetCursor(Qt::CrossCursor);
+	emit Instructions("Click a point in the domain to plot its fort.63 time series");
+}
+
+
 /**
  * @brief Undoes the last selection action performed by the user
  *
@@ -303,12 +380,14 @@ void Domain::SetFort15Location(QString newLoc)
 /**
  * @brief Sets the fort.63 file location
  *
- * <b>Not yet implemented</b>
+ * Sets the fort.63 file location used for playback. Any playback that is
+ * running is stopped.
  *
  * @param newLoc The fort.63 file location
  */
 void Domain::SetFort63Location(QString newLoc)
 {
+	StopFort63Animation();
 	fort63Location = newLoc;
 }
 
@@ -316,12 +395,14 @@ void Domain::SetFort63Location(QString newLoc)
 /**
  * @brief Sets the fort.64 file location
  *
- * <b>Not yet implemented</b>
+ * Sets the fort.64 file location used for velocity playback. Any velocity
+ * playback that is running is stopped.
  *
  * @param newLoc The fort.64 file location
  */
 void Domain::SetFort64Location(QString newLoc)
 {
+	StopFort64Animation();
 	fort64Location = newLoc;
 }
 
@@ -338,6 +419,116 @@ void Domain::SetPy140Location(QString newLoc)
 }
 
 
+void Domain::SetPy141Location(QString newLoc)
+{
+	py141Location = newLoc;
+}
+
+
+/**
+ * @brief Sets the full domain that this subdomain's mesh can be derived from
+ *
+ * Sets the full domain that this subdomain's mesh can be derived from. If the full
+ * domain has been loaded, or is being loaded, when this subdomain is read, the
+ * subdomain's Nodes and Elements are gathered from it through py.140 and py.141
+ * instead of reading the subdomain fort.14 file.
+ *
+ * @param newSource The full domain
+ */
+void Domain::SetSourceDomain(Domain *newSource)
+{
+	sourceDomain = newSource;
+}
+
+
+/**
+ * @brief Sets whether a DomainLoader will start reading the mesh
+ *
+ * Sets whether a DomainLoader will start reading the mesh. While the read is
+ * queued, drawing the Domain does not start it.
+ *
+ * @param queued true if the read is queued
+ */
+void Domain::SetLoadQueued(bool queued)
+{
+	loadQueued = queued;
+}
+
+
+/**
+ * @brief Starts reading the mesh on the TaskScheduler
+ *
+ * Starts reading the mesh on the TaskScheduler, if it has not already been read and
+ * is not being read. LoadProgress() and LoadFinished() report how the read goes.
+ *
+ * @param priority The TASK_PRIORITY_ of the read. A domain that is being drawn is
+ * read at high priority.
+ * @return true if a read was started
+ */
+bool Domain::LoadData(int priority)
+{
+	loadQueued = false;
+	if (loading || IsLoaded() || fort14Location.isEmpty() || !QFile(fort14Location).exists())
+		return false;
+
+	loading = true;
+	CreateTerrainLayer();
+	terrainLayer->SetReadPriority(priority);
+	LoadFort14File();
+	return true;
+}
+
+
+bool Domain::IsLoaded()
+{
+	return terrainLayer && terrainLayer->DataLoaded();
+}
+
+
+bool Domain::IsLoading()
+{
+	return loading;
+}
+
+
+/**
+ * @brief Frees the mesh and everything drawn from it to save memory
+ *
+ * Frees the mesh and everything drawn from it to save memory. The domain keeps
+ * its file locations, colors and camera, and reads the mesh again the next time
+ * LoadData() is called. Any fort.63 or fort.64 playback is stopped, and the
+ * selection history is dropped, since it points into the mesh.
+ *
+ * A domain that is loading, has elements selected, or has a time series, envelope
+ * or verification running on its mesh is left alone.
+ *
+ * @return true if the mesh was freed
+ */
+bool Domain::Unload()
+{
+	if (loading || !IsLoaded() || terrainLayer->IsReading())
+		return false;
+	if (timeSeriesTasks.IsRunning() || envelopeTasks.IsRunning() || verifierTasks.IsRunning())
+		return false;
+	if (GetNumElementsSelected() > 0)
+		return false;
+
+	StopFort63Animation();
+	StopFort64Animation();
+	if (velocityLayer)
+	{
+		delete velocityLayer;
+		velocityLayer = 0;
+	}
+	visibleOverlay = NoOverlay;
+
+	if (selectionLayer)
+		selectionLayer->ClearSelection();
+	terrainLayer->UnloadData();
+	return true;
+}
+
+
 /**
  * @brief Sets the properties used to draw a solid outline in the terrain layer
  *
@@ -477,6 +668,28 @@ QString Domain::GetPy140Location()
 }
 
 
+QString Domain::GetPy141Location()
+{
+	return py141Location;
+}
+
+
+/**
+ * @brief Returns the locations the file carvers need to write files for this subdomain
+ * @return The subdomain directory and its fort.14, py.140 and py.141 locations
+ */
+SubdomainFiles Domain::GetSubdomainFiles()
+{
+	return SubdomainFiles(domainPath, fort14Location, py140Location, py141Location);
+}
+
+
+Domain* Domain::GetSourceDomain()
+{
+	return sourceDomain;
+}
+
+
 std::vector<Element>* Domain::GetAllElements()
 {
 	return terrainLayer->GetAllElements();
@@ -657,6 +870,30 @@ unsigned int Domain::GetNumElementsSelected()
 }
 
 
+/**
+ * @brief Returns the estimated memory used by the mesh of this domain
+ * @return The memory in bytes, or 0 if the mesh is not loaded
+ */
+qint64 Domain::GetMemoryUsage()
+{
+	if (terrainLayer)
+		return terrainLayer->GetMemoryUsage();
+	return 0;
+}
+
+
+/**
+ * @brief Returns the memory used by the mesh of this domain on the GPU
+ * @return The memory in bytes, or 0 if the mesh has not been sent to the GPU
+ */
+qint64 Domain::GetGPUMemoryUsage()
+{
+	if (terrainLayer)
+		return terrainLayer->GetGPUMemoryUsage();
+	return 0;
+}
+
+
 GLCamera* Domain::GetCamera()
 {
 	return camera;
@@ -680,12 +917,469 @@ void Domain::ToggleTerrainQuadtree()
 }
 
 
+/**
+ * @brief Starts playing back the water elevation in fort.63 over the terrain
+ *
+ * Starts playing back the water elevation in fort.63 over the terrain. Timesteps
+ * are read ahead of playback on a separate thread by a TimestepPrefetcher, and
+ * a new timestep is shown every ANIMATION_FRAME_INTERVAL ms once the timestep
+ * index has been built. Only one float per node is sent to the GPU for each
+ * timestep. If a timestep has not been read in time, the current one stays on
+ * screen and the timestep is tried again on the next frame.
+ *
+ * If no fort.63 location has been set, fort.63 in the domain directory is used.
+ *
+ * @return true if playback was started
+ */
+bool Domain::StartFort63Animation()
+{
+	if (prefetcher)
+		return true;
+
+	if (!terrainLayer || !terrainLayer->DataLoaded())
+		return false;
+
+	QString fileLocation = FindFort63File();
+	if (!QFile(fileLocation).exists())
+	{
+		emit EmitMessage(QString("<p style='color:red'><strong>Error:</strong> fort.63 file not found at ").append(fileLocation).append("</p>"));
+		return false;
+	}
+
+	prefetchThread = new QThread();
+	prefetcher = new TimestepPrefetcher(fileLocation);
+	prefetcher->moveToThread(prefetchThread);
+	animationTimestep = 1;
+	animationRangeSet = false;
+	visibleOverlay = NoOverlay;
+
+	connect(prefetchThread, SIGNAL(started()), prefetcher, SLOT(prefetch()));
+	connect(prefetcher, SIGNAL(indexBuilt(int)), this, SLOT(Fort63Indexed(int)));
+	connect(prefetcher, SIGNAL(finishedPrefetching()), prefetchThread, SLOT(quit()));
+	connect(prefetchThread, SIGNAL(finished()), prefetcher, SLOT(deleteLater()));
+	connect(prefetchThread, SIGNAL(finished()), prefetchThread, SLOT(deleteLater()));
+
+	prefetchThread->start();
+	emit EmitMessage(QString("Indexing ").append(fileLocation));
+	return true;
+}
+
+
+/**
+ * @brief Stops fort.63 playback and goes back to drawing the terrain
+ *
+ * Stops fort.63 playback and goes back to drawing the terrain. The prefetch thread
+ * finishes its current read and then cleans itself up.
+ *
+ */
+void Domain::StopFort63Animation()
+{
+	if (animationTimer && !velocityPrefetcher)
+		animationTimer->stop();
+
+	if (prefetcher)
+	{
+		disconnect(prefetcher, SIGNAL(indexBuilt(int)), this, SLOT(Fort63Indexed(int)));
+		prefetcher->Stop();
+		prefetcher = 0;
+		prefetchThread = 0;
+
+		if (terrainLayer)
+		{
+			terrainLayer->HideNodalValues();
+			emit UpdateGL();
+		}
+	}
+}
+
+
+/**
+ * @brief Returns the fort.63 file used for playback and time series
+ *
+ * Returns the fort.63 file used for playback and time series. If no fort.63 location
+ * has been set, fort.63 in the domain directory is used, or fort.63.nc if the run
+ * wrote netCDF output.
+ *
+ * @return The fort.63 file location
+ */
+QString Domain::FindFort63File()
+{
+	if (!fort63Location.isEmpty())
+		return fort63Location;
+
+	QString asciiLocation = domainPath + QDir::separator() + "fort.63";
+	QString netcdfLocation = asciiLocation + ".nc";
+	if (!QFile(asciiLocation).exists() && QFile(netcdfLocation).exists())
+		return netcdfLocation;
+	return asciiLocation;
+}
+
+
+/**
+ * @brief Starts extracting the fort.63 time series at a point on the screen
+ *
+ * Starts extracting the fort.63 time series at a point on the screen. The point is
+ * located in the quadtree, and the series is interpolated from the three nodes of
+ * the Element that contains it by a task on the TaskScheduler. TimeSeriesExtracted() is
+ * emitted when the series is ready. If the fort.63 binary cache has not been built,
+ * it is built first and the extraction waits for it, so fort.63 is only parsed once
+ * and every later click reads from the cache.
+ *
+ * @param x The x-coordinate of the point (pixels)
+ * @param y The y-coordinate of the point (pixels)
+ */
+void Domain::ExtractTimeSeries(int x, int y)
+{
+	if (timeSeriesExtractor || !terrainLayer || !camera)
+		return;
+
+	QString fileLocation = FindFort63File();
+	if (!QFile(fileLocation).exists())
+	{
+		emit EmitMessage(QString("<p style='color:red'><strong>Error:</strong> fort.63 file not found at ").append(fileLocation).append("</p>"));
+		return;
+	}
+
+	float glX, glY;
+	camera->GetUnprojectedPoint(x, y, &glX, &glY);
+	Element *element = terrainLayer->GetElement(glX, glY);
+
+	PointTimeSeries *newExtractor = new PointTimeSeries(fileLocation);
+	if (!newExtractor->SetLocation(element, glX, glY))
+	{
+		emit Instructions("The point is not inside the domain");
+		delete newExtractor;
+		return;
+	}
+
+	timeSeriesExtractor = newExtractor;
+	connect(timeSeriesExtractor, SIGNAL(emitMessage(QString)), this, SIGNAL(EmitMessage(QString)));
+	if (progressBar)
+	{
+		connect(timeSeriesExtractor, SIGNAL(startedExtracting()), progressBar, SLOT(show()));
+		connect(timeSeriesExtractor, SIGNAL(progress(int)), progressBar, SLOT(setValue(int)));
+		connect(timeSeriesExtractor, SIGNAL(finishedExtracting()), progressBar, SLOT(hide()));
+	}
+
+	/* Reading fort.63 directly while the cache is built would parse the whole file twice */
+	BuildFort63Cache(fileLocation);
+	if (fort63CacheBuilder)
+	{
+		emit Instructions("The time series will be extracted once the binary cache is built");
+		if (progressBar)
+		{
+			connect(fort63CacheBuilder, SIGNAL(progress(int)), progressBar, SLOT(setValue(int)));
+			progressBar->show();
+		}
+		return;
+	}
+
+	TaskScheduler::Instance()->Start(timeSeriesExtractor, "extract", TASK_PRIORITY_HIGH, &timeSeriesTasks);
+}
+
+
+bool Domain::Fort63AnimationRunning()
+{
+	return prefetcher != 0;
+}
+
+
+/**
+ * @brief Shows the max envelope of fort.63 or fort.64 over the terrain, computing it if needed
+ *
+ * Shows the max envelope of fort.63 (water elevation) or fort.64 (speed) over the
+ * terrain. If the envelope of the whole run is asked for and maxele.63 or maxvel.63
+ * is already in the domain directory, it is shown right away. Otherwise the envelope
+ * is computed by an EnvelopeCalculator on the TaskScheduler. An envelope of the whole
+ * run is written to maxele.63 or maxvel.63, along with minele.63 or minvel.63, and an
+ * envelope of a shorter window has the window added to the file names. The envelope
+ * is shown once it has been written.
+ *
+ * @param velocity true for fort.64, false for fort.63
+ * @param firstTimestep The first timestep of the window (starting from 1)
+ * @param lastTimestep The last timestep of the window, or 0 for the last timestep in the file
+ * @return true if the envelope was shown or is being computed
+ */
+bool Domain::ComputeEnvelope(bool velocity, unsigned int firstTimestep, unsigned int lastTimestep)
+{
+	if (envelopeCalculator || !terrainLayer || !terrainLayer->DataLoaded())
+		return false;
+
+	QString fileLocation = velocity ? FindFort64File() : FindFort63File();
+	QString outputDir = QFileInfo(fileLocation).absolutePath() + QDir::separator();
+	QString maxName = velocity ? "maxvel" : "maxele";
+	QString minName = velocity ? "minvel" : "minele";
+	bool wholeRun = firstTimestep <= 1 && lastTimestep == 0;
+	if (!wholeRun)
+	{
+		QString window = QString(".").append(QString::number(firstTimestep)).append("-").append(QString::number(lastTimestep));
+		maxName.append(window);
+		minName.append(window);
+	}
+	QString maxLocation = outputDir + maxName + ".63";
+	QString minLocation = outputDir + minName + ".63";
+
+	if (wholeRun && QFile(maxLocation).exists())
+		return ShowEnvelope(maxLocation, velocity ? MaxVelocityOverlay : MaxElevationOverlay);
+
+	if (!QFile(fileLocation).exists())
+	{
+		emit EmitMessage(QString("<p style='color:red'><strong>Error:</strong> ").append(velocity ? "fort.64" : "fort.63")
+				 .append(" file not found at ").append(fileLocation).append("</p>"));
+		return false;
+	}
+
+	envelopeCalculator = new EnvelopeCalculator(fileLocation);
+	envelopeVelocity = velocity;
+	envelopeCalculator->SetTimeWindow(firstTimestep, lastTimestep);
+	envelopeCalculator->SetOutputPaths(maxLocation, minLocation);
+
+	connect(envelopeCalculator, SIGNAL(emitMessage(QString)), this, SIGNAL(EmitMessage(QString)));
+	if (progressBar)
+	{
+		connect(envelopeCalculator, SIGNAL(startedCalculating()), progressBar, SLOT(show()));
+		connect(envelopeCalculator, SIGNAL(progress(int)), progressBar, SLOT(setValue(int)));
+		connect(envelopeCalculator, SIGNAL(finishedCalculating()), progressBar, SLOT(hide()));
+	}
+
+	TaskScheduler::Instance()->Start(envelopeCalculator, "calculate", TASK_PRIORITY_NORMAL, &envelopeTasks);
+	emit EmitMessage(QString("Computing the envelope of ").append(fileLocation));
+	return true;
+}
+
+
+/**
+ * @brief Checks the subdomain's results against the full domain's results
+ *
+ * Checks the subdomain's fort.63 (or fort.64) against the full domain's, through
+ * py.140. The comparison runs on the TaskScheduler in a SubdomainVerifier, and the
+ * max difference at each node is drawn over the subdomain when it is done. The per-node
+ * max and RMS differences are written next to the subdomain's output file, with .diff
+ * added to its name.
+ *
+ * @param velocity true to compare fort.64, false to compare fort.63
+ * @return true if the verification was started
+ */
+bool Domain::VerifyAgainstFullDomain(bool velocity)
+{
+	if (verifier || !terrainLayer || !terrainLayer->DataLoaded())
+		return false;
+
+	if (!sourceDomain || py140Location.isEmpty())
+	{
+		emit EmitMessage("<p style='color:red'><strong>Error:</strong> Only a subdomain can be verified against the full domain.</p>");
+		return false;
+	}
+
+	QString subLocation = velocity ? FindFort64File() : FindFort63File();
+	QString fullLocation = velocity ? sourceDomain->FindFort64File() : sourceDomain->FindFort63File();
+	if (!QFile(subLocation).exists() || !QFile(fullLocation).exists())
+	{
+		emit EmitMessage(QString("<p style='color:red'><strong>Error:</strong> Both ").append(subLocation)
+				 .append(" and ").append(fullLocation).append(" are needed for verification.</p>"));
+		return false;
+	}
+
+	verifier = new SubdomainVerifier(subLocation, fullLocation, py140Location);
+	verifier->SetOutputPath(subLocation + ".diff");
+
+	connect(verifier, SIGNAL(emitMessage(QString)), this, SIGNAL(EmitMessage(QString)));
+	if (progressBar)
+	{
+		connect(verifier, SIGNAL(startedVerifying()), progressBar, SLOT(show()));
+		connect(verifier, SIGNAL(progress(int)), progressBar, SLOT(setValue(int)));
+		connect(verifier, SIGNAL(finishedVerifying()), progressBar, SLOT(hide()));
+	}
+
+	TaskScheduler::Instance()->Start(verifier, "verify", TASK_PRIORITY_NORMAL, &verifierTasks);
+	emit EmitMessage(QString("Verifying ").append(subLocation).append(" against ").append(fullLocation));
+	return true;
+}
+
+
+/**
+ * @brief Hides the envelope and goes back to drawing the terrain
+ */
+void Domain::HideEnvelope()
+{
+	if (visibleOverlay != NoOverlay && terrainLayer && !prefetcher)
+	{
+		terrainLayer->HideNodalValues();
+		emit UpdateGL();
+	}
+	visibleOverlay = NoOverlay;
+}
+
+
+/**
+ * @brief Returns which envelope is drawn over the terrain
+ * @return The envelope or difference being drawn, or NoOverlay
+ */
+OverlayType Domain::GetVisibleOverlay()
+{
+	return visibleOverlay;
+}
+
+
+/**
+ * @brief Shows the first record of a maxele.63 style file over the terrain
+ *
+ * Shows the first record of a maxele.63 style file over the terrain, colored
+ * between the lowest and highest wet values. Any fort.63 playback is stopped first.
+ *
+ * @param fileLocation The envelope file
+ * @param overlay What the envelope file holds
+ * @return true if the envelope matches the domain and is shown
+ */
+bool Domain::ShowEnvelope(QString fileLocation, OverlayType overlay)
+{
+	if (!terrainLayer)
+		return false;
+
+	Fort63 envelopeFile (fileLocation);
+	std::vector<float> values;
+	if (!envelopeFile.BuildIndex() || envelopeFile.GetNumNodes() != GetNumNodesDomain() ||
+	    !envelopeFile.ReadTimestep(1, values))
+	{
+		emit EmitMessage(QString("<p style='color:red'><strong>Error:</strong> ").append(fileLocation)
+				 .append(" does not match the domain.</p>"));
+		return false;
+	}
+
+	StopFort63Animation();
+	unsigned int valuesPerNode = envelopeFile.GetValuesPerNode();
+	SetAnimationRange(values, valuesPerNode);
+	terrainLayer->SetNodalValues(values, valuesPerNode);
+	visibleOverlay = overlay;
+	emit EmitMessage(QString("Showing ").append(fileLocation));
+	emit UpdateGL();
+	return true;
+}
+
+
+/**
+ * @brief Starts playing back the velocities in fort.64 as arrows over the terrain
+ *
+ * Starts playing back the velocities in fort.64 as arrows over the terrain. This
+ * works the same way as fort.63 playback, with its own TimestepPrefetcher, and
+ * shares the same frame timer so that both files can be played at once. The
+ * arrows are drawn by a VelocityLayer.
+ *
+ * If no fort.64 location has been set, fort.64 in the domain directory is used.
+ *
+ * @return true if playback was started
+ */
+bool Domain::StartFort64Animation()
+{
+	if (velocityPrefetcher)
+		return true;
+
+	if (!terrainLayer || !terrainLayer->DataLoaded())
+		return false;
+
+	QString fileLocation = FindFort64File();
+	if (!QFile(fileLocation).exists())
+	{
+		emit EmitMessage(QString("<p style='color:red'><strong>Error:</strong> fort.64 file not found at ").append(fileLocation).append("</p>"));
+		return false;
+	}
+
+	velocityThread = new QThread();
+	velocityPrefetcher = new TimestepPrefetcher(fileLocation);
+	velocityPrefetcher->moveToThread(velocityThread);
+	velocityTimestep = 1;
+
+	connect(velocityThread, SIGNAL(started()), velocityPrefetcher, SLOT(prefetch()));
+	connect(velocityPrefetcher, SIGNAL(indexBuilt(int)), this, SLOT(Fort64Indexed(int)));
+	connect(velocityPrefetcher, SIGNAL(finishedPrefetching()), velocityThread, SLOT(quit()));
+	connect(velocityThread, SIGNAL(finished()), velocityPrefetcher, SLOT(deleteLater()));
+	connect(velocityThread, SIGNAL(finished()), velocityThread, SLOT(deleteLater()));
+
+	velocityThread->start();
+	emit EmitMessage(QString("Indexing ").append(fileLocation));
+	return true;
+}
+
+
+/**
+ * @brief Stops fort.64 playback and hides the velocity arrows
+ *
+ * Stops fort.64 playback and hides the velocity arrows. The prefetch thread
+ * finishes its current read and then cleans itself up.
+ *
+ */
+void Domain::StopFort64Animation()
+{
+	if (animationTimer && !prefetcher)
+		animationTimer->stop();
+
+	if (velocityPrefetcher)
+	{
+		disconnect(velocityPrefetcher, SIGNAL(indexBuilt(int)), this, SLOT(Fort64Indexed(int)));
+		velocityPrefetcher->Stop();
+		velocityPrefetcher = 0;
+		velocityThread = 0;
+		emit UpdateGL();
+	}
+}
+
+
+bool Domain::Fort64AnimationRunning()
+{
+	return velocityPrefetcher != 0;
+}
+
+
+/**
+ * @brief Returns the fort.64 file used for playback
+ *
+ * Returns the fort.64 file used for playback. If no fort.64 location has been
+ * set, fort.64 in the domain directory is used, or fort.64.nc if the run wrote
+ * netCDF output.
+ *
+ * @return The fort.64 file location
+ */
+QString Domain::FindFort64File()
+{
+	if (!fort64Location.isEmpty())
+		return fort64Location;
+
+	QString asciiLocation = domainPath + QDir::separator() + "fort.64";
+	QString netcdfLocation = asciiLocation + ".nc";
+	if (!QFile(asciiLocation).exists() && QFile(netcdfLocation).exists())
+		return netcdfLocation;
+	return asciiLocation;
+}
+
+
+/**
+ * @brief Starts reading the mesh into the TerrainLayer
+ *
+ * Starts reading the mesh into the TerrainLayer. A subdomain's mesh can only be
+ * derived from its full domain once the full domain's mesh has finished loading,
+ * so if the full domain is still being read the subdomain waits for it before
+ * starting. If the full domain is not loaded or being read, the subdomain fort.14
+ * file is read instead.
+ *
+ */
 void Domain::LoadFort14File()
 {
 	CreateTerrainLayer();
 	loadingLayer = terrainLayer;
-	terrainLayer->moveToThread(layerThread);
-	terrainLayer->SetData(fort14Location);
+
+	if (sourceDomain && sourceDomain->IsLoading() && !py140Location.isEmpty() && !py141Location.isEmpty())
+	{
+		connect(sourceDomain, SIGNAL(LoadFinished(bool)), this, SLOT(SourceDomainLoaded()), Qt::UniqueConnection);
+		return;
+	}
+
+	/* LoadLayerToGPU() disconnects itself, so a layer that was unloaded must be connected again */
+	connect(terrainLayer, SIGNAL(finishedReadingData()), this, SLOT(LoadLayerToGPU()), Qt::UniqueConnection);
+	if (sourceDomain && sourceDomain->terrainLayer && sourceDomain->terrainLayer->DataLoaded() &&
+	    !py140Location.isEmpty() && !py141Location.isEmpty())
+		terrainLayer->SetDerivedData(sourceDomain->terrainLayer, fort14Location, py140Location, py141Location);
+	else
+		terrainLayer->SetData(fort14Location);
 }
 
 
@@ -712,6 +1406,9 @@ void Domain::CreateTerrainLayer()
 
 		connect(terrainLayer, SIGNAL(EmitMessage(QString)), this, SIGNAL(Message(QString)));
 		connect(terrainLayer, SIGNAL(finishedReadingData()), this, SLOT(LoadLayerToGPU()));
+		connect(terrainLayer, SIGNAL(finishedReadingData()), this, SLOT(TerrainLayerLoaded()));
+		connect(terrainLayer, SIGNAL(failedReadingData()), this, SLOT(TerrainLayerFailed()));
+		connect(terrainLayer, SIGNAL(progress(int)), this, SIGNAL(LoadProgress(int)));
 		connect(terrainLayer, SIGNAL(finishedLoadingToGPU()), this, SIGNAL(UpdateGL()));
 		connect(terrainLayer, SIGNAL(foundNumNodes(int)), this, SIGNAL(NumNodesDomain(int)));
 		connect(terrainLayer, SIGNAL(foundNumElements(int)), this, SIGNAL(NumElementsDomain(int)));
@@ -743,6 +1440,8 @@ void Domain::Zoom(float zoomAmount)
 		camera->Zoom(zoomAmount);
 	if (terrainLayer)
 		terrainLayer->UpdateZoomLevel(zoomAmount);
+	if (velocityLayer)
+		velocityLayer->ViewChanged();
 }
 
 
@@ -758,6 +1457,8 @@ void Domain::Pan(float dx, float dy)
 {
 	if (camera)
 		camera->Pan(dx, dy);
+	if (velocityLayer)
+		velocityLayer->ViewChanged();
 }
 
 
@@ -800,7 +1501,7 @@ void Domain::CalculateMouseCoordinates()
  * @brief This function is used internally to load Layer data to the GPU
  *
  * This function is used internally to load Layer data to the GPU. Layer data is
- * read from file using a separate thread. However, that data can only be loaded
+ * read from file by a task on the TaskScheduler. However, that data can only be loaded
  * to the OpenGL context from the main thread. Therefore, we provide this internal
  * slot mechanism that needs to be connected to the finishedReadingData() signal
  * of a Layer that is reading a file on a different thread. Once that signal
@@ -822,8 +1523,263 @@ void Domain::LoadLayerToGPU()
 }
 
 
+void Domain::TerrainLayerLoaded()
+{
+	loading = false;
+	emit LoadFinished(true);
+}
+
+
+void Domain::TerrainLayerFailed()
+{
+	loading = false;
+	emit LoadFinished(false);
+}
+
+
+/**
+ * @brief Starts reading the mesh once the full domain has finished loading
+ *
+ * Starts reading the mesh once the full domain has finished loading, so that it
+ * can be derived from the full domain. If the full domain failed to load, the
+ * subdomain fort.14 file is read.
+ *
+ */
+void Domain::SourceDomainLoaded()
+{
+	disconnect(sourceDomain, SIGNAL(LoadFinished(bool)), this, SLOT(SourceDomainLoaded()));
+	if (loading)
+		LoadFort14File();
+}
+
+
 void Domain::EnterDisplayMode()
 {
 	currentMode = DisplayAction;
 	emit SetCursor(Qt::ArrowCursor);
 }
+
+
+/**
+ * @brief Sets the range of the value gradient from the first timestep shown
+ *
+ * Sets the range of the value gradient from the first timestep shown. Dry nodes
+ * (-99999) are left out of the range and are drawn with the low color. Vector
+ * values are drawn by magnitude, so their range starts at zero.
+ *
+ * @param values The timestep's values
+ * @param valuesPerNode The number of values for each node
+ */
+void Domain::SetAnimationRange(std::vector<float> &values, unsigned int valuesPerNode)
+{
+	if (!terrainLayer || values.size() == 0)
+		return;
+
+	bool found = false;
+	float low = 0.0, high = 0.0;
+	for (unsigned int i=0; i+valuesPerNode<=values.size(); i+=valuesPerNode)
+	{
+		if (values[i] <= DRY_VALUE)
+			continue;
+
+		float value = values[i];
+		if (valuesPerNode > 1)
+		{
+			float magnitude = 0.0;
+			for (unsigned int j=0; j<valuesPerNode; ++j)
+				magnitude += values[i+j]*values[i+j];
+			value = sqrt(magnitude);
+		}
+
+		if (!found || value < low)
+			low = value;
+		if (!found || value > high)
+			high = value;
+		found = true;
+	}
+
+	if (valuesPerNode > 1)
+		low = 0.0;
+	if (high <= low)
+		high = low + 1.0;
+
+	terrainLayer->SetNodalValueRange(low, high);
+	animationRangeSet = found;
+}
+
+
+/**
+ * @brief Starts the playback timer once the fort.63 timestep index has been built
+ * @param numTimesteps The number of complete timesteps in the file
+ */
+void Domain::Fort63Indexed(int numTimesteps)
+{
+	if (!prefetcher)
+		return;
+
+	if (numTimesteps <= 0 || prefetcher->GetNumNodes() != GetNumNodesDomain())
+	{
+		emit EmitMessage("<p style='color:red'><strong>Error:</strong> fort.63 file does not match the domain.</p>");
+		StopFort63Animation();
+		return;
+	}
+
+	emit NumTimesteps(numTimesteps);
+	animationTimer->start();
+}
+
+
+/**
+ * @brief Creates the velocity layer and starts the playback timer once the fort.64 timestep index has been built
+ * @param numTimesteps The number of complete timesteps in the file
+ */
+void Domain::Fort64Indexed(int numTimesteps)
+{
+	if (!velocityPrefetcher)
+		return;
+
+	if (numTimesteps <= 0 || velocityPrefetcher->GetNumNodes() != GetNumNodesDomain() ||
+	    velocityPrefetcher->GetValuesPerNode() != 2)
+	{
+		emit EmitMessage("<p style='color:red'><strong>Error:</strong> fort.64 file does not match the domain.</p>");
+		StopFort64Animation();
+		return;
+	}
+
+	if (!velocityLayer)
+	{
+		velocityLayer = new VelocityLayer();
+		velocityLayer->SetCamera(camera);
+	}
+	velocityLayer->SetTerrainLayer(terrainLayer);
+
+	emit NumTimesteps(numTimesteps);
+	animationTimer->start();
+}
+
+
+/**
+ * @brief Starts building the binary cache of a fort.63 file in the background
+ *
+ * Starts building the binary cache of a fort.63 file as a low priority task on the
+ * TaskScheduler, so that time series after the first can be read from the cache's
+ * node-major chunks. Nothing is done for netCDF files that are chunked by node,
+ * which are read by node directly, or if the cache is current or already being built.
+ *
+ * @param fileLocation The fort.63 file
+ */
+void Domain::BuildFort63Cache(QString fileLocation)
+{
+	if (fort63CacheBuilder || Fort63Cache(fileLocation).CacheIsCurrent() || PointTimeSeries::NodeReadsAreCheap(fileLocation))
+		return;
+
+	fort63CacheBuilder = new Fort63Cache(fileLocation);
+	connect(fort63CacheBuilder, SIGNAL(emitMessage(QString)), this, SIGNAL(EmitMessage(QString)));
+	emit EmitMessage(QString("Building the binary cache of ").append(fileLocation));
+
+	TaskScheduler::Instance()->Start(fort63CacheBuilder, "buildCache", TASK_PRIORITY_LOW, &fort63CacheTasks);
+}
+
+
+/**
+ * @brief Cleans up the cache builder and starts the time series that was waiting for it
+ *
+ * Cleans up the cache builder and starts the time series that was waiting for it.
+ * The series is read from the cache if it was built, and from fort.63 otherwise.
+ *
+ */
+void Domain::Fort63CacheFinished()
+{
+	/* The building task has finished, so the builder can be deleted from here */
+	if (fort63CacheBuilder)
+	{
+		delete fort63CacheBuilder;
+		fort63CacheBuilder = 0;
+	}
+
+	if (timeSeriesExtractor && !timeSeriesTasks.IsRunning())
+		TaskScheduler::Instance()->Start(timeSeriesExtractor, "extract", TASK_PRIORITY_HIGH, &timeSeriesTasks);
+}
+
+
+/**
+ * @brief Passes the extracted time series up to the GUI and cleans up the extractor
+ */
+void Domain::TimeSeriesFinished()
+{
+	if (timeSeriesExtractor)
+	{
+		QPolygonF series = timeSeriesExtractor->GetSeries();
+		if (!series.isEmpty())
+			emit TimeSeriesExtracted(timeSeriesExtractor->GetLocationText(), series);
+		delete timeSeriesExtractor;
+	}
+	timeSeriesExtractor = 0;
+}
+
+
+/**
+ * @brief Shows the envelope once it has been written and cleans up the calculator
+ */
+void Domain::EnvelopeFinished()
+{
+	if (envelopeCalculator)
+	{
+		QString maxLocation = envelopeCalculator->GetMaxOutputPath();
+		bool written = envelopeCalculator->EnvelopeWritten();
+		delete envelopeCalculator;
+		if (written)
+			ShowEnvelope(maxLocation, envelopeVelocity ? MaxVelocityOverlay : MaxElevationOverlay);
+	}
+	envelopeCalculator = 0;
+}
+
+
+/**
+ * @brief Shows the per-node max difference once it has been written and cleans up the verifier
+ */
+void Domain::VerificationFinished()
+{
+	if (verifier)
+	{
+		QString outputLocation = verifier->GetOutputPath();
+		bool written = verifier->VerificationWritten();
+		delete verifier;
+		if (written)
+			ShowEnvelope(outputLocation, DifferenceOverlay);
+	}
+	verifier = 0;
+}
+
+
+/**
+ * @brief Shows the next fort.63 and fort.64 timesteps if they have been read
+ */
+void Domain::ShowNextTimestep()
+{
+	if (!terrainLayer)
+		return;
+
+	if (prefetcher && prefetcher->TakeTimestep(animationTimestep, animationValues))
+	{
+		unsigned int valuesPerNode = prefetcher->GetValuesPerNode();
+		if (animationValues.size() > 0)
+		{
+			if (!animationRangeSet)
+				SetAnimationRange(animationValues, valuesPerNode);
+			terrainLayer->SetNodalValues(animationValues, valuesPerNode);
+			emit UpdateGL();
+		}
+		animationTimestep = animationTimestep < prefetcher->GetNumTimesteps() ? animationTimestep+1 : 1;
+	}
+
+	if (velocityPrefetcher && velocityLayer && velocityPrefetcher->TakeTimestep(velocityTimestep, velocityValues))
+	{
+		if (velocityValues.size() > 0)
+		{
+			velocityLayer->SetVelocities(velocityValues);
+			emit UpdateGL();
+		}
+		velocityTimestep = velocityTimestep < velocityPrefetcher->GetNumTimesteps() ? velocityTimestep+1 : 1;
+	}
+}
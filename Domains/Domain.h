@@ -7,12 +7,17 @@
 #include <QMouseEvent>
 #include <QWheelEvent>
 #include <QKeyEvent>
+#include <QTimer>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
 
 #include <string>
 #include <vector>
 
 #include "Layers/Layer.h"
 #include "Layers/TerrainLayer.h"
+#include "Layers/VelocityLayer.h"
 #include "Layers/SelectionLayers/CreationSelectionLayer.h"
 
 #include "OpenGL/GLCamera.h"
@@ -21,6 +26,14 @@
 #include "OpenGL/Shaders/GradientShader.h"
 
 #include "Projects/ProjectFile.h"
+#include "Projects/IO/FileIO/SubdomainFiles.h"
+#include "Projects/IO/FileIO/TimestepPrefetcher.h"
+#include "Analysis/PointTimeSeries.h"
+#include "Analysis/EnvelopeCalculator.h"
+#include "Analysis/SubdomainVerifier.h"
+#include "Tasks/TaskScheduler.h"
+
+#define ANIMATION_FRAME_INTERVAL	33
 
 
 /**
@@ -72,6 +85,7 @@ class Domain : public QObject
 		void	KeyPress(QKeyEvent *event);
 		void	SetWindowSize(float w, float h);
 		void	UseTool(ToolType tool, SelectionType selection);
+		void	UseTimeSeriesTool();
 		void	Undo();
 		void	Redo();
 
@@ -84,6 +98,15 @@ class Domain : public QObject
 		void	SetFort64Location(QString newLoc);
 		void	SetBNListLocation(QString newLoc);
 		void	SetPy140Location(QString newLoc);
+		void	SetPy141Location(QString newLoc);
+		void	SetSourceDomain(Domain *newSource);
+		void	SetLoadQueued(bool queued);
+
+		// Loading the mesh from disk
+		bool	LoadData(int priority=TASK_PRIORITY_HIGH);
+		bool	IsLoaded();
+		bool	IsLoading();
+		bool	Unload();
 
 		// Query functions used to access data used to populate the GUI
 		QString		GetDomainPath();
@@ -93,6 +116,9 @@ class Domain : public QObject
 		QString		GetFort64Location();
 		QString		GetBNListLocation();
 		QString		GetPy140Location();
+		QString		GetPy141Location();
+		SubdomainFiles	GetSubdomainFiles();
+		Domain*		GetSourceDomain();
 		std::vector<Element> *GetAllElements();
 		ElementState*	GetCurrentSelectedElements();
 		float		GetTerrainMinElevation();
@@ -107,10 +133,22 @@ class Domain : public QObject
 		unsigned int	GetNumElementsDomain();
 		unsigned int	GetNumNodesSelected();
 		unsigned int	GetNumElementsSelected();
+		qint64		GetMemoryUsage();
+		qint64		GetGPUMemoryUsage();
 		GLCamera*	GetCamera();
 
 		/* Display methods used to change visibility of layers, etc. */
 		void	ToggleTerrainQuadtree();
+		bool	StartFort63Animation();
+		void	StopFort63Animation();
+		bool	Fort63AnimationRunning();
+		bool	StartFort64Animation();
+		void	StopFort64Animation();
+		bool	Fort64AnimationRunning();
+		bool	ComputeEnvelope(bool velocity, unsigned int firstTimestep=1, unsigned int lastTimestep=0);
+		void	HideEnvelope();
+		OverlayType	GetVisibleOverlay();
+		bool	VerifyAgainstFullDomain(bool velocity=false);
 
 
 	private:
@@ -122,12 +160,54 @@ class Domain : public QObject
 
 		// Layers
 		TerrainLayer*		terrainLayer;	/**< The terrain layer */
+		VelocityLayer*		velocityLayer;	/**< The layer that draws fort.64 velocities as arrows */
 		CreationSelectionLayer*	selectionLayer;	/**< The selection layer */
 
 		// Loading Operations
-		QThread*	layerThread;	/**< The thread on which file reading operations will execute */
 		QProgressBar*	progressBar;	/**< The progress bar that will show file reading progress */
 		Layer*		loadingLayer;	/**< Sort of a queue for the next layer that will send data to the GPU */
+		bool		loading;	/**< Flag that shows if the mesh is being read */
+		bool		loadQueued;	/**< Flag that shows if a DomainLoader will start the read, so drawing does not */
+
+		// fort.63 Playback
+		QThread*		prefetchThread;		/**< The thread on which upcoming timesteps are read */
+		TimestepPrefetcher*	prefetcher;		/**< Reads upcoming timesteps ahead of playback */
+		QTimer*			animationTimer;		/**< Shows a new timestep every ANIMATION_FRAME_INTERVAL ms */
+		unsigned int		animationTimestep;	/**< The next timestep that will be shown */
+		std::vector<float>	animationValues;	/**< Buffer that timesteps are passed through on the way to the terrain layer */
+		bool			animationRangeSet;	/**< Flag that shows if the value range has been set from the first timestep */
+
+		void	SetAnimationRange(std::vector<float> &values, unsigned int valuesPerNode);
+
+		// fort.64 Playback
+		QThread*		velocityThread;		/**< The thread on which upcoming fort.64 timesteps are read */
+		TimestepPrefetcher*	velocityPrefetcher;	/**< Reads upcoming fort.64 timesteps ahead of playback */
+		unsigned int		velocityTimestep;	/**< The next fort.64 timestep that will be shown */
+		std::vector<float>	velocityValues;		/**< Buffer that fort.64 timesteps are passed through on the way to the velocity layer */
+
+		QString	FindFort64File();
+
+		// Point Time Series
+		TaskGroup		timeSeriesTasks;	/**< The task extracting a time series */
+		PointTimeSeries*	timeSeriesExtractor;	/**< Extracts the time series at the clicked point */
+		TaskGroup		fort63CacheTasks;	/**< The task building the fort.63 binary cache */
+		Fort63Cache*		fort63CacheBuilder;	/**< Builds the fort.63 binary cache for later time series */
+
+		QString	FindFort63File();
+		void	ExtractTimeSeries(int x, int y);
+		void	BuildFort63Cache(QString fileLocation);
+
+		// Output Envelopes
+		TaskGroup		envelopeTasks;		/**< The task computing an envelope */
+		EnvelopeCalculator*	envelopeCalculator;	/**< Computes the max/min envelope of fort.63 or fort.64 */
+		bool			envelopeVelocity;	/**< true if the envelope being computed is of fort.64 */
+		OverlayType		visibleOverlay;		/**< The envelope or difference drawn over the terrain, if any */
+
+		bool	ShowEnvelope(QString fileLocation, OverlayType overlay);
+
+		// Subdomain Verification
+		TaskGroup		verifierTasks;		/**< The task verifying the subdomain results */
+		SubdomainVerifier*	verifier;		/**< Compares the subdomain results with the full domain results */
 
 		void	LoadFort14File();
 
@@ -142,6 +222,8 @@ class Domain : public QObject
 		QString		fort64Location;
 		QString		bnListLocation;
 		QString		py140Location;
+		QString		py141Location;
+		Domain*		sourceDomain;	/**< The full domain that a subdomain's mesh can be derived from */
 
 		/* Mouse Clicking and Moving Stuff */
 		ActionType	currentMode;	/**< The current mode used to determine where actions are sent */
@@ -182,6 +264,10 @@ class Domain : public QObject
 		void	NumElementsDomain(int);		/**< Emitted when the number of elements in the domain changes */
 		void	NumNodesSelected(int);		/**< Emitted when the number of currently selected nodes changes */
 		void	NumElementsSelected(int);	/**< Emitted when the number of currently selected elements changes */
+		void	LoadProgress(int);		/**< Emitted as the mesh is read, in percent */
+		void	LoadFinished(bool);		/**< Emitted when the mesh has been read, or could not be */
+		void	NumTimesteps(int);		/**< Emitted when the number of timesteps available for playback is known */
+		void	TimeSeriesExtracted(QString, QPolygonF);	/**< Emitted when the time series at a clicked point is ready */
 
 		/* Selection Tool Pass-through Signals */
 		void	ToolFinishedDrawing();				/**< Emitted when a selection tool has finished drawing */
@@ -195,7 +281,17 @@ class Domain : public QObject
 	protected slots:
 
 		void	LoadLayerToGPU();
+		void	TerrainLayerLoaded();
+		void	TerrainLayerFailed();
+		void	SourceDomainLoaded();
 		void	EnterDisplayMode();
+		void	Fort63Indexed(int numTimesteps);
+		void	Fort64Indexed(int numTimesteps);
+		void	ShowNextTimestep();
+		void	TimeSeriesFinished();
+		void	Fort63CacheFinished();
+		void	EnvelopeFinished();
+		void	VerificationFinished();
 
 };
 
@@ -19,16 +19,13 @@
  *
  * Threading usage:
  * - Create the new Layer object (using new)
- * - Create a new QThread object (using new)
- * - Move the new Layer to the QThread using Layer::moveToThread()
- * - Connect the Layer's finishedThreading signal to the QThread's deleteLater slot
- * - Use the Layer as normal, being sure to delete it when finished. This will also
- *   delete the QThread that the Layer has been using once all work on that thread
- *   has finished.
+ * - Run the slots that do long operations, like reading files, as tasks on the
+ *   TaskScheduler with TaskScheduler::Start(), counting them towards a TaskGroup
+ *   owned by the Layer
+ * - Cancel and wait on the TaskGroup before the data the tasks work on is deleted
  *
- * What this does is allow all slots of the Layer object to be processed on a
- * worker thread that is alive for the lifetime of the Layer itself, preventing the
- * main GUI from freezing during long operations like reading files.
+ * The Layer stays in the GUI thread, so the signals it emits from a task are queued
+ * to the GUI, and the main GUI does not freeze during long operations.
  *
  */
 class Layer : public QObject
@@ -76,6 +73,7 @@ class Layer : public QObject
 		void	startedReadingData();
 		void	progress(int);
 		void	finishedReadingData();
+		void	failedReadingData();
 		void	finishedLoadingToGPU();
 };
 
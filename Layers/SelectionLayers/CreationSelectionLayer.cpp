@@ -587,6 +587,46 @@ void CreationSelectionLayer::CreatePolygonTool()
 }
 
 
+/**
+ * @brief Drops the current selection, the undo and redo history and the GPU data
+ *
+ * Drops the current selection, the undo and redo history and the GPU data. Used
+ * when the TerrainLayer frees its Elements, which every selection points into, and
+ * its vertex buffer, which the vertex array object of this layer is bound to. The
+ * layer is set up again from the new vertex buffer once the terrain is reloaded.
+ *
+ */
+void CreationSelectionLayer::ClearSelection()
+{
+	ClearUndoStack();
+	ClearRedoStack();
+	if (selectedState)
+	{
+		delete selectedState;
+		selectedState = 0;
+	}
+	boundaryNodes.clear();
+
+	if (outlineShader)
+		delete outlineShader;
+	if (fillShader)
+		delete fillShader;
+	if (boundaryShader)
+		delete boundaryShader;
+	outlineShader = fillShader = boundaryShader = 0;
+
+	glBindVertexArray(0);
+	if (VAOId)
+		glDeleteVertexArrays(1, &VAOId);
+	if (IBOId)
+		glDeleteBuffers(1, &IBOId);
+	VAOId = IBOId = VBOId = 0;
+	glLoaded = false;
+
+	emit NumElementsSelected(0);
+}
+
+
 /**
  * @brief Clears the undo stack
  *
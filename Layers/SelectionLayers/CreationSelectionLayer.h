@@ -82,6 +82,7 @@ class CreationSelectionLayer : public SelectionLayer
 
 		virtual void	Undo();
 		virtual void	Redo();
+		void		ClearSelection();
 
 		std::vector<unsigned int>	GetBoundaryNodes();
 		ElementState*			GetCurrentSelection();
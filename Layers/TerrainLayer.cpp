@@ -6,18 +6,16 @@ TerrainLayer::TerrainLayer()
 	numNodes = 0;
 	numElements = 0;
 	minX = 99999.0;
-	midX = 0.0;
 	maxX = -99999.0;
 	minY = 99999.0;
-	midY = 0.0;
 	maxY = -99999.0;
 	minZ = 99999.0;
 	maxZ = -99999.0;
-	max = 1.0;
 
 	VAOId = 0;
 	VBOId = 0;
 	IBOId = 0;
+	valueVBOId = 0;
 	outlineShader = 0;
 	fillShader = 0;
 	boundaryShader = 0;
@@ -27,7 +25,11 @@ TerrainLayer::TerrainLayer()
 	glLoaded = false;
 	largeDomain = false;
 
+	dataBytes = 0;
+	gpuBytes = 0;
+
 	quadtree = 0;
+	quadtreeOutline = 0;
 	drawQuadtreeOutline = false;
 	numVisibleElements = 0;
 	viewingDepth = 5;
@@ -39,13 +41,30 @@ TerrainLayer::TerrainLayer()
 	gradientOutline = 0;
 	gradientFill = 0;
 	gradientBoundary = 0;
+	valueFill = 0;
+
+	pendingValuesPerNode = 1;
+	valuesPending = false;
+	valuesVisible = false;
+	valueLow = -1.0;
+	valueHigh = 1.0;
+
+	sourceLayer = 0;
+	py140Location = "";
+	py141Location = "";
 
-	connect(this, SIGNAL(fort14Valid()), this, SLOT(readFort14()));
+	readPriority = TASK_PRIORITY_NORMAL;
+
+	connect(this, SIGNAL(fort14Valid()), this, SLOT(queueRead()));
+	connect(this, SIGNAL(derivedDataValid()), this, SLOT(queueDerive()));
 }
 
 
 TerrainLayer::~TerrainLayer()
 {
+	/* The mesh must not be freed while it is being read */
+	readTasks.Cancel();
+	readTasks.Wait();
 
 	DEBUG("Deleting Terrain Layer. Layer ID: " << GetID());
 
@@ -64,14 +83,20 @@ TerrainLayer::~TerrainLayer()
 		delete gradientFill;
 	if (gradientBoundary)
 		delete gradientBoundary;
+	if (valueFill)
+		delete valueFill;
 
 	if (VBOId)
 		glDeleteBuffers(1, &VBOId);
+	if (valueVBOId)
+		glDeleteBuffers(1, &valueVBOId);
 	if (VAOId)
 		glDeleteBuffers(1, &VAOId);
 	if (IBOId)
 		glDeleteBuffers(1, &IBOId);
 
+	if (quadtreeOutline)
+		delete quadtreeOutline;
 	if (quadtree)
 		delete quadtree;
 }
@@ -89,10 +114,14 @@ void TerrainLayer::Draw()
 	{
 		glBindVertexArray(VAOId);
 
-		if (fillShader)
+		if (valuesPending)
+			UploadNodalValues();
+
+		GLShader *currentFill = valuesVisible && valueFill ? valueFill : fillShader;
+		if (currentFill)
 		{
 			glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-			if (fillShader->Use())
+			if (currentFill->Use())
 				if (largeDomain)
 					glDrawElements(GL_TRIANGLES, numVisibleElements*3, GL_UNSIGNED_INT, (GLvoid*)0);
 				else
@@ -120,7 +149,12 @@ void TerrainLayer::Draw()
 
 		if (drawQuadtreeOutline && quadtree)
 		{
-			quadtree->DrawOutlines();
+			if (!quadtreeOutline)
+			{
+				quadtreeOutline = new QuadtreeOutline(quadtree);
+				quadtreeOutline->SetCamera(camera);
+			}
+			quadtreeOutline->Draw();
 		}
 
 		glBindVertexArray(0);
@@ -227,6 +261,7 @@ void TerrainLayer::LoadDataToGPU()
 			if (VAOId && VBOId && IBOId)
 			{
 				glLoaded = true;
+				gpuBytes = VertexBufferSize + 3*sizeof(GLuint)*numElements + sizeof(GLuint)*boundaryNodes.size();
 				emit finishedLoadingToGPU();
 			}
 		} else {
@@ -251,12 +286,89 @@ void TerrainLayer::SetData(QString fileLocation)
 }
 
 
+/**
+ * @brief Sets the data of a subdomain layer to be derived from a full domain layer
+ *
+ * Sets the data of a subdomain layer to be derived from a full domain layer that
+ * has already been loaded. The Nodes and Elements are gathered from the full domain
+ * through the py.140 and py.141 mappings instead of being read from fort.14. If the
+ * full domain is not loaded or the mappings can't be used, the fort.14 file is read
+ * as usual.
+ *
+ * @param newSource The loaded full domain TerrainLayer
+ * @param fileLocation The subdomain fort.14 file location
+ * @param newPy140 The subdomain py.140 file location
+ * @param newPy141 The subdomain py.141 file location
+ */
+void TerrainLayer::SetDerivedData(TerrainLayer *newSource, QString fileLocation, QString newPy140, QString newPy141)
+{
+	fort14Location = fileLocation.toStdString();
+	sourceLayer = newSource;
+	py140Location = newPy140;
+	py141Location = newPy141;
+	emit derivedDataValid();
+}
+
+
 bool TerrainLayer::DataLoaded()
 {
 	return fileLoaded;
 }
 
 
+/**
+ * @brief Frees the mesh, the quadtree and the GPU buffers
+ *
+ * Frees the mesh, the quadtree and the GPU buffers, keeping the colors and the
+ * fort.14 location, so the layer can be read again with SetData(). Must not be
+ * called while IsReading() is true. Like the destructor, it must be called with the
+ * OpenGL context current.
+ *
+ */
+void TerrainLayer::UnloadData()
+{
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	glBindVertexArray(0);
+
+	if (VBOId)
+		glDeleteBuffers(1, &VBOId);
+	if (valueVBOId)
+		glDeleteBuffers(1, &valueVBOId);
+	if (IBOId)
+		glDeleteBuffers(1, &IBOId);
+	if (VAOId)
+		glDeleteVertexArrays(1, &VAOId);
+	VAOId = VBOId = IBOId = valueVBOId = 0;
+	glLoaded = false;
+	gpuBytes = 0;
+
+	visibleElementLists.clear();
+	numVisibleElements = 0;
+	if (quadtreeOutline)
+	{
+		delete quadtreeOutline;
+		quadtreeOutline = 0;
+	}
+	if (quadtree)
+	{
+		delete quadtree;
+		quadtree = 0;
+	}
+
+	std::vector<float>().swap(pendingValues);
+	valuesPending = false;
+	valuesVisible = false;
+
+	/* Swap with empty vectors so the memory is actually released */
+	std::vector<Node>().swap(nodes);
+	std::vector<Element>().swap(elements);
+	std::vector<unsigned int>().swap(boundaryNodes);
+	ClearData();
+	dataBytes = 0;
+}
+
+
 /**
  * @brief Getter method that returns the fort.14 location
  * @return The fort.14 absolute path
@@ -428,6 +540,27 @@ std::vector<Element*> TerrainLayer::GetElementsFromPolygon(std::vector<Point> po
 }
 
 
+/**
+ * @brief Finds an evenly spaced sample of the Nodes inside a rectangle
+ * @param l The left bound of the rectangle (normalized)
+ * @param r The right bound of the rectangle (normalized)
+ * @param b The bottom bound of the rectangle (normalized)
+ * @param t The top bound of the rectangle (normalized)
+ * @param spacing The minimum distance between sampled Nodes (normalized)
+ * @return The sampled Nodes
+ */
+std::vector<Node*> TerrainLayer::SampleNodesFromRectangle(float l, float r, float b, float t, float spacing)
+{
+	if (quadtree)
+	{
+		return quadtree->SampleNodesInRectangle(l, r, b, t, spacing);
+	} else {
+		std::vector<Node*> fail;
+		return fail;
+	}
+}
+
+
 /**
  * @brief Get the number of nodes
  * @return The number of nodes
@@ -521,7 +654,7 @@ float TerrainLayer::GetMaxZ()
  */
 float TerrainLayer::GetUnprojectedX(float x)
 {
-	return x*max + midX;
+	return normalizer.DenormalizeX(x);
 }
 
 
@@ -538,7 +671,7 @@ float TerrainLayer::GetUnprojectedX(float x)
  */
 float TerrainLayer::GetUnprojectedY(float y)
 {
-	return y*max + midY;
+	return normalizer.DenormalizeY(y);
 }
 
 
@@ -663,6 +796,40 @@ GLuint TerrainLayer::GetVBOId()
 }
 
 
+/**
+ * @brief Checks if the mesh is being read
+ *
+ * Checks if the mesh is being read. This stays true for a moment after
+ * finishedReadingData() has been emitted, while the fort.14 cache is written.
+ *
+ * @return true if the read task has not finished
+ */
+bool TerrainLayer::IsReading()
+{
+	return readTasks.IsRunning();
+}
+
+
+/**
+ * @brief Returns the estimated memory used by the mesh and the quadtree
+ * @return The memory in bytes, or 0 if no data is loaded
+ */
+qint64 TerrainLayer::GetMemoryUsage()
+{
+	return fileLoaded ? dataBytes : 0;
+}
+
+
+/**
+ * @brief Returns the memory used by the vertex and index buffers on the GPU
+ * @return The memory in bytes, or 0 if nothing has been sent to the GPU
+ */
+qint64 TerrainLayer::GetGPUMemoryUsage()
+{
+	return glLoaded ? gpuBytes : 0;
+}
+
+
 /**
  * @brief Sets the GLCamera object to be used when drawing this Layer
  *
@@ -682,8 +849,77 @@ void TerrainLayer::SetCamera(GLCamera *newCamera)
 		gradientOutline->SetCamera(camera);
 	if (gradientFill)
 		gradientFill->SetCamera(camera);
-	if (quadtree)
-		quadtree->SetCamera(camera);
+	if (valueFill)
+		valueFill->SetCamera(camera);
+	if (quadtreeOutline)
+		quadtreeOutline->SetCamera(camera);
+}
+
+
+/**
+ * @brief Sets the per-vertex values used to color the fill, such as one timestep of fort.63
+ *
+ * Sets the per-vertex values used to color the fill. The values are sent to the GPU
+ * the next time the layer is drawn, so this function can be called without the
+ * OpenGL context being current. The buffer is swapped with the layer's buffer, so
+ * newValues holds the previous values when the function returns and can be reused.
+ * Vector values (such as fort.64) are drawn using their magnitude.
+ *
+ * @param newValues The values, valuesPerNode for each node in node order
+ * @param valuesPerNode The number of values for each node
+ */
+void TerrainLayer::SetNodalValues(std::vector<float> &newValues, unsigned int valuesPerNode)
+{
+	pendingValues.swap(newValues);
+	pendingValuesPerNode = valuesPerNode > 0 ? valuesPerNode : 1;
+	valuesPending = true;
+	valuesVisible = true;
+}
+
+
+/**
+ * @brief Sets the values drawn with the low and high ends of the value gradient
+ * @param newLow The low value
+ * @param newHigh The high value
+ */
+void TerrainLayer::SetNodalValueRange(float newLow, float newHigh)
+{
+	valueLow = newLow;
+	valueHigh = newHigh;
+	if (valueFill)
+		valueFill->SetGradientRange(valueLow, valueHigh);
+}
+
+
+/**
+ * @brief Sets the gradient used to color the fill by the per-vertex values
+ *
+ * Sets the gradient used to color the fill by the per-vertex values. The shader
+ * is owned by the TerrainLayer.
+ *
+ * @param newStops The new gradient stops
+ */
+void TerrainLayer::SetNodalValueGradient(QGradientStops newStops)
+{
+	if (!valueFill)
+	{
+		valueFill = new GradientShader();
+		valueFill->SetCamera(camera);
+		valueFill->SetValueAttribute(true);
+		valueFill->SetGradientRange(valueLow, valueHigh);
+	}
+
+	valueFill->SetGradientStops(newStops);
+}
+
+
+/**
+ * @brief Goes back to drawing the fill without the per-vertex values
+ */
+void TerrainLayer::HideNodalValues()
+{
+	valuesVisible = false;
+	valuesPending = false;
 }
 
 
@@ -709,6 +945,20 @@ void TerrainLayer::SetFort14Location(std::string newLocation)
 }
 
 
+/**
+ * @brief Sets the priority of the task that reads the mesh
+ *
+ * Sets the priority of the task that reads the mesh. Only affects reads that are
+ * started afterwards.
+ *
+ * @param newPriority One of the TASK_PRIORITY_ values
+ */
+void TerrainLayer::SetReadPriority(int newPriority)
+{
+	readPriority = newPriority;
+}
+
+
 /**
  * @brief Sets the solid color used for drawing this Layer's outline
  *
@@ -940,6 +1190,59 @@ void TerrainLayer::UpdateGradientShadersRange()
 }
 
 
+/**
+ * @brief Sends the pending per-vertex values to the GPU
+ *
+ * Sends the pending per-vertex values to the GPU. The value buffer is attribute 1
+ * of the layer's vertex array object and is kept separate from the vertex buffer, so
+ * only one float per node is sent for each timestep. The buffer's storage is orphaned
+ * before each upload so the driver does not have to wait for the previous frame to
+ * finish drawing. Must be called with the layer's vertex array object bound.
+ *
+ */
+void TerrainLayer::UploadNodalValues()
+{
+	valuesPending = false;
+	if (pendingValues.size() < numNodes*pendingValuesPerNode || numNodes == 0)
+		return;
+
+	if (!valueFill)
+	{
+		QGradientStops defaultStops;
+		defaultStops << QGradientStop(0.0, QColor::fromRgb(255, 0, 0));
+		defaultStops << QGradientStop(0.5, QColor::fromRgb(255, 255, 255));
+		defaultStops << QGradientStop(1.0, QColor::fromRgb(0, 0, 255));
+		SetNodalValueGradient(defaultStops);
+	}
+
+	/* Vectors are drawn by magnitude, packed into the front of the buffer */
+	if (pendingValuesPerNode > 1)
+	{
+		for (unsigned int i=0; i<numNodes; ++i)
+		{
+			float magnitude = 0.0;
+			for (unsigned int j=0; j<pendingValuesPerNode; ++j)
+				magnitude += pendingValues[i*pendingValuesPerNode+j]*pendingValues[i*pendingValuesPerNode+j];
+			pendingValues[i] = sqrt(magnitude);
+		}
+	}
+
+	if (!valueVBOId)
+	{
+		glGenBuffers(1, &valueVBOId);
+		glBindBuffer(GL_ARRAY_BUFFER, valueVBOId);
+		glEnableVertexAttribArray(1);
+		glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(GLfloat), 0);
+	} else {
+		glBindBuffer(GL_ARRAY_BUFFER, valueVBOId);
+	}
+
+	const size_t ValueBufferSize = sizeof(GLfloat)*numNodes;
+	glBufferData(GL_ARRAY_BUFFER, ValueBufferSize, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, ValueBufferSize, &pendingValues[0]);
+}
+
+
 /**
  * @brief Function that determines if the domain is large enough to warrant extra GPU optimizations
  *
@@ -1020,52 +1323,68 @@ void TerrainLayer::UpdateVisibleElements()
  * @brief Reads the fort.14 file data
  *
  * This function is used to read data from the fort.14 file. It is implemented as
- * a slot so that it can be part of the signal/slot mechanism used for threading.
- * Typical threaded usage of this function:
- * - Create TerrainLayer object on heap (using new)
- * - Create new QThread
- * - Move the TerrainLayer object to the newly created QThread
- * - Set the fort.14 file when ready to get everything ready for drawing
+ * a slot so that it can be run as a task on the TaskScheduler, which is done when
+ * the fort.14 file is set. If the read is cancelled, the layer is left empty and
+ * failedReadingData() is emitted.
  *
  */
 void TerrainLayer::readFort14()
 {
-	std::ifstream fort14 (fort14Location.data());
+	/* A mesh that has been read before comes back from its binary cache */
+	if (ReadFort14Cache())
+		return;
 
-	if (fort14.is_open())
+	Fort14 fort14 (fort14Location);
+	fort14.SetFlipZValue(flipZValue);
+
+	if (fort14.Open())
 	{
 		emit startedReadingData();
 
-		std::string line;
-		std::getline(fort14, infoLine);
-		std::getline(fort14, line);
-		std::stringstream(line) >> numElements >> numNodes;
+		bool headerValid = fort14.ReadHeader(infoLine);
+		numNodes = fort14.GetNumNodes();
+		numElements = fort14.GetNumElements();
 
 		emit foundNumNodes(numNodes);
 		emit foundNumElements(numElements);
 
 		/* Progress bar stuff */
-		int currentProgress = 0;
-		int totalProgress = CalculateTotalProgress(true, true, true, true, true);
+		unsigned int currentProgress = 0;
+		bool subdomain = fort14.IsSubdomain();
+		unsigned int totalProgress = CalculateTotalProgress(true, true, subdomain, true, true);
 
-		if (numNodes > 0 && numElements > 0)
+		if (headerValid)
 		{
 			nodes.reserve(numNodes);
 			elements.reserve(numElements);
 
 			/* Read all of the nodal data with progress bar enabled */
 			currentProgress = ReadNodalData(numNodes, &fort14, currentProgress, totalProgress);
-
+			if (readTasks.IsCancelled() || nodes.size() != numNodes)
+			{
+				ClearData();
+				emit emitMessage("Error reading fort.14 file");
+				emit failedReadingData();
+				return;
+			}
 
 			/* Read all of the element data with progress bar enabled */
 			currentProgress = ReadElementData(numElements, &fort14, currentProgress, totalProgress);
+			if (readTasks.IsCancelled() || elements.size() != numElements)
+			{
+				ClearData();
+				emit emitMessage("Error reading fort.14 file");
+				emit failedReadingData();
+				return;
+			}
 
 
 			/* Read all of the boundary data if this is a subdomain */
-			currentProgress = ReadBoundaryNodes(&fort14, currentProgress, totalProgress);
+			if (subdomain)
+				currentProgress = ReadBoundaryNodes(&fort14, currentProgress, totalProgress);
 
 			/* All data has been read from fort.14, so close it */
-			fort14.close();
+			fort14.Close();
 			fileLoaded = true;
 
 			/* Calculate normalized coordinates */
@@ -1073,30 +1392,90 @@ void TerrainLayer::readFort14()
 
 
 			// Organize the data in a quadtree
-			if (!quadtree)
-			{
-				quadtree = new Quadtree(nodes, elements, 50, (minX-midX)/max, (maxX-midX)/max, (minY-midY)/max, (maxY-midY)/max);
-				quadtree->SetCamera(camera);
-			}
-
-			CheckForLargeDomain();
-
-			if (largeDomain)
-				visibleElementLists = quadtree->GetElementsThroughDepth(viewingDepth);
+			OrganizeData();
 
+			CalculateMemoryUsage();
 			emit finishedReadingData();
 			emit emitMessage(QString("Terrain layer created: <strong>").append(infoLine.data()).append("</strong>"));
 
+			// Keep a binary copy so the mesh can be read back quickly if it is unloaded
+			Fort14Cache cache (QString::fromStdString(fort14Location));
+			if (!cache.CacheIsCurrent())
+				cache.WriteCache(infoLine, nodes, elements, boundaryNodes);
+
 			DEBUG("x-range:\t" << minX << "\t" << maxX);
 			DEBUG("y-range:\t" << minY << "\t" << maxY);
 			DEBUG("z-range:\t" << minZ << "\t" << maxZ);
 		} else {
 			fileLoaded = false;
 			emit emitMessage("Error reading fort.14 file");
+			emit failedReadingData();
 		}
 	} else {
 		fileLoaded = false;
 		emit emitMessage("Error opening fort.14 file");
+		emit failedReadingData();
+	}
+}
+
+
+/**
+ * @brief Builds a subdomain from the full domain layer
+ *
+ * This function builds a subdomain's Nodes and Elements by gathering them from the
+ * loaded full domain layer through the py.140 and py.141 mappings. Like readFort14(),
+ * it is implemented as a slot so that it runs as a task on the TaskScheduler. Only the
+ * info line is read from the subdomain fort.14 file. The boundary nodes are found from
+ * the full domain Elements in the same way the subdomain was created, so they come out
+ * in the same order as in the subdomain fort.14 file.
+ *
+ * The full domain layer must have finished loading before this runs, which
+ * Domain::LoadFort14File() makes sure of. Falls back to readFort14() if the
+ * subdomain can't be derived.
+ *
+ */
+void TerrainLayer::deriveFromSource()
+{
+	if (!sourceLayer || !sourceLayer->DataLoaded() || !QFile(py140Location).exists() || !QFile(py141Location).exists())
+	{
+		readFort14();
+		return;
+	}
+
+	emit startedReadingData();
+
+	std::ifstream fort14 (fort14Location.data());
+	if (fort14.is_open())
+	{
+		std::getline(fort14, infoLine);
+		fort14.close();
+	}
+
+	std::vector<unsigned int> newToOldNodes = Py140(py140Location).GetNewToOldList();
+	std::vector<unsigned int> newToOldElements = Py141(py141Location).GetNewToOldList();
+	std::vector<unsigned int> oldToNewNodes;
+	emit progress(25);
+
+	if (DeriveNodalData(newToOldNodes, oldToNewNodes) && DeriveElementData(newToOldElements, oldToNewNodes))
+	{
+		emit foundNumNodes(numNodes);
+		emit foundNumElements(numElements);
+		emit progress(50);
+
+		DeriveBoundaryNodes(newToOldElements, oldToNewNodes);
+		fileLoaded = true;
+		emit progress(75);
+
+		NormalizeCoordinates();
+		OrganizeData();
+
+		CalculateMemoryUsage();
+		emit finishedReadingData();
+		emit emitMessage(QString("Terrain layer created from full domain: <strong>").append(infoLine.data()).append("</strong>"));
+	} else {
+		std::cout << "WARNING: Unable to derive subdomain from full domain, reading " << fort14Location << std::endl;
+		ClearData();
+		readFort14();
 	}
 }
 
@@ -1135,195 +1514,347 @@ unsigned int TerrainLayer::CalculateTotalProgress(bool readNodes, bool readEleme
 /**
  * @brief Helper function that reads all Nodal data from a fort.14 file
  *
- * Helper function that reads all Nodal data from a fort.14 file. Compares Nodal coordinates
- * against current min/max values and modifies those values accordingly.
+ * Helper function that reads all Nodal data from a fort.14 file. The Nodes are read
+ * a hundredth at a time, so the progress can be reported and a cancelled read stops
+ * early. The coordinate ranges are taken from the Fort14 reader.
+ *
+ * The reader must already be at the beginning of the nodal list in the fort.14 file.
  *
- * File stream object must already be at the beginning of the nodal list in the fort.14 file.
+ * Emits the current fort.14 processing progress.
  *
  * @param nodeCount The number of Nodes to read
- * @param fileStream File stream located at the beginning of the node list in fort.14
- * @return 0
+ * @param fort14 The reader, located at the beginning of the node list in fort.14
+ * @param currProgress The current progress in processing the fort.14 file
+ * @param totalProgress The value that indicates all of the fort.14 file has processed
+ * @return The progress in processing the fort.14 file after the nodal data has been read
  */
-unsigned int TerrainLayer::ReadNodalData(unsigned int nodeCount, std::ifstream *fileStream)
+unsigned int TerrainLayer::ReadNodalData(unsigned int nodeCount, Fort14 *fort14, unsigned int currProgress, unsigned int totalProgress)
 {
-	return ReadNodalData(nodeCount, fileStream, 0, 0);
+	unsigned int pieceSize = nodeCount/100 + 1;
+	while (nodes.size() < nodeCount && !readTasks.IsCancelled())
+	{
+		unsigned int numRead = fort14->ReadNodes(nodes, std::min(pieceSize, nodeCount - (unsigned int)nodes.size()));
+		if (!numRead)
+			break;
+
+		currProgress += numRead;
+		if (totalProgress)
+			emit progress(100.0*currProgress/totalProgress);
+	}
+
+	minX = fort14->GetMinX();
+	maxX = fort14->GetMaxX();
+	minY = fort14->GetMinY();
+	maxY = fort14->GetMaxY();
+	minZ = fort14->GetMinZ();
+	maxZ = fort14->GetMaxZ();
+	UpdateGradientShadersRange();
+
+	return currProgress;
 }
 
 
 /**
- * @brief Helper function that reads all Nodal data from a fort.14 file
+ * @brief Helper function that reads all Element data from the fort.14 file
  *
- * Helper function that reads all Nodal data from a fort.14 file. Compares Nodal coordinates
- * against current min/max values and modifies those values accordingly.
+ * Helper function that reads all Element data from the fort.14 file, a hundredth at
+ * a time like ReadNodalData().
  *
- * File stream object must already be at the beginning of the nodal list in the fort.14 file.
+ * The reader must already be at the beginning of the element list in the fort.14 file.
  *
  * Emits the current fort.14 processing progress.
  *
- * @param nodeCount The number of Nodes to read
- * @param fileStream File stream located at the beginning of the node list in fort.14
+ * @param elementCount The number of Elements to read
+ * @param fort14 The reader, located at the beginning of the element list in the fort.14 file
  * @param currProgress The current progress in processing the fort.14 file
  * @param totalProgress The value that indicates all of the fort.14 file has processed
- * @return The progress in processing the fort.14 file after the nodal data has been read
+ * @return The progress in processing the fort.14 file after the element data has been read
  */
-unsigned int TerrainLayer::ReadNodalData(unsigned int nodeCount, std::ifstream *fileStream, unsigned int currProgress, unsigned int totalProgress)
+unsigned int TerrainLayer::ReadElementData(unsigned int elementCount, Fort14 *fort14, unsigned int currProgress, unsigned int totalProgress)
 {
-	Node currNode;
-	for (unsigned int i=0; i<nodeCount; i++)
+	unsigned int pieceSize = elementCount/100 + 1;
+	while (elements.size() < elementCount && !readTasks.IsCancelled())
 	{
-		*fileStream >> currNode.nodeNumber;
-		*fileStream >> currNode.xDat;
-		*fileStream >> currNode.yDat;
-		*fileStream >> currNode.zDat;
-		currNode.x = atof(currNode.xDat.data());
-		currNode.y = atof(currNode.yDat.data());
-		currNode.z = atof(currNode.zDat.data());
-//		*fileStream >> currNode.x;
-//		*fileStream >> currNode.y;
-//		*fileStream >> currNode.z;
-
-		// Check against min/max values and flip the z-value if needed
+		unsigned int numRead = fort14->ReadElements(elements, nodes, std::min(pieceSize, elementCount - (unsigned int)elements.size()));
+		if (!numRead)
+			break;
+
+		currProgress += numRead;
+		if (totalProgress)
+			emit progress(100.0*currProgress/totalProgress);
+	}
+	return currProgress;
+}
+
+
+/**
+ * @brief Helper function that reads the list of boundary nodes from the fort.14 file
+ *
+ * Helper function that reads the list of boundary nodes from the fort.14 file.
+ *
+ * The reader must already be at the beginning of the list of boundaries in the fort.14 file.
+ *
+ * Emits the current fort.14 processing progress.
+ *
+ * @param fort14 The reader, located at the beginning of the list of boundaries in the fort.14 file
+ * @param currProgress The current progress in processing the fort.14 file
+ * @param totalProgress The value that indicates all of the fort.14 file has processed
+ * @return The progress in processing the fort.14 file after the boundary data has been read
+ */
+unsigned int TerrainLayer::ReadBoundaryNodes(Fort14 *fort14, unsigned int currProgress, unsigned int totalProgress)
+{
+	fort14->ReadBoundaryNodes(boundaryNodes);
+	currProgress += BOUNDARY_PROGRESS_VALUE;
+	if (totalProgress)
+		emit progress(100.0*currProgress/totalProgress);
+	return currProgress;
+}
+
+
+/**
+ * @brief Helper function that gathers all Nodal data from the full domain layer
+ *
+ * Helper function that gathers all Nodal data from the full domain layer and renumbers
+ * it using the subdomain numbering. Compares Nodal coordinates against current min/max
+ * values and modifies those values accordingly. The full domain z-values have already
+ * been flipped if needed.
+ *
+ * @param newToOldNodes The dense subdomain to full domain node mapping
+ * @param oldToNewNodes Filled with the dense full domain to subdomain node mapping
+ * @return true if every Node was found in the full domain
+ */
+bool TerrainLayer::DeriveNodalData(std::vector<unsigned int> &newToOldNodes, std::vector<unsigned int> &oldToNewNodes)
+{
+	numNodes = newToOldNodes.size();
+	if (numNodes == 0)
+		return false;
+
+	nodes.reserve(numNodes);
+	oldToNewNodes.assign(sourceLayer->GetNumNodes()+1, 0);
+	for (unsigned int i=0; i<numNodes; i++)
+	{
+		Node *sourceNode = sourceLayer->GetNode(newToOldNodes[i]);
+		if (!sourceNode)
+			return false;
+
+		Node currNode = *sourceNode;
+		currNode.nodeNumber = i+1;
 		if (currNode.x < minX)
 			minX = currNode.x;
-		else if (currNode.x > maxX)
+		if (currNode.x > maxX)
 			maxX = currNode.x;
 		if (currNode.y < minY)
 			minY = currNode.y;
-		else if (currNode.y > maxY)
+		if (currNode.y > maxY)
 			maxY = currNode.y;
-		if (flipZValue)
-			currNode.z *= -1.0;
 		if (currNode.z < minZ)
 			minZ = currNode.z;
-		else if (currNode.z > maxZ)
+		if (currNode.z > maxZ)
 			maxZ = currNode.z;
 		nodes.push_back(currNode);
-		if (totalProgress)
-			emit progress(100*(++currProgress)/totalProgress);
+
+		if (newToOldNodes[i] >= oldToNewNodes.size())
+			oldToNewNodes.resize(newToOldNodes[i]+1, 0);
+		oldToNewNodes[newToOldNodes[i]] = i+1;
 	}
 
 	UpdateGradientShadersRange();
 
-	return currProgress;
+	return true;
 }
 
 
 /**
- * @brief Helper function that reads all Element data from the fort.14 file
- *
- * Helper function that reads all Element data from the fort.14 file.
+ * @brief Helper function that gathers all Element data from the full domain layer
  *
- * File stream object must already be at the beginning of the element list in the fort.14 file.
+ * Helper function that gathers all Element data from the full domain layer and points
+ * each Element at the renumbered subdomain Nodes. Must be called after DeriveNodalData().
  *
- * @param elementCount The number of Elements to read
- * @param fileStream File stream located at the beginning of the element list in the fort.14 file
- * @return 0
+ * @param newToOldElements The dense subdomain to full domain element mapping
+ * @param oldToNewNodes The dense full domain to subdomain node mapping
+ * @return true if every Element and its Nodes were found
  */
-unsigned int TerrainLayer::ReadElementData(unsigned int elementCount, std::ifstream *fileStream)
+bool TerrainLayer::DeriveElementData(std::vector<unsigned int> &newToOldElements, std::vector<unsigned int> &oldToNewNodes)
 {
-	return ReadElementData(elementCount, fileStream, 0, 0);
+	numElements = newToOldElements.size();
+	if (numElements == 0)
+		return false;
+
+	elements.reserve(numElements);
+	Element currElement;
+	for (unsigned int i=0; i<numElements; i++)
+	{
+		Element *sourceElement = sourceLayer->GetElement(newToOldElements[i]);
+		if (!sourceElement || !sourceElement->n1 || !sourceElement->n2 || !sourceElement->n3)
+			return false;
+
+		unsigned int n1 = sourceElement->n1->nodeNumber;
+		unsigned int n2 = sourceElement->n2->nodeNumber;
+		unsigned int n3 = sourceElement->n3->nodeNumber;
+		if (n1 >= oldToNewNodes.size() || n2 >= oldToNewNodes.size() || n3 >= oldToNewNodes.size() ||
+		    !oldToNewNodes[n1] || !oldToNewNodes[n2] || !oldToNewNodes[n3])
+			return false;
+
+		currElement.elementNumber = i+1;
+		currElement.n1 = &nodes[oldToNewNodes[n1]-1];
+		currElement.n2 = &nodes[oldToNewNodes[n2]-1];
+		currElement.n3 = &nodes[oldToNewNodes[n3]-1];
+		elements.push_back(currElement);
+	}
+	return true;
 }
 
 
 /**
- * @brief Helper function that reads all Element data from the fort.14 file
- *
- * Helper function that reads all Element data from the fort.14 file.
- *
- * File stream object must already be at the beginning of the element list in the fort.14 file.
+ * @brief Helper function that finds the boundary nodes of a derived subdomain
  *
- * Emits the current fort.14 processing progress.
+ * Helper function that finds the boundary nodes of a derived subdomain. The boundary
+ * is found from the full domain Elements, which is how the subdomain fort.14 boundary
+ * was created, and is then renumbered. The closing node that repeats the first node is
+ * dropped, as it is when the boundary is read from fort.14.
  *
- * @param elementCount The number of Elements to read
- * @param fileStream File stream located at the beginning of the element list in the fort.14 file
- * @param currProgress The current progress in processing the fort.14 file
- * @param totalProgress The value that indicates all of the fort.14 file has processed
- * @return The progress in processing the fort.14 file after the element data has been read
+ * @param newToOldElements The dense subdomain to full domain element mapping
+ * @param oldToNewNodes The dense full domain to subdomain node mapping
  */
-unsigned int TerrainLayer::ReadElementData(unsigned int elementCount, std::ifstream *fileStream, unsigned int currProgress, unsigned int totalProgress)
+void TerrainLayer::DeriveBoundaryNodes(std::vector<unsigned int> &newToOldElements, std::vector<unsigned int> &oldToNewNodes)
 {
-	Element currElement;
-	int trash, currNodeNumber;
-	for (unsigned int i=0; i<elementCount; i++)
+	std::vector<Element*> sourceElements;
+	sourceElements.reserve(newToOldElements.size());
+	for (std::vector<unsigned int>::iterator it = newToOldElements.begin(); it != newToOldElements.end(); ++it)
+		sourceElements.push_back(sourceLayer->GetElement(*it));
+
+	BoundaryFinder boundaryFinder;
+	std::vector<unsigned int> oldBoundaryNodes = boundaryFinder.FindBoundaries(&sourceElements);
+	if (oldBoundaryNodes.size() > 1 && oldBoundaryNodes.front() == oldBoundaryNodes.back())
+		oldBoundaryNodes.pop_back();
+
+	boundaryNodes.clear();
+	for (std::vector<unsigned int>::iterator it = oldBoundaryNodes.begin(); it != oldBoundaryNodes.end(); ++it)
 	{
-		*fileStream >> currElement.elementNumber;
-		*fileStream >> trash;
-		*fileStream >> currNodeNumber;
-		currElement.n1 = GetNode(currNodeNumber);
-		*fileStream >> currNodeNumber;
-		currElement.n2 = GetNode(currNodeNumber);
-		*fileStream >> currNodeNumber;
-		currElement.n3 = GetNode(currNodeNumber);
-		elements.push_back(currElement);
-		if (totalProgress)
-			emit progress(100*(++currProgress)/totalProgress);
+		if (*it < oldToNewNodes.size() && oldToNewNodes[*it])
+			boundaryNodes.push_back(oldToNewNodes[*it]);
 	}
-	return currProgress;
 }
 
 
 /**
- * @brief Helper function that reads the list of boundary nodes from the fort.14 file
- *
- * Helper function that reads the list of boundary nodes from the fort.14 file.
+ * @brief Reads the mesh from the binary cache written the last time fort.14 was read
  *
- * File stream object must already be at the beginning of the list of boundaries in the fort.14 file.
+ * Reads the mesh from the binary cache written the last time fort.14 was read,
+ * which is much faster than parsing the text. Like readFort14(), it runs as a task
+ * on the TaskScheduler.
  *
- * @param fileStream File stream located at the beginning of the list of boundaries in the fort.14 file
- * @return 0
+ * @return true if the mesh was read from the cache
  */
-unsigned int TerrainLayer::ReadBoundaryNodes(std::ifstream *fileStream)
+bool TerrainLayer::ReadFort14Cache()
 {
-	return ReadBoundaryNodes(fileStream, 0, 0);
+	Fort14Cache cache (QString::fromStdString(fort14Location));
+	if (!cache.CacheIsCurrent())
+		return false;
+
+	emit startedReadingData();
+	if (!cache.ReadCache(infoLine, nodes, elements, boundaryNodes))
+	{
+		ClearData();
+		return false;
+	}
+
+	numNodes = nodes.size();
+	numElements = elements.size();
+	emit foundNumNodes(numNodes);
+	emit foundNumElements(numElements);
+	emit progress(50);
+
+	for (std::vector<Node>::iterator it = nodes.begin(); it != nodes.end(); ++it)
+	{
+		if (it->x < minX)
+			minX = it->x;
+		if (it->x > maxX)
+			maxX = it->x;
+		if (it->y < minY)
+			minY = it->y;
+		if (it->y > maxY)
+			maxY = it->y;
+		if (it->z < minZ)
+			minZ = it->z;
+		if (it->z > maxZ)
+			maxZ = it->z;
+	}
+	UpdateGradientShadersRange();
+	fileLoaded = true;
+	emit progress(75);
+
+	NormalizeCoordinates();
+	OrganizeData();
+
+	CalculateMemoryUsage();
+	emit finishedReadingData();
+	emit emitMessage(QString("Terrain layer created from cache: <strong>").append(infoLine.data()).append("</strong>"));
+	return true;
 }
 
 
 /**
- * @brief Helper function that reads the list of boundary nodes from the fort.14 file
+ * @brief Estimates the memory used by the mesh and the quadtree
  *
- * Helper function that reads the list of boundary nodes from the fort.14 file.
- *
- * File stream object must already be at the beginning of the list of boundaries in the fort.14 file.
+ * Estimates the memory used by the mesh and the quadtree. The quadtree keeps its
+ * own copy of every Node and Element, along with lists of pointers to them in its
+ * leaves. Called by the read task once reading has finished, so the estimate
+ * is ready by the time finishedReadingData() is received.
  *
- * Emits the current fort.14 processing progress.
- *
- * @param fileStream File stream located at the beginning of the list of boundaries in the fort.14 file
- * @param currProgress The current progress in processing the fort.14 file
- * @param totalProgress The value that indicates all of the fort.14 file has processed
- * @return The progress in processing the fort.14 file after the boundary data has been read
  */
-unsigned int TerrainLayer::ReadBoundaryNodes(std::ifstream *fileStream, unsigned int currProgress, unsigned int totalProgress)
-{
-	std::string line;
-	int numSegments, numBoundaryNodes, finalProgressValue;
-	finalProgressValue = currProgress + BOUNDARY_PROGRESS_VALUE;
-	std::getline(*fileStream, line);
-	std::getline(*fileStream, line);
-	std::stringstream(line) >> numSegments;
-	std::getline(*fileStream, line);
-	std::stringstream(line) >> numBoundaryNodes;
-	if (numSegments == 1)
-	{
-		int numNextBoundaryNodes, nextNodeNumber;
-		*fileStream >> numNextBoundaryNodes;
-		int progressPointSize = BOUNDARY_PROGRESS_VALUE/numNextBoundaryNodes;
-		for (int i=0; i<numNextBoundaryNodes; i++)
-		{
-			*fileStream >> nextNodeNumber;
-			boundaryNodes.push_back(nextNodeNumber);
-			if (totalProgress)
-			{
-				currProgress += progressPointSize;
-				emit progress(100*(currProgress)/totalProgress);
-			}
-		}
-	}
-	else if (totalProgress)
+void TerrainLayer::CalculateMemoryUsage()
+{
+	qint64 stringBytes = 0;
+	for (std::vector<Node>::iterator it = nodes.begin(); it != nodes.end(); ++it)
 	{
-		emit progress(finalProgressValue);
-		return finalProgressValue;
+		/* Short strings are stored inside the string object itself */
+		if (it->xDat.capacity() >= sizeof(std::string))
+			stringBytes += it->xDat.capacity();
+		if (it->yDat.capacity() >= sizeof(std::string))
+			stringBytes += it->yDat.capacity();
+		if (it->zDat.capacity() >= sizeof(std::string))
+			stringBytes += it->zDat.capacity();
 	}
-	return currProgress;
+
+	qint64 meshBytes = nodes.size()*sizeof(Node) + stringBytes + elements.size()*sizeof(Element);
+	qint64 quadtreeBytes = quadtree ? meshBytes + (nodes.size() + elements.size())*sizeof(void*) : 0;
+	dataBytes = (qint64)(nodes.capacity() - nodes.size())*sizeof(Node) +
+		    (qint64)(elements.capacity() - elements.size())*sizeof(Element) +
+		    boundaryNodes.capacity()*sizeof(unsigned int) +
+		    meshBytes + quadtreeBytes;
+}
+
+
+void TerrainLayer::queueRead()
+{
+	TaskScheduler::Instance()->Start(this, "readFort14", readPriority, &readTasks);
+}
+
+
+void TerrainLayer::queueDerive()
+{
+	TaskScheduler::Instance()->Start(this, "deriveFromSource", readPriority, &readTasks);
+}
+
+
+/**
+ * @brief Helper function that discards any partially loaded data
+ */
+void TerrainLayer::ClearData()
+{
+	nodes.clear();
+	elements.clear();
+	boundaryNodes.clear();
+	numNodes = 0;
+	numElements = 0;
+	minX = 99999.0;
+	maxX = -99999.0;
+	minY = 99999.0;
+	maxY = -99999.0;
+	minZ = 99999.0;
+	maxZ = -99999.0;
+	fileLoaded = false;
 }
 
 
@@ -1353,17 +1884,35 @@ unsigned int TerrainLayer::NormalizeCoordinates()
  */
 unsigned int TerrainLayer::NormalizeCoordinates(unsigned int currProgress, unsigned int totalProgress)
 {
-	midX = minX + (maxX - minX) / 2.0;
-	midY = minY + (maxY - minY) / 2.0;
-	max = fmax(maxX-minX, maxY-minY);
+	normalizer.SetExtents(minX, maxX, minY, maxY, minZ, maxZ);
 	for (unsigned int i=0; i<numNodes; i++)
 	{
-		nodes[i].normX = (nodes[i].x - midX)/max;
-		nodes[i].normY = (nodes[i].y - midY)/max;
-		nodes[i].normZ = nodes[i].z / (maxZ-minZ);
+		normalizer.NormalizeNode(nodes[i]);
 		if (totalProgress)
 			emit progress(100*(++currProgress)/totalProgress);
 	}
 	return currProgress;
 }
 
+
+/**
+ * @brief Helper function that organizes the loaded data for drawing and searching
+ *
+ * Helper function that organizes the loaded data in a Quadtree and, for large domains,
+ * finds the initial list of visible Elements. Normalized coordinates must already have
+ * been calculated.
+ *
+ */
+void TerrainLayer::OrganizeData()
+{
+	if (!quadtree)
+	{
+		quadtree = new Quadtree(nodes, elements, 50, normalizer.GetNormalizedMinX(), normalizer.GetNormalizedMaxX(),
+					normalizer.GetNormalizedMinY(), normalizer.GetNormalizedMaxY());
+	}
+
+	CheckForLargeDomain();
+
+	if (largeDomain)
+		visibleElementLists = quadtree->GetElementsThroughDepth(viewingDepth);
+}
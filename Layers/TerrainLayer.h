@@ -2,17 +2,26 @@
 #define TERRAINLAYER_H
 
 #include "Quadtree/Quadtree.h"
+#include "Quadtree/MeshNormalizer.h"
 #include "Layer.h"
+#include "OpenGL/QuadtreeOutline.h"
 #include "OpenGL/Shaders/GLShader.h"
 #include "OpenGL/Shaders/SolidShader.h"
 #include "OpenGL/Shaders/GradientShader.h"
 #include "OpenGL/Shaders/CulledSolidShader.h"
+#include "SubdomainTools/BoundaryFinder.h"
+#include "Projects/IO/FileIO/Py140.h"
+#include "Projects/IO/FileIO/Py141.h"
+#include "Projects/IO/FileIO/Fort14.h"
+#include "Projects/IO/FileIO/Fort14Cache.h"
+#include "Tasks/TaskScheduler.h"
 
 #include <string>
 #include <vector>
 #include <fstream>
 #include <sstream>
-#include <QThread>
+#include <cmath>
+#include <algorithm>
 
 #define BOUNDARY_PROGRESS_VALUE 100
 #define QUADTREE_PROGRESS_VALUE 10000
@@ -25,6 +34,18 @@
  * capable of reading the file, storing the data, and quickly accessing and drawing the
  * data as needed.
  *
+ * A subdomain can also be derived from an already loaded full domain TerrainLayer
+ * instead of reading its own fort.14 file. Every subdomain Node and Element is
+ * gathered from the full domain through the py.140 and py.141 mappings, which is
+ * much faster than parsing the text of fort.14. The subdomain still gets its own
+ * normalized coordinates and vertex buffer, since both depend on its own extents
+ * and numbering.
+ *
+ * The mesh is read by a task on the TaskScheduler, with the priority set by
+ * SetReadPriority(). The layer itself stays in the GUI thread. The parsing is done
+ * by Fort14 and the searching by Quadtree, which don't depend on Qt or OpenGL and
+ * are shared with the tools that run without a display.
+ *
  */
 class TerrainLayer : public Layer
 {
@@ -39,7 +60,9 @@ class TerrainLayer : public Layer
 		virtual void	Draw();
 		virtual void	LoadDataToGPU();
 		virtual void	SetData(QString fileLocation);
+		void		SetDerivedData(TerrainLayer *newSource, QString fileLocation, QString newPy140, QString newPy141);
 		virtual bool	DataLoaded();
+		void		UnloadData();
 
 		/* Getter Methods */
 		std::string		GetFort14Location();
@@ -52,6 +75,7 @@ class TerrainLayer : public Layer
 		std::vector<Element*>	GetElementsFromCircle(float x, float y, float radius);
 		std::vector<Element*>	GetElementsFromRectangle(float l, float r, float b, float t);
 		std::vector<Element*>	GetElementsFromPolygon(std::vector<Point> polyLine);
+		std::vector<Node*>	SampleNodesFromRectangle(float l, float r, float b, float t, float spacing);
 		unsigned int		GetNumNodes();
 		unsigned int		GetNumElements();
 		float			GetMinX();
@@ -71,10 +95,14 @@ class TerrainLayer : public Layer
 		QGradientStops		GetGradientFill();
 		QGradientStops		GetGradientBoundary();
 		GLuint			GetVBOId();
+		qint64			GetMemoryUsage();
+		qint64			GetGPUMemoryUsage();
+		bool			IsReading();
 
 		/* Setter Methods */
 		virtual void	SetCamera(GLCamera *newCamera);
 		void		SetFort14Location(std::string newLocation);
+		void		SetReadPriority(int newPriority);
 		void		SetSolidOutline(QColor newColor);
 		void		SetSolidFill(QColor newColor);
 		void		SetSolidBoundary(QColor newColor);
@@ -82,6 +110,12 @@ class TerrainLayer : public Layer
 		void		SetGradientFill(QGradientStops newStops);
 		void		SetGradientBoundary(QGradientStops newStops);
 
+		/* Per-Vertex Value Methods */
+		void		SetNodalValues(std::vector<float> &newValues, unsigned int valuesPerNode=1);
+		void		SetNodalValueRange(float newLow, float newHigh);
+		void		SetNodalValueGradient(QGradientStops newStops);
+		void		HideNodalValues();
+
 		/* Visibility Methods */
 		void	ToggleQuadtreeVisible();
 
@@ -103,14 +137,12 @@ class TerrainLayer : public Layer
 
 		/* Coordinate Properties */
 		float			minX;		/**< The minimum x-value */
-		float			midX;		/**< The calculated center of the x-values */
 		float			maxX;		/**< The maximum x-value */
 		float			minY;		/**< The minimum y-value */
-		float			midY;		/**< the calculated center of the y-values */
 		float			maxY;		/**< The maximum y-value */
 		float			minZ;		/**< The minimum z-value */
 		float			maxZ;		/**< The maximum z-value */
-		float			max;		/**< The maximum of the width/height of the domain */
+		MeshNormalizer		normalizer;	/**< Converts between fort.14 coordinates and OpenGL space */
 
 		/* All shaders needed to draw a terrain layer */
 		GLShader*	outlineShader;		/**< Pointer to the GLShader object that will be used to draw the outline */
@@ -121,6 +153,15 @@ class TerrainLayer : public Layer
 		GLuint		VAOId;			/**< The vertex array object ID in the OpenGL context */
 		GLuint		VBOId;			/**< The vertex buffer object ID in the OpenGL context */
 		GLuint		IBOId;			/**< The index buffer object ID in the OpenGL context */
+		GLuint		valueVBOId;		/**< The per-vertex value buffer object ID in the OpenGL context */
+
+		/* Per-vertex values drawn over the terrain, such as water elevation from fort.63 */
+		std::vector<float>	pendingValues;		/**< Values waiting to be sent to the GPU on the next Draw() */
+		unsigned int		pendingValuesPerNode;	/**< Number of values per node in pendingValues */
+		bool			valuesPending;		/**< Flag that shows if pendingValues needs to be sent to the GPU */
+		bool			valuesVisible;		/**< Flag that shows if the fill is colored by the per-vertex values */
+		float			valueLow;		/**< The value drawn with the low end of the value gradient */
+		float			valueHigh;		/**< The value drawn with the high end of the value gradient */
 
 		// Flags
 		bool	flipZValue;		/**< Flag that determines if the z-value is multiplied by -1 before being loaded to the GPU */
@@ -128,13 +169,27 @@ class TerrainLayer : public Layer
 		bool	glLoaded;		/**< Flag that shows if data has been successfully sent to the GPU */
 		bool	largeDomain;		/**< Flag that shows if the domain is extremely large (probably a full domain) */
 
+		/* Memory Use */
+		qint64	dataBytes;		/**< Estimated memory used by the mesh and quadtree, set when reading finishes */
+		qint64	gpuBytes;		/**< Memory used by the vertex and index buffers on the GPU */
+
 		/* Quadtree and Large Domain Variables */
-		Quadtree*	quadtree;	/**< The quadtree used for Node picking */
-		bool		drawQuadtreeOutline;	/**< Flag that shows if we want to draw the quadtree outline */
+		Quadtree*		quadtree;		/**< The quadtree used for Node picking */
+		QuadtreeOutline*	quadtreeOutline;	/**< Draws the quadtree, created the first time it is shown */
+		bool			drawQuadtreeOutline;	/**< Flag that shows if we want to draw the quadtree outline */
 		std::vector<std::vector<Element*>*>	visibleElementLists;	/**< The list of lists elements that are currently visible */
 		int					numVisibleElements;	/**< The total number of elements that are currently visible */
 		int					viewingDepth;
 
+		/* Reading on the TaskScheduler */
+		TaskGroup	readTasks;	/**< The task reading or deriving the mesh */
+		int		readPriority;	/**< One of the TASK_PRIORITY_ values */
+
+		/* Derived subdomain loading */
+		TerrainLayer*	sourceLayer;	/**< The full domain layer that a subdomain is derived from */
+		QString		py140Location;	/**< The subdomain to full domain node mapping */
+		QString		py141Location;	/**< The subdomain to full domain element mapping */
+
 	private:
 
 		bool		useCulledShaders;	/**< Flag that tells us if we need to use culled shaders */
@@ -144,34 +199,49 @@ class TerrainLayer : public Layer
 		GradientShader*	gradientOutline;	/**< Shader used to draw a gradient outline */
 		GradientShader*	gradientFill;		/**< Shader used to draw a gradient fill */
 		GradientShader*	gradientBoundary;	/**< Shader used to draw a gradient boundary */
+		GradientShader*	valueFill;		/**< Shader used to draw a fill colored by the per-vertex values */
 
 		void	SwitchToCulledShaders();
 		void	UpdateGradientShadersRange();
 		void	CheckForLargeDomain();
 		void	UpdateVisibleElements();
+		void	UploadNodalValues();
 
 		/* File Reading Methods */
 		unsigned int	CalculateTotalProgress(bool readNodes, bool readElements, bool readBoundaries, bool normalizeCoordinates, bool createQuadtree);
-		unsigned int	ReadNodalData(unsigned int nodeCount, std::ifstream* fileStream);
-		unsigned int	ReadNodalData(unsigned int nodeCount, std::ifstream *fileStream, unsigned int currProgress, unsigned int totalProgress);
-		unsigned int	ReadElementData(unsigned int elementCount, std::ifstream* fileStream);
-		unsigned int	ReadElementData(unsigned int elementCount, std::ifstream *fileStream, unsigned int currProgress, unsigned int totalProgress);
-		unsigned int	ReadBoundaryNodes(std::ifstream *fileStream);
-		unsigned int	ReadBoundaryNodes(std::ifstream *fileStream, unsigned int currProgress, unsigned int totalProgress);
+		unsigned int	ReadNodalData(unsigned int nodeCount, Fort14 *fort14, unsigned int currProgress, unsigned int totalProgress);
+		unsigned int	ReadElementData(unsigned int elementCount, Fort14 *fort14, unsigned int currProgress, unsigned int totalProgress);
+		unsigned int	ReadBoundaryNodes(Fort14 *fort14, unsigned int currProgress, unsigned int totalProgress);
+
+		/* Derived Loading Methods */
+		bool		DeriveNodalData(std::vector<unsigned int> &newToOldNodes, std::vector<unsigned int> &oldToNewNodes);
+		bool		DeriveElementData(std::vector<unsigned int> &newToOldElements, std::vector<unsigned int> &oldToNewNodes);
+		void		DeriveBoundaryNodes(std::vector<unsigned int> &newToOldElements, std::vector<unsigned int> &oldToNewNodes);
+		void		ClearData();
+		bool		ReadFort14Cache();
+		void		CalculateMemoryUsage();
 
 		/* Data Processing Methods */
 		unsigned int	NormalizeCoordinates();
 		unsigned int	NormalizeCoordinates(unsigned int currProgress, unsigned int totalProgress);
+		void		OrganizeData();
 
 	public slots:
 
-		// Slots used for work that needs to be performed on a worker thread
+		// Slots that are run as tasks on the TaskScheduler
 		void	readFort14();		/**< Reads the fort.14 file */
+		void	deriveFromSource();	/**< Builds a subdomain from the full domain layer */
+
+	private slots:
+
+		void	queueRead();
+		void	queueDerive();
 
 	signals:
 
 		// Signals used during threaded reading of fort.14
 		void	fort14Valid();
+		void	derivedDataValid();
 		void	foundNumNodes(int);
 		void	foundNumElements(int);
 		void	finishedLoadingToGPU();
@@ -0,0 +1,301 @@
+#include "VelocityLayer.h"
+
+VelocityLayer::VelocityLayer()
+{
+	terrainLayer = 0;
+	sampleSpacing = 0.0;
+	maxSpeed = 0.0;
+
+	glyphShader = 0;
+	VAOId = 0;
+	shapeVBOId = 0;
+	instanceVBOId = 0;
+	numInstances = 0;
+
+	glLoaded = false;
+	viewChanged = true;
+	instancesPending = false;
+}
+
+
+VelocityLayer::~VelocityLayer()
+{
+	DEBUG("Deleting Velocity Layer. Layer ID: " << GetID());
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	if (glyphShader)
+		delete glyphShader;
+
+	if (shapeVBOId)
+		glDeleteBuffers(1, &shapeVBOId);
+	if (instanceVBOId)
+		glDeleteBuffers(1, &instanceVBOId);
+	if (VAOId)
+		glDeleteVertexArrays(1, &VAOId);
+}
+
+
+/**
+ * @brief Draws an arrow at each sampled Node
+ *
+ * Draws an arrow at each sampled Node. If the view has changed since the last draw,
+ * the Nodes are sampled again first. If the Nodes or the velocities have changed, the
+ * instance buffer is rebuilt. All of the arrows are drawn with a single instanced
+ * draw call.
+ *
+ */
+void VelocityLayer::Draw()
+{
+	if (!glLoaded)
+		LoadDataToGPU();
+
+	if (glLoaded && glyphShader && DataLoaded())
+	{
+		glBindVertexArray(VAOId);
+
+		if (viewChanged)
+			SampleVisibleNodes();
+		if (instancesPending)
+			UploadInstances();
+
+		if (numInstances && glyphShader->Use())
+			glDrawArraysInstanced(GL_LINES, 0, 6, numInstances);
+
+		glBindVertexArray(0);
+		glUseProgram(0);
+	}
+}
+
+
+/**
+ * @brief Sends the arrow shape to the GPU and sets up the instance buffer
+ *
+ * Sends the arrow shape to the GPU and sets up the instance buffer. The shape is
+ * a shaft along +x with a length of one and two lines for the head. Attributes 1 and 2
+ * advance once per arrow instead of once per vertex.
+ *
+ */
+void VelocityLayer::LoadDataToGPU()
+{
+	GLfloat arrowShape[12] = {0.0,	0.0,	1.0,	0.0,
+				  1.0,	0.0,	0.75,	0.2,
+				  1.0,	0.0,	0.75,	-0.2};
+
+	if (VAOId)
+		return;
+
+	if (!glyphShader)
+	{
+		glyphShader = new GlyphShader();
+		if (camera)
+			glyphShader->SetCamera(camera);
+	}
+
+	glGenVertexArrays(1, &VAOId);
+	glGenBuffers(1, &shapeVBOId);
+	glGenBuffers(1, &instanceVBOId);
+
+	glBindVertexArray(VAOId);
+
+	glBindBuffer(GL_ARRAY_BUFFER, shapeVBOId);
+	glBufferData(GL_ARRAY_BUFFER, sizeof(arrowShape), arrowShape, GL_STATIC_DRAW);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2*sizeof(GLfloat), 0);
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBOId);
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, 4*sizeof(GLfloat), 0);
+	glVertexAttribDivisor(1, 1);
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 4*sizeof(GLfloat), (GLvoid*)(2*sizeof(GLfloat)));
+	glVertexAttribDivisor(2, 1);
+
+	glBindVertexArray(0);
+
+	GLenum errorCheck = glGetError();
+	if (errorCheck == GL_NO_ERROR)
+	{
+		if (VAOId && shapeVBOId && instanceVBOId)
+		{
+			glLoaded = true;
+			emit finishedLoadingToGPU();
+		}
+	} else {
+		const GLubyte *errString = gluErrorString(errorCheck);
+		DEBUG("OpenGL Error: " << errString);
+		glLoaded = false;
+	}
+}
+
+
+/**
+ * @brief Not used. Velocities are set with SetVelocities().
+ */
+void VelocityLayer::SetData(QString)
+{
+
+}
+
+
+bool VelocityLayer::DataLoaded()
+{
+	return terrainLayer && velocities.size() >= 2*terrainLayer->GetNumNodes() && velocities.size() > 0;
+}
+
+
+void VelocityLayer::SetCamera(GLCamera *newCamera)
+{
+	camera = newCamera;
+	if (glyphShader)
+		glyphShader->SetCamera(newCamera);
+	viewChanged = true;
+}
+
+
+void VelocityLayer::SetTerrainLayer(TerrainLayer *newLayer)
+{
+	terrainLayer = newLayer;
+	sampleNodes.clear();
+	sampleLocations.clear();
+	maxSpeed = 0.0;
+	viewChanged = true;
+}
+
+
+/**
+ * @brief Sets the velocities of the next timestep to be drawn
+ *
+ * Sets the velocities of the next timestep to be drawn. The buffers are swapped,
+ * so the caller gets back the buffer of the previous timestep to reuse.
+ *
+ * @param newVelocities The u and v velocity of every Node in node order
+ */
+void VelocityLayer::SetVelocities(std::vector<float> &newVelocities)
+{
+	velocities.swap(newVelocities);
+
+	float oldMaxSpeed = maxSpeed;
+	for (unsigned int i=0; i+1<velocities.size(); i+=2)
+	{
+		if (velocities[i] == DRY_VALUE || velocities[i+1] == DRY_VALUE)
+			continue;
+		float speed = sqrt(velocities[i]*velocities[i] + velocities[i+1]*velocities[i+1]);
+		if (speed > maxSpeed)
+			maxSpeed = speed;
+	}
+
+	if (maxSpeed != oldMaxSpeed)
+		UpdateGlyphScale();
+
+	instancesPending = true;
+}
+
+
+/**
+ * @brief Tells the layer that the camera has moved, so the Nodes must be sampled again
+ */
+void VelocityLayer::ViewChanged()
+{
+	viewChanged = true;
+}
+
+
+/**
+ * @brief Samples the visible Nodes so that the arrows are evenly spaced on the screen
+ *
+ * Samples the visible Nodes so that the arrows are evenly spaced on the screen. The
+ * spacing is GLYPH_SPACING_PIXELS converted to normalized units at the current zoom
+ * level, so zooming in shows more arrows.
+ *
+ */
+void VelocityLayer::SampleVisibleNodes()
+{
+	viewChanged = false;
+	if (!camera || !terrainLayer || camera->GetViewportWidth() <= 0)
+		return;
+
+	/* Get the bounds of the viewport in domain space */
+	float xTopLeft, yTopLeft, xBotRight, yBotRight;
+	camera->GetUnprojectedPoint(0, 0, &xTopLeft, &yTopLeft);
+	camera->GetUnprojectedPoint(camera->GetViewportWidth(), camera->GetViewportHeight(), &xBotRight, &yBotRight);
+
+	sampleSpacing = fabs(xBotRight - xTopLeft) / camera->GetViewportWidth() * GLYPH_SPACING_PIXELS;
+
+	float l = xTopLeft < xBotRight ? xTopLeft : xBotRight;
+	float r = xTopLeft < xBotRight ? xBotRight : xTopLeft;
+	float b = yTopLeft < yBotRight ? yTopLeft : yBotRight;
+	float t = yTopLeft < yBotRight ? yBotRight : yTopLeft;
+	std::vector<Node*> nodes = terrainLayer->SampleNodesFromRectangle(l, r, b, t, sampleSpacing);
+
+	sampleNodes.resize(nodes.size());
+	sampleLocations.resize(2*nodes.size());
+	for (unsigned int i=0; i<nodes.size(); ++i)
+	{
+		sampleNodes[i] = nodes[i]->nodeNumber;
+		sampleLocations[2*i+0] = nodes[i]->normX;
+		sampleLocations[2*i+1] = nodes[i]->normY;
+	}
+
+	UpdateGlyphScale();
+	instancesPending = true;
+}
+
+
+/**
+ * @brief Rebuilds the instance buffer from the sampled Nodes and the current velocities
+ *
+ * Rebuilds the instance buffer from the sampled Nodes and the current velocities.
+ * The buffer is orphaned before being written so the GPU never waits on the previous
+ * frame. Dry Nodes are skipped.
+ *
+ */
+void VelocityLayer::UploadInstances()
+{
+	instancesPending = false;
+	numInstances = 0;
+
+	const size_t InstanceBufferSize = 4*sizeof(GLfloat)*sampleNodes.size();
+	if (InstanceBufferSize == 0)
+		return;
+
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVBOId);
+	glBufferData(GL_ARRAY_BUFFER, InstanceBufferSize, NULL, GL_STREAM_DRAW);
+	GLfloat* glInstanceData = (GLfloat *)glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
+	if (glInstanceData)
+	{
+		for (unsigned int i=0; i<sampleNodes.size(); ++i)
+		{
+			unsigned int index = 2*(sampleNodes[i]-1);
+			if (index+1 >= velocities.size())
+				continue;
+
+			float u = velocities[index];
+			float v = velocities[index+1];
+			if (u == DRY_VALUE || v == DRY_VALUE || (u == 0.0 && v == 0.0))
+				continue;
+
+			glInstanceData[4*numInstances+0] = (GLfloat)sampleLocations[2*i+0];
+			glInstanceData[4*numInstances+1] = (GLfloat)sampleLocations[2*i+1];
+			glInstanceData[4*numInstances+2] = (GLfloat)u;
+			glInstanceData[4*numInstances+3] = (GLfloat)v;
+			++numInstances;
+		}
+	}
+
+	if (!glInstanceData || glUnmapBuffer(GL_ARRAY_BUFFER) == GL_FALSE)
+	{
+		DEBUG("ERROR: Writing instance buffer for VelocityLayer " << GetID());
+		numInstances = 0;
+	}
+}
+
+
+/**
+ * @brief Scales the arrows so that the fastest speed is as long as the spacing between arrows
+ */
+void VelocityLayer::UpdateGlyphScale()
+{
+	if (glyphShader && maxSpeed > 0.0 && sampleSpacing > 0.0)
+		glyphShader->SetGlyphScale(sampleSpacing / maxSpeed, sampleSpacing);
+}
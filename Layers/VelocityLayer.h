@@ -0,0 +1,89 @@
+#ifndef VELOCITYLAYER_H
+#define VELOCITYLAYER_H
+
+#include "Layers/Layer.h"
+#include "Layers/TerrainLayer.h"
+#include "OpenGL/GLCamera.h"
+#include "OpenGL/Shaders/GlyphShader.h"
+#include "adcData.h"
+
+#include <vector>
+#include <cmath>
+#include <QObject>
+
+#define GLYPH_SPACING_PIXELS	20.0
+
+
+/**
+ * @brief A Layer that draws velocity vectors from a fort.64 file as arrow glyphs
+ *
+ * This Layer draws an arrow at a sample of the Nodes of a TerrainLayer, pointing
+ * in the direction of the velocity at the Node and scaled by its speed. Drawing an
+ * arrow at every Node of a large domain would be unreadable and slow, so the Nodes are
+ * sampled from the TerrainLayer's quadtree so that the arrows are about
+ * GLYPH_SPACING_PIXELS apart on the screen. The sample is only recomputed when the
+ * view changes.
+ *
+ * The arrow shape is sent to the GPU once. Each sampled Node is one instance that
+ * supplies a location and a velocity, and the GlyphShader rotates and scales the
+ * arrow. A new timestep only replaces the instance buffer, which holds four floats for
+ * each visible arrow.
+ *
+ * Arrows are scaled so that the fastest speed seen so far is drawn as long as the
+ * spacing between arrows.
+ *
+ */
+class VelocityLayer : public Layer
+{
+		Q_OBJECT
+	public:
+
+		/* Constructor/Destructor */
+		VelocityLayer();
+		~VelocityLayer();
+
+		/* Virtual methods to override */
+		virtual void	Draw();
+		virtual void	LoadDataToGPU();
+		virtual void	SetData(QString fileLocation);
+		virtual bool	DataLoaded();
+
+		/* Setter Methods */
+		virtual void	SetCamera(GLCamera *newCamera);
+		void		SetTerrainLayer(TerrainLayer *newLayer);
+		void		SetVelocities(std::vector<float> &newVelocities);
+
+		/* View Methods */
+		void	ViewChanged();
+
+	protected:
+
+		TerrainLayer*	terrainLayer;	/**< The TerrainLayer whose Nodes the velocities belong to */
+
+		/* Velocity Data */
+		std::vector<float>	velocities;	/**< The u and v velocity at every Node of the TerrainLayer */
+		std::vector<unsigned int>	sampleNodes;	/**< Node numbers of the Nodes that currently have an arrow */
+		std::vector<float>	sampleLocations;	/**< Normalized x and y of each sampled Node */
+		float			sampleSpacing;	/**< Distance between sampled Nodes (normalized) */
+		float			maxSpeed;	/**< The fastest speed seen in any timestep */
+
+		/* OpenGL Variables */
+		GlyphShader*	glyphShader;	/**< The shader used to draw the arrows */
+		GLuint		VAOId;		/**< The vertex array object ID */
+		GLuint		shapeVBOId;	/**< The buffer that holds the arrow shape */
+		GLuint		instanceVBOId;	/**< The buffer that holds the location and velocity of each arrow */
+		unsigned int	numInstances;	/**< The number of arrows in the instance buffer */
+
+		/* Flags */
+		bool	glLoaded;		/**< Flag that shows if the arrow shape has been sent to the GPU */
+		bool	viewChanged;		/**< Flag that shows if the Nodes need to be sampled again */
+		bool	instancesPending;	/**< Flag that shows if the instance buffer needs to be rebuilt */
+
+	private:
+
+		void	SampleVisibleNodes();
+		void	UploadInstances();
+		void	UpdateGlyphScale();
+};
+
+#endif // VELOCITYLAYER_H
@@ -15,6 +15,16 @@ MainWindow::MainWindow(QWidget *parent) :
 	testProject = 0;
 	displayOptionsDialog = 0;
 
+	// Create the time series plot window, shown when a point time series is extracted
+	timeSeriesPlot = new TimeSeriesPlot(this);
+	timeSeriesPlot->setWindowFlags(Qt::Tool);
+	timeSeriesPlot->setWindowTitle("Point Time Series");
+
+	// Create the job status window, shown when an ADCIRC job is queued or changes state
+	jobStatus = new JobStatusWidget(this);
+	jobStatus->setWindowFlags(Qt::Tool);
+	jobStatus->setWindowTitle("ADCIRC Jobs");
+
 	// Create GLPanel status bar and all labels
 	glStatusBar = new QStatusBar();
 
@@ -73,6 +83,36 @@ void MainWindow::keyPressEvent(QKeyEvent *event)
 }
 
 
+/**
+ * @brief Asks before closing while ADCIRC jobs are queued or running
+ *
+ * Asks before closing while ADCIRC jobs are queued or running, since the jobs
+ * are stopped when the project is closed.
+ *
+ */
+void MainWindow::closeEvent(QCloseEvent *event)
+{
+	JobScheduler *scheduler = testProject ? testProject->GetJobScheduler() : 0;
+	int numJobs = scheduler ? scheduler->GetNumQueuedJobs() + scheduler->GetNumRunningJobs() : 0;
+	if (numJobs > 0)
+	{
+		QMessageBox dlg (this);
+		dlg.setWindowTitle("Quit");
+		dlg.setText(QString::number(numJobs) + " ADCIRC job(s) are still queued or running");
+		dlg.setInformativeText("Quitting now will stop them. Do you want to quit anyway?");
+		dlg.setIcon(QMessageBox::Warning);
+		dlg.setStandardButtons(QMessageBox::Yes | QMessageBox::No);
+		dlg.setDefaultButton(QMessageBox::No);
+		if (dlg.exec() != QMessageBox::Yes)
+		{
+			event->ignore();
+			return;
+		}
+	}
+	event->accept();
+}
+
+
 /**
  * @brief Displays output to the text box in the Output tab
  * @param The text (or rich HTML) to be displayed
@@ -231,6 +271,7 @@ void MainWindow::on_newProjectButton_clicked()
 	{
 		testProject = new Project();
 		testProject->SetProgressBar(ui->progressBar);
+		testProject->SetGLWidget(ui->GLPanel);
 		ConnectProject(testProject);
 		testProject->SetProjectTree(ui->projectTree);
 		testProject->CreateProject();
@@ -247,6 +288,7 @@ void MainWindow::on_openProjectButton_clicked()
 	{
 		testProject = new Project();
 		testProject->SetProgressBar(ui->progressBar);
+		testProject->SetGLWidget(ui->GLPanel);
 		ConnectProject(testProject);
 		testProject->SetProjectTree(ui->projectTree);
 		testProject->OpenProject();
@@ -323,6 +365,9 @@ void MainWindow::ConnectNewDomain(Domain *newDomain)
 		disconnect(testDomain, SIGNAL(EmitMessage(QString)), this, SLOT(displayOutput(QString)));
 		disconnect(testDomain, SIGNAL(UndoAvailable(bool)), ui->undoButton, SLOT(setEnabled(bool)));
 		disconnect(testDomain, SIGNAL(RedoAvailable(bool)), ui->redoButton, SLOT(setEnabled(bool)));
+		disconnect(testDomain, SIGNAL(NumTimesteps(int)), this, SLOT(showNumTS(int)));
+		disconnect(testDomain, SIGNAL(TimeSeriesExtracted(QString,QPolygonF)), timeSeriesPlot, SLOT(setSeries(QString,QPolygonF)));
+		disconnect(testDomain, SIGNAL(TimeSeriesExtracted(QString,QPolygonF)), timeSeriesPlot, SLOT(show()));
 	}
 
 	connect(newDomain, SIGNAL(Message(QString)), this, SLOT(displayOutput(QString)));
@@ -339,6 +384,9 @@ void MainWindow::ConnectNewDomain(Domain *newDomain)
 	connect(newDomain, SIGNAL(EmitMessage(QString)), this, SLOT(displayOutput(QString)));
 	connect(newDomain, SIGNAL(UndoAvailable(bool)), ui->undoButton, SLOT(setEnabled(bool)));
 	connect(newDomain, SIGNAL(RedoAvailable(bool)), ui->redoButton, SLOT(setEnabled(bool)));
+	connect(newDomain, SIGNAL(NumTimesteps(int)), this, SLOT(showNumTS(int)));
+	connect(newDomain, SIGNAL(TimeSeriesExtracted(QString,QPolygonF)), timeSeriesPlot, SLOT(setSeries(QString,QPolygonF)));
+	connect(newDomain, SIGNAL(TimeSeriesExtracted(QString,QPolygonF)), timeSeriesPlot, SLOT(show()));
 }
 
 
@@ -348,10 +396,31 @@ void MainWindow::ConnectProject(Project *newProject)
 	{
 		connect(newProject, SIGNAL(newDomainSelected()), this, SLOT(updateVisibleDomain()));
 		connect(newProject, SIGNAL(newDomainSelected()), ui->GLPanel, SLOT(updateGL()));
+		connect(newProject, SIGNAL(emitMessage(QString)), this, SLOT(displayOutput(QString)));
 		connect(ui->createSubdomainButton, SIGNAL(clicked()), newProject, SLOT(createSubdomain()));
 		connect(ui->saveProjectButton, SIGNAL(clicked()), newProject, SLOT(saveProject()));
 		connect(ui->actionProjectSettings, SIGNAL(triggered()), newProject, SLOT(showProjectSettings()));
 		connect(ui->runFullDomainButton, SIGNAL(clicked()), newProject, SLOT(runFullDomain()));
+		connect(ui->runSubdomainsButton, SIGNAL(clicked()), newProject, SLOT(runSubdomains()));
+		connect(ui->runPipelineButton, SIGNAL(clicked()), newProject, SLOT(runPipeline()));
+		connect(ui->resetPipelineButton, SIGNAL(clicked()), newProject, SLOT(resetPipeline()));
+		connect(ui->playFort63Button, SIGNAL(clicked()), newProject, SLOT(toggleFort63Animation()));
+		connect(ui->playFort64Button, SIGNAL(clicked()), newProject, SLOT(toggleFort64Animation()));
+		connect(ui->maxElevationButton, SIGNAL(clicked()), newProject, SLOT(toggleMaxElevation()));
+		connect(ui->maxVelocityButton, SIGNAL(clicked()), newProject, SLOT(toggleMaxVelocity()));
+		connect(ui->envelopeFirstSpinBox, SIGNAL(valueChanged(int)), newProject, SLOT(setEnvelopeFirstTimestep(int)));
+		connect(ui->envelopeLastSpinBox, SIGNAL(valueChanged(int)), newProject, SLOT(setEnvelopeLastTimestep(int)));
+		newProject->setEnvelopeFirstTimestep(ui->envelopeFirstSpinBox->value());
+		newProject->setEnvelopeLastTimestep(ui->envelopeLastSpinBox->value());
+		connect(ui->verifySubdomainButton, SIGNAL(clicked()), newProject, SLOT(verifySubdomain()));
+		connect(ui->pointTimeSeriesButton, SIGNAL(clicked()), newProject, SLOT(pickTimeSeries()));
+
+		JobScheduler *scheduler = newProject->GetJobScheduler();
+		connect(scheduler, SIGNAL(jobStateChanged(int,QString,QString)), jobStatus, SLOT(setJobState(int,QString,QString)));
+		connect(scheduler, SIGNAL(jobStateChanged(int,QString,QString)), jobStatus, SLOT(show()));
+		connect(scheduler, SIGNAL(emitMessage(QString)), this, SLOT(displayOutput(QString)));
+		connect(jobStatus, SIGNAL(cancelJob(int)), scheduler, SLOT(cancelJob(int)));
+		connect(newProject->GetRunMonitor(), SIGNAL(jobProgress(int,int,QString)), jobStatus, SLOT(setJobProgress(int,int,QString)));
 
 		connect(newProject, SIGNAL(showProjectExplorerPane()), this, SLOT(showProjectExplorerPane()));
 		connect(newProject, SIGNAL(showCreateSubdomainPane()), this, SLOT(showCreateSubdomainPane()));
@@ -5,12 +5,16 @@
 #include "Domains/Domain.h"
 
 #include "Dialogs/DisplayOptionsDialog.h"
+#include "Widgets/PlotWidgets/TimeSeriesPlot.h"
+#include "Widgets/JobWidgets/JobStatusWidget.h"
 
 #include <QMainWindow>
 #include <QThread>
 #include <QLabel>
 #include <QFileDialog>
 #include <QKeyEvent>
+#include <QCloseEvent>
+#include <QMessageBox>
 #include <QSystemTrayIcon>
 #include <QMenu>
 #include <QGLFormat>
@@ -31,6 +35,7 @@ class MainWindow : public QMainWindow
 	protected:
 
 		void	keyPressEvent(QKeyEvent *event);
+		void	closeEvent(QCloseEvent *event);
 
 
 	public slots:
@@ -97,6 +102,8 @@ class MainWindow : public QMainWindow
 
 		// Dialogs
 		DisplayOptionsDialog*	displayOptionsDialog;
+		TimeSeriesPlot*		timeSeriesPlot;
+		JobStatusWidget*	jobStatus;
 
 		void	ConnectNewDomain(Domain *newDomain);
 		void	ConnectProject(Project *newProject);
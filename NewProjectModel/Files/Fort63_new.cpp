@@ -3,22 +3,159 @@
 Fort63_new::Fort63_new(QObject *parent) :
 	QObject(parent),
 	domainName(),
-	projectFile(0)
+	projectFile(0),
+	cache(0),
+	cacheChecked(false)
 {
+	connect(&sourceWatcher, SIGNAL(fileChanged(QString)), this, SLOT(sourceChanged()));
 }
 
 
 Fort63_new::Fort63_new(ProjectFile_new *projectFile, QObject *parent) :
 	QObject(parent),
 	domainName(),
-	projectFile(projectFile)
+	projectFile(projectFile),
+	cache(0),
+	cacheChecked(false)
 {
+	connect(&sourceWatcher, SIGNAL(fileChanged(QString)), this, SLOT(sourceChanged()));
 }
 
 
 Fort63_new::Fort63_new(QString domainName, ProjectFile_new *projectFile, QObject *parent) :
 	QObject(parent),
 	domainName(domainName),
-	projectFile(projectFile)
+	projectFile(projectFile),
+	cache(0),
+	cacheChecked(false)
 {
+	connect(&sourceWatcher, SIGNAL(fileChanged(QString)), this, SLOT(sourceChanged()));
+}
+
+
+/**
+ * @brief Makes sure the binary cache of fort.63 is current and opens it
+ *
+ * Makes sure the binary cache of fort.63 is current and opens it. The cache is
+ * built the first time it is needed and rebuilt whenever fort.63 changes. Building
+ * the cache reads all of fort.63 once, after which any timestep or node history
+ * can be read without parsing the output file.
+ *
+ * The cache is only checked against fort.63 when it is first opened and after
+ * fort.63 changes on disk, so reads after that don't touch the cache header.
+ *
+ * @return true if the cache is ready to be read
+ */
+bool Fort63_new::PrepareCache()
+{
+	QString targetFile = GetFilePath();
+	if (targetFile.isEmpty() || !QFile(targetFile).exists())
+		return false;
+
+	if (!cache)
+	{
+		cache = new Fort63Cache(targetFile, this);
+		cacheChecked = false;
+	}
+	else if (cache->GetSourcePath() != targetFile)
+	{
+		cache->SetSourcePath(targetFile);
+		cacheChecked = false;
+	}
+
+	if (cacheChecked)
+		return true;
+
+	if (!cache->CacheIsCurrent() && !cache->BuildCache())
+		return false;
+	if (!cache->Open())
+		return false;
+
+	/* A file that is replaced drops out of the watcher, so it is added again each time */
+	if (!sourceWatcher.files().isEmpty())
+		sourceWatcher.removePaths(sourceWatcher.files());
+	sourceWatcher.addPath(targetFile);
+	cacheChecked = true;
+	return true;
+}
+
+
+/**
+ * @brief Reads the water elevation at every node for a single timestep
+ * @param ts The timestep (starting from 1)
+ * @param values The values in node order
+ * @return true if the timestep was read
+ */
+bool Fort63_new::ReadTimestep(unsigned int ts, std::vector<float> &values)
+{
+	if (!PrepareCache())
+		return false;
+	return cache->ReadTimestep(ts, values);
+}
+
+
+/**
+ * @brief Reads the water elevation at a single node for every timestep
+ * @param node The node number (starting from 1)
+ * @param values The values in timestep order
+ * @return true if the history was read
+ */
+bool Fort63_new::ReadNodeHistory(unsigned int node, std::vector<float> &values)
+{
+	if (!PrepareCache())
+		return false;
+	return cache->ReadNodeHistory(node, values);
+}
+
+
+QString Fort63_new::GetFilePath()
+{
+	if (!projectFile)
+		return QString();
+
+	QString targetFile = domainName.isEmpty() ? projectFile->GetFullDomainFort63() : projectFile->GetSubDomainFort63(domainName);
+	if (targetFile.isEmpty())
+	{
+		QString targetDirectory = domainName.isEmpty() ? projectFile->GetFullDomainDirectory() : projectFile->GetSubDomainDirectory(domainName);
+		if (!targetDirectory.isEmpty())
+		{
+			targetFile = targetDirectory + QDir::separator() + "fort.63";
+			if (!QFile(targetFile).exists() && QFile(targetFile + ".nc").exists())
+				targetFile.append(".nc");
+		}
+	}
+	return targetFile;
+}
+
+
+unsigned int Fort63_new::GetNumNodes()
+{
+	if (!PrepareCache())
+		return 0;
+	return cache->GetNumNodes();
+}
+
+
+unsigned int Fort63_new::GetNumTimesteps()
+{
+	if (!PrepareCache())
+		return 0;
+	return cache->GetNumTimesteps();
+}
+
+
+double Fort63_new::GetTimestepTime(unsigned int ts)
+{
+	if (!PrepareCache())
+		return 0.0;
+	return cache->GetTimestepTime(ts);
+}
+
+
+/**
+ * @brief Marks the cache to be checked again the next time it is read
+ */
+void Fort63_new::sourceChanged()
+{
+	cacheChecked = false;
 }
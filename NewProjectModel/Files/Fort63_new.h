@@ -2,8 +2,13 @@
 #define FORT63_new_H
 
 #include <QObject>
+#include <QDir>
+#include <QFileSystemWatcher>
+
+#include <vector>
 
 #include "NewProjectModel/Files/ProjectFile_new.h"
+#include "Projects/IO/FileIO/Fort63Cache.h"
 
 class Fort63_new : public QObject
 {
@@ -13,10 +18,25 @@ class Fort63_new : public QObject
 		Fort63_new(ProjectFile_new *projectFile, QObject *parent=0);
 		Fort63_new(QString domainName, ProjectFile_new *projectFile, QObject *parent=0);
 
+		bool		PrepareCache();
+		bool		ReadTimestep(unsigned int ts, std::vector<float> &values);
+		bool		ReadNodeHistory(unsigned int node, std::vector<float> &values);
+		QString		GetFilePath();
+		unsigned int	GetNumNodes();
+		unsigned int	GetNumTimesteps();
+		double		GetTimestepTime(unsigned int ts);
+
 	private:
 
 		QString			domainName;
 		ProjectFile_new*	projectFile;
+		Fort63Cache*		cache;
+		bool			cacheChecked;	/**< true once the cache has been found current and opened */
+		QFileSystemWatcher	sourceWatcher;	/**< Watches the output file so the cache is checked again when it changes */
+
+	private slots:
+
+		void	sourceChanged();
 };
 
 #endif // FORT63_new_H
@@ -3,23 +3,159 @@
 Fort64_new::Fort64_new(QObject *parent) :
 	QObject(parent),
 	domainName(),
-	projectFile(0)
+	projectFile(0),
+	cache(0),
+	cacheChecked(false)
 {
+	connect(&sourceWatcher, SIGNAL(fileChanged(QString)), this, SLOT(sourceChanged()));
 }
 
 
 Fort64_new::Fort64_new(ProjectFile_new *projectFile, QObject *parent) :
 	QObject(parent),
 	domainName(),
-	projectFile(projectFile)
+	projectFile(projectFile),
+	cache(0),
+	cacheChecked(false)
 {
+	connect(&sourceWatcher, SIGNAL(fileChanged(QString)), this, SLOT(sourceChanged()));
 }
 
 
 Fort64_new::Fort64_new(QString domainName, ProjectFile_new *projectFile, QObject *parent) :
 	QObject(parent),
 	domainName(domainName),
-	projectFile(projectFile)
+	projectFile(projectFile),
+	cache(0),
+	cacheChecked(false)
 {
+	connect(&sourceWatcher, SIGNAL(fileChanged(QString)), this, SLOT(sourceChanged()));
 }
 
+
+/**
+ * @brief Makes sure the binary cache of fort.64 is current and opens it
+ *
+ * Makes sure the binary cache of fort.64 is current and opens it. The cache is
+ * built the first time it is needed and rebuilt whenever fort.64 changes. Building
+ * the cache reads all of fort.64 once, after which any timestep or node history
+ * can be read without parsing the output file.
+ *
+ * The cache is only checked against fort.64 when it is first opened and after
+ * fort.64 changes on disk, so reads after that don't touch the cache header.
+ *
+ * @return true if the cache is ready to be read
+ */
+bool Fort64_new::PrepareCache()
+{
+	QString targetFile = GetFilePath();
+	if (targetFile.isEmpty() || !QFile(targetFile).exists())
+		return false;
+
+	if (!cache)
+	{
+		cache = new Fort63Cache(targetFile, this);
+		cacheChecked = false;
+	}
+	else if (cache->GetSourcePath() != targetFile)
+	{
+		cache->SetSourcePath(targetFile);
+		cacheChecked = false;
+	}
+
+	if (cacheChecked)
+		return true;
+
+	if (!cache->CacheIsCurrent() && !cache->BuildCache())
+		return false;
+	if (!cache->Open())
+		return false;
+
+	/* A file that is replaced drops out of the watcher, so it is added again each time */
+	if (!sourceWatcher.files().isEmpty())
+		sourceWatcher.removePaths(sourceWatcher.files());
+	sourceWatcher.addPath(targetFile);
+	cacheChecked = true;
+	return true;
+}
+
+
+/**
+ * @brief Reads the velocity at every node for a single timestep
+ * @param ts The timestep (starting from 1)
+ * @param values The values in node order, with the x and y components of each
+ * @return true if the timestep was read
+ */
+bool Fort64_new::ReadTimestep(unsigned int ts, std::vector<float> &values)
+{
+	if (!PrepareCache())
+		return false;
+	return cache->ReadTimestep(ts, values);
+}
+
+
+/**
+ * @brief Reads the velocity at a single node for every timestep
+ * @param node The node number (starting from 1)
+ * @param values The values in timestep order, with the x and y components of each
+ * @return true if the history was read
+ */
+bool Fort64_new::ReadNodeHistory(unsigned int node, std::vector<float> &values)
+{
+	if (!PrepareCache())
+		return false;
+	return cache->ReadNodeHistory(node, values);
+}
+
+
+QString Fort64_new::GetFilePath()
+{
+	if (!projectFile)
+		return QString();
+
+	QString targetFile = domainName.isEmpty() ? projectFile->GetFullDomainFort64() : projectFile->GetSubDomainFort64(domainName);
+	if (targetFile.isEmpty())
+	{
+		QString targetDirectory = domainName.isEmpty() ? projectFile->GetFullDomainDirectory() : projectFile->GetSubDomainDirectory(domainName);
+		if (!targetDirectory.isEmpty())
+		{
+			targetFile = targetDirectory + QDir::separator() + "fort.64";
+			if (!QFile(targetFile).exists() && QFile(targetFile + ".nc").exists())
+				targetFile.append(".nc");
+		}
+	}
+	return targetFile;
+}
+
+
+unsigned int Fort64_new::GetNumNodes()
+{
+	if (!PrepareCache())
+		return 0;
+	return cache->GetNumNodes();
+}
+
+
+unsigned int Fort64_new::GetNumTimesteps()
+{
+	if (!PrepareCache())
+		return 0;
+	return cache->GetNumTimesteps();
+}
+
+
+double Fort64_new::GetTimestepTime(unsigned int ts)
+{
+	if (!PrepareCache())
+		return 0.0;
+	return cache->GetTimestepTime(ts);
+}
+
+
+/**
+ * @brief Marks the cache to be checked again the next time it is read
+ */
+void Fort64_new::sourceChanged()
+{
+	cacheChecked = false;
+}
@@ -0,0 +1,173 @@
+#include "QuadtreeOutline.h"
+
+QuadtreeOutline::QuadtreeOutline(Quadtree *newQuadtree)
+{
+	quadtree = newQuadtree;
+
+	glLoaded = false;
+	pointCount = 0;
+	VAOId = 0;
+	VBOId = 0;
+	IBOId = 0;
+	outlineShader = 0;
+	camera = 0;
+}
+
+
+QuadtreeOutline::~QuadtreeOutline()
+{
+	/* Clean up shader */
+	if (outlineShader)
+		delete outlineShader;
+
+	/* Clean up OpenGL stuff */
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	if (VAOId)
+		glDeleteVertexArrays(1, &VAOId);
+	if (VBOId)
+		glDeleteBuffers(1, &VBOId);
+	if (IBOId)
+		glDeleteBuffers(1, &IBOId);
+}
+
+
+void QuadtreeOutline::Draw()
+{
+	if (!glLoaded)
+		InitializeGL();
+
+	if (glLoaded)
+	{
+		glBindVertexArray(VAOId);
+		if (outlineShader)
+		{
+			glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+			if (outlineShader->Use())
+				glDrawElements(GL_LINES, 2*pointCount, GL_UNSIGNED_INT, (GLvoid*)0);
+		}
+		glBindVertexArray(0);
+		glUseProgram(0);
+	}
+}
+
+
+void QuadtreeOutline::SetCamera(GLCamera *newCamera)
+{
+	camera = newCamera;
+	if (outlineShader)
+		outlineShader->SetCamera(camera);
+}
+
+
+void QuadtreeOutline::InitializeGL()
+{
+	if (!quadtree)
+		return;
+
+	if (!outlineShader)
+		outlineShader = new SolidShader();
+	outlineShader->SetColor(QColor(0.0*255, 0.0*255, 0.0*255, 1.0*255));
+	outlineShader->SetCamera(camera);
+
+	if (!VAOId)
+		glGenVertexArrays(1, &VAOId);
+	if (!VBOId)
+		glGenBuffers(1, &VBOId);
+	if (!IBOId)
+		glGenBuffers(1, &IBOId);
+
+	glBindVertexArray(VAOId);
+
+	glBindBuffer(GL_ARRAY_BUFFER, VBOId);
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4*sizeof(GLfloat), 0);
+
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBOId);
+
+	glBindVertexArray(0);
+
+	std::vector<Point> pointsList = quadtree->GetOutlinePoints();
+	pointCount = pointsList.size();
+	std::vector<GLuint> indicesList = BuildOutlinesIndices();
+
+	if (pointsList.size() > 0 && indicesList.size() > 0)
+	{
+		LoadOutlinesToGPU(pointsList, indicesList);
+	} else {
+		glLoaded = false;
+		return;
+	}
+
+	GLenum errorCheck = glGetError();
+	if (errorCheck == GL_NO_ERROR)
+	{
+		if (VAOId && VBOId && IBOId)
+		{
+			glLoaded = true;
+		} else {
+			DEBUG("Quadtree drawing not initialized");
+			glLoaded = false;
+		}
+	} else {
+		const GLubyte *errString = gluErrorString(errorCheck);
+		DEBUG("Quadtree Drawing OpenGL Error: " << errString);
+		glLoaded = false;
+	}
+}
+
+
+std::vector<GLuint> QuadtreeOutline::BuildOutlinesIndices()
+{
+	std::vector<GLuint> indexList;
+
+	for (int i=0; i<pointCount/4; ++i)
+	{
+		indexList.push_back(4*i+0); indexList.push_back(4*i+1);
+		indexList.push_back(4*i+1); indexList.push_back(4*i+2);
+		indexList.push_back(4*i+2); indexList.push_back(4*i+3);
+		indexList.push_back(4*i+3); indexList.push_back(4*i+0);
+	}
+
+	return indexList;
+}
+
+
+void QuadtreeOutline::LoadOutlinesToGPU(std::vector<Point> pointsList, std::vector<GLuint> indicesList)
+{
+	const size_t VertexBufferSize = 4*sizeof(GLfloat)*pointsList.size();
+	const size_t IndexBufferSize = sizeof(GLuint)*indicesList.size();
+
+	if (VBOId)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, VBOId);
+		glBufferData(GL_ARRAY_BUFFER, VertexBufferSize, NULL, GL_STATIC_DRAW);
+		GLfloat* glNodeData = (GLfloat*)glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
+		if (glNodeData)
+		{
+			for (unsigned int i=0; i<pointsList.size(); ++i)
+			{
+				glNodeData[4*i+0] = (GLfloat)pointsList[i].x;
+				glNodeData[4*i+1] = (GLfloat)pointsList[i].y;
+				glNodeData[4*i+2] = (GLfloat)1.0;
+				glNodeData[4*i+3] = (GLfloat)1.0;
+			}
+		}
+		glUnmapBuffer(GL_ARRAY_BUFFER);
+	}
+
+	if (IBOId)
+	{
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBOId);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, IndexBufferSize, NULL, GL_STATIC_DRAW);
+		GLuint* glIndexData = (GLuint*)glMapBuffer(GL_ELEMENT_ARRAY_BUFFER, GL_WRITE_ONLY);
+		if (glIndexData)
+		{
+			for (unsigned int i=0; i<indicesList.size(); ++i)
+			{
+				glIndexData[i] = indicesList[i];
+			}
+		}
+		glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+	}
+}
@@ -0,0 +1,48 @@
+#ifndef QUADTREEOUTLINE_H
+#define QUADTREEOUTLINE_H
+
+#include <vector>
+
+#include "OpenGL/GLCamera.h"
+#include "OpenGL/Shaders/SolidShader.h"
+#include "Quadtree/Quadtree.h"
+
+
+/**
+ * @brief Draws the outlines of the branches and leaves of a Quadtree
+ *
+ * Draws the outlines of the branches and leaves of a Quadtree, which is useful
+ * for seeing how a mesh has been divided up. The outlines are sent to the GPU the
+ * first time they are drawn, so the object must be created, drawn and deleted with
+ * the OpenGL context current. It does not take ownership of the Quadtree, and must be
+ * deleted before the Quadtree is.
+ *
+ */
+class QuadtreeOutline
+{
+	public:
+
+		QuadtreeOutline(Quadtree *newQuadtree);
+		~QuadtreeOutline();
+
+		void	Draw();
+		void	SetCamera(GLCamera *newCamera);
+
+	private:
+
+		Quadtree*	quadtree;
+
+		bool		glLoaded;
+		int		pointCount;
+		GLuint		VAOId;
+		GLuint		VBOId;
+		GLuint		IBOId;
+		SolidShader*	outlineShader;
+		GLCamera*	camera;
+
+		void			InitializeGL();
+		std::vector<GLuint>	BuildOutlinesIndices();
+		void			LoadOutlinesToGPU(std::vector<Point> pointsList, std::vector<GLuint> indicesList);
+};
+
+#endif // QUADTREEOUTLINE_H
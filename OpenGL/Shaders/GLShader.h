@@ -4,7 +4,7 @@
 #include "OpenGL/GLCamera.h"
 
 
-enum ShaderType {NoShaderType, SolidShaderType, GradientShaderType};
+enum ShaderType {NoShaderType, SolidShaderType, GradientShaderType, GlyphShaderType};
 
 
 
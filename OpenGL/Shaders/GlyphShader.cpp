@@ -0,0 +1,158 @@
+#include "GlyphShader.h"
+
+
+/**
+ * @brief Constructor that defines the source code and default values
+ *
+ * Constructor that defines the source code and default values
+ *
+ */
+GlyphShader::GlyphShader()
+{
+	vertexSource =  "#version 330"
+			"\n"
+			"layout(location=0) in vec2 in_Shape;"
+			"layout(location=1) in vec2 in_Location;"
+			"layout(location=2) in vec2 in_Vector;"
+			"out vec4 ex_Color;"
+			"uniform mat4 MVPMatrix;"
+			"uniform vec4 ColorVector;"
+			"uniform float GlyphScale;"
+			"uniform float MaxLength;"
+			"void main(void)"
+			"{"
+			"	float magnitude = length(in_Vector);"
+			"	vec2 direction = magnitude > 0.0 ? in_Vector/magnitude : vec2(1.0, 0.0);"
+			"	vec2 offset = min(magnitude*GlyphScale, MaxLength)*vec2(direction.x*in_Shape.x - direction.y*in_Shape.y,"
+			"								   direction.y*in_Shape.x + direction.x*in_Shape.y);"
+			"	gl_Position = MVPMatrix*vec4(in_Location + offset, 0.0, 1.0);"
+			"	ex_Color = ColorVector;"
+			"}";
+
+	fragSource =	"#version 330"
+			"\n"
+			"in vec4 ex_Color;"
+			"out vec4 out_Color;"
+			"void main(void)"
+			"{"
+			"	out_Color = ex_Color;"
+			"}";
+
+	color = QColor(0, 0, 0, 255);
+	glyphScale = 1.0;
+	maxLength = 1.0;
+
+	CompileShader();
+	UpdateUniforms();
+}
+
+
+void GlyphShader::SetColor(QColor newColor)
+{
+	color = newColor;
+	UpdateUniforms();
+}
+
+
+/**
+ * @brief Sets how long the glyphs are drawn
+ * @param newScale Glyph length (normalized units) per unit of vector magnitude
+ * @param newMaxLength The longest a glyph is drawn (normalized units)
+ */
+void GlyphShader::SetGlyphScale(float newScale, float newMaxLength)
+{
+	glyphScale = newScale;
+	maxLength = newMaxLength;
+	UpdateUniforms();
+}
+
+
+QColor GlyphShader::GetShaderProperties()
+{
+	return color;
+}
+
+
+ShaderType GlyphShader::GetShaderType()
+{
+	return GlyphShaderType;
+}
+
+
+/**
+ * @brief Compiles the shader parts and assembles them into a usable shader on the OpenGL context
+ *
+ * Compiles the shader parts and assembles them into a usable shader on the OpenGL context
+ *
+ */
+void GlyphShader::CompileShader()
+{
+	const char* fullVertSource = vertexSource.data();
+	const char* fullFragSource = fragSource.data();
+
+	GLuint vertexShaderID = CompileShaderPart(fullVertSource, GL_VERTEX_SHADER);
+	GLuint fragmentShaderID = CompileShaderPart(fullFragSource, GL_FRAGMENT_SHADER);
+
+	if (vertexShaderID && fragmentShaderID)
+	{
+		programID = glCreateProgram();
+		glAttachShader(programID, vertexShaderID);
+		glAttachShader(programID, fragmentShaderID);
+		glLinkProgram(programID);
+		glDeleteShader(vertexShaderID);
+		glDeleteShader(fragmentShaderID);
+		loaded = true;
+	}
+}
+
+
+/**
+ * @brief Updates values used for drawing
+ *
+ * This function updates the MVP matrix, the color, and the glyph scale used in
+ * drawing operations.
+ *
+ */
+void GlyphShader::UpdateUniforms()
+{
+	if (loaded && camSet)
+	{
+		glUseProgram(programID);
+
+		GLint MVPUniform = glGetUniformLocation(programID, "MVPMatrix");
+		GLint ColorUniform = glGetUniformLocation(programID, "ColorVector");
+		GLint ScaleUniform = glGetUniformLocation(programID, "GlyphScale");
+		GLint MaxLengthUniform = glGetUniformLocation(programID, "MaxLength");
+
+		GLenum errVal = glGetError();
+		if (errVal != GL_NO_ERROR)
+			DEBUG("Error getting uniform locations");
+
+		GLfloat currColor[4] = {color.red() / 255.0,
+					color.green() / 255.0,
+					color.blue() / 255.0,
+					color.alpha() / 255.0};
+
+		glUniformMatrix4fv(MVPUniform, 1, GL_FALSE, camera->MVPMatrix.m);
+		glUniform4fv(ColorUniform, 1, currColor);
+		glUniform1f(ScaleUniform, glyphScale);
+		glUniform1f(MaxLengthUniform, maxLength);
+
+		errVal = glGetError();
+		if (errVal != GL_NO_ERROR)
+		{
+			const GLubyte *errString = gluErrorString(errVal);
+			DEBUG("GlyphShader OpenGL Error: " << errString);
+			uniformsSet = false;
+		} else {
+			uniformsSet = true;
+		}
+
+	} else {
+		if (!loaded)
+			DEBUG("Uniforms not updated: Shader not loaded");
+		else
+			DEBUG("Uniforms not updated: Camera not set");
+		uniformsSet = false;
+	}
+}
@@ -0,0 +1,52 @@
+#ifndef GLYPHSHADER_H
+#define GLYPHSHADER_H
+
+#include <string>
+#include <QColor>
+#include "GLShader.h"
+
+
+/**
+ * @brief A shader that draws one instanced arrow glyph for each vector value
+ *
+ * This shader draws the same arrow shape once for every instance. Each instance
+ * supplies its location (attribute 1) and a vector such as a velocity (attribute 2),
+ * which are used to rotate and scale the arrow on the GPU. Attribute 0 is the arrow
+ * shape, pointing along +x with a length of one.
+ *
+ * The length of each arrow is the vector magnitude times the glyph scale, but is
+ * never longer than the maximum length so that neighboring arrows do not overlap.
+ *
+ */
+class GlyphShader : public GLShader
+{
+	public:
+
+		// Constructor
+		GlyphShader();
+
+		// Modification Functions
+		void	SetColor(QColor newColor);
+		void	SetGlyphScale(float newScale, float newMaxLength);
+
+		// Query Functions
+		QColor		GetShaderProperties();
+		ShaderType	GetShaderType();
+
+	protected:
+
+		// Source code
+		std::string	vertexSource;
+		std::string	fragSource;
+
+		// Shader Properties
+		QColor	color;
+		float	glyphScale;	/**< Glyph length per unit of vector magnitude */
+		float	maxLength;	/**< The longest a glyph is drawn */
+
+		// Override virtual functions
+		virtual void	CompileShader();
+		virtual void	UpdateUniforms();
+};
+
+#endif // GLYPHSHADER_H
@@ -15,17 +15,20 @@ GradientShader::GradientShader()
 	vertexSource =	"#version 330"
 			"\n"
 			"layout(location=0) in vec4 in_Position;"
+			"layout(location=1) in float in_Value;"
 			"out vec4 ex_Color;"
 			"uniform mat4 MVPMatrix;"
+			"uniform int useValue;"
 			"uniform int stopCount;"
 			"uniform float values[10];"
 			"uniform vec4 colors[10];"
 			"void main(void)"
 			"{"
+			"	float value = useValue == 1 ? in_Value : in_Position.z;"
 			"	ex_Color = colors[0];"
 			"	for (int i=1; i<min(stopCount, 10); ++i)"
 			"	{"
-			"		ex_Color = mix(ex_Color, colors[i], smoothstep(values[i-1], values[i], in_Position.z));"
+			"		ex_Color = mix(ex_Color, colors[i], smoothstep(values[i-1], values[i], value));"
 			"	}"
 			"	gl_Position = MVPMatrix*in_Position;"
 			"}";
@@ -41,6 +44,7 @@ GradientShader::GradientShader()
 
 	lowValue = 0.0;
 	highValue = 1.0;
+	useValueAttribute = false;
 
 	CompileShader();
 	UpdateUniforms();
@@ -62,6 +66,23 @@ void GradientShader::SetGradientRange(float newLow, float newHigh)
 }
 
 
+/**
+ * @brief Sets whether colors come from the per-vertex value attribute
+ *
+ * Sets whether colors come from the per-vertex value attribute (location 1)
+ * instead of the z-coordinate of each vertex. This is used to color a mesh by
+ * a value that changes over time, such as water elevation, without changing the
+ * vertex positions.
+ *
+ * @param useValue true to color using the value attribute
+ */
+void GradientShader::SetValueAttribute(bool useValue)
+{
+	useValueAttribute = useValue;
+	UpdateUniforms();
+}
+
+
 QGradientStops GradientShader::GetGradientStops()
 {
 	return gradientStops;
@@ -112,6 +133,7 @@ void GradientShader::UpdateUniforms()
 		glUseProgram(programID);
 
 		GLint MVPUniform = glGetUniformLocation(programID, "MVPMatrix");
+		GLint UseValueUniform = glGetUniformLocation(programID, "useValue");
 		GLint StopCountUniform = glGetUniformLocation(programID, "stopCount");
 		GLint ValuesUniform = glGetUniformLocation(programID, "values");
 		GLint ColorsUniform = glGetUniformLocation(programID, "colors");
@@ -134,6 +156,7 @@ void GradientShader::UpdateUniforms()
 			}
 
 			glUniformMatrix4fv(MVPUniform, 1, GL_FALSE, camera->MVPMatrix.m);
+			glUniform1i(UseValueUniform, useValueAttribute ? 1 : 0);
 			glUniform1i(StopCountUniform, stopCount);
 			glUniform1fv(ValuesUniform, stopCount, stopValues);
 			glUniform4fv(ColorsUniform, stopCount, colorValues);
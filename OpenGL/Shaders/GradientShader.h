@@ -26,6 +26,7 @@ class GradientShader : public GLShader
 		// Modification Functions
 		void	SetGradientStops(const QGradientStops &newStops);
 		void	SetGradientRange(float lowValue, float newHigh);
+		void	SetValueAttribute(bool useValue);
 
 		// Query Functions
 		QGradientStops	GetGradientStops();
@@ -41,6 +42,7 @@ class GradientShader : public GLShader
 		QGradientStops	gradientStops;
 		float		lowValue;
 		float		highValue;
+		bool		useValueAttribute;	/**< Color by the per-vertex value attribute instead of z */
 
 		// Override virtual functions
 		void	CompileShader();
@@ -0,0 +1,460 @@
+#include "DomainLoader.h"
+
+DomainLoader::DomainLoader(QObject *parent) :
+	QObject(parent)
+{
+	maxLoads = DOMAIN_LOAD_CONCURRENCY;
+	progressBar = 0;
+	glWidget = 0;
+	nextOrder = 0;
+	numRequested = 0;
+	numFinished = 0;
+	memoryBudget = JobScheduler::GetPhysicalMemory()/4;
+}
+
+
+/**
+ * @brief Sets the number of domains read from disk at once
+ * @param newMax The number of domains, at least 1
+ */
+void DomainLoader::SetMaxConcurrentLoads(int newMax)
+{
+	maxLoads = newMax > 0 ? newMax : 1;
+	StartLoads();
+}
+
+
+/**
+ * @brief Sets the progress bar that shows the combined progress of every load
+ *
+ * Sets the progress bar that shows the combined progress of every load. Does not
+ * take ownership of the QProgressBar.
+ *
+ * @param newBar Pointer to a progress bar in the user interface
+ */
+void DomainLoader::SetProgressBar(QProgressBar *newBar)
+{
+	progressBar = newBar;
+}
+
+
+/**
+ * @brief Sets the widget whose OpenGL context is made current before domains are unloaded
+ *
+ * Sets the widget whose OpenGL context is made current before domains are unloaded,
+ * so their GPU buffers are freed in the context that created them. Does not take
+ * ownership of the QGLWidget.
+ *
+ * @param newWidget Pointer to the widget the domains are drawn in
+ */
+void DomainLoader::SetGLWidget(QGLWidget *newWidget)
+{
+	glWidget = newWidget;
+}
+
+
+/**
+ * @brief Sets the memory the loaded meshes may use before domains are unloaded
+ * @param newBudget The memory in bytes, or 0 for no limit
+ */
+void DomainLoader::SetMemoryBudget(qint64 newBudget)
+{
+	memoryBudget = newBudget > 0 ? newBudget : 0;
+	EvictDomains();
+	StartLoads();
+}
+
+
+/**
+ * @brief Queues a domain to be loaded
+ *
+ * Queues a domain to be loaded. The domain will not load itself when it is drawn
+ * while it waits. A domain that is already queued keeps the higher of its two
+ * priorities, and a domain that is already loaded or loading is left alone.
+ *
+ * @param domain The domain
+ * @param priority One of the DOMAIN_LOAD_ priorities
+ */
+void DomainLoader::QueueDomain(Domain *domain, int priority)
+{
+	if (!domain)
+		return;
+
+	MarkUsed(domain, false);
+	if (domain->IsLoaded() || FindLoading(domain) >= 0)
+		return;
+
+	int index = FindQueued(domain);
+	if (index >= 0)
+	{
+		if (priority > queue[index].priority)
+			queue[index].priority = priority;
+	} else {
+		DomainLoadRequest request;
+		request.domain = domain;
+		request.priority = priority;
+		request.order = nextOrder++;
+		queue.push_back(request);
+		domain->SetLoadQueued(true);
+		++numRequested;
+	}
+
+	StartLoads();
+}
+
+
+/**
+ * @brief Moves a domain the user has selected to the front of the queue
+ *
+ * Moves a domain the user has selected to the front of the queue, and marks it as
+ * the most recently used domain, so it is the last to be unloaded.
+ *
+ * @param domain The domain
+ */
+void DomainLoader::Prioritize(Domain *domain)
+{
+	MarkUsed(domain, true);
+	QueueDomain(domain, DOMAIN_LOAD_ACTIVE);
+	EvictDomains();
+}
+
+
+/**
+ * @brief Forgets a domain that is about to be deleted
+ * @param domain The domain
+ */
+void DomainLoader::RemoveDomain(Domain *domain)
+{
+	std::vector<Domain*>::iterator used = std::find(recentlyUsed.begin(), recentlyUsed.end(), domain);
+	if (used != recentlyUsed.end())
+		recentlyUsed.erase(used);
+
+	int index = FindQueued(domain);
+	if (index >= 0)
+	{
+		queue.erase(queue.begin()+index);
+		++numFinished;
+	}
+
+	index = FindLoading(domain);
+	if (index >= 0)
+	{
+		disconnect(domain, 0, this, 0);
+		loading.erase(loading.begin()+index);
+		loadProgress.remove(domain);
+		++numFinished;
+	}
+
+	StartLoads();
+}
+
+
+/**
+ * @brief Returns the number of domains that are queued or loading
+ * @return The number of domains
+ */
+int DomainLoader::GetNumPending()
+{
+	return queue.size() + loading.size();
+}
+
+
+/**
+ * @brief Returns the memory budget
+ * @return The memory in bytes, or 0 for no limit
+ */
+qint64 DomainLoader::GetMemoryBudget()
+{
+	return memoryBudget;
+}
+
+
+/**
+ * @brief Returns the memory used by the meshes of every known domain
+ * @return The memory in bytes, in main memory and on the GPU
+ */
+qint64 DomainLoader::GetMemoryUsage()
+{
+	qint64 total = 0;
+	for (std::vector<Domain*>::iterator it = recentlyUsed.begin(); it != recentlyUsed.end(); ++it)
+		total += (*it)->GetMemoryUsage() + (*it)->GetGPUMemoryUsage();
+	return total;
+}
+
+
+/**
+ * @brief Returns the TaskScheduler priority a domain is read at
+ * @param priority One of the DOMAIN_LOAD_ priorities
+ * @return One of the TASK_PRIORITY_ values
+ */
+int DomainLoader::GetTaskPriority(int priority)
+{
+	if (priority >= DOMAIN_LOAD_ACTIVE)
+		return TASK_PRIORITY_HIGH;
+	if (priority == DOMAIN_LOAD_SOURCE)
+		return TASK_PRIORITY_NORMAL;
+	return TASK_PRIORITY_LOW;
+}
+
+
+int DomainLoader::FindQueued(Domain *domain)
+{
+	for (unsigned int i=0; i<queue.size(); ++i)
+		if (queue[i].domain == domain)
+			return i;
+	return -1;
+}
+
+
+int DomainLoader::FindLoading(Domain *domain)
+{
+	for (unsigned int i=0; i<loading.size(); ++i)
+		if (loading[i].domain == domain)
+			return i;
+	return -1;
+}
+
+
+bool DomainLoader::IsPending(Domain *domain)
+{
+	return domain && (FindQueued(domain) >= 0 || FindLoading(domain) >= 0);
+}
+
+
+/**
+ * @brief Checks if a domain's mesh is needed by a load that has not finished
+ * @param domain The domain
+ * @return true if the domain is pending, or a pending domain is derived from it
+ */
+bool DomainLoader::IsNeeded(Domain *domain)
+{
+	if (IsPending(domain))
+		return true;
+
+	for (std::vector<DomainLoadRequest>::iterator it = queue.begin(); it != queue.end(); ++it)
+		if (it->domain->GetSourceDomain() == domain)
+			return true;
+	for (std::vector<DomainLoadRequest>::iterator it = loading.begin(); it != loading.end(); ++it)
+		if (it->domain->GetSourceDomain() == domain)
+			return true;
+	return false;
+}
+
+
+/**
+ * @brief Records that a domain has been used
+ * @param domain The domain
+ * @param mostRecent If true, the domain becomes the most recently used. Otherwise a
+ * domain that is not known yet is added as the least recently used.
+ */
+void DomainLoader::MarkUsed(Domain *domain, bool mostRecent)
+{
+	if (!domain)
+		return;
+
+	std::vector<Domain*>::iterator it = std::find(recentlyUsed.begin(), recentlyUsed.end(), domain);
+	if (it != recentlyUsed.end())
+	{
+		if (!mostRecent)
+			return;
+		recentlyUsed.erase(it);
+	}
+
+	if (mostRecent)
+		recentlyUsed.insert(recentlyUsed.begin(), domain);
+	else
+		recentlyUsed.push_back(domain);
+}
+
+
+/**
+ * @brief Unloads the least recently used domains until the meshes fit in the budget
+ *
+ * Unloads the least recently used domains until the meshes fit in the budget. The
+ * most recently used domain is always kept, as is any domain a pending load needs.
+ * If anything had to be unloaded, the deferred loads that are still queued are
+ * dropped, since they would only push out other domains the user has not opened.
+ *
+ * The OpenGL context is made current before the first domain is unloaded, since
+ * this is called from slots rather than while drawing.
+ *
+ */
+void DomainLoader::EvictDomains()
+{
+	qint64 usage = GetMemoryUsage();
+	if (memoryBudget > 0 && usage > memoryBudget)
+	{
+		bool contextCurrent = false;
+		for (int i=recentlyUsed.size()-1; i>0 && usage > memoryBudget; --i)
+		{
+			Domain *domain = recentlyUsed[i];
+			if (!domain->IsLoaded() || IsNeeded(domain))
+				continue;
+
+			qint64 domainUsage = domain->GetMemoryUsage() + domain->GetGPUMemoryUsage();
+			if (domain->GetGPUMemoryUsage() > 0)
+			{
+				if (!glWidget)
+					continue;
+				if (!contextCurrent)
+				{
+					glWidget->makeCurrent();
+					contextCurrent = true;
+				}
+			}
+
+			if (domain->Unload())
+			{
+				usage -= domainUsage;
+				emit emitMessage("<p>Unloaded " + domain->GetDomainPath() + " to stay within the memory budget</p>");
+			}
+		}
+
+		std::vector<DomainLoadRequest>::iterator it = queue.begin();
+		while (it != queue.end())
+		{
+			if (it->priority == DOMAIN_LOAD_DEFERRED)
+			{
+				it->domain->SetLoadQueued(false);
+				it = queue.erase(it);
+				++numFinished;
+			} else {
+				++it;
+			}
+		}
+	}
+
+	emit memoryUsageChanged();
+}
+
+
+/**
+ * @brief Checks if a queued request may start now
+ *
+ * Checks if a queued request may start now. Only deferred requests are ever held
+ * back: they wait while anything more important is queued or loading, leave one
+ * slot free, and wait for the domain they are derived from.
+ *
+ * @param request The request
+ * @return true if the request may start
+ */
+bool DomainLoader::CanStart(const DomainLoadRequest &request)
+{
+	if (request.priority > DOMAIN_LOAD_DEFERRED)
+		return true;
+
+	for (std::vector<DomainLoadRequest>::iterator it = queue.begin(); it != queue.end(); ++it)
+		if (it->priority > DOMAIN_LOAD_DEFERRED)
+			return false;
+	for (std::vector<DomainLoadRequest>::iterator it = loading.begin(); it != loading.end(); ++it)
+		if (it->priority > DOMAIN_LOAD_DEFERRED)
+			return false;
+
+	int deferredSlots = maxLoads > 1 ? maxLoads-1 : 1;
+	if ((int)loading.size() >= deferredSlots)
+		return false;
+
+	if (memoryBudget > 0 && GetMemoryUsage() >= memoryBudget)
+		return false;
+
+	return !IsPending(request.domain->GetSourceDomain());
+}
+
+
+/**
+ * @brief Starts the most important requests that fit in the free slots
+ */
+void DomainLoader::StartLoads()
+{
+	while ((int)loading.size() < maxLoads)
+	{
+		int best = -1;
+		for (unsigned int i=0; i<queue.size(); ++i)
+		{
+			if (!CanStart(queue[i]))
+				continue;
+			if (best < 0 || queue[i].priority > queue[best].priority ||
+			    (queue[i].priority == queue[best].priority && queue[i].order < queue[best].order))
+				best = i;
+		}
+		if (best < 0)
+			break;
+
+		DomainLoadRequest request = queue[best];
+		queue.erase(queue.begin()+best);
+
+		Domain *domain = request.domain;
+		loading.push_back(request);
+		loadProgress[domain] = 0;
+		connect(domain, SIGNAL(LoadProgress(int)), this, SLOT(domainProgress(int)));
+		connect(domain, SIGNAL(LoadFinished(bool)), this, SLOT(domainFinished(bool)));
+
+		/* A domain that has nothing to read, or has already been read, is done right away */
+		if (!domain->LoadData(GetTaskPriority(request.priority)))
+		{
+			disconnect(domain, 0, this, 0);
+			loading.pop_back();
+			loadProgress.remove(domain);
+			++numFinished;
+		}
+	}
+
+	UpdateProgress();
+}
+
+
+/**
+ * @brief Shows the combined progress of every domain queued since the loader was last idle
+ */
+void DomainLoader::UpdateProgress()
+{
+	if (queue.size() == 0 && loading.size() == 0)
+	{
+		bool wasBusy = numRequested > 0;
+		numRequested = 0;
+		numFinished = 0;
+		if (progressBar)
+			progressBar->hide();
+		if (wasBusy)
+			emit finishedLoading();
+		return;
+	}
+
+	int total = 100*numFinished;
+	for (QMap<Domain*, int>::iterator it = loadProgress.begin(); it != loadProgress.end(); ++it)
+		total += it.value();
+
+	if (progressBar && numRequested > 0)
+	{
+		progressBar->setValue(total/numRequested);
+		progressBar->show();
+	}
+}
+
+
+void DomainLoader::domainProgress(int percent)
+{
+	Domain *domain = qobject_cast<Domain*>(sender());
+	if (!domain || !loadProgress.contains(domain))
+		return;
+
+	loadProgress[domain] = percent;
+	UpdateProgress();
+}
+
+
+void DomainLoader::domainFinished(bool)
+{
+	Domain *domain = qobject_cast<Domain*>(sender());
+	int index = FindLoading(domain);
+	if (index < 0)
+		return;
+
+	disconnect(domain, 0, this, 0);
+	loading.erase(loading.begin()+index);
+	loadProgress.remove(domain);
+	++numFinished;
+
+	EvictDomains();
+	StartLoads();
+}
@@ -0,0 +1,124 @@
+#ifndef DOMAINLOADER_H
+#define DOMAINLOADER_H
+
+#include <vector>
+#include <algorithm>
+#include <iostream>
+
+#include <QObject>
+#include <QMap>
+#include <QProgressBar>
+
+#include "Domains/Domain.h"
+#include "Adcirc/JobScheduler.h"
+
+#include <QGLWidget>
+
+#define DOMAIN_LOAD_CONCURRENCY	2	/**< Default number of domains read from disk at once */
+
+#define DOMAIN_LOAD_ACTIVE	2	/**< The domain the user is looking at */
+#define DOMAIN_LOAD_SOURCE	1	/**< The full domain, which subdomains are derived from */
+#define DOMAIN_LOAD_DEFERRED	0	/**< A domain the user has not opened yet */
+
+
+/**
+ * @brief A domain waiting to be loaded by a DomainLoader
+ */
+struct DomainLoadRequest
+{
+	Domain*		domain;
+	int		priority;	/**< One of the DOMAIN_LOAD_ priorities. Higher priorities are loaded first. */
+	unsigned int	order;		/**< Requests of the same priority are loaded in the order they were made */
+};
+
+
+/**
+ * @brief Loads the domains of a project from disk a few at a time, most important first
+ *
+ * Loads the domains of a project from disk a few at a time, most important first.
+ * Each Domain reads its mesh as a task on the TaskScheduler, at a priority that
+ * follows its place in the queue, but only SetMaxConcurrentLoads() of them read at
+ * once, so opening a project with many subdomains does not have every domain
+ * competing for the disk.
+ *
+ * The domain the user selects is moved to the front of the queue with Prioritize().
+ * Domains the user has not opened yet are deferred: they are only read in the
+ * background while nothing more important is queued or loading, they never take
+ * the last free slot, so a selected domain can always start right away, and a
+ * subdomain waits for its full domain so it can be derived from it instead of
+ * parsing its own fort.14 file.
+ *
+ * The progress bar shows the combined progress of every domain queued since the
+ * loader was last idle.
+ *
+ * The loader also keeps the domains in the order they were last used, and once the
+ * memory used by their meshes goes over the budget set with SetMemoryBudget(), the
+ * least recently used domains are unloaded until it fits again. The selected domain
+ * and any domain a pending load depends on are never unloaded, and Domain::Unload()
+ * itself refuses domains that are busy or have elements selected. An unloaded domain
+ * is read again from its fort.14 cache when it is next selected. Once the budget
+ * is used up, the deferred loads are dropped instead of pushing each other out, and
+ * those domains are read when they are first drawn.
+ *
+ * Unloading a domain frees its buffers on the GPU, and eviction happens outside of
+ * drawing, so the context of the widget set with SetGLWidget() is made current
+ * first. Without a widget, only domains that have nothing on the GPU are unloaded.
+ *
+ */
+class DomainLoader : public QObject
+{
+		Q_OBJECT
+	public:
+		DomainLoader(QObject *parent=0);
+
+		void	SetMaxConcurrentLoads(int newMax);
+		void	SetProgressBar(QProgressBar *newBar);
+		void	SetGLWidget(QGLWidget *newWidget);
+		void	SetMemoryBudget(qint64 newBudget);
+
+		void	QueueDomain(Domain *domain, int priority);
+		void	Prioritize(Domain *domain);
+		void	RemoveDomain(Domain *domain);
+
+		int	GetNumPending();
+		qint64	GetMemoryBudget();
+		qint64	GetMemoryUsage();
+
+	private:
+
+		int				maxLoads;
+		QProgressBar*			progressBar;
+		QGLWidget*			glWidget;	/**< The widget whose context the domains' GPU buffers belong to */
+		std::vector<DomainLoadRequest>	queue;		/**< Requests that have not started */
+		std::vector<DomainLoadRequest>	loading;	/**< Requests that are being read */
+		QMap<Domain*, int>		loadProgress;	/**< Progress of each domain being read */
+		unsigned int			nextOrder;
+		int				numRequested;	/**< Domains queued since the loader was last idle */
+		int				numFinished;	/**< Of those, the domains that have finished */
+		std::vector<Domain*>		recentlyUsed;	/**< Every known domain, most recently used first */
+		qint64				memoryBudget;	/**< Memory the loaded meshes may use in bytes, or 0 for no limit */
+
+		int	GetTaskPriority(int priority);
+		int	FindQueued(Domain *domain);
+		int	FindLoading(Domain *domain);
+		bool	IsPending(Domain *domain);
+		bool	IsNeeded(Domain *domain);
+		void	MarkUsed(Domain *domain, bool mostRecent);
+		void	EvictDomains();
+		bool	CanStart(const DomainLoadRequest &request);
+		void	StartLoads();
+		void	UpdateProgress();
+
+	private slots:
+
+		void	domainProgress(int percent);
+		void	domainFinished(bool succeeded);
+
+	signals:
+
+		void	finishedLoading();
+		void	memoryUsageChanged();
+		void	emitMessage(QString);
+};
+
+#endif // DOMAINLOADER_H
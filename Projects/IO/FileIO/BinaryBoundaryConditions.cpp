@@ -0,0 +1,641 @@
+#include "BinaryBoundaryConditions.h"
+
+BinaryBoundaryConditions::BinaryBoundaryConditions()
+{
+	mappedData = 0;
+	mappedSize = 0;
+	writing = false;
+
+	valueSize = 8;
+	numNodes = 0;
+	numTimesteps = 0;
+	headerValues = 0;
+	valuesLine1 = 0;
+	valuesLine2 = 0;
+}
+
+
+BinaryBoundaryConditions::~BinaryBoundaryConditions()
+{
+	Close();
+}
+
+
+/**
+ * @brief Checks if the file at the given location is in the binary format
+ *
+ * Checks if the file at the given location is in the binary format by looking
+ * for the magic string at the start of the file.
+ *
+ * @param path The file to check
+ * @return true if the file is a binary boundary condition file
+ */
+bool BinaryBoundaryConditions::IsBinaryFile(QString path)
+{
+	QFile testFile (path);
+	if (!testFile.open(QIODevice::ReadOnly))
+		return false;
+
+	char magic[8];
+	bool isBinary = testFile.read(magic, 8) == 8 && std::memcmp(magic, BINARY_BC_MAGIC, 8) == 0;
+	testFile.close();
+	return isBinary;
+}
+
+
+/**
+ * @brief Splits a line of an ASCII record into its values
+ * @param line The line of text
+ * @param values The values found on the line
+ */
+void BinaryBoundaryConditions::ParseValues(const std::string &line, std::vector<double> &values)
+{
+	std::stringstream lineStream (line);
+	double currValue;
+	while (lineStream >> currValue)
+		values.push_back(currValue);
+}
+
+
+/**
+ * @brief Formats values as a tab separated line of an ASCII record
+ *
+ * Formats values as a tab separated line of an ASCII record, using the number
+ * of significant digits that the stored precision can hold.
+ *
+ * @param values The first value
+ * @param count The number of values
+ * @param valueSize The size in bytes of the stored values (4 or 8)
+ * @return The formatted line, without a newline
+ */
+QString BinaryBoundaryConditions::FormatValues(const double *values, unsigned int count, unsigned int valueSize)
+{
+	int precision = valueSize == 4 ? 8 : 15;
+	QString line;
+	for (unsigned int i=0; i<count; ++i)
+	{
+		if (i > 0)
+			line.append("\t");
+		line.append(QString::number(values[i], 'g', precision));
+	}
+	return line;
+}
+
+
+/**
+ * @brief Reads one timestep record from an ASCII boundary condition file
+ *
+ * Reads one timestep record from an ASCII boundary condition file: a header
+ * line followed by two lines for each node, the first of which starts with the
+ * node number. The number of values found on each node line is reported so the
+ * layout of a binary file can be taken from the first record.
+ *
+ * @param stream The stream, positioned at the start of a record
+ * @param numRecordNodes The number of nodes in each record
+ * @param header The timestep header values
+ * @param recordNodes The node numbers, in record order
+ * @param values The values of every node, in record order
+ * @param recordValuesLine1 The number of values on the first line of a node record
+ * @param recordValuesLine2 The number of values on the second line of a node record
+ * @return true if a complete record was read
+ */
+bool BinaryBoundaryConditions::ReadAsciiTimestep(std::istream &stream, unsigned int numRecordNodes, std::vector<double> &header,
+						 std::vector<unsigned int> &recordNodes, std::vector<double> &values,
+						 unsigned int &recordValuesLine1, unsigned int &recordValuesLine2)
+{
+	header.clear();
+	recordNodes.clear();
+	values.clear();
+
+	std::string line;
+	if (!std::getline(stream, line))
+		return false;
+	ParseValues(line, header);
+
+	for (unsigned int i=0; i<numRecordNodes; ++i)
+	{
+		std::string line2;
+		if (!std::getline(stream, line) || !std::getline(stream, line2))
+			return false;
+
+		unsigned int currNode = 0;
+		std::stringstream nodeStream (line);
+		nodeStream >> currNode;
+		std::string line1;
+		std::getline(nodeStream, line1);
+		recordNodes.push_back(currNode);
+
+		size_t start = values.size();
+		ParseValues(line1, values);
+		size_t middle = values.size();
+		ParseValues(line2, values);
+		recordValuesLine1 = middle - start;
+		recordValuesLine2 = values.size() - middle;
+	}
+	return true;
+}
+
+
+/**
+ * @brief Opens and memory maps an existing binary file
+ * @param path The file to open
+ * @return true if the file was opened and the header is valid
+ */
+bool BinaryBoundaryConditions::OpenForReading(QString path)
+{
+	Close();
+
+	file.setFileName(path);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	if (!ReadHeader() || !MapFile())
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Remaps the file if it has grown since it was mapped
+ *
+ * Remaps the file if it has grown since it was mapped. Used when the file is
+ * still being written by another process.
+ *
+ * @return true if the mapping is valid
+ */
+bool BinaryBoundaryConditions::Refresh()
+{
+	if (writing || !file.isOpen())
+		return false;
+
+	if (file.size() != mappedSize)
+		return MapFile();
+
+	return mappedData != 0;
+}
+
+
+/**
+ * @brief Checks if a timestep has been completely written
+ *
+ * Checks if a timestep has been completely written. The writer fills in the
+ * index entry of a timestep only after its record has been written, so a
+ * non-zero index entry means the record is complete.
+ *
+ * @param ts The timestep (starting from 1)
+ * @return true if the timestep can be read
+ */
+bool BinaryBoundaryConditions::TimestepAvailable(unsigned int ts)
+{
+	if (TimestepOffset(ts) == 0)
+	{
+		if (!Refresh())
+			return false;
+		return TimestepOffset(ts) != 0;
+	}
+	return true;
+}
+
+
+bool BinaryBoundaryConditions::ReadTimestepHeader(unsigned int ts, std::vector<double> &header)
+{
+	if (!TimestepAvailable(ts))
+		return false;
+
+	const double *record = (const double*)(mappedData + TimestepOffset(ts));
+	header.assign(record, record + headerValues);
+	return true;
+}
+
+
+/**
+ * @brief Reads a complete timestep
+ * @param ts The timestep (starting from 1)
+ * @param header The timestep header values
+ * @param values The values of every node, in the order of the node numbers
+ * @return true if the timestep was read
+ */
+bool BinaryBoundaryConditions::ReadTimestep(unsigned int ts, std::vector<double> &header, std::vector<double> &values)
+{
+	if (!ReadTimestepHeader(ts, header))
+		return false;
+
+	const uchar *data = mappedData + TimestepOffset(ts) + headerValues*sizeof(double);
+	unsigned int count = numNodes*GetValuesPerNode();
+	if (valueSize == 4)
+	{
+		const float *floatData = (const float*)data;
+		values.assign(floatData, floatData + count);
+	} else {
+		const double *doubleData = (const double*)data;
+		values.assign(doubleData, doubleData + count);
+	}
+	return true;
+}
+
+
+/**
+ * @brief Gathers the values of a subset of nodes from a timestep
+ *
+ * Gathers the values of a subset of nodes directly from the mapped record,
+ * without touching the rest of the timestep.
+ *
+ * @param ts The timestep (starting from 1)
+ * @param recordIndices The positions of the nodes in the node number list
+ * @param values The values of the requested nodes, in the requested order
+ * @return true if the timestep was read
+ */
+bool BinaryBoundaryConditions::GatherTimestep(unsigned int ts, const std::vector<unsigned int> &recordIndices, std::vector<double> &values)
+{
+	if (!TimestepAvailable(ts))
+		return false;
+
+	const uchar *data = mappedData + TimestepOffset(ts) + headerValues*sizeof(double);
+	unsigned int valuesPerNode = GetValuesPerNode();
+	values.resize(recordIndices.size()*valuesPerNode);
+
+	std::vector<double>::iterator out = values.begin();
+	if (valueSize == 4)
+	{
+		const float *floatData = (const float*)data;
+		for (std::vector<unsigned int>::const_iterator it = recordIndices.begin(); it != recordIndices.end(); ++it)
+		{
+			const float *nodeData = floatData + (*it)*valuesPerNode;
+			for (unsigned int i=0; i<valuesPerNode; ++i, ++out)
+				*out = nodeData[i];
+		}
+	} else {
+		const double *doubleData = (const double*)data;
+		for (std::vector<unsigned int>::const_iterator it = recordIndices.begin(); it != recordIndices.end(); ++it)
+		{
+			const double *nodeData = doubleData + (*it)*valuesPerNode;
+			out = std::copy(nodeData, nodeData + valuesPerNode, out);
+		}
+	}
+	return true;
+}
+
+
+QString BinaryBoundaryConditions::FormatTimestepHeader(const std::vector<double> &header)
+{
+	return FormatValues(header.empty() ? 0 : &header[0], header.size(), 8) + "\n";
+}
+
+
+/**
+ * @brief Formats the values of one node as an ASCII node record
+ * @param nodeNumber The node number written at the start of the record
+ * @param values The values of the node
+ * @return The two lines of the node record
+ */
+QString BinaryBoundaryConditions::FormatNodeRecord(unsigned int nodeNumber, const double *values)
+{
+	return FormatNodeRecord(nodeNumber, values, valuesLine1, valuesLine2, valueSize);
+}
+
+
+QString BinaryBoundaryConditions::FormatNodeRecord(unsigned int nodeNumber, const double *values, unsigned int recordValuesLine1,
+						   unsigned int recordValuesLine2, unsigned int recordValueSize)
+{
+	return QString::number(nodeNumber) + "\t" + FormatValues(values, recordValuesLine1, recordValueSize) + "\n" +
+			FormatValues(values + recordValuesLine1, recordValuesLine2, recordValueSize) + "\n";
+}
+
+
+/**
+ * @brief Creates a new binary file, overwriting any existing file
+ *
+ * Creates a new binary file, overwriting any existing file. The header, node
+ * numbers and an empty timestep index are written immediately.
+ *
+ * @param path The file to create
+ * @param newNodeNumbers The recorded node numbers, in record order
+ * @param newNumTimesteps The number of timesteps that will be recorded
+ * @param newHeaderValues The number of values in each timestep header
+ * @param newValuesLine1 The number of values on the first line of a node record
+ * @param newValuesLine2 The number of values on the second line of a node record
+ * @param newValueSize 4 to store float32 values, 8 to store float64 values
+ * @return true if the file was created
+ */
+bool BinaryBoundaryConditions::OpenForWriting(QString path, std::vector<unsigned int> newNodeNumbers, unsigned int newNumTimesteps,
+					      unsigned int newHeaderValues, unsigned int newValuesLine1, unsigned int newValuesLine2,
+					      unsigned int newValueSize)
+{
+	Close();
+
+	nodeNumbers = newNodeNumbers;
+	numNodes = nodeNumbers.size();
+	numTimesteps = newNumTimesteps;
+	headerValues = newHeaderValues;
+	valuesLine1 = newValuesLine1;
+	valuesLine2 = newValuesLine2;
+	valueSize = newValueSize == 4 ? 4 : 8;
+
+	file.setFileName(path);
+	if (!file.open(QIODevice::ReadWrite | QIODevice::Truncate))
+	{
+		std::cout << "Unable to open " << path.toStdString().data() << " for writing" << std::endl;
+		return false;
+	}
+	writing = true;
+
+	if (!WriteHeader())
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+
+/**
+ * @brief Opens an existing binary file to write more timesteps to it
+ *
+ * Opens an existing binary file to write more timesteps to it. Timesteps
+ * already in the file are kept, which lets a restarted carve pick up where
+ * the previous one stopped.
+ *
+ * @param path The existing file
+ * @return true if the file was opened and the header is valid
+ */
+bool BinaryBoundaryConditions::OpenForAppending(QString path)
+{
+	Close();
+
+	file.setFileName(path);
+	if (!file.open(QIODevice::ReadWrite))
+		return false;
+	writing = true;
+
+	if (!ReadHeader())
+	{
+		Close();
+		return false;
+	}
+	return true;
+}
+
+
+/**
+ * @brief Writes a single timestep record and adds it to the index
+ *
+ * Writes a single timestep record and then its index entry, so a reader that
+ * sees the index entry can rely on the record being complete.
+ *
+ * @param ts The timestep (starting from 1)
+ * @param header The timestep header values
+ * @param values The values of every node, in the order of the node numbers
+ * @return true if the timestep was written
+ */
+bool BinaryBoundaryConditions::WriteTimestep(unsigned int ts, const std::vector<double> &header, const std::vector<double> &values)
+{
+	if (!writing || ts < 1 || ts > numTimesteps)
+		return false;
+
+	if (header.size() != headerValues || values.size() != (size_t)numNodes*GetValuesPerNode())
+	{
+		std::cout << "WARNING: Timestep " << ts << " does not match the layout of " <<
+			     file.fileName().toStdString().data() << std::endl;
+		return false;
+	}
+
+	QByteArray record (RecordSize(), '\0');
+	char *recordData = record.data();
+	if (!header.empty())
+	{
+		std::memcpy(recordData, &header[0], header.size()*sizeof(double));
+		recordData += header.size()*sizeof(double);
+	}
+	if (valueSize == 4)
+	{
+		float *floatData = (float*)recordData;
+		for (size_t i=0; i<values.size(); ++i)
+			floatData[i] = values[i];
+	} else if (!values.empty()) {
+		std::memcpy(recordData, &values[0], values.size()*sizeof(double));
+	}
+
+	quint64 offset = FirstRecordOffset() + (ts-1)*RecordSize();
+	if (!file.seek(offset) || file.write(record) != record.size())
+		return false;
+
+	if (!file.seek(IndexOffset() + (ts-1)*sizeof(quint64)) ||
+	    file.write((const char*)&offset, sizeof(quint64)) != sizeof(quint64))
+		return false;
+
+	file.flush();
+	return true;
+}
+
+
+void BinaryBoundaryConditions::Close()
+{
+	UnmapFile();
+	if (file.isOpen())
+		file.close();
+	writing = false;
+}
+
+
+bool BinaryBoundaryConditions::IsOpen()
+{
+	return file.isOpen();
+}
+
+
+unsigned int BinaryBoundaryConditions::GetValueSize()
+{
+	return valueSize;
+}
+
+
+unsigned int BinaryBoundaryConditions::GetNumNodes()
+{
+	return numNodes;
+}
+
+
+unsigned int BinaryBoundaryConditions::GetNumTimesteps()
+{
+	return numTimesteps;
+}
+
+
+unsigned int BinaryBoundaryConditions::GetNumHeaderValues()
+{
+	return headerValues;
+}
+
+
+unsigned int BinaryBoundaryConditions::GetValuesLine1()
+{
+	return valuesLine1;
+}
+
+
+unsigned int BinaryBoundaryConditions::GetValuesLine2()
+{
+	return valuesLine2;
+}
+
+
+unsigned int BinaryBoundaryConditions::GetValuesPerNode()
+{
+	return valuesLine1 + valuesLine2;
+}
+
+
+std::vector<unsigned int> BinaryBoundaryConditions::GetNodeNumbers()
+{
+	return nodeNumbers;
+}
+
+
+bool BinaryBoundaryConditions::ReadHeader()
+{
+	char header[BINARY_BC_HEADER_SIZE];
+	if (!file.seek(0) || file.read(header, BINARY_BC_HEADER_SIZE) != BINARY_BC_HEADER_SIZE)
+		return false;
+
+	if (std::memcmp(header, BINARY_BC_MAGIC, 8) != 0)
+		return false;
+
+	quint32 fields[8];
+	std::memcpy(fields, header+8, sizeof(fields));
+	if (fields[0] != BINARY_BC_VERSION)
+	{
+		std::cout << "WARNING: Unsupported version " << fields[0] << " in " << file.fileName().toStdString().data() << std::endl;
+		return false;
+	}
+	if (fields[7] != BINARY_BC_BYTE_ORDER)
+	{
+		std::cout << "WARNING: " << file.fileName().toStdString().data() << " was written with a different byte order" << std::endl;
+		return false;
+	}
+
+	valueSize = fields[1];
+	numNodes = fields[2];
+	numTimesteps = fields[3];
+	headerValues = fields[4];
+	valuesLine1 = fields[5];
+	valuesLine2 = fields[6];
+	if (valueSize != 4 && valueSize != 8)
+		return false;
+
+	/* The node numbers and index are written with the header, before any record */
+	if (file.size() < FirstRecordOffset())
+		return false;
+
+	nodeNumbers.resize(numNodes);
+	if (numNodes > 0)
+	{
+		qint64 nodeBytes = numNodes*sizeof(quint32);
+		if (!file.seek(NodeNumbersOffset()) || file.read((char*)&nodeNumbers[0], nodeBytes) != nodeBytes)
+			return false;
+	}
+
+	return true;
+}
+
+
+bool BinaryBoundaryConditions::WriteHeader()
+{
+	char header[BINARY_BC_HEADER_SIZE];
+	std::memcpy(header, BINARY_BC_MAGIC, 8);
+	quint32 fields[8] = {BINARY_BC_VERSION, valueSize, numNodes, numTimesteps,
+			     headerValues, valuesLine1, valuesLine2, BINARY_BC_BYTE_ORDER};
+	std::memcpy(header+8, fields, sizeof(fields));
+
+	if (file.write(header, BINARY_BC_HEADER_SIZE) != BINARY_BC_HEADER_SIZE)
+		return false;
+
+	/* Node numbers, padding, and an index with no timesteps written */
+	QByteArray tables (FirstRecordOffset() - NodeNumbersOffset(), '\0');
+	if (numNodes > 0)
+		std::memcpy(tables.data(), &nodeNumbers[0], numNodes*sizeof(quint32));
+
+	if (file.write(tables) != tables.size())
+		return false;
+
+	file.flush();
+	return true;
+}
+
+
+bool BinaryBoundaryConditions::MapFile()
+{
+	UnmapFile();
+	qint64 size = file.size();
+	if (size <= 0)
+		return false;
+
+	mappedData = file.map(0, size);
+	if (!mappedData)
+	{
+		std::cout << "WARNING: Unable to map " << file.fileName().toStdString().data() << std::endl;
+		return false;
+	}
+	mappedSize = size;
+	return true;
+}
+
+
+void BinaryBoundaryConditions::UnmapFile()
+{
+	if (mappedData)
+		file.unmap(mappedData);
+	mappedData = 0;
+	mappedSize = 0;
+}
+
+
+qint64 BinaryBoundaryConditions::NodeNumbersOffset()
+{
+	return BINARY_BC_HEADER_SIZE;
+}
+
+
+qint64 BinaryBoundaryConditions::IndexOffset()
+{
+	return NodeNumbersOffset() + PadToEight((qint64)numNodes*sizeof(quint32));
+}
+
+
+qint64 BinaryBoundaryConditions::FirstRecordOffset()
+{
+	return IndexOffset() + (qint64)numTimesteps*sizeof(quint64);
+}
+
+
+qint64 BinaryBoundaryConditions::RecordSize()
+{
+	return PadToEight((qint64)headerValues*sizeof(double) + (qint64)numNodes*GetValuesPerNode()*valueSize);
+}
+
+
+/**
+ * @brief Looks up the offset of a timestep in the mapped index
+ * @param ts The timestep (starting from 1)
+ * @return The offset of the record, or 0 if it is not available in the mapping
+ */
+qint64 BinaryBoundaryConditions::TimestepOffset(unsigned int ts)
+{
+	if (!mappedData || ts < 1 || ts > numTimesteps)
+		return 0;
+
+	quint64 offset;
+	std::memcpy(&offset, mappedData + IndexOffset() + (ts-1)*sizeof(quint64), sizeof(quint64));
+	if (offset == 0 || (qint64)offset + RecordSize() > mappedSize)
+		return 0;
+	return offset;
+}
+
+
+qint64 BinaryBoundaryConditions::PadToEight(qint64 size)
+{
+	return (size + 7) & ~((qint64)7);
+}
@@ -0,0 +1,117 @@
+#ifndef BINARYBOUNDARYCONDITIONS_H
+#define BINARYBOUNDARYCONDITIONS_H
+
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+#include <QString>
+#include <QFile>
+
+#define BINARY_BC_MAGIC		"ADCBCB1"
+#define BINARY_BC_VERSION	1
+#define BINARY_BC_BYTE_ORDER	0x01020304
+#define BINARY_BC_HEADER_SIZE	40
+
+
+/**
+ * @brief Reads and writes the binary, indexed variant of the boundary condition
+ * recording files (fort.066 and fort.020)
+ *
+ * The ASCII boundary condition files are expensive to parse and format and can
+ * only be read sequentially. The binary variant stores the same data in fixed-size
+ * records with an index of timestep offsets in the header, so any timestep can be
+ * reached with a single seek and the file can be memory mapped and gathered from
+ * directly.
+ *
+ * Layout (native byte order, checked with a byte order mark):
+ * - 40 byte header: magic, version, value size (4 or 8), number of nodes, number of
+ *   timesteps, number of timestep header values, number of values on the first and
+ *   second line of each node record, byte order mark
+ * - Node numbers (uint32), padded to a multiple of 8 bytes
+ * - Timestep offsets (uint64), 0 for timesteps that have not been written
+ * - One record per timestep: the timestep header values (float64) followed by all
+ *   node values (float32 or float64), padded to a multiple of 8 bytes
+ *
+ * Timesteps are numbered from 1, as they are in the ASCII files.
+ *
+ */
+class BinaryBoundaryConditions
+{
+	public:
+		BinaryBoundaryConditions();
+		~BinaryBoundaryConditions();
+
+		static bool	IsBinaryFile(QString path);
+		static void	ParseValues(const std::string &line, std::vector<double> &values);
+		static QString	FormatValues(const double *values, unsigned int count, unsigned int valueSize);
+		static QString	FormatNodeRecord(unsigned int nodeNumber, const double *values, unsigned int recordValuesLine1,
+						 unsigned int recordValuesLine2, unsigned int recordValueSize);
+		static bool	ReadAsciiTimestep(std::istream &stream, unsigned int numRecordNodes, std::vector<double> &header,
+					  std::vector<unsigned int> &recordNodes, std::vector<double> &values,
+					  unsigned int &recordValuesLine1, unsigned int &recordValuesLine2);
+
+		/* Reading */
+		bool	OpenForReading(QString path);
+		bool	Refresh();
+		bool	TimestepAvailable(unsigned int ts);
+		bool	ReadTimestepHeader(unsigned int ts, std::vector<double> &header);
+		bool	ReadTimestep(unsigned int ts, std::vector<double> &header, std::vector<double> &values);
+		bool	GatherTimestep(unsigned int ts, const std::vector<unsigned int> &recordIndices, std::vector<double> &values);
+		QString	FormatTimestepHeader(const std::vector<double> &header);
+		QString	FormatNodeRecord(unsigned int nodeNumber, const double *values);
+
+		/* Writing */
+		bool	OpenForWriting(QString path, std::vector<unsigned int> newNodeNumbers, unsigned int newNumTimesteps,
+				       unsigned int newHeaderValues, unsigned int newValuesLine1, unsigned int newValuesLine2,
+				       unsigned int newValueSize);
+		bool	OpenForAppending(QString path);
+		bool	WriteTimestep(unsigned int ts, const std::vector<double> &header, const std::vector<double> &values);
+
+		void	Close();
+
+		/* Getter Methods */
+		bool				IsOpen();
+		unsigned int			GetValueSize();
+		unsigned int			GetNumNodes();
+		unsigned int			GetNumTimesteps();
+		unsigned int			GetNumHeaderValues();
+		unsigned int			GetValuesLine1();
+		unsigned int			GetValuesLine2();
+		unsigned int			GetValuesPerNode();
+		std::vector<unsigned int>	GetNodeNumbers();
+
+	private:
+
+		QFile	file;
+		uchar*	mappedData;	/**< The memory mapped file when reading */
+		qint64	mappedSize;	/**< The number of bytes currently mapped */
+		bool	writing;
+
+		/* Header values */
+		unsigned int	valueSize;
+		unsigned int	numNodes;
+		unsigned int	numTimesteps;
+		unsigned int	headerValues;
+		unsigned int	valuesLine1;
+		unsigned int	valuesLine2;
+
+		std::vector<unsigned int>	nodeNumbers;
+
+		bool	ReadHeader();
+		bool	WriteHeader();
+		bool	MapFile();
+		void	UnmapFile();
+
+		qint64	NodeNumbersOffset();
+		qint64	IndexOffset();
+		qint64	FirstRecordOffset();
+		qint64	RecordSize();
+		qint64	TimestepOffset(unsigned int ts);
+		static qint64	PadToEight(qint64 size);
+};
+
+#endif // BINARYBOUNDARYCONDITIONS_H
@@ -0,0 +1,278 @@
+#include "BoundaryCache.h"
+
+BoundaryCache::BoundaryCache()
+{
+	cachePath = "";
+	fort14Path = "";
+	py140Path = "";
+}
+
+
+BoundaryCache::BoundaryCache(QString domainPath, QString newFort14, QString newPy140)
+{
+	SetDomainPath(domainPath);
+	SetSourceFiles(newFort14, newPy140);
+}
+
+
+void BoundaryCache::SetDomainPath(QString newPath)
+{
+	if (newPath.isEmpty())
+		cachePath = "";
+	else
+		cachePath = newPath + QDir::separator() + BOUNDARY_CACHE_NAME;
+}
+
+
+void BoundaryCache::SetSourceFiles(QString newFort14, QString newPy140)
+{
+	fort14Path = newFort14;
+	py140Path = newPy140;
+}
+
+
+/**
+ * @brief Reads the cached boundary nodes if they are still valid
+ *
+ * Reads the cached boundary nodes if they are still valid, meaning the subdomain
+ * fort.14 and py.140 files have the same contents as when the cache was written.
+ *
+ * @param innerNodes The cached inner boundary nodes
+ * @param outerNodes The cached outer boundary nodes
+ * @return true if the cache exists and is valid
+ */
+bool BoundaryCache::Read(std::vector<unsigned int> &innerNodes, std::vector<unsigned int> &outerNodes)
+{
+	if (cachePath.isEmpty())
+		return false;
+
+	std::ifstream file (cachePath.toStdString().data());
+	if (!file.is_open())
+		return false;
+
+	std::string fort14Line, py140Line;
+	if (!ReadStamps(file, fort14Line, py140Line))
+		return false;
+
+	bool fort14Current = false, py140Current = false;
+	if (!StampMatches(fort14Line, fort14Path, fort14Current) || !StampMatches(py140Line, py140Path, py140Current))
+		return false;
+
+	if (!ReadNodeList(file, innerNodes) || !ReadNodeList(file, outerNodes))
+		return false;
+	file.close();
+
+	/* A source file was touched but not changed, so store its new stamp to avoid hashing it again */
+	if (!fort14Current || !py140Current)
+		Write(innerNodes, outerNodes);
+
+	return true;
+}
+
+
+/**
+ * @brief Writes the boundary nodes to the cache
+ *
+ * Writes the boundary nodes to the cache along with the current stamps of the
+ * subdomain fort.14 and py.140 files. A source file is only hashed if its size or
+ * modification time differ from the stamp in the existing cache. The cache is
+ * written to a temporary file first so that an interrupted write never leaves a
+ * cache that looks valid.
+ *
+ * @param innerNodes The inner boundary nodes
+ * @param outerNodes The outer boundary nodes
+ * @return true if the cache was written
+ */
+bool BoundaryCache::Write(const std::vector<unsigned int> &innerNodes, const std::vector<unsigned int> &outerNodes)
+{
+	if (cachePath.isEmpty())
+		return false;
+
+	QString fort14Hash, py140Hash;
+	std::ifstream oldFile (cachePath.toStdString().data());
+	if (oldFile.is_open())
+	{
+		std::string fort14Line, py140Line;
+		if (ReadStamps(oldFile, fort14Line, py140Line))
+		{
+			fort14Hash = StoredHash(fort14Line, fort14Path);
+			py140Hash = StoredHash(py140Line, py140Path);
+		}
+		oldFile.close();
+	}
+
+	QString fort14Stamp = StampLine("fort14", fort14Path, fort14Hash);
+	QString py140Stamp = StampLine("py140", py140Path, py140Hash);
+	if (fort14Stamp.isEmpty() || py140Stamp.isEmpty())
+		return false;
+
+	QString tempPath = cachePath + ".tmp";
+	std::ofstream file (tempPath.toStdString().data());
+	if (!file.is_open())
+		return false;
+
+	file << BOUNDARY_CACHE_NAME << " " << BOUNDARY_CACHE_VERSION << "\n";
+	file << fort14Stamp.toStdString() << "\n";
+	file << py140Stamp.toStdString() << "\n";
+	file << innerNodes.size() << " inner\n";
+	for (std::vector<unsigned int>::const_iterator it = innerNodes.begin(); it != innerNodes.end(); ++it)
+		file << *it << "\n";
+	file << outerNodes.size() << " outer\n";
+	for (std::vector<unsigned int>::const_iterator it = outerNodes.begin(); it != outerNodes.end(); ++it)
+		file << *it << "\n";
+	file.close();
+
+	if (file.fail())
+	{
+		QFile::remove(tempPath);
+		return false;
+	}
+
+	QFile::remove(cachePath);
+	return QFile::rename(tempPath, cachePath);
+}
+
+
+QString BoundaryCache::GetCachePath()
+{
+	return cachePath;
+}
+
+
+/**
+ * @brief Checks a stored file stamp against the file on disk
+ *
+ * Checks a stored file stamp against the file on disk. If the size and
+ * modification time still match, the file is assumed to be unchanged. Otherwise
+ * the file is hashed and compared to the stored hash, so touching a file without
+ * changing it does not invalidate the cache.
+ *
+ * @param line The stored stamp: label, size, modification time, and hash
+ * @param sourcePath The file on disk
+ * @param stampCurrent Set to true if the size and modification time matched
+ * @return true if the file has not changed
+ */
+bool BoundaryCache::StampMatches(std::string line, QString sourcePath, bool &stampCurrent)
+{
+	stampCurrent = !StoredHash(line, sourcePath).isEmpty();
+	if (stampCurrent)
+		return true;
+
+	std::string label, hash;
+	std::stringstream lineStream (line);
+	lineStream >> label >> label >> label >> hash;
+
+	QString currentHash = HashFile(sourcePath);
+	return !currentHash.isEmpty() && currentHash == QString(hash.data());
+}
+
+
+/**
+ * @brief Builds the stamp line of a source file
+ * @param label The label at the start of the line
+ * @param sourcePath The file on disk
+ * @param knownHash The hash of the file if it is already known, or an empty string to hash it
+ * @return The stamp line, or an empty string if the file does not exist
+ */
+QString BoundaryCache::StampLine(QString label, QString sourcePath, QString knownHash)
+{
+	QFileInfo info (sourcePath);
+	if (sourcePath.isEmpty() || !info.exists())
+		return QString();
+
+	QString hash = knownHash.isEmpty() ? HashFile(sourcePath) : knownHash;
+	if (hash.isEmpty())
+		return QString();
+
+	return label + " " + QString::number(info.size()) + " " +
+			QString::number(info.lastModified().toTime_t()) + " " + hash;
+}
+
+
+/**
+ * @brief Gets the hash from a stored stamp if the file's size and modification time still match
+ * @param line The stored stamp: label, size, modification time, and hash
+ * @param sourcePath The file on disk
+ * @return The stored hash, or an empty string if the file has changed or does not exist
+ */
+QString BoundaryCache::StoredHash(std::string line, QString sourcePath)
+{
+	QFileInfo info (sourcePath);
+	if (sourcePath.isEmpty() || !info.exists())
+		return QString();
+
+	std::string label, hash;
+	qint64 size = -1;
+	unsigned int modified = 0;
+	std::stringstream lineStream (line);
+	lineStream >> label >> size >> modified >> hash;
+
+	if (size == info.size() && modified == info.lastModified().toTime_t())
+		return QString(hash.data());
+	return QString();
+}
+
+
+/**
+ * @brief Reads the version line and the two stamp lines at the top of the cache
+ * @param file The open cache file
+ * @param fort14Line The stored stamp of the subdomain fort.14
+ * @param py140Line The stored stamp of the subdomain py.140
+ * @return true if the cache is the current version and has both stamps
+ */
+bool BoundaryCache::ReadStamps(std::ifstream &file, std::string &fort14Line, std::string &py140Line)
+{
+	std::string line, name;
+	int version = 0;
+	if (!std::getline(file, line))
+		return false;
+	std::stringstream(line) >> name >> version;
+	if (version != BOUNDARY_CACHE_VERSION)
+		return false;
+
+	return std::getline(file, fort14Line) && std::getline(file, py140Line);
+}
+
+
+bool BoundaryCache::ReadNodeList(std::ifstream &file, std::vector<unsigned int> &nodes)
+{
+	std::string line;
+	unsigned int count = 0;
+	if (!std::getline(file, line))
+		return false;
+	std::stringstream(line) >> count;
+
+	nodes.clear();
+	nodes.reserve(count);
+	unsigned int currNode;
+	for (unsigned int i=0; i<count; ++i)
+	{
+		if (!(file >> currNode))
+			return false;
+		nodes.push_back(currNode);
+	}
+
+	/* Move past the end of the last line */
+	std::getline(file, line);
+	return true;
+}
+
+
+/**
+ * @brief Computes the MD5 hash of a file
+ * @param path The file
+ * @return The hash as a hex string, or an empty string if the file could not be read
+ */
+QString BoundaryCache::HashFile(QString path)
+{
+	QFile file (path);
+	if (!file.open(QIODevice::ReadOnly))
+		return QString();
+
+	QCryptographicHash hash (QCryptographicHash::Md5);
+	while (!file.atEnd())
+		hash.addData(file.read(BOUNDARY_CACHE_CHUNK));
+	file.close();
+
+	return QString(hash.result().toHex());
+}
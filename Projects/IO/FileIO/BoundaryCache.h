@@ -0,0 +1,64 @@
+#ifndef BOUNDARYCACHE_H
+#define BOUNDARYCACHE_H
+
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <QString>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QCryptographicHash>
+
+#define BOUNDARY_CACHE_NAME	"boundaryNodes.cache"
+#define BOUNDARY_CACHE_VERSION	1
+#define BOUNDARY_CACHE_CHUNK	1048576
+
+
+/**
+ * @brief Caches the inner and outer boundary nodes of a subdomain in its directory
+ *
+ * Finding a subdomain's boundary nodes means walking every edge of its mesh and
+ * converting the results through py.140. The results only change when the subdomain
+ * fort.14 or py.140 change, so they are stored in the subdomain directory keyed on
+ * the MD5 hashes of both files. The size and modification time of each file are
+ * stored as well, so an unchanged file does not need to be hashed again, either
+ * when the cache is read or when it is rewritten. A file that was touched without
+ * being changed is hashed once, and its new stamp is written back to the cache.
+ *
+ * The boundary nodes are stored using full domain node numbers.
+ *
+ */
+class BoundaryCache
+{
+	public:
+		BoundaryCache();
+		BoundaryCache(QString domainPath, QString newFort14, QString newPy140);
+
+		void	SetDomainPath(QString newPath);
+		void	SetSourceFiles(QString newFort14, QString newPy140);
+
+		bool	Read(std::vector<unsigned int> &innerNodes, std::vector<unsigned int> &outerNodes);
+		bool	Write(const std::vector<unsigned int> &innerNodes, const std::vector<unsigned int> &outerNodes);
+
+		QString	GetCachePath();
+
+	private:
+
+		QString	cachePath;
+		QString	fort14Path;
+		QString	py140Path;
+
+		bool	StampMatches(std::string line, QString sourcePath, bool &stampCurrent);
+		QString	StampLine(QString label, QString sourcePath, QString knownHash);
+		QString	StoredHash(std::string line, QString sourcePath);
+		bool	ReadStamps(std::ifstream &file, std::string &fort14Line, std::string &py140Line);
+		bool	ReadNodeList(std::ifstream &file, std::vector<unsigned int> &nodes);
+
+		static QString	HashFile(QString path);
+};
+
+#endif // BOUNDARYCACHE_H
@@ -0,0 +1,215 @@
+#include "BoundaryResampler.h"
+#include <cmath>
+
+BoundaryResampler::BoundaryResampler()
+{
+	recordInterval = 1.0;
+	outputInterval = 1.0;
+	valuesLine1 = 0;
+	valuesLine2 = 0;
+	numAdded = 0;
+	numOutput = 0;
+}
+
+
+BoundaryResampler::BoundaryResampler(double newRecordInterval, double newOutputInterval)
+{
+	recordInterval = 1.0;
+	outputInterval = 1.0;
+	valuesLine1 = 0;
+	valuesLine2 = 0;
+	numAdded = 0;
+	numOutput = 0;
+	SetIntervals(newRecordInterval, newOutputInterval);
+}
+
+
+/**
+ * @brief Sets the interval of the recorded timesteps and of the output timesteps
+ *
+ * Sets the interval of the recorded timesteps and of the output timesteps. Both
+ * intervals must be in the same units.
+ *
+ * @param newRecordInterval The time between recorded timesteps
+ * @param newOutputInterval The time between output timesteps
+ */
+void BoundaryResampler::SetIntervals(double newRecordInterval, double newOutputInterval)
+{
+	if (newRecordInterval > 0.0 && newOutputInterval > 0.0)
+	{
+		recordInterval = newRecordInterval;
+		outputInterval = newOutputInterval;
+	}
+}
+
+
+/**
+ * @brief Sets the number of values on each line of a node record
+ * @param newValuesLine1 The number of values on the first line (after the node number)
+ * @param newValuesLine2 The number of values on the second line
+ */
+void BoundaryResampler::SetLayout(unsigned int newValuesLine1, unsigned int newValuesLine2)
+{
+	valuesLine1 = newValuesLine1;
+	valuesLine2 = newValuesLine2;
+}
+
+
+/**
+ * @brief Returns the number of output timesteps that a recorded series produces
+ * @param numRecorded The number of recorded timesteps
+ * @return The number of output timesteps
+ */
+unsigned int BoundaryResampler::GetNumOutputTimesteps(unsigned int numRecorded)
+{
+	if (numRecorded == 0)
+		return 0;
+	return (unsigned int)std::floor((numRecorded-1)*recordInterval/outputInterval + 1.0e-9) + 1;
+}
+
+
+/**
+ * @brief Returns the number of the most recent output timestep (starting from 1)
+ * @return The output timestep last returned by NextOutput()
+ */
+unsigned int BoundaryResampler::GetOutputTimestep()
+{
+	return numOutput;
+}
+
+
+/**
+ * @brief Adds the next recorded timestep
+ *
+ * Adds the next recorded timestep. The oldest of the two timesteps in memory is
+ * dropped, so NextOutput() should be called until it returns false after every
+ * recorded timestep is added.
+ *
+ * @param header The timestep header values
+ * @param values The node values of the timestep, in record order
+ */
+void BoundaryResampler::AddTimestep(const std::vector<double> &header, const std::vector<double> &values)
+{
+	previousHeader.swap(currentHeader);
+	previousValues.swap(currentValues);
+	currentHeader = header;
+	currentValues = values;
+	++numAdded;
+}
+
+
+/**
+ * @brief Produces the next output timestep if it is covered by the recorded timesteps
+ * @param header The interpolated timestep header values
+ * @param values The interpolated node values
+ * @return true if an output timestep was produced
+ */
+bool BoundaryResampler::NextOutput(std::vector<double> &header, std::vector<double> &values)
+{
+	if (numAdded == 0)
+		return false;
+
+	double position = OutputPosition(numOutput);
+	double lastPosition = numAdded - 1;
+	if (position > lastPosition)
+		return false;
+
+	if (numAdded == 1)
+	{
+		header = currentHeader;
+		values = currentValues;
+	} else {
+		double weight = position - (lastPosition - 1.0);
+		if (weight < 0.0)
+			weight = 0.0;
+
+		Blend(previousHeader, currentHeader, weight, header);
+		Blend(previousValues, currentValues, weight, values);
+		SetIteration(header);
+
+		/* Node codes are not interpolated */
+		unsigned int valuesPerNode = valuesLine1 + valuesLine2;
+		if (valuesLine1 > 1 && valuesPerNode > 0)
+		{
+			const std::vector<double> &nearer = weight < 0.5 ? previousValues : currentValues;
+			for (unsigned int i=0; i+valuesPerNode <= values.size() && i+valuesPerNode <= nearer.size(); i += valuesPerNode)
+				for (unsigned int j=1; j<valuesLine1; ++j)
+					values[i+j] = nearer[i+j];
+		}
+	}
+
+	++numOutput;
+	return true;
+}
+
+
+/**
+ * @brief Returns the position of an output timestep in units of recorded timesteps
+ *
+ * Returns the position of an output timestep in units of recorded timesteps,
+ * snapped to a whole recorded timestep when it lands on one so that rounding
+ * error does not push it past the last recorded timestep.
+ *
+ * @param outputIndex The output timestep (starting from 0)
+ * @return The position, where 0 is the first recorded timestep
+ */
+double BoundaryResampler::OutputPosition(unsigned int outputIndex)
+{
+	double position = outputIndex*outputInterval/recordInterval;
+	double nearest = std::floor(position + 0.5);
+	if (std::fabs(position - nearest) < 1.0e-9)
+		return nearest;
+	return position;
+}
+
+
+/**
+ * @brief Sets the iteration of an output timestep header from its time
+ *
+ * Sets the iteration of an output timestep header (the second value, after the time)
+ * from its time. The model timestep (DTDP) is the time between the two recorded
+ * timesteps divided by the iterations between them, so the iteration is a whole
+ * number of model timesteps past the earlier one, instead of a blend of the two.
+ *
+ * @param header The interpolated header, whose iteration is replaced
+ */
+void BoundaryResampler::SetIteration(std::vector<double> &header)
+{
+	if (header.size() < 2 || previousHeader.size() < 2 || currentHeader.size() < 2)
+		return;
+
+	double iterations = currentHeader[1] - previousHeader[1];
+	if (iterations <= 0.0)
+		return;
+
+	double modelTimestep = (currentHeader[0] - previousHeader[0]) / iterations;
+	if (modelTimestep <= 0.0)
+		return;
+	header[1] = previousHeader[1] + std::floor((header[0] - previousHeader[0]) / modelTimestep + 0.5);
+}
+
+
+/**
+ * @brief Linearly blends two timesteps
+ *
+ * Linearly blends two timesteps. The loop runs over contiguous arrays without
+ * branches so the compiler can vectorize it across all nodes.
+ *
+ * @param first The earlier timestep
+ * @param second The later timestep
+ * @param weight The weight of the later timestep, from 0 to 1
+ * @param result The blended values
+ */
+void BoundaryResampler::Blend(const std::vector<double> &first, const std::vector<double> &second, double weight, std::vector<double> &result)
+{
+	size_t count = first.size() < second.size() ? first.size() : second.size();
+	result.resize(count);
+	if (count == 0)
+		return;
+
+	const double *a = &first[0];
+	const double *b = &second[0];
+	double *out = &result[0];
+	for (size_t i=0; i<count; ++i)
+		out[i] = a[i] + weight*(b[i] - a[i]);
+}
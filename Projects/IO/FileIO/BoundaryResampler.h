@@ -0,0 +1,66 @@
+#ifndef BOUNDARYRESAMPLER_H
+#define BOUNDARYRESAMPLER_H
+
+#include <vector>
+#include <cmath>
+
+
+/**
+ * @brief Streams one subdomain's boundary condition series onto a new time interval
+ *
+ * The full domain records boundary conditions at the record frequency chosen in
+ * fort.015. When a subdomain is run with a different timestep, its fort.020 file
+ * needs the boundary conditions at a different interval. The resampler sits in the
+ * carve pipeline: recorded timesteps are added in order as they are carved, and
+ * every output timestep that falls between the two most recent recorded timesteps
+ * is produced by linear interpolation. Only those two recorded timesteps are kept
+ * in memory.
+ *
+ * Output timesteps start at the first recorded timestep. The first value on the
+ * first line of each node record (water surface elevation) and every value on the
+ * second line (velocities) are interpolated. Any remaining values on the first line
+ * are node codes, which are taken from the nearer recorded timestep. The time in the
+ * timestep header is interpolated, and the iteration is found from it so that it
+ * stays a whole number.
+ *
+ * Both intervals are in seconds. The interval of fort.066 is the record frequency
+ * of fort.015 (NSPOOLGS, in timesteps) times the model timestep of fort.15.
+ *
+ */
+class BoundaryResampler
+{
+	public:
+		BoundaryResampler();
+		BoundaryResampler(double newRecordInterval, double newOutputInterval);
+
+		void	SetIntervals(double newRecordInterval, double newOutputInterval);
+		void	SetLayout(unsigned int newValuesLine1, unsigned int newValuesLine2);
+
+		unsigned int	GetNumOutputTimesteps(unsigned int numRecorded);
+		unsigned int	GetOutputTimestep();
+
+		void	AddTimestep(const std::vector<double> &header, const std::vector<double> &values);
+		bool	NextOutput(std::vector<double> &header, std::vector<double> &values);
+
+	private:
+
+		double		recordInterval;
+		double		outputInterval;
+		unsigned int	valuesLine1;
+		unsigned int	valuesLine2;
+
+		unsigned int	numAdded;	/**< The number of recorded timesteps added so far */
+		unsigned int	numOutput;	/**< The number of output timesteps produced so far */
+
+		/* The two most recent recorded timesteps */
+		std::vector<double>	previousHeader;
+		std::vector<double>	previousValues;
+		std::vector<double>	currentHeader;
+		std::vector<double>	currentValues;
+
+		double	OutputPosition(unsigned int outputIndex);
+		void	SetIteration(std::vector<double> &header);
+		void	Blend(const std::vector<double> &first, const std::vector<double> &second, double weight, std::vector<double> &result);
+};
+
+#endif // BOUNDARYRESAMPLER_H
@@ -1,10 +1,12 @@
 #include "Fort015.h"
 
-Fort015::Fort015()
+Fort015::Fort015(QObject *parent) :
+	QObject(parent)
 {
 	targetPath = "";
 	subdomainApproach = -1;
 	recordFrequency = -1;
+	fullDomainWritten = false;
 }
 
 Fort015::~Fort015()
@@ -19,7 +21,7 @@ void Fort015::SetPath(QString newPath)
 }
 
 
-void Fort015::SetSubdomains(std::vector<Domain *> newList)
+void Fort015::SetSubdomains(std::vector<SubdomainFiles> newList)
 {
 	subDomains = newList;
 }
@@ -40,6 +42,8 @@ void Fort015::SetRecordFrequency(int frequency)
 bool Fort015::WriteFort015FullDomain()
 {
 	ExtractAllBoundaryNodes();
+	if (TaskScheduler::Instance()->CurrentTaskCancelled())
+		return false;
 //	ExtractAllOuterBoundaryNodes();
 //	if (subdomainApproach == 2)
 //	{
@@ -59,12 +63,12 @@ bool Fort015::WriteFort015FullDomain()
 			fort015 << recordFrequency << "\t!NSPOOLGS" << std::endl;
 			fort015 << "0\t!enforceBN" << std::endl;
 			fort015 << outerBoundaries.size() << "\t!nobnr" << std::endl;
-			for (std::set<unsigned int>::iterator it = outerBoundaries.begin(); it != outerBoundaries.end(); ++it)
+			for (std::vector<unsigned int>::iterator it = outerBoundaries.begin(); it != outerBoundaries.end(); ++it)
 			{
 				fort015 << *it << std::endl;
 			}
 			fort015 << innerBoundaries.size() << "\t!nibnr" << std::endl;
-			for (std::set<unsigned int>::iterator it = innerBoundaries.begin(); it != innerBoundaries.end(); ++it)
+			for (std::vector<unsigned int>::iterator it = innerBoundaries.begin(); it != innerBoundaries.end(); ++it)
 			{
 				fort015 << *it << std::endl;
 			}
@@ -100,6 +104,110 @@ bool Fort015::WriteFort015Subdomain()
 }
 
 
+/**
+ * @brief Writes a fort.015 file into every processor directory of a partitioned run
+ *
+ * Writes a fort.015 file into every processor directory (PE0000, PE0001, ...) that
+ * adcprep created in the target path. Each processor of padcirc reads fort.015 from
+ * its own directory and uses the node numbers as local node numbers, so the full
+ * domain fort.015 in the target path is read back and each boundary node is written
+ * to the processor that owns it, renumbered with the local to global node table in
+ * that processor's fort.18. Ghost nodes are left out so that every boundary node is
+ * recorded by exactly one processor.
+ *
+ * @return true if a fort.015 file was written into every processor directory
+ */
+bool Fort015::WriteFort015Partitioned()
+{
+	int enforceBN = 0;
+	if (targetPath.isEmpty() || !ReadFort015(targetPath + QDir::separator() + "fort.015", enforceBN))
+		return false;
+
+	QDir runDirectory (targetPath);
+	QStringList processorDirectories = runDirectory.entryList(QStringList("PE*"), QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+	if (processorDirectories.size() == 0)
+		return false;
+
+	for (int i=0; i<processorDirectories.size(); ++i)
+	{
+		QString processorPath = runDirectory.absoluteFilePath(processorDirectories[i]);
+		std::vector<int> localToGlobal;
+		if (!ReadLocalToGlobal(processorPath + QDir::separator() + "fort.18", localToGlobal))
+		{
+			std::cout << "WARNING: Unable to read " << processorPath.toStdString().data() << "/fort.18" << std::endl;
+			return false;
+		}
+
+		/* Local numbers of the nodes this processor owns, in full domain node order */
+		std::vector<std::pair<unsigned int, unsigned int> > residentNodes;
+		for (unsigned int local=0; local<localToGlobal.size(); ++local)
+			if (localToGlobal[local] > 0)
+				residentNodes.push_back(std::pair<unsigned int, unsigned int>(localToGlobal[local], local+1));
+		std::sort(residentNodes.begin(), residentNodes.end());
+
+		std::vector<unsigned int> localOuter, localInner;
+		for (std::vector<std::pair<unsigned int, unsigned int> >::iterator it = residentNodes.begin(); it != residentNodes.end(); ++it)
+		{
+			if (std::binary_search(outerBoundaries.begin(), outerBoundaries.end(), it->first))
+				localOuter.push_back(it->second);
+			if (std::binary_search(innerBoundaries.begin(), innerBoundaries.end(), it->first))
+				localInner.push_back(it->second);
+		}
+
+		std::ofstream fort015 ((processorPath + QDir::separator() + "fort.015").toStdString().data());
+		if (!fort015.is_open())
+			return false;
+
+		fort015 << subdomainApproach << "\t!NOUTGS" << std::endl;
+		fort015 << recordFrequency << "\t!NSPOOLGS" << std::endl;
+		fort015 << enforceBN << "\t!enforceBN" << std::endl;
+		fort015 << localOuter.size() << "\t!nobnr" << std::endl;
+		for (std::vector<unsigned int>::iterator it = localOuter.begin(); it != localOuter.end(); ++it)
+			fort015 << *it << std::endl;
+		fort015 << localInner.size() << "\t!nibnr" << std::endl;
+		for (std::vector<unsigned int>::iterator it = localInner.begin(); it != localInner.end(); ++it)
+			fort015 << *it << std::endl;
+		fort015.close();
+	}
+
+	return true;
+}
+
+
+/**
+ * @brief Returns true if writeFullDomain() has written the full domain file
+ * @return true if the file was written
+ */
+bool Fort015::FullDomainWritten()
+{
+	return fullDomainWritten;
+}
+
+
+/**
+ * @brief Writes the full domain file, for use as a task on the TaskScheduler
+ *
+ * Writes the full domain file, for use as a task on the TaskScheduler. The outcome
+ * is kept for FullDomainWritten(), since a slot started as a task cannot return it.
+ *
+ */
+void Fort015::writeFullDomain()
+{
+	fullDomainWritten = WriteFort015FullDomain();
+}
+
+
+/**
+ * @brief Finds the boundary nodes of every subdomain, in full domain node numbers
+ *
+ * Finds the boundary nodes of every subdomain, in full domain node numbers. Each
+ * subdomain is handled by a BoundaryExtractionTask, and all of the tasks run in
+ * parallel on the TaskScheduler. Subdomains whose fort.14 and py.140 files have not
+ * changed since the last extraction are read from the cache in their directory.
+ * The results are merged into the sorted, unique inner and outer boundary lists.
+ *
+ * @return true if boundary nodes were found for every subdomain
+ */
 bool Fort015::ExtractAllBoundaryNodes()
 {
 	std::cout << "Extracting all boundary nodes from " << subDomains.size() << " subdomains" << std::endl;
@@ -107,28 +215,41 @@ bool Fort015::ExtractAllBoundaryNodes()
 	outerBoundaries.clear();
 	if (subDomains.size() > 0)
 	{
-		Domain *currSubdomain = 0;
-		for (std::vector<Domain*>::iterator it=subDomains.begin(); it != subDomains.end(); ++it)
+		TaskGroup extractionTasks;
+		std::vector<BoundaryExtractionTask*> tasks;
+		for (unsigned int i=0; i<subDomains.size() && !TaskScheduler::Instance()->CurrentTaskCancelled(); ++i)
 		{
-			currSubdomain = *it;
-			if (currSubdomain)
-			{
-				Boundaries currBoundaries = boundaryFinder.FindAllBoundaries(currSubdomain->GetAllElements());
-
-				Py140 currPy140 (currSubdomain->GetPy140Location());
-				currBoundaries.innerBoundaryNodes = currPy140.ConvertNewToOld(currBoundaries.innerBoundaryNodes);
-				currBoundaries.outerBoundaryNodes = currPy140.ConvertNewToOld(currBoundaries.outerBoundaryNodes);
-
-				std::cout << "Found " << currBoundaries.innerBoundaryNodes.size() << " inner boundary nodes and " <<
-					     currBoundaries.outerBoundaryNodes.size() << " outer boundary nodes" << std::endl;
-				if (currBoundaries.innerBoundaryNodes.size() > 0)
-					innerBoundaries.insert(currBoundaries.innerBoundaryNodes.begin(), currBoundaries.innerBoundaryNodes.end());
-				if (currBoundaries.outerBoundaryNodes.size() > 0)
-					outerBoundaries.insert(currBoundaries.outerBoundaryNodes.begin(), currBoundaries.outerBoundaryNodes.end());
-			} else {
-				return false;
-			}
+			BoundaryExtractionTask *currTask = new BoundaryExtractionTask(subDomains[i]);
+			currTask->setAutoDelete(false);
+			tasks.push_back(currTask);
+			TaskScheduler::Instance()->Start(currTask, TASK_PRIORITY_NORMAL, &extractionTasks);
 		}
+		extractionTasks.Wait();
+
+		bool allSucceeded = true;
+		for (std::vector<BoundaryExtractionTask*>::iterator it=tasks.begin(); it != tasks.end(); ++it)
+		{
+			BoundaryExtractionTask *currTask = *it;
+			std::vector<unsigned int> currInner = currTask->GetInnerBoundaryNodes();
+			std::vector<unsigned int> currOuter = currTask->GetOuterBoundaryNodes();
+
+			std::cout << "Found " << currInner.size() << " inner boundary nodes and " <<
+				     currOuter.size() << " outer boundary nodes" <<
+				     (currTask->UsedCache() ? " (cached)" : "") << std::endl;
+
+			innerBoundaries.insert(innerBoundaries.end(), currInner.begin(), currInner.end());
+			outerBoundaries.insert(outerBoundaries.end(), currOuter.begin(), currOuter.end());
+			allSucceeded = allSucceeded && currTask->Succeeded();
+			delete currTask;
+		}
+
+		std::sort(innerBoundaries.begin(), innerBoundaries.end());
+		innerBoundaries.erase(std::unique(innerBoundaries.begin(), innerBoundaries.end()), innerBoundaries.end());
+		std::sort(outerBoundaries.begin(), outerBoundaries.end());
+		outerBoundaries.erase(std::unique(outerBoundaries.begin(), outerBoundaries.end()), outerBoundaries.end());
+
+		if (!allSucceeded)
+			return false;
 		if (innerBoundaries.size() == 0)
 			return false;
 		if (outerBoundaries.size() == 0)
@@ -137,3 +258,84 @@ bool Fort015::ExtractAllBoundaryNodes()
 
 	return true;
 }
+
+
+/**
+ * @brief Reads a full domain fort.015 file into the approach, record frequency, and boundary lists
+ * @param fort015Path The file
+ * @param enforceBN Set to the enforceBN flag of the file
+ * @return true if the file was read
+ */
+bool Fort015::ReadFort015(QString fort015Path, int &enforceBN)
+{
+	std::ifstream fort015 (fort015Path.toStdString().data());
+	if (!fort015.is_open())
+		return false;
+
+	/* Every line starts with a single value, and may be followed by a comment */
+	std::string line;
+	std::vector<int> values;
+	while (std::getline(fort015, line))
+	{
+		int value;
+		if (std::stringstream(line) >> value)
+			values.push_back(value);
+	}
+
+	if (values.size() < 5)
+		return false;
+
+	subdomainApproach = values[0];
+	recordFrequency = values[1];
+	enforceBN = values[2];
+
+	unsigned int curr = 3;
+	unsigned int numOuter = values[curr++];
+	if (curr + numOuter >= values.size())
+		return false;
+	outerBoundaries.assign(values.begin()+curr, values.begin()+curr+numOuter);
+	curr += numOuter;
+
+	unsigned int numInner = values[curr++];
+	if (curr + numInner > values.size())
+		return false;
+	innerBoundaries.assign(values.begin()+curr, values.begin()+curr+numInner);
+
+	std::sort(outerBoundaries.begin(), outerBoundaries.end());
+	std::sort(innerBoundaries.begin(), innerBoundaries.end());
+	return true;
+}
+
+
+/**
+ * @brief Reads the local to global node table from a processor's fort.18 file
+ *
+ * Reads the local to global node table from a processor's fort.18 file. The table
+ * follows the NODG label, which is followed by the number of full domain nodes, the
+ * largest number of nodes on any processor, and the number of nodes on this processor.
+ * Ghost nodes, which are owned by another processor, have a negative global number.
+ *
+ * @param fort18Path The file
+ * @param localToGlobal The full domain node number of every local node, in local node order
+ * @return true if the table was read
+ */
+bool Fort015::ReadLocalToGlobal(QString fort18Path, std::vector<int> &localToGlobal)
+{
+	std::ifstream fort18 (fort18Path.toStdString().data());
+	if (!fort18.is_open())
+		return false;
+
+	std::string token;
+	while (fort18 >> token && token != "NODG");
+
+	int numGlobal = 0, maxLocal = 0, numLocal = 0;
+	if (token != "NODG" || !(fort18 >> numGlobal >> maxLocal >> numLocal) || numLocal <= 0)
+		return false;
+
+	localToGlobal.resize(numLocal);
+	for (int i=0; i<numLocal; ++i)
+		if (!(fort18 >> localToGlobal[i]))
+			return false;
+
+	return true;
+}
@@ -1,46 +1,75 @@
 #ifndef FORT015_H
 #define FORT015_H
 
-#include "Domains/Domain.h"
-#include "Layers/Actions/ElementState.h"
-#include "SubdomainTools/BoundaryFinder.h"
-#include "Projects/IO/FileIO/Py140.h"
+#include "Projects/IO/FileIO/SubdomainFiles.h"
+#include "SubdomainTools/BoundaryExtractionTask.h"
+#include "Tasks/TaskScheduler.h"
 
+#include <QObject>
 #include <QString>
 #include <QDir>
+#include <QStringList>
 
 #include <vector>
 #include <iostream>
 #include <fstream>
+#include <sstream>
+#include <algorithm>
 
-class Fort015
+/**
+ * @brief Writes the fort.015 files that tell ADCIRC which nodes to record or enforce
+ *
+ * Writes the fort.015 files that tell ADCIRC which nodes to record or enforce.
+ * The full domain file lists the inner and outer boundary nodes of every subdomain,
+ * in full domain node numbers, so the full domain run records the boundary
+ * conditions of each subdomain. A subdomain file only turns on enforcing them.
+ *
+ * The subdomains are given by their files, so fort.015 can be written without a
+ * display. Each subdomain's boundary nodes come from its BoundaryCache, or from its
+ * fort.14 file when the cache is missing or stale.
+ *
+ * Finding the boundary nodes of many subdomains takes a while, so the full domain
+ * file can also be written by starting the writeFullDomain() slot as a task on the
+ * TaskScheduler and checking FullDomainWritten() once its TaskGroup has finished.
+ *
+ */
+class Fort015 : public QObject
 {
+		Q_OBJECT
 	public:
-		Fort015();
+		Fort015(QObject *parent=0);
 		~Fort015();
 
 		void	SetPath(QString newPath);
-		void	SetSubdomains(std::vector<Domain*> newList);
+		void	SetSubdomains(std::vector<SubdomainFiles> newList);
 		void	SetApproach(int approach);
 		void	SetRecordFrequency(int frequency);
 
 		bool	WriteFort015FullDomain();
 		bool	WriteFort015Subdomain();
+		bool	WriteFort015Partitioned();
 
+		bool	FullDomainWritten();
 
-	private:
+		static bool	ReadLocalToGlobal(QString fort18Path, std::vector<int> &localToGlobal);
+
+	public slots:
 
-		BoundaryFinder boundaryFinder;
+		void	writeFullDomain();
+
+	private:
 
 		QString	targetPath;
 		int	subdomainApproach;
 		int	recordFrequency;
+		bool	fullDomainWritten;	/**< writeFullDomain() has written the full domain file */
 
-		std::vector<Domain*>		subDomains;
-		std::set<unsigned int>		innerBoundaries;
-		std::set<unsigned int>		outerBoundaries;
+		std::vector<SubdomainFiles>		subDomains;
+		std::vector<unsigned int>	innerBoundaries;	/**< Sorted, unique full domain node numbers */
+		std::vector<unsigned int>	outerBoundaries;	/**< Sorted, unique full domain node numbers */
 
 		bool	ExtractAllBoundaryNodes();
+		bool	ReadFort015(QString fort015Path, int &enforceBN);
 };
 
 #endif // FORT015_H
@@ -2,37 +2,232 @@
 
 Fort020::Fort020()
 {
+	filePath = "";
 }
 
 
 Fort020::Fort020(QString newLoc)
 {
-
+	filePath = newLoc;
 }
 
 
 Fort020::~Fort020()
 {
-
+	CloseFile();
 }
 
 
 void Fort020::SetFilePath(QString newLoc)
 {
-
+	CloseFile();
+	filePath = newLoc;
 }
 
 
+/**
+ * @brief Writes the info lines that precede the first timestep
+ *
+ * Writes the info lines that precede the first timestep. Any existing file
+ * at the target location is truncated.
+ *
+ * @param allLines The full text of the info lines
+ */
 void Fort020::WriteInfoLines(QString allLines)
 {
-
+	CloseFile();
+	if (!filePath.isEmpty())
+		file.open(filePath.toStdString().data(), std::ios_base::out | std::ios_base::trunc);
+	if (OpenFile())
+	{
+		file << allLines.toStdString();
+		file.flush();
+	}
 }
 
 
+/**
+ * @brief Appends a single timestep to the file
+ *
+ * Appends a single timestep to the file. The stream is flushed after every
+ * timestep so that a subdomain run reading the file while it is still being
+ * carved always sees complete records.
+ *
+ * @param allLines The full text of the timestep
+ */
 void Fort020::WriteTimestep(QString allLines)
 {
+	if (file.is_open() || OpenFile())
+	{
+		file << allLines.toStdString();
+		file.flush();
+	}
+}
+
+
+void Fort020::CloseFile()
+{
+	if (file.is_open())
+		file.close();
+	binaryFile.Close();
+}
+
+
+/**
+ * @brief Creates the file in the binary format
+ *
+ * Creates the file in the binary format, truncating any existing file. This
+ * takes the place of WriteInfoLines() for binary output.
+ *
+ * @param nodeNumbers The subdomain numbers of the recorded nodes
+ * @param numTS The number of timesteps that will be written
+ * @param headerValues The number of values in each timestep header
+ * @param valuesLine1 The number of values on the first line of a node record
+ * @param valuesLine2 The number of values on the second line of a node record
+ * @param valueSize 4 to store float32 values, 8 to store float64 values
+ * @return true if the file was created
+ */
+bool Fort020::WriteBinaryInfo(std::vector<unsigned int> nodeNumbers, unsigned int numTS, unsigned int headerValues,
+			      unsigned int valuesLine1, unsigned int valuesLine2, unsigned int valueSize)
+{
+	CloseFile();
+	if (filePath.isEmpty())
+		return false;
+	return binaryFile.OpenForWriting(filePath, nodeNumbers, numTS, headerValues, valuesLine1, valuesLine2, valueSize);
+}
+
+
+/**
+ * @brief Reopens an existing binary file so a restarted carve can continue it
+ * @return true if the existing file could be opened
+ */
+bool Fort020::ResumeBinary()
+{
+	CloseFile();
+	if (filePath.isEmpty())
+		return false;
+	return binaryFile.OpenForAppending(filePath);
+}
+
+
+bool Fort020::WriteBinaryTimestep(unsigned int ts, const std::vector<double> &header, const std::vector<double> &values)
+{
+	return binaryFile.WriteTimestep(ts, header, values);
+}
 
+
+/**
+ * @brief Converts an ASCII fort.020 file to the binary format
+ * @param asciiPath The existing ASCII file
+ * @param binaryPath The binary file to create
+ * @param valueSize 4 to store float32 values, 8 to store float64 values
+ * @return true if every timestep was converted
+ */
+bool Fort020::ConvertToBinary(QString asciiPath, QString binaryPath, unsigned int valueSize)
+{
+	std::ifstream asciiFile (asciiPath.toStdString().data());
+	if (!asciiFile.is_open())
+		return false;
+
+	/* Title line, counts line, then the recorded node numbers */
+	std::string line;
+	int trash = 0, numNodes = 0, numTS = 0;
+	std::getline(asciiFile, line);
+	if (!std::getline(asciiFile, line))
+		return false;
+	std::stringstream(line) >> trash >> numNodes >> numTS;
+
+	std::vector<unsigned int> nodeNumbers;
+	for (int i=0; i<numNodes && std::getline(asciiFile, line); ++i)
+	{
+		unsigned int currNode = 0;
+		std::stringstream(line) >> currNode;
+		nodeNumbers.push_back(currNode);
+	}
+
+	std::vector<double> header, values;
+	std::vector<unsigned int> recordNodes;
+	unsigned int valuesLine1 = 0, valuesLine2 = 0;
+	BinaryBoundaryConditions binaryOut;
+	int ts = 1;
+	for (; ts <= numTS; ++ts)
+	{
+		if (!BinaryBoundaryConditions::ReadAsciiTimestep(asciiFile, numNodes, header, recordNodes, values, valuesLine1, valuesLine2))
+			break;
+		if (ts == 1 && !binaryOut.OpenForWriting(binaryPath, nodeNumbers, numTS, header.size(),
+							 valuesLine1, valuesLine2, valueSize))
+			return false;
+		if (!binaryOut.WriteTimestep(ts, header, values))
+			break;
+	}
+	binaryOut.Close();
+
+	if (ts <= numTS)
+	{
+		std::cout << "WARNING: Converted " << ts-1 << " of " << numTS << " timesteps from " <<
+			     asciiPath.toStdString().data() << std::endl;
+		return false;
+	}
+	return true;
 }
 
 
+/**
+ * @brief Converts a binary fort.020 file to ASCII so ADCIRC can read it
+ * @param binaryPath The existing binary file
+ * @param asciiPath The ASCII file to create
+ * @return true if every timestep was converted
+ */
+bool Fort020::ConvertToAscii(QString binaryPath, QString asciiPath)
+{
+	BinaryBoundaryConditions binaryIn;
+	if (!binaryIn.OpenForReading(binaryPath))
+		return false;
+
+	Fort020 asciiOut (asciiPath);
+	std::vector<unsigned int> nodeNumbers = binaryIn.GetNodeNumbers();
+	unsigned int numTS = binaryIn.GetNumTimesteps();
+
+	QString infoLines = "Boundary conditions for subdomain\n";
+	infoLines.append("1\t" + QString::number(nodeNumbers.size()) + "\t" + QString::number(numTS) + "\n");
+	for (std::vector<unsigned int>::iterator it = nodeNumbers.begin(); it != nodeNumbers.end(); ++it)
+		infoLines.append(QString::number(*it) + "\n");
+	asciiOut.WriteInfoLines(infoLines);
+
+	std::vector<double> header, values;
+	unsigned int valuesPerNode = binaryIn.GetValuesPerNode();
+	unsigned int ts = 1;
+	for (; ts <= numTS && binaryIn.ReadTimestep(ts, header, values); ++ts)
+	{
+		QString currData = binaryIn.FormatTimestepHeader(header);
+		for (unsigned int i=0; i<nodeNumbers.size(); ++i)
+			currData.append(binaryIn.FormatNodeRecord(nodeNumbers[i], &values[i*valuesPerNode]));
+		asciiOut.WriteTimestep(currData);
+	}
+	asciiOut.CloseFile();
+
+	if (ts <= numTS)
+	{
+		std::cout << "WARNING: Converted " << ts-1 << " of " << numTS << " timesteps from " <<
+			     binaryPath.toStdString().data() << std::endl;
+		return false;
+	}
+	return true;
+}
 
+
+bool Fort020::OpenFile()
+{
+	if (filePath.isEmpty())
+		return false;
+
+	if (!file.is_open())
+		file.open(filePath.toStdString().data(), std::ios_base::out | std::ios_base::app);
+
+	if (!file.is_open())
+	{
+		std::cout << "Unable to open " << filePath.toStdString().data() << " for writing" << std::endl;
+		return false;
+	}
+	return true;
+}
@@ -1,8 +1,23 @@
 #ifndef FORT020_H
 #define FORT020_H
 
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
 #include <QString>
 
+#include "Projects/IO/FileIO/BinaryBoundaryConditions.h"
+
+/**
+ * @brief Writes the boundary conditions of a subdomain (fort.020)
+ *
+ * The file is written either as ASCII, which is what ADCIRC reads, or in the
+ * binary, indexed format described in BinaryBoundaryConditions. A binary file
+ * can be converted to ASCII before the subdomain run with ConvertToAscii().
+ *
+ */
 class Fort020
 {
 	public:
@@ -15,11 +30,24 @@ class Fort020
 
 		void	WriteInfoLines(QString allLines);
 		void	WriteTimestep(QString allLines);
+		void	CloseFile();
 
-	private:
+		/* Binary format */
+		bool	WriteBinaryInfo(std::vector<unsigned int> nodeNumbers, unsigned int numTS, unsigned int headerValues,
+					unsigned int valuesLine1, unsigned int valuesLine2, unsigned int valueSize);
+		bool	ResumeBinary();
+		bool	WriteBinaryTimestep(unsigned int ts, const std::vector<double> &header, const std::vector<double> &values);
 
+		static bool	ConvertToBinary(QString asciiPath, QString binaryPath, unsigned int valueSize);
+		static bool	ConvertToAscii(QString binaryPath, QString asciiPath);
+
+	private:
 
+		QString				filePath;
+		std::ofstream			file;
+		BinaryBoundaryConditions	binaryFile;
 
+		bool	OpenFile();
 
 };
 
@@ -1,112 +1,586 @@
 #include "Fort066.h"
 
-Fort066::Fort066()
+Fort066::Fort066(QObject *parent) :
+	QObject(parent)
 {
-	filePath = "";
+	Initialize("");
+}
+
+
+Fort066::Fort066(QString newLoc, QObject *parent) :
+	QObject(parent)
+{
+	Initialize(newLoc);
+}
+
+
+Fort066::~Fort066()
+{
+	CloseFile();
+	CloseFort020Files();
+	for (std::map<SubdomainFiles*, Fort020*>::iterator it = fortMaps.begin(); it != fortMaps.end(); ++it)
+		delete it->second;
+	for (std::map<SubdomainFiles*, Py140*>::iterator it = nodeMaps.begin(); it != nodeMaps.end(); ++it)
+		delete it->second;
+	for (std::map<SubdomainFiles*, BoundaryResampler*>::iterator it = resamplers.begin(); it != resamplers.end(); ++it)
+		delete it->second;
+}
+
+
+/**
+ * @brief Sets every member to its default, for both constructors
+ * @param newLoc The fort.066 file location
+ */
+void Fort066::Initialize(QString newLoc)
+{
+	filePath = newLoc;
 
 	numNodesRecorded = 0;
 	numTSRecorded = 0;
 	currentTimestep = 0;
+	firstTimestep = 1;
+	carvedAll = false;
+
+	processorInput = false;
+	binaryInput = false;
+	binaryOutput = false;
+	binaryValueSize = 8;
+	headerValues = 0;
+	valuesLine1 = 0;
+	valuesLine2 = 0;
+
+	recordInterval = 0.0;
+	outputInterval = 0.0;
+
+	followMode = false;
+	pollInterval = FOLLOW_POLL_INTERVAL;
+	idleTimeout = FOLLOW_IDLE_TIMEOUT;
+	idleTime = 0;
+	lastFileSize = 0;
+	stopRequested = false;
+	writerFinished = false;
 }
 
 
-Fort066::~Fort066()
+void Fort066::SetFilePath(QString newLoc)
 {
+	filePath = newLoc;
+}
+
 
+void Fort066::SetSubdomains(std::vector<SubdomainFiles> newDomains)
+{
+	subdomains = newDomains;
 }
 
 
-void Fort066::SetFilePath(QString newLoc)
+/**
+ * @brief Turns follow mode on or off
+ *
+ * In follow mode the fort.066 file is assumed to still be written by a running
+ * full domain ADCIRC run. Incomplete records at the end of the file are not
+ * consumed, and the carve waits for ADCIRC to append more data.
+ *
+ * @param follow true to follow a running full domain run
+ */
+void Fort066::SetFollowMode(bool follow)
 {
+	followMode = follow;
+}
+
 
+void Fort066::SetFollowPollInterval(unsigned long msec)
+{
+	if (msec > 0)
+		pollInterval = msec;
 }
 
 
-void Fort066::SetSubdomains(std::vector<Domain *> newDomains)
+void Fort066::SetFollowIdleTimeout(unsigned long msec)
 {
+	idleTimeout = msec;
+}
 
+
+/**
+ * @brief Sets the first timestep to carve
+ *
+ * Sets the first timestep to carve, so a carve that was interrupted can be
+ * restarted where it stopped. Binary fort.066 files are read starting directly
+ * at that timestep, while ASCII files have to be read up to it. The fort.020 files
+ * are continued rather than recreated: binary fort.020 files are written into
+ * their indexed slots, and ASCII fort.020 files are appended to, so they must
+ * end at the timestep before the restart.
+ *
+ * @param ts The first timestep to carve (starting from 1)
+ */
+void Fort066::SetFirstTimestep(int ts)
+{
+	firstTimestep = ts > 1 ? ts : 1;
+}
+
+
+/**
+ * @brief Writes the fort.020 files in the binary format instead of ASCII
+ * @param binary true to write binary fort.020 files
+ * @param valueSize 4 to store float32 values, 8 to store float64 values
+ */
+void Fort066::SetBinaryOutput(bool binary, unsigned int valueSize)
+{
+	binaryOutput = binary;
+	binaryValueSize = valueSize == 4 ? 4 : 8;
+}
+
+
+/**
+ * @brief Resamples each subdomain's boundary conditions onto a new interval
+ *
+ * Resamples each subdomain's boundary conditions onto a new interval while
+ * carving, for subdomains that run with a different timestep than the full
+ * domain recorded at. Both intervals are in seconds, so the record frequency of
+ * fort.015 must be multiplied by the model timestep first (see
+ * FullDomainRunner::GetRecordInterval()). Resampling is off if either interval
+ * is 0 or they are equal.
+ *
+ * @param newRecordInterval The seconds between the timesteps recorded in fort.066
+ * @param newOutputInterval The seconds between the timesteps written to fort.020
+ */
+void Fort066::SetResampling(double newRecordInterval, double newOutputInterval)
+{
+	recordInterval = newRecordInterval;
+	outputInterval = newOutputInterval;
 }
 
 
 void Fort066::CarveAllSubdomains()
 {
+	stopMutex.lock();
+	stopRequested = false;
+	stopMutex.unlock();
+	carvedAll = false;
+
 	/* Open the fort.066 file to get the number of TS recorded */
-	OpenFile();
+	if (!OpenFile())
+	{
+		emit emitMessage("<p style='color:red'><strong>Error:</strong> Unable to read fort.066 header</p>");
+		emit finishedCarving();
+		return;
+	}
+
+	emit startedCarving();
 
 	/* Loop through each subdomain:
 	 *	- Create the fort.020 file
-	 *	- Retrieve the py.140 and bnlist.14 files from the subdomain
-	 *	- Write the first chunk of info lines for the subdomain
+	 *	- Retrieve the py.140 file from the subdomain
 	 */
-	Domain *currDomain = 0;
-	for (std::vector<Domain*>::iterator it = subdomains.begin(); it != subdomains.end(); ++it)
+	SubdomainFiles *currDomain = 0;
+	for (std::vector<SubdomainFiles>::iterator it = subdomains.begin(); it != subdomains.end(); ++it)
 	{
-		currDomain = *it;
-		if (currDomain)
-		{
-			CreateFort020File(currDomain);
-			GetBNList(currDomain);
-			GetPy140File(currDomain);
-			WriteFort020FileInfoLines(currDomain);
-		}
+		currDomain = &(*it);
+		CreateFort020File(currDomain);
+		GetPy140File(currDomain);
 	}
 
 	/* Loop through each timestep of the full domain run:
-	 *	- Read the data from the timestep
+	 *	- Read the data from the timestep, waiting for it to be written in follow mode
 	 *	- Parse the data and put into a map that associates values with nodes
 	 *	Loop through each subdomain:
+	 *		- Write the info lines (or continue the existing file on a restart) once
+	 *		  the first timestep shows which nodes were recorded
 	 *		- Get all of the data needed from the appropriate nodes
 	 *		- Assemble the text of an entire timestep for the subdomain
 	 *		- Write the data to the subdomain fort.020 file
 	 */
-	currentTimestep = 1;
-	while (currentTimestep <= numTSRecorded)
+	if (ResamplingEnabled() && firstTimestep > 1)
 	{
-		ReadTimestep();
-		for (std::vector<Domain*>::iterator it = subdomains.begin(); it != subdomains.end(); ++it)
+		std::cout << "WARNING: A resampled carve cannot be restarted, carving from the first timestep" << std::endl;
+		firstTimestep = 1;
+	}
+
+	currentTimestep = binaryInput ? firstTimestep : 1;
+	bool firstRecord = true;
+	while (currentTimestep <= numTSRecorded && !CarvingStopped())
+	{
+		if (!ReadTimestep())
+		{
+			if (followMode && WaitForMoreData())
+				continue;
+			break;
+		}
+
+		/* An ASCII fort.066 has to be read up to the restart point */
+		if (currentTimestep < firstTimestep)
+		{
+			++currentTimestep;
+			continue;
+		}
+
+		for (std::vector<SubdomainFiles>::iterator it = subdomains.begin(); it != subdomains.end(); ++it)
 		{
-			currDomain = *it;
-			if (currDomain)
+			currDomain = &(*it);
+			if (firstRecord)
 			{
-				WriteFort020Timestep(currDomain);
+				FindRecordedBoundaryNodes(currDomain);
+				if (currentTimestep == 1)
+					WriteFort020FileInfoLines(currDomain);
+				else
+					ResumeFort020File(currDomain);
 			}
+			if (ResamplingEnabled())
+				ResampleFort020Timestep(currDomain);
+			else
+				WriteFort020Timestep(currDomain);
 		}
 
+		firstRecord = false;
+		emit carvedTimestep(currentTimestep);
 		++currentTimestep;
 	}
 
+	carvedAll = currentTimestep > numTSRecorded;
+	if (!carvedAll)
+	{
+		std::cout << "WARNING: Carved " << currentTimestep-1 << " of " << numTSRecorded <<
+			     " timesteps from " << filePath.toStdString().data() << std::endl;
+	}
+
 	/* Close all of the newly written fort.020 files */
+	CloseFile();
+	CloseFort020Files();
+
+	emit finishedCarving();
 }
 
 
-void Fort066::OpenFile()
+/**
+ * @brief Asks a running carve to stop after the current timestep
+ *
+ * Asks a running carve to stop after the current timestep. This is safe to
+ * call from a different thread than the one performing the carve, and wakes
+ * up a follow mode carve that is waiting for more data.
+ *
+ */
+void Fort066::StopCarving()
 {
-	readFile.open(filePath.toStdString().data());
-	if (readFile.is_open())
+	stopMutex.lock();
+	stopRequested = true;
+	stopCondition.wakeAll();
+	stopMutex.unlock();
+}
+
+
+/**
+ * @brief Tells a carve in follow mode that the run writing fort.066 has finished
+ *
+ * Tells a carve in follow mode that the run writing fort.066 has finished, so it
+ * stops waiting for more data once it has carved what is already in the file,
+ * instead of waiting for the idle timeout.
+ *
+ */
+void Fort066::FinishFollowing()
+{
+	stopMutex.lock();
+	writerFinished = true;
+	stopCondition.wakeAll();
+	stopMutex.unlock();
+}
+
+
+/**
+ * @brief Checks if the last carve reached the final timestep of fort.066
+ * @return true if every recorded timestep was carved
+ */
+bool Fort066::CarvedAllTimesteps()
+{
+	return carvedAll;
+}
+
+
+void Fort066::carveAllSubdomains()
+{
+	CarveAllSubdomains();
+}
+
+
+/**
+ * @brief Converts an ASCII fort.066 file to the binary format
+ *
+ * Converts an ASCII fort.066 file to the binary format. The record layout is
+ * taken from the first timestep, and every following timestep must record the
+ * same nodes in the same order.
+ *
+ * @param asciiPath The existing ASCII file
+ * @param binaryPath The binary file to create
+ * @param valueSize 4 to store float32 values, 8 to store float64 values
+ * @return true if every timestep was converted
+ */
+bool Fort066::ConvertToBinary(QString asciiPath, QString binaryPath, unsigned int valueSize)
+{
+	std::ifstream asciiFile (asciiPath.toStdString().data());
+	if (!asciiFile.is_open())
+		return false;
+
+	std::string line;
+	int trash = 0, numNodes = 0, numTS = 0;
+	if (!std::getline(asciiFile, line))
+		return false;
+	std::stringstream(line) >> trash >> numNodes >> numTS;
+
+	std::vector<double> header, values;
+	std::vector<unsigned int> nodeNumbers, recordNodes;
+	unsigned int lineValues1 = 0, lineValues2 = 0;
+	BinaryBoundaryConditions binaryOut;
+	int ts = 1;
+	for (; ts <= numTS; ++ts)
 	{
-		std::string firstLine;
-		std::getline(readFile, firstLine);
-		int trash;
-		std::stringstream(firstLine) >> trash >> numNodesRecorded >> numTSRecorded;
+		if (!BinaryBoundaryConditions::ReadAsciiTimestep(asciiFile, numNodes, header, recordNodes, values, lineValues1, lineValues2))
+			break;
+
+		if (ts == 1)
+		{
+			nodeNumbers = recordNodes;
+			if (!binaryOut.OpenForWriting(binaryPath, nodeNumbers, numTS, header.size(), lineValues1, lineValues2, valueSize))
+				return false;
+		}
+		else if (recordNodes != nodeNumbers)
+		{
+			std::cout << "WARNING: Timestep " << ts << " of " << asciiPath.toStdString().data() <<
+				     " records different nodes than the first timestep" << std::endl;
+			break;
+		}
+
+		if (!binaryOut.WriteTimestep(ts, header, values))
+			break;
 	}
+	binaryOut.Close();
+
+	if (ts <= numTS)
+	{
+		std::cout << "WARNING: Converted " << ts-1 << " of " << numTS << " timesteps from " <<
+			     asciiPath.toStdString().data() << std::endl;
+		return false;
+	}
+	return true;
 }
 
 
-void Fort066::ReadTimestep()
+/**
+ * @brief Converts a binary fort.066 file back to ASCII
+ * @param binaryPath The existing binary file
+ * @param asciiPath The ASCII file to create
+ * @return true if every timestep was converted
+ */
+bool Fort066::ConvertToAscii(QString binaryPath, QString asciiPath)
 {
-	if (readFile.is_open())
+	BinaryBoundaryConditions binaryIn;
+	if (!binaryIn.OpenForReading(binaryPath))
+		return false;
+
+	std::ofstream asciiFile (asciiPath.toStdString().data(), std::ios_base::out | std::ios_base::trunc);
+	if (!asciiFile.is_open())
+		return false;
+
+	std::vector<unsigned int> nodeNumbers = binaryIn.GetNodeNumbers();
+	unsigned int numTS = binaryIn.GetNumTimesteps();
+	asciiFile << "1\t" << nodeNumbers.size() << "\t" << numTS << "\n";
+
+	std::vector<double> header, values;
+	unsigned int valuesPerNode = binaryIn.GetValuesPerNode();
+	unsigned int ts = 1;
+	for (; ts <= numTS && binaryIn.ReadTimestep(ts, header, values); ++ts)
+	{
+		QString currData = binaryIn.FormatTimestepHeader(header);
+		for (unsigned int i=0; i<nodeNumbers.size(); ++i)
+			currData.append(binaryIn.FormatNodeRecord(nodeNumbers[i], &values[i*valuesPerNode]));
+		asciiFile << currData.toStdString();
+	}
+	asciiFile.close();
+
+	if (ts <= numTS)
+	{
+		std::cout << "WARNING: Converted " << ts-1 << " of " << numTS << " timesteps from " <<
+			     binaryPath.toStdString().data() << std::endl;
+		return false;
+	}
+	return true;
+}
+
+
+bool Fort066::OpenFile()
+{
+	idleTime = 0;
+	lastFileSize = 0;
+	while (!CarvingStopped())
+	{
+		if (UseProcessorFiles())
+		{
+			/* Succeeds once every processor has written its header */
+			binaryInput = false;
+			processorInput = true;
+			if (OpenProcessorFiles())
+				return true;
+		}
+		else if (BinaryBoundaryConditions::IsBinaryFile(filePath))
+		{
+			/* Succeeds once the header and index have been written */
+			CloseFile();
+			binaryInput = true;
+			processorInput = false;
+			if (binaryFile.OpenForReading(filePath))
+			{
+				numNodesRecorded = binaryFile.GetNumNodes();
+				numTSRecorded = binaryFile.GetNumTimesteps();
+				headerValues = binaryFile.GetNumHeaderValues();
+				valuesLine1 = binaryFile.GetValuesLine1();
+				valuesLine2 = binaryFile.GetValuesLine2();
+				return true;
+			}
+		}
+		else
+		{
+			binaryInput = false;
+			processorInput = false;
+			if (!readFile.is_open())
+				readFile.open(filePath.toStdString().data());
+		}
+
+		if (!binaryInput && !processorInput && readFile.is_open())
+		{
+			std::string firstLine;
+			if (ReadCompleteLine(firstLine))
+			{
+				int trash;
+				std::stringstream(firstLine) >> trash >> numNodesRecorded >> numTSRecorded;
+				return true;
+			}
+			readFile.clear();
+			readFile.seekg(0);
+		}
+
+		/* ADCIRC may not have created the file or written the header yet */
+		if (!followMode || !WaitForMoreData())
+			return false;
+	}
+	return false;
+}
+
+
+/**
+ * @brief Reads a single timestep record into currentTimestepData
+ *
+ * Reads a single timestep record into currentTimestepData. If the end of the
+ * file is hit before the record is complete, the stream is rewound to the start
+ * of the record so the read can be retried once more data has been written.
+ *
+ * For a binary fort.066 only the timestep header is read here. The node values
+ * are gathered from the mapped record for each subdomain as it is written.
+ *
+ * @return true if a complete record was read
+ */
+bool Fort066::ReadTimestep()
+{
+	if (binaryInput)
+		return binaryFile.ReadTimestepHeader(currentTimestep, tsHeader);
+
+	std::map<int, std::string> recordData;
+	std::string headerLine;
+	if (processorInput)
+	{
+		if (!ReadProcessorTimestep(headerLine, recordData))
+			return false;
+	} else {
+		if (!readFile.is_open())
+			return false;
+
+		std::streampos recordStart = readFile.tellg();
+		if (!ReadRecord(readFile, numNodesRecorded, 0, headerLine, recordData))
+		{
+			readFile.clear();
+			readFile.seekg(recordStart);
+			return false;
+		}
+	}
+
+	tsLine = headerLine;
+	currentTimestepData.swap(recordData);
+	tsHeader.clear();
+	BinaryBoundaryConditions::ParseValues(tsLine, tsHeader);
+	headerValues = tsHeader.size();
+	return true;
+}
+
+
+/**
+ * @brief Reads a single ASCII timestep record, adding each node's text to recordData
+ *
+ * Reads a single ASCII timestep record, adding each node's text to recordData. The
+ * stream is left wherever the read stopped, so the caller has to rewind it if the
+ * record was not complete.
+ *
+ * @param file The fort.066 file
+ * @param numNodes The number of nodes in the record
+ * @param toGlobal The local to global table of a processor file, or 0 if the file is numbered by full domain node
+ * @param headerLine The timestep header line
+ * @param recordData The text of each node's values, by full domain node number
+ * @return true if a complete record was read
+ */
+bool Fort066::ReadRecord(std::ifstream &file, int numNodes, std::vector<int> *toGlobal, std::string &headerLine, std::map<int, std::string> &recordData)
+{
+	std::string nodeLine, line2;
+	bool complete = ReadCompleteLine(file, headerLine);
+	for (int i=0; complete && i<numNodes; ++i)
 	{
-		int currNode;
-		std::string line1, line2;
-		std::getline(readFile, tsLine);
-		for (int i=0; i<numNodesRecorded; ++i)
+		complete = ReadCompleteLine(file, nodeLine) && ReadCompleteLine(file, line2);
+		if (complete)
 		{
-			readFile >> currNode;
-			std::getline(readFile, line1);
-			std::getline(readFile, line2);
-			currentTimestepData[currNode] = "\t" + line1 + "\n" + line2 + "\n";
+			int currNode = 0;
+			std::stringstream nodeStream (nodeLine);
+			nodeStream >> currNode;
+			std::string line1;
+			std::getline(nodeStream, line1);
+
+			/* Ghost nodes have a negative global number and are recorded by their owner */
+			if (toGlobal)
+				currNode = currNode > 0 && currNode <= (int)toGlobal->size() ? (*toGlobal)[currNode-1] : 0;
+			if (!toGlobal || currNode > 0)
+				recordData[currNode] = "\t" + line1 + "\n" + line2 + "\n";
+
+			/* The layout is needed to write binary fort.020 files */
+			if (i == 0)
+			{
+				std::vector<double> layoutValues;
+				BinaryBoundaryConditions::ParseValues(line1, layoutValues);
+				valuesLine1 = layoutValues.size();
+				layoutValues.clear();
+				BinaryBoundaryConditions::ParseValues(line2, layoutValues);
+				valuesLine2 = layoutValues.size();
+			}
 		}
 	}
+	return complete;
+}
+
+
+/**
+ * @brief Reads a line only if it has been completely written
+ *
+ * Reads a line only if it has been completely written, meaning it is terminated
+ * by a newline. A line that runs into the end of the file may still be in the
+ * middle of being written by ADCIRC.
+ *
+ * @param line The line that was read
+ * @return true if a complete line was read
+ */
+bool Fort066::ReadCompleteLine(std::string &line)
+{
+	return ReadCompleteLine(readFile, line);
+}
+
+
+bool Fort066::ReadCompleteLine(std::ifstream &file, std::string &line)
+{
+	std::getline(file, line);
+	return !file.eof() && !file.fail();
 }
 
 
@@ -116,87 +590,467 @@ void Fort066::CloseFile()
 	{
 		readFile.close();
 	}
+	readFile.clear();
+	binaryFile.Close();
+
+	for (std::vector<std::ifstream*>::iterator it = processorFiles.begin(); it != processorFiles.end(); ++it)
+		delete *it;
+	processorFiles.clear();
+	localToGlobal.clear();
+	processorNodesRecorded.clear();
 }
 
 
-void Fort066::CreateFort020File(Domain *currDomain)
+/**
+ * @brief Lists the processor directories (PE0000, PE0001, ...) of the run directory
+ * @return The directory names, in processor order
+ */
+QStringList Fort066::FindProcessorDirectories()
 {
-	if (currDomain && fortMaps.count(currDomain) == 0)
+	return QFileInfo(filePath).absoluteDir().entryList(QStringList("PE*"), QDir::Dirs | QDir::NoDotAndDotDot, QDir::Name);
+}
+
+
+/**
+ * @brief Checks if the fort.066 files of the processor directories should be read
+ *
+ * Checks if the fort.066 files of the processor directories should be read instead
+ * of the one in the run directory. adcprep writes fort.18 when it partitions the
+ * run, so a fort.066 in the run directory that is older than the partition was
+ * left by an earlier run on a single processor.
+ *
+ * @return true if the run was partitioned after fort.066 was last written in the run directory
+ */
+bool Fort066::UseProcessorFiles()
+{
+	QStringList processorDirectories = FindProcessorDirectories();
+	if (processorDirectories.isEmpty())
+		return false;
+
+	QFileInfo partition (QFileInfo(filePath).absoluteDir().absoluteFilePath(processorDirectories[0]) + QDir::separator() + "fort.18");
+	QFileInfo fullDomainFile (filePath);
+	return partition.exists() && (!fullDomainFile.exists() || fullDomainFile.lastModified() < partition.lastModified());
+}
+
+
+/**
+ * @brief Opens the fort.066 file and reads the fort.18 table of every processor
+ *
+ * Opens the fort.066 file and reads the fort.18 table of every processor. The
+ * number of recorded nodes is the sum over the processors, and the number of
+ * timesteps is the smallest any processor will write.
+ *
+ * @return true if every processor's table was read and its fort.066 header has been written
+ */
+bool Fort066::OpenProcessorFiles()
+{
+	CloseFile();
+
+	QDir runDirectory = QFileInfo(filePath).absoluteDir();
+	QStringList processorDirectories = FindProcessorDirectories();
+	numNodesRecorded = 0;
+	numTSRecorded = 0;
+	for (int i=0; i<processorDirectories.size(); ++i)
 	{
-		QString filePath = currDomain->GetDomainPath() + QDir::separator() + "fort.020";
-		if (QFile(filePath).exists())
+		QString processorPath = runDirectory.absoluteFilePath(processorDirectories[i]);
+		std::ifstream *currFile = new std::ifstream((processorPath + QDir::separator() + "fort.066").toStdString().data());
+		processorFiles.push_back(currFile);
+		localToGlobal.push_back(std::vector<int>());
+
+		std::string firstLine;
+		if (!Fort015::ReadLocalToGlobal(processorPath + QDir::separator() + "fort.18", localToGlobal.back()) ||
+		    !currFile->is_open() || !ReadCompleteLine(*currFile, firstLine))
 		{
-			std::cout << "WARNING: Overwriting fort.020 file at: " << filePath.toStdString().data() << std::endl;
+			CloseFile();
+			return false;
 		}
-		fortMaps[currDomain] = new Fort020(filePath);
+
+		int trash = 0, currNodes = 0, currTS = 0;
+		std::stringstream(firstLine) >> trash >> currNodes >> currTS;
+		processorNodesRecorded.push_back(currNodes);
+		numNodesRecorded += currNodes;
+		if (i == 0 || currTS < numTSRecorded)
+			numTSRecorded = currTS;
+	}
+
+	return !processorFiles.empty();
+}
+
+
+/**
+ * @brief Reads the same timestep from every processor file into one full domain record
+ *
+ * Reads the same timestep from every processor file into one full domain record.
+ * If any processor has not finished writing the timestep, every file is rewound to
+ * the start of the timestep so the read can be retried once more data has been written.
+ *
+ * @param headerLine The timestep header line of the first processor
+ * @param recordData The text of each node's values, by full domain node number
+ * @return true if every processor's record was complete
+ */
+bool Fort066::ReadProcessorTimestep(std::string &headerLine, std::map<int, std::string> &recordData)
+{
+	std::vector<std::streampos> recordStarts;
+	bool complete = true;
+	for (unsigned int i=0; i<processorFiles.size() && complete; ++i)
+	{
+		std::string currHeader;
+		recordStarts.push_back(processorFiles[i]->tellg());
+		complete = ReadRecord(*processorFiles[i], processorNodesRecorded[i], &localToGlobal[i], currHeader, recordData);
+		if (i == 0)
+			headerLine = currHeader;
+	}
+
+	if (!complete)
+	{
+		for (unsigned int i=0; i<recordStarts.size(); ++i)
+		{
+			processorFiles[i]->clear();
+			processorFiles[i]->seekg(recordStarts[i]);
+		}
+	}
+	return complete;
+}
+
+
+/**
+ * @brief Returns the size of fort.066, summed over the processor files of a parallel run
+ * @return The size in bytes
+ */
+qint64 Fort066::RecordedFileSize()
+{
+	if (!processorInput)
+		return QFileInfo(filePath).size();
+
+	QDir runDirectory = QFileInfo(filePath).absoluteDir();
+	QStringList processorDirectories = FindProcessorDirectories();
+	qint64 size = 0;
+	for (int i=0; i<processorDirectories.size(); ++i)
+		size += QFileInfo(runDirectory.absoluteFilePath(processorDirectories[i]) + QDir::separator() + "fort.066").size();
+	return size;
+}
+
+
+/**
+ * @brief Waits for the running full domain run to append more data
+ *
+ * Waits one poll interval for the running full domain run to append more data
+ * to fort.066. The time spent waiting without the file growing is accumulated,
+ * and waiting is abandoned once it passes the idle timeout (the run has most
+ * likely finished or died).
+ *
+ * @return true if the caller should try reading again
+ * @return false if the carve was stopped or the file has gone idle
+ */
+bool Fort066::WaitForMoreData()
+{
+	stopMutex.lock();
+	if (!stopRequested && !writerFinished)
+		stopCondition.wait(&stopMutex, pollInterval);
+	bool stopped = stopRequested;
+	bool finished = writerFinished;
+	stopMutex.unlock();
+
+	if (stopped)
+		return false;
+
+	qint64 currentSize = RecordedFileSize();
+	bool grew = currentSize != lastFileSize;
+	if (grew)
+	{
+		lastFileSize = currentSize;
+		idleTime = 0;
 	} else {
-		std::cout << "WARNING: No domain defined or domain already associated with fort.020 file" << std::endl;
+		idleTime += pollInterval;
+	}
+
+	/* Once the run is done, the file is read until it stops growing */
+	if (finished && !grew)
+		return false;
+
+	if (idleTimeout > 0 && idleTime >= idleTimeout)
+	{
+		std::cout << "WARNING: " << filePath.toStdString().data() << " has not grown in " <<
+			     idleTime/1000 << " seconds, stopping carve" << std::endl;
+		return false;
 	}
+
+	return true;
+}
+
+
+bool Fort066::ResamplingEnabled()
+{
+	return recordInterval > 0.0 && outputInterval > 0.0 && recordInterval != outputInterval;
+}
+
+
+/**
+ * @brief Returns the number of timesteps each fort.020 file will hold
+ * @return The number of timesteps recorded, or the number produced by resampling them
+ */
+int Fort066::NumFort020Timesteps()
+{
+	if (ResamplingEnabled())
+		return BoundaryResampler(recordInterval, outputInterval).GetNumOutputTimesteps(numTSRecorded);
+	return numTSRecorded;
 }
 
 
-void Fort066::GetBNList(Domain *currDomain)
+bool Fort066::CarvingStopped()
 {
-	if (currDomain && bnLists.count(currDomain) == 0)
+	stopMutex.lock();
+	bool stopped = stopRequested;
+	stopMutex.unlock();
+	return stopped || TaskScheduler::Instance()->CurrentTaskCancelled();
+}
+
+
+void Fort066::CreateFort020File(SubdomainFiles *currDomain)
+{
+	if (currDomain && fortMaps.count(currDomain) == 0)
 	{
-//		bnLists[currDomain] = new BNList14(currDomain->GetBNListLocation());
+		fortMaps[currDomain] = new Fort020(currDomain->domainPath + QDir::separator() + "fort.020");
 	} else {
-		std::cout << "WARNING: No domain defined or domain already associated with bnlist.14 file" << std::endl;
+		std::cout << "WARNING: No domain defined or domain already associated with fort.020 file" << std::endl;
 	}
 }
 
 
-void Fort066::GetPy140File(Domain *currDomain)
+void Fort066::GetPy140File(SubdomainFiles *currDomain)
 {
 	if (currDomain && nodeMaps.count(currDomain) == 0)
 	{
-		nodeMaps[currDomain] = new Py140(currDomain->GetPy140Location());
+		nodeMaps[currDomain] = new Py140(currDomain->py140Location);
 	} else {
 		std::cout << "WARNING: No domain defined or domain already associated with py.140 file" << std::endl;
 	}
 }
 
 
-void Fort066::WriteFort020FileInfoLines(Domain *currDomain)
+/**
+ * @brief Determines which of the recorded nodes belong to a subdomain
+ *
+ * fort.066 contains the boundary nodes of every subdomain in the project. Using the
+ * first timestep read (or the header of a binary file), this function finds the
+ * recorded nodes that are part of the given subdomain, ordered by their subdomain
+ * node number.
+ *
+ * @param currDomain The subdomain
+ */
+void Fort066::FindRecordedBoundaryNodes(SubdomainFiles *currDomain)
 {
-	if (currDomain && bnLists.count(currDomain) && fortMaps.count(currDomain))
+	if (currDomain && nodeMaps.count(currDomain))
 	{
-		BNList14 *currList = bnLists[currDomain];
+		std::vector<unsigned int> recordedNumbers;
+		if (binaryInput)
+		{
+			recordedNumbers = binaryFile.GetNodeNumbers();
+		} else {
+			for (std::map<int, std::string>::iterator it = currentTimestepData.begin(); it != currentTimestepData.end(); ++it)
+				recordedNumbers.push_back(it->first);
+		}
+
+		std::map<unsigned int, unsigned int> oldToNew = nodeMaps[currDomain]->GetOldToNew();
+		std::map<unsigned int, unsigned int> newToRecord;
+		for (unsigned int i=0; i<recordedNumbers.size(); ++i)
+		{
+			std::map<unsigned int, unsigned int>::iterator found = oldToNew.find(recordedNumbers[i]);
+			if (found != oldToNew.end())
+				newToRecord[found->second] = i;
+		}
+
+		std::vector<unsigned int> &recordedNodes = boundaryNodes[currDomain];
+		std::vector<unsigned int> &indices = recordIndices[currDomain];
+		recordedNodes.clear();
+		indices.clear();
+		for (std::map<unsigned int, unsigned int>::iterator it = newToRecord.begin(); it != newToRecord.end(); ++it)
+		{
+			recordedNodes.push_back(recordedNumbers[it->second]);
+			indices.push_back(it->second);
+		}
+	}
+}
+
+
+/**
+ * @brief Starts a new fort.020 file for a subdomain, truncating any existing one
+ * @param currDomain The subdomain
+ */
+void Fort066::WriteFort020FileInfoLines(SubdomainFiles *currDomain)
+{
+	if (currDomain && boundaryNodes.count(currDomain) && fortMaps.count(currDomain) && nodeMaps.count(currDomain))
+	{
+		QString fort020Path = currDomain->domainPath + QDir::separator() + "fort.020";
+		if (QFileInfo(fort020Path).size() > 0)
+			std::cout << "WARNING: Overwriting fort.020 file at: " << fort020Path.toStdString().data() << std::endl;
+
+		std::vector<unsigned int> &recordedNodes = boundaryNodes[currDomain];
+		Py140 *currNodeMap = nodeMaps[currDomain];
 		Fort020 *currFort = fortMaps[currDomain];
-		std::vector<unsigned int> outerBoundaries = currList->GetOuterBoundaryNodes();
+
+		if (binaryOutput)
+		{
+			std::vector<unsigned int> newNumbers;
+			for (std::vector<unsigned int>::iterator it = recordedNodes.begin(); it != recordedNodes.end(); ++it)
+				newNumbers.push_back(currNodeMap->ConvertOldToNew(*it));
+			currFort->WriteBinaryInfo(newNumbers, NumFort020Timesteps(), headerValues, valuesLine1, valuesLine2, binaryValueSize);
+			return;
+		}
 
 		QString infoLines = "Boundary conditions for subdomain\n";
-		infoLines.append("1\t" + QString::number(outerBoundaries.size()) + "\t" + QString::number(numTSRecorded) + "\n");
+		infoLines.append("1\t" + QString::number(recordedNodes.size()) + "\t" + QString::number(NumFort020Timesteps()) + "\n");
 
-		for (std::vector<unsigned int>::iterator it = outerBoundaries.begin(); it != outerBoundaries.end(); ++it)
+		for (std::vector<unsigned int>::iterator it = recordedNodes.begin(); it != recordedNodes.end(); ++it)
 		{
-			infoLines.append(QString::number(*it) + "\n");
+			infoLines.append(QString::number(currNodeMap->ConvertOldToNew(*it)) + "\n");
 		}
 
 		currFort->WriteInfoLines(infoLines);
 	}
-	if (currDomain && nodeMaps.count(currDomain))
-	{
-		Py140 *currPy140 = nodeMaps[currDomain];
+}
 
-	}
 
+/**
+ * @brief Continues an existing fort.020 file when a carve is restarted
+ *
+ * Continues an existing fort.020 file when a carve is restarted. A binary file
+ * is reopened so the remaining timesteps can be written into its index. An ASCII
+ * file is simply appended to by WriteFort020Timestep(). If there is no binary file
+ * to continue, a new one is created.
+ *
+ * @param currDomain The subdomain
+ */
+void Fort066::ResumeFort020File(SubdomainFiles *currDomain)
+{
+	if (binaryOutput && fortMaps.count(currDomain) && !fortMaps[currDomain]->ResumeBinary())
+	{
+		std::cout << "WARNING: Unable to continue the binary fort.020 file of " <<
+			     currDomain->domainPath.toStdString().data() << ", creating a new one" << std::endl;
+		WriteFort020FileInfoLines(currDomain);
+	}
 }
 
 
-void Fort066::WriteFort020Timestep(Domain *currDomain)
+void Fort066::WriteFort020Timestep(SubdomainFiles *currDomain)
 {
-	if (currDomain && nodeMaps.count(currDomain) && fortMaps.count(currDomain));
+	if (currDomain && boundaryNodes.count(currDomain) && nodeMaps.count(currDomain) && fortMaps.count(currDomain))
 	{
+		if (binaryInput || binaryOutput)
+		{
+			GatherSubdomainValues(currDomain, gatheredValues);
+			WriteFort020Values(currDomain, currentTimestep, tsHeader, gatheredValues);
+			return;
+		}
+
+		/* ASCII to ASCII: copy the text of each record without parsing it */
+		std::vector<unsigned int> &recordedNodes = boundaryNodes[currDomain];
 		Py140 *currNodeMap = nodeMaps[currDomain];
 		Fort020 *currFort = fortMaps[currDomain];
 		QString currData (tsLine.data());
 		currData.append("\n");
-		for (std::map<int, std::string>::iterator it = currentTimestepData.begin(); it != currentTimestepData.end(); ++it)
+		for (std::vector<unsigned int>::iterator it = recordedNodes.begin(); it != recordedNodes.end(); ++it)
 		{
-			currData.append(QString::number(currNodeMap->ConvertOldToNew(it->first)) + it->second.data());
+			std::map<int, std::string>::iterator data = currentTimestepData.find(*it);
+			if (data != currentTimestepData.end())
+				currData.append(QString::number(currNodeMap->ConvertOldToNew(*it)) + data->second.data());
 		}
 
 		currFort->WriteTimestep(currData);
 	}
 }
+
+
+/**
+ * @brief Passes the current timestep through a subdomain's resampler
+ *
+ * Passes the current timestep through a subdomain's resampler and writes every
+ * output timestep that it produces to the subdomain fort.020 file.
+ *
+ * @param currDomain The subdomain
+ */
+void Fort066::ResampleFort020Timestep(SubdomainFiles *currDomain)
+{
+	if (currDomain && boundaryNodes.count(currDomain) && nodeMaps.count(currDomain) && fortMaps.count(currDomain))
+	{
+		BoundaryResampler *currResampler = resamplers[currDomain];
+		if (!currResampler)
+		{
+			currResampler = new BoundaryResampler(recordInterval, outputInterval);
+			currResampler->SetLayout(valuesLine1, valuesLine2);
+			resamplers[currDomain] = currResampler;
+		}
+
+		GatherSubdomainValues(currDomain, gatheredValues);
+		currResampler->AddTimestep(tsHeader, gatheredValues);
+		while (currResampler->NextOutput(resampledHeader, resampledValues))
+			WriteFort020Values(currDomain, currResampler->GetOutputTimestep(), resampledHeader, resampledValues);
+	}
+}
+
+
+/**
+ * @brief Collects the values of a subdomain's recorded nodes from the current timestep
+ *
+ * Collects the values of a subdomain's recorded nodes from the current timestep,
+ * ordered by subdomain node number. A binary fort.066 is gathered straight out of
+ * the mapped record, while an ASCII record has to be parsed.
+ *
+ * @param currDomain The subdomain
+ * @param values The values of the recorded nodes
+ */
+void Fort066::GatherSubdomainValues(SubdomainFiles *currDomain, std::vector<double> &values)
+{
+	if (binaryInput)
+	{
+		binaryFile.GatherTimestep(currentTimestep, recordIndices[currDomain], values);
+		return;
+	}
+
+	std::vector<unsigned int> &recordedNodes = boundaryNodes[currDomain];
+	values.clear();
+	for (std::vector<unsigned int>::iterator it = recordedNodes.begin(); it != recordedNodes.end(); ++it)
+	{
+		std::map<int, std::string>::iterator data = currentTimestepData.find(*it);
+		if (data != currentTimestepData.end())
+			BinaryBoundaryConditions::ParseValues(data->second, values);
+	}
+}
+
+
+/**
+ * @brief Writes one timestep of values to a subdomain fort.020 file
+ * @param currDomain The subdomain
+ * @param ts The timestep of the fort.020 file (starting from 1)
+ * @param header The timestep header values
+ * @param values The values of the recorded nodes, ordered by subdomain node number
+ */
+void Fort066::WriteFort020Values(SubdomainFiles *currDomain, unsigned int ts, const std::vector<double> &header, const std::vector<double> &values)
+{
+	Fort020 *currFort = fortMaps[currDomain];
+	if (binaryOutput)
+	{
+		currFort->WriteBinaryTimestep(ts, header, values);
+		return;
+	}
+
+	std::vector<unsigned int> &recordedNodes = boundaryNodes[currDomain];
+	Py140 *currNodeMap = nodeMaps[currDomain];
+	unsigned int valuesPerNode = valuesLine1 + valuesLine2;
+	unsigned int valueSize = binaryInput ? binaryFile.GetValueSize() : 8;
+	QString currData = BinaryBoundaryConditions::FormatValues(header.empty() ? 0 : &header[0], header.size(), 8) + "\n";
+	for (unsigned int i=0; i<recordedNodes.size() && (i+1)*valuesPerNode <= values.size(); ++i)
+		currData.append(BinaryBoundaryConditions::FormatNodeRecord(currNodeMap->ConvertOldToNew(recordedNodes[i]),
+									   &values[i*valuesPerNode], valuesLine1, valuesLine2, valueSize));
+	currFort->WriteTimestep(currData);
+}
+
+
+void Fort066::CloseFort020Files()
+{
+	for (std::map<SubdomainFiles*, Fort020*>::iterator it = fortMaps.begin(); it != fortMaps.end(); ++it)
+	{
+		if (it->second)
+			it->second->CloseFile();
+	}
+}
@@ -7,57 +7,193 @@
 #include <ostream>
 #include <sstream>
 
+#include <QObject>
 #include <QString>
 #include <QDir>
+#include <QStringList>
 #include <QFileInfo>
+#include <QMutex>
+#include <QWaitCondition>
 
-#include "Domains/Domain.h"
+#include "Projects/IO/FileIO/SubdomainFiles.h"
 #include "Projects/IO/FileIO/Py140.h"
 #include "Projects/IO/FileIO/Fort020.h"
-#include "Projects/IO/FileIO/BNList14.h"
-
-class Fort066
+#include "Projects/IO/FileIO/BinaryBoundaryConditions.h"
+#include "Projects/IO/FileIO/BoundaryResampler.h"
+#include "Projects/IO/FileIO/Fort015.h"
+#include "Tasks/TaskScheduler.h"
+
+#define FOLLOW_POLL_INTERVAL	2000
+#define FOLLOW_IDLE_TIMEOUT	600000
+
+
+/**
+ * @brief Carves the full domain boundary condition recording (fort.066) into
+ * a fort.020 file for each subdomain
+ *
+ * The carve can run in one of two modes. In the normal mode the full domain
+ * run has already finished and the entire fort.066 file is processed in one pass.
+ * In follow mode the file is tailed while ADCIRC is still appending timesteps to
+ * it. Each timestep is carved as soon as its record is complete and every fort.020
+ * file is flushed after each timestep, so subdomain runs can be started behind the
+ * full domain run instead of waiting for it to finish.
+ *
+ * Follow mode gives up once the number of timesteps in the header has been
+ * carved, once the file has not grown for the idle timeout, or once the run has
+ * finished (see FinishFollowing()) and everything it wrote has been carved.
+ *
+ * fort.066 may be either the ASCII file written by ADCIRC or the binary, indexed
+ * variant (see BinaryBoundaryConditions), which is detected automatically. A binary
+ * fort.066 is memory mapped and each subdomain's nodes are gathered directly from
+ * the mapped records, and a restarted carve can seek straight to its first timestep.
+ * The fort.020 files are written as ASCII unless binary output is turned on.
+ *
+ * A full domain run on more than one processor (padcirc) writes a fort.066 into
+ * each processor directory (PE0000, PE0001, ...), numbered by the processor's local
+ * nodes. When the run directory has processor directories that were partitioned
+ * after fort.066 was last written there, or there is no fort.066 there at all, the
+ * processor files are read together instead. Each timestep is gathered from every
+ * processor file and its nodes are renumbered with the local to global table of the
+ * processor's fort.18, so the rest of the carve sees a single full domain record.
+ *
+ * Each subdomain's boundary conditions can also be resampled onto a different
+ * interval as they are carved (see BoundaryResampler), for subdomains that run
+ * with a different timestep than the full domain recorded at.
+ *
+ * Like a Layer, the object can be run as a task on the TaskScheduler through the
+ * carveAllSubdomains() slot. When following a running job it is moved to a QThread
+ * of its own instead, since it blocks until the job is done.
+ *
+ */
+class Fort066 : public QObject
 {
+		Q_OBJECT
 	public:
-		Fort066();
-		Fort066(QString newLoc);
+		Fort066(QObject *parent=0);
+		Fort066(QString newLoc, QObject *parent=0);
 		~Fort066();
 
 		void	SetFilePath(QString newLoc);
-		void	SetSubdomains(std::vector<Domain*> newDomains);
+		void	SetSubdomains(std::vector<SubdomainFiles> newDomains);
+		void	SetFollowMode(bool follow);
+		void	SetFollowPollInterval(unsigned long msec);
+		void	SetFollowIdleTimeout(unsigned long msec);
+		void	SetFirstTimestep(int ts);
+		void	SetBinaryOutput(bool binary, unsigned int valueSize=8);
+		void	SetResampling(double newRecordInterval, double newOutputInterval);
 
 		void	CarveAllSubdomains();
+		void	StopCarving();
+		void	FinishFollowing();
+		bool	CarvedAllTimesteps();
+
+		static bool	ConvertToBinary(QString asciiPath, QString binaryPath, unsigned int valueSize);
+		static bool	ConvertToAscii(QString binaryPath, QString asciiPath);
 
 	private:
 
 		QString	filePath;
 
 		std::ifstream	readFile;
-		std::ofstream	writeFile;
 
 		int	numNodesRecorded;
 		int	numTSRecorded;
 		int	currentTimestep;
-
-		std::vector<Domain*>		subdomains;
-		std::map<Domain*, Fort020*>	fortMaps;
-		std::map<Domain*, BNList14*>	bnLists;
-		std::map<Domain*, Py140*>	nodeMaps;
+		int	firstTimestep;
+		bool	carvedAll;		/**< The last carve reached the final timestep */
+
+		/* Processor files of a parallel run */
+		bool				processorInput;
+		std::vector<std::ifstream*>	processorFiles;
+		std::vector<std::vector<int> >	localToGlobal;		/**< The fort.18 table of each processor */
+		std::vector<int>		processorNodesRecorded;	/**< Nodes in each processor's record */
+
+		/* Binary format */
+		bool				binaryInput;
+		bool				binaryOutput;
+		unsigned int			binaryValueSize;
+		BinaryBoundaryConditions	binaryFile;
+		std::vector<double>		tsHeader;
+		std::vector<double>		gatheredValues;
+
+		/* Record layout */
+		unsigned int	headerValues;
+		unsigned int	valuesLine1;
+		unsigned int	valuesLine2;
+
+		/* Resampling */
+		double					recordInterval;
+		double					outputInterval;
+		std::map<SubdomainFiles*, BoundaryResampler*>	resamplers;
+		std::vector<double>			resampledHeader;
+		std::vector<double>			resampledValues;
+
+		/* Follow mode */
+		bool		followMode;
+		unsigned long	pollInterval;
+		unsigned long	idleTimeout;
+		unsigned long	idleTime;
+		qint64		lastFileSize;
+		bool		stopRequested;
+		bool		writerFinished;	/**< The run writing fort.066 has finished */
+		QMutex		stopMutex;
+		QWaitCondition	stopCondition;
+
+		std::vector<SubdomainFiles>	subdomains;
+		std::map<SubdomainFiles*, Fort020*>	fortMaps;
+		std::map<SubdomainFiles*, Py140*>	nodeMaps;
+		std::map<SubdomainFiles*, std::vector<unsigned int> >	boundaryNodes;	/**< Full domain numbers of the recorded nodes in each subdomain */
+		std::map<SubdomainFiles*, std::vector<unsigned int> >	recordIndices;	/**< Positions of those nodes within a binary record */
 
 		std::string			tsLine;
 		std::map<int, std::string>	currentTimestepData;
 
+		void	Initialize(QString newLoc);
+
 		/* Reading fort.066 */
-		void	OpenFile();
-		void	ReadTimestep();
+		bool	OpenFile();
+		bool	ReadTimestep();
+		bool	ReadRecord(std::ifstream &file, int numNodes, std::vector<int> *toGlobal, std::string &headerLine, std::map<int, std::string> &recordData);
+		bool	ReadCompleteLine(std::string &line);
+		bool	ReadCompleteLine(std::ifstream &file, std::string &line);
 		void	CloseFile();
 
+		/* Reading the processor files of a parallel run */
+		QStringList	FindProcessorDirectories();
+		bool		UseProcessorFiles();
+		bool		OpenProcessorFiles();
+		bool		ReadProcessorTimestep(std::string &headerLine, std::map<int, std::string> &recordData);
+		qint64		RecordedFileSize();
+
+		/* Follow mode helpers */
+		bool	WaitForMoreData();
+		bool	CarvingStopped();
+
+		bool	ResamplingEnabled();
+		int	NumFort020Timesteps();
+
 		/* Writing fort.020 */
-		void	CreateFort020File(Domain* currDomain);
-		void	GetBNList(Domain* currDomain);
-		void	GetPy140File(Domain* currDomain);
-		void	WriteFort020FileInfoLines(Domain* currDomain);
-		void	WriteFort020Timestep(Domain* currDomain);
+		void	CreateFort020File(SubdomainFiles* currDomain);
+		void	GetPy140File(SubdomainFiles* currDomain);
+		void	FindRecordedBoundaryNodes(SubdomainFiles* currDomain);
+		void	WriteFort020FileInfoLines(SubdomainFiles* currDomain);
+		void	ResumeFort020File(SubdomainFiles* currDomain);
+		void	WriteFort020Timestep(SubdomainFiles* currDomain);
+		void	ResampleFort020Timestep(SubdomainFiles* currDomain);
+		void	GatherSubdomainValues(SubdomainFiles* currDomain, std::vector<double> &values);
+		void	WriteFort020Values(SubdomainFiles* currDomain, unsigned int ts, const std::vector<double> &header, const std::vector<double> &values);
+		void	CloseFort020Files();
+
+	public slots:
+
+		void	carveAllSubdomains();
+
+	signals:
+
+		void	startedCarving();
+		void	carvedTimestep(int);
+		void	finishedCarving();
+		void	emitMessage(QString);
 
 };
 
@@ -0,0 +1,345 @@
+#include "Fort13.h"
+
+Fort13::Fort13(QObject *parent) :
+	QObject(parent)
+{
+	filePath = "";
+	forceCarve = false;
+	fileSize = 0;
+	numFullNodes = 0;
+	numAttributes = 0;
+}
+
+
+Fort13::Fort13(QString newLoc, QObject *parent) :
+	QObject(parent)
+{
+	filePath = newLoc;
+	forceCarve = false;
+	fileSize = 0;
+	numFullNodes = 0;
+	numAttributes = 0;
+}
+
+
+Fort13::~Fort13()
+{
+	CloseFiles(false);
+	if (readFile.is_open())
+		readFile.close();
+}
+
+
+void Fort13::SetFilePath(QString newLoc)
+{
+	filePath = newLoc;
+}
+
+
+void Fort13::SetSubdomains(std::vector<SubdomainFiles> newDomains)
+{
+	subdomains = newDomains;
+}
+
+
+/**
+ * @brief Sets whether subdomains with an up to date fort.13 are carved again
+ * @param force true to carve every subdomain
+ */
+void Fort13::SetForceCarve(bool force)
+{
+	forceCarve = force;
+}
+
+
+/**
+ * @brief Carves the full domain fort.13 file into a fort.13 file for each subdomain
+ *
+ * Carves the full domain fort.13 file into a fort.13 file for each subdomain
+ * in a single pass over the full domain file.
+ *
+ * @return true if every subdomain fort.13 file was written or already up to date
+ */
+bool Fort13::CarveAllSubdomains()
+{
+	emit startedCarving();
+
+	readFile.open(filePath.toStdString().data());
+	if (!readFile.is_open())
+	{
+		std::cout << "WARNING: Unable to open " << filePath.toStdString().data() << std::endl;
+		emit finishedCarving();
+		return false;
+	}
+	fileSize = QFileInfo(filePath).size();
+
+	/* The number of full domain nodes is needed to build each lookup */
+	std::string agridLine, nodesLine, attributesLine;
+	if (!std::getline(readFile, agridLine) || !std::getline(readFile, nodesLine) || !std::getline(readFile, attributesLine))
+	{
+		std::cout << "WARNING: Unable to read the header of " << filePath.toStdString().data() << std::endl;
+		readFile.close();
+		emit finishedCarving();
+		return false;
+	}
+	std::stringstream(nodesLine) >> numFullNodes;
+	std::stringstream(attributesLine) >> numAttributes;
+
+	bool succeeded = true;
+	for (std::vector<SubdomainFiles>::iterator it = subdomains.begin(); it != subdomains.end(); ++it)
+	{
+		SubdomainFiles *currDomain = &(*it);
+		if (forceCarve || !SubdomainUpToDate(currDomain))
+			succeeded = CreateSubdomainFile(currDomain) && succeeded;
+	}
+
+	if (outputs.size() > 0)
+	{
+		WriteHeader(agridLine, attributesLine);
+		bool carved = CarveAttributeDefinitions();
+		bool cancelled = false;
+		for (unsigned int i=0; i<numAttributes && carved && !cancelled; ++i)
+		{
+			carved = CarveAttributeBlock();
+			cancelled = TaskScheduler::Instance()->CurrentTaskCancelled();
+		}
+		carved = carved && !cancelled;
+
+		if (cancelled)
+			std::cout << "Cancelled carving " << filePath.toStdString().data() << std::endl;
+		else if (!carved)
+			std::cout << "WARNING: Unexpected end of " << filePath.toStdString().data() << std::endl;
+		else
+			emit emitMessage(QString("Carved fort.13 for ").append(QString::number(outputs.size())).append(" subdomains"));
+
+		CloseFiles(carved);
+		succeeded = carved && succeeded;
+	}
+
+	readFile.close();
+	emit progress(100);
+	emit finishedCarving();
+	return succeeded;
+}
+
+
+void Fort13::carveAllSubdomains()
+{
+	CarveAllSubdomains();
+}
+
+
+/**
+ * @brief Checks if a subdomain's fort.13 file is newer than the files it is carved from
+ * @param currDomain The subdomain
+ * @return true if the subdomain fort.13 file does not need to be carved again
+ */
+bool Fort13::SubdomainUpToDate(SubdomainFiles *currDomain)
+{
+	QFileInfo subFort13 (currDomain->domainPath + QDir::separator() + "fort.13");
+	QFileInfo fullFort13 (filePath);
+	QFileInfo py140 (currDomain->py140Location);
+
+	return subFort13.exists() && py140.exists() &&
+			subFort13.lastModified() >= fullFort13.lastModified() &&
+			subFort13.lastModified() >= py140.lastModified();
+}
+
+
+/**
+ * @brief Opens the fort.13 file of a subdomain and builds its node lookup
+ * @param currDomain The subdomain
+ * @return true if the subdomain is ready to be carved
+ */
+bool Fort13::CreateSubdomainFile(SubdomainFiles *currDomain)
+{
+	if (currDomain->py140Location.isEmpty())
+	{
+		std::cout << "WARNING: No py.140 file for subdomain at " << currDomain->domainPath.toStdString().data() << std::endl;
+		return false;
+	}
+
+	Py140 nodeMap (currDomain->py140Location);
+
+	Fort13Subdomain *currOutput = new Fort13Subdomain;
+	currOutput->domain = currDomain;
+	currOutput->filePath = currDomain->domainPath + QDir::separator() + "fort.13";
+	currOutput->tempPath = currOutput->filePath + ".tmp";
+	currOutput->oldToNew = nodeMap.GetOldToNewList();
+	currOutput->numNodes = nodeMap.GetNewToOldList().size();
+	currOutput->countPosition = 0;
+	currOutput->numNonDefault = 0;
+	if (currOutput->oldToNew.size() < numFullNodes+1)
+		currOutput->oldToNew.resize(numFullNodes+1, 0);
+
+	currOutput->file.open(currOutput->tempPath.toStdString().data());
+	if (currOutput->numNodes == 0 || !currOutput->file.is_open())
+	{
+		std::cout << "WARNING: Unable to create " << currOutput->filePath.toStdString().data() << std::endl;
+		delete currOutput;
+		return false;
+	}
+
+	outputs.push_back(currOutput);
+	return true;
+}
+
+
+/**
+ * @brief Writes the first three lines of each subdomain fort.13 file
+ * @param agridLine The grid name line of the full domain file
+ * @param attributesLine The number of attributes line of the full domain file
+ */
+void Fort13::WriteHeader(const std::string &agridLine, const std::string &attributesLine)
+{
+	for (std::vector<Fort13Subdomain*>::iterator it = outputs.begin(); it != outputs.end(); ++it)
+	{
+		Fort13Subdomain *currOutput = *it;
+		currOutput->file << agridLine << "\n";
+		currOutput->file << currOutput->numNodes << "\n";
+		currOutput->file << attributesLine << "\n";
+	}
+}
+
+
+/**
+ * @brief Copies the attribute definitions to every subdomain fort.13 file
+ *
+ * Copies the attribute definitions to every subdomain fort.13 file. Each definition
+ * is four lines: the name, the units, the number of values per node, and the
+ * default values. None of them depend on the subdomain.
+ *
+ * @return true if every definition was read
+ */
+bool Fort13::CarveAttributeDefinitions()
+{
+	std::string line;
+	for (unsigned int i=0; i<4*numAttributes; ++i)
+	{
+		if (!std::getline(readFile, line))
+			return false;
+		for (std::vector<Fort13Subdomain*>::iterator it = outputs.begin(); it != outputs.end(); ++it)
+			(*it)->file << line << "\n";
+	}
+	return true;
+}
+
+
+/**
+ * @brief Carves the non-default values of a single attribute
+ *
+ * Carves the non-default values of a single attribute. The block starts with the
+ * attribute name and the number of nodes that have non-default values, followed
+ * by one line per node.
+ *
+ * @return true if the entire block was read
+ */
+bool Fort13::CarveAttributeBlock()
+{
+	std::string nameLine, countLine, line;
+
+	/* Skip any blank lines between blocks */
+	do
+	{
+		if (!std::getline(readFile, nameLine))
+			return false;
+	} while (nameLine.find_first_not_of(" \t\r") == std::string::npos);
+
+	if (!std::getline(readFile, countLine))
+		return false;
+
+	unsigned int numNonDefault = 0;
+	std::stringstream(countLine) >> numNonDefault;
+
+	for (std::vector<Fort13Subdomain*>::iterator it = outputs.begin(); it != outputs.end(); ++it)
+	{
+		Fort13Subdomain *currOutput = *it;
+		currOutput->file << nameLine << "\n";
+		currOutput->countPosition = currOutput->file.tellp();
+		currOutput->file << std::setw(FORT13_COUNT_WIDTH) << 0 << "\n";
+		currOutput->numNonDefault = 0;
+	}
+
+	for (unsigned int i=0; i<numNonDefault; ++i)
+	{
+		if (!std::getline(readFile, line))
+			return false;
+		CarveLine(line);
+
+		if ((i+1) % FORT13_PROGRESS_LINES == 0 && fileSize > 0)
+			emit progress((int)(100.0*readFile.tellg()/fileSize));
+	}
+
+	for (std::vector<Fort13Subdomain*>::iterator it = outputs.begin(); it != outputs.end(); ++it)
+		FinishAttributeBlock(*it);
+
+	return true;
+}
+
+
+/**
+ * @brief Writes a single non-default line to every subdomain that contains its node
+ *
+ * Writes a single non-default line to every subdomain that contains its node. Only
+ * the node number is parsed. The rest of the line is copied as is.
+ *
+ * @param line The line from the full domain fort.13 file
+ */
+void Fort13::CarveLine(const std::string &line)
+{
+	const char *start = line.c_str();
+	char *rest = 0;
+	unsigned long oldNode = std::strtoul(start, &rest, 10);
+	if (rest == start)
+		return;
+
+	for (std::vector<Fort13Subdomain*>::iterator it = outputs.begin(); it != outputs.end(); ++it)
+	{
+		Fort13Subdomain *currOutput = *it;
+		if (oldNode < currOutput->oldToNew.size() && currOutput->oldToNew[oldNode])
+		{
+			currOutput->file << currOutput->oldToNew[oldNode] << rest << "\n";
+			++currOutput->numNonDefault;
+		}
+	}
+}
+
+
+/**
+ * @brief Fills in the number of non-default nodes of the block that was just carved
+ * @param currOutput The subdomain file
+ */
+void Fort13::FinishAttributeBlock(Fort13Subdomain *currOutput)
+{
+	std::streampos endPosition = currOutput->file.tellp();
+	currOutput->file.seekp(currOutput->countPosition);
+	currOutput->file << std::setw(FORT13_COUNT_WIDTH) << currOutput->numNonDefault;
+	currOutput->file.seekp(endPosition);
+}
+
+
+/**
+ * @brief Closes every subdomain fort.13 file
+ *
+ * Closes every subdomain fort.13 file. Completed files replace the existing
+ * subdomain fort.13 files, and incomplete files are removed.
+ *
+ * @param succeeded true if the carve completed
+ */
+void Fort13::CloseFiles(bool succeeded)
+{
+	for (std::vector<Fort13Subdomain*>::iterator it = outputs.begin(); it != outputs.end(); ++it)
+	{
+		Fort13Subdomain *currOutput = *it;
+		currOutput->file.close();
+		if (succeeded && !currOutput->file.fail())
+		{
+			QFile::remove(currOutput->filePath);
+			QFile::rename(currOutput->tempPath, currOutput->filePath);
+		} else {
+			QFile::remove(currOutput->tempPath);
+		}
+		delete currOutput;
+	}
+	outputs.clear();
+}
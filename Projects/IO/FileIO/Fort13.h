@@ -0,0 +1,118 @@
+#ifndef FORT13_H
+#define FORT13_H
+
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+
+#include <QObject>
+#include <QString>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+
+#include "Projects/IO/FileIO/SubdomainFiles.h"
+#include "Projects/IO/FileIO/Py140.h"
+#include "Tasks/TaskScheduler.h"
+
+#define FORT13_COUNT_WIDTH	12
+#define FORT13_PROGRESS_LINES	100000
+
+
+/**
+ * @brief A subdomain fort.13 file that is being written by Fort13
+ */
+struct Fort13Subdomain
+{
+	SubdomainFiles*			domain;
+	QString				filePath;	/**< The finished fort.13 file */
+	QString				tempPath;	/**< The file being written */
+	std::ofstream			file;
+	std::vector<unsigned int>	oldToNew;	/**< Dense full domain to subdomain node mapping */
+	unsigned int			numNodes;
+	std::streampos			countPosition;	/**< Where the non-default count of the current attribute is written */
+	unsigned int			numNonDefault;
+};
+
+
+/**
+ * @brief Carves the full domain nodal attributes file (fort.13) into a fort.13
+ * file for each subdomain
+ *
+ * Full domain fort.13 files can be several gigabytes, so the file is streamed
+ * and read exactly once no matter how many subdomains there are. The attribute
+ * definitions are copied to every subdomain, and each line of every non-default
+ * block is renumbered into each subdomain that contains its node using a dense
+ * lookup built from that subdomain's py.140 file. The values themselves are copied
+ * as text, so no precision is lost.
+ *
+ * The number of non-default nodes in a block is not known for a subdomain until
+ * the whole block has been read, so a fixed width placeholder is written and
+ * filled in once the block is done. Each fort.13 file is written to a temporary
+ * file first and renamed when complete.
+ *
+ * Subdomains whose fort.13 is newer than both the full domain fort.13 and their
+ * py.140 file are skipped unless forced.
+ *
+ * Project starts carveAllSubdomains() on the TaskScheduler as a full domain run is
+ * set up. ADCIRC only reads fort.13, so the carve can go on while the run starts.
+ *
+ */
+class Fort13 : public QObject
+{
+		Q_OBJECT
+	public:
+		Fort13(QObject *parent=0);
+		Fort13(QString newLoc, QObject *parent=0);
+		~Fort13();
+
+		void	SetFilePath(QString newLoc);
+		void	SetSubdomains(std::vector<SubdomainFiles> newDomains);
+		void	SetForceCarve(bool force);
+
+		bool	CarveAllSubdomains();
+
+	private:
+
+		QString	filePath;
+		bool	forceCarve;
+
+		std::ifstream	readFile;
+		qint64		fileSize;
+		unsigned int	numFullNodes;
+		unsigned int	numAttributes;
+
+		std::vector<SubdomainFiles>	subdomains;
+		std::vector<Fort13Subdomain*>	outputs;
+
+		/* Setting up the subdomain files */
+		bool	SubdomainUpToDate(SubdomainFiles *currDomain);
+		bool	CreateSubdomainFile(SubdomainFiles *currDomain);
+
+		/* Carving */
+		void	WriteHeader(const std::string &agridLine, const std::string &attributesLine);
+		bool	CarveAttributeDefinitions();
+		bool	CarveAttributeBlock();
+		void	CarveLine(const std::string &line);
+		void	FinishAttributeBlock(Fort13Subdomain *currOutput);
+
+		void	CloseFiles(bool succeeded);
+
+	public slots:
+
+		void	carveAllSubdomains();
+
+	signals:
+
+		void	startedCarving();
+		void	progress(int);
+		void	finishedCarving();
+		void	emitMessage(QString);
+
+};
+
+#endif // FORT13_H
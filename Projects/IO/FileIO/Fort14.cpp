@@ -0,0 +1,338 @@
+#include "Fort14.h"
+
+Fort14::Fort14()
+{
+	filePath = "";
+	flipZValue = false;
+	numNodes = 0;
+	numElements = 0;
+	ResetExtents();
+}
+
+
+Fort14::Fort14(std::string newLoc)
+{
+	filePath = newLoc;
+	flipZValue = false;
+	numNodes = 0;
+	numElements = 0;
+	ResetExtents();
+}
+
+
+Fort14::~Fort14()
+{
+	Close();
+}
+
+
+void Fort14::SetFilePath(std::string newLoc)
+{
+	Close();
+	filePath = newLoc;
+}
+
+
+/**
+ * @brief Sets whether the z-values are multiplied by -1 as they are read
+ *
+ * Sets whether the z-values are multiplied by -1 as they are read. fort.14 gives
+ * depths as positive values below the geoid, so they are flipped for drawing.
+ *
+ * @param flip true to flip the z-values
+ */
+void Fort14::SetFlipZValue(bool flip)
+{
+	flipZValue = flip;
+}
+
+
+/**
+ * @brief Checks if the mesh is a subdomain
+ *
+ * Checks if the mesh is a subdomain, which is the case when there is a py.140
+ * file in the same directory. Only the boundary nodes of a subdomain are read.
+ *
+ * @return true if the mesh is a subdomain
+ */
+bool Fort14::IsSubdomain()
+{
+	size_t separator = filePath.find_last_of("/\\");
+	std::string directory = separator == std::string::npos ? std::string() : filePath.substr(0, separator+1);
+	std::ifstream py140 ((directory + "py.140").data());
+	return py140.is_open();
+}
+
+
+/**
+ * @brief Reads the whole file
+ *
+ * Reads the whole file. The Node list is sized up front, so the Elements can point
+ * into it.
+ *
+ * @param infoLine Set to the info line
+ * @param nodes Filled with every Node
+ * @param elements Filled with every Element, pointing into nodes
+ * @param boundaryNodes Filled with the boundary node numbers if this is a subdomain
+ * @return true if every Node and Element given in the file was read
+ */
+bool Fort14::ReadFile(std::string &infoLine, std::vector<Node> &nodes,
+		      std::vector<Element> &elements, std::vector<unsigned int> &boundaryNodes)
+{
+	nodes.clear();
+	elements.clear();
+	boundaryNodes.clear();
+
+	if (!Open() || !ReadHeader(infoLine))
+	{
+		Close();
+		return false;
+	}
+
+	nodes.reserve(numNodes);
+	elements.reserve(numElements);
+	bool read = ReadNodes(nodes, numNodes) == numNodes &&
+		    ReadElements(elements, nodes, numElements) == numElements;
+	if (read && IsSubdomain())
+		ReadBoundaryNodes(boundaryNodes);
+	Close();
+
+	if (!read)
+	{
+		nodes.clear();
+		elements.clear();
+		std::cout << "WARNING: Unable to read " << filePath << std::endl;
+	}
+	return read;
+}
+
+
+/**
+ * @brief Opens the file for reading a piece at a time
+ * @return true if the file was opened
+ */
+bool Fort14::Open()
+{
+	Close();
+	numNodes = 0;
+	numElements = 0;
+	ResetExtents();
+	file.open(filePath.data());
+	return file.is_open();
+}
+
+
+/**
+ * @brief Reads the info line and the number of Elements and Nodes
+ * @param infoLine Set to the info line
+ * @return true if the file gives at least one Node and one Element
+ */
+bool Fort14::ReadHeader(std::string &infoLine)
+{
+	std::string line;
+	std::getline(file, infoLine);
+	std::getline(file, line);
+	std::stringstream(line) >> numElements >> numNodes;
+	return file.good() && numNodes > 0 && numElements > 0;
+}
+
+
+/**
+ * @brief Reads the next Nodes in the file
+ *
+ * Reads the next Nodes in the file and appends them to the list. The normalized
+ * coordinates are set to 0. Must be called after ReadHeader() and before any
+ * Elements are read.
+ *
+ * @param nodes The list to append the Nodes to
+ * @param count The number of Nodes to read
+ * @return The number of Nodes read, which is less than count at the end of the
+ * file or if a line can't be read
+ */
+unsigned int Fort14::ReadNodes(std::vector<Node> &nodes, unsigned int count)
+{
+	Node currNode;
+	currNode.normX = 0.0;
+	currNode.normY = 0.0;
+	currNode.normZ = 0.0;
+
+	unsigned int numRead = 0;
+	while (numRead < count && file >> currNode.nodeNumber >> currNode.xDat >> currNode.yDat >> currNode.zDat)
+	{
+		currNode.x = atof(currNode.xDat.data());
+		currNode.y = atof(currNode.yDat.data());
+		currNode.z = atof(currNode.zDat.data());
+		if (flipZValue)
+			currNode.z *= -1.0;
+
+		if (currNode.x < minX)
+			minX = currNode.x;
+		if (currNode.x > maxX)
+			maxX = currNode.x;
+		if (currNode.y < minY)
+			minY = currNode.y;
+		if (currNode.y > maxY)
+			maxY = currNode.y;
+		if (currNode.z < minZ)
+			minZ = currNode.z;
+		if (currNode.z > maxZ)
+			maxZ = currNode.z;
+
+		nodes.push_back(currNode);
+		++numRead;
+	}
+	return numRead;
+}
+
+
+/**
+ * @brief Reads the next Elements in the file
+ *
+ * Reads the next Elements in the file and appends them to the list. Each Element
+ * points into the list of Nodes, so every Node must have been read and the list must
+ * not be changed afterwards.
+ *
+ * @param elements The list to append the Elements to
+ * @param nodes Every Node in the file
+ * @param count The number of Elements to read
+ * @return The number of Elements read, which is less than count at the end of the
+ * file or if a line can't be read
+ */
+unsigned int Fort14::ReadElements(std::vector<Element> &elements, std::vector<Node> &nodes, unsigned int count)
+{
+	Element currElement;
+	unsigned int trash, n1, n2, n3;
+
+	unsigned int numRead = 0;
+	while (numRead < count && file >> currElement.elementNumber >> trash >> n1 >> n2 >> n3)
+	{
+		currElement.n1 = FindNode(nodes, n1);
+		currElement.n2 = FindNode(nodes, n2);
+		currElement.n3 = FindNode(nodes, n3);
+		if (!currElement.n1 || !currElement.n2 || !currElement.n3)
+			break;
+
+		elements.push_back(currElement);
+		++numRead;
+	}
+	return numRead;
+}
+
+
+/**
+ * @brief Reads the boundary nodes of a subdomain
+ *
+ * Reads the boundary nodes of a subdomain, which are written as a single open
+ * boundary segment. Nothing is read if there is more than one segment. Must be
+ * called after every Element has been read.
+ *
+ * @param boundaryNodes The list to append the boundary node numbers to
+ */
+void Fort14::ReadBoundaryNodes(std::vector<unsigned int> &boundaryNodes)
+{
+	std::string line;
+	int numSegments = 0, numBoundaryNodes = 0;
+	std::getline(file, line);
+	std::getline(file, line);
+	std::stringstream(line) >> numSegments;
+	std::getline(file, line);
+	std::stringstream(line) >> numBoundaryNodes;
+	if (numSegments == 1)
+	{
+		int numNextBoundaryNodes = 0;
+		unsigned int nextNodeNumber;
+		file >> numNextBoundaryNodes;
+		for (int i=0; i<numNextBoundaryNodes && file >> nextNodeNumber; i++)
+			boundaryNodes.push_back(nextNodeNumber);
+	}
+}
+
+
+void Fort14::Close()
+{
+	if (file.is_open())
+		file.close();
+	file.clear();
+}
+
+
+unsigned int Fort14::GetNumNodes()
+{
+	return numNodes;
+}
+
+
+unsigned int Fort14::GetNumElements()
+{
+	return numElements;
+}
+
+
+float Fort14::GetMinX()
+{
+	return minX;
+}
+
+
+float Fort14::GetMaxX()
+{
+	return maxX;
+}
+
+
+float Fort14::GetMinY()
+{
+	return minY;
+}
+
+
+float Fort14::GetMaxY()
+{
+	return maxY;
+}
+
+
+float Fort14::GetMinZ()
+{
+	return minZ;
+}
+
+
+float Fort14::GetMaxZ()
+{
+	return maxZ;
+}
+
+
+void Fort14::ResetExtents()
+{
+	minX = 99999.0;
+	maxX = -99999.0;
+	minY = 99999.0;
+	maxY = -99999.0;
+	minZ = 99999.0;
+	maxZ = -99999.0;
+}
+
+
+/**
+ * @brief Finds the Node with the given node number
+ *
+ * Finds the Node with the given node number. The Node is first looked up on the
+ * assumption that the list is ordered, which ADCIRC requires, and the whole list is
+ * searched otherwise.
+ *
+ * @param nodes The list of Nodes
+ * @param nodeNumber The node number
+ * @return A pointer to the Node
+ * @return 0 if there is no such Node
+ */
+Node* Fort14::FindNode(std::vector<Node> &nodes, unsigned int nodeNumber)
+{
+	if (nodeNumber > 0 && nodeNumber <= nodes.size() && nodes[nodeNumber-1].nodeNumber == nodeNumber)
+		return &nodes[nodeNumber-1];
+	for (unsigned int i=0; i<nodes.size(); i++)
+		if (nodes[i].nodeNumber == nodeNumber)
+			return &nodes[i];
+	return 0;
+}
@@ -0,0 +1,86 @@
+#ifndef FORT14_H
+#define FORT14_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+#include "adcData.h"
+
+
+/**
+ * @brief Reads the ADCIRC mesh file (fort.14)
+ *
+ * Reads the ADCIRC mesh file (fort.14): the info line, the Nodes, the Elements
+ * and the boundary nodes of a subdomain. The class has no Qt or OpenGL dependencies,
+ * so it is shared by TerrainLayer and the tools that work on meshes without a display.
+ *
+ * The whole file can be read with ReadFile(). A caller that reports progress, like
+ * TerrainLayer, opens the file and calls ReadNodes() and ReadElements() with a count
+ * instead, so it can report progress or stop early between the pieces.
+ *
+ * The text of each coordinate is kept along with its value, so a mesh that is written
+ * back out (see SubdomainExtractor) loses no precision. The range of the coordinates
+ * is tracked as the Nodes are read.
+ *
+ * Only a single open boundary segment is read, which is how the boundary of a
+ * subdomain is written. A mesh is a subdomain if it has a py.140 file next to it
+ * (see IsSubdomain()). The boundary segments of a full domain are skipped, even
+ * when there is only one.
+ *
+ */
+class Fort14
+{
+	public:
+		Fort14();
+		Fort14(std::string newLoc);
+		~Fort14();
+
+		void	SetFilePath(std::string newLoc);
+		void	SetFlipZValue(bool flip);
+		bool	IsSubdomain();
+
+		/* Reading the whole file */
+		bool	ReadFile(std::string &infoLine, std::vector<Node> &nodes,
+				 std::vector<Element> &elements, std::vector<unsigned int> &boundaryNodes);
+
+		/* Reading a piece at a time */
+		bool		Open();
+		bool		ReadHeader(std::string &infoLine);
+		unsigned int	ReadNodes(std::vector<Node> &nodes, unsigned int count);
+		unsigned int	ReadElements(std::vector<Element> &elements, std::vector<Node> &nodes, unsigned int count);
+		void		ReadBoundaryNodes(std::vector<unsigned int> &boundaryNodes);
+		void		Close();
+
+		unsigned int	GetNumNodes();
+		unsigned int	GetNumElements();
+		float		GetMinX();
+		float		GetMaxX();
+		float		GetMinY();
+		float		GetMaxY();
+		float		GetMinZ();
+		float		GetMaxZ();
+
+	private:
+
+		std::string	filePath;
+		std::ifstream	file;
+		bool		flipZValue;	/**< Multiply the z-values by -1 as they are read */
+
+		unsigned int	numNodes;	/**< The number of Nodes given in the file */
+		unsigned int	numElements;	/**< The number of Elements given in the file */
+
+		float	minX;
+		float	maxX;
+		float	minY;
+		float	maxY;
+		float	minZ;
+		float	maxZ;
+
+		void	ResetExtents();
+		Node*	FindNode(std::vector<Node> &nodes, unsigned int nodeNumber);
+};
+
+#endif // FORT14_H
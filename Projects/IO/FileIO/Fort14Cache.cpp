@@ -0,0 +1,247 @@
+#include "Fort14Cache.h"
+
+static const char FORT14_CACHE_MAGIC[8] = {'A', 'D', 'C', '1', '4', 'C', 'H', '\0'};
+
+
+Fort14Cache::Fort14Cache(QString sourceLoc)
+{
+	sourcePath = sourceLoc;
+	cachePath = GetCachePath(sourceLoc);
+}
+
+
+/**
+ * @brief Returns the location of the cache file for a fort.14 file
+ * @param sourceLoc The fort.14 file
+ * @return The cache file location
+ */
+QString Fort14Cache::GetCachePath(QString sourceLoc)
+{
+	return sourceLoc + ".cache";
+}
+
+
+/**
+ * @brief Checks if the cache file exists and was written from the current fort.14 file
+ * @return true if the cache can be used
+ */
+bool Fort14Cache::CacheIsCurrent()
+{
+	std::ifstream cacheFile (cachePath.toStdString().data(), std::ios::in | std::ios::binary);
+	if (!cacheFile.is_open())
+		return false;
+
+	Fort14CacheHeader header;
+	bool current = ReadHeader(cacheFile, header);
+	cacheFile.close();
+	return current;
+}
+
+
+/**
+ * @brief Writes the cache file
+ *
+ * Writes the cache file. The cache is written to a temporary file and renamed when
+ * complete, so an existing cache is never left half written.
+ *
+ * @param infoLine The info line of fort.14
+ * @param nodes Every Node, in order
+ * @param elements Every Element, in order. Their Node pointers must point into nodes.
+ * @param boundaryNodes The boundary node numbers
+ * @return true if the cache was written
+ */
+bool Fort14Cache::WriteCache(const std::string &infoLine, const std::vector<Node> &nodes,
+			     const std::vector<Element> &elements, const std::vector<unsigned int> &boundaryNodes)
+{
+	Fort14CacheHeader header;
+	memset(&header, 0, sizeof(Fort14CacheHeader));
+	if (nodes.size() == 0 || !ReadSourceInfo(header.sourceSize, header.sourceModified))
+		return false;
+
+	memcpy(header.magic, FORT14_CACHE_MAGIC, sizeof(FORT14_CACHE_MAGIC));
+	header.version = FORT14_CACHE_VERSION;
+	header.numNodes = nodes.size();
+	header.numElements = elements.size();
+	header.numBoundaryNodes = boundaryNodes.size();
+	header.infoLength = infoLine.size();
+
+	QString tempPath = cachePath + ".tmp";
+	std::ofstream cacheFile (tempPath.toStdString().data(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!cacheFile.is_open())
+		return false;
+
+	cacheFile.write((const char*)&header, sizeof(Fort14CacheHeader));
+	cacheFile.write(infoLine.data(), infoLine.size());
+
+	for (std::vector<Node>::const_iterator it = nodes.begin(); it != nodes.end(); ++it)
+	{
+		quint32 nodeNumber = it->nodeNumber;
+		float coordinates[3] = {it->x, it->y, it->z};
+		cacheFile.write((const char*)&nodeNumber, sizeof(quint32));
+		cacheFile.write((const char*)coordinates, 3*sizeof(float));
+		WriteString(cacheFile, it->xDat);
+		WriteString(cacheFile, it->yDat);
+		WriteString(cacheFile, it->zDat);
+	}
+
+	const Node *firstNode = &nodes[0];
+	for (std::vector<Element>::const_iterator it = elements.begin(); it != elements.end(); ++it)
+	{
+		quint32 element[4] = {it->elementNumber,
+				      (quint32)(it->n1 - firstNode),
+				      (quint32)(it->n2 - firstNode),
+				      (quint32)(it->n3 - firstNode)};
+		cacheFile.write((const char*)element, 4*sizeof(quint32));
+	}
+
+	if (boundaryNodes.size() > 0)
+		cacheFile.write((const char*)&boundaryNodes[0], boundaryNodes.size()*sizeof(unsigned int));
+
+	bool written = !cacheFile.fail();
+	cacheFile.close();
+
+	if (written)
+	{
+		QFile::remove(cachePath);
+		QFile::rename(tempPath, cachePath);
+	} else {
+		QFile::remove(tempPath);
+		std::cout << "WARNING: Unable to write the cache of " << sourcePath.toStdString().data() << std::endl;
+	}
+	return written;
+}
+
+
+/**
+ * @brief Reads the mesh back from the cache file
+ *
+ * Reads the mesh back from the cache file. The normalized coordinates of the Nodes
+ * are not stored, so they must be calculated again.
+ *
+ * @param infoLine Set to the info line of fort.14
+ * @param nodes Filled with every Node
+ * @param elements Filled with every Element, pointing into nodes
+ * @param boundaryNodes Filled with the boundary node numbers
+ * @return true if the cache was current and was read completely
+ */
+bool Fort14Cache::ReadCache(std::string &infoLine, std::vector<Node> &nodes,
+			    std::vector<Element> &elements, std::vector<unsigned int> &boundaryNodes)
+{
+	std::ifstream cacheFile (cachePath.toStdString().data(), std::ios::in | std::ios::binary);
+	if (!cacheFile.is_open())
+		return false;
+
+	Fort14CacheHeader header;
+	if (!ReadHeader(cacheFile, header))
+		return false;
+
+	infoLine.assign(header.infoLength, ' ');
+	if (header.infoLength > 0)
+		cacheFile.read(&infoLine[0], header.infoLength);
+
+	nodes.resize(header.numNodes);
+	for (std::vector<Node>::iterator it = nodes.begin(); it != nodes.end() && cacheFile.good(); ++it)
+	{
+		quint32 nodeNumber = 0;
+		float coordinates[3] = {0.0, 0.0, 0.0};
+		cacheFile.read((char*)&nodeNumber, sizeof(quint32));
+		cacheFile.read((char*)coordinates, 3*sizeof(float));
+		it->nodeNumber = nodeNumber;
+		it->x = coordinates[0];
+		it->y = coordinates[1];
+		it->z = coordinates[2];
+		it->normX = it->normY = it->normZ = 0.0;
+		ReadString(cacheFile, it->xDat);
+		ReadString(cacheFile, it->yDat);
+		ReadString(cacheFile, it->zDat);
+	}
+
+	elements.resize(header.numElements);
+	for (std::vector<Element>::iterator it = elements.begin(); it != elements.end() && cacheFile.good(); ++it)
+	{
+		quint32 element[4] = {0, 0, 0, 0};
+		cacheFile.read((char*)element, 4*sizeof(quint32));
+		if (element[1] >= header.numNodes || element[2] >= header.numNodes || element[3] >= header.numNodes)
+		{
+			cacheFile.setstate(std::ios::failbit);
+			break;
+		}
+		it->elementNumber = element[0];
+		it->n1 = &nodes[element[1]];
+		it->n2 = &nodes[element[2]];
+		it->n3 = &nodes[element[3]];
+	}
+
+	boundaryNodes.resize(header.numBoundaryNodes);
+	if (header.numBoundaryNodes > 0 && cacheFile.good())
+		cacheFile.read((char*)&boundaryNodes[0], header.numBoundaryNodes*sizeof(unsigned int));
+
+	bool read = cacheFile.good();
+	cacheFile.close();
+	if (!read)
+	{
+		nodes.clear();
+		elements.clear();
+		boundaryNodes.clear();
+		std::cout << "WARNING: Unable to read the cache of " << sourcePath.toStdString().data() << std::endl;
+	}
+	return read;
+}
+
+
+bool Fort14Cache::ReadSourceInfo(qint64 &size, qint64 &modified)
+{
+	QFileInfo sourceInfo (sourcePath);
+	if (!sourceInfo.exists())
+		return false;
+
+	size = sourceInfo.size();
+	modified = sourceInfo.lastModified().toMSecsSinceEpoch();
+	return true;
+}
+
+
+/**
+ * @brief Reads the header and checks that the cache matches the current fort.14 file
+ * @param cacheFile The open cache file
+ * @param header Filled with the header
+ * @return true if the cache can be used
+ */
+bool Fort14Cache::ReadHeader(std::ifstream &cacheFile, Fort14CacheHeader &header)
+{
+	qint64 sourceSize = 0, sourceModified = 0;
+	if (!ReadSourceInfo(sourceSize, sourceModified))
+		return false;
+
+	cacheFile.read((char*)&header, sizeof(Fort14CacheHeader));
+	return cacheFile.gcount() == sizeof(Fort14CacheHeader) &&
+	       memcmp(header.magic, FORT14_CACHE_MAGIC, sizeof(FORT14_CACHE_MAGIC)) == 0 &&
+	       header.version == FORT14_CACHE_VERSION &&
+	       header.sourceSize == sourceSize &&
+	       header.sourceModified == sourceModified;
+}
+
+
+void Fort14Cache::WriteString(std::ofstream &cacheFile, const std::string &value)
+{
+	quint32 length = value.size();
+	cacheFile.write((const char*)&length, sizeof(quint32));
+	cacheFile.write(value.data(), length);
+}
+
+
+bool Fort14Cache::ReadString(std::ifstream &cacheFile, std::string &value)
+{
+	quint32 length = 0;
+	cacheFile.read((char*)&length, sizeof(quint32));
+	if (!cacheFile.good() || length > 1024)
+	{
+		cacheFile.setstate(std::ios::failbit);
+		return false;
+	}
+
+	value.assign(length, ' ');
+	if (length > 0)
+		cacheFile.read(&value[0], length);
+	return cacheFile.good();
+}
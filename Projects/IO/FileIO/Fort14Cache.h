@@ -0,0 +1,75 @@
+#ifndef FORT14CACHE_H
+#define FORT14CACHE_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+
+#include <QString>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+
+#include "adcData.h"
+
+#define FORT14_CACHE_VERSION	2
+
+
+/**
+ * @brief The fixed size header at the start of a fort.14 cache file
+ */
+struct Fort14CacheHeader
+{
+	char		magic[8];
+	qint64		sourceSize;		/**< Size of fort.14 when the cache was written */
+	qint64		sourceModified;		/**< Modification time of fort.14 when the cache was written (ms) */
+	quint32		version;
+	quint32		numNodes;
+	quint32		numElements;
+	quint32		numBoundaryNodes;
+	quint32		infoLength;		/**< Length of the info line that follows the header */
+};
+
+
+/**
+ * @brief A binary copy of the mesh in a fort.14 file
+ *
+ * A binary copy of the mesh in a fort.14 file, so a mesh that has been dropped
+ * from memory can be read back without parsing the text again. It holds exactly
+ * what TerrainLayer reads from fort.14: the info line, the Nodes (including the
+ * original text of their coordinates), the Elements as node indices and the
+ * boundary nodes.
+ *
+ * Like Fort63Cache, the cache is written next to the source file (fort.14 becomes
+ * fort.14.cache) and records the size and modification time of the source, so it
+ * is ignored once fort.14 changes. Values are stored in the byte order of the
+ * machine that wrote the cache.
+ *
+ */
+class Fort14Cache
+{
+	public:
+		Fort14Cache(QString sourceLoc);
+
+		static QString	GetCachePath(QString sourceLoc);
+
+		bool	CacheIsCurrent();
+		bool	WriteCache(const std::string &infoLine, const std::vector<Node> &nodes,
+				   const std::vector<Element> &elements, const std::vector<unsigned int> &boundaryNodes);
+		bool	ReadCache(std::string &infoLine, std::vector<Node> &nodes,
+				  std::vector<Element> &elements, std::vector<unsigned int> &boundaryNodes);
+
+	private:
+
+		QString	sourcePath;
+		QString	cachePath;
+
+		bool	ReadSourceInfo(qint64 &size, qint64 &modified);
+		bool	ReadHeader(std::ifstream &cacheFile, Fort14CacheHeader &header);
+		void	WriteString(std::ofstream &cacheFile, const std::string &value);
+		bool	ReadString(std::ifstream &cacheFile, std::string &value);
+};
+
+#endif // FORT14CACHE_H
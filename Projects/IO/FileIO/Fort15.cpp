@@ -0,0 +1,88 @@
+#include "Fort15.h"
+
+Fort15::Fort15(std::string newLoc)
+{
+	filePath = newLoc;
+	timestep = 0.0;
+}
+
+
+/**
+ * @brief Reads the file up to the model timestep
+ * @return true if a positive timestep was read
+ */
+bool Fort15::ReadFile()
+{
+	timestep = 0.0;
+	std::ifstream file (filePath.data());
+	if (!file.is_open())
+		return false;
+
+	std::string value;
+	bool read = true;
+
+	/* RUNDES and RUNID are free text */
+	std::string line;
+	read = std::getline(file, line) && std::getline(file, line);
+
+	/* NFOVER, NABOUT, NSCREEN, IHOT, ICS */
+	for (int i=0; read && i<5; ++i)
+		read = ReadValue(file, value);
+
+	read = read && ReadValue(file, value);
+	int modelType = atoi(value.data());
+	if (read && modelType >= 20 && modelType < 40)
+		read = ReadValue(file, value);
+
+	/* NOLIBF, NOLIFA, NOLICA, NOLICAT */
+	for (int i=0; read && i<4; ++i)
+		read = ReadValue(file, value);
+
+	read = read && ReadValue(file, value);
+	int numNodalAttributes = atoi(value.data());
+	for (int i=0; read && i<numNodalAttributes; ++i)
+		read = ReadValue(file, value);
+
+	/* NCOR, NTIP, NWS, NRAMP, G */
+	for (int i=0; read && i<5; ++i)
+		read = ReadValue(file, value);
+
+	read = read && ReadValue(file, value);
+	if (read && atof(value.data()) == -5.0)
+		read = ReadValue(file, value);
+
+	read = read && ReadValue(file, value);
+	file.close();
+
+	if (read)
+		timestep = atof(value.data());
+	return timestep > 0.0;
+}
+
+
+/**
+ * @brief Returns the model timestep
+ * @return DTDP in seconds, or 0 if the file could not be read
+ */
+double Fort15::GetTimestep()
+{
+	return timestep;
+}
+
+
+/**
+ * @brief Reads the first word of the next line
+ * @param file The open file
+ * @param value Set to the first word
+ * @return true if a line was read
+ */
+bool Fort15::ReadValue(std::ifstream &file, std::string &value)
+{
+	std::string line;
+	if (!std::getline(file, line))
+		return false;
+	value.clear();
+	std::stringstream lineStream (line);
+	lineStream >> value;
+	return true;
+}
@@ -0,0 +1,42 @@
+#ifndef FORT15_H
+#define FORT15_H
+
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+
+
+/**
+ * @brief Reads the model timestep from the ADCIRC control file (fort.15)
+ *
+ * Reads the model timestep (DTDP) from the ADCIRC control file (fort.15), which is
+ * needed to turn the record frequencies of fort.015, given in timesteps, into seconds.
+ * Only the lines up to DTDP are read. Each value is the first word of its line:
+ *
+ *     RUNDES, RUNID, NFOVER, NABOUT, NSCREEN, IHOT, ICS, IM, [IDEN], NOLIBF, NOLIFA,
+ *     NOLICA, NOLICAT, NWP, [NWP attribute names], NCOR, NTIP, NWS, NRAMP, G, TAU0,
+ *     [Tau0FullDomainMin Tau0FullDomainMax], DTDP
+ *
+ * IDEN is only there for the baroclinic model types (IM of 20 to 39), and the
+ * TAU0 limits only when TAU0 is -5.0. The class has no Qt dependencies.
+ *
+ */
+class Fort15
+{
+	public:
+		Fort15(std::string newLoc);
+
+		bool	ReadFile();
+
+		double	GetTimestep();
+
+	private:
+
+		std::string	filePath;
+		double		timestep;	/**< DTDP, in seconds, or 0 if it has not been read */
+
+		bool	ReadValue(std::ifstream &file, std::string &value);
+};
+
+#endif // FORT15_H
@@ -0,0 +1,430 @@
+#include "Fort63.h"
+
+Fort63::Fort63()
+{
+	filePath = "";
+	indexBuilt = false;
+	infoLine = "";
+	numNodes = 0;
+	valuesPerNode = 1;
+	indexedSize = 0;
+	netcdfFile = 0;
+}
+
+
+Fort63::Fort63(QString newLoc)
+{
+	filePath = newLoc;
+	indexBuilt = false;
+	infoLine = "";
+	numNodes = 0;
+	valuesPerNode = 1;
+	indexedSize = 0;
+	netcdfFile = 0;
+}
+
+
+Fort63::~Fort63()
+{
+	if (readFile.is_open())
+		readFile.close();
+	if (netcdfFile)
+		delete netcdfFile;
+}
+
+
+void Fort63::SetFilePath(QString newLoc)
+{
+	if (readFile.is_open())
+		readFile.close();
+	if (netcdfFile)
+		delete netcdfFile;
+	netcdfFile = 0;
+	filePath = newLoc;
+	indexBuilt = false;
+	timestepOffsets.clear();
+	timestepTimes.clear();
+}
+
+
+/**
+ * @brief Scans the file once and builds the timestep index
+ *
+ * Scans the file once and builds the timestep index. The file is read in large
+ * chunks and only the timestep header lines are parsed. Every other line is only
+ * counted.
+ *
+ * A netCDF file is opened through Fort63NetCDF instead, which reads the time of
+ * every timestep directly.
+ *
+ * @return true if the header was read and the index was built
+ */
+bool Fort63::BuildIndex()
+{
+	if (indexBuilt)
+		return true;
+
+	if (Fort63NetCDF::IsNetCDF(filePath))
+	{
+		if (!netcdfFile)
+			netcdfFile = new Fort63NetCDF(filePath);
+		indexBuilt = netcdfFile->Open();
+		return indexBuilt;
+	}
+
+	if (!ReadHeader())
+		return false;
+
+	timestepOffsets.clear();
+	timestepTimes.clear();
+
+	std::vector<char> chunk (FORT63_SCAN_CHUNK);
+	std::string headerLine;
+	unsigned int bodyLines = 0;	/* Lines left in the current timestep, 0 when expecting a header */
+	qint64 chunkOffset = readFile.tellg();
+	qint64 lineOffset = chunkOffset;
+	indexedSize = chunkOffset;
+
+	while (readFile.read(&chunk[0], chunk.size()) || readFile.gcount() > 0)
+	{
+		size_t chunkSize = readFile.gcount();
+		size_t pos = 0;
+		while (pos < chunkSize)
+		{
+			const char *newline = (const char*)memchr(&chunk[pos], '\n', chunkSize-pos);
+			size_t lineEnd = newline ? newline - &chunk[0] : chunkSize;
+			if (bodyLines == 0)
+				headerLine.append(&chunk[pos], lineEnd-pos);
+
+			/* The line continues in the next chunk */
+			if (!newline)
+				break;
+
+			if (bodyLines == 0)
+			{
+				IndexTimestepHeader(lineOffset, headerLine, bodyLines);
+				headerLine.clear();
+			} else {
+				--bodyLines;
+				if (bodyLines == 0)
+					indexedSize = chunkOffset + lineEnd + 1;
+			}
+
+			pos = lineEnd + 1;
+			lineOffset = chunkOffset + pos;
+		}
+		chunkOffset += chunkSize;
+	}
+
+	/* The last timestep is still being written */
+	if (bodyLines > 0 && timestepOffsets.size() > 0)
+	{
+		timestepOffsets.pop_back();
+		timestepTimes.pop_back();
+	}
+
+	readFile.clear();
+	indexBuilt = true;
+	return true;
+}
+
+
+bool Fort63::IndexBuilt()
+{
+	return indexBuilt;
+}
+
+
+/**
+ * @brief Reads all of the values of a single timestep
+ *
+ * Reads all of the values of a single timestep. The entire timestep is read with
+ * one seek and one read and then parsed in memory.
+ *
+ * @param ts The timestep (starting from 1)
+ * @param values The values, valuesPerNode for each node in node order
+ * @return true if the timestep was read
+ */
+bool Fort63::ReadTimestep(unsigned int ts, std::vector<float> &values)
+{
+	if (netcdfFile)
+		return indexBuilt && netcdfFile->ReadTimestep(ts, values);
+
+	if (!indexBuilt || ts < 1 || ts > timestepOffsets.size())
+		return false;
+
+	qint64 start = timestepOffsets[ts-1];
+	qint64 end = ts < timestepOffsets.size() ? timestepOffsets[ts] : indexedSize;
+	if (end <= start)
+		return false;
+
+	readBuffer.resize(end-start);
+	readFile.clear();
+	readFile.seekg(start);
+	readFile.read(&readBuffer[0], readBuffer.size());
+	if ((size_t)readFile.gcount() != readBuffer.size())
+		return false;
+
+	const char *curr = &readBuffer[0];
+	const char *bufferEnd = curr + readBuffer.size();
+	const char *newline = (const char*)memchr(curr, '\n', bufferEnd-curr);
+	if (!newline)
+		return false;
+
+	/* A sparse timestep gives the number of listed nodes and the value of every other node */
+	double time, iteration, numListed, defaultValue = 0.0;
+	const char *field = ParseValue(curr, newline, time);
+	field = ParseValue(field, newline, iteration);
+	field = ParseValue(field, newline, numListed);
+	if (!ParseValue(field, newline, defaultValue))
+		defaultValue = 0.0;
+
+	values.assign(numNodes*valuesPerNode, (float)defaultValue);
+
+	curr = newline + 1;
+	double nodeNumber, value;
+	while (curr < bufferEnd)
+	{
+		const char *lineEnd = (const char*)memchr(curr, '\n', bufferEnd-curr);
+		if (!lineEnd)
+			lineEnd = bufferEnd;
+
+		field = ParseValue(curr, lineEnd, nodeNumber);
+		if (field && nodeNumber >= 1.0 && nodeNumber <= numNodes)
+		{
+			float *nodeValues = &values[((unsigned int)nodeNumber-1)*valuesPerNode];
+			for (unsigned int i=0; i<valuesPerNode && field; ++i)
+			{
+				field = ParseValue(field, lineEnd, value);
+				if (field)
+					nodeValues[i] = (float)value;
+			}
+		}
+
+		curr = lineEnd + 1;
+	}
+
+	return true;
+}
+
+
+QString Fort63::GetFilePath()
+{
+	return filePath;
+}
+
+
+unsigned int Fort63::GetNumNodes()
+{
+	if (netcdfFile)
+		return netcdfFile->GetNumNodes();
+	return numNodes;
+}
+
+
+unsigned int Fort63::GetNumTimesteps()
+{
+	if (netcdfFile)
+		return netcdfFile->GetNumTimesteps();
+	return timestepOffsets.size();
+}
+
+
+unsigned int Fort63::GetValuesPerNode()
+{
+	if (netcdfFile)
+		return netcdfFile->GetValuesPerNode();
+	return valuesPerNode;
+}
+
+
+/**
+ * @brief Returns the model time of a timestep
+ * @param ts The timestep (starting from 1)
+ * @return The model time in seconds, or 0 if the timestep is not in the index
+ */
+double Fort63::GetTimestepTime(unsigned int ts)
+{
+	if (netcdfFile)
+		return netcdfFile->GetTimestepTime(ts);
+	if (ts < 1 || ts > timestepTimes.size())
+		return 0.0;
+	return timestepTimes[ts-1];
+}
+
+
+/**
+ * @brief Opens the file and reads the two header lines
+ *
+ * Opens the file and reads the two header lines. The second line holds the number
+ * of timesteps, the number of nodes, the output interval, the output frequency, and
+ * the record type, which is the number of values per node.
+ *
+ * @return true if the header was read
+ */
+bool Fort63::ReadHeader()
+{
+	if (readFile.is_open())
+		readFile.close();
+
+	readFile.open(filePath.toStdString().data(), std::ios::in | std::ios::binary);
+	if (!readFile.is_open())
+	{
+		std::cout << "WARNING: Unable to open " << filePath.toStdString().data() << std::endl;
+		return false;
+	}
+
+	std::string line;
+	if (!std::getline(readFile, infoLine) || !std::getline(readFile, line))
+		return false;
+
+	int numDatasets = 0, outputFrequency = 0, recordType = 1;
+	double outputInterval = 0.0;
+	std::stringstream(line) >> numDatasets >> numNodes >> outputInterval >> outputFrequency >> recordType;
+
+	valuesPerNode = recordType >= 1 && recordType <= 3 ? recordType : 1;
+	return numNodes > 0;
+}
+
+
+/**
+ * @brief Adds a timestep header line to the index
+ * @param offset The byte offset of the line
+ * @param line The line
+ * @param bodyLines Set to the number of node lines that follow the header
+ * @return true if the line is a timestep header
+ */
+bool Fort63::IndexTimestepHeader(qint64 offset, const std::string &line, unsigned int &bodyLines)
+{
+	const char *start = line.data();
+	const char *end = start + line.size();
+
+	double time, iteration, numListed;
+	const char *curr = ParseValue(start, end, time);
+	if (!curr || !(curr = ParseValue(curr, end, iteration)))
+	{
+		bodyLines = 0;
+		return false;
+	}
+
+	if (ParseValue(curr, end, numListed) && numListed >= 0.0)
+		bodyLines = (unsigned int)numListed;
+	else
+		bodyLines = numNodes;
+
+	timestepOffsets.push_back(offset);
+	timestepTimes.push_back(time);
+	if (bodyLines == 0)
+		indexedSize = offset + line.size() + 1;
+	return true;
+}
+
+
+/**
+ * @brief Parses a single number from a line
+ *
+ * Parses a single number from a line. This is much faster than a stream or
+ * strtod() for the fixed and exponential formats ADCIRC writes, including Fortran
+ * D exponents. Anything else is handed to strtod().
+ *
+ * @param start The first character to parse
+ * @param end The end of the line
+ * @param value The parsed number
+ * @return A pointer just past the number, or 0 if there was no number before the end of the line
+ */
+const char* Fort63::ParseValue(const char *start, const char *end, double &value)
+{
+	static const double powers[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+					1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+	if (!start)
+		return 0;
+
+	const char *curr = start;
+	while (curr < end && (*curr == ' ' || *curr == '\t' || *curr == '\r'))
+		++curr;
+	if (curr >= end || *curr == '\n')
+		return 0;
+
+	const char *numberStart = curr;
+	bool negative = false;
+	if (*curr == '-' || *curr == '+')
+	{
+		negative = *curr == '-';
+		++curr;
+	}
+
+	double mantissa = 0.0;
+	int digits = 0, exponent = 0;
+	while (curr < end && *curr >= '0' && *curr <= '9')
+	{
+		mantissa = mantissa*10.0 + (*curr - '0');
+		++digits;
+		++curr;
+	}
+	if (curr < end && *curr == '.')
+	{
+		++curr;
+		while (curr < end && *curr >= '0' && *curr <= '9')
+		{
+			mantissa = mantissa*10.0 + (*curr - '0');
+			--exponent;
+			++digits;
+			++curr;
+		}
+	}
+
+	if (digits == 0)
+	{
+		/* Not a plain number (NaN, Infinity, etc.) */
+		std::string token (numberStart, end);
+		char *tokenEnd = 0;
+		value = strtod(token.c_str(), &tokenEnd);
+		if (tokenEnd == token.c_str())
+			return 0;
+		return numberStart + (tokenEnd - token.c_str());
+	}
+
+	if (curr < end && (*curr == 'E' || *curr == 'e' || *curr == 'D' || *curr == 'd'))
+	{
+		const char *exponentStart = curr++;
+		bool negativeExponent = false;
+		if (curr < end && (*curr == '-' || *curr == '+'))
+		{
+			negativeExponent = *curr == '-';
+			++curr;
+		}
+		if (curr < end && *curr >= '0' && *curr <= '9')
+		{
+			int explicitExponent = 0;
+			while (curr < end && *curr >= '0' && *curr <= '9')
+			{
+				explicitExponent = explicitExponent*10 + (*curr - '0');
+				++curr;
+			}
+			exponent += negativeExponent ? -explicitExponent : explicitExponent;
+		} else {
+			curr = exponentStart;
+		}
+	}
+
+	if (exponent < 0)
+	{
+		while (exponent < -22)
+		{
+			mantissa /= powers[22];
+			exponent += 22;
+		}
+		mantissa /= powers[-exponent];
+	} else {
+		while (exponent > 22)
+		{
+			mantissa *= powers[22];
+			exponent -= 22;
+		}
+		mantissa *= powers[exponent];
+	}
+
+	value = negative ? -mantissa : mantissa;
+	return curr;
+}
@@ -0,0 +1,89 @@
+#ifndef FORT63_H
+#define FORT63_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+
+#include <QString>
+
+#include "Projects/IO/FileIO/Fort63NetCDF.h"
+
+#define FORT63_SCAN_CHUNK	4194304
+
+
+/**
+ * @brief Reads timesteps from an ADCIRC global output file (fort.63 or fort.64)
+ *
+ * The first time the file is opened, it is scanned once and the byte offset and
+ * time of every timestep are stored in an index. After that, any timestep can be
+ * read with a single seek, so playback never has to parse the timesteps before
+ * the one being shown. Both the full and the sparse ASCII formats are supported,
+ * and a timestep that is still being written at the end of the file is left out
+ * of the index.
+ *
+ * Scalar files (fort.63) have one value per node and vector files (fort.64) have
+ * two. Values are returned in node order, with values for the nodes missing from
+ * a sparse timestep set to the timestep's default value.
+ *
+ * netCDF files (fort.63.nc and fort.64.nc) are recognized by their signature and
+ * read through Fort63NetCDF instead, which needs no index.
+ *
+ * Timesteps are numbered from 1.
+ *
+ */
+class Fort63
+{
+	public:
+		Fort63();
+		Fort63(QString newLoc);
+		~Fort63();
+
+		void	SetFilePath(QString newLoc);
+		bool	BuildIndex();
+		bool	IndexBuilt();
+
+		bool	ReadTimestep(unsigned int ts, std::vector<float> &values);
+
+		/* Getter Methods */
+		QString		GetFilePath();
+		unsigned int	GetNumNodes();
+		unsigned int	GetNumTimesteps();
+		unsigned int	GetValuesPerNode();
+		double		GetTimestepTime(unsigned int ts);
+
+	private:
+
+		QString		filePath;
+		std::ifstream	readFile;
+		bool		indexBuilt;
+
+		/* Header */
+		std::string	infoLine;
+		unsigned int	numNodes;
+		unsigned int	valuesPerNode;
+
+		/* Index */
+		std::vector<qint64>	timestepOffsets;	/**< Byte offset of each timestep header line */
+		std::vector<double>	timestepTimes;		/**< Model time of each timestep */
+		qint64			indexedSize;		/**< The byte offset just past the last indexed timestep */
+		std::vector<char>	readBuffer;
+
+		/* netCDF */
+		Fort63NetCDF*	netcdfFile;	/**< Reads the file instead if it is a netCDF file, 0 otherwise */
+
+		bool	ReadHeader();
+		bool	IndexTimestepHeader(qint64 offset, const std::string &line, unsigned int &bodyLines);
+
+		static const char*	ParseValue(const char *start, const char *end, double &value);
+
+		/* netcdfFile is owned and deleted by this object, so it can't be copied */
+		Fort63(const Fort63&);
+		Fort63&	operator=(const Fort63&);
+};
+
+#endif // FORT63_H
@@ -0,0 +1,509 @@
+#include "Fort63Cache.h"
+
+static const char FORT63_CACHE_MAGIC[8] = {'A', 'D', 'C', '6', '3', 'C', 'H', '\0'};
+
+
+Fort63Cache::Fort63Cache(QObject *parent) :
+	QObject(parent)
+{
+	sourcePath = "";
+	cachePath = "";
+	compressChunks = false;
+	cacheOpen = false;
+	nodeChunkIndex = 0;
+	memset(&header, 0, sizeof(Fort63CacheHeader));
+}
+
+
+Fort63Cache::Fort63Cache(QString sourceLoc, QObject *parent) :
+	QObject(parent)
+{
+	sourcePath = sourceLoc;
+	cachePath = GetCachePath(sourceLoc);
+	compressChunks = false;
+	cacheOpen = false;
+	nodeChunkIndex = 0;
+	memset(&header, 0, sizeof(Fort63CacheHeader));
+}
+
+
+Fort63Cache::~Fort63Cache()
+{
+	if (readFile.is_open())
+		readFile.close();
+}
+
+
+/**
+ * @brief Returns the location of the cache file for an output file
+ * @param sourceLoc The fort.63 or fort.64 file
+ * @return The cache file location
+ */
+QString Fort63Cache::GetCachePath(QString sourceLoc)
+{
+	return sourceLoc + ".cache";
+}
+
+
+void Fort63Cache::SetSourcePath(QString newLoc)
+{
+	if (readFile.is_open())
+		readFile.close();
+	cacheOpen = false;
+	nodeChunkIndex = 0;
+	sourcePath = newLoc;
+	cachePath = GetCachePath(newLoc);
+}
+
+
+/**
+ * @brief Sets whether chunks are compressed when the cache is built
+ *
+ * Sets whether chunks are compressed when the cache is built. Compression makes
+ * the cache considerably smaller for runs with large dry areas, at the cost of
+ * decompressing every chunk that is read.
+ *
+ * @param compress true to compress chunks
+ */
+void Fort63Cache::SetCompression(bool compress)
+{
+	compressChunks = compress;
+}
+
+
+/**
+ * @brief Checks if the cache file exists and was built from the current output file
+ * @return true if the cache can be used
+ */
+bool Fort63Cache::CacheIsCurrent()
+{
+	qint64 sourceSize = 0, sourceModified = 0;
+	if (!ReadSourceInfo(sourceSize, sourceModified))
+		return false;
+
+	std::ifstream cacheFile (cachePath.toStdString().data(), std::ios::in | std::ios::binary);
+	if (!cacheFile.is_open())
+		return false;
+
+	Fort63CacheHeader cacheHeader;
+	cacheFile.read((char*)&cacheHeader, sizeof(Fort63CacheHeader));
+	bool headerRead = cacheFile.gcount() == sizeof(Fort63CacheHeader);
+	cacheFile.close();
+
+	return headerRead &&
+	       memcmp(cacheHeader.magic, FORT63_CACHE_MAGIC, sizeof(FORT63_CACHE_MAGIC)) == 0 &&
+	       cacheHeader.version == FORT63_CACHE_VERSION &&
+	       cacheHeader.sourceSize == sourceSize &&
+	       cacheHeader.sourceModified == sourceModified;
+}
+
+
+/**
+ * @brief Builds the cache file from the output file
+ *
+ * Builds the cache file from the output file. The output file is indexed and
+ * read once to write the time-major chunks, and the node-major chunks are then
+ * built from the time-major chunks. The cache is written to a temporary file and
+ * renamed when complete, so an existing cache is never left half written.
+ *
+ * @return true if the cache was built
+ */
+bool Fort63Cache::BuildCache()
+{
+	emit startedBuilding();
+
+	if (readFile.is_open())
+		readFile.close();
+	cacheOpen = false;
+	nodeChunkIndex = 0;
+
+	Fort63 source (sourcePath);
+	qint64 sourceSize = 0, sourceModified = 0;
+	if (!ReadSourceInfo(sourceSize, sourceModified) || !source.BuildIndex() || source.GetNumTimesteps() == 0)
+	{
+		std::cout << "WARNING: Unable to index " << sourcePath.toStdString().data() << std::endl;
+		emit finishedBuilding();
+		return false;
+	}
+
+	memset(&header, 0, sizeof(Fort63CacheHeader));
+	memcpy(header.magic, FORT63_CACHE_MAGIC, sizeof(FORT63_CACHE_MAGIC));
+	header.sourceSize = sourceSize;
+	header.sourceModified = sourceModified;
+	header.version = FORT63_CACHE_VERSION;
+	header.numNodes = source.GetNumNodes();
+	header.numTimesteps = source.GetNumTimesteps();
+	header.valuesPerNode = source.GetValuesPerNode();
+	header.nodesPerChunk = FORT63_CACHE_CHUNK_VALUES / (header.numTimesteps*header.valuesPerNode);
+	if (header.nodesPerChunk < 1)
+		header.nodesPerChunk = 1;
+	if (header.nodesPerChunk > header.numNodes)
+		header.nodesPerChunk = header.numNodes;
+	header.compressed = compressChunks ? 1 : 0;
+
+	timestepTimes.resize(header.numTimesteps);
+	for (unsigned int i=0; i<header.numTimesteps; ++i)
+		timestepTimes[i] = source.GetTimestepTime(i+1);
+
+	Fort63CacheChunk emptyChunk = {0, 0};
+	chunks.assign(header.numTimesteps + NumNodeChunks(), emptyChunk);
+
+	QString tempPath = cachePath + ".tmp";
+	std::fstream cacheFile (tempPath.toStdString().data(), std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!cacheFile.is_open())
+	{
+		std::cout << "WARNING: Unable to create " << cachePath.toStdString().data() << std::endl;
+		emit finishedBuilding();
+		return false;
+	}
+
+	/* The chunk directory is written again once every chunk's location is known */
+	cacheFile.write((const char*)&header, sizeof(Fort63CacheHeader));
+	cacheFile.write((const char*)&timestepTimes[0], timestepTimes.size()*sizeof(double));
+	std::streampos directoryPosition = cacheFile.tellp();
+	cacheFile.write((const char*)&chunks[0], chunks.size()*sizeof(Fort63CacheChunk));
+
+	bool built = WriteTimeMajorChunks(source, cacheFile) && WriteNodeMajorChunks(cacheFile);
+	if (built)
+	{
+		cacheFile.seekp(directoryPosition);
+		cacheFile.write((const char*)&chunks[0], chunks.size()*sizeof(Fort63CacheChunk));
+	}
+	built = built && !cacheFile.fail();
+	cacheFile.close();
+
+	if (built)
+	{
+		QFile::remove(cachePath);
+		QFile::rename(tempPath, cachePath);
+		emit emitMessage(QString("Cached ").append(QString::number(header.numTimesteps)).append(" timesteps of ").append(sourcePath));
+	} else {
+		QFile::remove(tempPath);
+		std::cout << "WARNING: Unable to build the cache of " << sourcePath.toStdString().data() << std::endl;
+	}
+
+	emit progress(100);
+	emit finishedBuilding();
+	return built;
+}
+
+
+void Fort63Cache::buildCache()
+{
+	BuildCache();
+}
+
+
+/**
+ * @brief Opens the cache file for reading
+ * @return true if the cache file was opened and its directory was read
+ */
+bool Fort63Cache::Open()
+{
+	if (cacheOpen)
+		return true;
+
+	if (readFile.is_open())
+		readFile.close();
+	readFile.clear();
+	readFile.open(cachePath.toStdString().data(), std::ios::in | std::ios::binary);
+	if (!readFile.is_open())
+		return false;
+
+	readFile.read((char*)&header, sizeof(Fort63CacheHeader));
+	if (readFile.gcount() != sizeof(Fort63CacheHeader) ||
+	    memcmp(header.magic, FORT63_CACHE_MAGIC, sizeof(FORT63_CACHE_MAGIC)) != 0 ||
+	    header.version != FORT63_CACHE_VERSION ||
+	    header.numNodes == 0 || header.numTimesteps == 0 || header.nodesPerChunk == 0)
+	{
+		std::cout << "WARNING: " << cachePath.toStdString().data() << " is not a fort.63 cache file" << std::endl;
+		readFile.close();
+		return false;
+	}
+
+	timestepTimes.resize(header.numTimesteps);
+	chunks.resize(header.numTimesteps + NumNodeChunks());
+	readFile.read((char*)&timestepTimes[0], timestepTimes.size()*sizeof(double));
+	readFile.read((char*)&chunks[0], chunks.size()*sizeof(Fort63CacheChunk));
+	if (readFile.fail())
+	{
+		readFile.close();
+		return false;
+	}
+
+	nodeChunkIndex = 0;
+	cacheOpen = true;
+	return true;
+}
+
+
+/**
+ * @brief Reads all of the values of a single timestep
+ * @param ts The timestep (starting from 1)
+ * @param values The values, valuesPerNode for each node in node order
+ * @return true if the timestep was read
+ */
+bool Fort63Cache::ReadTimestep(unsigned int ts, std::vector<float> &values)
+{
+	if (!cacheOpen || ts < 1 || ts > header.numTimesteps)
+		return false;
+
+	return ReadChunk(readFile, chunks[ts-1], (size_t)header.numNodes*header.valuesPerNode, values);
+}
+
+
+/**
+ * @brief Reads the value of a single node at every timestep
+ *
+ * Reads the value of a single node at every timestep. The chunk holding the node
+ * is kept, so reading the history of neighboring nodes does not touch the disk again.
+ *
+ * @param node The node number (starting from 1)
+ * @param values The values, valuesPerNode for each timestep in timestep order
+ * @return true if the history was read
+ */
+bool Fort63Cache::ReadNodeHistory(unsigned int node, std::vector<float> &values)
+{
+	if (!cacheOpen || node < 1 || node > header.numNodes)
+		return false;
+
+	unsigned int chunk = (node-1) / header.nodesPerChunk;
+	size_t nodeValues = (size_t)header.numTimesteps*header.valuesPerNode;
+	if (nodeChunkIndex != chunk+1)
+	{
+		unsigned int chunkNodes = header.numNodes - chunk*header.nodesPerChunk;
+		if (chunkNodes > header.nodesPerChunk)
+			chunkNodes = header.nodesPerChunk;
+
+		nodeChunkIndex = 0;
+		if (!ReadChunk(readFile, chunks[header.numTimesteps + chunk], chunkNodes*nodeValues, nodeChunk))
+			return false;
+		nodeChunkIndex = chunk+1;
+	}
+
+	size_t first = ((node-1) - chunk*header.nodesPerChunk)*nodeValues;
+	values.assign(nodeChunk.begin() + first, nodeChunk.begin() + first + nodeValues);
+	return true;
+}
+
+
+QString Fort63Cache::GetSourcePath()
+{
+	return sourcePath;
+}
+
+
+unsigned int Fort63Cache::GetNumNodes()
+{
+	return header.numNodes;
+}
+
+
+unsigned int Fort63Cache::GetNumTimesteps()
+{
+	return header.numTimesteps;
+}
+
+
+unsigned int Fort63Cache::GetValuesPerNode()
+{
+	return header.valuesPerNode;
+}
+
+
+/**
+ * @brief Returns the model time of a timestep
+ * @param ts The timestep (starting from 1)
+ * @return The model time in seconds, or 0 if the timestep is not in the cache
+ */
+double Fort63Cache::GetTimestepTime(unsigned int ts)
+{
+	if (ts < 1 || ts > timestepTimes.size())
+		return 0.0;
+	return timestepTimes[ts-1];
+}
+
+
+bool Fort63Cache::ReadSourceInfo(qint64 &size, qint64 &modified)
+{
+	QFileInfo sourceInfo (sourcePath);
+	if (!sourceInfo.exists())
+		return false;
+
+	size = sourceInfo.size();
+	modified = sourceInfo.lastModified().toMSecsSinceEpoch();
+	return true;
+}
+
+
+/**
+ * @brief Writes one time-major chunk for each timestep of the output file
+ * @param source The indexed output file
+ * @param cacheFile The cache file being built
+ * @return true if every timestep was read and written
+ */
+bool Fort63Cache::WriteTimeMajorChunks(Fort63 &source, std::fstream &cacheFile)
+{
+	std::vector<float> values;
+	size_t numValues = (size_t)header.numNodes*header.valuesPerNode;
+	int lastProgress = -1;
+
+	for (unsigned int ts=1; ts<=header.numTimesteps; ++ts)
+	{
+		if (TaskScheduler::Instance()->CurrentTaskCancelled())
+			return false;
+		if (!source.ReadTimestep(ts, values) || values.size() != numValues)
+			return false;
+		if (!WriteChunk(cacheFile, values, 0, numValues, chunks[ts-1]))
+			return false;
+
+		int currProgress = (int)(50.0*ts/header.numTimesteps);
+		if (currProgress != lastProgress)
+		{
+			emit progress(currProgress);
+			lastProgress = currProgress;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * @brief Transposes the time-major chunks into node-major chunks
+ *
+ * Transposes the time-major chunks into node-major chunks. Each pass gathers the
+ * history of as many nodes as fit in FORT63_CACHE_TRANSPOSE_MEMORY from every
+ * time-major chunk and then writes them out, so the whole run never has to be in
+ * memory at once.
+ *
+ * @param cacheFile The cache file being built, with every time-major chunk written
+ * @return true if every node-major chunk was written
+ */
+bool Fort63Cache::WriteNodeMajorChunks(std::fstream &cacheFile)
+{
+	unsigned int numTimesteps = header.numTimesteps;
+	unsigned int valuesPerNode = header.valuesPerNode;
+	size_t nodeValues = (size_t)numTimesteps*valuesPerNode;
+
+	size_t nodesPerPass = FORT63_CACHE_TRANSPOSE_MEMORY / (sizeof(float)*nodeValues);
+	nodesPerPass -= nodesPerPass % header.nodesPerChunk;
+	if (nodesPerPass < header.nodesPerChunk)
+		nodesPerPass = header.nodesPerChunk;
+	unsigned int numPasses = (header.numNodes + nodesPerPass - 1) / nodesPerPass;
+
+	std::vector<float> timestep, transposed;
+	int lastProgress = -1;
+	unsigned int pass = 0;
+	for (unsigned int firstNode=0; firstNode<header.numNodes; firstNode+=nodesPerPass, ++pass)
+	{
+		unsigned int passNodes = header.numNodes - firstNode;
+		if (passNodes > nodesPerPass)
+			passNodes = nodesPerPass;
+		transposed.resize(passNodes*nodeValues);
+
+		for (unsigned int ts=0; ts<numTimesteps; ++ts)
+		{
+			if (TaskScheduler::Instance()->CurrentTaskCancelled())
+				return false;
+			if (!ReadChunk(cacheFile, chunks[ts], (size_t)header.numNodes*valuesPerNode, timestep))
+				return false;
+
+			const float *passValues = &timestep[(size_t)firstNode*valuesPerNode];
+			for (unsigned int n=0; n<passNodes; ++n)
+				for (unsigned int v=0; v<valuesPerNode; ++v)
+					transposed[n*nodeValues + ts*valuesPerNode + v] = passValues[n*valuesPerNode + v];
+
+			int currProgress = 50 + (int)(50.0*((double)pass*numTimesteps + ts + 1)/((double)numPasses*numTimesteps));
+			if (currProgress != lastProgress)
+			{
+				emit progress(currProgress);
+				lastProgress = currProgress;
+			}
+		}
+
+		for (unsigned int n=0; n<passNodes; n+=header.nodesPerChunk)
+		{
+			unsigned int chunkNodes = passNodes - n;
+			if (chunkNodes > header.nodesPerChunk)
+				chunkNodes = header.nodesPerChunk;
+
+			unsigned int chunk = numTimesteps + (firstNode + n)/header.nodesPerChunk;
+			if (!WriteChunk(cacheFile, transposed, n*nodeValues, chunkNodes*nodeValues, chunks[chunk]))
+				return false;
+		}
+	}
+	return true;
+}
+
+
+/**
+ * @brief Appends a chunk to the end of the cache file
+ * @param cacheFile The cache file being built
+ * @param values The values
+ * @param first The first value of the chunk
+ * @param count The number of values in the chunk
+ * @param chunk Set to the location of the chunk
+ * @return true if the chunk was written
+ */
+bool Fort63Cache::WriteChunk(std::fstream &cacheFile, const std::vector<float> &values, size_t first, size_t count, Fort63CacheChunk &chunk)
+{
+	cacheFile.clear();
+	cacheFile.seekp(0, std::ios::end);
+	chunk.offset = cacheFile.tellp();
+
+	if (compressChunks)
+	{
+		QByteArray compressed = qCompress((const uchar*)&values[first], count*sizeof(float));
+		cacheFile.write(compressed.constData(), compressed.size());
+		chunk.size = compressed.size();
+	} else {
+		cacheFile.write((const char*)&values[first], count*sizeof(float));
+		chunk.size = count*sizeof(float);
+	}
+
+	return !cacheFile.fail();
+}
+
+
+/**
+ * @brief Reads a chunk from the cache file
+ * @param cacheFile The cache file
+ * @param chunk The location of the chunk
+ * @param count The number of values in the chunk
+ * @param values The values
+ * @return true if the chunk was read and held the expected number of values
+ */
+bool Fort63Cache::ReadChunk(std::istream &cacheFile, const Fort63CacheChunk &chunk, size_t count, std::vector<float> &values)
+{
+	if (chunk.size <= 0 || count == 0)
+		return false;
+
+	chunkBuffer.resize(chunk.size);
+	cacheFile.clear();
+	cacheFile.seekg(chunk.offset);
+	cacheFile.read(&chunkBuffer[0], chunkBuffer.size());
+	if ((size_t)cacheFile.gcount() != chunkBuffer.size())
+		return false;
+
+	values.resize(count);
+	if (header.compressed)
+	{
+		QByteArray uncompressed = qUncompress((const uchar*)&chunkBuffer[0], chunkBuffer.size());
+		if ((size_t)uncompressed.size() != count*sizeof(float))
+			return false;
+		memcpy(&values[0], uncompressed.constData(), uncompressed.size());
+	} else {
+		if (chunkBuffer.size() != count*sizeof(float))
+			return false;
+		memcpy(&values[0], &chunkBuffer[0], chunkBuffer.size());
+	}
+	return true;
+}
+
+
+unsigned int Fort63Cache::NumNodeChunks()
+{
+	if (header.nodesPerChunk == 0)
+		return 0;
+	return (header.numNodes + header.nodesPerChunk - 1) / header.nodesPerChunk;
+}
@@ -0,0 +1,141 @@
+#ifndef FORT63CACHE_H
+#define FORT63CACHE_H
+
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+
+#include <QObject>
+#include <QString>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QByteArray>
+
+#include "Projects/IO/FileIO/Fort63.h"
+#include "Tasks/TaskScheduler.h"
+
+#define FORT63_CACHE_VERSION		1
+#define FORT63_CACHE_CHUNK_VALUES	262144
+#define FORT63_CACHE_TRANSPOSE_MEMORY	268435456
+
+
+/**
+ * @brief The fixed size header at the start of a fort.63 cache file
+ */
+struct Fort63CacheHeader
+{
+	char		magic[8];
+	qint64		sourceSize;		/**< Size of the output file when the cache was built */
+	qint64		sourceModified;		/**< Modification time of the output file when the cache was built (ms) */
+	quint32		version;
+	quint32		numNodes;
+	quint32		numTimesteps;
+	quint32		valuesPerNode;
+	quint32		nodesPerChunk;		/**< Number of nodes in each node-major chunk */
+	quint32		compressed;		/**< 1 if every chunk is compressed */
+};
+
+
+/**
+ * @brief The location of a single chunk in a fort.63 cache file
+ */
+struct Fort63CacheChunk
+{
+	qint64	offset;
+	qint64	size;	/**< Stored size in bytes, after compression */
+};
+
+
+/**
+ * @brief A binary cache of an ADCIRC global output file (fort.63 or fort.64) for
+ * random access by timestep or by node
+ *
+ * The ASCII output files can only be read front to back. The cache stores the same
+ * values as floats twice: once in time-major chunks holding every node of a single
+ * timestep, and once in node-major chunks holding every timestep of a range of nodes.
+ * Reading a timestep or the full history of a node is then a single seek and a single
+ * chunk read, no matter how long the run was. netCDF output that is stored timestep
+ * by timestep has the same problem for node histories, so it is cached the same way
+ * (fort.63.nc becomes fort.63.nc.cache).
+ *
+ * The cache is written next to the output file (fort.63 becomes fort.63.cache). It
+ * records the size and modification time of the output file, and is rebuilt when the
+ * output file changes. The node-major chunks are built from the time-major chunks in
+ * as few passes as FORT63_CACHE_TRANSPOSE_MEMORY allows, so runs larger than memory can
+ * be cached. Chunks can optionally be compressed with qCompress().
+ *
+ * Values are stored in the byte order of the machine that built the cache.
+ *
+ * Building the cache of a long run takes about as long as reading the whole output
+ * file, so it should be started off the GUI thread, through the buildCache() slot.
+ * The object can be used to read the cache once finishedBuilding() is emitted.
+ *
+ */
+class Fort63Cache : public QObject
+{
+		Q_OBJECT
+	public:
+		Fort63Cache(QObject *parent=0);
+		Fort63Cache(QString sourceLoc, QObject *parent=0);
+		~Fort63Cache();
+
+		static QString	GetCachePath(QString sourceLoc);
+
+		void	SetSourcePath(QString newLoc);
+		void	SetCompression(bool compress);
+
+		bool	CacheIsCurrent();
+		bool	BuildCache();
+		bool	Open();
+
+		bool	ReadTimestep(unsigned int ts, std::vector<float> &values);
+		bool	ReadNodeHistory(unsigned int node, std::vector<float> &values);
+
+		/* Getter Methods */
+		QString		GetSourcePath();
+		unsigned int	GetNumNodes();
+		unsigned int	GetNumTimesteps();
+		unsigned int	GetValuesPerNode();
+		double		GetTimestepTime(unsigned int ts);
+
+	private:
+
+		QString		sourcePath;
+		QString		cachePath;
+		bool		compressChunks;
+
+		/* Reading */
+		std::ifstream			readFile;
+		bool				cacheOpen;
+		Fort63CacheHeader		header;
+		std::vector<double>		timestepTimes;
+		std::vector<Fort63CacheChunk>	chunks;		/**< Time-major chunks, then node-major chunks */
+		std::vector<char>		chunkBuffer;
+		std::vector<float>		nodeChunk;		/**< The most recently read node-major chunk */
+		unsigned int			nodeChunkIndex;		/**< Index of the chunk in nodeChunk, or 0 if empty */
+
+		/* Building */
+		bool	ReadSourceInfo(qint64 &size, qint64 &modified);
+		bool	WriteTimeMajorChunks(Fort63 &source, std::fstream &cacheFile);
+		bool	WriteNodeMajorChunks(std::fstream &cacheFile);
+		bool	WriteChunk(std::fstream &cacheFile, const std::vector<float> &values, size_t first, size_t count, Fort63CacheChunk &chunk);
+
+		bool	ReadChunk(std::istream &cacheFile, const Fort63CacheChunk &chunk, size_t count, std::vector<float> &values);
+		unsigned int	NumNodeChunks();
+
+	public slots:
+
+		void	buildCache();
+
+	signals:
+
+		void	startedBuilding();
+		void	progress(int);
+		void	finishedBuilding();
+		void	emitMessage(QString);
+
+};
+
+#endif // FORT63CACHE_H
@@ -0,0 +1,367 @@
+#include "Fort63NetCDF.h"
+
+QMutex Fort63NetCDF::libraryMutex;
+
+Fort63NetCDF::Fort63NetCDF()
+{
+	filePath = "";
+	fileID = -1;
+	fileOpen = false;
+	numNodes = 0;
+	numTimesteps = 0;
+	timeChunk = 1;
+	nodeChunk = NETCDF_NODE_BLOCK;
+	chunked = false;
+	timeBlockFirst = 0;
+	timeBlockCount = 0;
+	nodeBlockFirst = 0;
+	nodeBlockCount = 0;
+}
+
+
+Fort63NetCDF::Fort63NetCDF(QString newLoc)
+{
+	filePath = newLoc;
+	fileID = -1;
+	fileOpen = false;
+	numNodes = 0;
+	numTimesteps = 0;
+	timeChunk = 1;
+	nodeChunk = NETCDF_NODE_BLOCK;
+	chunked = false;
+	timeBlockFirst = 0;
+	timeBlockCount = 0;
+	nodeBlockFirst = 0;
+	nodeBlockCount = 0;
+}
+
+
+Fort63NetCDF::~Fort63NetCDF()
+{
+	Close();
+}
+
+
+/**
+ * @brief Checks the first bytes of a file for the netCDF3 or netCDF4 (HDF5) signature
+ * @param fileLoc The file
+ * @return true if the file is a netCDF file
+ */
+bool Fort63NetCDF::IsNetCDF(QString fileLoc)
+{
+	std::ifstream testFile (fileLoc.toStdString().data(), std::ios::in | std::ios::binary);
+	char signature[8];
+	if (!testFile.read(signature, 8))
+		return false;
+
+	if (memcmp(signature, "CDF", 3) == 0 && (signature[3] == 1 || signature[3] == 2 || signature[3] == 5))
+		return true;
+	return memcmp(signature, "\211HDF\r\n\032\n", 8) == 0;
+}
+
+
+void Fort63NetCDF::SetFilePath(QString newLoc)
+{
+	Close();
+	filePath = newLoc;
+}
+
+
+/**
+ * @brief Opens the file and reads its dimensions and timestep times
+ * @return true if the file holds an ADCIRC (time, node) output variable
+ */
+bool Fort63NetCDF::Open()
+{
+	if (fileOpen)
+		return true;
+
+#ifdef ADCIRC_NETCDF
+	QMutexLocker locker (&libraryMutex);
+	if (nc_open(filePath.toStdString().data(), NC_NOWRITE, &fileID) != NC_NOERR)
+	{
+		std::cout << "WARNING: Unable to open " << filePath.toStdString().data() << std::endl;
+		return false;
+	}
+	fileOpen = true;
+
+	if (!ReadLayout())
+	{
+		std::cout << "WARNING: " << filePath.toStdString().data() << " is not an ADCIRC netCDF output file" << std::endl;
+		locker.unlock();
+		Close();
+		return false;
+	}
+	return true;
+#else
+	std::cout << "WARNING: Unable to open " << filePath.toStdString().data() << ". netCDF support was not compiled in." << std::endl;
+	return false;
+#endif
+}
+
+
+bool Fort63NetCDF::IsOpen()
+{
+	return fileOpen;
+}
+
+
+/**
+ * @brief Checks if the history of a node can be read without reading most of the file
+ *
+ * Checks if the history of a node can be read without reading most of the file,
+ * which is the case when the output variable is chunked into columns of no more
+ * than NETCDF_NODE_BLOCK nodes.
+ *
+ * @return true if the file is open and node histories are cheap to read
+ */
+bool Fort63NetCDF::NodeReadsAreCheap()
+{
+	return fileOpen && chunked && nodeChunk <= NETCDF_NODE_BLOCK;
+}
+
+
+/**
+ * @brief Reads all of the values of a single timestep
+ * @param ts The timestep (starting from 1)
+ * @param values The values, valuesPerNode for each node in node order
+ * @return true if the timestep was read
+ */
+bool Fort63NetCDF::ReadTimestep(unsigned int ts, std::vector<float> &values)
+{
+	if (!fileOpen || ts < 1 || ts > numTimesteps)
+		return false;
+
+	unsigned int valuesPerNode = variableIDs.size();
+	if (timeBlockFirst == 0 || ts < timeBlockFirst || ts >= timeBlockFirst + timeBlockCount)
+	{
+		/* Read the whole row of chunks that holds the timestep if it fits */
+		size_t rowSize = sizeof(float)*numNodes*valuesPerNode;
+		size_t count = timeChunk*rowSize <= NETCDF_BLOCK_MEMORY ? timeChunk : 1;
+		size_t first = (ts-1) / count * count;
+		if (first + count > numTimesteps)
+			count = numTimesteps - first;
+
+		timeBlockFirst = 0;
+		if (!ReadBlock(first, count, 0, numNodes, timeBlock))
+			return false;
+		timeBlockFirst = first + 1;
+		timeBlockCount = count;
+	}
+
+	values.resize(numNodes*valuesPerNode);
+	for (unsigned int v=0; v<valuesPerNode; ++v)
+	{
+		const float *row = &timeBlock[((size_t)v*timeBlockCount + (ts - timeBlockFirst))*numNodes];
+		for (unsigned int i=0; i<numNodes; ++i)
+			values[i*valuesPerNode+v] = row[i];
+	}
+	return true;
+}
+
+
+/**
+ * @brief Reads the values at a single node for every timestep
+ * @param node The node number (starting from 1)
+ * @param values The values, valuesPerNode for each timestep in timestep order
+ * @return true if the history was read
+ */
+bool Fort63NetCDF::ReadNodeHistory(unsigned int node, std::vector<float> &values)
+{
+	if (!fileOpen || node < 1 || node > numNodes || numTimesteps == 0)
+		return false;
+
+	unsigned int valuesPerNode = variableIDs.size();
+	if (nodeBlockFirst == 0 || node < nodeBlockFirst || node >= nodeBlockFirst + nodeBlockCount)
+	{
+		/* Read the whole column of chunks that holds the node if it fits */
+		size_t columnSize = sizeof(float)*numTimesteps*valuesPerNode;
+		size_t count = nodeChunk*columnSize <= NETCDF_BLOCK_MEMORY ? nodeChunk : NETCDF_BLOCK_MEMORY / columnSize;
+		if (count < 1)
+			count = 1;
+		size_t first = (node-1) / count * count;
+		if (first + count > numNodes)
+			count = numNodes - first;
+
+		nodeBlockFirst = 0;
+		if (!ReadBlock(0, numTimesteps, first, count, nodeBlock))
+			return false;
+		nodeBlockFirst = first + 1;
+		nodeBlockCount = count;
+	}
+
+	values.resize(numTimesteps*valuesPerNode);
+	for (unsigned int v=0; v<valuesPerNode; ++v)
+	{
+		const float *column = &nodeBlock[(size_t)v*numTimesteps*nodeBlockCount + (node - nodeBlockFirst)];
+		for (unsigned int ts=0; ts<numTimesteps; ++ts)
+			values[ts*valuesPerNode+v] = column[(size_t)ts*nodeBlockCount];
+	}
+	return true;
+}
+
+
+QString Fort63NetCDF::GetFilePath()
+{
+	return filePath;
+}
+
+
+unsigned int Fort63NetCDF::GetNumNodes()
+{
+	return numNodes;
+}
+
+
+unsigned int Fort63NetCDF::GetNumTimesteps()
+{
+	return numTimesteps;
+}
+
+
+unsigned int Fort63NetCDF::GetValuesPerNode()
+{
+	return variableIDs.size() > 0 ? variableIDs.size() : 1;
+}
+
+
+/**
+ * @brief Returns the model time of a timestep
+ * @param ts The timestep (starting from 1)
+ * @return The model time in seconds, or 0 if the timestep is not in the file
+ */
+double Fort63NetCDF::GetTimestepTime(unsigned int ts)
+{
+	if (ts < 1 || ts > timestepTimes.size())
+		return 0.0;
+	return timestepTimes[ts-1];
+}
+
+
+void Fort63NetCDF::Close()
+{
+#ifdef ADCIRC_NETCDF
+	if (fileOpen)
+	{
+		QMutexLocker locker (&libraryMutex);
+		nc_close(fileID);
+	}
+#endif
+	fileOpen = false;
+	fileID = -1;
+	variableIDs.clear();
+	timestepTimes.clear();
+	numNodes = 0;
+	numTimesteps = 0;
+	timeBlock.clear();
+	nodeBlock.clear();
+	timeBlockFirst = timeBlockCount = 0;
+	nodeBlockFirst = nodeBlockCount = 0;
+}
+
+
+/**
+ * @brief Finds the time and node dimensions, the output variables, and their chunking
+ *
+ * Finds the time and node dimensions, the output variables, and their chunking, and
+ * reads the time of every timestep. fort.63.nc holds zeta, and fort.64.nc holds u-vel
+ * and v-vel. Both must be stored as (time, node). Must be called with the library
+ * mutex held.
+ *
+ * @return true if the layout was read
+ */
+bool Fort63NetCDF::ReadLayout()
+{
+#ifdef ADCIRC_NETCDF
+	int timeDimID, nodeDimID, timeVarID;
+	size_t timeLength, nodeLength;
+	if (nc_inq_dimid(fileID, "time", &timeDimID) != NC_NOERR ||
+	    nc_inq_dimid(fileID, "node", &nodeDimID) != NC_NOERR ||
+	    nc_inq_dimlen(fileID, timeDimID, &timeLength) != NC_NOERR ||
+	    nc_inq_dimlen(fileID, nodeDimID, &nodeLength) != NC_NOERR ||
+	    nc_inq_varid(fileID, "time", &timeVarID) != NC_NOERR)
+		return false;
+
+	const char *scalarNames[] = {"zeta"};
+	const char *vectorNames[] = {"u-vel", "v-vel"};
+	int varID;
+	variableIDs.clear();
+	if (nc_inq_varid(fileID, scalarNames[0], &varID) == NC_NOERR)
+	{
+		variableIDs.push_back(varID);
+	}
+	else
+	{
+		for (int i=0; i<2; ++i)
+		{
+			if (nc_inq_varid(fileID, vectorNames[i], &varID) != NC_NOERR)
+				return false;
+			variableIDs.push_back(varID);
+		}
+	}
+
+	for (std::vector<int>::iterator it=variableIDs.begin(); it != variableIDs.end(); ++it)
+	{
+		int numDims, dimIDs[NC_MAX_VAR_DIMS];
+		if (nc_inq_varndims(fileID, *it, &numDims) != NC_NOERR || numDims != 2 ||
+		    nc_inq_vardimid(fileID, *it, dimIDs) != NC_NOERR || dimIDs[0] != timeDimID || dimIDs[1] != nodeDimID)
+			return false;
+	}
+
+	numTimesteps = timeLength;
+	numNodes = nodeLength;
+	timestepTimes.resize(numTimesteps);
+	if (numTimesteps > 0 && nc_get_var_double(fileID, timeVarID, &timestepTimes[0]) != NC_NOERR)
+		return false;
+
+	int storage;
+	size_t chunks[2];
+	if (nc_inq_var_chunking(fileID, variableIDs[0], &storage, chunks) == NC_NOERR && storage == NC_CHUNKED)
+	{
+		timeChunk = chunks[0] > 0 ? chunks[0] : 1;
+		nodeChunk = chunks[1] > 0 ? chunks[1] : NETCDF_NODE_BLOCK;
+		chunked = true;
+	} else {
+		timeChunk = 1;
+		nodeChunk = NETCDF_NODE_BLOCK;
+		chunked = false;
+	}
+
+	return numNodes > 0;
+#else
+	return false;
+#endif
+}
+
+
+/**
+ * @brief Reads a (time, node) hyperslab of every output variable
+ * @param firstTimestep The first timestep (starting from 0)
+ * @param timestepCount The number of timesteps
+ * @param firstNode The first node (starting from 0)
+ * @param nodeCount The number of nodes
+ * @param block The values of each variable in turn, each stored timestep by timestep
+ * @return true if the hyperslab was read
+ */
+bool Fort63NetCDF::ReadBlock(size_t firstTimestep, size_t timestepCount, size_t firstNode, size_t nodeCount, std::vector<float> &block)
+{
+#ifdef ADCIRC_NETCDF
+	size_t variableSize = timestepCount*nodeCount;
+	block.resize(variableSize*variableIDs.size());
+
+	size_t start[2] = {firstTimestep, firstNode};
+	size_t count[2] = {timestepCount, nodeCount};
+	QMutexLocker locker (&libraryMutex);
+	for (unsigned int v=0; v<variableIDs.size(); ++v)
+	{
+		if (nc_get_vara_float(fileID, variableIDs[v], start, count, &block[v*variableSize]) != NC_NOERR)
+		{
+			std::cout << "WARNING: Unable to read " << filePath.toStdString().data() << std::endl;
+			return false;
+		}
+	}
+	return true;
+#else
+	return false;
+#endif
+}
@@ -0,0 +1,115 @@
+#ifndef FORT63NETCDF_H
+#define FORT63NETCDF_H
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+
+#include <QString>
+#include <QMutex>
+#include <QMutexLocker>
+
+#ifdef ADCIRC_NETCDF
+#include <netcdf.h>
+#endif
+
+#define NETCDF_BLOCK_MEMORY	67108864
+#define NETCDF_NODE_BLOCK	4096
+
+
+/**
+ * @brief Reads timesteps and node histories from an ADCIRC netCDF output file
+ * (fort.63.nc or fort.64.nc)
+ *
+ * ADCIRC's netCDF output stores each output variable as a (time, node) array:
+ * zeta for fort.63, and u-vel and v-vel for fort.64. Dry nodes hold the -99999
+ * fill value. Only the dimensions and the time variable are read when the file is
+ * opened. Everything else is read in hyperslabs, so the file is never loaded whole.
+ *
+ * Reads are aligned to the variable's chunks. A timestep read pulls every timestep
+ * in the same row of chunks, and a node history read pulls every node in the same
+ * column of chunks, as long as the block fits in NETCDF_BLOCK_MEMORY. The block is
+ * kept, so playback and neighboring node histories are served from memory until the
+ * read moves into the next row or column of chunks. Files without chunking (netCDF3)
+ * use NETCDF_NODE_BLOCK nodes and single timesteps.
+ *
+ * A node history read is only cheap if the variable is chunked by node. ADCIRC
+ * often chunks by whole timesteps, and netCDF3 files are stored timestep by
+ * timestep, so reading one node reads the whole file. NodeReadsAreCheap() tells
+ * which, so that Fort63Cache can be used for node histories instead.
+ *
+ * The netCDF library is not thread safe, so every call into it, from any
+ * Fort63NetCDF object, is made while holding a single process-wide mutex.
+ *
+ * This offers the same timestep API as Fort63, and Fort63 hands netCDF files to
+ * this class, so everything that reads fort.63 also reads fort.63.nc.
+ *
+ * Support is compiled in when ADCIRC_NETCDF is defined (see Core/Core.pro).
+ * Without it, Open() always fails.
+ *
+ * Timesteps are numbered from 1.
+ *
+ */
+class Fort63NetCDF
+{
+	public:
+		Fort63NetCDF();
+		Fort63NetCDF(QString newLoc);
+		~Fort63NetCDF();
+
+		static bool	IsNetCDF(QString fileLoc);
+
+		void	SetFilePath(QString newLoc);
+		bool	Open();
+		bool	IsOpen();
+		bool	NodeReadsAreCheap();
+
+		bool	ReadTimestep(unsigned int ts, std::vector<float> &values);
+		bool	ReadNodeHistory(unsigned int node, std::vector<float> &values);
+
+		/* Getter Methods */
+		QString		GetFilePath();
+		unsigned int	GetNumNodes();
+		unsigned int	GetNumTimesteps();
+		unsigned int	GetValuesPerNode();
+		double		GetTimestepTime(unsigned int ts);
+
+	private:
+
+		QString		filePath;
+		int		fileID;
+		bool		fileOpen;
+
+		/* Layout */
+		std::vector<int>	variableIDs;	/**< One variable for each value per node */
+		unsigned int		numNodes;
+		unsigned int		numTimesteps;
+		std::vector<double>	timestepTimes;
+		size_t			timeChunk;	/**< Timesteps in each chunk */
+		size_t			nodeChunk;	/**< Nodes in each chunk */
+		bool			chunked;	/**< false for netCDF3 and contiguous netCDF4 variables */
+
+		/* The most recently read row of chunks, for timestep reads */
+		std::vector<float>	timeBlock;	/**< Every value of each timestep in the block, variable by variable */
+		unsigned int		timeBlockFirst;	/**< First timestep in the block (starting from 1), or 0 if empty */
+		unsigned int		timeBlockCount;
+
+		/* The most recently read column of chunks, for node history reads */
+		std::vector<float>	nodeBlock;	/**< Every timestep of each node in the block, variable by variable */
+		unsigned int		nodeBlockFirst;	/**< First node in the block (starting from 1), or 0 if empty */
+		unsigned int		nodeBlockCount;
+
+		static QMutex	libraryMutex;	/**< Held during every call into the netCDF library */
+
+		void	Close();
+		bool	ReadLayout();
+		bool	ReadBlock(size_t firstTimestep, size_t timestepCount, size_t firstNode, size_t nodeCount, std::vector<float> &block);
+
+		/* The open file is closed by the destructor, so it can't be copied */
+		Fort63NetCDF(const Fort63NetCDF&);
+		Fort63NetCDF&	operator=(const Fort63NetCDF&);
+};
+
+#endif // FORT63NETCDF_H
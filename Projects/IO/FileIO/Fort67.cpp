@@ -0,0 +1,396 @@
+#include "Fort67.h"
+
+Fort67::Fort67(QObject *parent) :
+	QObject(parent)
+{
+	filePath = "";
+	recordSize = HOTSTART_RECORD_SIZE;
+	forceCarve = false;
+	fileSize = 0;
+	numNodes = 0;
+	numElements = 0;
+	imhs = 0;
+	iths = 0;
+}
+
+
+Fort67::Fort67(QString newLoc, QObject *parent) :
+	QObject(parent)
+{
+	filePath = newLoc;
+	recordSize = HOTSTART_RECORD_SIZE;
+	forceCarve = false;
+	fileSize = 0;
+	numNodes = 0;
+	numElements = 0;
+	imhs = 0;
+	iths = 0;
+}
+
+
+Fort67::~Fort67()
+{
+	CloseFiles(false);
+	if (readFile.is_open())
+		readFile.close();
+}
+
+
+void Fort67::SetFilePath(QString newLoc)
+{
+	filePath = newLoc;
+}
+
+
+void Fort67::SetSubdomains(std::vector<SubdomainFiles> newDomains)
+{
+	subdomains = newDomains;
+}
+
+
+/**
+ * @brief Sets the size of each record in the hotstart file
+ *
+ * Sets the size of each record in the hotstart file. This is the NBYTE value
+ * ADCIRC was compiled with, which is 8 on nearly every machine.
+ *
+ * @param newSize The record size in bytes
+ */
+void Fort67::SetRecordSize(unsigned int newSize)
+{
+	if (newSize >= sizeof(double))
+		recordSize = newSize;
+}
+
+
+/**
+ * @brief Sets whether subdomains with an up to date hotstart file are carved again
+ * @param force true to carve every subdomain
+ */
+void Fort67::SetForceCarve(bool force)
+{
+	forceCarve = force;
+}
+
+
+/**
+ * @brief Carves the full domain hotstart file into a hotstart file for each subdomain
+ *
+ * Carves the full domain hotstart file into a hotstart file for each subdomain
+ * in a single pass over the full domain file.
+ *
+ * @return true if every subdomain hotstart file was written
+ */
+bool Fort67::CarveAllSubdomains()
+{
+	emit startedCarving();
+
+	readFile.open(filePath.toStdString().data(), std::ios::in | std::ios::binary);
+	if (!readFile.is_open())
+	{
+		std::cout << "WARNING: Unable to open " << filePath.toStdString().data() << std::endl;
+		emit finishedCarving();
+		return false;
+	}
+	fileSize = QFileInfo(filePath).size();
+
+	if (!ReadHeader() || !CheckFileSize())
+	{
+		readFile.close();
+		emit finishedCarving();
+		return false;
+	}
+
+	bool succeeded = true;
+	for (std::vector<SubdomainFiles>::iterator it = subdomains.begin(); it != subdomains.end(); ++it)
+	{
+		SubdomainFiles *currDomain = &(*it);
+		if (forceCarve || !SubdomainUpToDate(currDomain))
+			succeeded = CreateSubdomainFile(currDomain) && succeeded;
+	}
+
+	if (outputs.size() > 0)
+	{
+		for (std::vector<Fort67Subdomain*>::iterator it = outputs.begin(); it != outputs.end(); ++it)
+			WriteHeader(*it);
+
+		/* The nodal arrays, then NOFF, then the output counters */
+		bool carved = true;
+		bool cancelled = false;
+		for (unsigned int i=0; i<NumNodalArrays() && carved && !cancelled; ++i)
+		{
+			carved = CarveArray(true);
+			cancelled = TaskScheduler::Instance()->CurrentTaskCancelled();
+		}
+		carved = carved && !cancelled && CarveArray(false) && CopyTail();
+
+		if (cancelled)
+			std::cout << "Cancelled carving " << filePath.toStdString().data() << std::endl;
+		else if (!carved)
+			std::cout << "WARNING: Unexpected end of " << filePath.toStdString().data() << std::endl;
+		else
+			emit emitMessage(QString("Carved hotstart file at timestep ").append(QString::number(iths)).append(" for ").append(QString::number(outputs.size())).append(" subdomains"));
+
+		CloseFiles(carved);
+		succeeded = carved && succeeded;
+	}
+
+	readFile.close();
+	emit progress(100);
+	emit finishedCarving();
+	return succeeded;
+}
+
+
+void Fort67::carveAllSubdomains()
+{
+	CarveAllSubdomains();
+}
+
+
+/**
+ * @brief Finds the most recently written hotstart file in a domain directory
+ * @param domainPath The domain directory
+ * @return The newer of fort.67 and fort.68, or an empty string if neither exists
+ */
+QString Fort67::FindLatestHotstart(QString domainPath)
+{
+	QFileInfo fort67 (domainPath + QDir::separator() + "fort.67");
+	QFileInfo fort68 (domainPath + QDir::separator() + "fort.68");
+
+	if (fort67.exists() && fort68.exists())
+		return fort68.lastModified() > fort67.lastModified() ? fort68.absoluteFilePath() : fort67.absoluteFilePath();
+	if (fort67.exists())
+		return fort67.absoluteFilePath();
+	if (fort68.exists())
+		return fort68.absoluteFilePath();
+	return QString();
+}
+
+
+bool Fort67::ReadHeader()
+{
+	headerRecords.resize(HOTSTART_HEADER_RECORDS*recordSize);
+	readFile.read(&headerRecords[0], headerRecords.size());
+	if ((size_t)readFile.gcount() != headerRecords.size())
+	{
+		std::cout << "WARNING: Unable to read the header of " << filePath.toStdString().data() << std::endl;
+		return false;
+	}
+
+	imhs = GetRecordInt(1);
+	iths = GetRecordInt(3);
+	numNodes = GetRecordInt(4);
+	numElements = GetRecordInt(5);
+	return numNodes > 0 && numElements > 0;
+}
+
+
+/**
+ * @brief Checks that the hotstart file has exactly the records of a 2D hotstart file
+ * @return true if the file can be carved
+ */
+bool Fort67::CheckFileSize()
+{
+	qint64 numRecords = HOTSTART_HEADER_RECORDS + (qint64)NumNodalArrays()*numNodes + numElements + HOTSTART_TAIL_RECORDS;
+	if (numRecords*recordSize != fileSize)
+	{
+		std::cout << "WARNING: " << filePath.toStdString().data() << " is not a 2D hotstart file with " <<
+			     numNodes << " nodes and " << numElements << " elements" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+
+/**
+ * @brief Returns the number of nodal arrays in the hotstart file
+ * @return 7 if the file includes CH1 (IMHS = 10), 6 otherwise
+ */
+unsigned int Fort67::NumNodalArrays()
+{
+	return imhs == 10 ? 7 : 6;
+}
+
+
+/**
+ * @brief Opens the hotstart file of a subdomain and reads its mappings
+ * @param currDomain The subdomain
+ * @return true if the subdomain is ready to be carved
+ */
+/**
+ * @brief Checks if a subdomain hotstart file is newer than everything it is carved from
+ * @param currDomain The subdomain
+ * @return true if the subdomain hotstart file does not need to be carved again
+ */
+bool Fort67::SubdomainUpToDate(SubdomainFiles *currDomain)
+{
+	QFileInfo subHotstart (currDomain->domainPath + QDir::separator() + QFileInfo(filePath).fileName());
+	QFileInfo fullHotstart (filePath);
+	QFileInfo py140 (currDomain->py140Location);
+	QFileInfo py141 (currDomain->py141Location.isEmpty() ?
+				 py140.absolutePath() + QDir::separator() + "py.141" :
+				 currDomain->py141Location);
+
+	return subHotstart.exists() && py140.exists() && py141.exists() &&
+			subHotstart.lastModified() >= fullHotstart.lastModified() &&
+			subHotstart.lastModified() >= py140.lastModified() &&
+			subHotstart.lastModified() >= py141.lastModified();
+}
+
+
+bool Fort67::CreateSubdomainFile(SubdomainFiles *currDomain)
+{
+	QString py141Location = currDomain->py141Location;
+	if (py141Location.isEmpty() && !currDomain->py140Location.isEmpty())
+		py141Location = QFileInfo(currDomain->py140Location).absolutePath() + QDir::separator() + "py.141";
+
+	if (currDomain->py140Location.isEmpty() || !QFile(py141Location).exists())
+	{
+		std::cout << "WARNING: No py.140 or py.141 file for subdomain at " << currDomain->domainPath.toStdString().data() << std::endl;
+		return false;
+	}
+
+	Fort67Subdomain *currOutput = new Fort67Subdomain;
+	currOutput->domain = currDomain;
+	currOutput->filePath = currDomain->domainPath + QDir::separator() + QFileInfo(filePath).fileName();
+	currOutput->tempPath = currOutput->filePath + ".tmp";
+	currOutput->newToOldNodes = Py140(currDomain->py140Location).GetNewToOldList();
+	currOutput->newToOldElements = Py141(py141Location).GetNewToOldList();
+
+	/* Every subdomain node and element must exist in the full domain */
+	bool mappingsValid = currOutput->newToOldNodes.size() > 0 && currOutput->newToOldElements.size() > 0;
+	for (std::vector<unsigned int>::iterator it = currOutput->newToOldNodes.begin(); it != currOutput->newToOldNodes.end() && mappingsValid; ++it)
+		mappingsValid = *it > 0 && *it <= (unsigned int)numNodes;
+	for (std::vector<unsigned int>::iterator it = currOutput->newToOldElements.begin(); it != currOutput->newToOldElements.end() && mappingsValid; ++it)
+		mappingsValid = *it > 0 && *it <= (unsigned int)numElements;
+
+	if (mappingsValid)
+		currOutput->file.open(currOutput->tempPath.toStdString().data(), std::ios::out | std::ios::binary | std::ios::trunc);
+
+	if (!mappingsValid || !currOutput->file.is_open())
+	{
+		std::cout << "WARNING: Unable to create " << currOutput->filePath.toStdString().data() << std::endl;
+		delete currOutput;
+		return false;
+	}
+
+	outputs.push_back(currOutput);
+	return true;
+}
+
+
+/**
+ * @brief Writes the header of a subdomain hotstart file using the subdomain's counts
+ * @param currOutput The subdomain file
+ */
+void Fort67::WriteHeader(Fort67Subdomain *currOutput)
+{
+	std::vector<char> subdomainHeader = headerRecords;
+	SetRecordInt(subdomainHeader, 4, currOutput->newToOldNodes.size());
+	SetRecordInt(subdomainHeader, 5, currOutput->newToOldElements.size());
+	SetRecordInt(subdomainHeader, 6, currOutput->newToOldNodes.size());
+	SetRecordInt(subdomainHeader, 7, currOutput->newToOldElements.size());
+	currOutput->file.write(&subdomainHeader[0], subdomainHeader.size());
+}
+
+
+/**
+ * @brief Carves the next nodal or elemental array
+ *
+ * Reads the next array of the full domain file and gathers the records of each
+ * subdomain's nodes or elements, in subdomain order, into its hotstart file.
+ *
+ * @param nodal true for a nodal array, false for an elemental array
+ * @return true if the entire array was read
+ */
+bool Fort67::CarveArray(bool nodal)
+{
+	size_t count = nodal ? numNodes : numElements;
+	arrayBuffer.resize(count*recordSize);
+	readFile.read(&arrayBuffer[0], arrayBuffer.size());
+	if ((size_t)readFile.gcount() != arrayBuffer.size())
+		return false;
+
+	for (std::vector<Fort67Subdomain*>::iterator it = outputs.begin(); it != outputs.end(); ++it)
+	{
+		Fort67Subdomain *currOutput = *it;
+		std::vector<unsigned int> &newToOld = nodal ? currOutput->newToOldNodes : currOutput->newToOldElements;
+
+		gatherBuffer.resize(newToOld.size()*recordSize);
+		for (size_t i=0; i<newToOld.size(); ++i)
+			memcpy(&gatherBuffer[i*recordSize], &arrayBuffer[(newToOld[i]-1)*recordSize], recordSize);
+		currOutput->file.write(&gatherBuffer[0], gatherBuffer.size());
+	}
+
+	if (fileSize > 0)
+		emit progress((int)(100.0*readFile.tellg()/fileSize));
+
+	return true;
+}
+
+
+bool Fort67::CopyTail()
+{
+	arrayBuffer.resize(HOTSTART_TAIL_RECORDS*recordSize);
+	readFile.read(&arrayBuffer[0], arrayBuffer.size());
+	if ((size_t)readFile.gcount() != arrayBuffer.size())
+		return false;
+
+	for (std::vector<Fort67Subdomain*>::iterator it = outputs.begin(); it != outputs.end(); ++it)
+		(*it)->file.write(&arrayBuffer[0], arrayBuffer.size());
+	return true;
+}
+
+
+/**
+ * @brief Closes every subdomain hotstart file
+ *
+ * Closes every subdomain hotstart file. Completed files replace the existing
+ * subdomain hotstart files, and incomplete files are removed.
+ *
+ * @param succeeded true if the carve completed
+ */
+void Fort67::CloseFiles(bool succeeded)
+{
+	for (std::vector<Fort67Subdomain*>::iterator it = outputs.begin(); it != outputs.end(); ++it)
+	{
+		Fort67Subdomain *currOutput = *it;
+		currOutput->file.close();
+		if (succeeded && !currOutput->file.fail())
+		{
+			QFile::remove(currOutput->filePath);
+			QFile::rename(currOutput->tempPath, currOutput->filePath);
+		} else {
+			QFile::remove(currOutput->tempPath);
+		}
+		delete currOutput;
+	}
+	outputs.clear();
+}
+
+
+/**
+ * @brief Reads an integer from the start of a header record
+ * @param record The record number (starting from 0)
+ * @return The integer value
+ */
+int Fort67::GetRecordInt(unsigned int record)
+{
+	int value = 0;
+	memcpy(&value, &headerRecords[record*recordSize], sizeof(int));
+	return value;
+}
+
+
+/**
+ * @brief Replaces a header record with an integer value
+ * @param records The header records
+ * @param record The record number (starting from 0)
+ * @param value The integer value
+ */
+void Fort67::SetRecordInt(std::vector<char> &records, unsigned int record, int value)
+{
+	memset(&records[record*recordSize], 0, recordSize);
+	memcpy(&records[record*recordSize], &value, sizeof(int));
+}
@@ -0,0 +1,135 @@
+#ifndef FORT67_H
+#define FORT67_H
+
+#include <vector>
+#include <fstream>
+#include <iostream>
+#include <cstring>
+
+#include <QObject>
+#include <QString>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+
+#include "Projects/IO/FileIO/SubdomainFiles.h"
+#include "Projects/IO/FileIO/Py140.h"
+#include "Projects/IO/FileIO/Py141.h"
+#include "Tasks/TaskScheduler.h"
+
+#define HOTSTART_RECORD_SIZE	8
+#define HOTSTART_HEADER_RECORDS	8
+#define HOTSTART_TAIL_RECORDS	18
+
+
+/**
+ * @brief A subdomain hotstart file that is being written by Fort67
+ */
+struct Fort67Subdomain
+{
+	SubdomainFiles*			domain;
+	QString				filePath;	/**< The finished hotstart file */
+	QString				tempPath;	/**< The file being written */
+	std::ofstream			file;
+	std::vector<unsigned int>	newToOldNodes;	/**< Dense subdomain to full domain node mapping */
+	std::vector<unsigned int>	newToOldElements;	/**< Dense subdomain to full domain element mapping */
+};
+
+
+/**
+ * @brief Carves the full domain hotstart file (fort.67 or fort.68) into a hotstart
+ * file for each subdomain
+ *
+ * ADCIRC writes its non-NetCDF hotstart files as direct access binary files with
+ * one value per fixed size record: a header (file version, IMHS, time, timestep,
+ * and the node and element counts), the nodal arrays (ETA1, ETA2, EtaDisc, UU2,
+ * VV2, CH1 when IMHS is 10, and NNODECODE), the elemental array NOFF, and finally
+ * the output file counters.
+ *
+ * The full domain file is read once, one array at a time, and each array is
+ * gathered into every subdomain file through the dense py.140 and py.141 mappings.
+ * Records are copied byte for byte, so values are never converted. Only the node
+ * and element counts in the header are changed. The output counters are copied as
+ * is.
+ *
+ * Only 2D hotstart files are supported. A file that does not have exactly the
+ * expected number of records is not carved. A subdomain whose hotstart file is
+ * newer than the full domain hotstart file and its py.140 and py.141 files is
+ * skipped, unless carving is forced.
+ *
+ * Not to be confused with fort.067, which is written by subdomain runs.
+ *
+ * A running job rewrites fort.67 and fort.68 in place, so Project only starts
+ * carveAllSubdomains() on the TaskScheduler once the full domain run has finished.
+ *
+ */
+class Fort67 : public QObject
+{
+		Q_OBJECT
+	public:
+		Fort67(QObject *parent=0);
+		Fort67(QString newLoc, QObject *parent=0);
+		~Fort67();
+
+		void	SetFilePath(QString newLoc);
+		void	SetSubdomains(std::vector<SubdomainFiles> newDomains);
+		void	SetRecordSize(unsigned int newSize);
+		void	SetForceCarve(bool force);
+
+		bool	CarveAllSubdomains();
+
+		static QString	FindLatestHotstart(QString domainPath);
+
+	private:
+
+		QString		filePath;
+		unsigned int	recordSize;
+		bool		forceCarve;
+
+		std::ifstream	readFile;
+		qint64		fileSize;
+
+		/* Header values */
+		int	numNodes;
+		int	numElements;
+		int	imhs;
+		int	iths;
+
+		std::vector<char>	headerRecords;
+		std::vector<char>	arrayBuffer;
+		std::vector<char>	gatherBuffer;
+
+		std::vector<SubdomainFiles>	subdomains;
+		std::vector<Fort67Subdomain*>	outputs;
+
+		/* Reading the full domain file */
+		bool	ReadHeader();
+		bool	CheckFileSize();
+		unsigned int	NumNodalArrays();
+
+		/* Writing the subdomain files */
+		bool	SubdomainUpToDate(SubdomainFiles *currDomain);
+		bool	CreateSubdomainFile(SubdomainFiles *currDomain);
+		void	WriteHeader(Fort67Subdomain *currOutput);
+		bool	CarveArray(bool nodal);
+		bool	CopyTail();
+		void	CloseFiles(bool succeeded);
+
+		int	GetRecordInt(unsigned int record);
+		void	SetRecordInt(std::vector<char> &records, unsigned int record, int value);
+
+	public slots:
+
+		void	carveAllSubdomains();
+
+	signals:
+
+		void	startedCarving();
+		void	progress(int);
+		void	finishedCarving();
+		void	emitMessage(QString);
+
+};
+
+#endif // FORT67_H
@@ -122,6 +122,54 @@ std::map<unsigned int, unsigned int> Py140::GetNewToOld()
 }
 
 
+/**
+ * @brief Returns the new to old mapping as a dense list
+ *
+ * Returns the new to old mapping as a dense list, where entry i holds the old
+ * number of new node i+1, or 0 if new node i+1 is not in the mapping.
+ *
+ * @return The dense new to old mapping
+ */
+std::vector<unsigned int> Py140::GetNewToOldList()
+{
+	std::vector<unsigned int> newToOldList;
+	if (newToOldNodes.size() > 0)
+	{
+		newToOldList.resize(newToOldNodes.rbegin()->first, 0);
+		for (std::map<unsigned int, unsigned int>::iterator it = newToOldNodes.begin(); it != newToOldNodes.end(); ++it)
+		{
+			if (it->first > 0)
+				newToOldList[it->first-1] = it->second;
+		}
+	}
+	return newToOldList;
+}
+
+
+/**
+ * @brief Returns the old to new mapping as a dense list
+ *
+ * Returns the old to new mapping as a dense list, where entry i holds the new
+ * number of old node i, or 0 if old node i is not in the subdomain. Entry 0 is
+ * unused. The list is sized to hold every full domain node if the number of full
+ * domain nodes is known, so it can be indexed with any full domain node number.
+ *
+ * @return The dense old to new mapping
+ */
+std::vector<unsigned int> Py140::GetOldToNewList()
+{
+	std::vector<unsigned int> oldToNewList;
+	unsigned int listSize = numFullNodes > 0 ? numFullNodes+1 : 0;
+	if (oldToNewNodes.size() > 0 && oldToNewNodes.rbegin()->first >= listSize)
+		listSize = oldToNewNodes.rbegin()->first+1;
+
+	oldToNewList.resize(listSize, 0);
+	for (std::map<unsigned int, unsigned int>::iterator it = oldToNewNodes.begin(); it != oldToNewNodes.end(); ++it)
+		oldToNewList[it->first] = it->second;
+	return oldToNewList;
+}
+
+
 std::vector<unsigned int> Py140::ConvertNewToOld(std::vector<unsigned int> newList)
 {
 	std::vector<unsigned int> oldList;
@@ -100,6 +100,30 @@ std::map<unsigned int, unsigned int> Py141::GetNewToOld()
 }
 
 
+/**
+ * @brief Returns the new to old mapping as a dense list
+ *
+ * Returns the new to old mapping as a dense list, where entry i holds the old
+ * number of new element i+1, or 0 if new element i+1 is not in the mapping.
+ *
+ * @return The dense new to old mapping
+ */
+std::vector<unsigned int> Py141::GetNewToOldList()
+{
+	std::vector<unsigned int> newToOldList;
+	if (newToOldElements.size() > 0)
+	{
+		newToOldList.resize(newToOldElements.rbegin()->first, 0);
+		for (std::map<unsigned int, unsigned int>::iterator it = newToOldElements.begin(); it != newToOldElements.end(); ++it)
+		{
+			if (it->first > 0)
+				newToOldList[it->first-1] = it->second;
+		}
+	}
+	return newToOldList;
+}
+
+
 std::vector<unsigned int> Py141::ConvertNewToOld(std::vector<unsigned int> newList)
 {
 	std::vector<unsigned int> oldList;
@@ -27,6 +27,7 @@ class Py141
 
 		std::map<unsigned int, unsigned int>	GetOldToNew();
 		std::map<unsigned int, unsigned int>	GetNewToOld();
+		std::vector<unsigned int>		GetNewToOldList();
 		std::vector<unsigned int>		ConvertNewToOld(std::vector<unsigned int> newList);
 		std::vector<unsigned int>		ConvertOldToNew(std::vector<unsigned int> oldList);
 		std::set<unsigned int>			ConvertNewToOld(std::set<unsigned int> newSet);
@@ -0,0 +1,27 @@
+#ifndef SUBDOMAINFILES_H
+#define SUBDOMAINFILES_H
+
+#include <QString>
+
+
+/**
+ * @brief The locations of the files of a subdomain
+ *
+ * The locations of the files of a subdomain. The carvers (Fort13, Fort066 and Fort67)
+ * and Fort015 only need to know where a subdomain is and how it maps onto the full
+ * domain, so they are given a list of these instead of the Domains themselves, which
+ * lets them be used without a display. See Domain::GetSubdomainFiles().
+ *
+ */
+struct SubdomainFiles
+{
+		QString	domainPath;	/**< The subdomain directory */
+		QString	fort14Location;	/**< The subdomain mesh */
+		QString	py140Location;	/**< The subdomain to full domain node mapping */
+		QString	py141Location;	/**< The subdomain to full domain element mapping, if known */
+		SubdomainFiles() {}
+		SubdomainFiles(QString path, QString fort14, QString py140, QString py141) :
+			domainPath(path), fort14Location(fort14), py140Location(py140), py141Location(py141) {}
+};
+
+#endif // SUBDOMAINFILES_H
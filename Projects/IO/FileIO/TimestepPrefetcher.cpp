@@ -0,0 +1,240 @@
+#include "TimestepPrefetcher.h"
+
+TimestepPrefetcher::TimestepPrefetcher(QString filePath, unsigned int newCapacity, QObject *parent) :
+	QObject(parent),
+	file(filePath),
+	cache(filePath)
+{
+	useCache = false;
+	capacity = newCapacity > 0 ? newCapacity : 1;
+	numTimesteps = 0;
+	position = 1;
+	stopRequested = false;
+
+	ring.resize(capacity);
+	for (unsigned int i=0; i<capacity; ++i)
+		ring[i].timestep = 0;
+}
+
+
+unsigned int TimestepPrefetcher::GetNumNodes()
+{
+	return useCache ? cache.GetNumNodes() : file.GetNumNodes();
+}
+
+
+unsigned int TimestepPrefetcher::GetNumTimesteps()
+{
+	return numTimesteps;
+}
+
+
+unsigned int TimestepPrefetcher::GetValuesPerNode()
+{
+	return useCache ? cache.GetValuesPerNode() : file.GetValuesPerNode();
+}
+
+
+double TimestepPrefetcher::GetTimestepTime(unsigned int ts)
+{
+	return useCache ? cache.GetTimestepTime(ts) : file.GetTimestepTime(ts);
+}
+
+
+/**
+ * @brief Moves the prefetch window to start at a new timestep
+ *
+ * Moves the prefetch window to start at a new timestep. Timesteps already in
+ * the ring that are still inside the window are kept.
+ *
+ * @param ts The next timestep that will be shown (starting from 1)
+ */
+void TimestepPrefetcher::SetPosition(unsigned int ts)
+{
+	ringMutex.lock();
+	position = ts > 0 ? ts : 1;
+	wakeCondition.wakeAll();
+	ringMutex.unlock();
+}
+
+
+/**
+ * @brief Takes a timestep out of the ring if it has been read
+ *
+ * Takes a timestep out of the ring if it has been read, and moves the prefetch
+ * window to start at the following timestep. The caller's buffer is swapped into
+ * the ring and reused for a later timestep. Never waits for a read.
+ *
+ * @param ts The timestep (starting from 1)
+ * @param values The timestep's values. Empty if the timestep could not be read.
+ * @return true if the timestep was in the ring
+ */
+bool TimestepPrefetcher::TakeTimestep(unsigned int ts, std::vector<float> &values)
+{
+	bool found = false;
+
+	ringMutex.lock();
+	PrefetchSlot *slot = FindSlot(ts);
+	if (ts > 0 && slot)
+	{
+		values.swap(slot->values);
+		slot->timestep = 0;
+		position = ts < numTimesteps ? ts+1 : 1;
+		wakeCondition.wakeAll();
+		found = true;
+	}
+	ringMutex.unlock();
+
+	return found;
+}
+
+
+/**
+ * @brief Asks the worker to stop once its current read is done
+ *
+ * Asks the worker to stop once its current read is done. This is safe to call
+ * from a different thread than the one performing the reads.
+ *
+ */
+void TimestepPrefetcher::Stop()
+{
+	ringMutex.lock();
+	stopRequested = true;
+	wakeCondition.wakeAll();
+	ringMutex.unlock();
+}
+
+
+/**
+ * @brief Opens the cache or builds the timestep index and keeps the ring filled until stopped
+ */
+void TimestepPrefetcher::prefetch()
+{
+	useCache = cache.CacheIsCurrent() && cache.Open();
+	if (!useCache && !file.BuildIndex())
+	{
+		emit indexBuilt(0);
+		emit finishedPrefetching();
+		return;
+	}
+
+	ringMutex.lock();
+	numTimesteps = useCache ? cache.GetNumTimesteps() : file.GetNumTimesteps();
+	ringMutex.unlock();
+	emit indexBuilt(numTimesteps);
+
+	std::vector<float> values;
+	ringMutex.lock();
+	while (!stopRequested)
+	{
+		unsigned int ts = NextTimestepToRead();
+		if (ts == 0)
+		{
+			wakeCondition.wait(&ringMutex);
+			continue;
+		}
+
+		/* Read without holding the lock so that playback is never blocked */
+		ringMutex.unlock();
+		if (!ReadTimestep(ts, values))
+			values.clear();
+		ringMutex.lock();
+
+		PrefetchSlot *slot = FreeSlot();
+		if (InWindow(ts) && slot)
+		{
+			slot->values.swap(values);
+			slot->timestep = ts;
+			emit timestepReady(ts);
+		}
+	}
+	ringMutex.unlock();
+
+	emit finishedPrefetching();
+}
+
+
+/**
+ * @brief Reads a timestep from the cache if it is being used, or from the file
+ * @param ts The timestep (starting from 1)
+ * @param values The timestep's values
+ * @return true if the timestep was read
+ */
+bool TimestepPrefetcher::ReadTimestep(unsigned int ts, std::vector<float> &values)
+{
+	if (useCache)
+		return cache.ReadTimestep(ts, values);
+	return file.ReadTimestep(ts, values);
+}
+
+
+/**
+ * @brief Finds the first timestep in the window that is not in the ring
+ *
+ * Finds the first timestep in the window that is not in the ring. Must be called
+ * with the ring locked.
+ *
+ * @return The timestep, or 0 if the window is full
+ */
+unsigned int TimestepPrefetcher::NextTimestepToRead()
+{
+	if (numTimesteps == 0)
+		return 0;
+
+	unsigned int windowSize = capacity < numTimesteps ? capacity : numTimesteps;
+	for (unsigned int i=0; i<windowSize; ++i)
+	{
+		unsigned int ts = (position - 1 + i) % numTimesteps + 1;
+		if (!FindSlot(ts))
+			return ts;
+	}
+	return 0;
+}
+
+
+/**
+ * @brief Checks if a timestep is in the prefetch window. Must be called with the ring locked.
+ * @param ts The timestep
+ * @return true if the timestep is in the window
+ */
+bool TimestepPrefetcher::InWindow(unsigned int ts)
+{
+	if (numTimesteps == 0 || ts < 1 || ts > numTimesteps)
+		return false;
+
+	unsigned int windowSize = capacity < numTimesteps ? capacity : numTimesteps;
+	unsigned int offset = (ts + numTimesteps - position) % numTimesteps;
+	return offset < windowSize;
+}
+
+
+/**
+ * @brief Finds the slot holding a timestep. Must be called with the ring locked.
+ * @param ts The timestep
+ * @return The slot, or 0 if the timestep is not in the ring
+ */
+PrefetchSlot* TimestepPrefetcher::FindSlot(unsigned int ts)
+{
+	for (std::vector<PrefetchSlot>::iterator it = ring.begin(); it != ring.end(); ++it)
+		if (it->timestep == ts)
+			return &(*it);
+	return 0;
+}
+
+
+/**
+ * @brief Finds a slot that can be filled. Must be called with the ring locked.
+ *
+ * Finds a slot that can be filled, meaning it is empty or holds a timestep that
+ * has left the window. The window is never larger than the ring, so there is always
+ * a free slot while a timestep in the window is missing.
+ *
+ * @return The slot, or 0 if every slot holds a timestep in the window
+ */
+PrefetchSlot* TimestepPrefetcher::FreeSlot()
+{
+	for (std::vector<PrefetchSlot>::iterator it = ring.begin(); it != ring.end(); ++it)
+		if (it->timestep == 0 || !InWindow(it->timestep))
+			return &(*it);
+	return 0;
+}
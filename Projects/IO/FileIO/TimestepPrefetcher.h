@@ -0,0 +1,95 @@
+#ifndef TIMESTEPPREFETCHER_H
+#define TIMESTEPPREFETCHER_H
+
+#include <vector>
+
+#include <QObject>
+#include <QString>
+#include <QMutex>
+#include <QWaitCondition>
+
+#include "Projects/IO/FileIO/Fort63.h"
+#include "Projects/IO/FileIO/Fort63Cache.h"
+
+#define PREFETCH_CAPACITY	8
+
+
+/**
+ * @brief A single timestep held by a TimestepPrefetcher
+ */
+struct PrefetchSlot
+{
+	unsigned int		timestep;	/**< The timestep in the slot, or 0 if the slot is empty */
+	std::vector<float>	values;
+};
+
+
+/**
+ * @brief Reads upcoming timesteps of a fort.63 or fort.64 file on a worker thread
+ *
+ * Reads upcoming timesteps of a fort.63 or fort.64 file on a worker thread so
+ * that playback never waits on the disk. The timesteps are kept in a fixed ring of
+ * slots. The worker keeps the ring filled with the timesteps starting at the playback
+ * position, wrapping around to the first timestep so that looping playback does not
+ * stall, and refills each slot as soon as playback moves past its timestep.
+ *
+ * TakeTimestep() never blocks on a read. The value buffers are swapped between the
+ * caller and the ring, so no memory is allocated once playback is running.
+ *
+ * If the binary cache of the file is current (see Fort63Cache), timesteps are read
+ * from its time-major chunks, which is a single seek and read per timestep.
+ * Otherwise the file itself is indexed and parsed.
+ *
+ * Like a Layer, the object is moved to a worker QThread. The prefetch() slot opens
+ * the cache or builds the timestep index and then runs until Stop() is called.
+ *
+ */
+class TimestepPrefetcher : public QObject
+{
+		Q_OBJECT
+	public:
+		TimestepPrefetcher(QString filePath, unsigned int newCapacity=PREFETCH_CAPACITY, QObject *parent=0);
+
+		/* Valid once indexBuilt() has been emitted */
+		unsigned int	GetNumNodes();
+		unsigned int	GetNumTimesteps();
+		unsigned int	GetValuesPerNode();
+		double		GetTimestepTime(unsigned int ts);
+
+		void	SetPosition(unsigned int ts);
+		bool	TakeTimestep(unsigned int ts, std::vector<float> &values);
+		void	Stop();
+
+	private:
+
+		Fort63				file;
+		Fort63Cache			cache;
+		bool				useCache;	/**< true if timesteps are read from the cache */
+		unsigned int			capacity;
+		unsigned int			numTimesteps;
+		std::vector<PrefetchSlot>	ring;
+
+		unsigned int	position;	/**< The first timestep of the prefetch window */
+		bool		stopRequested;
+		QMutex		ringMutex;
+		QWaitCondition	wakeCondition;
+
+		bool		ReadTimestep(unsigned int ts, std::vector<float> &values);
+		unsigned int	NextTimestepToRead();
+		bool		InWindow(unsigned int ts);
+		PrefetchSlot*	FindSlot(unsigned int ts);
+		PrefetchSlot*	FreeSlot();
+
+	public slots:
+
+		void	prefetch();
+
+	signals:
+
+		void	indexBuilt(int);
+		void	timestepReady(int);
+		void	finishedPrefetching();
+
+};
+
+#endif // TIMESTEPPREFETCHER_H
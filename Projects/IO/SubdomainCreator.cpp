@@ -103,12 +103,24 @@ QString SubdomainCreator::GetPy141Location()
 }
 
 
+/**
+ * @brief Builds the subdomain from the selected Elements
+ *
+ * Builds the subdomain from the selected Elements, and warns the user about any
+ * Nodes or Elements that were selected more than once.
+ *
+ */
 void SubdomainCreator::GetAllRequiredData()
 {
-	FindUniqueNodes();
-	FindBoundaryNodes();
-	MapOldToNewNodes();
-	MapOldToNewElements();
+	if (currentSelectedState)
+		extractor.SetElements(*currentSelectedState->GetState());
+	extractor.SetFullDomainSize(fullNumNodes, fullNumElements);
+	extractor.Extract();
+
+	if (extractor.GetDuplicateNodes().size() != 0)
+		DuplicatesWarning("nodes", extractor.GetDuplicateNodes());
+	if (extractor.GetDuplicateElements().size() != 0)
+		DuplicatesWarning("elements", extractor.GetDuplicateElements());
 }
 
 
@@ -130,69 +142,10 @@ bool SubdomainCreator::PerformDataValidation()
 
 bool SubdomainCreator::WriteFort14File()
 {
-	// Open the file
 	fort14Path = targetPath;
 	fort14Path.append(QDir::separator()).append("fort.14");
-	std::ofstream fort14File;
-	fort14File.open(fort14Path.toStdString().data());
-	if (fort14File.is_open())
-	{
-		// Write title line
-		fort14File << subdomainName.toStdString().data() << std::endl;
-
-		// Write info line
-		fort14File << selectedElements.size() << " " << selectedNodes.size() << std::endl;
-
-		// Write nodes
-		fort14File << std::setprecision(12);
-		Node *currNode = 0;
-		for (std::vector<Node*>::iterator it = selectedNodes.begin(); it != selectedNodes.end(); ++it)
-		{
-			currNode = *it;
-			if (currNode)
-			{
-				fort14File << "\t" <<
-					      oldToNewNodes[currNode->nodeNumber] << "\t" <<
-					      currNode->xDat << "\t" <<
-					      currNode->yDat << "\t" <<
-					      currNode->zDat <<
-					      std::endl;
-			}
-		}
-
-		// Write elements
-		Element *currElement = 0;
-		for (std::vector<Element*>::iterator it = selectedElements.begin(); it != selectedElements.end(); ++it)
-		{
-			currElement = *it;
-			if (currElement)
-			{
-				fort14File << oldToNewElements[currElement->elementNumber] << "\t3\t" <<
-					      oldToNewNodes[currElement->n1->nodeNumber] << "\t" <<
-					      oldToNewNodes[currElement->n2->nodeNumber] << "\t" <<
-					      oldToNewNodes[currElement->n3->nodeNumber] <<
-					      std::endl;
-			}
-		}
-
-		// Write boundaries
-		fort14File << "1\t!no. of open boundary segments" << std::endl;
-		fort14File << boundaryNodes.size()-1 << "\t!no. of open boundary nodes" << std::endl;
-		fort14File << boundaryNodes.size()-1 << std::endl;
-		for (std::vector<unsigned int>::iterator it = boundaryNodes.begin(); it != boundaryNodes.end(); ++it)
-		{
-			fort14File << oldToNewNodes[*it] << std::endl;
-		}
-		fort14File << "0\t!no. of land boundary segments" << std::endl;
-		fort14File << "0\t!no. of land boundary nodes" << std::endl;
-
-		// Close the file
-		fort14File.close();
-
-		return true;
-	} else {
-		return false;
-	}
+	extractor.SetSubdomainName(subdomainName.toStdString());
+	return extractor.WriteFort14File(fort14Path.toStdString());
 }
 
 
@@ -211,24 +164,7 @@ bool SubdomainCreator::WritePy140File()
 {
 	py140Path = targetPath;
 	py140Path.append(QDir::separator()).append("py.140");
-	std::ofstream py140;
-	py140.open(py140Path.toStdString().data());
-	if (py140.is_open())
-	{
-		py140 << "new old " << fullNumNodes << std::endl;
-		if (oldToNewNodes.size() != 0)
-		{
-			for (std::map<unsigned int, unsigned int>::iterator it = oldToNewNodes.begin(); it != oldToNewNodes.end(); ++it)
-			{
-				py140 << it->second << " " << it->first << std::endl;
-			}
-		}
-		py140.close();
-		return true;
-	} else {
-		std::cout << "Unable to open " << targetPath.append(QDir::separator()).append("py.140").toStdString().data() << std::endl;
-		return false;
-	}
+	return extractor.WritePy140File(py140Path.toStdString());
 }
 
 
@@ -236,134 +172,7 @@ bool SubdomainCreator::WritePy141File()
 {
 	py141Path = targetPath;
 	py141Path.append(QDir::separator()).append("py.141");
-	std::ofstream py141;
-	py141.open(py141Path.toStdString().data());
-	if (py141.is_open())
-	{
-		py141 << "new old " << fullNumElements << std::endl;
-		if (oldToNewElements.size() != 0)
-		{
-			for (std::map<unsigned int, unsigned int>::iterator it = oldToNewElements.begin(); it != oldToNewElements.end(); ++it)
-			{
-				py141 << it->second << " " << it->first << std::endl;
-			}
-		}
-		py141.close();
-		return true;
-	} else {
-		return false;
-	}
-}
-
-
-void SubdomainCreator::FindUniqueNodes()
-{
-	if (currentSelectedState)
-	{
-		// The list of all selected Elements
-		selectedElements = *currentSelectedState->GetState();
-
-		// Make a list of all selected Nodes, include duplicates
-		selectedNodes.reserve(selectedElements.size()*3);
-		Element *currElement = 0;
-		for (std::vector<Element*>::iterator it = selectedElements.begin(); it != selectedElements.end(); ++it)
-		{
-			currElement = *it;
-			selectedNodes.push_back(currElement->n1);
-			selectedNodes.push_back(currElement->n2);
-			selectedNodes.push_back(currElement->n3);
-		}
-
-		// Now remove duplicates
-		std::sort(selectedNodes.begin(), selectedNodes.end());
-		std::vector<Node*>::iterator it = std::unique(selectedNodes.begin(), selectedNodes.end());
-		selectedNodes.resize(std::distance(selectedNodes.begin(), it));
-	}
-}
-
-
-void SubdomainCreator::FindBoundaryNodes()
-{
-	if (currentSelectedState)
-	{
-		boundaryNodes = boundaryFinder.FindBoundaries(currentSelectedState);
-	}
-}
-
-
-void SubdomainCreator::MapOldToNewNodes()
-{
-	std::vector<unsigned int> skippedNodes;
-	Node *currNode = 0;
-	unsigned int newNodeNumber = 1;
-	for (std::vector<Node*>::iterator it = selectedNodes.begin(); it != selectedNodes.end(); ++it)
-	{
-		currNode = *it;
-		if (currNode)
-		{
-			if (oldToNewNodes.count(currNode->nodeNumber) != 0)
-			{
-				skippedNodes.push_back(currNode->nodeNumber);
-			} else {
-				oldToNewNodes[currNode->nodeNumber] = newNodeNumber;
-				++newNodeNumber;
-			}
-		}
-	}
-
-	if (skippedNodes.size() != 0)
-	{
-		QMessageBox msgBox;
-		msgBox.setWindowTitle("Create Subdomain");
-		QString warningText = "Warning: The following duplicate nodes have been removed:\n";
-		for (std::vector<unsigned int>::iterator it = skippedNodes.begin(); it != skippedNodes.end(); ++it)
-		{
-			warningText.append(QString::number(*it).append(", "));
-		}
-		warningText.chop(2);
-		msgBox.setText(warningText);
-		msgBox.setIcon(QMessageBox::Warning);
-		msgBox.setStandardButtons(QMessageBox::Ok);
-		msgBox.exec();
-	}
-}
-
-
-void SubdomainCreator::MapOldToNewElements()
-{
-	std::vector<unsigned int> skippedElements;
-	Element *currElement = 0;
-	unsigned int newElementNumber = 1;
-	for (std::vector<Element*>::iterator it = selectedElements.begin(); it != selectedElements.end(); ++it)
-	{
-		currElement = *it;
-		if (currElement)
-		{
-			if (oldToNewElements.count(currElement->elementNumber) != 0)
-			{
-				skippedElements.push_back(currElement->elementNumber);
-			} else {
-				oldToNewElements[currElement->elementNumber] = newElementNumber;
-				++newElementNumber;
-			}
-		}
-	}
-
-	if (skippedElements.size() != 0)
-	{
-		QMessageBox msgBox;
-		msgBox.setWindowTitle("Create Subdomain");
-		QString warningText = "Warning: The following duplicate elements have been removed:\n";
-		for (std::vector<unsigned int>::iterator it = skippedElements.begin(); it != skippedElements.end(); ++it)
-		{
-			warningText.append(QString::number(*it).append(", "));
-		}
-		warningText.chop(2);
-		msgBox.setText(warningText);
-		msgBox.setIcon(QMessageBox::Warning);
-		msgBox.setStandardButtons(QMessageBox::Ok);
-		msgBox.exec();
-	}
+	return extractor.WritePy141File(py141Path.toStdString());
 }
 
 
@@ -429,23 +238,19 @@ bool SubdomainCreator::TestForValidPath()
 
 bool SubdomainCreator::TestForSufficientElements()
 {
-	if (selectedElements.size() > 0)
-		return true;
-	return false;
+	return extractor.HasSufficientElements();
 }
 
 
 bool SubdomainCreator::TestForSufficientNodes()
 {
-	if (selectedNodes.size() > 2)
-		return true;
-	return false;
+	return extractor.HasSufficientNodes();
 }
 
 
 bool SubdomainCreator::TestForValidBoundary()
 {
-	if (boundaryNodes.size() > 2 && boundaryNodes[0] == boundaryNodes[boundaryNodes.size()-1])
+	if (extractor.HasValidBoundary())
 		return true;
 
 	QMessageBox msgBox;
@@ -458,6 +263,23 @@ bool SubdomainCreator::TestForValidBoundary()
 }
 
 
+void SubdomainCreator::DuplicatesWarning(QString type, std::vector<unsigned int> duplicates)
+{
+	QMessageBox msgBox;
+	msgBox.setWindowTitle("Create Subdomain");
+	QString warningText = "Warning: The following duplicate " + type + " have been removed:\n";
+	for (std::vector<unsigned int>::iterator it = duplicates.begin(); it != duplicates.end(); ++it)
+	{
+		warningText.append(QString::number(*it).append(", "));
+	}
+	warningText.chop(2);
+	msgBox.setText(warningText);
+	msgBox.setIcon(QMessageBox::Warning);
+	msgBox.setStandardButtons(QMessageBox::Ok);
+	msgBox.exec();
+}
+
+
 void SubdomainCreator::FileWriteError(QString fileName)
 {
 	QMessageBox msgBox;
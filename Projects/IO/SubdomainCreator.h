@@ -15,10 +15,18 @@
 #include <map>
 
 #include "Domains/Domain.h"
-#include "SubdomainTools/BoundaryFinder.h"
+#include "SubdomainTools/SubdomainExtractor.h"
 #include "Projects/IO/FileIO/BNList14.h"
 
 
+/**
+ * @brief Creates a subdomain from the Elements selected in a Domain
+ *
+ * Creates a subdomain from the Elements selected in a Domain. The subdomain is
+ * built and written by SubdomainExtractor. This class asks the user for a name
+ * and whether to overwrite an existing subdomain, and reports any problems.
+ *
+ */
 class SubdomainCreator
 {
 	public:
@@ -41,17 +49,10 @@ class SubdomainCreator
 	private:
 
 		/* Class Variables */
-		BoundaryFinder	boundaryFinder;
-		ElementState*	currentSelectedState;
-		unsigned int	fullNumNodes;
-		unsigned int	fullNumElements;
-
-		std::vector<Element*>		selectedElements;
-		std::vector<Node*>		selectedNodes;
-		std::vector<unsigned int>	boundaryNodes;
-
-		std::map<unsigned int, unsigned int>	oldToNewNodes;
-		std::map<unsigned int, unsigned int>	oldToNewElements;
+		SubdomainExtractor	extractor;
+		ElementState*		currentSelectedState;
+		unsigned int		fullNumNodes;
+		unsigned int		fullNumElements;
 
 		QString		projectPath;
 		QString		targetPath;
@@ -72,13 +73,6 @@ class SubdomainCreator
 		bool	WritePy141File();
 
 
-		/* Helper Functions */
-		void	FindUniqueNodes();
-		void	FindBoundaryNodes();
-		void	MapOldToNewNodes();
-		void	MapOldToNewElements();
-
-
 		/* Validation Functions */
 		bool	TestForValidPath();
 		bool	TestForSufficientElements();
@@ -86,6 +80,7 @@ class SubdomainCreator
 		bool	TestForValidBoundary();
 
 		/* Generic Message Boxes */
+		void	DuplicatesWarning(QString type, std::vector<unsigned int> duplicates);
 		void	FileWriteError(QString fileName);
 
 };
@@ -5,18 +5,89 @@ Project::Project() :
 	progressBar(0),
 	currentDomain(0),
 	fullDomain(0),
+	domainLoader(0),
 	displayOptions(0),
-	adcircRunning(false)
+	adcircRunning(false),
+	envelopeFirstTimestep(1),
+	envelopeLastTimestep(0),
+	jobScheduler(0),
+	runMonitor(0),
+	fullDomainRun(0),
+	fullDomainRunner(0),
+	pipeline(0),
+	carveThread(0),
+	liveCarver(0),
+	liveCarvingPending(false),
+	liveRecordInterval(0.0),
+	liveOutputInterval(0.0),
+	fort015Writer(0),
+	fort13Carver(0),
+	hotstartCarver(0)
 {
 	displayOptions = new DisplayOptionsDialog();
 	testProjectFile = new ProjectFile();
 	testProjectSettings = new ProjectSettings();
 	testProjectSettings->SetProjectFile(testProjectFile);
+
+	domainLoader = new DomainLoader();
+	connect(domainLoader, SIGNAL(memoryUsageChanged()), this, SLOT(updateMemoryDisplay()));
+	connect(domainLoader, SIGNAL(emitMessage(QString)), this, SIGNAL(emitMessage(QString)));
+	jobScheduler = new JobScheduler();
+	runMonitor = new RunMonitor(jobScheduler);
+
+	connect(&fort015Tasks, SIGNAL(finished()), this, SLOT(fort015Written()));
+	connect(&fort13Tasks, SIGNAL(finished()), this, SLOT(fort13CarvingFinished()));
+	connect(&hotstartTasks, SIGNAL(finished()), this, SLOT(hotstartCarvingFinished()));
 }
 
 
 Project::~Project()
 {
+	if (pipeline)
+		delete pipeline;
+	if (fullDomainRun)
+		delete fullDomainRun;
+	if (runMonitor)
+		delete runMonitor;
+	if (jobScheduler)
+		delete jobScheduler;
+
+	if (liveCarver)
+	{
+		liveCarver->StopCarving();
+		carveThread->quit();
+		carveThread->wait();
+		delete liveCarver;
+
+		/* The thread deletes itself later when it finishes, but there is no later now */
+		delete carveThread;
+	}
+
+	if (fort015Writer)
+	{
+		fort015Tasks.Cancel();
+		fort015Tasks.Wait();
+		delete fort015Writer;
+	}
+	if (fullDomainRunner)
+		delete fullDomainRunner;
+
+	if (fort13Carver)
+	{
+		fort13Tasks.Cancel();
+		fort13Tasks.Wait();
+		delete fort13Carver;
+	}
+
+	if (hotstartCarver)
+	{
+		hotstartTasks.Cancel();
+		hotstartTasks.Wait();
+		delete hotstartCarver;
+	}
+
+	if (domainLoader)
+		delete domainLoader;
 	if (fullDomain)
 		delete fullDomain;
 	if (subDomains.size() != 0)
@@ -55,6 +126,19 @@ void Project::SetProjectTree(QTreeWidget *newTree)
 void Project::SetProgressBar(QProgressBar *newBar)
 {
 	progressBar = newBar;
+	if (domainLoader)
+		domainLoader->SetProgressBar(progressBar);
+}
+
+
+/**
+ * @brief Sets the widget the domains are drawn in, so their GPU buffers can be freed when they are unloaded
+ * @param newWidget Pointer to the OpenGL widget in the user interface
+ */
+void Project::SetGLWidget(QGLWidget *newWidget)
+{
+	if (domainLoader)
+		domainLoader->SetGLWidget(newWidget);
 }
 
 
@@ -110,17 +194,30 @@ void Project::PopulateFromProjectFile()
 		if (!fullDomain)
 		{
 			fullDomain = new Domain();
-			if (progressBar)
-			{
-				fullDomain->SetProgressBar(progressBar);
-			}
 			QString fullDomainPath = testProjectFile->GetProjectDirectory();
 			QString fullFort14 = testProjectFile->GetFullDomainFort14();
+			QString fullFort63 = testProjectFile->GetFullDomainFort63();
+			QString fullFort64 = testProjectFile->GetFullDomainFort64();
 			if (!fullFort14.isEmpty())
 			{
 				fullDomain->SetDomainPath(fullDomainPath);
 				fullDomain->SetFort14Location(fullFort14);
 			}
+			if (!fullFort63.isEmpty())
+			{
+				fullDomain->SetFort63Location(fullFort63);
+			}
+			if (!fullFort64.isEmpty())
+			{
+				fullDomain->SetFort64Location(fullFort64);
+			}
+
+			/* Set after the fort.14 location, so the mesh read reports its progress through the loader */
+			if (progressBar)
+			{
+				fullDomain->SetProgressBar(progressBar);
+			}
+			domainLoader->QueueDomain(fullDomain, DOMAIN_LOAD_SOURCE);
 		}
 
 		QStringList subdomainNames = testProjectFile->GetSubDomainNames();
@@ -130,21 +227,39 @@ void Project::PopulateFromProjectFile()
 			if (subDomains.count(currName) == 0)
 			{
 				Domain *newSubdomain = new Domain();
-				if (progressBar)
-				{
-					newSubdomain->SetProgressBar(progressBar);
-				}
 				subDomains[currName] = newSubdomain;
 				QString subFort14 = testProjectFile->GetSubDomainFort14(currName);
 				QString subPy140 = testProjectFile->GetSubDomainPy140(currName);
+				QString subPy141 = testProjectFile->GetSubDomainPy141(currName);
+				QString subFort63 = testProjectFile->GetSubDomainFort63(currName);
+				QString subFort64 = testProjectFile->GetSubDomainFort64(currName);
 				if (!subFort14.isEmpty())
 				{
+					newSubdomain->SetDomainPath(QFileInfo(subFort14).absolutePath());
 					newSubdomain->SetFort14Location(subFort14);
 				}
 				if (!subPy140.isEmpty())
 				{
 					newSubdomain->SetPy140Location(subPy140);
 				}
+				if (!subPy141.isEmpty())
+				{
+					newSubdomain->SetPy141Location(subPy141);
+				}
+				if (!subFort63.isEmpty())
+				{
+					newSubdomain->SetFort63Location(subFort63);
+				}
+				if (!subFort64.isEmpty())
+				{
+					newSubdomain->SetFort64Location(subFort64);
+				}
+				newSubdomain->SetSourceDomain(fullDomain);
+				if (progressBar)
+				{
+					newSubdomain->SetProgressBar(progressBar);
+				}
+				domainLoader->QueueDomain(newSubdomain, DOMAIN_LOAD_DEFERRED);
 			}
 		}
 	}
@@ -191,6 +306,18 @@ Domain* Project::GetActiveDomain()
 }
 
 
+JobScheduler* Project::GetJobScheduler()
+{
+	return jobScheduler;
+}
+
+
+RunMonitor* Project::GetRunMonitor()
+{
+	return runMonitor;
+}
+
+
 void Project::ConnectProjectTree()
 {
 	if (projectTree)
@@ -274,11 +401,66 @@ void Project::UpdateTreeDisplay()
 			}
 
 			projectTree->expandToDepth(1);
+			updateMemoryDisplay();
+		}
+	}
+}
+
+
+/**
+ * @brief Shows the memory used by each domain's mesh next to it in the project tree
+ */
+void Project::updateMemoryDisplay()
+{
+	if (!projectTree || projectTree->topLevelItemCount() == 0)
+		return;
+
+	QTreeWidgetItem *treeTop = projectTree->topLevelItem(0);
+	for (int i=0; i<treeTop->childCount(); ++i)
+	{
+		QTreeWidgetItem *branch = treeTop->child(i);
+		if (branch->text(0) == "Full Domain")
+		{
+			ShowDomainMemory(branch, fullDomain);
+		}
+		else if (branch->text(0) == "Sub Domains")
+		{
+			for (int j=0; j<branch->childCount(); ++j)
+			{
+				std::map<QString, Domain*>::iterator it = subDomains.find(branch->child(j)->text(0));
+				if (it != subDomains.end())
+					ShowDomainMemory(branch->child(j), it->second);
+			}
 		}
 	}
 }
 
 
+/**
+ * @brief Shows the memory used by a domain's mesh in the second column of its tree item
+ * @param item The tree item of the domain
+ * @param domain The domain
+ */
+void Project::ShowDomainMemory(QTreeWidgetItem *item, Domain *domain)
+{
+	if (!item || !domain)
+		return;
+
+	qint64 memory = domain->GetMemoryUsage();
+	qint64 gpuMemory = domain->GetGPUMemoryUsage();
+	if (memory + gpuMemory == 0)
+	{
+		item->setData(1, Qt::DisplayRole, QString());
+		item->setData(1, Qt::ToolTipRole, QString("Not loaded"));
+		return;
+	}
+
+	item->setData(1, Qt::DisplayRole, QString::number((memory + gpuMemory)/1048576.0, 'f', 1) + " MB");
+	item->setData(1, Qt::ToolTipRole, QString::number(memory/1048576.0, 'f', 1) + " MB in memory, " +
+		      QString::number(gpuMemory/1048576.0, 'f', 1) + " MB on the GPU");
+}
+
+
 void Project::CreateFullDomain()
 {
 	if (!fullDomain)
@@ -292,7 +474,13 @@ void Project::SetCurrentDomain(Domain *domain)
 {
 	if (domain)
 	{
+		if (currentDomain && currentDomain != domain)
+		{
+			currentDomain->StopFort63Animation();
+			currentDomain->StopFort64Animation();
+		}
 		currentDomain = domain;
+		domainLoader->Prioritize(currentDomain);
 		if (displayOptions)
 		{
 			displayOptions->SetActiveDomain(currentDomain);
@@ -454,6 +642,118 @@ void Project::showDisplayOptions()
 }
 
 
+/**
+ * @brief Starts or stops fort.63 playback in the visible domain
+ */
+void Project::toggleFort63Animation()
+{
+	if (currentDomain)
+	{
+		if (currentDomain->Fort63AnimationRunning())
+			currentDomain->StopFort63Animation();
+		else
+			currentDomain->StartFort63Animation();
+	}
+}
+
+
+/**
+ * @brief Starts or stops fort.64 velocity playback in the visible domain
+ */
+void Project::toggleFort64Animation()
+{
+	if (currentDomain)
+	{
+		if (currentDomain->Fort64AnimationRunning())
+			currentDomain->StopFort64Animation();
+		else
+			currentDomain->StartFort64Animation();
+	}
+}
+
+
+/**
+ * @brief Shows or hides the max water elevation envelope in the visible domain
+ *
+ * Shows or hides the max water elevation envelope in the visible domain, over the
+ * time window set with setEnvelopeFirstTimestep() and setEnvelopeLastTimestep().
+ * The envelope of the whole run is computed from fort.63 if maxele.63 is missing.
+ * If the max velocity envelope is shown, it is replaced.
+ *
+ */
+void Project::toggleMaxElevation()
+{
+	if (currentDomain)
+	{
+		if (currentDomain->GetVisibleOverlay() == MaxElevationOverlay)
+			currentDomain->HideEnvelope();
+		else
+			currentDomain->ComputeEnvelope(false, envelopeFirstTimestep, envelopeLastTimestep);
+	}
+}
+
+
+/**
+ * @brief Shows or hides the max speed envelope in the visible domain
+ *
+ * Shows or hides the max speed envelope in the visible domain, over the time
+ * window set with setEnvelopeFirstTimestep() and setEnvelopeLastTimestep(). The
+ * envelope of the whole run is computed from fort.64 if maxvel.63 is missing. If
+ * the max elevation envelope is shown, it is replaced.
+ *
+ */
+void Project::toggleMaxVelocity()
+{
+	if (currentDomain)
+	{
+		if (currentDomain->GetVisibleOverlay() == MaxVelocityOverlay)
+			currentDomain->HideEnvelope();
+		else
+			currentDomain->ComputeEnvelope(true, envelopeFirstTimestep, envelopeLastTimestep);
+	}
+}
+
+
+/**
+ * @brief Sets the first timestep of the envelope window
+ * @param timestep The first timestep (starting from 1)
+ */
+void Project::setEnvelopeFirstTimestep(int timestep)
+{
+	envelopeFirstTimestep = timestep > 1 ? timestep : 1;
+}
+
+
+/**
+ * @brief Sets the last timestep of the envelope window
+ * @param timestep The last timestep, or 0 for the last timestep in the file
+ */
+void Project::setEnvelopeLastTimestep(int timestep)
+{
+	envelopeLastTimestep = timestep > 0 ? timestep : 0;
+}
+
+
+/**
+ * @brief Checks the visible subdomain's fort.63 against the full domain's fort.63
+ */
+void Project::verifySubdomain()
+{
+	if (currentDomain)
+		currentDomain->VerifyAgainstFullDomain();
+}
+
+
+/**
+ * @brief Lets the user click a point in the visible domain to plot its fort.63 time series
+ */
+void Project::pickTimeSeries()
+{
+	if (currentDomain)
+		currentDomain->UseTimeSeriesTool();
+}
+
+
 void Project::showProjectSettings()
 {
 	if (testProjectSettings)
@@ -461,27 +761,414 @@ void Project::showProjectSettings()
 }
 
 
+/**
+ * @brief Asks for the options of a full domain run and starts writing its fort.015 file
+ *
+ * Asks for the options of a full domain run and starts writing its fort.015 file
+ * as a task on the TaskScheduler, since finding the boundary nodes of every
+ * subdomain can take a while. The run is queued by fort015Written() once the file
+ * has been written.
+ *
+ */
 void Project::runFullDomain()
 {
-	if (ProjectIsOpen() && fullDomain && !adcircRunning)
+	if (ProjectIsOpen() && fullDomain && !adcircRunning && !fullDomainRunner && !(pipeline && pipeline->IsRunning()))
 	{
-		FullDomainRunner adcirc;
-		adcirc.SetAdcircExecutable(testProjectSettings->GetAdcircExecutableLocation());
-		adcirc.SetFullDomain(fullDomain);
+		fullDomainRunner = new FullDomainRunner();
+		fullDomainRunner->SetAdcircExecutable(testProjectSettings->GetAdcircExecutableLocation());
+		fullDomainRunner->SetPadcircExecutable(testProjectSettings->GetPadcircExecutableLocation());
+		fullDomainRunner->SetFullDomain(fullDomain);
 		if (subDomains.size() > 0)
 		{
-			std::cout << "Using " << subDomains.size() << " subdomains" << std::endl;
 			std::vector<Domain*> subdomainList;
 			for (std::map<QString, Domain*>::iterator it = subDomains.begin(); it != subDomains.end(); ++it)
 			{
 				subdomainList.push_back(it->second);
 			}
-			adcirc.SetSubDomains(subdomainList);
+			fullDomainRunner->SetSubDomains(subdomainList);
+		}
+
+		if (fullDomainRunner->ShowRunOptionsDialog())
+			fort015Writer = fullDomainRunner->CreateFort015Writer();
+
+		if (!fort015Writer)
+		{
+			delete fullDomainRunner;
+			fullDomainRunner = 0;
+			return;
+		}
+
+		emit emitMessage("<p>Writing fort.015 for " + QString::number(subDomains.size()) + " subdomains</p>");
+		TaskScheduler::Instance()->Start(fort015Writer, "writeFullDomain", TASK_PRIORITY_HIGH, &fort015Tasks);
+	}
+}
+
+
+/**
+ * @brief Queues the full domain run once its fort.015 file has been written
+ */
+void Project::fort015Written()
+{
+	/* The writing task has finished, so the writer can be deleted from here */
+	bool written = fort015Writer && fort015Writer->FullDomainWritten();
+	if (fort015Writer)
+	{
+		delete fort015Writer;
+		fort015Writer = 0;
+	}
+
+	FullDomainRunner *adcirc = fullDomainRunner;
+	fullDomainRunner = 0;
+	if (!adcirc)
+		return;
+
+	if (!written)
+	{
+		emit emitMessage("<p style='color:red'><strong>Error:</strong> Unable to write fort.015 for the full domain run</p>");
+		delete adcirc;
+		return;
+	}
+
+	if (!adcirc->CheckForRequiredFiles())
+	{
+		delete adcirc;
+		return;
+	}
+
+	if (subDomains.size() > 0)
+	{
+		std::vector<Domain*> subdomainList;
+		for (std::map<QString, Domain*>::iterator it = subDomains.begin(); it != subDomains.end(); ++it)
+		{
+			subdomainList.push_back(it->second);
 		}
+		StartFort13Carving(subdomainList);
+	}
+
+	/* Live carving follows fort.066, so it waits until the run has left the queue */
+	liveCarvingPending = adcirc->GetLiveCarving();
+	if (liveCarvingPending)
+	{
+		liveRecordInterval = adcirc->GetRecordInterval();
+		liveOutputInterval = adcirc->GetResampleInterval();
+		if (liveOutputInterval > 0.0 && liveRecordInterval <= 0.0)
+			emit emitMessage("<p style='color:red'><strong>Error:</strong> Unable to read the timestep (DTDP) from fort.15, boundary conditions will not be resampled</p>");
+	}
+
+	fullDomainRun = new AdcircRun(jobScheduler);
+	connect(fullDomainRun, SIGNAL(emitMessage(QString)), this, SIGNAL(emitMessage(QString)));
+	connect(fullDomainRun, SIGNAL(simulationStarted()), this, SLOT(fullDomainSimulationStarted()));
+	connect(fullDomainRun, SIGNAL(finished(int)), this, SLOT(fullDomainRunFinished(int)));
+	if (!adcirc->PerformFullDomainRun(fullDomainRun) && fullDomainRun)
+	{
+		delete fullDomainRun;
+		fullDomainRun = 0;
+		liveCarvingPending = false;
+	}
+	delete adcirc;
+
+	/* A run that failed to launch has already been cleaned up by fullDomainRunFinished() */
+	adcircRunning = fullDomainRun != 0;
+}
+
+
+/**
+ * @brief Queues an ADCIRC run in every subdomain directory
+ *
+ * Queues an ADCIRC run in every subdomain directory with the project's job
+ * scheduler, which packs as many of them onto the machine as its core and memory
+ * budget allows. Each run uses the ADCIRC executable from the project settings, so
+ * a stand-in executable can be set there to try out a batch.
+ *
+ */
+void Project::runSubdomains()
+{
+	if (!ProjectIsOpen() || subDomains.size() == 0)
+		return;
+
+	QString adcircExecutable = testProjectSettings->GetAdcircExecutableLocation();
+	if (adcircExecutable.isEmpty() || !QFile(adcircExecutable).exists())
+	{
+		QMessageBox dlg;
+		dlg.setWindowTitle("Run Subdomains");
+		dlg.setText("Error - The ADCIRC executable has not been set in the project settings");
+		dlg.setIcon(QMessageBox::Critical);
+		dlg.setStandardButtons(QMessageBox::Ok);
+		dlg.exec();
+		return;
+	}
+
+	for (std::map<QString, Domain*>::iterator it = subDomains.begin(); it != subDomains.end(); ++it)
+	{
+		Domain *subdomain = it->second;
+		if (subdomain)
+			jobScheduler->SubmitJob(it->first,
+						subdomain->GetDomainPath(),
+						adcircExecutable,
+						QStringList(),
+						1,
+						JobScheduler::EstimateMemory(subdomain->GetFort14Location()));
+	}
+}
+
+
+/**
+ * @brief Runs every step from the full domain run to the subdomain runs as a pipeline
+ *
+ * Runs every step from the full domain run to the subdomain runs as a pipeline,
+ * starting each step as soon as the steps it depends on are done. Steps that
+ * the project file records as done are skipped, so a pipeline that failed or was
+ * interrupted picks up from the last completed steps. Clicking the button while
+ * the pipeline is running stops it.
+ *
+ */
+void Project::runPipeline()
+{
+	if (!ProjectIsOpen() || !fullDomain || adcircRunning)
+		return;
 
-		if (adcirc.PrepareForFullDomainRun())
+	if (!pipeline)
+	{
+		pipeline = new Pipeline(jobScheduler, testProjectFile);
+		connect(pipeline, SIGNAL(emitMessage(QString)), this, SIGNAL(emitMessage(QString)));
+	}
+
+	if (pipeline->IsRunning())
+	{
+		pipeline->Stop();
+		return;
+	}
+
+	pipeline->SetFullDomain(fullDomain);
+	pipeline->SetSubdomains(subDomains);
+	pipeline->SetAdcircExecutable(testProjectSettings->GetAdcircExecutableLocation());
+	pipeline->SetPadcircExecutable(testProjectSettings->GetPadcircExecutableLocation());
+	pipeline->SetSubdomainExecutable(testProjectSettings->GetAdcircExecutableLocation());
+	if (pipeline->Configure())
+		pipeline->Start();
+}
+
+
+/**
+ * @brief Forgets which pipeline steps are done, so the next run starts from the beginning
+ */
+void Project::resetPipeline()
+{
+	if (!ProjectIsOpen() || (pipeline && pipeline->IsRunning()))
+		return;
+
+	if (pipeline)
+		pipeline->Reset();
+	else
+		testProjectFile->ClearPipelineState();
+	emit emitMessage("<p>The run pipeline has been reset</p>");
+}
+
+
+/**
+ * @brief Starts carving the full domain fort.066 file while the full domain run is writing it
+ *
+ * Starts carving the full domain fort.066 file while the full domain run is writing it.
+ * The carve runs in follow mode on its own thread, so each subdomain fort.020 file is
+ * kept current and subdomain runs can be started before the full domain run finishes.
+ * If the subdomains run with a different timestep, the boundary conditions are
+ * resampled onto it as they are carved.
+ *
+ * @param subdomainList The subdomains to carve boundary conditions for
+ * @param recordInterval The time between recorded timesteps in fort.066
+ * @param outputInterval The time between timesteps in fort.020, or 0 to keep the recorded timesteps
+ */
+void Project::StartLiveCarving(std::vector<Domain*> subdomainList, double recordInterval, double outputInterval)
+{
+	if (liveCarver || !fullDomain)
+		return;
+
+	carveThread = new QThread();
+	liveCarver = new Fort066(fullDomain->GetDomainPath() + QDir::separator() + "fort.066");
+	liveCarver->SetSubdomains(ListSubdomainFiles(subdomainList));
+	liveCarver->SetFollowMode(true);
+	liveCarver->SetResampling(recordInterval, outputInterval);
+	liveCarver->moveToThread(carveThread);
+
+	connect(carveThread, SIGNAL(started()), liveCarver, SLOT(carveAllSubdomains()));
+	connect(liveCarver, SIGNAL(finishedCarving()), carveThread, SLOT(quit()));
+	connect(carveThread, SIGNAL(finished()), this, SLOT(liveCarvingFinished()));
+	connect(carveThread, SIGNAL(finished()), carveThread, SLOT(deleteLater()));
+	if (progressBar)
+	{
+		connect(liveCarver, SIGNAL(startedCarving()), progressBar, SLOT(show()));
+		connect(liveCarver, SIGNAL(finishedCarving()), progressBar, SLOT(hide()));
+	}
+
+	carveThread->start();
+}
+
+
+/**
+ * @brief Lists the file locations of each subdomain for the file carvers
+ * @param subdomainList The subdomains
+ * @return The file locations of each subdomain
+ */
+std::vector<SubdomainFiles> Project::ListSubdomainFiles(std::vector<Domain *> subdomainList)
+{
+	std::vector<SubdomainFiles> filesList;
+	for (std::vector<Domain*>::iterator it = subdomainList.begin(); it != subdomainList.end(); ++it)
+		if (*it)
+			filesList.push_back((*it)->GetSubdomainFiles());
+	return filesList;
+}
+
+
+/**
+ * @brief Starts carving the full domain fort.13 file into each subdomain
+ *
+ * Starts carving the full domain fort.13 file into each subdomain as a task on
+ * the TaskScheduler. Subdomains whose fort.13 file is already up to date are
+ * skipped. Nothing is done if the full domain does not have a fort.13 file.
+ *
+ * @param subdomainList The subdomains to carve nodal attributes for
+ */
+void Project::StartFort13Carving(std::vector<Domain*> subdomainList)
+{
+	if (fort13Carver || !fullDomain)
+		return;
+
+	QString fort13Path = fullDomain->GetDomainPath() + QDir::separator() + "fort.13";
+	if (!QFile(fort13Path).exists())
+		return;
+
+	fort13Carver = new Fort13(fort13Path);
+	fort13Carver->SetSubdomains(ListSubdomainFiles(subdomainList));
+
+	if (progressBar)
+	{
+		connect(fort13Carver, SIGNAL(startedCarving()), progressBar, SLOT(show()));
+		connect(fort13Carver, SIGNAL(progress(int)), progressBar, SLOT(setValue(int)));
+		connect(fort13Carver, SIGNAL(finishedCarving()), progressBar, SLOT(hide()));
+	}
+
+	TaskScheduler::Instance()->Start(fort13Carver, "carveAllSubdomains", TASK_PRIORITY_NORMAL, &fort13Tasks);
+}
+
+
+/**
+ * @brief Starts carving the full domain hotstart file into each subdomain
+ *
+ * Starts carving the most recent full domain hotstart file (fort.67 or fort.68)
+ * into each subdomain as a task on the TaskScheduler, so that subdomain runs can be
+ * hot started. This is done once the full domain run has finished, so the files it
+ * wrote are carved rather than ones it may be overwriting. Subdomains whose hotstart
+ * file is already newer than the full domain file are skipped. Nothing is done if
+ * the full domain does not have a hotstart file.
+ *
+ * @param subdomainList The subdomains to carve the hotstart file for
+ */
+void Project::StartHotstartCarving(std::vector<Domain*> subdomainList)
+{
+	if (hotstartCarver || !fullDomain)
+		return;
+
+	QString hotstartPath = Fort67::FindLatestHotstart(fullDomain->GetDomainPath());
+	if (hotstartPath.isEmpty())
+		return;
+
+	hotstartCarver = new Fort67(hotstartPath);
+	hotstartCarver->SetSubdomains(ListSubdomainFiles(subdomainList));
+
+	TaskScheduler::Instance()->Start(hotstartCarver, "carveAllSubdomains", TASK_PRIORITY_NORMAL, &hotstartTasks);
+}
+
+
+void Project::liveCarvingFinished()
+{
+	/* The carving thread has finished, so the carver can be deleted from here */
+	if (liveCarver)
+	{
+		delete liveCarver;
+		liveCarver = 0;
+	}
+	carveThread = 0;
+}
+
+
+void Project::fort13CarvingFinished()
+{
+	/* The carving task has finished, so the carver can be deleted from here */
+	if (fort13Carver)
+	{
+		delete fort13Carver;
+		fort13Carver = 0;
+	}
+}
+
+
+void Project::hotstartCarvingFinished()
+{
+	/* The carving task has finished, so the carver can be deleted from here */
+	if (hotstartCarver)
+	{
+		delete hotstartCarver;
+		hotstartCarver = 0;
+	}
+}
+
+
+/**
+ * @brief Starts live carving once the full domain ADCIRC job starts running
+ */
+void Project::fullDomainSimulationStarted()
+{
+	if (!liveCarvingPending)
+		return;
+	liveCarvingPending = false;
+
+	std::vector<Domain*> subdomainList;
+	for (std::map<QString, Domain*>::iterator it = subDomains.begin(); it != subDomains.end(); ++it)
+	{
+		subdomainList.push_back(it->second);
+	}
+	StartLiveCarving(subdomainList, liveRecordInterval, liveOutputInterval);
+}
+
+
+/**
+ * @brief Cleans up once the full domain run has finished or failed
+ * @param exitCode The exit code of the last step of the run
+ */
+void Project::fullDomainRunFinished(int exitCode)
+{
+	if (exitCode == 0)
+		emit emitMessage("<p>Full domain run finished</p>");
+	else
+		emit emitMessage("<p style='color:red'><strong>Error:</strong> Full domain run failed with exit code " +
+				 QString::number(exitCode) + "</p>");
+
+	/* Nothing more will be written to fort.066, so the live carve must not wait for it */
+	liveCarvingPending = false;
+	if (liveCarver)
+	{
+		if (exitCode == 0)
+			liveCarver->FinishFollowing();
+		else
+			liveCarver->StopCarving();
+	}
+
+	if (fullDomainRun)
+	{
+		/* The run is still emitting finished(), so it cannot be deleted from here */
+		fullDomainRun->deleteLater();
+		fullDomainRun = 0;
+	}
+	adcircRunning = false;
+
+	/* The run has stopped writing its hotstart files, so they can be carved */
+	if (exitCode == 0 && subDomains.size() > 0)
+	{
+		std::vector<Domain*> subdomainList;
+		for (std::map<QString, Domain*>::iterator it = subDomains.begin(); it != subDomains.end(); ++it)
 		{
-			adcircRunning = adcirc.PerformFullDomainRun();
+			subdomainList.push_back(it->second);
 		}
+		StartHotstartCarving(subdomainList);
 	}
 }
@@ -13,9 +13,18 @@
 
 #include "Projects/ProjectFile.h"
 #include "Projects/ProjectSettings.h"
+#include "Projects/DomainLoader.h"
 #include "Projects/IO/SubdomainCreator.h"
+#include "Projects/IO/FileIO/Fort066.h"
+#include "Projects/IO/FileIO/Fort13.h"
+#include "Projects/IO/FileIO/Fort67.h"
 
 #include "Adcirc/FullDomainRunner.h"
+#include "Adcirc/JobScheduler.h"
+#include "Adcirc/Pipeline.h"
+#include "Adcirc/RunMonitor.h"
+
+#include "Tasks/TaskScheduler.h"
 
 
 /**
@@ -35,6 +44,7 @@ class Project : public QObject
 		/* User Interface Connections */
 		void	SetProjectTree(QTreeWidget *newTree);
 		void	SetProgressBar(QProgressBar *newBar);
+		void	SetGLWidget(QGLWidget *newWidget);
 
 		void	CreateProject();
 		void	OpenProject();
@@ -46,6 +56,10 @@ class Project : public QObject
 		/* Active domain fetching function */
 		Domain*		GetActiveDomain();
 
+		/* The scheduler that runs every ADCIRC job of the project */
+		JobScheduler*	GetJobScheduler();
+		RunMonitor*	GetRunMonitor();
+
 	private:
 
 		QTreeWidget*	projectTree;
@@ -60,6 +74,7 @@ class Project : public QObject
 		/* The actual Domains */
 		Domain*				fullDomain;
 		std::map<QString, Domain*>	subDomains;	/**< Map of subdomain names to the actual domain */
+		DomainLoader*			domainLoader;	/**< Reads the domains from disk, the selected one first */
 
 		/* Dialogs */
 		DisplayOptionsDialog*	displayOptions;
@@ -67,10 +82,45 @@ class Project : public QObject
 		/* Flags */
 		bool	adcircRunning;
 
+		/* The time window of the max elevation and max velocity envelopes */
+		unsigned int	envelopeFirstTimestep;
+		unsigned int	envelopeLastTimestep;	/**< 0 for the last timestep in the file */
+
+		/* Running ADCIRC */
+		JobScheduler*	jobScheduler;
+		RunMonitor*	runMonitor;
+		AdcircRun*	fullDomainRun;
+		FullDomainRunner*	fullDomainRunner;	/**< The options of a full domain run whose fort.015 is being written */
+		Pipeline*	pipeline;
+
+		/* Carving fort.066 while the full domain runs */
+		QThread*	carveThread;
+		Fort066*	liveCarver;
+		bool		liveCarvingPending;	/**< Live carving starts once the full domain run leaves the queue */
+		double		liveRecordInterval;
+		double		liveOutputInterval;
+		void		StartLiveCarving(std::vector<Domain*> subdomainList, double recordInterval=0.0, double outputInterval=0.0);
+
+		/* Writing fort.015 before the full domain runs */
+		TaskGroup	fort015Tasks;
+		Fort015*	fort015Writer;
+
+		/* Carving fort.13 for the subdomains */
+		TaskGroup	fort13Tasks;
+		Fort13*		fort13Carver;
+		void		StartFort13Carving(std::vector<Domain*> subdomainList);
+
+		/* Carving the full domain hotstart file for the subdomains */
+		TaskGroup	hotstartTasks;
+		Fort67*		hotstartCarver;
+		void		StartHotstartCarving(std::vector<Domain*> subdomainList);
+
 		/* Project-wide functionality */
 		void	ConnectProjectTree();
 		void	UpdateTreeDisplay();
+		void	ShowDomainMemory(QTreeWidgetItem *item, Domain *domain);
 		void	CreateFullDomain();
+		std::vector<SubdomainFiles>	ListSubdomainFiles(std::vector<Domain*> subdomainList);
 
 		/* Creating a new project */
 		bool	CreateProjectFile(QString directory, QString filename);
@@ -86,6 +136,13 @@ class Project : public QObject
 	private slots:
 
 		void	on_ProjectTreeItemChanged(QTreeWidgetItem *item, QTreeWidgetItem*);
+		void	liveCarvingFinished();
+		void	fort13CarvingFinished();
+		void	hotstartCarvingFinished();
+		void	fort015Written();
+		void	fullDomainSimulationStarted();
+		void	fullDomainRunFinished(int exitCode);
+		void	updateMemoryDisplay();
 
 	public slots:
 
@@ -101,10 +158,22 @@ class Project : public QObject
 		void	showProjectSettings();
 
 		void	runFullDomain();
+		void	runSubdomains();
+		void	runPipeline();
+		void	resetPipeline();
+		void	toggleFort63Animation();
+		void	toggleFort64Animation();
+		void	toggleMaxElevation();
+		void	toggleMaxVelocity();
+		void	setEnvelopeFirstTimestep(int timestep);
+		void	setEnvelopeLastTimestep(int timestep);
+		void	verifySubdomain();
+		void	pickTimeSeries();
 
 	signals:
 
 		void	newDomainSelected();
+		void	emitMessage(QString);
 
 		void	showProjectExplorerPane();
 		void	showCreateSubdomainPane();
@@ -5,6 +5,8 @@ const QString ProjectFile::TAG_PROJECT = "adcSubdomainProject";
 const QString ProjectFile::TAG_FULL_DOMAIN = "fullDomain";
 const QString ProjectFile::TAG_SUB_DOMAIN = "subDomain";
 const QString ProjectFile::TAG_SETTINGS = "settings";
+const QString ProjectFile::TAG_PIPELINE = "pipeline";
+const QString ProjectFile::TAG_PIPELINE_STEP = "step";
 
 const QString ProjectFile::ATTR_NAME = "name";
 const QString ProjectFile::ATTR_DIRECTORY = "dir";
@@ -29,7 +31,10 @@ const QString ProjectFile::ATTR_MAXVELLOCATION = "maxvelLoc";
 const QString ProjectFile::ATTR_PY140 = "py140Loc";
 const QString ProjectFile::ATTR_PY141 = "py141Loc";
 const QString ProjectFile::ATTR_ADCIRCLOCATION = "adcircExe";
+const QString ProjectFile::ATTR_PADCIRCLOCATION = "padcircExe";
 const QString ProjectFile::ATTR_LASTSAVE = "savedOn";
+const QString ProjectFile::ATTR_STATE = "state";
+const QString ProjectFile::ATTR_INPUTS = "inputs";
 
 
 
@@ -247,6 +252,56 @@ QString ProjectFile::GetAdcircLocation()
 }
 
 
+QString ProjectFile::GetPadcircLocation()
+{
+	return GetAttribute(TAG_SETTINGS, ATTR_PADCIRCLOCATION);
+}
+
+
+/**
+ * @brief Returns the saved state of a step of the run pipeline
+ * @param stepName The name of the step
+ * @return The state, or an empty string if the step has not been run
+ */
+QString ProjectFile::GetPipelineStepState(QString stepName)
+{
+	QDomElement pipelineElement = documentElement().namedItem(TAG_PIPELINE).toElement();
+	QDomElement currentStep = pipelineElement.firstChildElement(TAG_PIPELINE_STEP);
+	while (!currentStep.isNull())
+	{
+		QDomElement nameElement = currentStep.namedItem(ATTR_NAME).toElement();
+		if (nameElement.text() == stepName)
+		{
+			return currentStep.namedItem(ATTR_STATE).toElement().text();
+		}
+		currentStep = currentStep.nextSiblingElement(TAG_PIPELINE_STEP);
+	}
+	return QString();
+}
+
+
+/**
+ * @brief Returns the fingerprint of the inputs a step of the run pipeline was last done with
+ * @param stepName The name of the step
+ * @return The fingerprint, or an empty string if the step has not been done
+ */
+QString ProjectFile::GetPipelineStepInputs(QString stepName)
+{
+	QDomElement pipelineElement = documentElement().namedItem(TAG_PIPELINE).toElement();
+	QDomElement currentStep = pipelineElement.firstChildElement(TAG_PIPELINE_STEP);
+	while (!currentStep.isNull())
+	{
+		QDomElement nameElement = currentStep.namedItem(ATTR_NAME).toElement();
+		if (nameElement.text() == stepName)
+		{
+			return currentStep.namedItem(ATTR_INPUTS).toElement().text();
+		}
+		currentStep = currentStep.nextSiblingElement(TAG_PIPELINE_STEP);
+	}
+	return QString();
+}
+
+
 QDateTime ProjectFile::GetLastFileAccess()
 {
 	return lastModified;
@@ -391,6 +446,90 @@ void ProjectFile::SetAdcircLocation(QString newLoc)
 }
 
 
+void ProjectFile::SetPadcircLocation(QString newLoc)
+{
+	SetAttribute(TAG_SETTINGS, ATTR_PADCIRCLOCATION, newLoc);
+}
+
+
+/**
+ * @brief Saves the state of a step of the run pipeline
+ *
+ * Saves the state of a step of the run pipeline, so that an interrupted pipeline
+ * can pick up where it left off when the project is opened again. The project file
+ * is written immediately.
+ *
+ * @param stepName The name of the step
+ * @param state The state
+ * @param inputs The fingerprint of the inputs the step was done with, or empty to keep the saved one
+ */
+void ProjectFile::SetPipelineStepState(QString stepName, QString state, QString inputs)
+{
+	QDomElement pipelineElement = documentElement().namedItem(TAG_PIPELINE).toElement();
+	if (pipelineElement.isNull())
+	{
+		pipelineElement = createElement(TAG_PIPELINE);
+		documentElement().appendChild(pipelineElement);
+	}
+
+	QDomElement currentStep = pipelineElement.firstChildElement(TAG_PIPELINE_STEP);
+	while (!currentStep.isNull())
+	{
+		if (currentStep.namedItem(ATTR_NAME).toElement().text() == stepName)
+			break;
+		currentStep = currentStep.nextSiblingElement(TAG_PIPELINE_STEP);
+	}
+
+	if (currentStep.isNull())
+	{
+		currentStep = createElement(TAG_PIPELINE_STEP);
+		QDomElement nameElement = createElement(ATTR_NAME);
+		nameElement.appendChild(createTextNode(stepName));
+		currentStep.appendChild(nameElement);
+		pipelineElement.appendChild(currentStep);
+	}
+
+	QDomNode stateNode = currentStep.namedItem(ATTR_STATE);
+	if (!stateNode.isNull())
+	{
+		currentStep.removeChild(stateNode);
+	}
+
+	QDomElement stateElement = createElement(ATTR_STATE);
+	stateElement.appendChild(createTextNode(state));
+	currentStep.appendChild(stateElement);
+
+	if (!inputs.isEmpty())
+	{
+		QDomNode inputsNode = currentStep.namedItem(ATTR_INPUTS);
+		if (!inputsNode.isNull())
+		{
+			currentStep.removeChild(inputsNode);
+		}
+
+		QDomElement inputsElement = createElement(ATTR_INPUTS);
+		inputsElement.appendChild(createTextNode(inputs));
+		currentStep.appendChild(inputsElement);
+	}
+
+	SaveProject();
+}
+
+
+/**
+ * @brief Forgets the state of every step of the run pipeline, so the next run starts over
+ */
+void ProjectFile::ClearPipelineState()
+{
+	QDomNode pipelineNode = documentElement().namedItem(TAG_PIPELINE);
+	if (!pipelineNode.isNull())
+	{
+		documentElement().removeChild(pipelineNode);
+		SaveProject();
+	}
+}
+
+
 bool ProjectFile::AddSubdomain(QString newName)
 {
 	QDomElement currentSubdomain = documentElement().firstChildElement(TAG_SUB_DOMAIN);
@@ -39,6 +39,9 @@ class ProjectFile : public QDomDocument
 		QString		GetSubDomainPy140(QString subdomainName);
 		QString		GetSubDomainPy141(QString subdomainName);
 		QString		GetAdcircLocation();
+		QString		GetPadcircLocation();
+		QString		GetPipelineStepState(QString stepName);
+		QString		GetPipelineStepInputs(QString stepName);
 		QDateTime	GetLastFileAccess();
 
 		/* Setter Functions */
@@ -63,6 +66,9 @@ class ProjectFile : public QDomDocument
 		void	SetSubDomainPy140(QString subDomain, QString newLoc);
 		void	SetSubDomainPy141(QString subDomain, QString newLoc);
 		void	SetAdcircLocation(QString newLoc);
+		void	SetPadcircLocation(QString newLoc);
+		void	SetPipelineStepState(QString stepName, QString state, QString inputs=QString());
+		void	ClearPipelineState();
 
 		/* Adder Functions */
 		bool	AddSubdomain(QString newName);
@@ -73,6 +79,8 @@ class ProjectFile : public QDomDocument
 		static const QString	TAG_FULL_DOMAIN;
 		static const QString	TAG_SUB_DOMAIN;
 		static const QString	TAG_SETTINGS;
+		static const QString	TAG_PIPELINE;
+		static const QString	TAG_PIPELINE_STEP;
 
 		/* Static attribute strings */
 		static const QString	ATTR_NAME;
@@ -98,7 +106,10 @@ class ProjectFile : public QDomDocument
 		static const QString	ATTR_PY140;
 		static const QString	ATTR_PY141;
 		static const QString	ATTR_ADCIRCLOCATION;
+		static const QString	ATTR_PADCIRCLOCATION;
 		static const QString	ATTR_LASTSAVE;
+		static const QString	ATTR_STATE;
+		static const QString	ATTR_INPUTS;
 
 	private:
 
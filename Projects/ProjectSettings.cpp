@@ -2,7 +2,9 @@
 
 ProjectSettings::ProjectSettings()
 {
+	projectFile = 0;
 	adcircExecutableLocation = "";
+	padcircExecutableLocation = "";
 }
 
 
@@ -17,9 +19,16 @@ void ProjectSettings::ShowProjectSettingsDialog()
 	ReadSettingsFromFile();
 	ProjectSettingsDialog dlg;
 	dlg.SetAdcircExecutableLocation(adcircExecutableLocation);
+	dlg.SetPadcircExecutableLocation(padcircExecutableLocation);
 	if (dlg.exec())
 	{
 		adcircExecutableLocation = dlg.GetAdcircExecutableLocation();
+		padcircExecutableLocation = dlg.GetPadcircExecutableLocation();
+		if (projectFile)
+		{
+			projectFile->SetAdcircLocation(adcircExecutableLocation);
+			projectFile->SetPadcircLocation(padcircExecutableLocation);
+		}
 	}
 }
 
@@ -41,6 +50,17 @@ QString ProjectSettings::GetAdcircExecutableLocation()
 }
 
 
+/**
+ * @brief Returns the parallel ADCIRC executable used for runs on more than one processor
+ * @return The location of padcirc, or an empty string if it has not been set
+ */
+QString ProjectSettings::GetPadcircExecutableLocation()
+{
+	ReadSettingsFromFile();
+	return padcircExecutableLocation;
+}
+
+
 void ProjectSettings::ReadSettingsFromFile()
 {
 	if (projectFile)
@@ -48,6 +68,7 @@ void ProjectSettings::ReadSettingsFromFile()
 		if (lastDataFetch.isNull() || lastDataFetch < projectFile->GetLastFileAccess())
 		{
 			adcircExecutableLocation = projectFile->GetAdcircLocation();
+			padcircExecutableLocation = projectFile->GetPadcircLocation();
 
 			lastDataFetch = QDateTime::currentDateTime();
 		}
@@ -18,6 +18,7 @@ class ProjectSettings
 		void	SetProjectFile(ProjectFile *newFile);
 
 		QString		GetAdcircExecutableLocation();
+		QString		GetPadcircExecutableLocation();
 
 	private:
 
@@ -25,6 +26,7 @@ class ProjectSettings
 
 		QDateTime	lastDataFetch;
 		QString		adcircExecutableLocation;
+		QString		padcircExecutableLocation;
 
 		void	ReadSettingsFromFile();
 
@@ -0,0 +1,198 @@
+#include "MeshNormalizer.h"
+
+MeshNormalizer::MeshNormalizer()
+{
+	minX = maxX = minY = maxY = minZ = maxZ = 0.0;
+	midX = midY = 0.0;
+	scale = 1.0;
+}
+
+
+/**
+ * @brief Sets the extents of the mesh, as tracked while it was read
+ * @param newMinX The smallest x-value
+ * @param newMaxX The largest x-value
+ * @param newMinY The smallest y-value
+ * @param newMaxY The largest y-value
+ * @param newMinZ The smallest z-value
+ * @param newMaxZ The largest z-value
+ */
+void MeshNormalizer::SetExtents(float newMinX, float newMaxX, float newMinY, float newMaxY, float newMinZ, float newMaxZ)
+{
+	minX = newMinX;
+	maxX = newMaxX;
+	minY = newMinY;
+	maxY = newMaxY;
+	minZ = newMinZ;
+	maxZ = newMaxZ;
+	FindScale();
+}
+
+
+/**
+ * @brief Finds the extents of the mesh from its Nodes
+ *
+ * Finds the extents of the mesh from its Nodes, for meshes that were read
+ * from a cache rather than parsed.
+ *
+ * @param nodes Every Node of the mesh
+ */
+void MeshNormalizer::FindExtents(const std::vector<Node> &nodes)
+{
+	if (nodes.size() == 0)
+		return;
+
+	minX = maxX = nodes[0].x;
+	minY = maxY = nodes[0].y;
+	minZ = maxZ = nodes[0].z;
+	for (std::vector<Node>::const_iterator it = nodes.begin(); it != nodes.end(); ++it)
+	{
+		if (it->x < minX)
+			minX = it->x;
+		if (it->x > maxX)
+			maxX = it->x;
+		if (it->y < minY)
+			minY = it->y;
+		if (it->y > maxY)
+			maxY = it->y;
+		if (it->z < minZ)
+			minZ = it->z;
+		if (it->z > maxZ)
+			maxZ = it->z;
+	}
+	FindScale();
+}
+
+
+/**
+ * @brief Calculates the normalized coordinates of a single Node
+ * @param node The Node
+ */
+void MeshNormalizer::NormalizeNode(Node &node)
+{
+	float depthRange = maxZ - minZ;
+	node.normX = (node.x - midX)/scale;
+	node.normY = (node.y - midY)/scale;
+	node.normZ = depthRange != 0.0 ? node.z / depthRange : 0.0;
+}
+
+
+/**
+ * @brief Calculates the normalized coordinates of each Node
+ * @param nodes The Nodes
+ */
+void MeshNormalizer::NormalizeNodes(std::vector<Node> &nodes)
+{
+	for (std::vector<Node>::iterator it = nodes.begin(); it != nodes.end(); ++it)
+		NormalizeNode(*it);
+}
+
+
+float MeshNormalizer::NormalizeX(float x)
+{
+	return (x - midX)/scale;
+}
+
+
+float MeshNormalizer::NormalizeY(float y)
+{
+	return (y - midY)/scale;
+}
+
+
+float MeshNormalizer::NormalizeDistance(float distance)
+{
+	return distance/scale;
+}
+
+
+/**
+ * @brief Converts a normalized x-coordinate back into mesh coordinates
+ * @param x The normalized coordinate
+ * @return The coordinate in the mesh's coordinate system
+ */
+float MeshNormalizer::DenormalizeX(float x)
+{
+	return x*scale + midX;
+}
+
+
+/**
+ * @brief Converts a normalized y-coordinate back into mesh coordinates
+ * @param y The normalized coordinate
+ * @return The coordinate in the mesh's coordinate system
+ */
+float MeshNormalizer::DenormalizeY(float y)
+{
+	return y*scale + midY;
+}
+
+
+float MeshNormalizer::GetMinX()
+{
+	return minX;
+}
+
+
+float MeshNormalizer::GetMaxX()
+{
+	return maxX;
+}
+
+
+float MeshNormalizer::GetMinY()
+{
+	return minY;
+}
+
+
+float MeshNormalizer::GetMaxY()
+{
+	return maxY;
+}
+
+
+float MeshNormalizer::GetMinZ()
+{
+	return minZ;
+}
+
+
+float MeshNormalizer::GetMaxZ()
+{
+	return maxZ;
+}
+
+
+float MeshNormalizer::GetNormalizedMinX()
+{
+	return NormalizeX(minX);
+}
+
+
+float MeshNormalizer::GetNormalizedMaxX()
+{
+	return NormalizeX(maxX);
+}
+
+
+float MeshNormalizer::GetNormalizedMinY()
+{
+	return NormalizeY(minY);
+}
+
+
+float MeshNormalizer::GetNormalizedMaxY()
+{
+	return NormalizeY(maxY);
+}
+
+
+void MeshNormalizer::FindScale()
+{
+	midX = minX + (maxX - minX) / 2.0;
+	midY = minY + (maxY - minY) / 2.0;
+	scale = fmax(maxX-minX, maxY-minY);
+	if (scale == 0.0)
+		scale = 1.0;
+}
@@ -0,0 +1,67 @@
+#ifndef MESHNORMALIZER_H
+#define MESHNORMALIZER_H
+
+#include <vector>
+#include <math.h>
+
+#include "adcData.h"
+
+
+/**
+ * @brief Calculates the normalized coordinates of a mesh for building a Quadtree
+ *
+ * Calculates the normalized coordinates of a mesh. The Quadtree and the search
+ * tools work in normalized coordinates, where the mesh is centered on the origin
+ * and its longer side spans from -0.5 to 0.5. TerrainLayer uses it to normalize
+ * its Nodes for drawing, and the command line tools use it to build a Quadtree
+ * without a display, so both select the same Elements. It also converts points
+ * and distances between mesh coordinates and normalized coordinates.
+ *
+ * Usage:
+ * - Call FindExtents() with the Nodes, or SetExtents() if they are already known
+ * - Call NormalizeNodes(), then build the Quadtree with the normalized bounds
+ *
+ */
+class MeshNormalizer
+{
+	public:
+		MeshNormalizer();
+
+		void	SetExtents(float newMinX, float newMaxX, float newMinY, float newMaxY, float newMinZ, float newMaxZ);
+		void	FindExtents(const std::vector<Node> &nodes);
+		void	NormalizeNode(Node &node);
+		void	NormalizeNodes(std::vector<Node> &nodes);
+
+		float	NormalizeX(float x);
+		float	NormalizeY(float y);
+		float	NormalizeDistance(float distance);
+		float	DenormalizeX(float x);
+		float	DenormalizeY(float y);
+
+		float	GetMinX();
+		float	GetMaxX();
+		float	GetMinY();
+		float	GetMaxY();
+		float	GetMinZ();
+		float	GetMaxZ();
+		float	GetNormalizedMinX();
+		float	GetNormalizedMaxX();
+		float	GetNormalizedMinY();
+		float	GetNormalizedMaxY();
+
+	private:
+
+		float	minX;
+		float	maxX;
+		float	minY;
+		float	maxY;
+		float	minZ;
+		float	maxZ;
+		float	midX;
+		float	midY;
+		float	scale;	/**< The length of the longer side of the mesh */
+
+		void	FindScale();
+};
+
+#endif // MESHNORMALIZER_H
@@ -14,14 +14,6 @@ Quadtree::Quadtree(std::vector<Node> nodes, int size, float minX, float maxX, fl
 	nodeList = nodes;
 	binSize = size;
 
-	glLoaded = false;
-	pointCount = 0;
-	VAOId = 0;
-	VBOId = 0;
-	IBOId = 0;
-	outlineShader = 0;
-	camera = 0;
-
 	// Create the root branch
 	root = newBranch(minX, maxX, minY, maxY);
 
@@ -50,14 +42,6 @@ Quadtree::Quadtree(std::vector<Node> nodes, std::vector<Element> elements, int s
 	elementList = elements;
 	binSize = size;
 
-	glLoaded = false;
-	pointCount = 0;
-	VAOId = 0;
-	VBOId = 0;
-	IBOId = 0;
-	outlineShader = 0;
-	camera = 0;
-
 	// Create the root branch
 	root = newBranch(minX, maxX, minY, maxY);
 
@@ -82,48 +66,6 @@ Quadtree::~Quadtree()
 	for (unsigned int i=0; i<branchList.size(); i++)
 		if (branchList[i] != 0)
 			delete branchList[i];
-
-	/* Clean up shader */
-	if (outlineShader)
-		delete outlineShader;
-
-	/* Clean up OpenGL stuff */
-	glBindBuffer(GL_ARRAY_BUFFER, 0);
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-	if (VAOId)
-		glDeleteBuffers(1, &VAOId);
-	if (VBOId)
-		glDeleteBuffers(1, &VBOId);
-	if (IBOId)
-		glDeleteBuffers(1, &IBOId);
-}
-
-
-void Quadtree::DrawOutlines()
-{
-	if (!glLoaded)
-		InitializeGL();
-
-	if (glLoaded)
-	{
-		glBindVertexArray(VAOId);
-		if (outlineShader)
-		{
-			glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-			if (outlineShader->Use())
-				glDrawElements(GL_LINES, 2*pointCount, GL_UNSIGNED_INT, (GLvoid*)0);
-		}
-		glBindVertexArray(0);
-		glUseProgram(0);
-	}
-}
-
-
-void Quadtree::SetCamera(GLCamera *newCam)
-{
-	camera = newCam;
-	if (outlineShader)
-		outlineShader->SetCamera(camera);
 }
 
 
@@ -199,6 +141,26 @@ std::vector<std::vector<Element*>*> Quadtree::GetElementsThroughDepth(int depth)
 }
 
 
+/**
+ * @brief Finds an evenly spaced sample of the Nodes that fall inside of the provided rectangle
+ *
+ * Finds an evenly spaced sample of the Nodes that fall inside of the provided rectangle,
+ * with at most one Node in each spacing by spacing cell. This is used to place glyphs
+ * at a constant density on the screen regardless of the mesh resolution.
+ *
+ * @param l The left bound of the rectangle
+ * @param r The right bound of the rectangle
+ * @param b The bottom bound of the rectangle
+ * @param t The top bound of the rectangle
+ * @param spacing The minimum distance between sampled Nodes
+ * @return A vector of pointers to the sampled Nodes
+ */
+std::vector<Node*> Quadtree::SampleNodesInRectangle(float l, float r, float b, float t, float spacing)
+{
+	return sampleSearch.FindNodes(root, l, r, b, t, spacing);
+}
+
+
 std::vector<std::vector<Element*>*> Quadtree::GetElementsThroughDepth(int depth, float l, float r, float b, float t)
 {
 	return depthSearch.FindElements(root, depth, l, r, b, t);
@@ -391,29 +353,31 @@ void Quadtree::addNode(Node *currNode, branch *currBranch)
  *
  * Adds an Element to the quadtree. An element is considered to be inside of a branch
  * or leaf if any of its Nodes are inside of the branch or leaf. Adding the Element is done
- * by recursively going down the tree based on n1 location.
+ * by recursively going down every branch that the Element overlaps.
+ *
+ * An Element that is larger than the leaves around it can cover part of a leaf without
+ * any of its Nodes being inside of it. It is added to the crossingElements of that leaf,
+ * so a point in that part of the leaf can still be found by ClickSearch. The selection
+ * tools only use the Elements that have a Node in the leaf.
  *
  * @param currElement The Element being added
  * @param currBranch The current branch we'd like to add the Element to
  */
 void Quadtree::addElement(Element *currElement, branch *currBranch)
 {
-	// See if any of the Nodes fall into any of the branches
+	// See if the Element overlaps any of the branches
 	for (int i=0; i<4; i++)
 	{
 		if (currBranch->branches[i] != 0)
 		{
-			if (nodeIsInside(currElement->n1, currBranch->branches[i]) ||
-			    nodeIsInside(currElement->n2, currBranch->branches[i]) ||
-			    nodeIsInside(currElement->n3, currBranch->branches[i]))
+			if (elementOverlaps(currElement, currBranch->branches[i]))
 			{
 				addElement(currElement, currBranch->branches[i]);
-//				return;
 			}
 		}
 	}
 
-	// See if any of the Nodes fall into any of the leaves
+	// See if any of the Nodes fall into any of the leaves, or if the Element crosses them
 	for (int i=0; i<4; i++)
 	{
 		if (currBranch->leaves[i] != 0)
@@ -423,7 +387,10 @@ void Quadtree::addElement(Element *currElement, branch *currBranch)
 			    nodeIsInside(currElement->n3, currBranch->leaves[i]))
 			{
 				currBranch->leaves[i]->elements.push_back(currElement);
-//				return;
+			}
+			else if (elementOverlaps(currElement, currBranch->leaves[i]))
+			{
+				currBranch->leaves[i]->crossingElements.push_back(currElement);
 			}
 		}
 	}
@@ -468,60 +435,52 @@ bool Quadtree::nodeIsInside(Node *currNode, branch *currBranch)
 }
 
 
-void Quadtree::InitializeGL()
+/**
+ * @brief A helper function that determines if the bounding box of an Element overlaps the leaf
+ * @param currElement A pointer to the Element being tested
+ * @param currLeaf A pointer to the leaf being tested
+ * @return true if the bounding box of the Element overlaps the leaf
+ */
+bool Quadtree::elementOverlaps(Element *currElement, leaf *currLeaf)
 {
-	if (!outlineShader)
-		outlineShader = new SolidShader();
-	outlineShader->SetColor(QColor(0.0*255, 0.0*255, 0.0*255, 1.0*255));
-	outlineShader->SetCamera(camera);
-
-	if (!VAOId)
-		glGenVertexArrays(1, &VAOId);
-	if (!VBOId)
-		glGenBuffers(1, &VBOId);
-	if (!IBOId)
-		glGenBuffers(1, &IBOId);
-
-	glBindVertexArray(VAOId);
-
-	glBindBuffer(GL_ARRAY_BUFFER, VBOId);
-	glEnableVertexAttribArray(0);
-	glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 4*sizeof(GLfloat), 0);
-
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBOId);
-
-	glBindVertexArray(0);
-
-	std::vector<Point> pointsList = BuildOutlinesList();
-	std::vector<GLuint> indicesList = BuildOutlinesIndices();
+	Node *n1 = currElement->n1;
+	Node *n2 = currElement->n2;
+	Node *n3 = currElement->n3;
+	return	std::max(n1->normX, std::max(n2->normX, n3->normX)) >= currLeaf->bounds[0] &&
+		std::min(n1->normX, std::min(n2->normX, n3->normX)) <= currLeaf->bounds[1] &&
+		std::max(n1->normY, std::max(n2->normY, n3->normY)) >= currLeaf->bounds[2] &&
+		std::min(n1->normY, std::min(n2->normY, n3->normY)) <= currLeaf->bounds[3];
+}
 
-	if (pointsList.size() > 0 && indicesList.size() > 0)
-	{
-		LoadOutlinesToGPU(pointsList, indicesList);
-	} else {
-		glLoaded = false;
-		return;
-	}
 
-	GLenum errorCheck = glGetError();
-	if (errorCheck == GL_NO_ERROR)
-	{
-		if (VAOId && VBOId && IBOId)
-		{
-			glLoaded = true;
-		} else {
-			DEBUG("Quadtree drawing not initialized");
-			glLoaded = false;
-		}
-	} else {
-		const GLubyte *errString = gluErrorString(errorCheck);
-		DEBUG("Quadtree Drawing OpenGL Error: " << errString);
-		glLoaded = false;
-	}
+/**
+ * @brief A helper function that determines if the bounding box of an Element overlaps the branch
+ * @param currElement A pointer to the Element being tested
+ * @param currBranch A pointer to the branch being tested
+ * @return true if the bounding box of the Element overlaps the branch
+ */
+bool Quadtree::elementOverlaps(Element *currElement, branch *currBranch)
+{
+	Node *n1 = currElement->n1;
+	Node *n2 = currElement->n2;
+	Node *n3 = currElement->n3;
+	return	std::max(n1->normX, std::max(n2->normX, n3->normX)) >= currBranch->bounds[0] &&
+		std::min(n1->normX, std::min(n2->normX, n3->normX)) <= currBranch->bounds[1] &&
+		std::max(n1->normY, std::max(n2->normY, n3->normY)) >= currBranch->bounds[2] &&
+		std::min(n1->normY, std::min(n2->normY, n3->normY)) <= currBranch->bounds[3];
 }
 
 
-std::vector<Point> Quadtree::BuildOutlinesList()
+/**
+ * @brief Returns the corners of every branch and leaf in the Quadtree
+ *
+ * Returns the corners of every branch and leaf in the Quadtree, four points for
+ * each rectangle in counterclockwise order starting from the lower left. Used to
+ * draw the outlines of the Quadtree.
+ *
+ * @return The list of corner points, in normalized coordinates
+ */
+std::vector<Point> Quadtree::GetOutlinePoints()
 {
 	std::vector<Point> pointsList;
 
@@ -534,29 +493,12 @@ std::vector<Point> Quadtree::BuildOutlinesList()
 }
 
 
-std::vector<GLuint> Quadtree::BuildOutlinesIndices()
-{
-	std::vector<GLuint> indexList;
-
-	for (int i=0; i<pointCount/4; ++i)
-	{
-		indexList.push_back(4*i+0); indexList.push_back(4*i+1);
-		indexList.push_back(4*i+1); indexList.push_back(4*i+2);
-		indexList.push_back(4*i+2); indexList.push_back(4*i+3);
-		indexList.push_back(4*i+3); indexList.push_back(4*i+0);
-	}
-
-	return indexList;
-}
-
-
 void Quadtree::AddOutlinePoints(branch *currBranch, std::vector<Point> *pointsList)
 {
 	pointsList->push_back(Point(currBranch->bounds[0], currBranch->bounds[2]));
 	pointsList->push_back(Point(currBranch->bounds[1], currBranch->bounds[2]));
 	pointsList->push_back(Point(currBranch->bounds[1], currBranch->bounds[3]));
 	pointsList->push_back(Point(currBranch->bounds[0], currBranch->bounds[3]));
-	pointCount += 4;
 
 	for (int i=0; i<4; ++i)
 		if (currBranch->branches[i])
@@ -573,45 +515,4 @@ void Quadtree::AddOutlinePoints(leaf *currLeaf, std::vector<Point> *pointsList)
 	pointsList->push_back(Point(currLeaf->bounds[1], currLeaf->bounds[2]));
 	pointsList->push_back(Point(currLeaf->bounds[1], currLeaf->bounds[3]));
 	pointsList->push_back(Point(currLeaf->bounds[0], currLeaf->bounds[3]));
-	pointCount += 4;
-}
-
-
-void Quadtree::LoadOutlinesToGPU(std::vector<Point> pointsList, std::vector<GLuint> indicesList)
-{
-	const size_t VertexBufferSize = 4*sizeof(GLfloat)*pointsList.size();
-	const size_t IndexBufferSize = sizeof(GLuint)*indicesList.size();
-
-	if (VBOId)
-	{
-		glBindBuffer(GL_ARRAY_BUFFER, VBOId);
-		glBufferData(GL_ARRAY_BUFFER, VertexBufferSize, NULL, GL_STATIC_DRAW);
-		GLfloat* glNodeData = (GLfloat*)glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-		if (glNodeData)
-		{
-			for (unsigned int i=0; i<pointsList.size(); ++i)
-			{
-				glNodeData[4*i+0] = (GLfloat)pointsList[i].x;
-				glNodeData[4*i+1] = (GLfloat)pointsList[i].y;
-				glNodeData[4*i+2] = (GLfloat)1.0;
-				glNodeData[4*i+3] = (GLfloat)1.0;
-			}
-		}
-		glUnmapBuffer(GL_ARRAY_BUFFER);
-	}
-
-	if (IBOId)
-	{
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, IBOId);
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, IndexBufferSize, NULL, GL_STATIC_DRAW);
-		GLuint* glIndexData = (GLuint*)glMapBuffer(GL_ELEMENT_ARRAY_BUFFER, GL_WRITE_ONLY);
-		if (glIndexData)
-		{
-			for (unsigned int i=0; i<indicesList.size(); ++i)
-			{
-				glIndexData[i] = indicesList[i];
-			}
-		}
-		glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
-	}
 }
@@ -1,11 +1,10 @@
 #ifndef QUADTREE_H
 #define QUADTREE_H
 
-#include "OpenGL/GLCamera.h"
-#include "OpenGL/Shaders/SolidShader.h"
 #include "adcData.h"
 #include "QuadtreeData.h"
 #include <vector>
+#include <algorithm>
 #include <math.h>
 
 #include "Quadtree/SearchTools/ClickSearch.h"
@@ -13,6 +12,7 @@
 #include "Quadtree/SearchTools/RectangleSearch.h"
 #include "Quadtree/SearchTools/PolygonSearch.h"
 #include "Quadtree/SearchTools/DepthSearch.h"
+#include "Quadtree/SearchTools/SampleSearch.h"
 
 /**
  * @brief This class provides a data structure that can be used to store a large number
@@ -39,6 +39,9 @@
  * if the nodal data is modified after the Quadtree is created and before a call to
  * Quadtree::FindNode() is performed.
  *
+ * The class has no Qt or OpenGL dependencies. The outlines of the branches and leaves
+ * are drawn by QuadtreeOutline.
+ *
  */
 class Quadtree
 {
@@ -49,10 +52,6 @@ class Quadtree
 		Quadtree(std::vector<Node> nodes, std::vector<Element> elements, int size, float minX, float maxX, float minY, float maxY);
 		~Quadtree();
 
-		/* Drawing Functions */
-		void	DrawOutlines();
-		void	SetCamera(GLCamera* newCam);
-
 		// Public Functions
 		Node*			FindNode(float x, float y);
 		Element*		FindElement(float x, float y);
@@ -60,8 +59,10 @@ class Quadtree
 		std::vector<Element*>	FindElementsInCircle(float x, float y, float radius);
 		std::vector<Element*>	FindElementsInRectangle(float l, float r, float b, float t);
 		std::vector<Element*>	FindElementsInPolygon(std::vector<Point> polyLine);
+		std::vector<Node*>	SampleNodesInRectangle(float l, float r, float b, float t, float spacing);
 		std::vector<std::vector<Element*> *> GetElementsThroughDepth(int depth);
 		std::vector<std::vector<Element*> *> GetElementsThroughDepth(int depth, float l, float r, float b, float t);
+		std::vector<Point>	GetOutlinePoints();
 
 	private:
 
@@ -80,6 +81,7 @@ class Quadtree
 		CircleSearch	circleSearch;
 		RectangleSearch	rectangleSearch;
 		DepthSearch	depthSearch;
+		SampleSearch	sampleSearch;
 
 		/* Quadtree Building Methods */
 		leaf*	newLeaf(float l, float r, float b, float t);
@@ -90,23 +92,12 @@ class Quadtree
 		void	addElement(Element *currElement, branch *currBranch);
 		bool	nodeIsInside(Node *currNode, leaf *currLeaf);
 		bool	nodeIsInside(Node *currNode, branch *currBranch);
+		bool	elementOverlaps(Element *currElement, leaf *currLeaf);
+		bool	elementOverlaps(Element *currElement, branch *currBranch);
 
-		/* Outline Drawing Variables */
-		bool	glLoaded;
-		int	pointCount;
-		GLuint	VAOId;
-		GLuint	VBOId;
-		GLuint	IBOId;
-		SolidShader*	outlineShader;
-		GLCamera*	camera;
-
-		/* Outline Drawing Methods */
-		void			InitializeGL();
-		std::vector<Point>	BuildOutlinesList();
-		std::vector<GLuint>	BuildOutlinesIndices();
-		void			AddOutlinePoints(branch *currBranch, std::vector<Point> *pointsList);
-		void			AddOutlinePoints(leaf *currLeaf, std::vector<Point> *pointsList);
-		void			LoadOutlinesToGPU(std::vector<Point> pointsList, std::vector<GLuint> indicesList);
+		/* Outline Methods */
+		void	AddOutlinePoints(branch *currBranch, std::vector<Point> *pointsList);
+		void	AddOutlinePoints(leaf *currLeaf, std::vector<Point> *pointsList);
 };
 
 #endif // QUADTREE_H
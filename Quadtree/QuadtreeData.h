@@ -11,6 +11,7 @@ struct leaf
 		float			bounds[4];	/**< Defines the x-y boundaries of the rectangular leaf */
 		std::vector<Node*>	nodes;		/**< A list of pointers to the Nodes in the leaf */
 		std::vector<Element*>	elements;	/**< A list of pointers to the Elements in the leaf */
+		std::vector<Element*>	crossingElements;	/**< Elements that cross the leaf without having a Node in it */
 };
 
 
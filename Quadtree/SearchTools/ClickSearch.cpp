@@ -4,15 +4,30 @@ ClickSearch::ClickSearch()
 {
 	x = 0.0;
 	y = 0.0;
+	closestNode = 0;
+	closestDistance = 0.0;
 }
 
 
+/**
+ * @brief Finds the Node closest to a point
+ * @param root The highest level of the Quadtree to search
+ * @param x The x-coordinate of the point
+ * @param y The y-coordinate of the point
+ * @return The Node closest to the point
+ * @return 0 if the point is outside of the Quadtree or the Quadtree has no Nodes
+ */
 Node* ClickSearch::FindNode(branch *root, float x, float y)
 {
 	this->x = x;
 	this->y = y;
+	closestNode = 0;
+	closestDistance = 0.0;
 
-	return SearchNodes(root);
+	if (root && PointIsInsideSquare(root))
+		SearchNodes(root);
+
+	return closestNode;
 }
 
 
@@ -25,60 +40,52 @@ Element* ClickSearch::FindElement(branch *root, float x, float y)
 }
 
 
-Node* ClickSearch::SearchNodes(branch *currBranch)
+/**
+ * @brief Recursively searches through the branch for a Node closer than the closest one so far
+ *
+ * Recursively searches through the branch for a Node closer than the closest one so far.
+ * The part of the branch that holds the point is searched first, then every other part
+ * that could hold a closer Node.
+ *
+ * @param currBranch The branch to search
+ */
+void ClickSearch::SearchNodes(branch *currBranch)
 {
-	if (PointIsInsideSquare(currBranch))
+	for (int i=0; i<4; ++i)
 	{
-		for (int i=0; i<4; ++i)
-		{
-			if (currBranch->branches[i])
-			{
-				Node *result = SearchNodes(currBranch->branches[i]);
-				if (result)
-				{
-					return result;
-				}
-			}
-			if (currBranch->leaves[i])
-			{
-				Node *result = SearchNodes(currBranch->leaves[i]);
-				if (result)
-				{
-					return result;
-				}
-			}
-		}
+		if (currBranch->branches[i] && PointIsInsideSquare(currBranch->branches[i]))
+			SearchNodes(currBranch->branches[i]);
+		else if (currBranch->leaves[i] && PointIsInsideSquare(currBranch->leaves[i]))
+			SearchNodes(currBranch->leaves[i]);
+	}
+
+	for (int i=0; i<4; ++i)
+	{
+		if (currBranch->branches[i] && !PointIsInsideSquare(currBranch->branches[i]) &&
+		    IsCloserThanClosestNode(currBranch->branches[i]))
+			SearchNodes(currBranch->branches[i]);
+		else if (currBranch->leaves[i] && !PointIsInsideSquare(currBranch->leaves[i]) &&
+			 IsCloserThanClosestNode(currBranch->leaves[i]))
+			SearchNodes(currBranch->leaves[i]);
 	}
-	return 0;
 }
 
 
-Node* ClickSearch::SearchNodes(leaf *currLeaf)
+/**
+ * @brief Checks each Node in the leaf against the closest one so far
+ * @param currLeaf The leaf to search
+ */
+void ClickSearch::SearchNodes(leaf *currLeaf)
 {
-	if (PointIsInsideSquare(currLeaf))
+	for (std::vector<Node*>::iterator it = currLeaf->nodes.begin(); it != currLeaf->nodes.end(); ++it)
 	{
-		bool itStarted = false;
-		Node *currClosest = 0;
-		float recordDistance = 0.0;
-		float currentDistance = 0.0;
-		for (std::vector<Node*>::iterator it = currLeaf->nodes.begin(); it != currLeaf->nodes.end(); ++it)
+		float currentDistance = Distance(*it);
+		if (!closestNode || currentDistance < closestDistance)
 		{
-			if (!itStarted)
-			{
-				itStarted = true;
-				currClosest = *it;
-				recordDistance = Distance(*it);
-			} else {
-				currentDistance = Distance(*it);
-				if (currentDistance < recordDistance)
-				{
-					currClosest = *it;
-				}
-			}
+			closestNode = *it;
+			closestDistance = currentDistance;
 		}
-		return currClosest;
 	}
-	return 0;
 }
 
 
@@ -121,6 +128,13 @@ Element* ClickSearch::SearchElements(leaf *currLeaf)
 				return *it;
 			}
 		}
+		for (std::vector<Element*>::iterator it = currLeaf->crossingElements.begin(); it != currLeaf->crossingElements.end(); ++it)
+		{
+			if (PointIsInsideElement(*it))
+			{
+				return *it;
+			}
+		}
 	}
 	return 0;
 }
@@ -170,7 +184,9 @@ bool ClickSearch::PointIsInsideSquare(leaf *currLeaf)
  * @brief Determines if the point is inside of an Element
  *
  * Determines if the point is inside of an Element using
- * barycentric coordinates.
+ * barycentric coordinates. A point on an edge is inside of
+ * the Element, so a point on the edge between two Elements
+ * is not missed.
  *
  * @param currElement The Element to test
  * @return true if the point falls inside of the Element
@@ -186,12 +202,42 @@ bool ClickSearch::PointIsInsideElement(Element *currElement)
 	float c = (n1->normX - n3->normX)*(y - n3->normY) - (x - n3->normX)*(n1->normY - n3->normY);
 
 
-	if ((a > 0 && b > 0 && c > 0) || (a < 0 && b < 0 && c < 0))
+	if ((a >= 0 && b >= 0 && c >= 0) || (a <= 0 && b <= 0 && c <= 0))
 		return true;
 	return false;
 }
 
 
+/**
+ * @brief Determines if any part of a branch is closer to the point than the closest Node so far
+ * @param currBranch The branch to test
+ * @return true if the branch could hold a closer Node
+ */
+bool ClickSearch::IsCloserThanClosestNode(branch *currBranch)
+{
+	if (!closestNode)
+		return true;
+	float dx = std::max(std::max(currBranch->bounds[0] - x, x - currBranch->bounds[1]), 0.0f);
+	float dy = std::max(std::max(currBranch->bounds[2] - y, y - currBranch->bounds[3]), 0.0f);
+	return sqrt(dx*dx + dy*dy) < closestDistance;
+}
+
+
+/**
+ * @brief Determines if any part of a leaf is closer to the point than the closest Node so far
+ * @param currLeaf The leaf to test
+ * @return true if the leaf could hold a closer Node
+ */
+bool ClickSearch::IsCloserThanClosestNode(leaf *currLeaf)
+{
+	if (!closestNode)
+		return true;
+	float dx = std::max(std::max(currLeaf->bounds[0] - x, x - currLeaf->bounds[1]), 0.0f);
+	float dy = std::max(std::max(currLeaf->bounds[2] - y, y - currLeaf->bounds[3]), 0.0f);
+	return sqrt(dx*dx + dy*dy) < closestDistance;
+}
+
+
 /**
  * @brief Calculates the distance between the point and a Node
  *
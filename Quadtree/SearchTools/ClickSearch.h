@@ -2,10 +2,22 @@
 #define CLICKSEARCH_H
 
 #include <math.h>
+#include <algorithm>
 
 #include "adcData.h"
 #include "Quadtree/QuadtreeData.h"
 
+
+/**
+ * @brief A tool used to search a Quadtree for the Node closest to a point, or the Element
+ * that contains it
+ *
+ * A tool used to search a Quadtree for the Node closest to a point, or the Element that
+ * contains it. The closest Node is searched for in the leaf that holds the point first,
+ * and then in any other leaf that is closer to the point than the closest Node found so
+ * far, since the closest Node is often in a neighbouring leaf.
+ *
+ */
 class ClickSearch
 {
 	public:
@@ -20,9 +32,13 @@ class ClickSearch
 		float	x;
 		float	y;
 
+		/* The closest Node found so far */
+		Node*	closestNode;
+		float	closestDistance;
+
 		/* Search Functions */
-		Node*		SearchNodes(branch *currBranch);
-		Node*		SearchNodes(leaf *currLeaf);
+		void		SearchNodes(branch *currBranch);
+		void		SearchNodes(leaf *currLeaf);
 		Element*	SearchElements(branch *currBranch);
 		Element*	SearchElements(leaf *currLeaf);
 
@@ -30,6 +46,8 @@ class ClickSearch
 		bool	PointIsInsideSquare(branch *currBranch);
 		bool	PointIsInsideSquare(leaf *currLeaf);
 		bool	PointIsInsideElement(Element* currElement);
+		bool	IsCloserThanClosestNode(branch *currBranch);
+		bool	IsCloserThanClosestNode(leaf *currLeaf);
 		float	Distance(Node *currNode);
 		float	Distance(Element *currElement);
 };
@@ -70,7 +70,7 @@ std::vector<Element*> PolygonSearch::FindElements(branch *root, std::vector<Poin
 void PolygonSearch::SearchNodes(branch *currBranch)
 {
 	int branchCornersInsidePolygon = CountCornersInsidePolygon(currBranch);
-	if (branchCornersInsidePolygon == 4)
+	if (branchCornersInsidePolygon == 4 && SquareIsInsidePolygon(currBranch))
 	{
 		AddToFullNodes(currBranch);
 	}
@@ -105,7 +105,7 @@ void PolygonSearch::SearchNodes(branch *currBranch)
 void PolygonSearch::SearchNodes(leaf *currLeaf)
 {
 	int leafCornersInsidePolygon = CountCornersInsidePolygon(currLeaf);
-	if (leafCornersInsidePolygon == 4)
+	if (leafCornersInsidePolygon == 4 && SquareIsInsidePolygon(currLeaf))
 	{
 		AddToFullNodes(currLeaf);
 	}
@@ -131,7 +131,7 @@ void PolygonSearch::SearchElements(branch *currBranch)
 {
 
 	int branchCornersInsidePolygon = CountCornersInsidePolygon(currBranch);
-	if (branchCornersInsidePolygon == 4)
+	if (branchCornersInsidePolygon == 4 && SquareIsInsidePolygon(currBranch))
 	{
 		AddToFullElements(currBranch);
 	}
@@ -167,7 +167,7 @@ void PolygonSearch::SearchElements(branch *currBranch)
 void PolygonSearch::SearchElements(leaf *currLeaf)
 {
 	int leafCornersInsidePolygon = CountCornersInsidePolygon(currLeaf);
-	if (leafCornersInsidePolygon == 4)
+	if (leafCornersInsidePolygon == 4 && SquareIsInsidePolygon(currLeaf))
 	{
 		AddToFullElements(currLeaf);
 	}
@@ -260,6 +260,38 @@ int PolygonSearch::CountCornersInsidePolygon(leaf *currLeaf)
 }
 
 
+/**
+ * @brief Determines if all of a branch is inside of the polygon
+ *
+ * Determines if all of a branch is inside of the polygon, once all four of its corners
+ * are known to be. A polygon that is not convex can still cut into the branch between
+ * its corners, which means it has a point inside of the branch or an edge that crosses
+ * the edges of the branch.
+ *
+ * @param currBranch The branch to test
+ * @return true if no part of the polygon cuts into the branch
+ */
+bool PolygonSearch::SquareIsInsidePolygon(branch *currBranch)
+{
+	return !PolygonHasPointsInside(currBranch) && !PolygonHasEdgeIntersection(currBranch);
+}
+
+
+/**
+ * @brief Determines if all of a leaf is inside of the polygon
+ *
+ * Determines if all of a leaf is inside of the polygon, once all four of its corners
+ * are known to be.
+ *
+ * @param currLeaf The leaf to test
+ * @return true if no part of the polygon cuts into the leaf
+ */
+bool PolygonSearch::SquareIsInsidePolygon(leaf *currLeaf)
+{
+	return !PolygonHasPointsInside(currLeaf) && !PolygonHasEdgeIntersection(currLeaf);
+}
+
+
 /**
  * @brief Determines if any of the polygon points are inside of a branch
  *
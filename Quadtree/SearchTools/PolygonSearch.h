@@ -36,6 +36,9 @@ class PolygonSearch
 		int	CountCornersInsidePolygon(branch *currBranch);
 		int	CountCornersInsidePolygon(leaf *currLeaf);
 
+		bool	SquareIsInsidePolygon(branch *currBranch);
+		bool	SquareIsInsidePolygon(leaf *currLeaf);
+
 		bool	PolygonHasPointsInside(branch *currBranch);
 		bool	PolygonHasPointsInside(leaf *currLeaf);
 		bool	PolygonHasEdgeIntersection(branch *currBranch);
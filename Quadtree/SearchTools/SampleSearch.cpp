@@ -0,0 +1,137 @@
+#include "SampleSearch.h"
+
+
+/**
+ * @brief Constructor
+ */
+SampleSearch::SampleSearch()
+{
+	l = 0.0;
+	r = 0.0;
+	b = 0.0;
+	t = 0.0;
+	spacing = 0.0;
+	cellsWide = 0;
+	cellsHigh = 0;
+}
+
+
+/**
+ * @brief Finds an evenly spaced sample of the Nodes that fall within a rectangle
+ *
+ * Finds an evenly spaced sample of the Nodes that fall within a rectangle, with at most
+ * one Node in each spacing by spacing cell. If the spacing would create more than
+ * SAMPLE_MAX_CELLS cells, it is increased.
+ *
+ * @param root The highest level of the Quadtree to search
+ * @param l The left bound of the rectangle
+ * @param r The right bound of the rectangle
+ * @param b The bottom bound of the rectangle
+ * @param t The top bound of the rectangle
+ * @param spacing The width of each cell
+ * @return A list of the sampled Nodes
+ */
+std::vector<Node*> SampleSearch::FindNodes(branch *root, float l, float r, float b, float t, float spacing)
+{
+	sampledNodes.clear();
+	if (!root || r <= l || t <= b || spacing <= 0.0)
+		return sampledNodes;
+
+	this->l = l;
+	this->r = r;
+	this->b = b;
+	this->t = t;
+	this->spacing = spacing;
+
+	while ((double)((r-l)/this->spacing + 1.0)*((t-b)/this->spacing + 1.0) > SAMPLE_MAX_CELLS)
+		this->spacing *= 2.0;
+
+	cellsWide = (unsigned int)((r-l)/this->spacing) + 1;
+	cellsHigh = (unsigned int)((t-b)/this->spacing) + 1;
+	occupiedCells.assign(cellsWide*cellsHigh, false);
+
+	SearchNodes(root);
+
+	return sampledNodes;
+}
+
+
+/**
+ * @brief Recursively searches through the branch for Nodes in empty cells
+ * @param currBranch The branch through which recursion will take place
+ */
+void SampleSearch::SearchNodes(branch *currBranch)
+{
+	if (!SquareIntersectsRectangle(currBranch->bounds) || SquareIsInOccupiedCell(currBranch->bounds))
+		return;
+
+	for (int i=0; i<4; ++i)
+	{
+		if (currBranch->branches[i])
+		{
+			SearchNodes(currBranch->branches[i]);
+		}
+		if (currBranch->leaves[i])
+		{
+			SearchNodes(currBranch->leaves[i]);
+		}
+	}
+}
+
+
+/**
+ * @brief Takes the first Node of each empty cell from the leaf
+ * @param currLeaf The leaf to search
+ */
+void SampleSearch::SearchNodes(leaf *currLeaf)
+{
+	if (!SquareIntersectsRectangle(currLeaf->bounds) || SquareIsInOccupiedCell(currLeaf->bounds))
+		return;
+
+	for (std::vector<Node*>::iterator it = currLeaf->nodes.begin(); it != currLeaf->nodes.end(); ++it)
+	{
+		Node *currNode = *it;
+		if (currNode->normX < l || currNode->normX > r || currNode->normY < b || currNode->normY > t)
+			continue;
+
+		unsigned int cell = CellIndex(currNode->normX, currNode->normY);
+		if (!occupiedCells[cell])
+		{
+			occupiedCells[cell] = true;
+			sampledNodes.push_back(currNode);
+		}
+	}
+}
+
+
+bool SampleSearch::SquareIntersectsRectangle(float *bounds)
+{
+	return bounds[0] <= r && bounds[1] >= l && bounds[2] <= t && bounds[3] >= b;
+}
+
+
+/**
+ * @brief Determines if a square lies entirely inside a single cell that already has a Node
+ * @param bounds The bounds of the square
+ * @return true if the square can be skipped
+ */
+bool SampleSearch::SquareIsInOccupiedCell(float *bounds)
+{
+	if (bounds[0] < l || bounds[1] > r || bounds[2] < b || bounds[3] > t)
+		return false;
+
+	unsigned int cell = CellIndex(bounds[0], bounds[2]);
+	return cell == CellIndex(bounds[1], bounds[3]) && occupiedCells[cell];
+}
+
+
+unsigned int SampleSearch::CellIndex(float x, float y)
+{
+	unsigned int cellX = (unsigned int)((x - l)/spacing);
+	unsigned int cellY = (unsigned int)((y - b)/spacing);
+	if (cellX >= cellsWide)
+		cellX = cellsWide-1;
+	if (cellY >= cellsHigh)
+		cellY = cellsHigh-1;
+	return cellY*cellsWide + cellX;
+}
@@ -0,0 +1,51 @@
+#ifndef SAMPLESEARCH_H
+#define SAMPLESEARCH_H
+
+#include <vector>
+
+#include "adcData.h"
+#include "Quadtree/QuadtreeData.h"
+
+#define SAMPLE_MAX_CELLS	4194304
+
+/**
+ * @brief A tool used to search a Quadtree for an evenly spaced sample of the Nodes inside a rectangle
+ *
+ * The rectangle is divided into square cells and at most one Node is taken from each
+ * cell. Any branch or leaf that lies entirely inside a cell that already has a Node is
+ * skipped without being searched, so the cost of the search depends on the number of
+ * cells rather than the number of Nodes in the rectangle.
+ *
+ */
+class SampleSearch
+{
+	public:
+
+		SampleSearch();
+
+		std::vector<Node*>	FindNodes(branch *root, float l, float r, float b, float t, float spacing);
+
+	private:
+
+		float l;	/**< The left bound of the rectangle */
+		float r;	/**< The right bound of the rectangle */
+		float b;	/**< The bottom bound of the rectangle */
+		float t;	/**< The top bound of the rectangle */
+		float spacing;	/**< The width of each cell */
+
+		unsigned int		cellsWide;	/**< The number of cells across the rectangle */
+		unsigned int		cellsHigh;	/**< The number of cells up the rectangle */
+		std::vector<bool>	occupiedCells;	/**< Flags that show which cells already have a Node */
+		std::vector<Node*>	sampledNodes;	/**< The list of sampled Nodes */
+
+		/* Search Functions */
+		void	SearchNodes(branch *currBranch);
+		void	SearchNodes(leaf *currLeaf);
+
+		/* Helper Functions */
+		bool	SquareIntersectsRectangle(float *bounds);
+		bool	SquareIsInOccupiedCell(float *bounds);
+		unsigned int	CellIndex(float x, float y);
+};
+
+#endif // SAMPLESEARCH_H
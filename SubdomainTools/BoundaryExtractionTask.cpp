@@ -0,0 +1,94 @@
+#include "BoundaryExtractionTask.h"
+
+
+/**
+ * @brief Constructor that records everything the task needs from the subdomain
+ *
+ * Constructor that records everything the task needs from the subdomain, so
+ * that run() does not need to call into the Domain from a worker thread.
+ *
+ * @param newSubdomain The subdomain files
+ */
+BoundaryExtractionTask::BoundaryExtractionTask(SubdomainFiles newSubdomain)
+{
+	succeeded = false;
+	usedCache = false;
+
+	domainPath = newSubdomain.domainPath;
+	fort14Path = newSubdomain.fort14Location;
+	py140Path = newSubdomain.py140Location;
+}
+
+
+void BoundaryExtractionTask::run()
+{
+	BoundaryCache cache (domainPath, fort14Path, py140Path);
+	if (cache.Read(innerBoundaryNodes, outerBoundaryNodes))
+	{
+		usedCache = true;
+		succeeded = true;
+		return;
+	}
+
+	std::string infoLine;
+	std::vector<Node> readNodes;
+	std::vector<Element> readElements;
+	std::vector<unsigned int> boundaryNodes;
+	Fort14 fort14 (fort14Path.toStdString());
+	if (fort14Path.isEmpty() || !fort14.ReadFile(infoLine, readNodes, readElements, boundaryNodes) || readElements.size() == 0)
+	{
+		std::cout << "WARNING: Unable to read the mesh of the subdomain at " << domainPath.toStdString().data() << std::endl;
+		return;
+	}
+
+	BoundaryFinder boundaryFinder;
+	Boundaries currBoundaries = boundaryFinder.FindAllBoundaries(&readElements);
+
+	Py140 currPy140 (py140Path);
+	innerBoundaryNodes = currPy140.ConvertNewToOld(std::vector<unsigned int>(currBoundaries.innerBoundaryNodes.begin(),
+										 currBoundaries.innerBoundaryNodes.end()));
+	outerBoundaryNodes = currPy140.ConvertNewToOld(std::vector<unsigned int>(currBoundaries.outerBoundaryNodes.begin(),
+										 currBoundaries.outerBoundaryNodes.end()));
+	SortNodes(innerBoundaryNodes);
+	SortNodes(outerBoundaryNodes);
+
+	if (!cache.Write(innerBoundaryNodes, outerBoundaryNodes))
+		std::cout << "WARNING: Unable to write boundary node cache " << cache.GetCachePath().toStdString().data() << std::endl;
+
+	succeeded = true;
+}
+
+
+bool BoundaryExtractionTask::Succeeded()
+{
+	return succeeded;
+}
+
+
+bool BoundaryExtractionTask::UsedCache()
+{
+	return usedCache;
+}
+
+
+std::vector<unsigned int> BoundaryExtractionTask::GetInnerBoundaryNodes()
+{
+	return innerBoundaryNodes;
+}
+
+
+std::vector<unsigned int> BoundaryExtractionTask::GetOuterBoundaryNodes()
+{
+	return outerBoundaryNodes;
+}
+
+
+/**
+ * @brief Sorts a list of full domain node numbers and removes any repeats
+ * @param nodes The node numbers
+ */
+void BoundaryExtractionTask::SortNodes(std::vector<unsigned int> &nodes)
+{
+	std::sort(nodes.begin(), nodes.end());
+	nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+}
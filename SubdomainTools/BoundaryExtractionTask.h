@@ -0,0 +1,59 @@
+#ifndef BOUNDARYEXTRACTIONTASK_H
+#define BOUNDARYEXTRACTIONTASK_H
+
+#include <vector>
+#include <algorithm>
+#include <iostream>
+
+#include <QRunnable>
+#include <QString>
+
+#include "SubdomainTools/BoundaryFinder.h"
+#include "Projects/IO/FileIO/SubdomainFiles.h"
+#include "Projects/IO/FileIO/Fort14.h"
+#include "Projects/IO/FileIO/Py140.h"
+#include "Projects/IO/FileIO/BoundaryCache.h"
+
+
+/**
+ * @brief Finds the inner and outer boundary nodes of a single subdomain
+ *
+ * Finds the inner and outer boundary nodes of a single subdomain, in full domain
+ * node numbers. The results are read from the subdomain's BoundaryCache when it is
+ * still valid. Otherwise they are found with a BoundaryFinder, converted through
+ * py.140, and written to the cache. The subdomain fort.14 is read by the task, since
+ * a loaded Domain may be unloaded while the task runs.
+ *
+ * Each task only reads its own subdomain, so the tasks for all subdomains can be run
+ * at the same time on the TaskScheduler. Auto deletion is turned off so the results
+ * can be collected once the tasks are done.
+ *
+ */
+class BoundaryExtractionTask : public QRunnable
+{
+	public:
+		BoundaryExtractionTask(SubdomainFiles newSubdomain);
+
+		void	run();
+
+		bool				Succeeded();
+		bool				UsedCache();
+		std::vector<unsigned int>	GetInnerBoundaryNodes();
+		std::vector<unsigned int>	GetOuterBoundaryNodes();
+
+	private:
+
+		QString	domainPath;
+		QString	fort14Path;
+		QString	py140Path;
+
+		bool	succeeded;
+		bool	usedCache;
+
+		std::vector<unsigned int>	innerBoundaryNodes;	/**< Sorted, in full domain node numbers */
+		std::vector<unsigned int>	outerBoundaryNodes;	/**< Sorted, in full domain node numbers */
+
+		static void	SortNodes(std::vector<unsigned int> &nodes);
+};
+
+#endif // BOUNDARYEXTRACTIONTASK_H
@@ -13,11 +13,17 @@ BoundaryFinder::~BoundaryFinder()
 
 
 std::vector<unsigned int> BoundaryFinder::FindBoundaries(ElementState *elementSelection)
+{
+	return FindBoundaries(elementSelection->GetState());
+}
+
+
+std::vector<unsigned int> BoundaryFinder::FindBoundaries(std::vector<Element*> *elements)
 {
 	edgesMap.clear();
 	nodeAdjacency.clear();
 	edgesList.clear();
-	FindEdges(elementSelection->GetState());
+	FindEdges(elements);
 	CreateEdgesList();
 	return edgesList;
 }
@@ -51,6 +51,7 @@ class BoundaryFinder
 
 		/* The Callable Search Function */
 		std::vector<unsigned int> FindBoundaries(ElementState* elementSelection);
+		std::vector<unsigned int> FindBoundaries(std::vector<Element*>* elements);
 		std::vector<unsigned int> FindInnerBoundaries(ElementState* elementSelection);
 		Boundaries	FindAllBoundaries(std::vector<Element> *elements);
 
@@ -0,0 +1,167 @@
+#include "SubdomainDefinition.h"
+
+SubdomainDefinition::SubdomainDefinition()
+{
+
+}
+
+
+/**
+ * @brief Reads the shapes from a subdomain definition file
+ * @param filePath The definition file
+ * @return true if the file was read and has at least one shape
+ * @return false otherwise, see GetErrorMessage()
+ */
+bool SubdomainDefinition::ReadFile(std::string filePath)
+{
+	shapes.clear();
+	errorMessage = "";
+
+	std::ifstream file (filePath.data());
+	if (!file.is_open())
+	{
+		errorMessage = "Unable to open " + filePath;
+		return false;
+	}
+
+	std::string line;
+	unsigned int lineNumber = 0;
+	while (std::getline(file, line))
+	{
+		++lineNumber;
+		if (!ParseLine(line, lineNumber))
+			return false;
+	}
+	file.close();
+
+	if (shapes.size() == 0)
+	{
+		errorMessage = "No shapes in " + filePath;
+		return false;
+	}
+	return true;
+}
+
+
+/**
+ * @brief Selects every Element that is inside at least one of the shapes
+ *
+ * Selects every Element that is inside at least one of the shapes. Elements that
+ * are inside more than one shape are only selected once, in the order they were
+ * first found.
+ *
+ * @param quadtree The Quadtree of the full domain, built on the normalized coordinates
+ * @param normalizer The normalizer the coordinates were calculated with
+ * @return The selected Elements, which point into the Quadtree
+ */
+std::vector<Element*> SubdomainDefinition::SelectElements(Quadtree *quadtree, MeshNormalizer *normalizer)
+{
+	std::vector<Element*> selectedElements;
+	if (!quadtree || !normalizer)
+		return selectedElements;
+
+	std::set<unsigned int> selectedNumbers;
+	for (std::vector<DefinitionShape>::iterator it = shapes.begin(); it != shapes.end(); ++it)
+	{
+		std::vector<Point> normPoints;
+		for (std::vector<Point>::iterator pt = it->points.begin(); pt != it->points.end(); ++pt)
+			normPoints.push_back(Point(normalizer->NormalizeX(pt->x), normalizer->NormalizeY(pt->y)));
+
+		std::vector<Element*> shapeElements;
+		if (it->type == CircleToolType)
+			shapeElements = quadtree->FindElementsInCircle(normPoints[0].x, normPoints[0].y, normalizer->NormalizeDistance(it->radius));
+		else if (it->type == RectangleToolType)
+			shapeElements = quadtree->FindElementsInRectangle(normPoints[0].x, normPoints[1].x, normPoints[0].y, normPoints[1].y);
+		else if (it->type == PolygonToolType)
+			shapeElements = quadtree->FindElementsInPolygon(normPoints);
+
+		for (std::vector<Element*>::iterator elem = shapeElements.begin(); elem != shapeElements.end(); ++elem)
+			if (*elem && selectedNumbers.insert((*elem)->elementNumber).second)
+				selectedElements.push_back(*elem);
+	}
+
+	return selectedElements;
+}
+
+
+unsigned int SubdomainDefinition::GetNumShapes()
+{
+	return shapes.size();
+}
+
+
+/**
+ * @brief Returns a description of why the last file could not be read
+ * @return The description
+ */
+std::string SubdomainDefinition::GetErrorMessage()
+{
+	return errorMessage;
+}
+
+
+/**
+ * @brief Reads the shape on a single line of a definition file
+ * @param line The line
+ * @param lineNumber The line number, for the error message
+ * @return true if the line held a shape or nothing
+ */
+bool SubdomainDefinition::ParseLine(const std::string &line, unsigned int lineNumber)
+{
+	std::stringstream stream (line);
+	std::string type;
+	if (!(stream >> type) || type[0] == '#')
+		return true;
+
+	std::vector<float> values;
+	float value;
+	while (stream >> value)
+		values.push_back(value);
+
+	std::stringstream lineName;
+	lineName << "line " << lineNumber;
+
+	DefinitionShape shape;
+	shape.radius = 0.0;
+	if (type == "circle")
+	{
+		if (values.size() != 3 || values[2] <= 0.0)
+		{
+			errorMessage = "A circle needs a center and a positive radius on " + lineName.str();
+			return false;
+		}
+		shape.type = CircleToolType;
+		shape.points.push_back(Point(values[0], values[1]));
+		shape.radius = values[2];
+	}
+	else if (type == "rectangle")
+	{
+		if (values.size() != 4 || values[0] >= values[1] || values[2] >= values[3])
+		{
+			errorMessage = "A rectangle needs left < right and bottom < top on " + lineName.str();
+			return false;
+		}
+		shape.type = RectangleToolType;
+		shape.points.push_back(Point(values[0], values[2]));
+		shape.points.push_back(Point(values[1], values[3]));
+	}
+	else if (type == "polygon")
+	{
+		if (values.size() < 6 || values.size() % 2 != 0)
+		{
+			errorMessage = "A polygon needs at least three x-y points on " + lineName.str();
+			return false;
+		}
+		shape.type = PolygonToolType;
+		for (unsigned int i=0; i+1<values.size(); i+=2)
+			shape.points.push_back(Point(values[i], values[i+1]));
+	}
+	else
+	{
+		errorMessage = "Unknown shape '" + type + "' on " + lineName.str();
+		return false;
+	}
+
+	shapes.push_back(shape);
+	return true;
+}
@@ -0,0 +1,64 @@
+#ifndef SUBDOMAINDEFINITION_H
+#define SUBDOMAINDEFINITION_H
+
+#include <vector>
+#include <set>
+#include <string>
+#include <fstream>
+#include <sstream>
+
+#include "adcData.h"
+#include "Quadtree/Quadtree.h"
+#include "Quadtree/MeshNormalizer.h"
+
+
+/**
+ * @brief A shape in a subdomain definition file
+ */
+struct DefinitionShape
+{
+		ToolType		type;
+		std::vector<Point>	points;		/**< The center of a circle, two corners of a rectangle, or the points of a polygon */
+		float			radius;		/**< The radius of a circle */
+};
+
+
+/**
+ * @brief Reads a subdomain definition file and selects its Elements from a Quadtree
+ *
+ * Reads a subdomain definition file and selects its Elements from a Quadtree, in
+ * the same way the circle, rectangle and polygon tools select them in the GUI.
+ * This is how subdomains are described to tools that run without a display.
+ *
+ * A definition file has one shape per line, in mesh coordinates. Blank lines and
+ * lines that start with # are skipped.
+ *
+ *     circle <x> <y> <radius>
+ *     rectangle <left> <right> <bottom> <top>
+ *     polygon <x1> <y1> <x2> <y2> <x3> <y3> ...
+ *
+ * The subdomain is every Element that is inside at least one of the shapes. A
+ * polygon is closed back to its first point.
+ *
+ */
+class SubdomainDefinition
+{
+	public:
+		SubdomainDefinition();
+
+		bool	ReadFile(std::string filePath);
+
+		std::vector<Element*>	SelectElements(Quadtree *quadtree, MeshNormalizer *normalizer);
+
+		unsigned int	GetNumShapes();
+		std::string	GetErrorMessage();
+
+	private:
+
+		std::vector<DefinitionShape>	shapes;
+		std::string			errorMessage;
+
+		bool	ParseLine(const std::string &line, unsigned int lineNumber);
+};
+
+#endif // SUBDOMAINDEFINITION_H
@@ -0,0 +1,322 @@
+#include "SubdomainExtractor.h"
+
+SubdomainExtractor::SubdomainExtractor()
+{
+	fullNumNodes = 0;
+	fullNumElements = 0;
+	subdomainName = "";
+}
+
+
+SubdomainExtractor::~SubdomainExtractor()
+{
+
+}
+
+
+void SubdomainExtractor::SetElements(std::vector<Element *> newElements)
+{
+	selectedElements = newElements;
+}
+
+
+void SubdomainExtractor::SetFullDomainSize(unsigned int newNumNodes, unsigned int newNumElements)
+{
+	fullNumNodes = newNumNodes;
+	fullNumElements = newNumElements;
+}
+
+
+/**
+ * @brief Sets the name written to the title line of the subdomain fort.14
+ * @param newName The subdomain name
+ */
+void SubdomainExtractor::SetSubdomainName(std::string newName)
+{
+	subdomainName = newName;
+}
+
+
+/**
+ * @brief Finds the Nodes, the boundary and the renumbering of the subdomain
+ *
+ * Finds the Nodes, the boundary and the renumbering of the subdomain. Elements or
+ * Nodes that are in the selection more than once are only numbered once, and their
+ * numbers can be listed with GetDuplicateNodes() and GetDuplicateElements().
+ *
+ */
+void SubdomainExtractor::Extract()
+{
+	selectedNodes.clear();
+	boundaryNodes.clear();
+	duplicateNodes.clear();
+	duplicateElements.clear();
+	oldToNewNodes.clear();
+	oldToNewElements.clear();
+
+	FindUniqueNodes();
+	FindBoundaryNodes();
+	MapOldToNewNodes();
+	MapOldToNewElements();
+}
+
+
+bool SubdomainExtractor::HasSufficientElements()
+{
+	return selectedElements.size() > 0;
+}
+
+
+bool SubdomainExtractor::HasSufficientNodes()
+{
+	return selectedNodes.size() > 2;
+}
+
+
+/**
+ * @brief Checks that the boundary of the subdomain is a single closed loop
+ * @return true if the boundary can be written to fort.14
+ */
+bool SubdomainExtractor::HasValidBoundary()
+{
+	return boundaryNodes.size() > 2 && boundaryNodes[0] == boundaryNodes[boundaryNodes.size()-1];
+}
+
+
+/**
+ * @brief Writes the subdomain fort.14 file
+ *
+ * Writes the subdomain fort.14 file, with the boundary as a single open boundary
+ * segment. The coordinates are copied as text from the full domain.
+ *
+ * @param filePath The file to write
+ * @return true if the file was written
+ */
+bool SubdomainExtractor::WriteFort14File(std::string filePath)
+{
+	// Open the file
+	std::ofstream fort14File;
+	fort14File.open(filePath.data());
+	if (fort14File.is_open())
+	{
+		// Write title line
+		fort14File << subdomainName << std::endl;
+
+		// Write info line
+		fort14File << selectedElements.size() << " " << selectedNodes.size() << std::endl;
+
+		// Write nodes
+		fort14File << std::setprecision(12);
+		Node *currNode = 0;
+		for (std::vector<Node*>::iterator it = selectedNodes.begin(); it != selectedNodes.end(); ++it)
+		{
+			currNode = *it;
+			if (currNode)
+			{
+				fort14File << "\t" <<
+					      oldToNewNodes[currNode->nodeNumber] << "\t" <<
+					      currNode->xDat << "\t" <<
+					      currNode->yDat << "\t" <<
+					      currNode->zDat <<
+					      std::endl;
+			}
+		}
+
+		// Write elements
+		Element *currElement = 0;
+		for (std::vector<Element*>::iterator it = selectedElements.begin(); it != selectedElements.end(); ++it)
+		{
+			currElement = *it;
+			if (currElement)
+			{
+				fort14File << oldToNewElements[currElement->elementNumber] << "\t3\t" <<
+					      oldToNewNodes[currElement->n1->nodeNumber] << "\t" <<
+					      oldToNewNodes[currElement->n2->nodeNumber] << "\t" <<
+					      oldToNewNodes[currElement->n3->nodeNumber] <<
+					      std::endl;
+			}
+		}
+
+		// Write boundaries
+		fort14File << "1\t!no. of open boundary segments" << std::endl;
+		fort14File << boundaryNodes.size()-1 << "\t!no. of open boundary nodes" << std::endl;
+		fort14File << boundaryNodes.size()-1 << std::endl;
+		for (std::vector<unsigned int>::iterator it = boundaryNodes.begin(); it != boundaryNodes.end(); ++it)
+		{
+			fort14File << oldToNewNodes[*it] << std::endl;
+		}
+		fort14File << "0\t!no. of land boundary segments" << std::endl;
+		fort14File << "0\t!no. of land boundary nodes" << std::endl;
+
+		// Close the file
+		fort14File.close();
+
+		return true;
+	} else {
+		return false;
+	}
+}
+
+
+/**
+ * @brief Writes the subdomain to full domain node mapping (py.140)
+ * @param filePath The file to write
+ * @return true if the file was written
+ */
+bool SubdomainExtractor::WritePy140File(std::string filePath)
+{
+	std::ofstream py140;
+	py140.open(filePath.data());
+	if (py140.is_open())
+	{
+		py140 << "new old " << fullNumNodes << std::endl;
+		if (oldToNewNodes.size() != 0)
+		{
+			for (std::map<unsigned int, unsigned int>::iterator it = oldToNewNodes.begin(); it != oldToNewNodes.end(); ++it)
+			{
+				py140 << it->second << " " << it->first << std::endl;
+			}
+		}
+		py140.close();
+		return true;
+	} else {
+		std::cout << "Unable to open " << filePath << std::endl;
+		return false;
+	}
+}
+
+
+/**
+ * @brief Writes the subdomain to full domain element mapping (py.141)
+ * @param filePath The file to write
+ * @return true if the file was written
+ */
+bool SubdomainExtractor::WritePy141File(std::string filePath)
+{
+	std::ofstream py141;
+	py141.open(filePath.data());
+	if (py141.is_open())
+	{
+		py141 << "new old " << fullNumElements << std::endl;
+		if (oldToNewElements.size() != 0)
+		{
+			for (std::map<unsigned int, unsigned int>::iterator it = oldToNewElements.begin(); it != oldToNewElements.end(); ++it)
+			{
+				py141 << it->second << " " << it->first << std::endl;
+			}
+		}
+		py141.close();
+		return true;
+	} else {
+		return false;
+	}
+}
+
+
+unsigned int SubdomainExtractor::GetNumNodes()
+{
+	return selectedNodes.size();
+}
+
+
+unsigned int SubdomainExtractor::GetNumElements()
+{
+	return selectedElements.size();
+}
+
+
+/**
+ * @brief Returns the full domain numbers of the boundary nodes
+ *
+ * Returns the full domain numbers of the boundary nodes, in order around the
+ * boundary. A valid boundary ends with the node it starts with.
+ *
+ * @return The boundary node numbers
+ */
+std::vector<unsigned int> SubdomainExtractor::GetBoundaryNodes()
+{
+	return boundaryNodes;
+}
+
+
+std::vector<unsigned int> SubdomainExtractor::GetDuplicateNodes()
+{
+	return duplicateNodes;
+}
+
+
+std::vector<unsigned int> SubdomainExtractor::GetDuplicateElements()
+{
+	return duplicateElements;
+}
+
+
+void SubdomainExtractor::FindUniqueNodes()
+{
+	// Make a list of all selected Nodes, include duplicates
+	selectedNodes.reserve(selectedElements.size()*3);
+	Element *currElement = 0;
+	for (std::vector<Element*>::iterator it = selectedElements.begin(); it != selectedElements.end(); ++it)
+	{
+		currElement = *it;
+		selectedNodes.push_back(currElement->n1);
+		selectedNodes.push_back(currElement->n2);
+		selectedNodes.push_back(currElement->n3);
+	}
+
+	// Now remove duplicates
+	std::sort(selectedNodes.begin(), selectedNodes.end());
+	std::vector<Node*>::iterator it = std::unique(selectedNodes.begin(), selectedNodes.end());
+	selectedNodes.resize(std::distance(selectedNodes.begin(), it));
+}
+
+
+void SubdomainExtractor::FindBoundaryNodes()
+{
+	if (selectedElements.size() > 0)
+	{
+		boundaryNodes = boundaryFinder.FindBoundaries(&selectedElements);
+	}
+}
+
+
+void SubdomainExtractor::MapOldToNewNodes()
+{
+	Node *currNode = 0;
+	unsigned int newNodeNumber = 1;
+	for (std::vector<Node*>::iterator it = selectedNodes.begin(); it != selectedNodes.end(); ++it)
+	{
+		currNode = *it;
+		if (currNode)
+		{
+			if (oldToNewNodes.count(currNode->nodeNumber) != 0)
+			{
+				duplicateNodes.push_back(currNode->nodeNumber);
+			} else {
+				oldToNewNodes[currNode->nodeNumber] = newNodeNumber;
+				++newNodeNumber;
+			}
+		}
+	}
+}
+
+
+void SubdomainExtractor::MapOldToNewElements()
+{
+	Element *currElement = 0;
+	unsigned int newElementNumber = 1;
+	for (std::vector<Element*>::iterator it = selectedElements.begin(); it != selectedElements.end(); ++it)
+	{
+		currElement = *it;
+		if (currElement)
+		{
+			if (oldToNewElements.count(currElement->elementNumber) != 0)
+			{
+				duplicateElements.push_back(currElement->elementNumber);
+			} else {
+				oldToNewElements[currElement->elementNumber] = newElementNumber;
+				++newElementNumber;
+			}
+		}
+	}
+}
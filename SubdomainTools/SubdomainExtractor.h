@@ -0,0 +1,81 @@
+#ifndef SUBDOMAINEXTRACTOR_H
+#define SUBDOMAINEXTRACTOR_H
+
+#include <vector>
+#include <map>
+#include <string>
+#include <fstream>
+#include <iomanip>
+#include <algorithm>
+
+#include "adcData.h"
+#include "SubdomainTools/BoundaryFinder.h"
+
+
+/**
+ * @brief Builds a subdomain from a set of full domain Elements and writes its files
+ *
+ * Builds a subdomain from a set of full domain Elements: the Nodes they use, the
+ * boundary around them and the renumbering of both, and writes the subdomain
+ * fort.14, py.140 and py.141 files. The class has no Qt or OpenGL dependencies.
+ * SubdomainCreator uses it for the selection made in the GUI, and asks the user
+ * for anything it needs.
+ *
+ * Usage:
+ * - Set the Elements and the size of the full domain
+ * - Call Extract(), then check that the subdomain is valid
+ * - Write each of the files
+ *
+ * The Elements point into the full domain mesh, which must not change until the
+ * files have been written.
+ *
+ */
+class SubdomainExtractor
+{
+	public:
+		SubdomainExtractor();
+		~SubdomainExtractor();
+
+		void	SetElements(std::vector<Element*> newElements);
+		void	SetFullDomainSize(unsigned int newNumNodes, unsigned int newNumElements);
+		void	SetSubdomainName(std::string newName);
+
+		void	Extract();
+
+		bool	HasSufficientElements();
+		bool	HasSufficientNodes();
+		bool	HasValidBoundary();
+
+		bool	WriteFort14File(std::string filePath);
+		bool	WritePy140File(std::string filePath);
+		bool	WritePy141File(std::string filePath);
+
+		unsigned int			GetNumNodes();
+		unsigned int			GetNumElements();
+		std::vector<unsigned int>	GetBoundaryNodes();
+		std::vector<unsigned int>	GetDuplicateNodes();
+		std::vector<unsigned int>	GetDuplicateElements();
+
+	private:
+
+		BoundaryFinder	boundaryFinder;
+		unsigned int	fullNumNodes;
+		unsigned int	fullNumElements;
+		std::string	subdomainName;
+
+		std::vector<Element*>		selectedElements;
+		std::vector<Node*>		selectedNodes;
+		std::vector<unsigned int>	boundaryNodes;
+		std::vector<unsigned int>	duplicateNodes;		/**< Node numbers that were in the selection more than once */
+		std::vector<unsigned int>	duplicateElements;	/**< Element numbers that were in the selection more than once */
+
+		std::map<unsigned int, unsigned int>	oldToNewNodes;
+		std::map<unsigned int, unsigned int>	oldToNewElements;
+
+		void	FindUniqueNodes();
+		void	FindBoundaryNodes();
+		void	MapOldToNewNodes();
+		void	MapOldToNewElements();
+};
+
+#endif // SUBDOMAINEXTRACTOR_H
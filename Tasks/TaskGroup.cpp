@@ -0,0 +1,71 @@
+#include "TaskGroup.h"
+#include "Tasks/TaskScheduler.h"
+
+TaskGroup::TaskGroup(QObject *parent) :
+	QObject(parent)
+{
+	numPending = 0;
+	cancelled = false;
+}
+
+
+/**
+ * @brief Drops the tasks that have not started and waits for the rest
+ */
+TaskGroup::~TaskGroup()
+{
+	TaskScheduler::Instance()->Cancel(this);
+	TaskScheduler::Instance()->Wait(this);
+}
+
+
+/**
+ * @brief Drops the tasks of the group that have not started
+ */
+void TaskGroup::Cancel()
+{
+	TaskScheduler::Instance()->Cancel(this);
+}
+
+
+/**
+ * @brief Waits for every task of the group, running queued ones on this thread
+ */
+void TaskGroup::Wait()
+{
+	TaskScheduler::Instance()->Wait(this);
+}
+
+
+/**
+ * @brief Checks if the group has been cancelled
+ *
+ * Checks if the group has been cancelled. Long tasks can call this now and then and
+ * return early.
+ *
+ * @return true if Cancel() has been called since the group was last started
+ */
+bool TaskGroup::IsCancelled()
+{
+	return TaskScheduler::Instance()->IsCancelled(this);
+}
+
+
+/**
+ * @brief Checks if any task of the group is queued or running
+ * @return true if the group has tasks that have not finished
+ */
+bool TaskGroup::IsRunning()
+{
+	return GetNumPending() > 0;
+}
+
+
+/**
+ * @brief Returns the number of tasks of the group that are queued or running
+ * @return The number of tasks
+ */
+int TaskGroup::GetNumPending()
+{
+	return TaskScheduler::Instance()->GetNumPending(this);
+}
@@ -0,0 +1,52 @@
+#ifndef TASKGROUP_H
+#define TASKGROUP_H
+
+#include <QObject>
+
+
+/**
+ * @brief A set of tasks on the TaskScheduler that can be waited on or cancelled together
+ *
+ * A set of tasks on the TaskScheduler that can be waited on or cancelled together.
+ * Every task started with the group counts towards it until it has run, and
+ * finished() is emitted once the last one is done, through the event loop of the
+ * thread the group lives in. This takes the place of connecting to the finished()
+ * signal of a QThread.
+ *
+ * Cancel() drops the tasks that have not started. A task that is already running
+ * finishes unless it checks IsCancelled(), or TaskScheduler::CurrentTaskCancelled()
+ * if it does not know its group, and returns early. A cancelled group can
+ * be used again once its running tasks are done.
+ *
+ * The group waits for its tasks when it is destroyed, so the objects they work on
+ * should be declared before it, or outlive it.
+ *
+ */
+class TaskGroup : public QObject
+{
+		Q_OBJECT
+	public:
+		TaskGroup(QObject *parent=0);
+		~TaskGroup();
+
+		void	Cancel();
+		void	Wait();
+
+		bool	IsCancelled();
+		bool	IsRunning();
+		int	GetNumPending();
+
+	private:
+
+		/* Guarded by the TaskScheduler */
+		int	numPending;	/**< Tasks that have been started with the group and have not finished */
+		bool	cancelled;
+
+		friend class TaskScheduler;
+
+	signals:
+
+		void	finished();	/**< Emitted when the last task of the group has finished or been cancelled */
+};
+
+#endif // TASKGROUP_H
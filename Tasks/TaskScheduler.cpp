@@ -0,0 +1,540 @@
+#include "TaskScheduler.h"
+
+
+/**
+ * @brief Runs a slot of a worker QObject as a task
+ *
+ * Runs a slot of a worker QObject as a task. The slot is called directly on the
+ * thread that runs the task, so the worker must not be deleted until the task's
+ * TaskGroup has finished.
+ *
+ */
+class MethodTask : public QRunnable
+{
+	public:
+		MethodTask(QObject *newWorker, const char *newMethod) :
+			worker(newWorker),
+			method(newMethod)
+		{
+		}
+
+		void run()
+		{
+			if (!QMetaObject::invokeMethod(worker, method.constData(), Qt::DirectConnection))
+				qWarning("TaskScheduler: unable to call %s", method.constData());
+		}
+
+	private:
+
+		QObject*	worker;
+		QByteArray	method;
+};
+
+
+TaskWorker::TaskWorker(TaskScheduler *newScheduler) :
+	QThread(),
+	scheduler(newScheduler)
+{
+}
+
+
+void TaskWorker::run()
+{
+	scheduler->WorkerLoop(this);
+}
+
+
+/**
+ * @brief Starts one thread per core
+ */
+TaskScheduler::TaskScheduler()
+{
+	numQueued = 0;
+	stopping = false;
+
+	int numThreads = QThread::idealThreadCount() > 0 ? QThread::idealThreadCount() : 2;
+	for (int i=0; i<numThreads; ++i)
+		workers.push_back(new TaskWorker(this));
+	for (std::vector<TaskWorker*>::iterator it = workers.begin(); it != workers.end(); ++it)
+		(*it)->start();
+}
+
+
+/**
+ * @brief Drops every queued task and stops the threads once their current tasks are done
+ */
+TaskScheduler::~TaskScheduler()
+{
+	std::vector<ScheduledTask> removed;
+	mutex.lock();
+	stopping = true;
+	for (int i=0; i<TASK_NUM_PRIORITIES; ++i)
+		RemoveGroup(queues[i], 0, removed);
+	workAvailable.wakeAll();
+	stateChanged.wakeAll();
+	mutex.unlock();
+
+	for (std::vector<TaskWorker*>::iterator it = workers.begin(); it != workers.end(); ++it)
+		(*it)->wait();
+
+	for (std::vector<TaskWorker*>::iterator it = workers.begin(); it != workers.end(); ++it)
+	{
+		RemoveGroup((*it)->localTasks, 0, removed);
+		delete *it;
+	}
+	workers.clear();
+
+	for (std::vector<ScheduledTask>::iterator it = removed.begin(); it != removed.end(); ++it)
+		if (it->runnable->autoDelete())
+			delete it->runnable;
+}
+
+
+/**
+ * @brief Returns the scheduler, starting it the first time it is used
+ * @return The scheduler of the process
+ */
+TaskScheduler* TaskScheduler::Instance()
+{
+	static TaskScheduler scheduler;
+	return &scheduler;
+}
+
+
+/**
+ * @brief Queues a task
+ *
+ * Queues a task. A task started from one of the scheduler's own threads goes on the
+ * local queue of that thread and keeps the priority of the task that started it.
+ * The runnable is deleted once it has run if its autoDelete() is set.
+ *
+ * @param runnable The task
+ * @param priority One of the TASK_PRIORITY_ values
+ * @param group The group the task counts towards, or 0
+ */
+void TaskScheduler::Start(QRunnable *runnable, int priority, TaskGroup *group)
+{
+	if (!runnable)
+		return;
+
+	if (priority < TASK_PRIORITY_LOW)
+		priority = TASK_PRIORITY_LOW;
+	if (priority > TASK_PRIORITY_HIGH)
+		priority = TASK_PRIORITY_HIGH;
+
+	ScheduledTask task;
+	task.runnable = runnable;
+	task.group = group;
+	task.priority = priority;
+
+	TaskWorker *worker = CurrentWorker();
+
+	mutex.lock();
+	if (stopping)
+	{
+		mutex.unlock();
+		if (runnable->autoDelete())
+			delete runnable;
+		return;
+	}
+	if (group)
+	{
+		if (group->numPending == 0)
+			group->cancelled = false;
+		++group->numPending;
+	}
+	if (!worker)
+		queues[priority].push_back(task);
+	mutex.unlock();
+
+	if (worker)
+	{
+		worker->localMutex.lock();
+		worker->localTasks.push_back(task);
+		worker->localMutex.unlock();
+	}
+
+	mutex.lock();
+	++numQueued;
+	workAvailable.wakeOne();
+	stateChanged.wakeAll();
+	mutex.unlock();
+}
+
+
+/**
+ * @brief Queues a call to a slot of a worker QObject
+ *
+ * Queues a call to a slot of a worker QObject, such as TerrainLayer::readFort14(). The
+ * worker is not moved to another thread, so the signals it emits while the slot runs
+ * are queued to the objects in the GUI thread that are connected to them.
+ *
+ * @param worker The worker
+ * @param method The name of the slot, without arguments or the SLOT() macro
+ * @param priority One of the TASK_PRIORITY_ values
+ * @param group The group the task counts towards, or 0
+ */
+void TaskScheduler::Start(QObject *worker, const char *method, int priority, TaskGroup *group)
+{
+	if (worker && method)
+		Start(new MethodTask(worker, method), priority, group);
+}
+
+
+/**
+ * @brief Drops the queued tasks of a group and marks it as cancelled
+ * @param group The group
+ */
+void TaskScheduler::Cancel(TaskGroup *group)
+{
+	if (!group)
+		return;
+
+	std::vector<ScheduledTask> removed;
+
+	mutex.lock();
+	group->cancelled = true;
+	for (int i=0; i<TASK_NUM_PRIORITIES; ++i)
+		RemoveGroup(queues[i], group, removed);
+	mutex.unlock();
+
+	for (std::vector<TaskWorker*>::iterator it = workers.begin(); it != workers.end(); ++it)
+	{
+		(*it)->localMutex.lock();
+		RemoveGroup((*it)->localTasks, group, removed);
+		(*it)->localMutex.unlock();
+	}
+
+	if (removed.size() > 0)
+	{
+		mutex.lock();
+		numQueued -= removed.size();
+		mutex.unlock();
+	}
+
+	for (std::vector<ScheduledTask>::iterator it = removed.begin(); it != removed.end(); ++it)
+		FinishTask(*it, it->runnable->autoDelete());
+}
+
+
+/**
+ * @brief Waits for every task of a group to finish
+ *
+ * Waits for every task of a group to finish. The calling thread runs the queued
+ * tasks of the group itself while it waits, so a task can wait on tasks it has
+ * started without holding up a thread of the pool.
+ *
+ * @param group The group
+ */
+void TaskScheduler::Wait(TaskGroup *group)
+{
+	if (!group)
+		return;
+
+	TaskWorker *worker = CurrentWorker();
+	while (true)
+	{
+		mutex.lock();
+		bool done = group->numPending == 0 || stopping;
+		mutex.unlock();
+		if (done)
+			return;
+
+		ScheduledTask task;
+		if (TakeTask(worker, group, task))
+		{
+			RunTask(task);
+			continue;
+		}
+
+		mutex.lock();
+		if (group->numPending > 0 && !stopping)
+			stateChanged.wait(&mutex);
+		mutex.unlock();
+	}
+}
+
+
+bool TaskScheduler::IsCancelled(TaskGroup *group)
+{
+	if (!group)
+		return false;
+
+	mutex.lock();
+	bool cancelled = group->cancelled;
+	mutex.unlock();
+	return cancelled;
+}
+
+
+/**
+ * @brief Checks if the group of the task the calling thread is running has been cancelled
+ *
+ * Checks if the group of the task the calling thread is running has been cancelled,
+ * or if the scheduler is stopping. Long running tasks call this between their steps
+ * and return early when it is true. It is always false on a thread that is not
+ * running a task of the scheduler, such as a QThread of a follow mode carve.
+ *
+ * @return true if the current task should stop
+ */
+bool TaskScheduler::CurrentTaskCancelled()
+{
+	if (!runningTasks.hasLocalData())
+		return false;
+
+	TaskGroup *group = runningTasks.localData()->group;
+	mutex.lock();
+	bool cancelled = stopping || (group && group->cancelled);
+	mutex.unlock();
+	return cancelled;
+}
+
+
+int TaskScheduler::GetNumPending(TaskGroup *group)
+{
+	if (!group)
+		return 0;
+
+	mutex.lock();
+	int numPending = group->numPending;
+	mutex.unlock();
+	return numPending;
+}
+
+
+int TaskScheduler::GetNumThreads()
+{
+	return workers.size();
+}
+
+
+/**
+ * @brief Returns the number of tasks that have not started
+ * @return The number of tasks
+ */
+int TaskScheduler::GetNumQueued()
+{
+	mutex.lock();
+	int queued = numQueued;
+	mutex.unlock();
+	return queued;
+}
+
+
+/**
+ * @brief Returns the scheduler thread that is calling, if any
+ * @return The worker, or 0 if the calling thread is not one of the scheduler's
+ */
+TaskWorker* TaskScheduler::CurrentWorker()
+{
+	QThread *current = QThread::currentThread();
+	for (std::vector<TaskWorker*>::iterator it = workers.begin(); it != workers.end(); ++it)
+		if (*it == current)
+			return *it;
+	return 0;
+}
+
+
+/**
+ * @brief Takes the next task a thread should run
+ *
+ * Takes the next task a thread should run: the newest task on its own local queue,
+ * then the oldest task of the highest priority on the shared queues, then the oldest
+ * task on another thread's local queue.
+ *
+ * @param worker The thread, or 0 if it is not one of the scheduler's
+ * @param group If not 0, only a task of this group is taken
+ * @param task Set to the task
+ * @return true if a task was taken
+ */
+bool TaskScheduler::TakeTask(TaskWorker *worker, TaskGroup *group, ScheduledTask &task)
+{
+	bool found = false;
+
+	if (worker)
+	{
+		worker->localMutex.lock();
+		found = TakeFrom(worker->localTasks, group, true, task);
+		worker->localMutex.unlock();
+	}
+
+	if (!found)
+	{
+		mutex.lock();
+		for (int i=TASK_NUM_PRIORITIES-1; i>=0 && !found; --i)
+			found = TakeFrom(queues[i], group, false, task);
+		if (found)
+			--numQueued;
+		mutex.unlock();
+		if (found)
+			return true;
+	}
+
+	if (!found)
+	{
+		/* Start stealing from the thread after this one, so the threads don't all pick the same victim */
+		unsigned int first = 0;
+		for (unsigned int i=0; i<workers.size(); ++i)
+			if (workers[i] == worker)
+				first = i+1;
+
+		for (unsigned int i=0; i<workers.size() && !found; ++i)
+		{
+			TaskWorker *victim = workers[(first+i) % workers.size()];
+			if (victim == worker)
+				continue;
+			victim->localMutex.lock();
+			found = TakeFrom(victim->localTasks, group, false, task);
+			victim->localMutex.unlock();
+		}
+	}
+
+	if (found)
+	{
+		mutex.lock();
+		--numQueued;
+		mutex.unlock();
+	}
+	return found;
+}
+
+
+/**
+ * @brief Takes a task from one end of a queue
+ *
+ * Takes a task from one end of a queue. The caller must hold the lock of the queue.
+ *
+ * @param queue The queue
+ * @param group If not 0, the first task of this group from that end is taken
+ * @param newest true to take from the back, false to take from the front
+ * @param task Set to the task
+ * @return true if a task was taken
+ */
+bool TaskScheduler::TakeFrom(std::deque<ScheduledTask> &queue, TaskGroup *group, bool newest, ScheduledTask &task)
+{
+	if (newest)
+	{
+		for (std::deque<ScheduledTask>::reverse_iterator it = queue.rbegin(); it != queue.rend(); ++it)
+		{
+			if (!group || it->group == group)
+			{
+				task = *it;
+				queue.erase(--(it.base()));
+				return true;
+			}
+		}
+	} else {
+		for (std::deque<ScheduledTask>::iterator it = queue.begin(); it != queue.end(); ++it)
+		{
+			if (!group || it->group == group)
+			{
+				task = *it;
+				queue.erase(it);
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+
+/**
+ * @brief Moves every task of a group out of a queue
+ *
+ * Moves every task of a group out of a queue. The caller must hold the lock of the queue.
+ *
+ * @param queue The queue
+ * @param group The group, or 0 for every task
+ * @param removed The tasks are added to the end of this list
+ */
+void TaskScheduler::RemoveGroup(std::deque<ScheduledTask> &queue, TaskGroup *group, std::vector<ScheduledTask> &removed)
+{
+	std::deque<ScheduledTask>::iterator it = queue.begin();
+	while (it != queue.end())
+	{
+		if (!group || it->group == group)
+		{
+			removed.push_back(*it);
+			it = queue.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+
+/**
+ * @brief Runs a task, recording its group for CurrentTaskCancelled()
+ *
+ * Runs a task, recording its group for CurrentTaskCancelled(). A thread that waits on
+ * a group runs other tasks from inside a task, so the group of the outer task is put
+ * back once the inner one is done.
+ *
+ * @param task The task
+ */
+void TaskScheduler::RunTask(ScheduledTask &task)
+{
+	if (!runningTasks.hasLocalData())
+		runningTasks.setLocalData(new RunningTask());
+	RunningTask *running = runningTasks.localData();
+	TaskGroup *outerGroup = running->group;
+
+	running->group = task.group;
+	task.runnable->run();
+	running->group = outerGroup;
+
+	FinishTask(task, task.runnable->autoDelete());
+}
+
+
+/**
+ * @brief Counts a task that has run or been cancelled towards its group
+ *
+ * Counts a task that has run or been cancelled towards its group, and posts the
+ * group's finished() signal if it was the last one. The signal is posted rather than
+ * emitted so it is never delivered after a group that has finished waiting has
+ * been deleted.
+ *
+ * @param task The task
+ * @param deleteRunnable true to delete the runnable
+ */
+void TaskScheduler::FinishTask(ScheduledTask &task, bool deleteRunnable)
+{
+	if (deleteRunnable)
+		delete task.runnable;
+	task.runnable = 0;
+
+	mutex.lock();
+	if (task.group && --task.group->numPending == 0)
+		QMetaObject::invokeMethod(task.group, "finished", Qt::QueuedConnection);
+	stateChanged.wakeAll();
+	mutex.unlock();
+}
+
+
+/**
+ * @brief Runs tasks on a thread of the pool until the scheduler is stopped
+ * @param worker The thread
+ */
+void TaskScheduler::WorkerLoop(TaskWorker *worker)
+{
+	while (true)
+	{
+		ScheduledTask task;
+		if (TakeTask(worker, 0, task))
+		{
+			RunTask(task);
+			continue;
+		}
+
+		mutex.lock();
+		if (stopping)
+		{
+			mutex.unlock();
+			return;
+		}
+		if (numQueued <= 0)
+			workAvailable.wait(&mutex);
+		mutex.unlock();
+	}
+}
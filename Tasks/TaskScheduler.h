@@ -0,0 +1,151 @@
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <vector>
+#include <deque>
+
+#include <QObject>
+#include <QThread>
+#include <QRunnable>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadStorage>
+#include <QByteArray>
+#include <QMetaObject>
+
+#include "Tasks/TaskGroup.h"
+
+#define TASK_PRIORITY_LOW	0	/**< Background work nobody is waiting for */
+#define TASK_PRIORITY_NORMAL	1	/**< Work the user has asked for */
+#define TASK_PRIORITY_HIGH	2	/**< Work the user is looking at and waiting on */
+#define TASK_NUM_PRIORITIES	3
+
+
+/**
+ * @brief A task waiting in a TaskScheduler
+ */
+struct ScheduledTask
+{
+	QRunnable*	runnable;
+	TaskGroup*	group;		/**< The group the task counts towards, or 0 */
+	int		priority;	/**< One of the TASK_PRIORITY_ values */
+};
+
+
+/**
+ * @brief The group of the task a thread is running, so the task can tell if it was cancelled
+ */
+struct RunningTask
+{
+	TaskGroup*	group;
+	RunningTask() : group(0) {}
+};
+
+
+class TaskScheduler;
+
+
+/**
+ * @brief One thread of the TaskScheduler, along with the tasks started from it
+ */
+class TaskWorker : public QThread
+{
+	public:
+		TaskWorker(TaskScheduler *newScheduler);
+
+	protected:
+
+		void	run();
+
+	private:
+
+		TaskScheduler*			scheduler;
+		QMutex				localMutex;
+		std::deque<ScheduledTask>	localTasks;	/**< Tasks started from this thread. Taken from the back here and stolen from the front. */
+
+		friend class TaskScheduler;
+};
+
+
+/**
+ * @brief The pool of threads that every long running job of the application is run on
+ *
+ * The pool of threads that every long running job of the application is run on:
+ * reading meshes, extracting time series, computing envelopes, verifying subdomains,
+ * carving files for subdomains and finding boundaries. There is one scheduler per
+ * process, with one thread per core, so the jobs of every domain share the machine
+ * instead of each starting threads of its own, and the GUI thread only hands work
+ * off and receives the results through signals.
+ *
+ * Tasks are QRunnables, like EnvelopeTask and BoundaryExtractionTask, or a slot of a
+ * worker QObject, like the reader and carver classes that used to be moved to their
+ * own QThread. Their signals are delivered to the GUI thread in the same way, since
+ * the worker object stays in the GUI thread. A TaskGroup tells when tasks are done.
+ *
+ * Scheduling is work-stealing:
+ * - A task started from outside the pool goes on a shared queue for its priority,
+ *   and higher priorities always start first.
+ * - A task started by a running task (for example the per-range tasks of an envelope)
+ *   goes on the local queue of that thread, which takes the newest one first so its
+ *   data is still in cache. Idle threads steal the oldest tasks from the other local
+ *   queues once the shared queues are empty.
+ * - A thread that waits on a TaskGroup runs the queued tasks of that group itself
+ *   instead of blocking, so tasks that start and wait on tasks of their own never tie
+ *   up the pool.
+ *
+ * Each local queue has its own lock, so threads working through their own tasks do
+ * not contend with each other.
+ *
+ * Cancelling a group only drops the tasks that have not started. The long running
+ * jobs call CurrentTaskCancelled() between their steps, so a running job returns
+ * early when its group is cancelled and a Cancel() and Wait() in a destructor does not
+ * hold up the GUI thread.
+ *
+ * Jobs that block for as long as the user is watching, such as fort.63 playback and
+ * carving the output of a running job, keep their own QThread so they do not hold
+ * a core of the pool.
+ *
+ */
+class TaskScheduler
+{
+	public:
+
+		static TaskScheduler*	Instance();
+
+		void	Start(QRunnable *runnable, int priority=TASK_PRIORITY_NORMAL, TaskGroup *group=0);
+		void	Start(QObject *worker, const char *method, int priority=TASK_PRIORITY_NORMAL, TaskGroup *group=0);
+		void	Cancel(TaskGroup *group);
+		void	Wait(TaskGroup *group);
+
+		bool	IsCancelled(TaskGroup *group);
+		bool	CurrentTaskCancelled();
+		int	GetNumPending(TaskGroup *group);
+		int	GetNumThreads();
+		int	GetNumQueued();
+
+	private:
+
+		TaskScheduler();
+		~TaskScheduler();
+
+		std::vector<TaskWorker*>	workers;
+		std::deque<ScheduledTask>	queues[TASK_NUM_PRIORITIES];	/**< Tasks started from outside the pool, by priority */
+		QMutex				mutex;		/**< Guards the shared queues, the counts and every TaskGroup */
+		QWaitCondition			workAvailable;	/**< Wakes idle threads when a task is queued */
+		QWaitCondition			stateChanged;	/**< Wakes threads waiting on a TaskGroup */
+		int				numQueued;	/**< Tasks queued on every queue, shared or local */
+		bool				stopping;
+		QThreadStorage<RunningTask*>	runningTasks;	/**< The task each thread is running, if any */
+
+		TaskWorker*	CurrentWorker();
+		bool		TakeTask(TaskWorker *worker, TaskGroup *group, ScheduledTask &task);
+		bool		TakeFrom(std::deque<ScheduledTask> &queue, TaskGroup *group, bool newest, ScheduledTask &task);
+		void		RemoveGroup(std::deque<ScheduledTask> &queue, TaskGroup *group, std::vector<ScheduledTask> &removed);
+		void		RunTask(ScheduledTask &task);
+		void		FinishTask(ScheduledTask &task, bool deleteRunnable);
+		void		WorkerLoop(TaskWorker *worker);
+
+		friend class TaskWorker;
+};
+
+#endif // TASKSCHEDULER_H
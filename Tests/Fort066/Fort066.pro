@@ -0,0 +1,19 @@
+#-------------------------------------------------
+#
+# tst_fort066: carves a synthetic two processor run into a subdomain fort.020
+#
+#-------------------------------------------------
+
+QT       = core testlib
+
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_fort066
+TEMPLATE = app
+
+CORE_BUILD_DIR = $$OUT_PWD/../../Core
+include(../../Core/Core.pri)
+
+
+SOURCES += tst_Fort066.cpp
@@ -0,0 +1,210 @@
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QTextStream>
+#include <QtTest>
+
+#include "Projects/IO/FileIO/Fort066.h"
+#include "Projects/IO/FileIO/BinaryBoundaryConditions.h"
+
+#define NUM_FULL_NODES	6
+#define NUM_TIMESTEPS	2
+
+
+/**
+ * @brief Carves a synthetic two processor run into a subdomain fort.020
+ *
+ * Carves a synthetic two processor run into a subdomain fort.020. The full domain
+ * has six nodes. PE0000 owns nodes 1 to 3 and PE0001 owns nodes 4 to 6, and each
+ * has the first node of the other as a ghost node. Nodes 2 to 5 are recorded, split
+ * between the two processor fort.066 files in local node numbers, and the subdomain
+ * is made of full domain nodes 3, 4 and 5.
+ *
+ */
+class TestFort066 : public QObject
+{
+		Q_OBJECT
+	private:
+
+		QString	runDirectory;
+		QString	subdomainDirectory;
+
+		void	WriteFile(QString path, QString contents);
+		void	WriteProcessor(QString name, QList<int> localToGlobal, QList<int> recordedLocal);
+		double	Value(int globalNode, int ts, int position);
+		void	Carve(bool binary);
+		void	RemoveDirectory(QString path);
+
+	private slots:
+
+		void	initTestCase();
+		void	cleanupTestCase();
+
+		void	carvesAsciiFromProcessorFiles();
+		void	carvesBinaryFromProcessorFiles();
+};
+
+
+void TestFort066::WriteFile(QString path, QString contents)
+{
+	QFile file (path);
+	QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text));
+	QTextStream stream (&file);
+	stream << contents;
+}
+
+
+/**
+ * @brief Writes the fort.18 and fort.066 of a processor directory
+ * @param name The processor directory
+ * @param localToGlobal The full domain number of each local node, negative for ghost nodes
+ * @param recordedLocal The local numbers of the recorded nodes
+ */
+void TestFort066::WriteProcessor(QString name, QList<int> localToGlobal, QList<int> recordedLocal)
+{
+	QDir run (runDirectory);
+	QVERIFY(run.mkpath(name));
+	QString processorPath = run.absoluteFilePath(name);
+
+	QString fort18 = "FileFmt 0\nNODG " + QString::number(NUM_FULL_NODES) + " 4 " + QString::number(localToGlobal.size()) + "\n";
+	for (int i=0; i<localToGlobal.size(); ++i)
+		fort18.append(QString::number(localToGlobal[i]) + "\n");
+	WriteFile(processorPath + "/fort.18", fort18);
+
+	QString fort066 = "1\t" + QString::number(recordedLocal.size()) + "\t" + QString::number(NUM_TIMESTEPS) + "\n";
+	for (int ts=1; ts<=NUM_TIMESTEPS; ++ts)
+	{
+		fort066.append(QString::number(3600.0*ts) + " " + QString::number(ts) + "\n");
+		for (int i=0; i<recordedLocal.size(); ++i)
+		{
+			int global = localToGlobal[recordedLocal[i]-1];
+			fort066.append(QString::number(recordedLocal[i]) + " " + QString::number(Value(global, ts, 0)) + " " +
+				       QString::number(Value(global, ts, 1)) + "\n");
+			fort066.append(QString::number(Value(global, ts, 2)) + "\n");
+		}
+	}
+	WriteFile(processorPath + "/fort.066", fort066);
+}
+
+
+/**
+ * @brief The value recorded for a node, different for every node, timestep and position in the record
+ */
+double TestFort066::Value(int globalNode, int ts, int position)
+{
+	return globalNode + 0.25*ts + 10.0*position;
+}
+
+
+void TestFort066::Carve(bool binary)
+{
+	std::vector<SubdomainFiles> subdomains;
+	subdomains.push_back(SubdomainFiles(subdomainDirectory, subdomainDirectory + "/fort.14",
+					    subdomainDirectory + "/py.140", subdomainDirectory + "/py.141"));
+
+	Fort066 carver (runDirectory + "/fort.066");
+	carver.SetSubdomains(subdomains);
+	carver.SetBinaryOutput(binary);
+	carver.CarveAllSubdomains();
+	QVERIFY(carver.CarvedAllTimesteps());
+}
+
+
+void TestFort066::RemoveDirectory(QString path)
+{
+	QDir directory (path);
+	QStringList entries = directory.entryList(QDir::Files);
+	for (int i=0; i<entries.size(); ++i)
+		directory.remove(entries[i]);
+	entries = directory.entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+	for (int i=0; i<entries.size(); ++i)
+		RemoveDirectory(directory.absoluteFilePath(entries[i]));
+	QDir().rmdir(path);
+}
+
+
+void TestFort066::initTestCase()
+{
+	QDir temp = QDir::temp();
+	QString name = "tst_fort066_" + QString::number(QCoreApplication::applicationPid());
+	QVERIFY(temp.mkpath(name + "/full"));
+	QVERIFY(temp.mkpath(name + "/sub"));
+	runDirectory = temp.absoluteFilePath(name + "/full");
+	subdomainDirectory = temp.absoluteFilePath(name + "/sub");
+
+	WriteProcessor("PE0000", QList<int>() << 1 << 2 << 3 << -4, QList<int>() << 2 << 3);
+	WriteProcessor("PE0001", QList<int>() << 4 << 5 << 6 << -3, QList<int>() << 1 << 2);
+	WriteFile(subdomainDirectory + "/py.140", "new old " + QString::number(NUM_FULL_NODES) + "\n1 3\n2 4\n3 5\n");
+}
+
+
+void TestFort066::cleanupTestCase()
+{
+	RemoveDirectory(QFileInfo(runDirectory).absolutePath());
+}
+
+
+void TestFort066::carvesAsciiFromProcessorFiles()
+{
+	Carve(false);
+
+	QFile fort020 (subdomainDirectory + "/fort.020");
+	QVERIFY(fort020.open(QIODevice::ReadOnly | QIODevice::Text));
+	QStringList lines;
+	QTextStream stream (&fort020);
+	while (!stream.atEnd())
+		lines << stream.readLine().simplified();
+
+	QStringList expected;
+	expected << "Boundary conditions for subdomain" << "1 3 " + QString::number(NUM_TIMESTEPS) << "1" << "2" << "3";
+	for (int ts=1; ts<=NUM_TIMESTEPS; ++ts)
+	{
+		expected << QString::number(3600.0*ts) + " " + QString::number(ts);
+		for (int newNode=1; newNode<=3; ++newNode)
+		{
+			int global = newNode + 2;
+			expected << QString::number(newNode) + " " + QString::number(Value(global, ts, 0)) + " " + QString::number(Value(global, ts, 1));
+			expected << QString::number(Value(global, ts, 2));
+		}
+	}
+	QCOMPARE(lines, expected);
+}
+
+
+void TestFort066::carvesBinaryFromProcessorFiles()
+{
+	Carve(true);
+
+	BinaryBoundaryConditions fort020;
+	QVERIFY(fort020.OpenForReading(subdomainDirectory + "/fort.020"));
+	QCOMPARE(fort020.GetNumTimesteps(), (unsigned int)NUM_TIMESTEPS);
+	QCOMPARE(fort020.GetValuesLine1(), 2u);
+	QCOMPARE(fort020.GetValuesLine2(), 1u);
+
+	std::vector<unsigned int> nodeNumbers = fort020.GetNodeNumbers();
+	QCOMPARE((int)nodeNumbers.size(), 3);
+	for (unsigned int i=0; i<nodeNumbers.size(); ++i)
+		QCOMPARE(nodeNumbers[i], i+1);
+
+	std::vector<double> header, values;
+	for (int ts=1; ts<=NUM_TIMESTEPS; ++ts)
+	{
+		QVERIFY(fort020.ReadTimestep(ts, header, values));
+		QCOMPARE((int)values.size(), 9);
+		for (int i=0; i<3; ++i)
+			for (int position=0; position<3; ++position)
+				QCOMPARE(values[i*3 + position], Value(i+3, ts, position));
+	}
+	fort020.Close();
+}
+
+
+int main(int argc, char *argv[])
+{
+	/* QTEST_MAIN would need a QApplication with Qt 4 */
+	QCoreApplication app (argc, argv);
+	TestFort066 test;
+	return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_Fort066.moc"
@@ -0,0 +1,24 @@
+#-------------------------------------------------
+#
+# tst_jobscheduler: drives the JobScheduler with a stand-in for ADCIRC
+#
+#-------------------------------------------------
+
+QT       = core testlib
+
+CONFIG += console testcase
+CONFIG -= app_bundle
+
+TARGET = tst_jobscheduler
+TEMPLATE = app
+
+INCLUDEPATH += ../..
+
+DEFINES += FAKE_ADCIRC=\\\"$$PWD/fake_adcirc.sh\\\"
+
+
+SOURCES += tst_JobScheduler.cpp \
+    ../../Adcirc/JobScheduler.cpp
+
+HEADERS  += \
+    ../../Adcirc/JobScheduler.h
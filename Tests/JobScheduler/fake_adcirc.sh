@@ -0,0 +1,10 @@
+#!/bin/sh
+#
+# Stands in for adcirc in the JobScheduler test
+#
+# Usage: fake_adcirc.sh <seconds> [exit code]
+#
+
+echo "fake adcirc running in $(pwd)"
+sleep "${1:-0}"
+exit "${2:-0}"
@@ -0,0 +1,274 @@
+#include <QCoreApplication>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QSignalSpy>
+#include <QtTest>
+
+#include "Adcirc/JobScheduler.h"
+
+#define TEST_TIMEOUT	20000
+
+
+/**
+ * @brief Drives a JobScheduler through queueing, core budgets and cancellation
+ *
+ * Drives a JobScheduler through queueing, core budgets and cancellation. Every job
+ * runs fake_adcirc.sh, which sleeps for a given number of seconds and exits with a
+ * given code, so nothing here needs ADCIRC to be installed.
+ *
+ */
+class TestJobScheduler : public QObject
+{
+		Q_OBJECT
+	private:
+
+		QString	workingDirectory;
+
+		int	SubmitFakeJob(JobScheduler &scheduler, QString name, QString seconds, int cores=1,
+				      int priority=0, int exitCode=0);
+		bool	WaitUntilIdle(JobScheduler &scheduler);
+		QStringList	StartOrder(QSignalSpy &stateSpy);
+
+	private slots:
+
+		void	initTestCase();
+		void	cleanupTestCase();
+
+		void	queuesJobsBeyondTheCoreBudget();
+		void	startsHigherPriorityJobsFirst();
+		void	fillsFreeCoresWithSmallerJobs();
+		void	runsOversizedJobsAlone();
+		void	cancelsQueuedJobs();
+		void	cancelsRunningJobs();
+		void	reportsFailedJobs();
+		void	reportsMissingDirectories();
+};
+
+
+int TestJobScheduler::SubmitFakeJob(JobScheduler &scheduler, QString name, QString seconds, int cores,
+				    int priority, int exitCode)
+{
+	QStringList arguments;
+	arguments << FAKE_ADCIRC << seconds << QString::number(exitCode);
+	return scheduler.SubmitJob(name, workingDirectory, "/bin/sh", arguments, cores, 0, priority, name);
+}
+
+
+bool TestJobScheduler::WaitUntilIdle(JobScheduler &scheduler)
+{
+	if (scheduler.GetNumQueuedJobs() == 0 && scheduler.GetNumRunningJobs() == 0)
+		return true;
+
+	QEventLoop loop;
+	connect(&scheduler, SIGNAL(allJobsFinished()), &loop, SLOT(quit()));
+	QTimer::singleShot(TEST_TIMEOUT, &loop, SLOT(quit()));
+	loop.exec();
+
+	return scheduler.GetNumQueuedJobs() == 0 && scheduler.GetNumRunningJobs() == 0;
+}
+
+
+/**
+ * @brief Lists the names of the jobs in the order they started running
+ * @param stateSpy A spy on JobScheduler::jobStateChanged()
+ * @return The job names
+ */
+QStringList TestJobScheduler::StartOrder(QSignalSpy &stateSpy)
+{
+	QStringList names;
+	for (int i=0; i<stateSpy.count(); ++i)
+		if (stateSpy.at(i).at(2).toString() == JobScheduler::GetStateName(JobRunning))
+			names << stateSpy.at(i).at(1).toString();
+	return names;
+}
+
+
+void TestJobScheduler::initTestCase()
+{
+	QVERIFY(QFile(FAKE_ADCIRC).exists());
+
+	QDir temp = QDir::temp();
+	QString name = "tst_jobscheduler_" + QString::number(QCoreApplication::applicationPid());
+	QVERIFY(temp.mkpath(name));
+	workingDirectory = temp.absoluteFilePath(name);
+}
+
+
+void TestJobScheduler::cleanupTestCase()
+{
+	QDir directory (workingDirectory);
+	QStringList files = directory.entryList(QDir::Files);
+	for (int i=0; i<files.size(); ++i)
+		directory.remove(files[i]);
+	QDir::temp().rmdir(directory.dirName());
+}
+
+
+void TestJobScheduler::queuesJobsBeyondTheCoreBudget()
+{
+	JobScheduler scheduler;
+	scheduler.SetCoreBudget(2);
+	scheduler.SetMemoryBudget(0);
+	QSignalSpy idleSpy (&scheduler, SIGNAL(allJobsFinished()));
+
+	int first = SubmitFakeJob(scheduler, "first", "0.5");
+	int second = SubmitFakeJob(scheduler, "second", "0.5");
+	int third = SubmitFakeJob(scheduler, "third", "0.5");
+
+	QCOMPARE(scheduler.GetNumRunningJobs(), 2);
+	QCOMPARE(scheduler.GetNumQueuedJobs(), 1);
+	QCOMPARE(scheduler.GetJob(third)->state, JobQueued);
+
+	QVERIFY(WaitUntilIdle(scheduler));
+	QCOMPARE(idleSpy.count(), 1);
+	QCOMPARE(scheduler.GetJob(first)->state, JobFinished);
+	QCOMPARE(scheduler.GetJob(second)->state, JobFinished);
+	QCOMPARE(scheduler.GetJob(third)->state, JobFinished);
+	QVERIFY(QFile(workingDirectory + "/first.stdout").exists());
+}
+
+
+void TestJobScheduler::startsHigherPriorityJobsFirst()
+{
+	JobScheduler scheduler;
+	scheduler.SetCoreBudget(1);
+	scheduler.SetMemoryBudget(0);
+	QSignalSpy stateSpy (&scheduler, SIGNAL(jobStateChanged(int,QString,QString)));
+
+	SubmitFakeJob(scheduler, "running", "0.3");
+	SubmitFakeJob(scheduler, "low", "0", 1, 0);
+	SubmitFakeJob(scheduler, "high", "0", 1, 5);
+	SubmitFakeJob(scheduler, "low2", "0", 1, 0);
+
+	QVERIFY(WaitUntilIdle(scheduler));
+	QCOMPARE(StartOrder(stateSpy), QStringList() << "running" << "high" << "low" << "low2");
+}
+
+
+void TestJobScheduler::fillsFreeCoresWithSmallerJobs()
+{
+	JobScheduler scheduler;
+	scheduler.SetCoreBudget(4);
+	scheduler.SetMemoryBudget(0);
+
+	int running = SubmitFakeJob(scheduler, "running", "0.5", 2);
+	int large = SubmitFakeJob(scheduler, "large", "0", 3);
+	int small = SubmitFakeJob(scheduler, "small", "0.5", 2);
+
+	QCOMPARE(scheduler.GetJob(running)->state, JobRunning);
+	QCOMPARE(scheduler.GetJob(large)->state, JobQueued);
+	QCOMPARE(scheduler.GetJob(small)->state, JobRunning);
+
+	QVERIFY(WaitUntilIdle(scheduler));
+	QCOMPARE(scheduler.GetJob(large)->state, JobFinished);
+}
+
+
+void TestJobScheduler::runsOversizedJobsAlone()
+{
+	JobScheduler scheduler;
+	scheduler.SetCoreBudget(2);
+	scheduler.SetMemoryBudget(0);
+	QSignalSpy stateSpy (&scheduler, SIGNAL(jobStateChanged(int,QString,QString)));
+
+	SubmitFakeJob(scheduler, "running", "0.3");
+	int oversized = SubmitFakeJob(scheduler, "oversized", "0.3", 8);
+	int behind = SubmitFakeJob(scheduler, "behind", "0");
+
+	/* Nothing is started past the oversized job while it waits for the machine to empty */
+	QCOMPARE(scheduler.GetJob(oversized)->state, JobQueued);
+	QCOMPARE(scheduler.GetJob(behind)->state, JobQueued);
+
+	QVERIFY(WaitUntilIdle(scheduler));
+	QCOMPARE(StartOrder(stateSpy), QStringList() << "running" << "oversized" << "behind");
+	QCOMPARE(scheduler.GetJob(oversized)->state, JobFinished);
+}
+
+
+void TestJobScheduler::cancelsQueuedJobs()
+{
+	JobScheduler scheduler;
+	scheduler.SetCoreBudget(1);
+	scheduler.SetMemoryBudget(0);
+	QSignalSpy stateSpy (&scheduler, SIGNAL(jobStateChanged(int,QString,QString)));
+
+	int running = SubmitFakeJob(scheduler, "running", "0.3");
+	int queued = SubmitFakeJob(scheduler, "queued", "0");
+
+	QVERIFY(scheduler.CancelJob(queued));
+	QCOMPARE(scheduler.GetJob(queued)->state, JobCancelled);
+	QCOMPARE(scheduler.GetNumQueuedJobs(), 0);
+	QVERIFY(!scheduler.CancelJob(queued));
+
+	QVERIFY(WaitUntilIdle(scheduler));
+	QCOMPARE(scheduler.GetJob(running)->state, JobFinished);
+	QCOMPARE(StartOrder(stateSpy), QStringList() << "running");
+}
+
+
+void TestJobScheduler::cancelsRunningJobs()
+{
+	JobScheduler scheduler;
+	scheduler.SetCoreBudget(1);
+	scheduler.SetMemoryBudget(0);
+	QSignalSpy finishedSpy (&scheduler, SIGNAL(jobFinished(int,int)));
+
+	int running = SubmitFakeJob(scheduler, "running", "60");
+	int queued = SubmitFakeJob(scheduler, "queued", "0");
+	QCOMPARE(scheduler.GetJob(running)->state, JobRunning);
+
+	scheduler.CancelAllJobs();
+	QCOMPARE(scheduler.GetJob(queued)->state, JobCancelled);
+
+	QElapsedTimer timer;
+	timer.start();
+	QVERIFY(WaitUntilIdle(scheduler));
+	QVERIFY(timer.elapsed() < JOB_KILL_TIMEOUT + 1000);
+
+	QCOMPARE(scheduler.GetJob(running)->state, JobCancelled);
+	QCOMPARE(finishedSpy.count(), 1);
+	QCOMPARE(finishedSpy.at(0).at(0).toInt(), running);
+}
+
+
+void TestJobScheduler::reportsFailedJobs()
+{
+	JobScheduler scheduler;
+	scheduler.SetMemoryBudget(0);
+	QSignalSpy messageSpy (&scheduler, SIGNAL(emitMessage(QString)));
+	QSignalSpy finishedSpy (&scheduler, SIGNAL(jobFinished(int,int)));
+
+	int failed = SubmitFakeJob(scheduler, "failed", "0", 1, 0, 3);
+
+	QVERIFY(WaitUntilIdle(scheduler));
+	QCOMPARE(scheduler.GetJob(failed)->state, JobFailed);
+	QCOMPARE(scheduler.GetJob(failed)->exitCode, 3);
+	QCOMPARE(finishedSpy.count(), 1);
+	QCOMPARE(finishedSpy.at(0).at(1).toInt(), 3);
+	QCOMPARE(messageSpy.count(), 1);
+}
+
+
+void TestJobScheduler::reportsMissingDirectories()
+{
+	JobScheduler scheduler;
+	scheduler.SetMemoryBudget(0);
+	QSignalSpy finishedSpy (&scheduler, SIGNAL(jobFinished(int,int)));
+
+	int missing = scheduler.SubmitJob("missing", workingDirectory + "/does_not_exist", "/bin/sh");
+
+	QCOMPARE(scheduler.GetJob(missing)->state, JobFailed);
+	QCOMPARE(finishedSpy.count(), 1);
+	QCOMPARE(scheduler.GetNumRunningJobs(), 0);
+}
+
+
+int main(int argc, char *argv[])
+{
+	/* QTEST_MAIN would need a QApplication with Qt 4 */
+	QCoreApplication app (argc, argv);
+	TestJobScheduler test;
+	return QTest::qExec(&test, argc, argv);
+}
+
+#include "tst_JobScheduler.moc"
@@ -0,0 +1,99 @@
+#include "JobStatusWidget.h"
+
+#include <QKeyEvent>
+
+#include "Adcirc/JobScheduler.h"
+
+JobStatusWidget::JobStatusWidget(QWidget *parent) : QTreeWidget(parent)
+{
+	setColumnCount(4);
+	setHeaderLabels(QStringList() << "Job" << "State" << "Since" << "Progress");
+	setRootIsDecorated(false);
+	setSelectionMode(QAbstractItemView::SingleSelection);
+	setMinimumSize(400, 250);
+}
+
+
+/**
+ * @brief Asks for the selected job to be cancelled when Delete is pressed
+ */
+void JobStatusWidget::keyPressEvent(QKeyEvent *event)
+{
+	QTreeWidgetItem *item = currentItem();
+	if (item && event->key() == Qt::Key_Delete)
+	{
+		emit cancelJob(item->data(0, Qt::UserRole).toInt());
+		return;
+	}
+	QTreeWidget::keyPressEvent(event);
+}
+
+
+/**
+ * @brief Shows the new state of a job
+ * @param id The ID of the job
+ * @param name The name of the job
+ * @param state The name of the state the job is now in
+ */
+void JobStatusWidget::setJobState(int id, QString name, QString state)
+{
+	QTreeWidgetItem *item = rows.value(id, 0);
+	if (!item)
+	{
+		item = new QTreeWidgetItem(this);
+		item->setData(0, Qt::UserRole, id);
+		rows.insert(id, item);
+	}
+
+	item->setText(0, name);
+	item->setText(1, state);
+	item->setText(2, QDateTime::currentDateTime().toString("hh:mm:ss"));
+
+	if (state == JobScheduler::GetStateName(JobFailed))
+		item->setForeground(1, QBrush(Qt::red));
+	else if (state == JobScheduler::GetStateName(JobRunning))
+		item->setForeground(1, QBrush(Qt::darkGreen));
+	else
+		item->setForeground(1, QBrush(palette().color(QPalette::Text)));
+
+	resizeColumnToContents(0);
+}
+
+
+/**
+ * @brief Shows how far along a running job is
+ * @param id The ID of the job
+ * @param percent The percent complete, or -1 if it is not known
+ * @param details The timestep, estimated time left and output written
+ */
+void JobStatusWidget::setJobProgress(int id, int percent, QString details)
+{
+	QTreeWidgetItem *item = rows.value(id, 0);
+	if (!item)
+		return;
+
+	if (percent >= 0)
+		item->setText(3, QString::number(percent) + "% - " + details);
+	else
+		item->setText(3, details);
+}
+
+
+/**
+ * @brief Removes every job that is no longer queued or running
+ */
+void JobStatusWidget::clearFinishedJobs()
+{
+	QMap<int, QTreeWidgetItem*>::iterator it = rows.begin();
+	while (it != rows.end())
+	{
+		QString state = it.value()->text(1);
+		if (state != JobScheduler::GetStateName(JobQueued) && state != JobScheduler::GetStateName(JobRunning))
+		{
+			delete it.value();
+			it = rows.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
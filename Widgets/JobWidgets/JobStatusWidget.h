@@ -0,0 +1,47 @@
+#ifndef JOBSTATUSWIDGET_H
+#define JOBSTATUSWIDGET_H
+
+#include <QWidget>
+#include <QTreeWidget>
+#include <QTreeWidgetItem>
+#include <QHeaderView>
+#include <QStringList>
+#include <QDateTime>
+#include <QMap>
+
+
+/**
+ * @brief A list of the jobs run by a JobScheduler and the state each is in
+ *
+ * A list of the jobs run by a JobScheduler and the state each is in. A row is
+ * added the first time a job is seen and updated every time its state changes.
+ * Cancelling the selected job is requested through the cancelJob() signal, so the
+ * widget never touches the scheduler itself.
+ *
+ */
+class JobStatusWidget : public QTreeWidget
+{
+		Q_OBJECT
+	public:
+		JobStatusWidget(QWidget *parent = 0);
+
+	protected:
+
+		void	keyPressEvent(QKeyEvent *event);
+
+	private:
+
+		QMap<int, QTreeWidgetItem*>	rows;	/**< Map of job IDs to their rows */
+
+	public slots:
+
+		void	setJobState(int id, QString name, QString state);
+		void	setJobProgress(int id, int percent, QString details);
+		void	clearFinishedJobs();
+
+	signals:
+
+		void	cancelJob(int id);
+};
+
+#endif // JOBSTATUSWIDGET_H
@@ -0,0 +1,180 @@
+#include "TimeSeriesPlot.h"
+
+TimeSeriesPlot::TimeSeriesPlot(QWidget *parent) : QFrame(parent)
+{
+	title = "";
+	xLabel = "Time (days)";
+	yLabel = "Elevation (m)";
+	dataBounds = QRectF();
+
+	setFrameShape(QFrame::StyledPanel);
+	setMinimumSize(400, 250);
+	setAutoFillBackground(true);
+	setBackgroundRole(QPalette::Base);
+}
+
+
+void TimeSeriesPlot::SetAxisLabels(QString newXLabel, QString newYLabel)
+{
+	xLabel = newXLabel;
+	yLabel = newYLabel;
+	update();
+}
+
+
+void TimeSeriesPlot::paintEvent(QPaintEvent *)
+{
+	QPainter painter(this);
+	drawFrame(&painter);
+	painter.setRenderHint(QPainter::Antialiasing);
+
+	QRect plotArea = contentsRect().adjusted(PLOT_MARGIN_LEFT, PLOT_MARGIN_TOP, -PLOT_MARGIN_RIGHT, -PLOT_MARGIN_BOTTOM);
+	if (plotArea.width() <= 0 || plotArea.height() <= 0)
+		return;
+
+	painter.drawText(contentsRect().adjusted(0, 5, 0, 0), Qt::AlignHCenter | Qt::AlignTop, title);
+
+	if (!dataBounds.isValid())
+	{
+		painter.drawText(plotArea, Qt::AlignCenter, series.isEmpty() ? "No data" : "Dry for the entire run");
+		return;
+	}
+
+	DrawAxes(&painter, plotArea);
+	DrawSeries(&painter, plotArea);
+}
+
+
+/**
+ * @brief Finds the extents of the series, ignoring gaps
+ */
+void TimeSeriesPlot::CalculateBounds()
+{
+	bool found = false;
+	double minX = 0.0, maxX = 0.0, minY = 0.0, maxY = 0.0;
+	for (QPolygonF::const_iterator it = series.constBegin(); it != series.constEnd(); ++it)
+	{
+		if (qIsNaN(it->y()))
+			continue;
+		if (!found || it->x() < minX) minX = it->x();
+		if (!found || it->x() > maxX) maxX = it->x();
+		if (!found || it->y() < minY) minY = it->y();
+		if (!found || it->y() > maxY) maxY = it->y();
+		found = true;
+	}
+
+	if (!found)
+	{
+		dataBounds = QRectF();
+		return;
+	}
+
+	/* Keep a flat or single point series visible */
+	if (maxX <= minX)
+		maxX = minX + 1.0;
+	if (maxY <= minY)
+	{
+		minY -= 0.5;
+		maxY += 0.5;
+	}
+	dataBounds = QRectF(QPointF(minX, minY), QPointF(maxX, maxY));
+}
+
+
+QPointF TimeSeriesPlot::DataToWidget(const QPointF &point, const QRect &plotArea)
+{
+	double x = plotArea.left() + (point.x() - dataBounds.left()) / dataBounds.width() * plotArea.width();
+	double y = plotArea.bottom() - (point.y() - dataBounds.top()) / dataBounds.height() * plotArea.height();
+	return QPointF(x, y);
+}
+
+
+void TimeSeriesPlot::DrawAxes(QPainter *painter, const QRect &plotArea)
+{
+	painter->save();
+	painter->setPen(palette().color(QPalette::Mid));
+	painter->drawRect(plotArea);
+
+	QFontMetrics metrics = painter->fontMetrics();
+	for (int i=0; i<PLOT_TICK_COUNT; ++i)
+	{
+		double fraction = (double)i / (PLOT_TICK_COUNT - 1);
+
+		int x = plotArea.left() + (int)(fraction*plotArea.width());
+		QString xText = QString::number(dataBounds.left() + fraction*dataBounds.width(), 'f', 2);
+		painter->setPen(palette().color(QPalette::Midlight));
+		painter->drawLine(x, plotArea.top(), x, plotArea.bottom());
+		painter->setPen(palette().color(QPalette::Text));
+		painter->drawText(x - metrics.width(xText)/2, plotArea.bottom() + metrics.height(), xText);
+
+		int y = plotArea.bottom() - (int)(fraction*plotArea.height());
+		QString yText = QString::number(dataBounds.top() + fraction*dataBounds.height(), 'f', 3);
+		painter->setPen(palette().color(QPalette::Midlight));
+		painter->drawLine(plotArea.left(), y, plotArea.right(), y);
+		painter->setPen(palette().color(QPalette::Text));
+		painter->drawText(plotArea.left() - metrics.width(yText) - 5, y + metrics.ascent()/2, yText);
+	}
+
+	painter->drawText(QRect(plotArea.left(), plotArea.bottom() + metrics.height(), plotArea.width(), PLOT_MARGIN_BOTTOM - metrics.height()),
+			  Qt::AlignCenter, xLabel);
+	painter->translate(contentsRect().left() + metrics.height(), plotArea.center().y());
+	painter->rotate(-90.0);
+	painter->drawText(QRect(-plotArea.height()/2, -metrics.height(), plotArea.height(), metrics.height()), Qt::AlignCenter, yLabel);
+	painter->restore();
+}
+
+
+/**
+ * @brief Draws the series as a line, broken across gaps
+ * @param painter The painter
+ * @param plotArea The area inside the axes
+ */
+void TimeSeriesPlot::DrawSeries(QPainter *painter, const QRect &plotArea)
+{
+	QPainterPath path;
+	bool penDown = false;
+	for (QPolygonF::const_iterator it = series.constBegin(); it != series.constEnd(); ++it)
+	{
+		if (qIsNaN(it->y()))
+		{
+			penDown = false;
+			continue;
+		}
+
+		QPointF point = DataToWidget(*it, plotArea);
+		if (penDown)
+			path.lineTo(point);
+		else
+			path.moveTo(point);
+		penDown = true;
+	}
+
+	painter->save();
+	painter->setClipRect(plotArea);
+	painter->setPen(QPen(QColor::fromRgb(0, 0, 200), 1.5));
+	painter->drawPath(path);
+	painter->restore();
+}
+
+
+/**
+ * @brief Shows a new time series
+ * @param newTitle The title drawn above the plot
+ * @param newSeries The time series, with NaN values for gaps
+ */
+void TimeSeriesPlot::setSeries(QString newTitle, QPolygonF newSeries)
+{
+	title = newTitle;
+	series = newSeries;
+	CalculateBounds();
+	update();
+}
+
+
+void TimeSeriesPlot::clear()
+{
+	title = "";
+	series.clear();
+	dataBounds = QRectF();
+	update();
+}
@@ -0,0 +1,58 @@
+#ifndef TIMESERIESPLOT_H
+#define TIMESERIESPLOT_H
+
+#include <QWidget>
+#include <QFrame>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPolygonF>
+#include <qnumeric.h>
+
+#define PLOT_TICK_COUNT		5
+#define PLOT_MARGIN_LEFT	60
+#define PLOT_MARGIN_RIGHT	15
+#define PLOT_MARGIN_TOP		30
+#define PLOT_MARGIN_BOTTOM	35
+
+
+/**
+ * @brief A simple line plot of a single time series
+ *
+ * A simple line plot of a single time series, such as the water elevation at a
+ * point. Points with a NaN value are treated as gaps (dry timesteps) and the line
+ * is broken across them. The axes are scaled to the data each time a new series
+ * is set.
+ *
+ */
+class TimeSeriesPlot : public QFrame
+{
+		Q_OBJECT
+	public:
+		TimeSeriesPlot(QWidget *parent = 0);
+
+		void	SetAxisLabels(QString newXLabel, QString newYLabel);
+
+	protected:
+
+		void	paintEvent(QPaintEvent *);
+
+	private:
+
+		QString		title;
+		QString		xLabel;
+		QString		yLabel;
+		QPolygonF	series;
+		QRectF		dataBounds;	/**< The extents of every point that is not a gap */
+
+		void	CalculateBounds();
+		QPointF	DataToWidget(const QPointF &point, const QRect &plotArea);
+		void	DrawAxes(QPainter *painter, const QRect &plotArea);
+		void	DrawSeries(QPainter *painter, const QRect &plotArea);
+
+	public slots:
+
+		void	setSeries(QString newTitle, QPolygonF newSeries);
+		void	clear();
+};
+
+#endif // TIMESERIESPLOT_H
@@ -30,6 +30,10 @@
 #define EARTH_RADIUS 6378206.4
 
 
+/** The value ADCIRC writes in its output files for dry nodes, and that derived files use as well */
+#define DRY_VALUE -99999.0f
+
+
 /**
  * @brief Defines an ADCIRC node (See fort.14 in ADCIRC manual)
  *
@@ -90,7 +94,7 @@ struct Point
  * Types of actions that the user can perform.
  *
  */
-enum ActionType {DisplayAction, SelectionAction};
+enum ActionType {DisplayAction, SelectionAction, TimeSeriesAction};
 
 
 /**
@@ -111,4 +115,14 @@ enum ToolType {ClickToolType, CircleToolType, RectangleToolType, PolygonToolType
 enum SelectionType {NodeSelection, ElementSelection};
 
 
+/**
+ * @brief Types of per-node results that can be drawn over the terrain
+ *
+ * Types of per-node results that can be drawn over the terrain in place of
+ * fort.63 playback.
+ *
+ */
+enum OverlayType {NoOverlay, MaxElevationOverlay, MaxVelocityOverlay, DifferenceOverlay};
+
+
 #endif // ADCDATA_H
@@ -0,0 +1,199 @@
+#-------------------------------------------------
+#
+# Project created by QtCreator 2013-06-10T10:42:19
+#
+#-------------------------------------------------
+
+QT       += core gui opengl xml
+
+LIBS += -lGLEW -lGLU
+
+greaterThan(QT_MAJOR_VERSION, 4): QT += widgets
+
+# Lets the per-node reductions (output envelopes, etc.) be vectorized
+*-g++*|*-clang*: QMAKE_CXXFLAGS_RELEASE += -ftree-vectorize
+
+TARGET = adcSubdomainTool
+TEMPLATE = app
+
+# The mesh, spatial index and file I/O code is built by Core/Core.pro
+include(Core/Core.pri)
+
+
+SOURCES += main.cpp\
+        MainWindow.cpp \
+    OpenGL/OpenGLPanel.cpp \
+    OpenGL/glew.c \
+    OpenGL/GLCamera.cpp \
+    OpenGL/QuadtreeOutline.cpp \
+    Layers/Layer.cpp \
+    Layers/TerrainLayer.cpp \
+    Layers/VelocityLayer.cpp \
+    OpenGL/Shaders/GLShader.cpp \
+    OpenGL/Shaders/SolidShader.cpp \
+    SubdomainTools/CircleTool.cpp \
+    Layers/SelectionLayer.cpp \
+    Layers/Actions/Action.cpp \
+    Layers/Actions/NodeAction.cpp \
+    Layers/Actions/ElementAction.cpp \
+    OpenGL/Shaders/GradientShader.cpp \
+    Domains/Domain.cpp \
+    OpenGL/Shaders/CulledSolidShader.cpp \
+    OpenGL/Shaders/GlyphShader.cpp \
+    Layers/SelectionLayers/CreationSelectionLayer.cpp \
+    SubdomainTools/RectangleTool.cpp \
+    SubdomainTools/PolygonTool.cpp \
+    SubdomainTools/SelectionTool.cpp \
+    Dialogs/CreateProjectDialog.cpp \
+    SubdomainTools/ClickTool.cpp \
+    Projects/Project.cpp \
+    Projects/ProjectFile.cpp \
+    Dialogs/DisplayOptionsDialog.cpp \
+    Widgets/ShaderOptionsStackedWidget.cpp \
+    Widgets/ColorWidgets/ColorGradientFrame.cpp \
+    Widgets/ColorWidgets/ValueSlider.cpp \
+    Widgets/ColorWidgets/BasicColorsWidget.cpp \
+    Widgets/ColorWidgets/ColorButton.cpp \
+    Widgets/ColorWidgets/CustomColorsWidget.cpp \
+    Widgets/ColorWidgets/TriangleSliderButton.cpp \
+    Widgets/ColorWidgets/GradientSliderFrame.cpp \
+    Widgets/ColorWidgets/GradientSliderWidget.cpp \
+    Widgets/ColorWidgets/SliderItemDelegate.cpp \
+    Projects/IO/SubdomainCreator.cpp \
+    Projects/ProjectSettings.cpp \
+    Projects/DomainLoader.cpp \
+    Dialogs/ProjectSettingsDialog.cpp \
+    Adcirc/FullDomainRunner.cpp \
+    Adcirc/JobScheduler.cpp \
+    Adcirc/AdcircRun.cpp \
+    Adcirc/Pipeline.cpp \
+    Adcirc/RunMonitor.cpp \
+    Dialogs/FullDomainRunOptionsDialog.cpp \
+    Projects/IO/FileIO/TimestepPrefetcher.cpp \
+    Analysis/PointTimeSeries.cpp \
+    Analysis/EnvelopeTask.cpp \
+    Analysis/EnvelopeCalculator.cpp \
+    Widgets/PlotWidgets/TimeSeriesPlot.cpp \
+    Widgets/JobWidgets/JobStatusWidget.cpp \
+    Projects/IO/FileIO/BNList14.cpp \
+    NewProjectModel/Domains/FullDomain.cpp \
+    NewProjectModel/Domains/SubDomain.cpp \
+    NewProjectModel/Project_new.cpp \
+    NewProjectModel/Files/Maxvel63_new.cpp \
+    NewProjectModel/Files/Maxele63_new.cpp \
+    NewProjectModel/Files/Fort64_new.cpp \
+    NewProjectModel/Files/Fort63_new.cpp \
+    NewProjectModel/Files/Py141_new.cpp \
+    NewProjectModel/Files/Py140_new.cpp \
+    NewProjectModel/Files/Fort22_new.cpp \
+    NewProjectModel/Files/Fort021_new.cpp \
+    NewProjectModel/Files/Fort15_new.cpp \
+    NewProjectModel/ProjectSettings_new.cpp \
+    NewProjectModel/Files/ProjectFile_new.cpp \
+    NewProjectModel/Files/Fort14_new.cpp \
+    NewProjectModel/Files/Fort020_new.cpp \
+    NewProjectModel/Files/BNList14_new.cpp \
+    NewProjectModel/Files/Fort022_new.cpp \
+    NewProjectModel/Files/Fort015_new.cpp \
+    NewProjectModel/Files/Fort066_new.cpp \
+    NewProjectModel/Files/Fort067_new.cpp
+
+HEADERS  += MainWindow.h \
+    OpenGL/OpenGLPanel.h \
+    OpenGL/wglew.h \
+    OpenGL/glxew.h \
+    OpenGL/glew.h \
+    OpenGL/GLCamera.h \
+    OpenGL/QuadtreeOutline.h \
+    OpenGL/GLData.h \
+    Layers/Layer.h \
+    Layers/TerrainLayer.h \
+    Layers/VelocityLayer.h \
+    OpenGL/Shaders/GLShader.h \
+    OpenGL/Shaders/SolidShader.h \
+    SubdomainTools/CircleTool.h \
+    Layers/SelectionLayer.h \
+    Layers/Actions/Action.h \
+    Layers/Actions/NodeAction.h \
+    Layers/Actions/ElementAction.h \
+    OpenGL/Shaders/GradientShader.h \
+    Domains/Domain.h \
+    OpenGL/Shaders/CulledSolidShader.h \
+    OpenGL/Shaders/GlyphShader.h \
+    Layers/SelectionLayers/CreationSelectionLayer.h \
+    SubdomainTools/RectangleTool.h \
+    SubdomainTools/PolygonTool.h \
+    SubdomainTools/SelectionTool.h \
+    Dialogs/CreateProjectDialog.h \
+    SubdomainTools/ClickTool.h \
+    Projects/Project.h \
+    Projects/ProjectFile.h \
+    Dialogs/DisplayOptionsDialog.h \
+    Widgets/ShaderOptionsStackedWidget.h \
+    Widgets/ColorGradientFrame.h \
+    Widgets/ColorWidgets/ColorGradientFrame.h \
+    Widgets/ColorWidgets/ValueSlider.h \
+    Widgets/ColorWidgets/BasicColorsWidget.h \
+    Widgets/ColorWidgets/ColorButton.h \
+    Widgets/ColorWidgets/CustomColorsWidget.h \
+    Widgets/ColorWidgets/TriangleSliderButton.h \
+    Widgets/ColorWidgets/GradientSliderFrame.h \
+    Widgets/ColorWidgets/GradientSliderWidget.h \
+    Widgets/ColorWidgets/SliderItemDelegate.h \
+    Projects/IO/SubdomainCreator.h \
+    Projects/ProjectSettings.h \
+    Projects/DomainLoader.h \
+    Dialogs/ProjectSettingsDialog.h \
+    Adcirc/FullDomainRunner.h \
+    Adcirc/JobScheduler.h \
+    Adcirc/AdcircRun.h \
+    Adcirc/Pipeline.h \
+    Adcirc/RunMonitor.h \
+    Dialogs/FullDomainRunOptionsDialog.h \
+    Projects/IO/FileIO/TimestepPrefetcher.h \
+    Analysis/PointTimeSeries.h \
+    Analysis/EnvelopeTask.h \
+    Analysis/EnvelopeCalculator.h \
+    Widgets/PlotWidgets/TimeSeriesPlot.h \
+    Widgets/JobWidgets/JobStatusWidget.h \
+    Projects/IO/FileIO/BNList14.h \
+    NewProjectModel/Domains/FullDomain.h \
+    NewProjectModel/Domains/SubDomain.h \
+    NewProjectModel/Project_new.h \
+    NewProjectModel/Files/Maxvel63_new.h \
+    NewProjectModel/Files/Maxele63_new.h \
+    NewProjectModel/Files/Fort64_new.h \
+    NewProjectModel/Files/Fort63_new.h \
+    NewProjectModel/Files/Py141_new.h \
+    NewProjectModel/Files/Py140_new.h \
+    NewProjectModel/Files/Fort22_new.h \
+    NewProjectModel/Files/Fort021_new.h \
+    NewProjectModel/Files/Fort15_new.h \
+    NewProjectModel/ProjectSettings_new.h \
+    NewProjectModel/Files/ProjectFile_new.h \
+    NewProjectModel/Files/Fort14_new.h \
+    NewProjectModel/Files/Fort020_new.h \
+    NewProjectModel/Files/BNList14_new.h \
+    NewProjectModel/Files/Fort022_new.h \
+    NewProjectModel/Files/Fort015_new.h \
+    NewProjectModel/Files/Fort066_new.h \
+    NewProjectModel/Files/Fort067_new.h
+
+FORMS    += MainWindow.ui \
+    Dialogs/CreateProjectDialog.ui \
+    Dialogs/DisplayOptionsDialog.ui \
+    Widgets/ShaderOptionsStackedWidget.ui \
+    Dialogs/ProjectSettingsDialog.ui \
+    Dialogs/FullDomainRunOptionsDialog.ui
+
+target.path = /usr/local/bin
+desktop.path = /usr/share/applications
+desktop.files += AdcircSubdomainTool.desktop
+
+INSTALLS += target desktop
+
+RESOURCES += \
+    icons.qrc
+
+OTHER_FILES += \
+    AdcircSubdomainTool.desktop